@@ -0,0 +1,286 @@
+/******************************************************************************
+
+ @file  cs_prof.c
+
+ @brief This file contains the critical section profiler, which keeps
+        the maximum and a histogram of the time interrupts stay masked
+        at each call site.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifdef CS_PROF
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "cs_prof.h"
+
+#if defined __TI_COMPILER_VERSION__ || defined __ICCARM__ || defined __arm__
+#define CS_PROF_DWT
+#else
+#include <time.h>
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#ifdef CS_PROF_DWT
+// CPU clock, counted by the DWT cycle counter
+#ifndef CS_PROF_CPU_HZ
+#define CS_PROF_CPU_HZ                    48000000
+#endif
+
+// Cortex-M3 debug registers
+#define CS_PROF_DEMCR                     (*(volatile uint32_t *)0xE000EDFC)
+#define CS_PROF_DEMCR_TRCENA              0x01000000
+#define CS_PROF_DWT_CTRL                  (*(volatile uint32_t *)0xE0001000)
+#define CS_PROF_DWT_CTRL_CYCCNTENA        0x00000001
+#define CS_PROF_DWT_CYCCNT                (*(volatile uint32_t *)0xE0001004)
+
+#define CS_PROF_TICK_HZ                   CS_PROF_CPU_HZ
+#else
+#define CS_PROF_TICK_HZ                   1000000000
+#endif // CS_PROF_DWT
+
+#define CS_PROF_TICKS_PER_US              (CS_PROF_TICK_HZ / 1000000)
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static csProfSite_t csProfSites[CS_PROF_MAX_SITES];
+static uint8_t csProfNumSites = 0;
+
+static uint32_t csProfBudget = CS_PROF_BUDGET_US * CS_PROF_TICKS_PER_US;
+static uint32_t csProfOverBudget = 0;
+
+// Outermost section in progress
+static uint8_t csProfDepth = 0;
+static const char *csProfFile;
+static uint16_t csProfLine;
+static uint32_t csProfStart;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      csProf_now
+ *
+ * @brief   Read the timestamp counter.
+ */
+static uint32_t csProf_now(void)
+{
+#ifdef CS_PROF_DWT
+  return CS_PROF_DWT_CYCCNT;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+#endif // CS_PROF_DWT
+}
+
+/*********************************************************************
+ * @fn      csProf_findSite
+ *
+ * @brief   Find or add the entry of a call site.
+ *
+ * @param   pFile - file of the site
+ * @param   line - line of the site
+ *
+ * @return  site entry, the last one if the table is full
+ */
+static csProfSite_t *csProf_findSite(const char *pFile, uint16_t line)
+{
+  csProfSite_t *pSite;
+  uint8_t i;
+
+  for (i = 0; i < csProfNumSites; i++)
+  {
+    pSite = &csProfSites[i];
+
+    // The same file name is usually the same string
+    if (pSite->line == line && pSite->pFile != NULL &&
+        (pSite->pFile == pFile || strcmp(pSite->pFile, pFile) == 0))
+    {
+      return pSite;
+    }
+  }
+
+  if (csProfNumSites < CS_PROF_MAX_SITES - 1)
+  {
+    pSite = &csProfSites[csProfNumSites++];
+    pSite->pFile = pFile;
+    pSite->line = line;
+
+    return pSite;
+  }
+
+  // Other sites share the last entry
+  csProfNumSites = CS_PROF_MAX_SITES;
+
+  return &csProfSites[CS_PROF_MAX_SITES - 1];
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+void CsProf_init(void)
+{
+#ifdef CS_PROF_DWT
+  CS_PROF_DEMCR |= CS_PROF_DEMCR_TRCENA;
+  CS_PROF_DWT_CTRL |= CS_PROF_DWT_CTRL_CYCCNTENA;
+#endif // CS_PROF_DWT
+}
+
+void CsProf_begin(const char *pFile, uint16_t line)
+{
+  if (csProfDepth++ == 0)
+  {
+    csProfFile = pFile;
+    csProfLine = line;
+    csProfStart = csProf_now();
+  }
+}
+
+void CsProf_end(void)
+{
+  csProfSite_t *pSite;
+  uint32_t ticks;
+  uint32_t us;
+  uint8_t bucket;
+
+  // Sections nested in the outermost one are not timed
+  if (csProfDepth == 0 || --csProfDepth > 0)
+  {
+    return;
+  }
+
+  ticks = csProf_now() - csProfStart;
+
+  pSite = csProf_findSite(csProfFile, csProfLine);
+  pSite->count++;
+  pSite->totalTicks += ticks;
+  if (ticks > pSite->maxTicks)
+  {
+    pSite->maxTicks = ticks;
+  }
+
+  us = ticks / CS_PROF_TICKS_PER_US;
+  for (bucket = 0; us != 0 && bucket < CS_PROF_NUM_BUCKETS - 1; bucket++)
+  {
+    us >>= 1;
+  }
+
+  if (pSite->hist[bucket] != 0xFFFF)
+  {
+    pSite->hist[bucket]++;
+  }
+
+  if (csProfBudget != 0 && ticks > csProfBudget)
+  {
+    if (pSite->overBudget != 0xFFFF)
+    {
+      pSite->overBudget++;
+    }
+
+    csProfOverBudget++;
+
+    CS_PROF_BUDGET_HOOK(pSite, ticks / CS_PROF_TICKS_PER_US);
+  }
+}
+
+void CsProf_setBudget(uint32_t us)
+{
+  csProfBudget = us * CS_PROF_TICKS_PER_US;
+}
+
+uint32_t CsProf_getTickHz(void)
+{
+  return CS_PROF_TICK_HZ;
+}
+
+uint8_t CsProf_getNumSites(void)
+{
+  return csProfNumSites;
+}
+
+uint8_t CsProf_getSite(uint8_t idx, csProfSite_t *pSite)
+{
+  UInt key;
+
+  if (idx >= csProfNumSites)
+  {
+    return FALSE;
+  }
+
+  key = Hwi_disable();
+  *pSite = csProfSites[idx];
+  Hwi_restore(key);
+
+  return TRUE;
+}
+
+uint32_t CsProf_getOverBudget(void)
+{
+  return csProfOverBudget;
+}
+
+void CsProf_reset(void)
+{
+  UInt key;
+
+  key = Hwi_disable();
+  memset(csProfSites, 0, sizeof(csProfSites));
+  csProfNumSites = 0;
+  csProfOverBudget = 0;
+  Hwi_restore(key);
+}
+
+#endif // CS_PROF
@@ -0,0 +1,238 @@
+/******************************************************************************
+
+ @file  cs_prof.h
+
+ @brief This file contains the definitions and prototypes of the
+        critical section profiler, which measures how long interrupts
+        stay masked at each call site.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef CS_PROF_H
+#define CS_PROF_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of call sites profiled. Sites found once the table is full are
+// counted in the last entry, which has no file.
+#ifndef CS_PROF_MAX_SITES
+#define CS_PROF_MAX_SITES                 32
+#endif
+
+// Number of histogram buckets. Bucket 0 counts sections under 1 us,
+// bucket n those of 2^(n-1) to 2^n us, and the last one all longer ones.
+#ifndef CS_PROF_NUM_BUCKETS
+#define CS_PROF_NUM_BUCKETS               12
+#endif
+
+// Default budget (us). Set it to the interrupt latency the radio
+// tolerates; longer sections are counted in csProfSite_t.overBudget.
+#ifndef CS_PROF_BUDGET_US
+#define CS_PROF_BUDGET_US                 20
+#endif
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Called with interrupts masked, after a section went over budget, e.g.
+// defined as HAL_ASSERT(FALSE) to stop at the offender.
+#ifndef CS_PROF_BUDGET_HOOK
+#define CS_PROF_BUDGET_HOOK(pSite, us)
+#endif
+
+// Place right after masking interrupts and right before restoring them
+#ifdef CS_PROF
+#define CS_PROF_BEGIN()       CsProf_begin(__FILE__, __LINE__)
+#define CS_PROF_END()         CsProf_end()
+#else
+#define CS_PROF_BEGIN()
+#define CS_PROF_END()
+#endif // CS_PROF
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * Statistics of a call site. Nested sections are charged to the
+ * outermost one, which is the site that masked interrupts. Times are in
+ * ticks of CsProf_getTickHz().
+ */
+typedef struct
+{
+  const char *pFile;                   //!< __FILE__ of the site
+  uint16_t line;                       //!< __LINE__ of the site
+  uint16_t overBudget;                 //!< Sections longer than the budget
+  uint32_t count;                      //!< Sections measured
+  uint32_t maxTicks;                   //!< Longest section
+  uint64_t totalTicks;                 //!< Sum of the sections
+  uint16_t hist[CS_PROF_NUM_BUCKETS];  //!< Log2 histogram, see above
+} csProfSite_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      CsProf_init
+ *
+ * @brief   Start the timestamp counter. Call before interrupts are
+ *          enabled.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void CsProf_init(void);
+
+/*********************************************************************
+ * @fn      CsProf_begin
+ *
+ * @brief   Start timing a section, with interrupts masked. Use
+ *          CS_PROF_BEGIN(), which compiles to nothing unless CS_PROF is
+ *          defined.
+ *
+ * @param   pFile - file of the site
+ * @param   line - line of the site
+ *
+ * @return  none
+ */
+extern void CsProf_begin(const char *pFile, uint16_t line);
+
+/*********************************************************************
+ * @fn      CsProf_end
+ *
+ * @brief   End the section started by the matching CsProf_begin(), with
+ *          interrupts still masked.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void CsProf_end(void);
+
+/*********************************************************************
+ * @fn      CsProf_setBudget
+ *
+ * @brief   Change the budget that sections are checked against.
+ *
+ * @param   us - budget in microseconds, 0 disables the check
+ *
+ * @return  none
+ */
+extern void CsProf_setBudget(uint32_t us);
+
+/*********************************************************************
+ * @fn      CsProf_getTickHz
+ *
+ * @brief   Get the frequency of the timestamp counter.
+ *
+ * @param   none
+ *
+ * @return  ticks per second
+ */
+extern uint32_t CsProf_getTickHz(void);
+
+/*********************************************************************
+ * @fn      CsProf_getNumSites
+ *
+ * @brief   Get the number of call sites seen.
+ *
+ * @param   none
+ *
+ * @return  number of entries readable with CsProf_getSite()
+ */
+extern uint8_t CsProf_getNumSites(void);
+
+/*********************************************************************
+ * @fn      CsProf_getSite
+ *
+ * @brief   Copy the statistics of a call site. Sites are in the order
+ *          they were first seen.
+ *
+ * @param   idx - site index, below CsProf_getNumSites()
+ * @param   pSite - statistics to fill
+ *
+ * @return  TRUE if the site exists, else FALSE
+ */
+extern uint8_t CsProf_getSite(uint8_t idx, csProfSite_t *pSite);
+
+/*********************************************************************
+ * @fn      CsProf_getOverBudget
+ *
+ * @brief   Get the number of sections longer than the budget, at all
+ *          sites.
+ *
+ * @param   none
+ *
+ * @return  number of sections over budget since the last reset
+ */
+extern uint32_t CsProf_getOverBudget(void);
+
+/*********************************************************************
+ * @fn      CsProf_reset
+ *
+ * @brief   Clear all statistics.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void CsProf_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CS_PROF_H */
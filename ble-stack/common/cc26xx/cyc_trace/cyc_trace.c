@@ -0,0 +1,218 @@
+/******************************************************************************
+
+ @file  cyc_trace.c
+
+ @brief This file contains the cycle counter trace. Records are
+        timestamped with the DWT cycle counter on the device and with
+        the monotonic clock on hosts.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifdef CYC_TRACE
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "cyc_trace.h"
+
+#if defined __TI_COMPILER_VERSION__ || defined __ICCARM__ || defined __arm__
+#define CYC_TRACE_DWT
+#else
+#include <time.h>
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#if (CYC_TRACE_SIZE & (CYC_TRACE_SIZE - 1)) || CYC_TRACE_SIZE > 32768
+#error "CYC_TRACE_SIZE must be a power of 2, 32768 at most"
+#endif
+
+#ifdef CYC_TRACE_DWT
+// CPU clock, counted by the DWT cycle counter
+#ifndef CYC_TRACE_CPU_HZ
+#define CYC_TRACE_CPU_HZ                  48000000
+#endif
+
+// Cortex-M3 debug registers
+#define CYC_TRACE_DEMCR                   (*(volatile uint32_t *)0xE000EDFC)
+#define CYC_TRACE_DEMCR_TRCENA            0x01000000
+#define CYC_TRACE_DWT_CTRL                (*(volatile uint32_t *)0xE0001000)
+#define CYC_TRACE_DWT_CTRL_CYCCNTENA      0x00000001
+#define CYC_TRACE_DWT_CYCCNT              (*(volatile uint32_t *)0xE0001004)
+
+#define CYC_TRACE_TICK_HZ                 CYC_TRACE_CPU_HZ
+#else
+#define CYC_TRACE_TICK_HZ                 1000000000
+#endif // CYC_TRACE_DWT
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+cycTraceBuf_t cycTraceBuf;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8_t cycTraceEnabled = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      cycTrace_now
+ *
+ * @brief   Read the timestamp counter.
+ */
+static uint32_t cycTrace_now(void)
+{
+#ifdef CYC_TRACE_DWT
+  return CYC_TRACE_DWT_CYCCNT;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+#endif // CYC_TRACE_DWT
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+void CycTrace_init(void)
+{
+#ifdef CYC_TRACE_DWT
+  CYC_TRACE_DEMCR |= CYC_TRACE_DEMCR_TRCENA;
+  CYC_TRACE_DWT_CYCCNT = 0;
+  CYC_TRACE_DWT_CTRL |= CYC_TRACE_DWT_CTRL_CYCCNTENA;
+#endif // CYC_TRACE_DWT
+
+  cycTraceBuf.hdr.magic[0] = 'C';
+  cycTraceBuf.hdr.magic[1] = 'T';
+  cycTraceBuf.hdr.version = CYC_TRACE_VERSION;
+  cycTraceBuf.hdr.recSize = sizeof(cycTraceRec_t);
+  cycTraceBuf.hdr.numRecs = CYC_TRACE_SIZE;
+  cycTraceBuf.hdr.tickHz = CYC_TRACE_TICK_HZ;
+  cycTraceBuf.hdr.head = 0;
+
+  cycTraceEnabled = 1;
+}
+
+void CycTrace_record(uint8_t id, uint8_t kind)
+{
+  BIOS_ThreadType threadType = BIOS_getThreadType();
+  uint16_t ctx;
+  cycTraceRec_t *pRec;
+  UInt key;
+
+  if (threadType == BIOS_ThreadType_Hwi)
+  {
+    ctx = CYC_TRACE_CTX_HWI;
+  }
+  else if (threadType == BIOS_ThreadType_Swi)
+  {
+    ctx = CYC_TRACE_CTX_SWI;
+  }
+  else
+  {
+    ctx = (uint16_t)(uintptr_t)Task_self();
+  }
+
+  key = Hwi_disable();
+
+  if (cycTraceEnabled)
+  {
+    pRec = &cycTraceBuf.recs[cycTraceBuf.hdr.head++ & (CYC_TRACE_SIZE - 1)];
+    pRec->time = cycTrace_now();
+    pRec->ctx = ctx;
+    pRec->id = id;
+    pRec->kind = kind;
+  }
+
+  Hwi_restore(key);
+}
+
+uint16_t CycTrace_drain(pfnCycTraceWrite_t pfnWrite)
+{
+  cycTraceHdr_t hdr;
+  uint32_t first;
+  uint16_t num;
+  uint16_t i;
+  UInt key;
+
+  key = Hwi_disable();
+  cycTraceEnabled = 0;
+  Hwi_restore(key);
+
+  // The drained trace holds num records starting at index 0
+  hdr = cycTraceBuf.hdr;
+  num = (hdr.head > CYC_TRACE_SIZE) ? CYC_TRACE_SIZE : hdr.head;
+  first = hdr.head - num;
+  hdr.numRecs = num;
+  hdr.head = num;
+  pfnWrite((const uint8_t *)&hdr, sizeof(hdr));
+
+  for (i = 0; i < num; i++)
+  {
+    pfnWrite((const uint8_t *)
+             &cycTraceBuf.recs[(first + i) & (CYC_TRACE_SIZE - 1)],
+             sizeof(cycTraceRec_t));
+  }
+
+  key = Hwi_disable();
+  cycTraceBuf.hdr.head = 0;
+  cycTraceEnabled = 1;
+  Hwi_restore(key);
+
+  return num;
+}
+
+#endif // CYC_TRACE
@@ -0,0 +1,213 @@
+/******************************************************************************
+
+ @file  cyc_trace.h
+
+ @brief This file contains the definitions and prototypes of the cycle
+        counter trace, a ring buffer of timestamped begin and end
+        markers placed on hot paths.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef CYC_TRACE_H
+#define CYC_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of records kept, a power of 2. The oldest records are overwritten.
+#ifndef CYC_TRACE_SIZE
+#define CYC_TRACE_SIZE                    128
+#endif
+
+// Buffer format version, see cycTraceBuf_t
+#define CYC_TRACE_VERSION                 1
+
+// Record kinds
+#define CYC_TRACE_KIND_BEGIN              0
+#define CYC_TRACE_KIND_END                1
+#define CYC_TRACE_KIND_MARK               2
+
+// Record contexts other than tasks
+#define CYC_TRACE_CTX_HWI                 0xFFFF
+#define CYC_TRACE_CTX_SWI                 0xFFFE
+
+// Marker ids. Names are kept in sync in tools/cyctrace/cyctrace_decode.py.
+#define CYC_TRACE_ICALL_DISPATCH          1  // ICall_dispatch()
+#define CYC_TRACE_ICALL_WAIT_MATCH        2  // ICall_waitMatch() and
+                                             // ICall_waitArmedMatch() wait
+#define CYC_TRACE_HEAP_MALLOC             3  // ICall_heapMalloc()
+#define CYC_TRACE_GSA_SEND_NOTI_IND       4  // gattServApp_SendNotiInd()
+#define CYC_TRACE_APP_STACK_MSG           5  // application processStackMsg
+#define CYC_TRACE_GAPROLE_STACK_MSG       6  // gapRole_processStackMsg()
+
+// First id free for application markers
+#define CYC_TRACE_USER                    32
+
+/*********************************************************************
+ * MACROS
+ */
+
+#ifdef CYC_TRACE
+#define CYC_TRACE_BEGIN(id)   CycTrace_record((id), CYC_TRACE_KIND_BEGIN)
+#define CYC_TRACE_END(id)     CycTrace_record((id), CYC_TRACE_KIND_END)
+#define CYC_TRACE_MARK(id)    CycTrace_record((id), CYC_TRACE_KIND_MARK)
+#else
+#define CYC_TRACE_BEGIN(id)
+#define CYC_TRACE_END(id)
+#define CYC_TRACE_MARK(id)
+#endif // CYC_TRACE
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * Trace record. Timestamps wrap around; the decoder unwraps them assuming
+ * consecutive records are less than one wrap apart.
+ */
+typedef struct
+{
+  uint32_t time;  //!< Timestamp, in ticks of cycTraceBuf_t.tickHz
+  uint16_t ctx;   //!< Low half of the task handle, or CYC_TRACE_CTX_*
+  uint8_t id;     //!< Marker id
+  uint8_t kind;   //!< CYC_TRACE_KIND_*
+} cycTraceRec_t;
+
+/**
+ * Trace header. All fields of the header and of records are little-endian.
+ * Records are in ring order: once more than numRecs were written, the
+ * oldest is at head % numRecs.
+ */
+typedef struct
+{
+  uint8_t magic[2];   //!< 'C', 'T'
+  uint8_t version;    //!< CYC_TRACE_VERSION
+  uint8_t recSize;    //!< sizeof(cycTraceRec_t)
+  uint16_t numRecs;   //!< Number of records that follow
+  uint16_t reserved;
+  uint32_t tickHz;    //!< Timestamp frequency
+  uint32_t head;      //!< Number of records written
+} cycTraceHdr_t;
+
+/**
+ * Trace buffer, read as is from RAM. CycTrace_drain() writes the same
+ * layout.
+ */
+typedef struct
+{
+  cycTraceHdr_t hdr;
+  cycTraceRec_t recs[CYC_TRACE_SIZE];
+} cycTraceBuf_t;
+
+/**
+ * @brief   Output function of CycTrace_drain(), e.g. a blocking UART
+ *          write.
+ *
+ * @param   pBuf - bytes to write
+ * @param   len - number of bytes
+ */
+typedef void (*pfnCycTraceWrite_t)(const uint8_t *pBuf, uint16_t len);
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// The trace, for debuggers
+extern cycTraceBuf_t cycTraceBuf;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      CycTrace_init
+ *
+ * @brief   Start the timestamp counter and enable tracing. Records made
+ *          before are dropped.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void CycTrace_init(void);
+
+/*********************************************************************
+ * @fn      CycTrace_record
+ *
+ * @brief   Add a record, from any context. Use the CYC_TRACE_* macros,
+ *          which compile to nothing unless CYC_TRACE is defined.
+ *
+ * @param   id - marker id
+ * @param   kind - CYC_TRACE_KIND_*
+ *
+ * @return  none
+ */
+extern void CycTrace_record(uint8_t id, uint8_t kind);
+
+/*********************************************************************
+ * @fn      CycTrace_drain
+ *
+ * @brief   Write the header and the records, oldest first, and empty
+ *          the trace. Records made meanwhile are dropped. Call from
+ *          a task; pfnWrite may block.
+ *
+ * @param   pfnWrite - output function
+ *
+ * @return  number of records written
+ */
+extern uint16_t CycTrace_drain(pfnCycTraceWrite_t pfnWrite);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CYC_TRACE_H */
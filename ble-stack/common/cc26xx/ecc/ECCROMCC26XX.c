@@ -54,6 +54,11 @@
 #include <ti/sysbios/BIOS.h>
 #include <ti/sysbios/knl/Semaphore.h>
 #include <ti/sysbios/family/arm/m3/Hwi.h>
+#ifdef ECCROMCC26XX_KEY_POOL
+#include <ti/sysbios/knl/Task.h>
+
+#include <TRNGCC26XX.h>
+#endif // ECCROMCC26XX_KEY_POOL
 
 #include "ecc/ECCROMCC26XX.h"
 
@@ -77,6 +82,30 @@
 // Total buffer size
 #define ECC_BUF_TOTAL_LEN(len)         ((len) + ECC_KEY_OFFSET) 
 
+#ifdef ECCROMCC26XX_KEY_POOL
+// Number of precomputed NIST P-256 key pairs.
+#ifndef ECCROMCC26XX_KEY_POOL_SIZE
+#define ECCROMCC26XX_KEY_POOL_SIZE     1
+#endif // ECCROMCC26XX_KEY_POOL_SIZE
+
+// Priority of the precompute task.  TI-RTOS does not time-slice tasks of
+// equal priority, so keys are precomputed at the priority of the Idle
+// task and never delay an application task.  Idle functions, such as the
+// power policy, do not run while a key pair is being computed.
+#ifndef ECCROMCC26XX_KEY_POOL_TASK_PRIORITY
+#define ECCROMCC26XX_KEY_POOL_TASK_PRIORITY  0
+#endif // ECCROMCC26XX_KEY_POOL_TASK_PRIORITY
+
+#ifndef ECCROMCC26XX_KEY_POOL_TASK_STACK_SIZE
+#define ECCROMCC26XX_KEY_POOL_TASK_STACK_SIZE  512
+#endif // ECCROMCC26XX_KEY_POOL_TASK_STACK_SIZE
+
+// Memory used by the precompute task: workzone and 3 buffers.
+#define ECC_KEY_POOL_BUF_LEN                                                   \
+  (ECCROMCC26XX_NIST_P256_WORKZONE_LEN_IN_BYTES +                              \
+   ECC_BUF_TOTAL_LEN(ECCROMCC26XX_NIST_P256_KEY_LEN_IN_BYTES) * 3)
+#endif // ECCROMCC26XX_KEY_POOL
+
 /*********************************************************************
  * EXTERNS
  */
@@ -107,6 +136,20 @@ extern uint32_t NIST_Curve_P256_b;
 extern uint32_t NIST_Curve_P256_Gx;
 extern uint32_t NIST_Curve_P256_Gy;
 
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+#ifdef ECCROMCC26XX_KEY_POOL
+// Precomputed NIST P-256 key pair.
+typedef struct
+{
+  uint8_t privateKey[ECCROMCC26XX_NIST_P256_KEY_LEN_IN_BYTES];
+  uint8_t publicKeyX[ECCROMCC26XX_NIST_P256_KEY_LEN_IN_BYTES];
+  uint8_t publicKeyY[ECCROMCC26XX_NIST_P256_KEY_LEN_IN_BYTES];
+} ECC_KeyPair;
+#endif // ECCROMCC26XX_KEY_POOL
+
 /*********************************************************************
  * LOCAL VARIABLES
  */
@@ -114,11 +157,45 @@ extern uint32_t NIST_Curve_P256_Gy;
 // ECC driver semaphore used to synchronize access.
 static Semaphore_Handle ECC_semaphore;
 
+#ifdef ECCROMCC26XX_KEY_POOL
+// Pool of precomputed key pairs.
+static ECC_KeyPair ECC_keyPool[ECCROMCC26XX_KEY_POOL_SIZE];
+static uint8_t ECC_keyPoolCount = 0;
+
+// Precompute task and the semaphore waking it up.
+static Task_Struct ECC_keyPoolTask;
+static uint8_t ECC_keyPoolTaskStack[ECCROMCC26XX_KEY_POOL_TASK_STACK_SIZE];
+static Semaphore_Handle ECC_keyPoolSemaphore;
+
+// Memory handed out to the ROM by the precompute task.  Accesses are
+// serialized by ECC_semaphore.
+static uint32_t ECC_keyPoolBuf[ECC_UINT32_BLK_LEN(ECC_KEY_POOL_BUF_LEN)];
+
+// Task holding the ECC engine, if any, and number of other tasks waiting
+// for it.  The precompute task does not start a key pair while any task
+// is waiting, and inherits the priority of a task waiting on it.
+static Task_Handle ECC_owner = NULL;
+static uint8_t ECC_waiting = 0;
+#endif // ECCROMCC26XX_KEY_POOL
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
 
 static void ECC_initGlobals(ECCROMCC26XX_CurveParams *pCurve);
+static Bool ECC_pend(UInt32 timeout);
+static void ECC_post(void);
+static int8_t ECC_genKeys(uint8_t *privateKey, uint8_t *publicKeyX,
+                          uint8_t *publicKeyY, ECCROMCC26XX_Params *params);
+
+#ifdef ECCROMCC26XX_KEY_POOL
+static uint8_t ECC_keyPoolTake(uint8_t *privateKey, uint8_t *publicKeyX,
+                               uint8_t *publicKeyY,
+                               ECCROMCC26XX_Params *params);
+static void ECC_keyPoolTaskFxn(UArg a0, UArg a1);
+static uint8_t *ECC_keyPoolMalloc(uint16_t len);
+static void ECC_keyPoolFree(uint8_t *pBuf);
+#endif // ECCROMCC26XX_KEY_POOL
 
 /*********************************************************************
  * PUBLIC FUNCTIONS
@@ -146,6 +223,22 @@ void ECCROMCC26XX_init(void)
     Semaphore_Params_init(&semParams);
     semParams.mode = Semaphore_Mode_BINARY;
     ECC_semaphore = Semaphore_create(1, &semParams, NULL);
+
+#ifdef ECCROMCC26XX_KEY_POOL
+    {
+      Task_Params taskParams;
+
+      // Start filling the key pool right away.
+      ECC_keyPoolSemaphore = Semaphore_create(1, &semParams, NULL);
+
+      Task_Params_init(&taskParams);
+      taskParams.stack = ECC_keyPoolTaskStack;
+      taskParams.stackSize = ECCROMCC26XX_KEY_POOL_TASK_STACK_SIZE;
+      taskParams.priority = ECCROMCC26XX_KEY_POOL_TASK_PRIORITY;
+
+      Task_construct(&ECC_keyPoolTask, ECC_keyPoolTaskFxn, &taskParams, NULL);
+    }
+#endif // ECCROMCC26XX_KEY_POOL
   }
   
   // Exit critical section.
@@ -184,6 +277,38 @@ void ECCROMCC26XX_Params_init(ECCROMCC26XX_Params *params)
  */
 int8_t ECCROMCC26XX_genKeys(uint8_t *privateKey, uint8_t *publicKeyX, 
                             uint8_t *publicKeyY, ECCROMCC26XX_Params *params)
+{
+#ifdef ECCROMCC26XX_KEY_POOL
+  // Hand out a precomputed key pair if one is ready.
+  if (ECC_keyPoolTake(privateKey, publicKeyX, publicKeyY, params))
+  {
+    return ECCROMCC26XX_STATUS_SUCCESS;
+  }
+
+  // A key pair in progress is ready sooner than a new one: wait for the
+  // precompute task to store it, then take it.
+  if (ECC_owner == Task_handle(&ECC_keyPoolTask) && params != NULL)
+  {
+    if (ECC_pend(params->timeout))
+    {
+      ECC_post();
+
+      if (ECC_keyPoolTake(privateKey, publicKeyX, publicKeyY, params))
+      {
+        return ECCROMCC26XX_STATUS_SUCCESS;
+      }
+    }
+  }
+#endif // ECCROMCC26XX_KEY_POOL
+
+  return ECC_genKeys(privateKey, publicKeyX, publicKeyY, params);
+}
+
+/*
+ *  ======== ECC_genKeys ========
+ */
+static int8_t ECC_genKeys(uint8_t *privateKey, uint8_t *publicKeyX,
+                          uint8_t *publicKeyY, ECCROMCC26XX_Params *params)
 {
   int8_t  status;
   uint8_t *randStrBuf;
@@ -204,7 +329,7 @@ int8_t ECCROMCC26XX_genKeys(uint8_t *privateKey, uint8_t *publicKeyX,
   }
   
   // Pend on Semaphore.
-  params->status = Semaphore_pend(ECC_semaphore, params->timeout);
+  params->status = ECC_pend(params->timeout);
   
   // If execution returned due to a timeout
   if (!params->status)
@@ -219,7 +344,7 @@ int8_t ECCROMCC26XX_genKeys(uint8_t *privateKey, uint8_t *publicKeyX,
   if (!(eccRom_workzone = (uint32_t *)params->malloc(params->curve.workzoneLen + ECC_BUF_TOTAL_LEN(params->curve.keyLen) * 3)))
   {
     // Post Semaphore.
-    Semaphore_post(ECC_semaphore);
+    ECC_post();
     
     // Store status.
     params->status = ECCROMCC26XX_STATUS_MALLOC_FAIL;
@@ -261,7 +386,7 @@ int8_t ECCROMCC26XX_genKeys(uint8_t *privateKey, uint8_t *publicKeyX,
   params->free((uint8_t *)eccRom_workzone);
   
   // Post Semaphore.
-  Semaphore_post(ECC_semaphore);
+  ECC_post();
   
   // Map success code.
   if (((uint8_t)status) == ECCROMCC26XX_STATUS_ECDH_KEYGEN_OK)
@@ -304,7 +429,7 @@ int8_t ECCROMCC26XX_genDHKey(uint8_t *privateKey, uint8_t *publicKeyX,
   }
   
   // Pend on Semaphore.
-  params->status = Semaphore_pend(ECC_semaphore, params->timeout);
+  params->status = ECC_pend(params->timeout);
   
   // If execution returned due to a timeout then leave here
   if (!params->status)
@@ -319,7 +444,7 @@ int8_t ECCROMCC26XX_genDHKey(uint8_t *privateKey, uint8_t *publicKeyX,
   if (!(eccRom_workzone = (uint32_t *)params->malloc(params->curve.workzoneLen + ECC_BUF_TOTAL_LEN(params->curve.keyLen) * 5)))
   {
     // Post Semaphore.
-    Semaphore_post(ECC_semaphore);
+    ECC_post();
     
     // Store status.
     params->status = ECCROMCC26XX_STATUS_MALLOC_FAIL;
@@ -367,7 +492,7 @@ int8_t ECCROMCC26XX_genDHKey(uint8_t *privateKey, uint8_t *publicKeyX,
   params->free((uint8_t *)eccRom_workzone);
   
   // Post Semaphore.
-  Semaphore_post(ECC_semaphore);
+  ECC_post();
 
   // Map success code.
   if (((uint8_t)status) == ECCROMCC26XX_STATUS_ECDH_COMMON_KEY_OK)
@@ -377,10 +502,237 @@ int8_t ECCROMCC26XX_genDHKey(uint8_t *privateKey, uint8_t *publicKeyX,
   
   // Store status.
   params->status = status;
+
+#ifdef ECCROMCC26XX_KEY_POOL
+  // The key exchange is over: replace the key pair used, if any, without
+  // competing with it for the ECC engine.
+  ECCROMCC26XX_refillKeyPool();
+#endif // ECCROMCC26XX_KEY_POOL
   
   return status;
 }
 
+#ifdef ECCROMCC26XX_KEY_POOL
+/*
+ *  ======== ECCROMCC26XX_refillKeyPool ========
+ */
+void ECCROMCC26XX_refillKeyPool(void)
+{
+  if (ECC_keyPoolCount < ECCROMCC26XX_KEY_POOL_SIZE)
+  {
+    Semaphore_post(ECC_keyPoolSemaphore);
+  }
+}
+
+/*
+ *  ======== ECCROMCC26XX_keyPoolCount ========
+ */
+uint8_t ECCROMCC26XX_keyPoolCount(void)
+{
+  return ECC_keyPoolCount;
+}
+
+/*
+ *  ======== ECC_keyPoolTake ========
+ */
+static uint8_t ECC_keyPoolTake(uint8_t *privateKey, uint8_t *publicKeyX,
+                               uint8_t *publicKeyY,
+                               ECCROMCC26XX_Params *params)
+{
+  ECC_KeyPair *pKeys;
+  unsigned int key;
+
+  // Only NIST P-256 key pairs are precomputed.
+  if (privateKey == NULL || publicKeyX == NULL || publicKeyY == NULL ||
+      params == NULL ||
+      params->curve.keyLen != ECCROMCC26XX_NIST_P256_KEY_LEN_IN_BYTES ||
+      params->curve.param_p != &NIST_Curve_P256_p)
+  {
+    return 0;
+  }
+
+  // Enter critical section.
+  key = Hwi_disable();
+
+  if (ECC_keyPoolCount == 0)
+  {
+    // Exit critical section.
+    Hwi_restore(key);
+
+    return 0;
+  }
+
+  pKeys = &ECC_keyPool[--ECC_keyPoolCount];
+
+  // The private key is handed back through the caller's random string,
+  // which the caller keeps as its private key.
+  memcpy(privateKey, pKeys->privateKey, sizeof(pKeys->privateKey));
+  memcpy(publicKeyX, pKeys->publicKeyX, sizeof(pKeys->publicKeyX));
+  memcpy(publicKeyY, pKeys->publicKeyY, sizeof(pKeys->publicKeyY));
+
+  // Never hand out the same key pair twice.
+  memset(pKeys, 0x00, sizeof(ECC_KeyPair));
+
+  // Exit critical section.
+  Hwi_restore(key);
+
+  params->status = ECCROMCC26XX_STATUS_SUCCESS;
+
+  return 1;
+}
+
+/*
+ *  ======== ECC_keyPoolTaskFxn ========
+ */
+static void ECC_keyPoolTaskFxn(UArg a0, UArg a1)
+{
+  ECCROMCC26XX_Params params;
+  TRNGCC26XX_Handle trngHandle;
+  Task_Handle self = Task_self();
+  ECC_KeyPair keys;
+  int8_t status;
+
+  ECCROMCC26XX_Params_init(&params);
+  params.malloc = ECC_keyPoolMalloc;
+  params.free   = ECC_keyPoolFree;
+
+  TRNGCC26XX_init();
+  trngHandle = TRNGCC26XX_open(0);
+
+  for (;;)
+  {
+    Semaphore_pend(ECC_keyPoolSemaphore, BIOS_WAIT_FOREVER);
+
+    // A key exchange waiting for the ECC engine refills the pool when
+    // done, see ECCROMCC26XX_genDHKey().
+    while (ECC_keyPoolCount < ECCROMCC26XX_KEY_POOL_SIZE && !ECC_waiting)
+    {
+      unsigned int key;
+      uint8_t i;
+
+      for (i = 0; i < sizeof(keys.privateKey); i += sizeof(uint32_t))
+      {
+        uint32_t trngVal = TRNGCC26XX_getNumber(trngHandle, NULL, NULL);
+
+        memcpy(&keys.privateKey[i], &trngVal, sizeof(uint32_t));
+      }
+
+      status = ECC_genKeys(keys.privateKey, keys.publicKeyX,
+                           keys.publicKeyY, &params);
+
+      if (status == ECCROMCC26XX_STATUS_SUCCESS)
+      {
+        // Enter critical section.
+        key = Hwi_disable();
+
+        memcpy(&ECC_keyPool[ECC_keyPoolCount++], &keys, sizeof(ECC_KeyPair));
+
+        // Exit critical section.
+        Hwi_restore(key);
+      }
+
+      // Drop a priority lent by a waiting request only now, so that the
+      // request finds the key pair in the pool once it runs.
+      if (Task_getPri(self) != ECCROMCC26XX_KEY_POOL_TASK_PRIORITY)
+      {
+        Task_setPri(self, ECCROMCC26XX_KEY_POOL_TASK_PRIORITY);
+      }
+
+      if (status != ECCROMCC26XX_STATUS_SUCCESS)
+      {
+        break;
+      }
+    }
+
+    memset(&keys, 0x00, sizeof(ECC_KeyPair));
+  }
+}
+
+/*
+ *  ======== ECC_keyPoolMalloc ========
+ */
+static uint8_t *ECC_keyPoolMalloc(uint16_t len)
+{
+  return (len <= sizeof(ECC_keyPoolBuf)) ? (uint8_t *)ECC_keyPoolBuf : NULL;
+}
+
+/*
+ *  ======== ECC_keyPoolFree ========
+ */
+static void ECC_keyPoolFree(uint8_t *pBuf)
+{
+}
+#endif // ECCROMCC26XX_KEY_POOL
+
+/*
+ *  ======== ECC_pend ========
+ */
+static Bool ECC_pend(UInt32 timeout)
+{
+#ifdef ECCROMCC26XX_KEY_POOL
+  Task_Handle self = Task_self();
+  Task_Handle pool = Task_handle(&ECC_keyPoolTask);
+  Bool acquired;
+  UInt key;
+
+  key = Task_disable();
+
+  if (self != pool)
+  {
+    ECC_waiting++;
+
+    // Lend our priority to the precompute task so that the key pair it
+    // is computing does not wait for every task in between.
+    if (ECC_owner == pool && Task_getPri(pool) < Task_getPri(self))
+    {
+      Task_setPri(pool, Task_getPri(self));
+    }
+  }
+
+  Task_restore(key);
+
+  acquired = Semaphore_pend(ECC_semaphore, timeout);
+
+  key = Task_disable();
+
+  if (self != pool)
+  {
+    ECC_waiting--;
+  }
+  if (acquired)
+  {
+    ECC_owner = self;
+  }
+
+  Task_restore(key);
+
+  return acquired;
+#else // ECCROMCC26XX_KEY_POOL
+  return Semaphore_pend(ECC_semaphore, timeout);
+#endif // ECCROMCC26XX_KEY_POOL
+}
+
+/*
+ *  ======== ECC_post ========
+ */
+static void ECC_post(void)
+{
+#ifdef ECCROMCC26XX_KEY_POOL
+  UInt key;
+
+  key = Task_disable();
+
+  // The precompute task keeps an inherited priority until it has stored
+  // its key pair, see ECC_keyPoolTaskFxn().
+  ECC_owner = NULL;
+  Semaphore_post(ECC_semaphore);
+
+  Task_restore(key);
+#else // ECCROMCC26XX_KEY_POOL
+  Semaphore_post(ECC_semaphore);
+#endif // ECCROMCC26XX_KEY_POOL
+}
+
 /*
  *  ======== ECC_initGlobals ========
  */
@@ -197,6 +197,8 @@
  *  | ECCROMCC26XX_Params_init()     | Initialize parameters for Key Generation          |
  *  | ECCROMCC26XX_genKeys()         | Generate Public Key X and Y Coordinates           |
  *  | ECCROMCC26XX_genDHKey()        | Generate Diffie-Hellman Shared Secret             |
+ *  | ECCROMCC26XX_refillKeyPool()   | Refill the precomputed key pool                   |
+ *  | ECCROMCC26XX_keyPoolCount()    | Number of precomputed key pairs ready             |
  *
  *  ## Unsupported functions:
  *  Functionality that currently not supported:
@@ -423,6 +425,34 @@ int8_t ECCROMCC26XX_genDHKey(uint8_t *privateKey, uint8_t *publicKeyX,
                              uint8_t *publicKeyY, uint8_t *dHKeyX, 
                              uint8_t *dHKeyY, ECCROMCC26XX_Params *params);
 
+#ifdef ECCROMCC26XX_KEY_POOL
+/*!
+ *  @brief  Request the key pool to be refilled.
+ *
+ *          With ECCROMCC26XX_KEY_POOL defined, a task at the priority of
+ *          the Idle task keeps ECCROMCC26XX_KEY_POOL_SIZE NIST P-256 key
+ *          pairs precomputed.  It does not start a key pair while another
+ *          task waits for the ECC engine, and inherits the priority of a
+ *          task that has to wait for the key pair in progress.
+ *          ECCROMCC26XX_genKeys() hands out a precomputed key pair when one
+ *          is ready: the private key is written back to the privateKey
+ *          buffer, so the caller shall keep that buffer as its private key.
+ *          The pool is filled at initialization and refilled after each
+ *          ECCROMCC26XX_genDHKey(), once the key exchange no longer needs
+ *          the ECC engine.  This function refills it at any other time.
+ *  @pre    ECCROMCC26XX_init must be called prior to this.
+ *          Calling context: Hwi, Swi or Task.
+ */
+void ECCROMCC26XX_refillKeyPool(void);
+
+/*!
+ *  @brief  Get the number of precomputed key pairs ready to be used.
+ *  @pre    Calling context: Hwi, Swi or Task.
+ *  @return number of precomputed key pairs
+ */
+uint8_t ECCROMCC26XX_keyPoolCount(void);
+#endif /* ECCROMCC26XX_KEY_POOL */
+
 #ifdef __cplusplus
 }
 #endif
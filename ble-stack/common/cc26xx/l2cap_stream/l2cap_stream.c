@@ -0,0 +1,944 @@
+/******************************************************************************
+
+ @file  l2cap_stream.c
+
+ @brief This file contains the L2CAP Connection Oriented Channel bulk
+        transfer engine. It splits large transfers into SDUs, keeps the
+        next SDUs ready while the stack sends the current one, returns
+        credits to the peer in batches and measures the throughput of
+        each channel.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "bcomdef.h"
+#include "l2cap.h"
+#include "gatt.h"
+#include "gattservapp.h"
+#include "gapbondmgr.h"
+#include "osal_snv.h"
+#include "icall.h"
+#include "icall_apimsg.h"
+
+#include "l2cap_stream.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Length of the SDU length field in the first LE-frame of an SDU
+#define L2CAP_STREAM_SDU_HDR_SIZE         2
+
+// LE-frames received before their credits are returned
+#if (L2CAP_STREAM_CREDIT_BATCH != 0)
+#define L2CAP_STREAM_BATCH                L2CAP_STREAM_CREDIT_BATCH
+#else
+#define L2CAP_STREAM_BATCH                (L2CAP_STREAM_PEER_CREDITS / 2)
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Streaming channel
+typedef struct
+{
+  uint16 CID;                            // Local channel id, L2CAP_CID_NULL if closed
+  uint16 sduLen;                         // Size of the SDUs sent
+  uint16 mps;                            // Local MPS, size of received LE-frames
+  uint16 rxFrames;                       // LE-frames received since credits were returned
+  uint32 txLen;                          // Length of the transfer in progress
+  uint32 txRead;                         // Bytes of it read from the source
+  uint32 txSent;                         // Bytes of it sent
+  uint32 txMark;                         // Tick of the last send progress
+  uint32 rxMark;                         // Tick of the last SDU received
+  uint32 txTicks;                        // Ticks spent sending
+  uint32 rxTicks;                        // Ticks spent receiving
+  uint8 *pSdu[L2CAP_STREAM_WINDOW];      // Prepared SDUs, oldest first
+  uint16 sduSize[L2CAP_STREAM_WINDOW];   // Length of the prepared SDUs
+  uint8 sduHead;                         // Index of the oldest SDU
+  uint8 sduCount;                        // Number of prepared SDUs
+  uint8 busy;                            // The oldest SDU is with the stack
+#ifdef ICALL_API_ASYNC
+  uint8 token;                           // Token of the SDU awaiting its status
+#endif // ICALL_API_ASYNC
+  l2capPacket_t pkt;                     // SDU given to the stack
+  l2capStreamStats_t stats;
+} l2capStreamChan_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static l2capStreamChan_t streamChans[L2CAP_STREAM_MAX_CHANNELS];
+
+static const l2capStreamCBs_t *pStreamCBs = NULL;
+
+static uint16 streamPsm = L2CAP_INVALID_PSM;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static l2capStreamChan_t *l2capStream_findChan(uint16 CID);
+static void l2capStream_openChan(l2capChannelEstEvt_t *pEvt);
+static void l2capStream_closeChan(l2capStreamChan_t *pChan);
+static void l2capStream_fill(l2capStreamChan_t *pChan);
+static void l2capStream_submit(l2capStreamChan_t *pChan);
+static void l2capStream_sendStatus(l2capStreamChan_t *pChan, uint8 status);
+static void l2capStream_sduDone(l2capStreamChan_t *pChan,
+                                l2capSendSduDoneEvt_t *pEvt);
+static void l2capStream_finish(l2capStreamChan_t *pChan, uint8 status);
+static void l2capStream_flush(l2capStreamChan_t *pChan);
+static void l2capStream_receive(l2capStreamChan_t *pChan, l2capPacket_t *pPkt);
+static void l2capStream_returnCredits(l2capStreamChan_t *pChan);
+static uint32 l2capStream_rate(uint32 bytes, uint32 ticks);
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      L2CAPStream_register
+ *
+ * @brief   Register a PSM for streaming and the application callbacks.
+ *
+ * @param   selfEntity - ICall entity of the application task
+ * @param   psm - local PSM
+ * @param   pCBs - application callbacks, must stay valid
+ *
+ * @return  status of L2CAP_RegisterPsm()
+ */
+bStatus_t L2CAPStream_register(ICall_EntityID selfEntity, uint16 psm,
+                               const l2capStreamCBs_t *pCBs)
+{
+  l2capPsm_t psmInfo;
+  bStatus_t status;
+  uint8 i;
+
+  for (i = 0; i < L2CAP_STREAM_MAX_CHANNELS; i++)
+  {
+    streamChans[i].CID = L2CAP_CID_NULL;
+  }
+
+  psmInfo.psm = psm;
+  psmInfo.mtu = L2CAP_STREAM_MAX_SDU;
+  psmInfo.initPeerCredits = L2CAP_STREAM_PEER_CREDITS;
+  // Credits are returned before this; it only catches a lost batch
+  psmInfo.peerCreditThreshold = L2CAP_STREAM_PEER_CREDITS / 4;
+  psmInfo.maxNumChannels = L2CAP_STREAM_MAX_CHANNELS;
+  psmInfo.taskId = ICall_getLocalMsgEntityId(ICALL_SERVICE_CLASS_BLE_MSG,
+                                             selfEntity);
+  psmInfo.pfnVerifySecCB = NULL;
+
+  status = L2CAP_RegisterPsm(&psmInfo);
+  if (status == SUCCESS)
+  {
+    streamPsm = psm;
+    pStreamCBs = pCBs;
+
+    // Get L2CAP_NUM_CTRL_DATA_PKT_EVT to retry SDUs that found no buffer
+    L2CAP_RegisterFlowCtrlTask(selfEntity);
+  }
+
+  return status;
+}
+
+/*********************************************************************
+ * @fn      L2CAPStream_connect
+ *
+ * @brief   Connect a channel from the registered PSM to a peer PSM.
+ *
+ * @param   connHandle - connection to create the channel on
+ * @param   peerPsm - peer PSM
+ *
+ * @return  status of L2CAP_ConnectReq()
+ */
+bStatus_t L2CAPStream_connect(uint16 connHandle, uint16 peerPsm)
+{
+  if (streamPsm == L2CAP_INVALID_PSM)
+  {
+    return bleIncorrectMode;
+  }
+
+  return L2CAP_ConnectReq(connHandle, streamPsm, peerPsm);
+}
+
+/*********************************************************************
+ * @fn      L2CAPStream_send
+ *
+ * @brief   Start sending len bytes read from the pfnRead callback.
+ *
+ * @param   CID - local channel id
+ * @param   len - number of bytes to send
+ *
+ * @return  SUCCESS, INVALIDPARAMETER, blePending or the status of the
+ *          first L2CAP_SendSDU()
+ */
+bStatus_t L2CAPStream_send(uint16 CID, uint32 len)
+{
+  l2capStreamChan_t *pChan = l2capStream_findChan(CID);
+
+  if ((pChan == NULL) || (len == 0) ||
+      (pStreamCBs == NULL) || (pStreamCBs->pfnRead == NULL))
+  {
+    return INVALIDPARAMETER;
+  }
+
+  if ((pChan->txLen != 0) || pChan->busy)
+  {
+    // A transfer is in progress, or the last SDU of an aborted one
+    return blePending;
+  }
+
+  pChan->txLen = len;
+  pChan->txRead = 0;
+  pChan->txSent = 0;
+  pChan->txMark = Clock_getTicks();
+
+  l2capStream_fill(pChan);
+
+  if (pChan->sduCount == 0)
+  {
+    // Source had nothing, or no memory for a single SDU
+    pChan->txLen = 0;
+
+    return bleMemAllocError;
+  }
+
+  l2capStream_submit(pChan);
+
+  // A transfer that failed right away has been reported through pfnDone
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      L2CAPStream_abort
+ *
+ * @brief   Abort the transfer in progress.
+ *
+ * @param   CID - local channel id
+ *
+ * @return  none
+ */
+void L2CAPStream_abort(uint16 CID)
+{
+  l2capStreamChan_t *pChan = l2capStream_findChan(CID);
+
+  if ((pChan != NULL) && (pChan->txLen != 0))
+  {
+    l2capStream_finish(pChan, FAILURE);
+  }
+}
+
+/*********************************************************************
+ * @fn      L2CAPStream_resume
+ *
+ * @brief   Retry SDUs the stack could not take for lack of buffers.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void L2CAPStream_resume(void)
+{
+  uint8 i;
+
+  for (i = 0; i < L2CAP_STREAM_MAX_CHANNELS; i++)
+  {
+    l2capStreamChan_t *pChan = &streamChans[i];
+
+    if (pChan->CID != L2CAP_CID_NULL)
+    {
+      l2capStream_fill(pChan);
+      l2capStream_submit(pChan);
+
+      if (pChan->rxFrames != 0)
+      {
+        // A credit return that failed earlier
+        l2capStream_returnCredits(pChan);
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      L2CAPStream_processStackMsg
+ *
+ * @brief   Process an L2CAP_SIGNAL_EVENT or L2CAP_DATA_EVENT message.
+ *
+ * @param   pMsg - message received by the application task
+ *
+ * @return  TRUE if the message was for a streaming channel, else FALSE
+ */
+uint8 L2CAPStream_processStackMsg(osal_event_hdr_t *pMsg)
+{
+  l2capStreamChan_t *pChan;
+
+  if (pMsg->event == L2CAP_DATA_EVENT)
+  {
+    l2capDataEvent_t *pData = (l2capDataEvent_t *)pMsg;
+
+    pChan = l2capStream_findChan(pData->pkt.CID);
+    if (pChan == NULL)
+    {
+      return FALSE;
+    }
+
+    l2capStream_receive(pChan, &pData->pkt);
+
+    return TRUE;
+  }
+
+  if (pMsg->event == L2CAP_SIGNAL_EVENT)
+  {
+    l2capSignalEvent_t *pSignal = (l2capSignalEvent_t *)pMsg;
+
+    switch (pSignal->opcode)
+    {
+      case L2CAP_CHANNEL_ESTABLISHED_EVT:
+        if ((pSignal->cmd.channelEstEvt.result == L2CAP_CONN_SUCCESS) &&
+            (pSignal->cmd.channelEstEvt.info.psm == streamPsm))
+        {
+          l2capStream_openChan(&pSignal->cmd.channelEstEvt);
+
+          return TRUE;
+        }
+        break;
+
+      case L2CAP_CHANNEL_TERMINATED_EVT:
+        pChan = l2capStream_findChan(pSignal->cmd.channelTermEvt.CID);
+        if (pChan != NULL)
+        {
+          l2capStream_closeChan(pChan);
+
+          return TRUE;
+        }
+        break;
+
+      case L2CAP_SEND_SDU_DONE_EVT:
+        pChan = l2capStream_findChan(pSignal->cmd.sendSduDoneEvt.CID);
+        if (pChan != NULL)
+        {
+          l2capStream_sduDone(pChan, &pSignal->cmd.sendSduDoneEvt);
+
+          return TRUE;
+        }
+        break;
+
+      case L2CAP_OUT_OF_CREDIT_EVT:
+        pChan = l2capStream_findChan(pSignal->cmd.creditEvt.CID);
+        if (pChan != NULL)
+        {
+          // The stack resumes the SDU when the peer returns credits
+          pChan->stats.creditStalls++;
+
+          return TRUE;
+        }
+        break;
+
+      case L2CAP_PEER_CREDIT_THRESHOLD_EVT:
+        pChan = l2capStream_findChan(pSignal->cmd.creditEvt.CID);
+        if (pChan != NULL)
+        {
+          l2capStream_returnCredits(pChan);
+
+          return TRUE;
+        }
+        break;
+
+      case L2CAP_NUM_CTRL_DATA_PKT_EVT:
+        L2CAPStream_resume();
+
+        // Other users of controller buffers may want this as well
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return FALSE;
+}
+
+#ifdef ICALL_API_ASYNC
+/*********************************************************************
+ * @fn      L2CAPStream_processCmdStatus
+ *
+ * @brief   Process the completion of an SDU sent in asynchronous mode.
+ *
+ * @param   token - token of the completion from ICall_apiCmdStatus()
+ * @param   status - status of the completion
+ *
+ * @return  TRUE if the command was sent by the engine, else FALSE
+ */
+uint8 L2CAPStream_processCmdStatus(uint8 token, uint8 status)
+{
+  uint8 i;
+
+  for (i = 0; i < L2CAP_STREAM_MAX_CHANNELS; i++)
+  {
+    l2capStreamChan_t *pChan = &streamChans[i];
+
+    if (pChan->busy && (pChan->token == token))
+    {
+      pChan->token = ICALL_API_NO_TOKEN;
+
+      if (pChan->CID == L2CAP_CID_NULL)
+      {
+        // Channel terminated while the stack had the SDU; free it unless
+        // the stack took it
+        if (status != SUCCESS)
+        {
+          BM_free(pChan->pSdu[pChan->sduHead]);
+        }
+        pChan->sduCount = 0;
+        pChan->busy = FALSE;
+
+        return TRUE;
+      }
+
+      l2capStream_sendStatus(pChan, status);
+
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+#endif // ICALL_API_ASYNC
+
+/*********************************************************************
+ * @fn      L2CAPStream_getStats
+ *
+ * @brief   Get the transfer statistics of a channel.
+ *
+ * @param   CID - local channel id
+ * @param   pStats - statistics to fill
+ *
+ * @return  SUCCESS or INVALIDPARAMETER
+ */
+bStatus_t L2CAPStream_getStats(uint16 CID, l2capStreamStats_t *pStats)
+{
+  l2capStreamChan_t *pChan = l2capStream_findChan(CID);
+
+  if (pChan == NULL)
+  {
+    return INVALIDPARAMETER;
+  }
+
+  *pStats = pChan->stats;
+
+  pStats->txRate = l2capStream_rate(pChan->stats.txBytes, pChan->txTicks);
+  pStats->rxRate = l2capStream_rate(pChan->stats.rxBytes, pChan->rxTicks);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      l2capStream_findChan
+ *
+ * @brief   Find a streaming channel.
+ *
+ * @param   CID - local channel id
+ *
+ * @return  channel, or NULL if the channel is not streaming
+ */
+static l2capStreamChan_t *l2capStream_findChan(uint16 CID)
+{
+  uint8 i;
+
+  if (CID == L2CAP_CID_NULL)
+  {
+    return NULL;
+  }
+
+  for (i = 0; i < L2CAP_STREAM_MAX_CHANNELS; i++)
+  {
+    if (streamChans[i].CID == CID)
+    {
+      return &streamChans[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      l2capStream_openChan
+ *
+ * @brief   Add an established channel to the engine.
+ *
+ * @param   pEvt - channel established event
+ *
+ * @return  none
+ */
+static void l2capStream_openChan(l2capChannelEstEvt_t *pEvt)
+{
+  l2capStreamChan_t *pChan = NULL;
+  uint8 i;
+
+  for (i = 0; (pChan == NULL) && (i < L2CAP_STREAM_MAX_CHANNELS); i++)
+  {
+    // A closed channel stays busy until the status of its last SDU
+    if ((streamChans[i].CID == L2CAP_CID_NULL) && !streamChans[i].busy)
+    {
+      pChan = &streamChans[i];
+    }
+  }
+
+  if (pChan == NULL)
+  {
+    // maxNumChannels of the PSM keeps this from happening
+    return;
+  }
+
+  VOID memset(pChan, 0, sizeof(l2capStreamChan_t));
+
+  pChan->CID = pEvt->CID;
+  pChan->mps = pEvt->info.mps;
+
+  // Largest SDUs the peer takes: the stack splits them into LE-frames of
+  // the peer MPS and sends those as credits and buffers allow
+  pChan->sduLen = MIN(pEvt->info.peerMtu, L2CAP_STREAM_MAX_SDU);
+#ifdef ICALL_API_ASYNC
+  pChan->token = ICALL_API_NO_TOKEN;
+#endif // ICALL_API_ASYNC
+}
+
+/*********************************************************************
+ * @fn      l2capStream_closeChan
+ *
+ * @brief   Remove a terminated channel from the engine.
+ *
+ * @param   pChan - channel
+ *
+ * @return  none
+ */
+static void l2capStream_closeChan(l2capStreamChan_t *pChan)
+{
+#ifdef ICALL_API_ASYNC
+  if (pChan->busy && (pChan->token != ICALL_API_NO_TOKEN))
+  {
+    // Whether the stack took the SDU is only known from the command
+    // status: keep the entry until L2CAPStream_processCmdStatus()
+  }
+  else
+#endif // ICALL_API_ASYNC
+  if (pChan->busy)
+  {
+    // The stack frees the SDU it was sending
+    pChan->sduHead = (pChan->sduHead + 1) % L2CAP_STREAM_WINDOW;
+    pChan->sduCount--;
+    pChan->busy = FALSE;
+  }
+
+  if (pChan->txLen != 0)
+  {
+    l2capStream_finish(pChan, bleNotConnected);
+  }
+
+  l2capStream_flush(pChan);
+
+  pChan->CID = L2CAP_CID_NULL;
+}
+
+/*********************************************************************
+ * @fn      l2capStream_fill
+ *
+ * @brief   Prepare SDUs of the transfer in progress until the window is
+ *          full.
+ *
+ * @param   pChan - channel
+ *
+ * @return  none
+ */
+static void l2capStream_fill(l2capStreamChan_t *pChan)
+{
+  while ((pChan->sduCount < L2CAP_STREAM_WINDOW) &&
+         (pChan->txRead < pChan->txLen))
+  {
+    uint8 idx = (pChan->sduHead + pChan->sduCount) % L2CAP_STREAM_WINDOW;
+    uint16 len = MIN(pChan->sduLen, pChan->txLen - pChan->txRead);
+    uint8 *pSdu = L2CAP_bm_alloc(len);
+
+    if (pSdu == NULL)
+    {
+      // Retried when the stack is done with an SDU
+      break;
+    }
+
+    len = pStreamCBs->pfnRead(pChan->CID, pChan->txRead, pSdu, len);
+    if (len == 0)
+    {
+      BM_free(pSdu);
+
+      // Source gave up, end the transfer with what was read
+      pChan->txLen = pChan->txRead;
+      break;
+    }
+
+    pChan->pSdu[idx] = pSdu;
+    pChan->sduSize[idx] = len;
+    pChan->sduCount++;
+
+    pChan->txRead += len;
+  }
+}
+
+/*********************************************************************
+ * @fn      l2capStream_submit
+ *
+ * @brief   Give the oldest prepared SDU to the stack if it is not
+ *          sending one already.
+ *
+ * @param   pChan - channel
+ *
+ * @return  none
+ */
+static void l2capStream_submit(l2capStreamChan_t *pChan)
+{
+  bStatus_t status;
+
+  if (pChan->busy || (pChan->sduCount == 0))
+  {
+    return;
+  }
+
+  // Credits owed to the peer go first: the PDUs of our SDUs would take
+  // every buffer the Flow Control Credit packet needs
+  if (pChan->rxFrames >= L2CAP_STREAM_BATCH)
+  {
+    l2capStream_returnCredits(pChan);
+
+    if (pChan->rxFrames != 0)
+    {
+      // Retried with L2CAPStream_resume()
+      return;
+    }
+  }
+
+  // The stack keeps a pointer to the packet until the command is done
+  pChan->pkt.CID = pChan->CID;
+  pChan->pkt.pPayload = pChan->pSdu[pChan->sduHead];
+  pChan->pkt.len = pChan->sduSize[pChan->sduHead];
+
+  pChan->busy = TRUE;
+
+#ifdef ICALL_API_ASYNC
+  // Don't block the task while the stack takes the SDU
+  if (ICall_apiSetAsync(TRUE) == SUCCESS)
+  {
+    status = L2CAP_SendSDU(&pChan->pkt);
+    pChan->token = ICall_apiLastToken();
+
+    ICall_apiSetAsync(FALSE);
+
+    if ((status == SUCCESS) && (pChan->token != ICALL_API_NO_TOKEN))
+    {
+      // Status is passed to L2CAPStream_processCmdStatus()
+      return;
+    }
+  }
+  else
+#endif // ICALL_API_ASYNC
+  {
+    status = L2CAP_SendSDU(&pChan->pkt);
+  }
+
+  l2capStream_sendStatus(pChan, status);
+}
+
+/*********************************************************************
+ * @fn      l2capStream_sendStatus
+ *
+ * @brief   Process the status of L2CAP_SendSDU() for the oldest SDU.
+ *
+ * @param   pChan - channel
+ * @param   status - status of L2CAP_SendSDU()
+ *
+ * @return  none
+ */
+static void l2capStream_sendStatus(l2capStreamChan_t *pChan, uint8 status)
+{
+  if (status == SUCCESS)
+  {
+    // The stack owns the SDU until L2CAP_SEND_SDU_DONE_EVT
+    return;
+  }
+
+  pChan->busy = FALSE;
+
+  if ((status == blePending) || (status == MSG_BUFFER_NOT_AVAIL) ||
+      (status == bleMemAllocError))
+  {
+    // Keep the SDU and retry it with L2CAPStream_resume()
+    return;
+  }
+
+  if (pChan->txLen != 0)
+  {
+    l2capStream_finish(pChan, status);
+  }
+  else
+  {
+    // Last SDU of an aborted transfer
+    l2capStream_flush(pChan);
+  }
+}
+
+/*********************************************************************
+ * @fn      l2capStream_sduDone
+ *
+ * @brief   Process the end of an SDU and hand the next one to the stack.
+ *
+ * @param   pChan - channel
+ * @param   pEvt - send SDU done event
+ *
+ * @return  none
+ */
+static void l2capStream_sduDone(l2capStreamChan_t *pChan,
+                                l2capSendSduDoneEvt_t *pEvt)
+{
+  uint32 now = Clock_getTicks();
+
+  if (!pChan->busy)
+  {
+    return;
+  }
+
+  // The stack freed the SDU payload
+  pChan->sduHead = (pChan->sduHead + 1) % L2CAP_STREAM_WINDOW;
+  pChan->sduCount--;
+  pChan->busy = FALSE;
+
+  pChan->stats.txBytes += pEvt->txLen;
+  pChan->stats.txSdus++;
+
+  if (pChan->txLen == 0)
+  {
+    // Last SDU of an aborted transfer
+    return;
+  }
+
+  pChan->txSent += pEvt->txLen;
+  pChan->txTicks += now - pChan->txMark;
+  pChan->txMark = now;
+
+  if (pEvt->txLen < pEvt->totalLen)
+  {
+    // SDU was aborted by the stack
+    l2capStream_finish(pChan, FAILURE);
+
+    return;
+  }
+
+  // Next SDU is ready, hand it over before reading the one after it
+  l2capStream_submit(pChan);
+  l2capStream_fill(pChan);
+  l2capStream_submit(pChan);
+
+  if ((pChan->sduCount == 0) && (pChan->txRead == pChan->txLen))
+  {
+    l2capStream_finish(pChan, SUCCESS);
+  }
+}
+
+/*********************************************************************
+ * @fn      l2capStream_finish
+ *
+ * @brief   End the transfer in progress and report it.
+ *
+ * @param   pChan - channel
+ * @param   status - status to report
+ *
+ * @return  none
+ */
+static void l2capStream_finish(l2capStreamChan_t *pChan, uint8 status)
+{
+  uint32 sent = pChan->txSent;
+
+  pChan->txLen = 0;
+
+  l2capStream_flush(pChan);
+
+  if (pStreamCBs->pfnDone != NULL)
+  {
+    pStreamCBs->pfnDone(pChan->CID, status, sent);
+  }
+}
+
+/*********************************************************************
+ * @fn      l2capStream_flush
+ *
+ * @brief   Free the prepared SDUs the stack does not own.
+ *
+ * @param   pChan - channel
+ *
+ * @return  none
+ */
+static void l2capStream_flush(l2capStreamChan_t *pChan)
+{
+  // Skip the SDU with the stack
+  uint8 keep = pChan->busy ? 1 : 0;
+
+  while (pChan->sduCount > keep)
+  {
+    uint8 idx = (pChan->sduHead + pChan->sduCount - 1) % L2CAP_STREAM_WINDOW;
+
+    BM_free(pChan->pSdu[idx]);
+    pChan->sduCount--;
+  }
+}
+
+/*********************************************************************
+ * @fn      l2capStream_receive
+ *
+ * @brief   Pass a received SDU to the application and return credits
+ *          once a batch of LE-frames was received.
+ *
+ * @param   pChan - channel
+ * @param   pPkt - received SDU
+ *
+ * @return  none
+ */
+static void l2capStream_receive(l2capStreamChan_t *pChan, l2capPacket_t *pPkt)
+{
+  uint32 now = Clock_getTicks();
+
+  // Count time between SDUs of a transfer, not between transfers
+  if ((pChan->stats.rxSdus != 0) &&
+      ((now - pChan->rxMark) <
+       ((L2CAP_STREAM_RX_IDLE * 1000) / Clock_tickPeriod)))
+  {
+    pChan->rxTicks += now - pChan->rxMark;
+  }
+  pChan->rxMark = now;
+
+  pChan->stats.rxBytes += pPkt->len;
+  pChan->stats.rxSdus++;
+
+  // Each LE-frame used one credit, the first one also carries the SDU length
+  if (pChan->mps != 0)
+  {
+    pChan->rxFrames += (pPkt->len + L2CAP_STREAM_SDU_HDR_SIZE +
+                        pChan->mps - 1) / pChan->mps;
+  }
+
+  if (pStreamCBs->pfnRecv != NULL)
+  {
+    pStreamCBs->pfnRecv(pChan->CID, pPkt->pPayload, pPkt->len);
+  }
+
+  BM_free(pPkt->pPayload);
+  pPkt->pPayload = NULL;
+
+  if (pChan->rxFrames >= L2CAP_STREAM_BATCH)
+  {
+    l2capStream_returnCredits(pChan);
+  }
+}
+
+/*********************************************************************
+ * @fn      l2capStream_returnCredits
+ *
+ * @brief   Return the credits of the LE-frames received since the last
+ *          return in one Flow Control Credit packet.
+ *
+ * @param   pChan - channel
+ *
+ * @return  none
+ */
+static void l2capStream_returnCredits(l2capStreamChan_t *pChan)
+{
+  if (pChan->rxFrames == 0)
+  {
+    return;
+  }
+
+  if (L2CAP_FlowCtrlCredit(pChan->CID, pChan->rxFrames) == SUCCESS)
+  {
+    pChan->rxFrames = 0;
+    pChan->stats.creditMsgs++;
+  }
+  // else retried with the next SDU or L2CAPStream_resume()
+}
+
+/*********************************************************************
+ * @fn      l2capStream_rate
+ *
+ * @brief   Compute a rate in bytes per second.
+ *
+ * @param   bytes - number of bytes
+ * @param   ticks - system ticks it took
+ *
+ * @return  bytes per second, 0 if no time was measured
+ */
+static uint32 l2capStream_rate(uint32 bytes, uint32 ticks)
+{
+  // Clock_tickPeriod is in microseconds
+  uint32 ms = (ticks / 1000) * Clock_tickPeriod +
+              ((ticks % 1000) * Clock_tickPeriod) / 1000;
+
+  if (ms == 0)
+  {
+    return 0;
+  }
+
+  if (ms > (0xFFFFFFFF / 1000))
+  {
+    return bytes / (ms / 1000);
+  }
+
+  return (bytes / ms) * 1000 + ((bytes % ms) * 1000) / ms;
+}
+
+/*********************************************************************
+*********************************************************************/
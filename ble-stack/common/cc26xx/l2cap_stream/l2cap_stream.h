@@ -0,0 +1,280 @@
+/******************************************************************************
+
+ @file  l2cap_stream.h
+
+ @brief This file contains the definitions and prototypes of the L2CAP
+        Connection Oriented Channel bulk transfer engine.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef L2CAP_STREAM_H
+#define L2CAP_STREAM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "bcomdef.h"
+#include "l2cap.h"
+#include "icall.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of channels that can stream at the same time
+#ifndef L2CAP_STREAM_MAX_CHANNELS
+#define L2CAP_STREAM_MAX_CHANNELS         2
+#endif
+
+// Number of SDUs prepared ahead of the stack on each channel
+#ifndef L2CAP_STREAM_WINDOW
+#define L2CAP_STREAM_WINDOW               2
+#endif
+
+// Largest SDU sent or received. SDUs are sized to the peer MTU up to this
+#ifndef L2CAP_STREAM_MAX_SDU
+#define L2CAP_STREAM_MAX_SDU              L2CAP_SDU_SIZE
+#endif
+
+// LE-frames the peer may send before credits are returned
+#ifndef L2CAP_STREAM_PEER_CREDITS
+#define L2CAP_STREAM_PEER_CREDITS         16
+#endif
+
+// LE-frames received before credits are returned to the peer, 0 returns
+// them once half of L2CAP_STREAM_PEER_CREDITS are used
+#ifndef L2CAP_STREAM_CREDIT_BATCH
+#define L2CAP_STREAM_CREDIT_BATCH         0
+#endif
+
+// Receive gaps longer than this (ms) are not counted in the receive rate
+#ifndef L2CAP_STREAM_RX_IDLE
+#define L2CAP_STREAM_RX_IDLE              500
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * Per channel transfer statistics. Rates are in bytes per second over the
+ * time a transfer was in progress.
+ */
+typedef struct
+{
+  uint32 txBytes;      //!< Bytes the stack reported sent
+  uint32 rxBytes;      //!< Bytes received
+  uint32 txRate;       //!< Sustained send rate
+  uint32 rxRate;       //!< Sustained receive rate
+  uint16 txSdus;       //!< SDUs sent
+  uint16 rxSdus;       //!< SDUs received
+  uint16 creditStalls; //!< Times sending waited for peer credits
+  uint16 creditMsgs;   //!< Flow Control Credit packets sent to the peer
+} l2capStreamStats_t;
+
+/**
+ * @brief   Read the next part of a transfer into an SDU.
+ *
+ * @param   CID - local channel id
+ * @param   offset - offset of the data in the transfer
+ * @param   pBuf - SDU payload to fill
+ * @param   len - number of bytes wanted
+ *
+ * @return  Number of bytes copied, 0 aborts the transfer.
+ */
+typedef uint16 (*pfnL2CAPStreamRead_t)(uint16 CID, uint32 offset,
+                                       uint8 *pBuf, uint16 len);
+
+/**
+ * @brief   Consume a received SDU. The payload is freed on return.
+ *
+ * @param   CID - local channel id
+ * @param   pData - SDU payload
+ * @param   len - SDU length
+ */
+typedef void (*pfnL2CAPStreamRecv_t)(uint16 CID, uint8 *pData, uint16 len);
+
+/**
+ * @brief   A transfer started by L2CAPStream_send ended.
+ *
+ * @param   CID - local channel id
+ * @param   status - SUCCESS, or why the transfer was aborted
+ * @param   len - number of bytes sent
+ */
+typedef void (*pfnL2CAPStreamDone_t)(uint16 CID, uint8 status, uint32 len);
+
+/**
+ * Application callbacks. Any of them can be NULL.
+ */
+typedef struct
+{
+  pfnL2CAPStreamRead_t pfnRead; //!< Data source of transfers
+  pfnL2CAPStreamRecv_t pfnRecv; //!< Data sink of received SDUs
+  pfnL2CAPStreamDone_t pfnDone; //!< Transfer completion
+} l2capStreamCBs_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      L2CAPStream_register
+ *
+ * @brief   Register a PSM for streaming and the application callbacks.
+ *          Channels of the PSM are added to the engine when they are
+ *          established, whichever side connected them.
+ *
+ * @param   selfEntity - ICall entity of the application task
+ * @param   psm - local PSM
+ * @param   pCBs - application callbacks, must stay valid
+ *
+ * @return  status of L2CAP_RegisterPsm()
+ */
+extern bStatus_t L2CAPStream_register(ICall_EntityID selfEntity, uint16 psm,
+                                      const l2capStreamCBs_t *pCBs);
+
+/*********************************************************************
+ * @fn      L2CAPStream_connect
+ *
+ * @brief   Connect a channel from the registered PSM to a peer PSM.
+ *          The channel is added when L2CAP_CHANNEL_ESTABLISHED_EVT is
+ *          received.
+ *
+ * @param   connHandle - connection to create the channel on
+ * @param   peerPsm - peer PSM
+ *
+ * @return  status of L2CAP_ConnectReq()
+ */
+extern bStatus_t L2CAPStream_connect(uint16 connHandle, uint16 peerPsm);
+
+/*********************************************************************
+ * @fn      L2CAPStream_send
+ *
+ * @brief   Start sending len bytes read from the pfnRead callback. The
+ *          data is split into SDUs of the peer MTU, up to
+ *          L2CAP_STREAM_WINDOW of which are prepared ahead so that the
+ *          next one is handed to the stack as soon as the previous one
+ *          is done. pfnDone is called when the transfer ends.
+ *
+ * @param   CID - local channel id
+ * @param   len - number of bytes to send
+ *
+ * @return  SUCCESS, INVALIDPARAMETER if the channel is not streaming,
+ *          blePending if a transfer is in progress, or the status of
+ *          the first L2CAP_SendSDU()
+ */
+extern bStatus_t L2CAPStream_send(uint16 CID, uint32 len);
+
+/*********************************************************************
+ * @fn      L2CAPStream_abort
+ *
+ * @brief   Abort the transfer in progress. The SDU already given to the
+ *          stack is still sent. pfnDone is called with FAILURE.
+ *
+ * @param   CID - local channel id
+ *
+ * @return  none
+ */
+extern void L2CAPStream_abort(uint16 CID);
+
+/*********************************************************************
+ * @fn      L2CAPStream_resume
+ *
+ * @brief   Retry SDUs the stack could not take for lack of buffers. It is
+ *          done on L2CAP_NUM_CTRL_DATA_PKT_EVT already; applications can
+ *          also call it at the end of connection events.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void L2CAPStream_resume(void);
+
+/*********************************************************************
+ * @fn      L2CAPStream_processStackMsg
+ *
+ * @brief   Process an L2CAP_SIGNAL_EVENT or L2CAP_DATA_EVENT message.
+ *
+ * @param   pMsg - message received by the application task
+ *
+ * @return  TRUE if the message was for a streaming channel, else FALSE
+ */
+extern uint8 L2CAPStream_processStackMsg(osal_event_hdr_t *pMsg);
+
+#ifdef ICALL_API_ASYNC
+/*********************************************************************
+ * @fn      L2CAPStream_processCmdStatus
+ *
+ * @brief   Process the completion of an SDU sent in asynchronous mode.
+ *
+ * @param   token - token of the completion from ICall_apiCmdStatus()
+ * @param   status - status of the completion
+ *
+ *          SDUs are sent in asynchronous mode from within the engine,
+ *          which leaves asynchronous mode disabled for the task.
+ *
+ * @return  TRUE if the command was sent by the engine, else FALSE
+ */
+extern uint8 L2CAPStream_processCmdStatus(uint8 token, uint8 status);
+#endif // ICALL_API_ASYNC
+
+/*********************************************************************
+ * @fn      L2CAPStream_getStats
+ *
+ * @brief   Get the transfer statistics of a channel.
+ *
+ * @param   CID - local channel id
+ * @param   pStats - statistics to fill
+ *
+ * @return  SUCCESS or INVALIDPARAMETER if the channel is not streaming
+ */
+extern bStatus_t L2CAPStream_getStats(uint16 CID, l2capStreamStats_t *pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* L2CAP_STREAM_H */
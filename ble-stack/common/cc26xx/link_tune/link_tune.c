@@ -0,0 +1,565 @@
+/******************************************************************************
+
+ @file  link_tune.c
+
+ @brief This file contains the link tuning manager. It negotiates the
+        maximum data length and ATT MTU of new connections and reports
+        the notification length with the best goodput once both
+        have settled.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "bcomdef.h"
+#include "hci_tl.h"
+#include "linkdb.h"
+#include "l2cap.h"
+#include "gatt.h"
+#include "ll.h"
+#include "ble_user_config.h"
+#include "util.h"
+
+#include "link_tune.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Maximum LL payload requested, no need to exceed the largest L2CAP PDU
+#ifndef LINK_TUNE_TX_OCTETS
+#define LINK_TUNE_TX_OCTETS               MIN(LL_MAX_LINK_DATA_LEN, MAX_PDU_SIZE)
+#endif
+
+// Time (us) of an LL packet on the 1M PHY: 14 bytes of preamble, access
+// address, header, MIC and CRC around the payload
+#define LINK_TUNE_OCTETS_TIME(octets)     (((octets) + 14) * 8)
+
+// Maximum LL packet time requested
+#ifndef LINK_TUNE_TX_TIME
+#define LINK_TUNE_TX_TIME                 LINK_TUNE_OCTETS_TIME(LINK_TUNE_TX_OCTETS)
+#endif
+
+// ATT MTU requested
+#ifndef LINK_TUNE_MTU
+#define LINK_TUNE_MTU                     (MAX_PDU_SIZE - L2CAP_HDR_SIZE)
+#endif
+
+// Opcode and handle of a notification or indication
+#define LINK_TUNE_NOTI_HDR_SIZE           3
+
+// Air time of an LL data packet besides its payload, in byte times: 14
+// bytes of preamble, access address, header, MIC and CRC, the empty packet
+// of the peer (10) and two inter frame spaces of 150 us (38)
+#define LINK_TUNE_PKT_OVERHEAD            62
+
+// Procedures a connection waits for
+#define LINK_TUNE_WAIT_DLE                0x01
+#define LINK_TUNE_WAIT_MTU                0x02
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Tuned connection
+typedef struct
+{
+  uint16 connHandle;  // Connection handle, INVALID_CONNHANDLE if free
+  uint8 wait;         // Procedures not done yet
+  uint32 start;       // Tick the connection was formed
+  linkTuneInfo_t info;
+} linkTuneConn_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static linkTuneConn_t tuneConns[LINK_TUNE_MAX_CONNS];
+
+static pfnLinkTuneCB_t tuneCBs[LINK_TUNE_MAX_CBS];
+
+static Util_ClockStruct settleClock;
+
+#ifdef LINK_TUNE_EXCHANGE_MTU
+static ICall_EntityID tuneEntity;
+#endif // LINK_TUNE_EXCHANGE_MTU
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static linkTuneConn_t *linkTune_findConn(uint16 connHandle);
+static void linkTune_update(linkTuneConn_t *pConn);
+static uint32 linkTune_airTime(uint16 frame, uint16 txOctets);
+static void linkTune_startClock(void);
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      LinkTune_init
+ *
+ * @brief   Initialize the link tuning manager.
+ *
+ * @param   selfEntity - ICall entity of the application task
+ * @param   clockCB - application clock handler
+ * @param   arg - argument of clockCB
+ *
+ * @return  none
+ */
+void LinkTune_init(ICall_EntityID selfEntity, Clock_FuncPtr clockCB, UArg arg)
+{
+  uint8 i;
+
+  for (i = 0; i < LINK_TUNE_MAX_CONNS; i++)
+  {
+    tuneConns[i].connHandle = INVALID_CONNHANDLE;
+  }
+
+  Util_constructClock(&settleClock, clockCB, LINK_TUNE_SETTLE_TIME, 0, false,
+                      arg);
+
+  // Let the controller use the longest packets on connections the peer
+  // updates first as well
+  HCI_LE_WriteSuggestedDefaultDataLenCmd(LINK_TUNE_TX_OCTETS,
+                                         LINK_TUNE_TX_TIME);
+
+#ifdef LINK_TUNE_EXCHANGE_MTU
+  // The MTU exchange is a GATT client procedure
+  tuneEntity = selfEntity;
+  GATT_InitClient();
+#endif // LINK_TUNE_EXCHANGE_MTU
+}
+
+/*********************************************************************
+ * @fn      LinkTune_register
+ *
+ * @brief   Register a callback for payload length changes.
+ *
+ * @param   pfnCB - callback
+ *
+ * @return  SUCCESS or bleNoResources
+ */
+bStatus_t LinkTune_register(pfnLinkTuneCB_t pfnCB)
+{
+  uint8 i;
+
+  for (i = 0; i < LINK_TUNE_MAX_CBS; i++)
+  {
+    if (tuneCBs[i] == NULL)
+    {
+      tuneCBs[i] = pfnCB;
+
+      return SUCCESS;
+    }
+  }
+
+  return bleNoResources;
+}
+
+/*********************************************************************
+ * @fn      LinkTune_connected
+ *
+ * @brief   Start the data length update and ATT MTU exchange of a new
+ *          connection.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkTune_connected(uint16 connHandle)
+{
+  linkTuneConn_t *pConn = linkTune_findConn(INVALID_CONNHANDLE);
+
+  if (pConn == NULL)
+  {
+    return;
+  }
+
+  pConn->connHandle = connHandle;
+  pConn->wait = 0;
+  pConn->start = Clock_getTicks();
+
+  // Values every connection starts with
+  pConn->info.mtu = ATT_MTU_SIZE;
+  pConn->info.txOctets = LL_MIN_LINK_DATA_LEN;
+  pConn->info.rxOctets = LL_MIN_LINK_DATA_LEN;
+  pConn->info.payloadLen = LinkTune_payloadLen(ATT_MTU_SIZE,
+                                               LL_MIN_LINK_DATA_LEN);
+  pConn->info.settled = FALSE;
+
+  if ((LINK_TUNE_TX_OCTETS > LL_MIN_LINK_DATA_LEN) &&
+      (HCI_LE_SetDataLenCmd(connHandle, LINK_TUNE_TX_OCTETS,
+                            LINK_TUNE_TX_TIME) == SUCCESS))
+  {
+    pConn->wait |= LINK_TUNE_WAIT_DLE;
+  }
+
+  if (LINK_TUNE_MTU > ATT_MTU_SIZE)
+  {
+#ifdef LINK_TUNE_EXCHANGE_MTU
+    attExchangeMTUReq_t req;
+
+    req.clientRxMTU = LINK_TUNE_MTU;
+
+    // If this fails, the peer may still start the exchange
+    VOID GATT_ExchangeMTU(connHandle, &req, tuneEntity);
+#endif // LINK_TUNE_EXCHANGE_MTU
+
+    pConn->wait |= LINK_TUNE_WAIT_MTU;
+  }
+
+  if (pConn->wait == 0)
+  {
+    linkTune_update(pConn);
+  }
+  else if (!Util_isActive(&settleClock))
+  {
+    Util_restartClock(&settleClock, LINK_TUNE_SETTLE_TIME);
+  }
+}
+
+/*********************************************************************
+ * @fn      LinkTune_disconnected
+ *
+ * @brief   Forget a connection.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+void LinkTune_disconnected(uint16 connHandle)
+{
+  linkTuneConn_t *pConn = linkTune_findConn(connHandle);
+
+  if (pConn != NULL)
+  {
+    pConn->connHandle = INVALID_CONNHANDLE;
+  }
+}
+
+/*********************************************************************
+ * @fn      LinkTune_processStackMsg
+ *
+ * @brief   Track LE Data Length Change events and ATT MTU updates.
+ *
+ * @param   pMsg - message received by the application task
+ *
+ * @return  none
+ */
+void LinkTune_processStackMsg(osal_event_hdr_t *pMsg)
+{
+  linkTuneConn_t *pConn;
+
+  if ((pMsg->event == HCI_GAP_EVENT_EVENT) &&
+      (pMsg->status == HCI_LE_EVENT_CODE))
+  {
+    hciEvt_BLEDataLengthChange_t *pEvt = (hciEvt_BLEDataLengthChange_t *)pMsg;
+
+    if ((pEvt->BLEEventCode == HCI_BLE_DATA_LENGTH_CHANGE_EVENT) &&
+        ((pConn = linkTune_findConn(pEvt->connHandle)) != NULL))
+    {
+      pConn->info.txOctets = pEvt->maxTxOctets;
+      pConn->info.rxOctets = pEvt->maxRxOctets;
+      pConn->wait &= ~LINK_TUNE_WAIT_DLE;
+
+      linkTune_update(pConn);
+    }
+  }
+  else if (pMsg->event == GATT_MSG_EVENT)
+  {
+    gattMsgEvent_t *pEvt = (gattMsgEvent_t *)pMsg;
+
+    if ((pConn = linkTune_findConn(pEvt->connHandle)) == NULL)
+    {
+      return;
+    }
+
+    if (pEvt->method == ATT_MTU_UPDATED_EVENT)
+    {
+      pConn->info.mtu = pEvt->msg.mtuEvt.MTU;
+      pConn->wait &= ~LINK_TUNE_WAIT_MTU;
+
+      linkTune_update(pConn);
+    }
+#ifdef LINK_TUNE_EXCHANGE_MTU
+    else if ((pEvt->method == ATT_ERROR_RSP) &&
+             (pEvt->msg.errorRsp.reqOpcode == ATT_EXCHANGE_MTU_REQ))
+    {
+      // Peer keeps the default MTU
+      pConn->wait &= ~LINK_TUNE_WAIT_MTU;
+
+      linkTune_update(pConn);
+    }
+#endif // LINK_TUNE_EXCHANGE_MTU
+  }
+}
+
+/*********************************************************************
+ * @fn      LinkTune_processTimeout
+ *
+ * @brief   Report the links whose procedures did not complete in time.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void LinkTune_processTimeout(void)
+{
+  uint32 settleTicks = (LINK_TUNE_SETTLE_TIME * 1000) / Clock_tickPeriod;
+  uint32 now = Clock_getTicks();
+  uint8 i;
+
+  for (i = 0; i < LINK_TUNE_MAX_CONNS; i++)
+  {
+    linkTuneConn_t *pConn = &tuneConns[i];
+
+    if ((pConn->connHandle != INVALID_CONNHANDLE) &&
+        !pConn->info.settled && ((now - pConn->start) >= settleTicks))
+    {
+      // Peer did not answer, or the values did not change
+      pConn->wait = 0;
+
+      linkTune_update(pConn);
+    }
+  }
+
+  linkTune_startClock();
+}
+
+/*********************************************************************
+ * @fn      LinkTune_getInfo
+ *
+ * @brief   Get the link parameters of a connection.
+ *
+ * @param   connHandle - connection handle
+ * @param   pInfo - parameters to fill
+ *
+ * @return  SUCCESS or INVALIDPARAMETER
+ */
+bStatus_t LinkTune_getInfo(uint16 connHandle, linkTuneInfo_t *pInfo)
+{
+  linkTuneConn_t *pConn;
+
+  if ((connHandle == INVALID_CONNHANDLE) ||
+      ((pConn = linkTune_findConn(connHandle)) == NULL))
+  {
+    return INVALIDPARAMETER;
+  }
+
+  *pInfo = pConn->info;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      LinkTune_payloadLen
+ *
+ * @brief   Notification value length with the best goodput. See the
+ *          header for the limits of the estimate.
+ *
+ * @param   mtu - ATT MTU
+ * @param   txOctets - maximum LL payload sent
+ *
+ * @return  value length
+ */
+uint16 LinkTune_payloadLen(uint16 mtu, uint16 txOctets)
+{
+  // Largest L2CAP frame carrying an ATT PDU
+  uint16 full = mtu + L2CAP_HDR_SIZE;
+  uint16 whole;
+
+  if ((txOctets == 0) || ((full % txOctets) == 0) || (full < txOctets))
+  {
+    // Fills a single packet or whole packets already
+    return mtu - LINK_TUNE_NOTI_HDR_SIZE;
+  }
+
+  // Drop the partly filled last packet when the bytes it carries cost more
+  // air time than they are worth
+  whole = full - (full % txOctets);
+
+  if (((uint32)(whole - L2CAP_HDR_SIZE - LINK_TUNE_NOTI_HDR_SIZE) *
+       linkTune_airTime(full, txOctets)) >
+      ((uint32)(full - L2CAP_HDR_SIZE - LINK_TUNE_NOTI_HDR_SIZE) *
+       linkTune_airTime(whole, txOctets)))
+  {
+    return whole - L2CAP_HDR_SIZE - LINK_TUNE_NOTI_HDR_SIZE;
+  }
+
+  return mtu - LINK_TUNE_NOTI_HDR_SIZE;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      linkTune_findConn
+ *
+ * @brief   Find a tuned connection.
+ *
+ * @param   connHandle - connection handle, INVALID_CONNHANDLE
+ *                       for a free entry
+ *
+ * @return  connection, or NULL if not found
+ */
+static linkTuneConn_t *linkTune_findConn(uint16 connHandle)
+{
+  uint8 i;
+
+  for (i = 0; i < LINK_TUNE_MAX_CONNS; i++)
+  {
+    if (tuneConns[i].connHandle == connHandle)
+    {
+      return &tuneConns[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      linkTune_update
+ *
+ * @brief   Recompute the payload length of a connection and report it
+ *          once both procedures are done, or when it changes later.
+ *
+ * @param   pConn - connection
+ *
+ * @return  none
+ */
+static void linkTune_update(linkTuneConn_t *pConn)
+{
+  uint16 payloadLen;
+  uint8 i;
+
+  if (pConn->wait != 0)
+  {
+    // Don't make profiles resize twice while the link is being set up
+    return;
+  }
+
+  payloadLen = LinkTune_payloadLen(pConn->info.mtu, pConn->info.txOctets);
+
+  if (pConn->info.settled && (payloadLen == pConn->info.payloadLen))
+  {
+    return;
+  }
+
+  pConn->info.payloadLen = payloadLen;
+  pConn->info.settled = TRUE;
+
+  for (i = 0; i < LINK_TUNE_MAX_CBS; i++)
+  {
+    if (tuneCBs[i] != NULL)
+    {
+      tuneCBs[i](pConn->connHandle, payloadLen);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      linkTune_airTime
+ *
+ * @brief   Air time of an L2CAP frame in byte times.
+ *
+ * @param   frame - L2CAP frame length
+ * @param   txOctets - maximum LL payload sent
+ *
+ * @return  air time
+ */
+static uint32 linkTune_airTime(uint16 frame, uint16 txOctets)
+{
+  uint16 numPkts = (frame + txOctets - 1) / txOctets;
+
+  return frame + ((uint32)numPkts * LINK_TUNE_PKT_OVERHEAD);
+}
+
+/*********************************************************************
+ * @fn      linkTune_startClock
+ *
+ * @brief   Start the settle clock for the connection closest to its
+ *          timeout, if any.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void linkTune_startClock(void)
+{
+  uint32 settleTicks = (LINK_TUNE_SETTLE_TIME * 1000) / Clock_tickPeriod;
+  uint32 now = Clock_getTicks();
+  uint32 next = settleTicks;
+  uint8 i;
+
+  for (i = 0; i < LINK_TUNE_MAX_CONNS; i++)
+  {
+    linkTuneConn_t *pConn = &tuneConns[i];
+
+    if ((pConn->connHandle != INVALID_CONNHANDLE) &&
+        !pConn->info.settled)
+    {
+      uint32 elapsed = now - pConn->start;
+
+      if (elapsed < settleTicks)
+      {
+        next = MIN(next, settleTicks - elapsed);
+      }
+    }
+  }
+
+  if (next < settleTicks)
+  {
+    // Round up to whole milliseconds
+    Util_restartClock(&settleClock,
+                      ((next * Clock_tickPeriod) + 999) / 1000);
+  }
+}
+
+/*********************************************************************
+*********************************************************************/
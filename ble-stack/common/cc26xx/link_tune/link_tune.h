@@ -0,0 +1,230 @@
+/******************************************************************************
+
+ @file  link_tune.h
+
+ @brief This file contains the definitions and prototypes of the link
+        tuning manager.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+
+#ifndef LINK_TUNE_H
+#define LINK_TUNE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <ti/sysbios/knl/Clock.h>
+
+#include "bcomdef.h"
+#include "icall.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of connections tuned at the same time
+#ifndef LINK_TUNE_MAX_CONNS
+#define LINK_TUNE_MAX_CONNS               1
+#endif
+
+// Number of payload length callbacks
+#ifndef LINK_TUNE_MAX_CBS
+#define LINK_TUNE_MAX_CBS                 4
+#endif
+
+// Time (ms) given to the data length and MTU procedures before the values
+// in use are reported
+#ifndef LINK_TUNE_SETTLE_TIME
+#define LINK_TUNE_SETTLE_TIME             3000
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * Link parameters of a connection.
+ */
+typedef struct
+{
+  uint16 mtu;        //!< ATT MTU
+  uint16 txOctets;   //!< Maximum LL payload sent
+  uint16 rxOctets;   //!< Maximum LL payload received
+  uint16 payloadLen; //!< Notification value length with the best goodput
+  uint8 settled;     //!< TRUE once both procedures are done or timed out
+} linkTuneInfo_t;
+
+/**
+ * @brief   The effective payload length of a connection changed.
+ *
+ * @param   connHandle - connection handle
+ * @param   payloadLen - notification or indication value length with
+ *                       the best goodput, see LinkTune_payloadLen()
+ */
+typedef void (*pfnLinkTuneCB_t)(uint16 connHandle, uint16 payloadLen);
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      LinkTune_init
+ *
+ * @brief   Initialize the link tuning manager and set the suggested
+ *          default data length of the controller.
+ *
+ * @param   selfEntity - ICall entity of the application task
+ * @param   clockCB - application clock handler, called with arg when the
+ *                    application must call LinkTune_processTimeout()
+ * @param   arg - argument of clockCB
+ *
+ * @return  none
+ */
+extern void LinkTune_init(ICall_EntityID selfEntity, Clock_FuncPtr clockCB,
+                          UArg arg);
+
+/*********************************************************************
+ * @fn      LinkTune_register
+ *
+ * @brief   Register a callback for payload length changes, e.g. from a
+ *          profile that sizes its notifications.
+ *
+ * @param   pfnCB - callback
+ *
+ * @return  SUCCESS or bleNoResources
+ */
+extern bStatus_t LinkTune_register(pfnLinkTuneCB_t pfnCB);
+
+/*********************************************************************
+ * @fn      LinkTune_connected
+ *
+ * @brief   Start the data length update and ATT MTU exchange of a new
+ *          connection.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+extern void LinkTune_connected(uint16 connHandle);
+
+/*********************************************************************
+ * @fn      LinkTune_disconnected
+ *
+ * @brief   Forget a connection.
+ *
+ * @param   connHandle - connection handle
+ *
+ * @return  none
+ */
+extern void LinkTune_disconnected(uint16 connHandle);
+
+/*********************************************************************
+ * @fn      LinkTune_processStackMsg
+ *
+ * @brief   Track LE Data Length Change events (HCI_GAP_EVENT_EVENT) and
+ *          ATT MTU updates (GATT_MSG_EVENT). The message is only read.
+ *
+ * @param   pMsg - message received by the application task
+ *
+ * @return  none
+ */
+extern void LinkTune_processStackMsg(osal_event_hdr_t *pMsg);
+
+/*********************************************************************
+ * @fn      LinkTune_processTimeout
+ *
+ * @brief   Report the links whose procedures did not complete within
+ *          LINK_TUNE_SETTLE_TIME.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void LinkTune_processTimeout(void);
+
+/*********************************************************************
+ * @fn      LinkTune_getInfo
+ *
+ * @brief   Get the link parameters of a connection.
+ *
+ * @param   connHandle - connection handle
+ * @param   pInfo - parameters to fill
+ *
+ * @return  SUCCESS or INVALIDPARAMETER
+ */
+extern bStatus_t LinkTune_getInfo(uint16 connHandle, linkTuneInfo_t *pInfo);
+
+/*********************************************************************
+ * @fn      LinkTune_payloadLen
+ *
+ * @brief   Notification value length with the best goodput: the MTU
+ *          limit, or the longest value whose L2CAP frame fills whole LL
+ *          packets when the partly filled last packet of the MTU limit
+ *          costs more air time per byte.
+ *
+ *          The estimate is per packet and ignores connection events.
+ *          Trimming wins when the number of packets per event is limited,
+ *          by the controller (MAX_NUM_PDU) or by the peer. When the
+ *          event length is the only limit, the short last packet of the
+ *          MTU limit can fit in the time left at the end of an event
+ *          that no whole packet fits in, and trimming may lose: with an
+ *          ATT MTU of 185 and 185 octets at a 7.5 ms interval, 178 byte
+ *          values give 569.6 kbit/s against 582.4 for 182 bytes (see
+ *          tools/linktune/goodput.py).
+ *
+ * @param   mtu - ATT MTU
+ * @param   txOctets - maximum LL payload sent
+ *
+ * @return  value length
+ */
+extern uint16 LinkTune_payloadLen(uint16 mtu, uint16 txOctets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LINK_TUNE_H */
@@ -64,7 +64,7 @@
  */
    
 // Clock instance for Calibration injections
-static Clock_Struct  injectCalibrationClock;
+static Util_ClockStruct injectCalibrationClock;
 
 // Power Notify Object for wake-up callbacks
 Power_NotifyObj injectCalibrationPowerNotifyObj;
@@ -83,6 +83,10 @@ typedef struct _queueRec_
  * LOCAL FUNCTIONS
  */
 
+#ifdef ICALL_TIMER_WHEEL
+static void Util_wheelClockFunc(ICall_WheelTimer *timer);
+#endif //ICALL_TIMER_WHEEL
+
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -109,15 +113,33 @@ typedef struct _queueRec_
  * @param   startFlag     - TRUE to start immediately, FALSE to wait.
  * @param   arg           - argument passed to callback function.
  *
- * @return  Clock_Handle  - a handle to the clock instance.
+ * @return  Util_ClockHandle - a handle to the clock instance.
  */
-Clock_Handle Util_constructClock(Clock_Struct *pClock,
-                                 Clock_FuncPtr clockCB,
-                                 uint32_t clockDuration,
-                                 uint32_t clockPeriod,
-                                 uint8_t startFlag,
-                                 UArg arg)
+Util_ClockHandle Util_constructClock(Util_ClockStruct *pClock,
+                                     Clock_FuncPtr clockCB,
+                                     uint32_t clockDuration,
+                                     uint32_t clockPeriod,
+                                     uint8_t startFlag,
+                                     UArg arg)
 {
+#ifdef ICALL_TIMER_WHEEL
+  // Convert clockDuration in milliseconds to ticks.
+  uint32_t clockTicks = clockDuration * (1000 / Clock_tickPeriod);
+
+  pClock->clockCB = clockCB;
+  pClock->arg = arg;
+
+  // If period is 0, this is a one-shot timer.
+  ICall_wheelConstruct(&pClock->timer, Util_wheelClockFunc, clockTicks,
+                       clockPeriod * (1000 / Clock_tickPeriod));
+
+  if (startFlag)
+  {
+    ICall_wheelStart(&pClock->timer);
+  }
+
+  return pClock;
+#else //!ICALL_TIMER_WHEEL
   Clock_Params clockParams;
 
   // Convert clockDuration in milliseconds to ticks.
@@ -140,6 +162,7 @@ Clock_Handle Util_constructClock(Clock_Struct *pClock,
   Clock_construct(pClock, clockCB, clockTicks, &clockParams);
 
   return Clock_handle(pClock);
+#endif //ICALL_TIMER_WHEEL
 }
 
 /*********************************************************************
@@ -151,12 +174,16 @@ Clock_Handle Util_constructClock(Clock_Struct *pClock,
  *
  * @return  none
  */
-void Util_startClock(Clock_Struct *pClock)
+void Util_startClock(Util_ClockStruct *pClock)
 {
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelStart(&pClock->timer);
+#else //!ICALL_TIMER_WHEEL
   Clock_Handle handle = Clock_handle(pClock);
 
   // Start clock instance
   Clock_start(handle);
+#endif //ICALL_TIMER_WHEEL
 }
 
 /*********************************************************************
@@ -169,9 +196,17 @@ void Util_startClock(Clock_Struct *pClock)
  *
  * @return  none
  */
-void Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout)
+void Util_restartClock(Util_ClockStruct *pClock, uint32_t clockTimeout)
 {
   uint32_t clockTicks;
+#ifdef ICALL_TIMER_WHEEL
+  // Convert timeout in milliseconds to ticks.
+  clockTicks = clockTimeout * (1000 / Clock_tickPeriod);
+
+  // Starting a running timer restarts it with the new timeout
+  ICall_wheelSetTimeout(&pClock->timer, clockTicks);
+  ICall_wheelStart(&pClock->timer);
+#else //!ICALL_TIMER_WHEEL
   Clock_Handle handle;
 
   handle = Clock_handle(pClock);
@@ -190,6 +225,7 @@ void Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout)
 
   // Start clock instance
   Clock_start(handle);
+#endif //ICALL_TIMER_WHEEL
 }
 
 /*********************************************************************
@@ -202,12 +238,16 @@ void Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout)
  * @return  TRUE if Clock is currently active
             FALSE otherwise
  */
-bool Util_isActive(Clock_Struct *pClock)
+bool Util_isActive(Util_ClockStruct *pClock)
 {
+#ifdef ICALL_TIMER_WHEEL
+  return ICall_wheelIsActive(&pClock->timer);
+#else //!ICALL_TIMER_WHEEL
   Clock_Handle handle = Clock_handle(pClock);
 
   // Start clock instance
   return Clock_isActive(handle);
+#endif //ICALL_TIMER_WHEEL
 }
 
 /*********************************************************************
@@ -219,12 +259,16 @@ bool Util_isActive(Clock_Struct *pClock)
  *
  * @return  none
  */
-void Util_stopClock(Clock_Struct *pClock)
+void Util_stopClock(Util_ClockStruct *pClock)
 {
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelStop(&pClock->timer);
+#else //!ICALL_TIMER_WHEEL
   Clock_Handle handle = Clock_handle(pClock);
 
   // Stop clock instance
   Clock_stop(handle);
+#endif //ICALL_TIMER_WHEEL
 }
 
 /*********************************************************************
@@ -236,10 +280,24 @@ void Util_stopClock(Clock_Struct *pClock)
  * @param   clockPeriod - longevity of clock timer in milliseconds
  * @return  none
  */
-void Util_rescheduleClock(Clock_Struct *pClock, uint32_t clockPeriod)
+void Util_rescheduleClock(Util_ClockStruct *pClock, uint32_t clockPeriod)
 {
   bool running;
   uint32_t clockTicks;
+#ifdef ICALL_TIMER_WHEEL
+  running = ICall_wheelIsActive(&pClock->timer);
+
+  // Convert period in milliseconds to ticks.
+  clockTicks = clockPeriod * (1000 / Clock_tickPeriod);
+
+  ICall_wheelSetTimeout(&pClock->timer, clockTicks);
+  ICall_wheelSetPeriod(&pClock->timer, clockTicks);
+
+  if (running)
+  {
+    ICall_wheelStart(&pClock->timer);
+  }
+#else //!ICALL_TIMER_WHEEL
   Clock_Handle handle;
 
   handle = Clock_handle(pClock);
@@ -260,8 +318,27 @@ void Util_rescheduleClock(Clock_Struct *pClock, uint32_t clockPeriod)
   {
     Clock_start(handle);
   }
+#endif //ICALL_TIMER_WHEEL
 }
 
+#ifdef ICALL_TIMER_WHEEL
+/*********************************************************************
+ * @fn      Util_wheelClockFunc
+ *
+ * @brief   Timer wheel expiry function of the Util clocks.
+ *
+ * @param   timer - timer embedded in a Util_ClockStruct
+ *
+ * @return  none
+ */
+static void Util_wheelClockFunc(ICall_WheelTimer *timer)
+{
+  Util_ClockStruct *pClock = (Util_ClockStruct *)timer;
+
+  pClock->clockCB(pClock->arg);
+}
+#endif //ICALL_TIMER_WHEEL
+
 /*********************************************************************
  * @fn      Util_constructQueue
  *
@@ -370,6 +447,128 @@ uint8_t *Util_dequeueMsg(Queue_Handle msgQueue)
   return NULL;
 }
 
+/*********************************************************************
+ * @fn      Util_constructPool
+ *
+ * @brief   Initialize a pool of fixed-size blocks. Each block must start
+ *          with a Queue_Elem so that it can be queued to an RTOS queue
+ *          without a separate queue node.
+ *
+ * @param   pPool   - pointer to queue instance structure holding the
+ *                    free blocks.
+ * @param   pBuf    - storage for the blocks.
+ * @param   blkSize - size of one block in bytes.
+ * @param   numBlks - number of blocks in pBuf.
+ *
+ * @return  A handle to the pool.
+ */
+Queue_Handle Util_constructPool(Queue_Struct *pPool, void *pBuf,
+                                uint16_t blkSize, uint16_t numBlks)
+{
+  Queue_Handle pool = Util_constructQueue(pPool);
+  uint8_t *pBlk = (uint8_t *)pBuf;
+
+  // Put every block on the free list.
+  while (numBlks--)
+  {
+    Queue_put(pool, (Queue_Elem *)pBlk);
+    pBlk += blkSize;
+  }
+
+  return pool;
+}
+
+/*********************************************************************
+ * @fn      Util_poolAlloc
+ *
+ * @brief   Take a block from a pool. Safe to call from any context.
+ *
+ * @param   pool - pool handle.
+ *
+ * @return  pointer to the block, NULL if the pool is empty.
+ */
+void *Util_poolAlloc(Queue_Handle pool)
+{
+  // This is an atomic operation
+  Queue_Elem *pBlk = Queue_get(pool);
+
+  if (pBlk != (Queue_Elem *)pool)
+  {
+    return pBlk;
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      Util_poolFree
+ *
+ * @brief   Return a block to its pool. Safe to call from any context.
+ *
+ * @param   pool - pool handle.
+ * @param   pBlk - block obtained from Util_poolAlloc.
+ *
+ * @return  none
+ */
+void Util_poolFree(Queue_Handle pool, void *pBlk)
+{
+  // This is an atomic operation
+  Queue_put(pool, (Queue_Elem *)pBlk);
+}
+
+/*********************************************************************
+ * @fn      Util_enqueuePoolMsg
+ *
+ * @brief   Puts a pool block in RTOS queue. Unlike Util_enqueueMsg, no
+ *          queue node is allocated since the block carries its own
+ *          Queue_Elem.
+ *
+ * @param   msgQueue - queue handle.
+ * @param   sem - thread's event processing semaphore that queue is
+ *                associated with.
+ * @param   pBlk - pointer to pool block to be queued
+ *
+ * @return  none
+ */
+void Util_enqueuePoolMsg(Queue_Handle msgQueue,
+#ifdef ICALL_EVENTS
+                         Event_Handle event,
+#else //!ICALL_EVENTS
+                         Semaphore_Handle sem,
+#endif //ICALL_EVENTS
+                         void *pBlk)
+{
+  // This is an atomic operation
+  Queue_put(msgQueue, (Queue_Elem *)pBlk);
+
+  // Wake up the application thread event handler.
+#ifdef ICALL_EVENTS
+  if (event)
+  {
+    Event_post(event, UTIL_QUEUE_EVENT_ID);
+  }
+#else //!ICALL_EVENTS
+  if (sem)
+  {
+    Semaphore_post(sem);
+  }
+#endif //ICALL_EVENTS
+}
+
+/*********************************************************************
+ * @fn      Util_dequeuePoolMsg
+ *
+ * @brief   Dequeues a pool block from the RTOS queue.
+ *
+ * @param   msgQueue - queue handle.
+ *
+ * @return  pointer to dequeued block, NULL otherwise.
+ */
+void *Util_dequeuePoolMsg(Queue_Handle msgQueue)
+{
+  return Util_poolAlloc(msgQueue);
+}
+
 /*********************************************************************
  * @fn      Util_convertBdAddr2Str
  *
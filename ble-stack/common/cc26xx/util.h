@@ -62,6 +62,9 @@ extern "C" {
 #else //!ICALL_EVENTS
 #include <ti/sysbios/knl/Semaphore.h>
 #endif //ICALL_EVENTS
+#ifdef ICALL_TIMER_WHEEL
+#include <icall.h>
+#endif //ICALL_TIMER_WHEEL
 
 /*********************************************************************
 *  EXTERNAL VARIABLES
@@ -89,6 +92,22 @@ typedef struct
   uint8_t state; // Event state;
 }appEvtHdr_t;
 
+#ifdef ICALL_TIMER_WHEEL
+// Clock instance running on the ICall timer wheel instead of a TIRTOS Clock.
+typedef struct
+{
+  ICall_WheelTimer timer;  // Timer wheel entry, must be first.
+  Clock_FuncPtr clockCB;   // Callback function upon clock expiration.
+  UArg arg;                // Argument passed to callback function.
+} Util_ClockStruct;
+
+typedef Util_ClockStruct *Util_ClockHandle;
+#else //!ICALL_TIMER_WHEEL
+typedef Clock_Struct Util_ClockStruct;
+
+typedef Clock_Handle Util_ClockHandle;
+#endif //ICALL_TIMER_WHEEL
+
 /*********************************************************************
  * MACROS
  */
@@ -110,14 +129,14 @@ typedef struct
  * @param   startFlag     - TRUE to start immediately, FALSE to wait.
  * @param   arg           - argument passed to callback function.
  *
- * @return  Clock_Handle  - a handle to the clock instance.
+ * @return  Util_ClockHandle - a handle to the clock instance.
  */
-extern Clock_Handle Util_constructClock(Clock_Struct *pClock,
-                                        Clock_FuncPtr clockCB,
-                                        uint32_t clockDuration,
-                                        uint32_t clockPeriod,
-                                        uint8_t startFlag,
-                                        UArg arg);
+extern Util_ClockHandle Util_constructClock(Util_ClockStruct *pClock,
+                                            Clock_FuncPtr clockCB,
+                                            uint32_t clockDuration,
+                                            uint32_t clockPeriod,
+                                            uint8_t startFlag,
+                                            UArg arg);
 
 /*********************************************************************
  * @fn      Util_startClock
@@ -128,7 +147,7 @@ extern Clock_Handle Util_constructClock(Clock_Struct *pClock,
  *
  * @return  none
  */
-extern void Util_startClock(Clock_Struct *pClock);
+extern void Util_startClock(Util_ClockStruct *pClock);
 
 /*********************************************************************
  * @fn      Util_setClockTimeout
@@ -140,7 +159,8 @@ extern void Util_startClock(Clock_Struct *pClock);
  *
  * @return  none
  */
-extern void Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout);
+extern void Util_restartClock(Util_ClockStruct *pClock,
+                              uint32_t clockTimeout);
 
 /*********************************************************************
  * @fn      Util_isActive
@@ -151,7 +171,7 @@ extern void Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout);
  *
  * @return  TRUE or FALSE
  */
-extern bool Util_isActive(Clock_Struct *pClock);
+extern bool Util_isActive(Util_ClockStruct *pClock);
 
 /*********************************************************************
  * @fn      Util_stopClock
@@ -162,7 +182,7 @@ extern bool Util_isActive(Clock_Struct *pClock);
  *
  * @return  none
  */
-extern void Util_stopClock(Clock_Struct *pClock);
+extern void Util_stopClock(Util_ClockStruct *pClock);
 
 /*********************************************************************
  * @fn      Util_rescheduleClock
@@ -173,7 +193,8 @@ extern void Util_stopClock(Clock_Struct *pClock);
  * @param   clockPeriod - longevity of clock timer in milliseconds
  * @return  none
  */
-extern void Util_rescheduleClock(Clock_Struct *pClock, uint32_t clockPeriod);
+extern void Util_rescheduleClock(Util_ClockStruct *pClock,
+                                 uint32_t clockPeriod);
 
 /*********************************************************************
  * @fn      Util_constructQueue
@@ -223,6 +244,85 @@ extern uint8_t Util_enqueueMsg(Queue_Handle msgQueue,
  */
 extern uint8_t *Util_dequeueMsg(Queue_Handle msgQueue);
 
+/*********************************************************************
+ * @fn      Util_constructPool
+ *
+ * @brief   Initialize a pool of fixed-size blocks. Each block must start
+ *          with a Queue_Elem so that it can be queued to an RTOS queue
+ *          without a separate queue node.
+ *
+ * @param   pPool   - pointer to queue instance structure holding the
+ *                    free blocks.
+ * @param   pBuf    - storage for the blocks.
+ * @param   blkSize - size of one block in bytes.
+ * @param   numBlks - number of blocks in pBuf.
+ *
+ * @return  A handle to the pool.
+ */
+extern Queue_Handle Util_constructPool(Queue_Struct *pPool, void *pBuf,
+                                       uint16_t blkSize, uint16_t numBlks);
+
+/*********************************************************************
+ * @fn      Util_poolAlloc
+ *
+ * @brief   Take a block from a pool. Safe to call from any context.
+ *
+ * @param   pool - pool handle.
+ *
+ * @return  pointer to the block, NULL if the pool is empty.
+ */
+extern void *Util_poolAlloc(Queue_Handle pool);
+
+/*********************************************************************
+ * @fn      Util_poolFree
+ *
+ * @brief   Return a block to its pool. Safe to call from any context.
+ *
+ * @param   pool - pool handle.
+ * @param   pBlk - block obtained from Util_poolAlloc.
+ *
+ * @return  none
+ */
+extern void Util_poolFree(Queue_Handle pool, void *pBlk);
+
+/*********************************************************************
+ * @fn      Util_enqueuePoolMsg
+ *
+ * @brief   Puts a pool block in RTOS queue. Unlike Util_enqueueMsg, no
+ *          queue node is allocated since the block carries its own
+ *          Queue_Elem.
+ *
+ * @param   msgQueue - queue handle.
+ *
+ * @param   event - the thread's event processing event that this queue is
+ *                  associated with.
+ *
+ * @param   sem - the thread's event processing semaphore that this queue is
+ *                associated with.
+ *
+ * @param   pBlk - pointer to pool block to be queued
+ *
+ * @return  none
+ */
+extern void Util_enqueuePoolMsg(Queue_Handle msgQueue,
+#ifdef ICALL_EVENTS
+                                Event_Handle event,
+#else //!ICALL_EVENTS
+                                Semaphore_Handle sem,
+#endif //ICALL_EVENTS
+                                void *pBlk);
+
+/*********************************************************************
+ * @fn      Util_dequeuePoolMsg
+ *
+ * @brief   Dequeues a pool block from the RTOS queue.
+ *
+ * @param   msgQueue - queue handle.
+ *
+ * @return  pointer to dequeued block, NULL otherwise.
+ */
+extern void *Util_dequeuePoolMsg(Queue_Handle msgQueue);
+
 /*********************************************************************
  * @fn      Util_convertBdAddr2Str
  *
@@ -58,6 +58,12 @@
 #include <driverlib/trng.h>
 #include <TRNGCC26XX.h>
 
+#include "cs_prof.h"
+
+#ifdef TRNGCC26XX_POOL
+#include <inc/hw_ints.h>
+#endif // TRNGCC26XX_POOL
+
 /*******************************************************************************
  * CONSTANTS
  */
@@ -78,10 +84,66 @@
 #define TRNGCC26XX_IS_NOT_INITIALIZED 0
 #define TRNGCC26XX_IS_INITIALIZED     1
 
+#ifdef TRNGCC26XX_POOL
+// Entropy pool size in 32 bit words.  Must be a power of 2, 128 at most.
+#ifndef TRNGCC26XX_POOL_SIZE
+#define TRNGCC26XX_POOL_SIZE                  16
+#endif // TRNGCC26XX_POOL_SIZE
+
+#define TRNGCC26XX_POOL_MASK                  (TRNGCC26XX_POOL_SIZE - 1)
+
+// Refill is started once the pool holds this many words or less.
+#define TRNGCC26XX_POOL_LOW_WATER             (TRNGCC26XX_POOL_SIZE / 2)
+
+// Number of DRBG output words after which the DRBG key is reseeded.
+#ifndef TRNGCC26XX_DRBG_RESEED_WORDS
+#define TRNGCC26XX_DRBG_RESEED_WORDS          1024
+#endif // TRNGCC26XX_DRBG_RESEED_WORDS
+
+// DRBG key and block sizes in 32 bit words (ChaCha20).
+#define TRNGCC26XX_DRBG_KEY_WORDS             8
+#define TRNGCC26XX_DRBG_BLOCK_WORDS           16
+
+// Pool refill states
+#define TRNGCC26XX_POOL_IDLE                  0
+#define TRNGCC26XX_POOL_REFILL                1
+
+#define TRNGCC26XX_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define TRNGCC26XX_QUARTER_ROUND(x, a, b, c, d)                                \
+  x[a] += x[b]; x[d] ^= x[a]; x[d] = TRNGCC26XX_ROTL(x[d], 16);                \
+  x[c] += x[d]; x[b] ^= x[c]; x[b] = TRNGCC26XX_ROTL(x[b], 12);                \
+  x[a] += x[b]; x[d] ^= x[a]; x[d] = TRNGCC26XX_ROTL(x[d], 8);                 \
+  x[c] += x[d]; x[b] ^= x[c]; x[b] = TRNGCC26XX_ROTL(x[b], 7)
+#endif // TRNGCC26XX_POOL
+
 /*******************************************************************************
  * LOCAL VARIABLES
  */
 
+#ifdef TRNGCC26XX_POOL
+// Entropy pool, filled from the TRNG interrupt.
+static uint32_t trngPool[TRNGCC26XX_POOL_SIZE];
+static uint8_t  trngPoolHead;
+static uint8_t  trngPoolCount;
+static uint8_t  trngPoolState = TRNGCC26XX_POOL_IDLE;
+
+// TRNG interrupt.
+static Hwi_Struct trngHwi;
+
+// DRBG serving requests while the pool is empty.
+static uint32_t trngDrbgKey[TRNGCC26XX_DRBG_KEY_WORDS];
+static uint32_t trngDrbgCounter;
+static uint32_t trngDrbgOut[TRNGCC26XX_DRBG_BLOCK_WORDS -
+                            TRNGCC26XX_DRBG_KEY_WORDS];
+static uint8_t  trngDrbgAvail;
+static uint16_t trngDrbgUsed;
+static uint8_t  trngDrbgSeeded;
+
+// Number of TRNG words still to be mixed into the DRBG key.
+static uint8_t  trngDrbgReseed = TRNGCC26XX_DRBG_KEY_WORDS;
+#endif // TRNGCC26XX_POOL
+
 /*******************************************************************************
  * GLOBAL VARIABLES
  */
@@ -98,6 +160,16 @@ extern const TRNGCC26XX_Config TRNGCC26XX_config[];
 void closeTRNG(TRNGCC26XX_Handle handle);
 void openTRNG(TRNGCC26XX_Handle handle);
 
+#ifdef TRNGCC26XX_POOL
+static void trngPoolHwiFxn(UArg arg);
+static void trngPoolStartRefill(void);
+static void trngPoolStopRefill(void);
+static uint8_t trngPoolGet(uint32_t *pWord);
+static void trngDrbgBlock(uint32_t *pOut, const uint32_t *pKey,
+                          uint32_t counter);
+static uint8_t trngDrbgGet(uint32_t *pWord);
+#endif // TRNGCC26XX_POOL
+
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  */
@@ -115,9 +187,23 @@ void TRNGCC26XX_init(void)
 
   if (isInit == TRNGCC26XX_IS_NOT_INITIALIZED)
   {
+#ifdef TRNGCC26XX_POOL
+    Hwi_Params hwiParams;
+#endif // TRNGCC26XX_POOL
+
     // Intialize internal state of TRNG Peripherals to closed.
     ((TRNGCC26XX_Object *)(TRNGCC26XX_config[TRNGCC26XXX_PERIPHERAL_0_INDEX].object))->state = TRNGCC26XX_CLOSED;
 
+#ifdef TRNGCC26XX_POOL
+    // The TRNG interrupt refills the entropy pool in the background.
+    Hwi_Params_init(&hwiParams);
+    hwiParams.priority = ~0;
+    Hwi_construct(&trngHwi, INT_TRNG_IRQ, trngPoolHwiFxn, &hwiParams, NULL);
+
+    // Seed the DRBG and fill the pool.
+    trngPoolStartRefill();
+#endif // TRNGCC26XX_POOL
+
     isInit = TRNGCC26XX_IS_INITIALIZED;
   }
 
@@ -195,8 +281,27 @@ uint32_t TRNGCC26XX_getNumber(TRNGCC26XX_Handle handle, TRNGCC26XX_Params *param
   uint16_t hwiKey;
   uint32_t trngVal;
 
+#ifdef TRNGCC26XX_POOL
+  // Requests using the default configuration are served from the entropy
+  // pool, or from the DRBG while the pool is empty.
+  if ((!params                                                          ||
+       (params->minSamplesPerCycle == TRNGCC26XX_MIN_SAMPLES_DEFAULT    &&
+        params->maxSamplesPerCycle == TRNGCC26XX_MAX_SAMPLES_DEFAULT    &&
+        params->clocksPerSample    == TRNGCC26XX_SAMPLE_RATE_DEFAULT))  &&
+      (trngPoolGet(&trngVal) || trngDrbgGet(&trngVal)))
+  {
+    if (status)
+    {
+      *status = TRNGCC26XX_STATUS_SUCCESS;
+    }
+
+    return (trngVal);
+  }
+#endif // TRNGCC26XX_POOL
+
   // Disable hardware interrupts.
   hwiKey = (uint16_t) Hwi_disable();
+  CS_PROF_BEGIN();
 
   // Check if driver is not open.
   if (((TRNGCC26XX_Object *)TRNGCC26XX_config[TRNGCC26XXX_PERIPHERAL_0_INDEX].object)->state == TRNGCC26XX_CLOSED)
@@ -224,6 +329,7 @@ uint32_t TRNGCC26XX_getNumber(TRNGCC26XX_Handle handle, TRNGCC26XX_Params *param
     Power_releaseDependency(PowerCC26XX_PERIPH_TRNG);
 
     // Enable hardware interrupts.
+    CS_PROF_END();
     Hwi_restore(hwiKey);
 
     return (TRNGCC26XX_ILLEGAL_PARAM_RETURN_VALUE);
@@ -252,11 +358,48 @@ uint32_t TRNGCC26XX_getNumber(TRNGCC26XX_Handle handle, TRNGCC26XX_Params *param
   }
 
   // Enable hardware interrupts.
+  CS_PROF_END();
   Hwi_restore(hwiKey);
 
   return (trngVal);
 }
 
+#ifdef TRNGCC26XX_POOL
+/*
+ *  ======== TRNGCC26XX_getBytes ========
+ */
+int8_t TRNGCC26XX_getBytes(TRNGCC26XX_Handle handle, uint8_t *pBuf,
+                           uint32_t len)
+{
+  uint32_t trngVal;
+  int8_t status = TRNGCC26XX_STATUS_SUCCESS;
+
+  if (!pBuf && len)
+  {
+    return (TRNGCC26XX_STATUS_ILLEGAL_PARAM);
+  }
+
+  while (len)
+  {
+    uint8_t i;
+
+    trngVal = TRNGCC26XX_getNumber(handle, NULL, &status);
+    if (status != TRNGCC26XX_STATUS_SUCCESS)
+    {
+      break;
+    }
+
+    for (i = 0; i < sizeof(trngVal) && len; i++, len--)
+    {
+      *pBuf++ = (uint8_t)trngVal;
+      trngVal >>= 8;
+    }
+  }
+
+  return (status);
+}
+#endif // TRNGCC26XX_POOL
+
  /*
   *  ======== TRNGCC26XX_isParamValid ========
   */
@@ -308,5 +451,260 @@ void closeTRNG(TRNGCC26XX_Handle handle)
   }
 }
 
+#ifdef TRNGCC26XX_POOL
+/*
+ * TRNG interrupt: store the new number and start the next one.
+ */
+static void trngPoolHwiFxn(UArg arg)
+{
+  uint16_t hwiKey;
+  uint32_t trngVal;
+
+  hwiKey = (uint16_t) Hwi_disable();
+
+  // The interrupt may be left pending by TRNGCC26XX_getNumber() or by the
+  // end of a refill.
+  if (trngPoolState != TRNGCC26XX_POOL_REFILL ||
+      !(TRNGStatusGet() & TRNG_NUMBER_READY))
+  {
+    Hwi_restore(hwiKey);
+
+    return;
+  }
+
+  // Reading the number starts the generation of the next one.
+  trngVal = TRNGNumberGet(TRNG_LOW_WORD);
+
+  if (trngDrbgReseed)
+  {
+    // Mix fresh entropy into the DRBG key first.
+    trngDrbgKey[--trngDrbgReseed] ^= trngVal;
+
+    if (!trngDrbgReseed)
+    {
+      trngDrbgSeeded = 1;
+      trngDrbgUsed = 0;
+    }
+  }
+  else if (trngPoolCount < TRNGCC26XX_POOL_SIZE)
+  {
+    trngPool[(trngPoolHead + trngPoolCount) & TRNGCC26XX_POOL_MASK] = trngVal;
+    trngPoolCount++;
+  }
+
+  if (!trngDrbgReseed && trngPoolCount == TRNGCC26XX_POOL_SIZE)
+  {
+    trngPoolStopRefill();
+  }
+
+  Hwi_restore(hwiKey);
+}
+
+/*
+ * Start generating numbers in the background.  Called with interrupts
+ * disabled.
+ */
+static void trngPoolStartRefill(void)
+{
+  if (trngPoolState == TRNGCC26XX_POOL_REFILL)
+  {
+    return;
+  }
+
+  trngPoolState = TRNGCC26XX_POOL_REFILL;
+
+  // The TRNG configuration is lost in standby.  A refill is short, so
+  // standby is simply held off until it completes.
+  Power_setDependency(PowerCC26XX_PERIPH_TRNG);
+  Power_setConstraint(PowerCC26XX_SB_DISALLOW);
+
+  // Configure TRNG.  This will disable TRNG.
+  TRNGConfigure(TRNGCC26XX_MIN_SAMPLES_DEFAULT,
+                TRNGCC26XX_MAX_SAMPLES_DEFAULT,
+                TRNGCC26XX_SAMPLE_RATE_DEFAULT);
+
+  TRNGIntEnable(TRNG_NUMBER_READY);
+  TRNGEnable();
+}
+
+/*
+ * Stop generating numbers in the background.  Called with interrupts
+ * disabled.
+ */
+static void trngPoolStopRefill(void)
+{
+  TRNGIntDisable(TRNG_NUMBER_READY);
+  TRNGDisable();
+
+  Power_releaseConstraint(PowerCC26XX_SB_DISALLOW);
+  Power_releaseDependency(PowerCC26XX_PERIPH_TRNG);
+
+  trngPoolState = TRNGCC26XX_POOL_IDLE;
+}
+
+/*
+ * Take a word from the pool, or from the DRBG output left over from an
+ * earlier block.  Returns 1 if a word was taken, 0 otherwise.
+ */
+static uint8_t trngPoolGet(uint32_t *pWord)
+{
+  uint16_t hwiKey;
+  uint8_t found = 1;
+
+  hwiKey = (uint16_t) Hwi_disable();
+
+  if (trngPoolCount)
+  {
+    *pWord = trngPool[trngPoolHead];
+    trngPool[trngPoolHead] = 0;
+    trngPoolHead = (trngPoolHead + 1) & TRNGCC26XX_POOL_MASK;
+    trngPoolCount--;
+  }
+  else if (trngDrbgAvail)
+  {
+    // Output words are erased once used.
+    *pWord = trngDrbgOut[--trngDrbgAvail];
+    trngDrbgOut[trngDrbgAvail] = 0;
+  }
+  else
+  {
+    found = 0;
+  }
+
+  if (trngPoolCount <= TRNGCC26XX_POOL_LOW_WATER || trngDrbgReseed)
+  {
+    trngPoolStartRefill();
+  }
+
+  Hwi_restore(hwiKey);
+
+  return (found);
+}
+
+/*
+ * ChaCha20 block function with a zero nonce.
+ */
+static void trngDrbgBlock(uint32_t *pOut, const uint32_t *pKey,
+                          uint32_t counter)
+{
+  uint8_t i;
+
+  pOut[0] = 0x61707865;
+  pOut[1] = 0x3320646e;
+  pOut[2] = 0x79622d32;
+  pOut[3] = 0x6b206574;
+
+  for (i = 0; i < TRNGCC26XX_DRBG_KEY_WORDS; i++)
+  {
+    pOut[4 + i] = pKey[i];
+  }
+
+  pOut[12] = counter;
+  pOut[13] = 0;
+  pOut[14] = 0;
+  pOut[15] = 0;
+
+  for (i = 0; i < 10; i++)
+  {
+    TRNGCC26XX_QUARTER_ROUND(pOut, 0, 4,  8, 12);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 1, 5,  9, 13);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 2, 6, 10, 14);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 3, 7, 11, 15);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 0, 5, 10, 15);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 1, 6, 11, 12);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 2, 7,  8, 13);
+    TRNGCC26XX_QUARTER_ROUND(pOut, 3, 4,  9, 14);
+  }
+
+  // Feed forward of the input block.
+  pOut[0] += 0x61707865;
+  pOut[1] += 0x3320646e;
+  pOut[2] += 0x79622d32;
+  pOut[3] += 0x6b206574;
+
+  for (i = 0; i < TRNGCC26XX_DRBG_KEY_WORDS; i++)
+  {
+    pOut[4 + i] += pKey[i];
+  }
+
+  pOut[12] += counter;
+}
+
+/*
+ * Generate a word with the DRBG.  The block is computed with interrupts
+ * enabled.  Its first half is folded into the key, so that earlier output
+ * cannot be recovered from the state, and its second half is output.
+ * Returns 0 if the DRBG was never seeded.
+ */
+static uint8_t trngDrbgGet(uint32_t *pWord)
+{
+  uint32_t key[TRNGCC26XX_DRBG_KEY_WORDS];
+  uint32_t block[TRNGCC26XX_DRBG_BLOCK_WORDS];
+  uint32_t counter;
+  uint16_t hwiKey;
+  uint8_t i;
+
+  hwiKey = (uint16_t) Hwi_disable();
+
+  if (!trngDrbgSeeded)
+  {
+    Hwi_restore(hwiKey);
+
+    return (0);
+  }
+
+  for (i = 0; i < TRNGCC26XX_DRBG_KEY_WORDS; i++)
+  {
+    key[i] = trngDrbgKey[i];
+  }
+
+  // Concurrent callers each use their own counter value.
+  counter = trngDrbgCounter++;
+
+  Hwi_restore(hwiKey);
+
+  trngDrbgBlock(block, key, counter);
+
+  hwiKey = (uint16_t) Hwi_disable();
+
+  for (i = 0; i < TRNGCC26XX_DRBG_KEY_WORDS; i++)
+  {
+    trngDrbgKey[i] ^= block[i];
+  }
+
+  *pWord = block[TRNGCC26XX_DRBG_KEY_WORDS];
+
+  // Keep the rest of the output for later requests.
+  if (!trngDrbgAvail)
+  {
+    for (i = 1; i < TRNGCC26XX_DRBG_BLOCK_WORDS - TRNGCC26XX_DRBG_KEY_WORDS; i++)
+    {
+      trngDrbgOut[trngDrbgAvail++] = block[TRNGCC26XX_DRBG_KEY_WORDS + i];
+    }
+  }
+
+  trngDrbgUsed += TRNGCC26XX_DRBG_BLOCK_WORDS - TRNGCC26XX_DRBG_KEY_WORDS;
+  if (trngDrbgUsed >= TRNGCC26XX_DRBG_RESEED_WORDS && !trngDrbgReseed)
+  {
+    trngDrbgReseed = TRNGCC26XX_DRBG_KEY_WORDS;
+    trngPoolStartRefill();
+  }
+
+  Hwi_restore(hwiKey);
+
+  for (i = 0; i < TRNGCC26XX_DRBG_BLOCK_WORDS; i++)
+  {
+    block[i] = 0;
+  }
+
+  for (i = 0; i < TRNGCC26XX_DRBG_KEY_WORDS; i++)
+  {
+    key[i] = 0;
+  }
+
+  return (1);
+}
+#endif // TRNGCC26XX_POOL
+
 /*******************************************************************************
  */
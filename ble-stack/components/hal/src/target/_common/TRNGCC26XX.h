@@ -380,6 +380,25 @@ uint32_t TRNGCC26XX_getNumber(TRNGCC26XX_Handle handle,
  */
 int8_t TRNGCC26XX_isParamValid(TRNGCC26XX_Params *params);
 
+#ifdef TRNGCC26XX_POOL
+/*!
+ * @brief       Fill a buffer with random bytes.
+ *              With TRNGCC26XX_POOL defined, requests using the default
+ *              configuration are served from an entropy pool refilled in the
+ *              background from the TRNG interrupt, and from a DRBG seeded by
+ *              the TRNG while the pool is empty.  This routine does not
+ *              busy-wait on the TRNG once the DRBG has been seeded.
+ * @pre         Calling context: Hwi, Swi or Task.
+ * @param       handle - a TRNGCC26XX_Handle returned from TRNGCC26XX_open().
+ * @param       pBuf   - buffer to fill. output parameter.
+ * @param       len    - number of bytes to fill.
+ * @return      TRNGCC26XX_STATUS_SUCCESS if successful.
+ *              TRNGCC26XX_STATUS_ILLEGAL_PARAM if pBuf is NULL.
+ */
+int8_t TRNGCC26XX_getBytes(TRNGCC26XX_Handle handle, uint8_t *pBuf,
+                           uint32_t len);
+#endif /* TRNGCC26XX_POOL */
+
 #ifdef __cplusplus
 }
 #endif
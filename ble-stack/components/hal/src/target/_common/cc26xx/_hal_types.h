@@ -59,8 +59,14 @@ typedef unsigned char   uint8;
 typedef signed   short  int16;
 typedef unsigned short  uint16;
 
+#ifdef __GNUC__
+/* 32 bits wide on 64-bit hosts too, where long is 8 bytes */
+typedef int32_t         int32;
+typedef uint32_t        uint32;
+#else
 typedef signed   long   int32;
 typedef unsigned long   uint32;
+#endif
 
 //typedef unsigned char   bool;
 
@@ -143,7 +149,11 @@ typedef uint32          halDataAlign_t;
 #define PACKED_TYPEDEF_UNION        typedef union PACKED
 
 #elif defined (__GNUC__)
-#define PACKED __attribute__((__packed__))
+#define PACKED                      __attribute__((__packed__))
+#define PACKED_STRUCT               struct PACKED
+#define PACKED_TYPEDEF_STRUCT       typedef struct PACKED
+#define PACKED_TYPEDEF_CONST_STRUCT typedef const struct PACKED
+#define PACKED_TYPEDEF_UNION        typedef union PACKED
 #endif
 
 /**************************************************************************************************
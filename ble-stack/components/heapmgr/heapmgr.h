@@ -71,6 +71,10 @@
 #define HEAPMGR_GETMETRICS heapmgrGetMetrics
 #endif
 
+#ifndef HEAPMGR_GETSEGCACHED
+#define HEAPMGR_GETSEGCACHED heapmgrGetSegCached
+#endif
+
 #ifndef HEAPMGR_SANITY_CHECK
 #define HEAPMGR_SANITY_CHECK heapmgrSanityCheck
 #endif
@@ -124,6 +128,91 @@
 #define HEAPMGR_SMALL_BLKSZ  16
 #endif
 
+#ifdef HEAPMGR_SEGREGATED
+/* Smallest size class block: the header and the free list link that a
+ * cached block holds in its payload, rounded up to the header size.
+ */
+#define HEAPMGR_SEG_MINSZ \
+  (((HDRSZ + sizeof(void *) + HDRSZ - 1) / HDRSZ) * HDRSZ)
+
+/* Block sizes, header included, of the segregated size classes, as a
+ * comma-separated list. Freed blocks of exactly one of these sizes are
+ * kept on a per-class LIFO free list instead of being returned to the
+ * first-fit heap, so that allocation and free of a class size take
+ * constant time while the class has a block cached. Larger requests are
+ * still first-fit, and slower than without the classes since the search
+ * steps over the cached blocks. The defaults cover app event messages
+ * (sbpEvt_t), RTOS queue records (queueRec_t), ICall message headers with
+ * small bodies and ATT PDUs up to the default ATT MTU. Sizes must be multiples of the heap alignment, in ascending
+ * order, and at least HEAPMGR_SEG_MINSZ, which is checked at build time.
+ */
+#ifndef HEAPMGR_SEG_CLASSES
+#define HEAPMGR_SEG_CLASSES  HEAPMGR_SEG_MINSZ, 16, 24, 32, 48, 64, 96, 128
+#endif
+
+/* Largest size class block; must be the last of HEAPMGR_SEG_CLASSES.
+ * Sizes up to it find their class in a table of one byte per HDRSZ.
+ */
+#ifndef HEAPMGR_SEG_MAXSZ
+#define HEAPMGR_SEG_MAXSZ    128
+#endif
+
+/* Number of blocks to carve for each size class at initialization, as
+ * a comma-separated list. The reserve stays on the class lists: it makes
+ * class-sized allocations up to the reserve constant time from boot and
+ * keeps those blocks together at the start of the heap, at the cost of
+ * memory that can no longer be used for other sizes. The default covers
+ * the app events, queue records and stack messages in flight at once in
+ * the simple peripheral, 544 bytes with the 4 byte header of the target.
+ */
+#ifndef HEAPMGR_SEG_RESERVE
+#define HEAPMGR_SEG_RESERVE  4, 4, 4, 4, 2, 2
+#endif
+
+/* Most blocks cached on each size class list, reserve included, as a
+ * comma-separated list. Blocks freed beyond it go back to the first-fit
+ * heap, which bounds how far cached blocks fragment it. When the
+ * first-fit heap runs out of memory the blocks cached beyond the reserve
+ * are returned to it, so caching never makes an allocation fail that the
+ * plain first-fit heap would have served; the limit bounds that drain to
+ * the sum of the limits less the reserve, 24 first-fit frees by default.
+ */
+#ifndef HEAPMGR_SEG_LIMIT
+#define HEAPMGR_SEG_LIMIT    8, 8, 8, 8, 4, 4, 2, 2
+#endif
+#endif /* HEAPMGR_SEGREGATED */
+
+#ifdef HEAPMGR_TRACE
+/* Number of block owners tracked when tracing. Owners are dense indexes
+ * returned by HEAPMGR_TRACE_OWNER(); out-of-range values are charged to
+ * the last owner.
+ */
+#ifndef HEAPMGR_TRACE_OWNERS
+#define HEAPMGR_TRACE_OWNERS  8
+#endif
+
+/* Expression evaluated outside the heap lock for each allocation, which
+ * yields the owner to charge the block to.
+ */
+#ifndef HEAPMGR_TRACE_OWNER
+#define HEAPMGR_TRACE_OWNER()  0
+#endif
+
+/* Upper bounds of requested sizes for the size histogram. The last
+ * bucket must cover the maximum allocation size.
+ */
+#ifndef HEAPMGR_TRACE_BUCKETS
+#define HEAPMGR_TRACE_BUCKETS  { 8, 16, 32, 64, 128, 256, 65535 }
+#endif
+
+#ifndef HEAPMGR_TRACE_REPORT
+#define HEAPMGR_TRACE_REPORT heapmgrTraceReport
+#endif
+
+/* Report format version written by HEAPMGR_TRACE_REPORT */
+#define HEAPMGR_TRACE_VERSION  1
+#endif /* HEAPMGR_TRACE */
+
 #ifdef HEAPMGR_PROFILER
 #ifndef osal_memset
 #define osal_memset memset
@@ -138,6 +227,52 @@
 #define HEAPMGR_FF2 HEAPMGR_PREFIXED(Ff2)
 #define HEAPMGR_HEAPSTORE HEAPMGR_PREFIXED(HeapStore)
 #define HEAPMGR_HEAP HEAPMGR_PREFIXED(Heap)
+
+/* The first-fit allocator may be fronted by the segregated size classes,
+ * and either may be wrapped by tracing. Only the outermost layer carries
+ * the public HEAPMGR_MALLOC/HEAPMGR_FREE names.
+ */
+#if defined(HEAPMGR_SEGREGATED) || defined(HEAPMGR_TRACE)
+#define HEAPMGR_FF_MALLOC HEAPMGR_PREFIXED(FfMalloc)
+#define HEAPMGR_FF_FREE HEAPMGR_PREFIXED(FfFree)
+#define HEAPMGR_FF_SCOPE static
+#else
+#define HEAPMGR_FF_MALLOC HEAPMGR_MALLOC
+#define HEAPMGR_FF_FREE HEAPMGR_FREE
+#define HEAPMGR_FF_SCOPE
+#endif
+
+#ifdef HEAPMGR_SEGREGATED
+#define HEAPMGR_SEGSIZE HEAPMGR_PREFIXED(SegSize)
+#define HEAPMGR_SEGFREE HEAPMGR_PREFIXED(SegFree)
+#define HEAPMGR_SEGCNT HEAPMGR_PREFIXED(SegCnt)
+#define HEAPMGR_SEGRSV HEAPMGR_PREFIXED(SegRsv)
+#define HEAPMGR_SEGLIM HEAPMGR_PREFIXED(SegLim)
+#define HEAPMGR_SEGIDX HEAPMGR_PREFIXED(SegIdx)
+#define HEAPMGR_SEGCACHED HEAPMGR_PREFIXED(SegCached)
+#ifdef HEAPMGR_TRACE
+#define HEAPMGR_SEG_MALLOC HEAPMGR_PREFIXED(SegMalloc)
+#define HEAPMGR_SEG_FREE HEAPMGR_PREFIXED(SegDealloc)
+#define HEAPMGR_SEG_SCOPE static
+#else
+#define HEAPMGR_SEG_MALLOC HEAPMGR_MALLOC
+#define HEAPMGR_SEG_FREE HEAPMGR_FREE
+#define HEAPMGR_SEG_SCOPE
+#endif
+#define HEAPMGR_BE_MALLOC HEAPMGR_SEG_MALLOC
+#define HEAPMGR_BE_FREE HEAPMGR_SEG_FREE
+#else
+#define HEAPMGR_BE_MALLOC HEAPMGR_FF_MALLOC
+#define HEAPMGR_BE_FREE HEAPMGR_FF_FREE
+#endif
+
+#ifdef HEAPMGR_TRACE
+#define HEAPMGR_TRCLIM HEAPMGR_PREFIXED(TrcLim)
+#define HEAPMGR_TRCOWN HEAPMGR_PREFIXED(TrcOwn)
+#define HEAPMGR_TRCBKT HEAPMGR_PREFIXED(TrcBkt)
+#define HEAPMGR_TRCCUR HEAPMGR_PREFIXED(TrcCur)
+#define HEAPMGR_TRCPEAK HEAPMGR_PREFIXED(TrcPeak)
+#endif
 #ifdef HEAPMGR_METRICS
 #define HEAPMGR_BLKMAX HEAPMGR_PREFIXED(BlkMax)
 #define HEAPMGR_BLKCNT HEAPMGR_PREFIXED(BlkCnt)
@@ -192,6 +327,8 @@ typedef hmU16_t  heapmgrHdr_t;
 #define HEAPMGR_ALIGN_SIZE 4
 #elif defined __GNUC__ && defined __arm__
 #define HEAPMGR_ALIGN_SIZE 4
+#elif defined __GNUC__ && defined __x86_64__
+#define HEAPMGR_ALIGN_SIZE 4
 #elif defined (ccs)  || (rvmdk)
 #define HEAPMGR_ALIGN_SIZE 4
 #elif defined __TI_COMPILER_VERSION__ && defined __TI_ARM__
@@ -216,6 +353,23 @@ typedef hmU16_t  heapmgrHdr_t;
   #endif
 #endif // AUTOHEAPSIZE
 
+#ifdef HEAPMGR_TRACE
+/** @internal owner tag kept in the last bytes of an enlarged block header */
+typedef struct
+{
+  hmU16_t size;    // requested size
+  hmU8_t  owner;   // owner index
+  hmU8_t  bucket;  // size histogram bucket
+} heapmgrTag_t;
+
+/* Grow the block header so that the tag fits between the size word and
+ * the payload, keeping the payload aligned. */
+#undef HDRSZ
+#define HDRSZ 8
+
+#define HEAPMGR_TAG(_ptr) ((heapmgrTag_t *)((hmU8_t *)(_ptr) - sizeof(heapmgrTag_t)))
+#endif /* HEAPMGR_TRACE */
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -235,6 +389,60 @@ typedef hmU16_t  heapmgrHdr_t;
 static heapmgrHdr_t *HEAPMGR_FF1;  // First free block in the small-block bucket.
 static heapmgrHdr_t *HEAPMGR_FF2;  // First free block after the small-block bucket.
 
+#ifdef HEAPMGR_SEGREGATED
+#define HEAPMGR_SEG_NUM \
+  (sizeof(HEAPMGR_SEGSIZE) / sizeof(HEAPMGR_SEGSIZE[0]))
+
+/* First element of a comma-separated list */
+#define HEAPMGR_SEG_FIRST_(_first, ...) (_first)
+#define HEAPMGR_SEG_FIRST(...) HEAPMGR_SEG_FIRST_(__VA_ARGS__, 0)
+
+/* The smallest class must hold the free list link after the header. */
+typedef char HEAPMGR_PREFIXED(SegMinCheck)
+  [(HEAPMGR_SEG_FIRST(HEAPMGR_SEG_CLASSES) >= HEAPMGR_SEG_MINSZ) ? 1 : -1];
+
+static const hmU16_t HEAPMGR_SEGSIZE[] = { HEAPMGR_SEG_CLASSES };
+static const hmU16_t HEAPMGR_SEGRSV[HEAPMGR_SEG_NUM] = { HEAPMGR_SEG_RESERVE };
+static const hmU16_t HEAPMGR_SEGLIM[HEAPMGR_SEG_NUM] = { HEAPMGR_SEG_LIMIT };
+static void *HEAPMGR_SEGFREE[HEAPMGR_SEG_NUM];  // Per-class free lists.
+static hmU16_t HEAPMGR_SEGCNT[HEAPMGR_SEG_NUM]; // Blocks on each list.
+static hmU8_t HEAPMGR_SEGIDX[HEAPMGR_SEG_MAXSZ / HDRSZ + 1]; // Class by size.
+
+HEAPMGR_SEG_SCOPE void HEAPMGR_SEG_FREE( void *ptr );
+#endif
+
+HEAPMGR_FF_SCOPE void *HEAPMGR_FF_MALLOC( hmU16_t size );
+HEAPMGR_FF_SCOPE void HEAPMGR_FF_FREE( void *ptr );
+
+#ifdef HEAPMGR_TRACE
+/* Per-owner usage, in requested bytes */
+typedef struct
+{
+  hmU16_t cur;     // bytes currently held
+  hmU16_t peak;    // max bytes ever held at once
+  hmU16_t atPeak;  // bytes held when the total usage peaked
+  hmU16_t blocks;  // blocks currently held
+  hmU16_t fails;   // failed allocations
+} heapmgrTrcOwner_t;
+
+/* Per-bucket size histogram */
+typedef struct
+{
+  hmU16_t cur;     // blocks currently allocated
+  hmU16_t peak;    // max blocks allocated at once
+  hmU32_t total;   // allocations ever made
+} heapmgrTrcBucket_t;
+
+static const hmU16_t HEAPMGR_TRCLIM[] = HEAPMGR_TRACE_BUCKETS;
+#define HEAPMGR_TRACE_NUM_BUCKETS \
+  (sizeof(HEAPMGR_TRCLIM) / sizeof(HEAPMGR_TRCLIM[0]))
+
+static heapmgrTrcOwner_t HEAPMGR_TRCOWN[HEAPMGR_TRACE_OWNERS];
+static heapmgrTrcBucket_t HEAPMGR_TRCBKT[HEAPMGR_TRACE_NUM_BUCKETS];
+static hmU16_t HEAPMGR_TRCCUR;   // Total requested bytes currently held.
+static hmU16_t HEAPMGR_TRCPEAK;  // Max total requested bytes held at once.
+#endif
+
 #ifdef HEAPMGR_METRICS
 hmU16_t HEAPMGR_BLKMAX = 0;  // Max cnt of all blocks ever seen at once.
 hmU16_t HEAPMGR_BLKCNT = 0;  // Current cnt of all blocks.
@@ -243,6 +451,9 @@ hmU16_t HEAPMGR_MEMALO = 0;  // Current total memory allocated.
 hmU16_t HEAPMGR_MEMMAX = 0;  // Max total memory ever allocated at once.
 hmU16_t HEAPMGR_MEMUB = 0;   // Upper-bound of memory usage
 hmU16_t HEAPMGR_MEMFAIL = 0; // Memory allocation failure count
+#ifdef HEAPMGR_SEGREGATED
+hmU16_t HEAPMGR_SEGCACHED = 0; // Memory cached on the size class lists.
+#endif
 #endif
 
 #ifdef HEAPMGR_PROFILER
@@ -331,7 +542,7 @@ void HEAPMGR_INIT( void )
   // Setup a NULL block that is never freed so that the small-block bucket
   // is never coalesced with the wilderness.
   HEAPMGR_FF1 = tmp;
-  HEAPMGR_FF2 = HEAPMGR_MALLOC( 0 );
+  HEAPMGR_FF2 = HEAPMGR_FF_MALLOC( 0 );
   HEAPMGR_FF1 = (heapmgrHdr_t *)HEAPMGR_HEAP;
 
 #ifdef HEAPMGR_METRICS
@@ -340,15 +551,240 @@ void HEAPMGR_INIT( void )
    */
   HEAPMGR_BLKCNT = HEAPMGR_BLKFREE = 2;
   HEAPMGR_MEMFAIL = 0;
+#ifdef HEAPMGR_SEGREGATED
+  HEAPMGR_SEGCACHED = 0;
+#endif
+#endif
+
+#ifdef HEAPMGR_SEGREGATED
+  {
+    hmU8_t idx;
+    hmU16_t cnt;
+
+    HEAPMGR_ASSERT( HEAPMGR_SEGSIZE[HEAPMGR_SEG_NUM - 1] == HEAPMGR_SEG_MAXSZ );
+
+    for ( idx = 0; idx < HEAPMGR_SEG_NUM; idx++ )
+    {
+      HEAPMGR_SEGFREE[idx] = NULL;
+      HEAPMGR_SEGCNT[idx] = 0;
+    }
+
+    // Smallest class that holds each size, in units of the header size.
+    for ( idx = 0, cnt = 0; cnt <= HEAPMGR_SEG_MAXSZ / HDRSZ; cnt++ )
+    {
+      while ( cnt * HDRSZ > HEAPMGR_SEGSIZE[idx] )
+      {
+        idx++;
+      }
+      HEAPMGR_SEGIDX[cnt] = idx;
+    }
+
+    // Populate the classes; freeing the blocks moves them to the class lists.
+    for ( idx = 0; idx < HEAPMGR_SEG_NUM; idx++ )
+    {
+      for ( cnt = 0; cnt < HEAPMGR_SEGRSV[idx]; cnt++ )
+      {
+        void *blk = HEAPMGR_FF_MALLOC( HEAPMGR_SEGSIZE[idx] - HDRSZ );
+
+        if ( blk == NULL )
+        {
+          break;
+        }
+        HEAPMGR_SEG_FREE( blk );
+      }
+    }
+  }
+#endif
+
+#ifdef HEAPMGR_TRACE
+  HEAPMGR_MEMSET( HEAPMGR_TRCOWN, 0, sizeof(HEAPMGR_TRCOWN) );
+  HEAPMGR_MEMSET( HEAPMGR_TRCBKT, 0, sizeof(HEAPMGR_TRCBKT) );
+  HEAPMGR_TRCCUR = HEAPMGR_TRCPEAK = 0;
+#endif
+}
+
+#ifdef HEAPMGR_SEGREGATED
+/**
+ * @brief   Finds the smallest size class that holds a block.
+ * @param   blkSize - block size in bytes, header included.
+ * @return  index of the size class or HEAPMGR_SEG_NUM if none matches.
+ */
+static hmU8_t HEAPMGR_PREFIXED(SegClass)( hmU16_t blkSize )
+{
+  if ( blkSize > HEAPMGR_SEG_MAXSZ )
+  {
+    return HEAPMGR_SEG_NUM;
+  }
+  return HEAPMGR_SEGIDX[(blkSize + HDRSZ - 1) / HDRSZ];
+}
+
+/**
+ * @brief   Pops a block off a size class free list.
+ * @param   idx - index of the size class.
+ * @param   keep - number of blocks to leave on the list.
+ * @return  the block; NULL if the list holds no more than keep blocks.
+ */
+static void *HEAPMGR_PREFIXED(SegPop)( hmU8_t idx, hmU16_t keep )
+{
+  void *blk = NULL;
+
+  HEAPMGR_LOCK();
+
+  if ( HEAPMGR_SEGCNT[idx] > keep )
+  {
+    blk = HEAPMGR_SEGFREE[idx];
+    HEAPMGR_SEGFREE[idx] = *(void **)blk;
+    HEAPMGR_SEGCNT[idx]--;
+
+#ifdef HEAPMGR_METRICS
+    HEAPMGR_SEGCACHED -= HEAPMGR_SEGSIZE[idx];
+    HEAPMGR_MEMALO += HEAPMGR_SEGSIZE[idx];
+    if ( HEAPMGR_MEMMAX < HEAPMGR_MEMALO )
+    {
+      HEAPMGR_MEMMAX = HEAPMGR_MEMALO;
+    }
+#endif
+  }
+
+  HEAPMGR_UNLOCK();
+
+  return blk;
+}
+
+/**
+ * @brief   Returns the blocks cached on the size class lists, beyond the
+ *          configured reserve, to the first-fit heap: at most the sum of
+ *          HEAPMGR_SEG_LIMIT less the reserve. The blocks are moved one
+ *          at a time so that interrupts are never masked for longer than
+ *          a single first-fit free.
+ * @return  non-zero if any block was returned.
+ */
+static hmU8_t HEAPMGR_PREFIXED(SegDrain)( void )
+{
+  hmU8_t drained = 0;
+  hmU8_t idx;
+  void *blk;
+
+  for ( idx = 0; idx < HEAPMGR_SEG_NUM; idx++ )
+  {
+    while ( (blk = HEAPMGR_PREFIXED(SegPop)( idx, HEAPMGR_SEGRSV[idx] )) != NULL )
+    {
+      HEAPMGR_FF_FREE( blk );
+      drained = 1;
+    }
+  }
+
+  return drained;
+}
+
+/**
+ * @brief   Segregated-fit allocator.
+ *          Requests that fit a size class are served from the class free
+ *          list in constant time; when the list is empty a block of the
+ *          full class size is taken from the first-fit heap, or failing
+ *          that a cached block of the next larger class. Larger requests
+ *          go to the first-fit heap directly. When the first-fit heap is
+ *          exhausted the cached blocks are returned to it and the
+ *          allocation is retried once.
+ * @param   size - number of bytes to allocate from the heap.
+ * @return  void * - pointer to the heap allocation; NULL if error or failure.
+ */
+HEAPMGR_SEG_SCOPE void *HEAPMGR_SEG_MALLOC( hmU16_t size )
+{
+  hmU8_t idx;
+  hmU8_t big;
+  void *blk;
+
+  HEAPMGR_ASSERT( size );
+
+  idx = HEAPMGR_PREFIXED(SegClass)( size + HDRSZ );
+  if ( idx == HEAPMGR_SEG_NUM )
+  {
+    blk = HEAPMGR_FF_MALLOC( size );
+    if ( blk == NULL && HEAPMGR_PREFIXED(SegDrain)() )
+    {
+      blk = HEAPMGR_FF_MALLOC( size );
+    }
+    return blk;
+  }
+
+  blk = HEAPMGR_PREFIXED(SegPop)( idx, 0 );
+  if ( blk != NULL )
+  {
+    return blk;
+  }
+
+  blk = HEAPMGR_FF_MALLOC( HEAPMGR_SEGSIZE[idx] - HDRSZ );
+  if ( blk != NULL )
+  {
+    return blk;
+  }
+
+  // A larger cached block keeps its own class size and goes back there.
+  for ( big = idx + 1; big < HEAPMGR_SEG_NUM; big++ )
+  {
+    blk = HEAPMGR_PREFIXED(SegPop)( big, 0 );
+    if ( blk != NULL )
+    {
+      return blk;
+    }
+  }
+
+  if ( HEAPMGR_PREFIXED(SegDrain)() )
+  {
+    blk = HEAPMGR_FF_MALLOC( HEAPMGR_SEGSIZE[idx] - HDRSZ );
+  }
+
+  return blk;
+}
+
+/**
+ * @brief   Segregated-fit de-allocator.
+ *          Blocks whose size is exactly that of a size class stay marked
+ *          in use in the first-fit heap and are pushed onto the class
+ *          free list, up to the limit of the class; other blocks are
+ *          returned to the first-fit heap.
+ * @param   ptr - pointer to the memory to free.
+ */
+HEAPMGR_SEG_SCOPE void HEAPMGR_SEG_FREE( void *ptr )
+{
+  heapmgrHdr_t *currHdr = (heapmgrHdr_t *)((hmU8_t *)ptr - HDRSZ);
+  hmU16_t blkSize;
+  hmU8_t idx;
+
+  HEAPMGR_ASSERT(*currHdr & HEAPMGR_IN_USE);
+
+  blkSize = (hmU16_t)(*currHdr & ~HEAPMGR_IN_USE);
+  idx = HEAPMGR_PREFIXED(SegClass)( blkSize );
+  if ( idx == HEAPMGR_SEG_NUM || HEAPMGR_SEGSIZE[idx] != blkSize ||
+       HEAPMGR_SEGCNT[idx] >= HEAPMGR_SEGLIM[idx] )
+  {
+    HEAPMGR_FF_FREE( ptr );
+    return;
+  }
+
+  HEAPMGR_LOCK();
+
+  *(void **)ptr = HEAPMGR_SEGFREE[idx];
+  HEAPMGR_SEGFREE[idx] = ptr;
+  HEAPMGR_SEGCNT[idx]++;
+
+  // Cached blocks are still in use as far as the first-fit heap goes.
+#ifdef HEAPMGR_METRICS
+  HEAPMGR_MEMALO -= blkSize;
+  HEAPMGR_SEGCACHED += blkSize;
 #endif
+
+  HEAPMGR_UNLOCK();
 }
+#endif /* HEAPMGR_SEGREGATED */
 
 /**
  * @brief   Implementation of the allocator functionality.
  * @param   size - number of bytes to allocate from the heap.
  * @return  void * - pointer to the heap allocation; NULL if error or failure.
  */
-void *HEAPMGR_MALLOC( hmU16_t size )
+HEAPMGR_FF_SCOPE void *HEAPMGR_FF_MALLOC( hmU16_t size )
 {
   heapmgrHdr_t *prev = NULL;
   heapmgrHdr_t *hdr;
@@ -591,7 +1027,7 @@ void *HEAPMGR_REALLOC( void* ptr, hmU16_t size )
  * @brief   Implementation of the de-allocator functionality.
  * @param   ptr - pointer to the memory to free.
  */
-void HEAPMGR_FREE( void *ptr )
+HEAPMGR_FF_SCOPE void HEAPMGR_FF_FREE( void *ptr )
 {
   heapmgrHdr_t *currHdr;
 
@@ -640,6 +1076,169 @@ void HEAPMGR_FREE( void *ptr )
   HEAPMGR_UNLOCK();
 }
 
+#ifdef HEAPMGR_TRACE
+/**
+ * @brief   Traced allocator. Charges the block to the owner given by
+ *          HEAPMGR_TRACE_OWNER() and updates the size histogram.
+ * @param   size - number of bytes to allocate from the heap.
+ * @return  void * - pointer to the heap allocation; NULL if error or failure.
+ */
+void *HEAPMGR_MALLOC( hmU16_t size )
+{
+  hmU8_t owner = (hmU8_t) HEAPMGR_TRACE_OWNER();
+  void *ptr = HEAPMGR_BE_MALLOC( size );
+  heapmgrTrcOwner_t *pOwn;
+
+  if ( owner >= HEAPMGR_TRACE_OWNERS )
+  {
+    owner = HEAPMGR_TRACE_OWNERS - 1;
+  }
+  pOwn = &HEAPMGR_TRCOWN[owner];
+
+  HEAPMGR_LOCK();
+
+  if ( ptr == NULL )
+  {
+    pOwn->fails++;
+  }
+  else
+  {
+    heapmgrTag_t *tag = HEAPMGR_TAG( ptr );
+    heapmgrTrcBucket_t *pBkt;
+    hmU8_t idx;
+
+    for ( idx = 0; idx < HEAPMGR_TRACE_NUM_BUCKETS - 1; idx++ )
+    {
+      if ( size <= HEAPMGR_TRCLIM[idx] )
+      {
+        break;
+      }
+    }
+
+    tag->size = size;
+    tag->owner = owner;
+    tag->bucket = idx;
+
+    pBkt = &HEAPMGR_TRCBKT[idx];
+    pBkt->total++;
+    if ( ++pBkt->cur > pBkt->peak )
+    {
+      pBkt->peak = pBkt->cur;
+    }
+
+    pOwn->blocks++;
+    pOwn->cur += size;
+    if ( pOwn->cur > pOwn->peak )
+    {
+      pOwn->peak = pOwn->cur;
+    }
+
+    HEAPMGR_TRCCUR += size;
+    if ( HEAPMGR_TRCCUR > HEAPMGR_TRCPEAK )
+    {
+      // New high-water mark; snapshot who holds the heap.
+      HEAPMGR_TRCPEAK = HEAPMGR_TRCCUR;
+      for ( idx = 0; idx < HEAPMGR_TRACE_OWNERS; idx++ )
+      {
+        HEAPMGR_TRCOWN[idx].atPeak = HEAPMGR_TRCOWN[idx].cur;
+      }
+    }
+  }
+
+  HEAPMGR_UNLOCK();
+
+  return ptr;
+}
+
+/**
+ * @brief   Traced de-allocator.
+ * @param   ptr - pointer to the memory to free.
+ */
+void HEAPMGR_FREE( void *ptr )
+{
+  heapmgrTag_t *tag = HEAPMGR_TAG( ptr );
+  heapmgrTrcOwner_t *pOwn = &HEAPMGR_TRCOWN[tag->owner];
+
+  HEAPMGR_LOCK();
+
+  HEAPMGR_TRCBKT[tag->bucket].cur--;
+  pOwn->blocks--;
+  pOwn->cur -= tag->size;
+  HEAPMGR_TRCCUR -= tag->size;
+
+  HEAPMGR_UNLOCK();
+
+  HEAPMGR_BE_FREE( ptr );
+}
+
+/**
+ * @brief   Writes a compact binary trace report. All multi-byte fields
+ *          are little-endian.
+ *
+ *          offset 0: 'H', 'T', version, owner count N, bucket count B, 0
+ *          offset 6: total bytes held (2), total bytes peak (2)
+ *          then B buckets: limit (2), cur (2), peak (2), total (4)
+ *          then N owners:  cur (2), peak (2), at peak (2), blocks (2),
+ *                          fails (2)
+ *
+ * @param   buf - buffer to write the report to
+ * @param   len - size of the buffer in bytes
+ * @return  number of bytes written; 0 if the buffer is too small.
+ */
+hmU16_t HEAPMGR_TRACE_REPORT( hmU8_t *buf, hmU16_t len )
+{
+  hmU16_t need = 10 + HEAPMGR_TRACE_NUM_BUCKETS * 10 + HEAPMGR_TRACE_OWNERS * 10;
+  hmU8_t *p = buf;
+  hmU8_t idx;
+
+  if ( len < need )
+  {
+    return 0;
+  }
+
+#define HEAPMGR_PUT16(_v) do { *p++ = (hmU8_t)(_v); *p++ = (hmU8_t)((_v) >> 8); } while (0)
+
+  HEAPMGR_LOCK();
+
+  *p++ = 'H';
+  *p++ = 'T';
+  *p++ = HEAPMGR_TRACE_VERSION;
+  *p++ = HEAPMGR_TRACE_OWNERS;
+  *p++ = HEAPMGR_TRACE_NUM_BUCKETS;
+  *p++ = 0;
+  HEAPMGR_PUT16( HEAPMGR_TRCCUR );
+  HEAPMGR_PUT16( HEAPMGR_TRCPEAK );
+
+  for ( idx = 0; idx < HEAPMGR_TRACE_NUM_BUCKETS; idx++ )
+  {
+    heapmgrTrcBucket_t *pBkt = &HEAPMGR_TRCBKT[idx];
+
+    HEAPMGR_PUT16( HEAPMGR_TRCLIM[idx] );
+    HEAPMGR_PUT16( pBkt->cur );
+    HEAPMGR_PUT16( pBkt->peak );
+    HEAPMGR_PUT16( pBkt->total );
+    HEAPMGR_PUT16( pBkt->total >> 16 );
+  }
+
+  for ( idx = 0; idx < HEAPMGR_TRACE_OWNERS; idx++ )
+  {
+    heapmgrTrcOwner_t *pOwn = &HEAPMGR_TRCOWN[idx];
+
+    HEAPMGR_PUT16( pOwn->cur );
+    HEAPMGR_PUT16( pOwn->peak );
+    HEAPMGR_PUT16( pOwn->atPeak );
+    HEAPMGR_PUT16( pOwn->blocks );
+    HEAPMGR_PUT16( pOwn->fails );
+  }
+
+  HEAPMGR_UNLOCK();
+
+#undef HEAPMGR_PUT16
+
+  return need;
+}
+#endif /* HEAPMGR_TRACE */
+
 #ifdef HEAPMGR_METRICS
 /**
  * @brief   obtain heap usage metrics
@@ -667,6 +1266,26 @@ void HEAPMGR_GETMETRICS(hmU16_t *pBlkMax,
   HEAPMGR_UNLOCK();
 }
 
+#ifdef HEAPMGR_SEGREGATED
+/**
+ * @brief   obtain the memory cached on the size class free lists.
+ *          This memory is counted neither as allocated nor as free by
+ *          HEAPMGR_GETMETRICS(): it is held by the allocator and only
+ *          returned to the first-fit heap when that runs out.
+ * @return  number of bytes, headers included, on the class free lists.
+ */
+hmU16_t HEAPMGR_GETSEGCACHED(void)
+{
+  hmU16_t cached;
+
+  HEAPMGR_LOCK();
+  cached = HEAPMGR_SEGCACHED;
+  HEAPMGR_UNLOCK();
+
+  return cached;
+}
+#endif /* HEAPMGR_SEGREGATED */
+
 /**
  * @brief   Sanity checks heap
  * @return  0 when heap is OK. Non-zero, otherwise.
@@ -60,6 +60,10 @@
 
 #include "icall.h"
 #include "icall_platform.h"
+#include "cyc_trace.h"
+#ifdef CS_PROF
+#include "cs_prof.h"
+#endif /* CS_PROF */
 
 #ifndef ICALL_FEATURE_SEPARATE_IMGINFO
 #include <icall_addrs.h>
@@ -245,8 +249,19 @@ static const void *ICall_initParams[] = ICALL_CUSTOM_INIT_PARAMS;
 
 #endif /* ICALL_FEATURE_SEPARATE_IMGINFO */
 
-/** @internal message queue */
-typedef void *ICall_MsgQueue;
+/**
+ * @internal message queue.
+ * Both ends of the list are tracked so that enqueue, dequeue and
+ * prepend operations take constant time regardless of queue depth.
+ */
+typedef struct _icall_msg_queue_t
+{
+  void *head;
+  void *tail;
+} ICall_MsgQueue;
+
+/** @internal initializer for an empty @ref ICall_MsgQueue */
+#define ICALL_MSG_QUEUE_INIT(_q) do { (_q).head = NULL; (_q).tail = NULL; } while (0)
 
 /** @internal data structure about a task using ICall module */
 typedef struct _icall_task_entry_t
@@ -254,6 +269,12 @@ typedef struct _icall_task_entry_t
   Task_Handle task;
   ICall_SyncHandle syncHandle;
   ICall_MsgQueue queue;
+  /* response slot, see ICall_armMatch() */
+  ICall_MsgMatchFn armedMatch;
+  void *armedMsg;
+#ifdef HEAPMGR_TRACE
+  uint_least8_t heapOwner;
+#endif /* HEAPMGR_TRACE */
 } ICall_TaskEntry;
 
 /** @internal data structure about an entity using ICall module */
@@ -270,17 +291,100 @@ static ICall_TaskEntry ICall_tasks[ICALL_MAX_NUM_TASKS];
 /** @internal storage to track all entities using ICall module */
 static ICall_entityEntry ICall_entities[ICALL_MAX_NUM_ENTITIES];
 
+#ifndef ICALL_SERVICE_MAP_MAX_CLASS
+/**
+ * Highest service class covered by the direct-mapped service table.
+ * Services above this class, or with a non-zero instance number,
+ * are still looked up by scanning @ref ICall_entities.
+ * The value may be overridden by a compile option.
+ */
+#define ICALL_SERVICE_MAP_MAX_CLASS   ICALL_SERVICE_CLASS_DUMMY_BOARD
+#endif
+
+/** @internal number of entries in @ref ICall_serviceMap */
+#define ICALL_SERVICE_MAP_SIZE \
+  ((ICALL_SERVICE_MAP_MAX_CLASS >> 3) + 1)
+
+/**
+ * @internal
+ * Checks whether a service id has a slot in @ref ICall_serviceMap
+ */
+#define ICALL_SERVICE_MAPPED(_s)                                  \
+  (((_s) & ICALL_SERVICE_INSTANCE_MASK) == 0 &&                   \
+   (_s) <= ICALL_SERVICE_MAP_MAX_CLASS)
+
+/**
+ * @internal
+ * Direct-mapped service to entity id table, indexed by service class.
+ * Entries are filled in when a service is enrolled and never change
+ * afterwards, so lookups do not need a critical section.
+ */
+static ICall_EntityID ICall_serviceMap[ICALL_SERVICE_MAP_SIZE];
+
 /**
  * @internal
  * Wakeup schedule data structure definition
  */
 typedef struct _icall_schedule_t
 {
+#ifdef ICALL_TIMER_WHEEL
+  ICall_WheelTimer timer;
+#else /* ICALL_TIMER_WHEEL */
   Clock_Handle  clock;
+#endif /* ICALL_TIMER_WHEEL */
   ICall_TimerCback cback;
   void *arg;
 } ICall_ScheduleEntry;
 
+#ifdef ICALL_TIMER_WHEEL
+#ifndef ICALL_TIMER_WHEEL_TICK_US
+/**
+ * Resolution of the timer wheel in microseconds.
+ * The value may be overridden by a compile option.
+ */
+#define ICALL_TIMER_WHEEL_TICK_US   1000
+#endif
+
+/** @internal number of slots per level of the timer wheel, as a power of 2 */
+#define ICALL_WHEEL_BITS            5
+#define ICALL_WHEEL_SLOTS           (1u << ICALL_WHEEL_BITS)
+#define ICALL_WHEEL_MASK            (ICALL_WHEEL_SLOTS - 1)
+
+/** @internal number of levels of the timer wheel */
+#define ICALL_WHEEL_LEVELS          3
+
+/** @internal number of wheel ticks covered by the timer wheel */
+#define ICALL_WHEEL_RANGE \
+  ((uint_least32_t) 1 << (ICALL_WHEEL_BITS * ICALL_WHEEL_LEVELS))
+
+/** @internal timer wheel slots, level after level */
+static ICall_WheelTimer *ICall_wheelSlots[ICALL_WHEEL_LEVELS *
+                                          ICALL_WHEEL_SLOTS];
+
+/** @internal one bit per slot which may hold timers, for each level */
+static uint_least32_t ICall_wheelBusy[ICALL_WHEEL_LEVELS];
+
+/** @internal next wheel tick to service, and its RTOS clock tick */
+static uint_least32_t ICall_wheelBase;
+static uint_least32_t ICall_wheelBaseClock;
+
+/** @internal wheel tick the driving clock is armed for, if armed */
+static uint_least32_t ICall_wheelArmedAt;
+static bool ICall_wheelArmed;
+
+/** @internal set while the clock function services the wheel */
+static bool ICall_wheelServicing;
+
+/** @internal number of running timers */
+static uint_fast16_t ICall_wheelActive;
+
+/** @internal RTOS clock ticks per wheel tick */
+static uint_least32_t ICall_wheelRes;
+
+/** @internal RTOS clock driving the timer wheel */
+static Clock_Struct ICall_wheelClock;
+#endif /* ICALL_TIMER_WHEEL */
+
 /* For now critical sections completely disable hardware interrupts
  * because they are used from ISRs in MAC layer implementation.
  * If MAC layer implementation changes, critical section
@@ -295,8 +399,48 @@ ICall_CSState ICall_enterCSImpl(void)
   return cu.state;
 }
 
+#ifdef CS_PROF
+/* See header file for comment */
+ICall_CSState ICall_enterCSProf(const char *file, uint_least16_t line)
+{
+  ICall_CSState key = ICall_enterCSImpl();
+  CsProf_begin(file, line);
+  return key;
+}
+
+/* See header file for comment */
+void ICall_leaveCSProf(ICall_CSState key)
+{
+  CsProf_end();
+  ICall_leaveCSImpl(key);
+}
+
+/**
+ * @internal
+ * Enters a critical section on behalf of code calling through
+ * the function pointers, i.e. the stack image. The sections are
+ * charged to this line.
+ */
+static ICall_CSState ICall_enterCSPtr(void)
+{
+  return ICall_enterCSProf(__FILE__, __LINE__);
+}
+
+/**
+ * @internal
+ * Leaves a critical section entered with ICall_enterCSPtr().
+ */
+static void ICall_leaveCSPtr(ICall_CSState key)
+{
+  ICall_leaveCSProf(key);
+}
+
+/* See header file for comment */
+ICall_EnterCS ICall_enterCriticalSection = ICall_enterCSPtr;
+#else /* CS_PROF */
 /* See header file for comment */
 ICall_EnterCS ICall_enterCriticalSection = ICall_enterCSImpl;
+#endif /* CS_PROF */
 
 /* leave critical section implementation. See header file for comment */
 void ICall_leaveCSImpl(ICall_CSState key)
@@ -307,7 +451,16 @@ void ICall_leaveCSImpl(ICall_CSState key)
 }
 
 /* See header file for comment */
+#ifdef CS_PROF
+ICall_LeaveCS ICall_leaveCriticalSection = ICall_leaveCSPtr;
+
+/* Critical sections of this file, including those of the heap, are
+ * charged to their caller */
+#define ICall_enterCSImpl()        ICall_enterCSProf(__FILE__, __LINE__)
+#define ICall_leaveCSImpl(key)     ICall_leaveCSProf(key)
+#else /* CS_PROF */
 ICall_LeaveCS ICall_leaveCriticalSection = ICall_leaveCSImpl;
+#endif /* CS_PROF */
 
 /* Implementing a simple heap using heapmgr.h template.
  * This simple heap depends on critical section implementation
@@ -316,21 +469,83 @@ void *ICall_heapMalloc(uint16_t size);
 void *ICall_heapRealloc(void *blk, uint16_t size);
 void ICall_heapFree(void *blk);
 #define HEAPMGR_INIT       ICall_heapInit
+#ifdef CYC_TRACE
+/* ICall_heapMalloc() is the traced wrapper of the template allocator */
+void *ICall_heapMallocUntraced(uint16_t size);
+#define HEAPMGR_MALLOC     ICall_heapMallocUntraced
+#else /* CYC_TRACE */
 #define HEAPMGR_MALLOC     ICall_heapMalloc
+#endif /* CYC_TRACE */
 #define HEAPMGR_FREE       ICall_heapFree
 #define HEAPMGR_REALLOC    ICall_heapRealloc
 #define HEAPMGR_GETMETRICS ICall_heapGetMetrics
+#define HEAPMGR_GETSEGCACHED ICall_heapGetSegCached
 #define HEAPMGR_LOCK()                                       \
   do { ICall_heapCSState = ICall_enterCSImpl(); } while (0)
 #define HEAPMGR_UNLOCK()                                     \
   do { ICall_leaveCSImpl(ICall_heapCSState); } while (0)
 #define HEAPMGR_IMPL_INIT()
+#ifdef HEAPMGR_TRACE
+/* Blocks are charged to the allocating task, or to whichever owner
+ * the task has temporarily selected with ICall_heapSetOwner(). */
+#define HEAPMGR_TRACE_OWNERS  ICALL_HEAP_OWNER_TASK(ICALL_MAX_NUM_TASKS)
+#define HEAPMGR_TRACE_OWNER() ICall_heapOwner()
+#define HEAPMGR_TRACE_REPORT  ICall_heapTraceReport
+#endif /* HEAPMGR_TRACE */
 /* Note that a static variable can be used to contain critical section
  * state since heapmgr.h template ensures that there is no nested
  * lock call. */
 static ICall_CSState ICall_heapCSState;
 #include <heapmgr.h>
 
+#ifdef CYC_TRACE
+void *ICall_heapMalloc(uint16_t size)
+{
+  void *blk;
+
+  CYC_TRACE_BEGIN(CYC_TRACE_HEAP_MALLOC);
+  blk = ICall_heapMallocUntraced(size);
+  CYC_TRACE_END(CYC_TRACE_HEAP_MALLOC);
+
+  return blk;
+}
+#endif /* CYC_TRACE */
+
+/**
+ * @internal Caches a task entry in the environment pointer of its task
+ *           so that subsequent lookups from the task need no table scan.
+ *           An environment pointer already in use by someone else is left
+ *           untouched, in which case lookups simply keep scanning.
+ * @param taskentry  task entry to cache
+ */
+static void ICall_cacheTask(ICall_TaskEntry *taskentry)
+{
+  if (Task_getEnv(taskentry->task) == NULL)
+  {
+    Task_setEnv(taskentry->task, taskentry);
+  }
+}
+
+/**
+ * @internal Retrieves the task entry cached by ICall_cacheTask().
+ * @param taskhandle  TI-RTOS task handle
+ * @return Pointer to task entry when cached, or NULL.
+ */
+static ICall_TaskEntry *ICall_cachedTask(Task_Handle taskhandle)
+{
+  ICall_TaskEntry *taskentry = (ICall_TaskEntry *) Task_getEnv(taskhandle);
+
+  /* The environment pointer is trusted only if it points into
+   * ICall_tasks and the entry refers back to the same task. */
+  if ((uintptr_t) taskentry >= (uintptr_t) &ICall_tasks[0] &&
+      (uintptr_t) taskentry < (uintptr_t) &ICall_tasks[ICALL_MAX_NUM_TASKS] &&
+      taskentry->task == taskhandle)
+  {
+    return taskentry;
+  }
+  return NULL;
+}
+
 /**
  * @internal Searches for a task entry within @ref ICall_tasks.
  * @param taskhandle  TI-RTOS task handle
@@ -340,6 +555,12 @@ static ICall_TaskEntry *ICall_searchTask(Task_Handle taskhandle)
 {
   size_t i;
   ICall_CSState key;
+  ICall_TaskEntry *taskentry = ICall_cachedTask(taskhandle);
+
+  if (taskentry != NULL)
+  {
+    return taskentry;
+  }
 
   key = ICall_enterCSImpl();
   for (i = 0; i < ICALL_MAX_NUM_TASKS; i++)
@@ -351,6 +572,7 @@ static ICall_TaskEntry *ICall_searchTask(Task_Handle taskhandle)
     }
     if (taskhandle == ICall_tasks[i].task)
     {
+      ICall_cacheTask(&ICall_tasks[i]);
       ICall_leaveCSImpl(key);
       return &ICall_tasks[i];
     }
@@ -359,6 +581,36 @@ static ICall_TaskEntry *ICall_searchTask(Task_Handle taskhandle)
   return NULL;
 }
 
+#ifdef HEAPMGR_TRACE
+/* See header file for comment */
+uint_least8_t ICall_heapOwner(void)
+{
+  ICall_TaskEntry *taskentry;
+
+  if (BIOS_getThreadType() != BIOS_ThreadType_Task)
+  {
+    return ICALL_HEAP_OWNER_OTHER;
+  }
+  taskentry = ICall_searchTask(Task_self());
+  return (taskentry != NULL) ? taskentry->heapOwner : ICALL_HEAP_OWNER_OTHER;
+}
+
+/* See header file for comment */
+uint_least8_t ICall_heapSetOwner(uint_least8_t owner)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+  uint_least8_t prev;
+
+  if (taskentry == NULL)
+  {
+    return ICALL_HEAP_OWNER_OTHER;
+  }
+  prev = taskentry->heapOwner;
+  taskentry->heapOwner = owner;
+  return prev;
+}
+#endif /* HEAPMGR_TRACE */
+
 /**
  * @internal Searches for a task entry within @ref ICall_tasks or
  *           build an entry if the entry table is empty.
@@ -378,13 +630,19 @@ static ICall_TaskEntry *ICall_newTask(Task_Handle taskhandle)
       /* Empty slot */
       ICall_TaskEntry *taskentry = &ICall_tasks[i];
       taskentry->task = taskhandle;
-      taskentry->queue = NULL;
+      ICALL_MSG_QUEUE_INIT(taskentry->queue);
+      taskentry->armedMatch = NULL;
+      taskentry->armedMsg = NULL;
+#ifdef HEAPMGR_TRACE
+      taskentry->heapOwner = (uint_least8_t) ICALL_HEAP_OWNER_TASK(i);
+#endif /* HEAPMGR_TRACE */
       taskentry->syncHandle = ICALL_SYNC_HANDLE_CREATE();
       if (taskentry->syncHandle == NULL)
       {
         /* abort */
         ICALL_HOOK_ABORT_FUNC();
       }
+      ICall_cacheTask(taskentry);
       ICall_leaveCSImpl(key);
       return taskentry;
     }
@@ -404,6 +662,11 @@ ICall_EntityID ICall_searchServiceEntity(ICall_ServiceEnum service)
   size_t i;
   ICall_CSState key;
 
+  if (ICALL_SERVICE_MAPPED(service))
+  {
+    return ICall_serviceMap[service >> 3];
+  }
+
   key = ICall_enterCSImpl();
   for (i = 0; i < ICALL_MAX_NUM_ENTITIES; i++)
   {
@@ -439,23 +702,45 @@ ICall_searchService(ICall_ServiceEnum service)
   return &ICall_entities[entity];
 }
 
+/**
+ * @internal Records a newly enrolled service in @ref ICall_serviceMap.
+ * @param service  service id
+ * @param entity   entity id assigned to the service
+ */
+static void ICall_mapService(ICall_ServiceEnum service, ICall_EntityID entity)
+{
+  if (ICALL_SERVICE_MAPPED(service))
+  {
+    ICall_serviceMap[service >> 3] = entity;
+  }
+}
+
 /* Dispatcher implementation. See ICall_dispatcher declaration
  * for comment. */
 static ICall_Errno ICall_dispatch(ICall_FuncArgsHdr *args)
 {
   ICall_entityEntry *entity;
+  ICall_Errno errno;
+
+  CYC_TRACE_BEGIN(CYC_TRACE_ICALL_DISPATCH);
 
   entity =  ICall_searchService(args->service);
   if (!entity)
   {
-    return ICALL_ERRNO_INVALID_SERVICE;
+    errno = ICALL_ERRNO_INVALID_SERVICE;
   }
-  if (!entity->fn)
+  else if (!entity->fn)
   {
-    return ICALL_ERRNO_INVALID_FUNCTION;
+    errno = ICALL_ERRNO_INVALID_FUNCTION;
+  }
+  else
+  {
+    errno = entity->fn(args);
   }
 
-  return entity->fn(args);
+  CYC_TRACE_END(CYC_TRACE_ICALL_DISPATCH);
+
+  return errno;
 }
 
 /* See header file for comments */
@@ -467,8 +752,13 @@ ICall_Dispatcher ICall_dispatcher = ICall_dispatch;
 static const ICall_RemoteTaskArg ICall_taskEntryFuncs =
 {
   ICall_dispatch,
+#ifdef CS_PROF
+  ICall_enterCSPtr,
+  ICall_leaveCSPtr
+#else /* CS_PROF */
   ICall_enterCSImpl,
   ICall_leaveCSImpl
+#endif /* CS_PROF */
 };
 
 /**
@@ -488,6 +778,9 @@ static Void ICall_taskEntry(UArg arg0, UArg arg1)
 /* forward reference */
 static void ICall_initPrim(void);
 #endif /* ICALL_JT */
+#ifdef ICALL_TIMER_WHEEL
+static void ICall_wheelInit(void);
+#endif /* ICALL_TIMER_WHEEL */
 
 /* See header file for comments. */
 void ICall_init(void)
@@ -497,12 +790,20 @@ void ICall_init(void)
   for (i = 0; i < ICALL_MAX_NUM_TASKS; i++)
   {
     ICall_tasks[i].task = NULL;
-    ICall_tasks[i].queue = NULL;
+    ICALL_MSG_QUEUE_INIT(ICall_tasks[i].queue);
   }
   for (i = 0; i < ICALL_MAX_NUM_ENTITIES; i++)
   {
     ICall_entities[i].service = ICALL_SERVICE_CLASS_INVALID_ENTRY;
   }
+  for (i = 0; i < ICALL_SERVICE_MAP_SIZE; i++)
+  {
+    ICall_serviceMap[i] = ICALL_INVALID_ENTITY_ID;
+  }
+
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelInit();
+#endif /* ICALL_TIMER_WHEEL */
 
 #ifndef ICALL_JT
   /* Initialize primitive service */
@@ -590,6 +891,7 @@ static ICall_Errno ICall_primEnroll(ICall_EnrollServiceArgs *args)
       ICall_entities[i].service = args->service;
       ICall_entities[i].task = taskentry;
       ICall_entities[i].fn = args->fn;
+      ICall_mapService(args->service, (ICall_EntityID) i);
       args->entity = (ICall_EntityID) i;
       args->msgSyncHdl = taskentry->syncHandle;
       ICall_leaveCSImpl(key);
@@ -740,7 +1042,6 @@ static ICall_Errno ICall_primFree(ICall_FreeArgs *args)
  */
 static void ICall_msgEnqueue( ICall_MsgQueue *q_ptr, void *msg_ptr )
 {
-  void *list;
   ICall_CSState key;
 
   // Hold off interrupts
@@ -748,19 +1049,16 @@ static void ICall_msgEnqueue( ICall_MsgQueue *q_ptr, void *msg_ptr )
 
   ICALL_MSG_NEXT( msg_ptr ) = NULL;
   // If first message in queue
-  if ( *q_ptr == NULL )
+  if ( q_ptr->head == NULL )
   {
-    *q_ptr = msg_ptr;
+    q_ptr->head = msg_ptr;
   }
   else
   {
-    // Find end of queue
-    for ( list = *q_ptr; ICALL_MSG_NEXT( list ) != NULL;
-          list = ICALL_MSG_NEXT( list ) );
-
     // Add message to end of queue
-    ICALL_MSG_NEXT( list ) = msg_ptr;
+    ICALL_MSG_NEXT( q_ptr->tail ) = msg_ptr;
   }
+  q_ptr->tail = msg_ptr;
 
   // Re-enable interrupts
   ICall_leaveCSImpl(key);
@@ -779,11 +1077,15 @@ static void *ICall_msgDequeue( ICall_MsgQueue *q_ptr )
   // Hold off interrupts
   key = ICall_enterCSImpl();
 
-  if ( *q_ptr != NULL )
+  if ( q_ptr->head != NULL )
   {
     // Dequeue message
-    msg_ptr = *q_ptr;
-    *q_ptr = ICALL_MSG_NEXT( msg_ptr );
+    msg_ptr = q_ptr->head;
+    q_ptr->head = ICALL_MSG_NEXT( msg_ptr );
+    if ( q_ptr->head == NULL )
+    {
+      q_ptr->tail = NULL;
+    }
     ICALL_MSG_NEXT( msg_ptr ) = NULL;
     ICALL_MSG_DEST_ID( msg_ptr ) = ICALL_UNDEF_DEST_ID;
   }
@@ -797,32 +1099,67 @@ static void *ICall_msgDequeue( ICall_MsgQueue *q_ptr )
 /**
  * @internal Prepends a list of messages to a message queue
  * @param q_ptr  message queue pointer
- * @param head   message list to prepend
+ * @param list   message queue to prepend. The queue is left
+ *               in an undefined state after the call.
  */
-static void ICall_msgPrepend( ICall_MsgQueue *q_ptr, ICall_MsgQueue head )
+static void ICall_msgPrepend( ICall_MsgQueue *q_ptr, ICall_MsgQueue *list )
 {
-  void *msg_ptr = NULL;
   ICall_CSState key;
 
   // Hold off interrupts
   key = ICall_enterCSImpl();
 
-  if ( head != NULL )
+  if ( list->head != NULL )
   {
-    /* Find the end of the queue */
-    msg_ptr = head;
-    while (ICALL_MSG_NEXT( msg_ptr ) != NULL)
+    /* Splice the list in front of the queue */
+    ICALL_MSG_NEXT( list->tail ) = q_ptr->head;
+    if ( q_ptr->head == NULL )
     {
-      msg_ptr = ICALL_MSG_NEXT( msg_ptr );
+      q_ptr->tail = list->tail;
     }
-    ICALL_MSG_NEXT(msg_ptr) = *q_ptr;
-    *q_ptr = head;
+    q_ptr->head = list->head;
   }
 
   // Re-enable interrupts
   ICall_leaveCSImpl(key);
 }
 
+/**
+ * @internal Delivers a message to a task.
+ *
+ * The message is stored in the response slot of the task if the slot
+ * is armed and empty and the message matches, or queued otherwise.
+ * The header of the message must already be filled in.
+ *
+ * @param taskentry  task entry of the destination
+ * @param msg        pointer to the message body
+ */
+static void ICall_deliverMsg(ICall_TaskEntry *taskentry, void *msg)
+{
+  ICall_MsgHdr *hdr = (ICall_MsgHdr *) msg - 1;
+  ICall_MsgMatchFn matchFn = taskentry->armedMatch;
+  ICall_ServiceEnum servId = ICall_entities[hdr->srcentity].service;
+
+  /* As with ICall_waitMatch(), only messages from a server can match */
+  if (matchFn != NULL &&
+      servId != ICALL_SERVICE_CLASS_INVALID_ENTRY &&
+      servId != ICALL_SERVICE_CLASS_APPLICATION &&
+      matchFn(servId, hdr->dstentity, msg))
+  {
+    ICall_CSState key = ICall_enterCSImpl();
+
+    /* The slot may have been disarmed or filled in the meantime */
+    if (taskentry->armedMatch == matchFn && taskentry->armedMsg == NULL)
+    {
+      taskentry->armedMsg = msg;
+      ICall_leaveCSImpl(key);
+      return;
+    }
+    ICall_leaveCSImpl(key);
+  }
+  ICall_msgEnqueue(&taskentry->queue, msg);
+}
+
 #ifndef ICALL_JT
 /**
  * @internal Sends a message to an entity.
@@ -860,7 +1197,7 @@ static ICall_Errno ICall_primSend(ICall_SendArgs *args)
   hdr->srcentity = args->src;
   hdr->dstentity = args->dest.entityId;
   hdr->format = args->format;
-  ICall_msgEnqueue(&ICall_entities[args->dest.entityId].task->queue, args->msg);
+  ICall_deliverMsg(ICall_entities[args->dest.entityId].task, args->msg);
   ICALL_SYNC_HANDLE_POST(ICall_entities[args->dest.entityId].task->syncHandle);
 
   return ICALL_ERRNO_SUCCESS;
@@ -931,7 +1268,7 @@ static ICall_Errno ICall_primRepostSync(void)
   }
 
   /* Check if this entity's queue is not empty */
-  if (taskentry->queue == NULL)
+  if (taskentry->queue.head == NULL)
   {
     /* Queue is empty */
     return ICALL_ERRNO_NOMSG;
@@ -972,6 +1309,74 @@ static ICall_Errno ICall_primEntityId2ServiceId(ICall_EntityID entityId,
   return ICALL_ERRNO_SUCCESS;
 }
 
+/**
+ * @internal Retrieves up to a given number of service messages from
+ * the message queue of a task in one go.
+ *
+ * Messages that were not sent by a server are thrown away, as with
+ * ICall_fetchServiceMsg().
+ *
+ * The first message retrieved is assumed to account for the wakeup
+ * of the calling thread; the signals posted for the other retrieved
+ * messages are consumed here so that the thread does not wake up again
+ * only to find an empty queue.
+ *
+ * @param taskentry  task entry of the calling thread
+ * @param msgs       array to store the retrieved messages
+ * @param max        number of elements in @p msgs
+ * @return number of messages stored in @p msgs
+ */
+static uint_least8_t ICall_fetchServiceMsgs(ICall_TaskEntry *taskentry,
+                                            ICall_ServiceMsg *msgs,
+                                            uint_least8_t max)
+{
+  uint_least8_t count = 0;
+  uint_least8_t taken = 0;
+
+  while (count < max)
+  {
+    void *msg = ICall_msgDequeue(&taskentry->queue);
+    ICall_MsgHdr *hdr;
+
+    if (msg == NULL)
+    {
+      break;
+    }
+    taken++;
+    hdr = (ICall_MsgHdr *) msg - 1;
+    if (ICall_primEntityId2ServiceId(hdr->srcentity, &msgs[count].src) !=
+        ICALL_ERRNO_SUCCESS)
+    {
+      /* Source entity ID cannot be translated to service id */
+      ICall_freeMsg(msg);
+      continue;
+    }
+    msgs[count].dest = hdr->dstentity;
+    msgs[count].msg = msg;
+    count++;
+  }
+
+#ifdef ICALL_EVENTS
+  /* Event flags are binary and were cleared by the last pend, so they only
+   * need to be re-posted if messages were left in the queue. */
+  if (taskentry->queue.head != NULL)
+  {
+    ICALL_SYNC_HANDLE_POST(taskentry->syncHandle);
+  }
+#else /* ICALL_EVENTS */
+  /* Each queued message posted the semaphore once */
+  while (taken-- > 1)
+  {
+    if (!ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, BIOS_NO_WAIT))
+    {
+      break;
+    }
+  }
+#endif /* ICALL_EVENTS */
+
+  return count;
+}
+
 #ifndef ICALL_JT
 /**
  * @internal Transforms and entityId into a serviceId.
@@ -1053,6 +1458,28 @@ static ICall_Errno ICall_primFetchServiceMsg(ICall_FetchMsgArgs *args)
   }
   return errno;
 }
+
+/**
+ * @internal Retrieves a batch of messages received at the message queue
+ * associated with the calling thread.
+ *
+ * @param args   arguments corresponding to those of
+ *               ICall_fetchServiceMsgBatch()
+ * @return return values corresponding to those of
+ *         ICall_fetchServiceMsgBatch()
+ */
+static ICall_Errno ICall_primFetchServiceMsgBatch(ICall_FetchMsgBatchArgs *args)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+
+  args->count = 0;
+  if (!taskentry)
+  {
+    return ICALL_ERRNO_UNKNOWN_THREAD;
+  }
+  args->count = ICall_fetchServiceMsgs(taskentry, args->msgs, args->max);
+  return (args->count != 0) ? ICALL_ERRNO_SUCCESS : ICALL_ERRNO_NOMSG;
+}
 #endif /* ICALL_JT */
 /**
  * @internal
@@ -1080,6 +1507,177 @@ static ICall_Errno ICall_msecs2Ticks(uint_fast32_t msecs, UInt *ticks)
   return ICALL_ERRNO_SUCCESS;
 }
 
+/**
+ * @internal
+ * Arms the response slot of the calling thread.
+ *
+ * A message left in the slot by a previous arming that was never
+ * collected is handed back to the message queue. Its signal was already
+ * posted, so the queue and the synchronization object remain consistent.
+ *
+ * @param matchFn  match function, or NULL to disarm the slot
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when the calling thread
+ *         does not have a task entry.
+ */
+static ICall_Errno ICall_armMatchImpl(ICall_MsgMatchFn matchFn)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+  ICall_CSState key;
+  void *msg;
+
+  if (!taskentry)
+  {
+    return ICALL_ERRNO_UNKNOWN_THREAD;
+  }
+
+  key = ICall_enterCSImpl();
+  msg = taskentry->armedMsg;
+  taskentry->armedMatch = matchFn;
+  taskentry->armedMsg = NULL;
+  ICall_leaveCSImpl(key);
+
+  if (msg != NULL)
+  {
+    ICall_msgEnqueue(&taskentry->queue, msg);
+  }
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/**
+ * @internal
+ * Waits for the message routed to the response slot of the calling thread
+ * and disarms the slot.
+ *
+ * Unlike ICall_waitMatch(), queued messages are neither dequeued nor
+ * passed to the match function. Wakeups caused by those messages are
+ * counted and their signals restored before returning.
+ *
+ * @param milliseconds  timeout period in milliseconds
+ * @param servId  pointer to a variable to store the service id of the sender
+ * @param dest    pointer to a variable to store the destination entity id
+ * @param msg     pointer to a variable to store the message body
+ * @return return values corresponding to those of ICall_waitArmedMatch()
+ */
+static ICall_Errno ICall_waitArmedMatchImpl(uint_least32_t milliseconds,
+                                            ICall_ServiceEnum *servId,
+                                            ICall_EntityID *dest,
+                                            void **msg)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+#ifndef ICALL_EVENTS
+  uint_fast16_t consumedCount = 0;
+#endif
+  UInt timeout;
+  uint_fast32_t timeoutStamp;
+  ICall_CSState key;
+  ICall_MsgHdr *hdr;
+  void *found;
+
+  {
+    BIOS_ThreadType threadtype = BIOS_getThreadType();
+
+    if (threadtype == BIOS_ThreadType_Hwi ||
+        threadtype == BIOS_ThreadType_Swi)
+    {
+      /* Blocking call is not allowed from Hwi or Swi. */
+      return ICALL_ERRNO_UNKNOWN_THREAD;
+    }
+  }
+
+  if (!taskentry)
+  {
+    return ICALL_ERRNO_UNKNOWN_THREAD;
+  }
+  if (taskentry->armedMatch == NULL)
+  {
+    return ICALL_ERRNO_INVALID_PARAMETER;
+  }
+  if (milliseconds == 0)
+  {
+    timeout = BIOS_NO_WAIT;
+  }
+  else if (milliseconds == ICALL_TIMEOUT_FOREVER)
+  {
+    timeout = BIOS_WAIT_FOREVER;
+  }
+  else
+  {
+    /* Convert milliseconds to number of ticks */
+    ICall_Errno errno = ICall_msecs2Ticks(milliseconds, &timeout);
+    if (errno != ICALL_ERRNO_SUCCESS)
+    {
+      ICall_armMatchImpl(NULL);
+      return errno;
+    }
+  }
+
+  CYC_TRACE_BEGIN(CYC_TRACE_ICALL_WAIT_MATCH);
+
+  timeoutStamp = Clock_getTicks() + timeout;
+  while (taskentry->armedMsg == NULL &&
+         ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
+  {
+#ifndef ICALL_EVENTS
+    /* Keep the decremented semaphore count */
+    consumedCount++;
+#endif /* ICALL_EVENTS */
+    if (timeout != BIOS_WAIT_FOREVER &&
+        timeout != BIOS_NO_WAIT)
+    {
+      /* Readjust timeout */
+      UInt newTimeout = timeoutStamp - Clock_getTicks();
+      if (newTimeout == 0 || newTimeout > timeout)
+      {
+        break;
+      }
+      timeout = newTimeout;
+    }
+  }
+
+  /* Disarm, collecting a message routed up to this point */
+  key = ICall_enterCSImpl();
+  found = taskentry->armedMsg;
+  taskentry->armedMatch = NULL;
+  taskentry->armedMsg = NULL;
+  ICall_leaveCSImpl(key);
+
+  CYC_TRACE_END(CYC_TRACE_ICALL_WAIT_MATCH);
+
+#ifdef ICALL_EVENTS
+  /* The event flag may have been cleared on behalf of queued messages */
+  ICall_primRepostSync();
+#else /* ICALL_EVENTS */
+  if (found != NULL)
+  {
+    /* One signal was posted for the routed message */
+    if (consumedCount > 0)
+    {
+      consumedCount--;
+    }
+    else
+    {
+      (void) ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, BIOS_NO_WAIT);
+    }
+  }
+  /* Re-increment the semaphores consumed on behalf of queued messages */
+  for (; consumedCount > 0; consumedCount--)
+  {
+    Semaphore_post(taskentry->syncHandle);
+  }
+#endif /* ICALL_EVENTS */
+
+  if (found == NULL)
+  {
+    return ICALL_ERRNO_TIMEOUT;
+  }
+  hdr = (ICall_MsgHdr *) found - 1;
+  *servId = ICall_entities[hdr->srcentity].service;
+  *dest = hdr->dstentity;
+  *msg = found;
+  return ICALL_ERRNO_SUCCESS;
+}
+
 #ifndef ICALL_JT
 /**
  * @internal
@@ -1277,6 +1875,392 @@ static ICall_Errno ICall_primGetTicks(ICall_GetUint32Args *args)
 }
 #endif /* ICALL_JT */
 
+#ifdef ICALL_TIMER_WHEEL
+/**
+ * @internal Converts RTOS clock ticks to wheel ticks, rounding up.
+ * @param ticks  RTOS clock ticks
+ * @return wheel ticks
+ */
+static uint_least32_t ICall_wheelTicks(uint_fast32_t ticks)
+{
+  return (uint_least32_t) (ticks / ICall_wheelRes +
+                           ((ticks % ICall_wheelRes) ? 1 : 0));
+}
+
+/**
+ * @internal Gets the RTOS clock ticks elapsed since the start of
+ * @ref ICall_wheelBase. Once a tick has been serviced, the wheel base is
+ * the tick after it, which starts up to one wheel tick in the future,
+ * so the result may be negative.
+ * @param now  current RTOS clock tick
+ * @return elapsed RTOS clock ticks
+ */
+static int_least32_t ICall_wheelElapsed(uint_least32_t now)
+{
+  return (int_least32_t) (now - ICall_wheelBaseClock);
+}
+
+/**
+ * @internal Gets the current wheel time.
+ * @param now  current RTOS clock tick
+ * @return current time in wheel ticks
+ */
+static uint_least32_t ICall_wheelNow(uint_least32_t now)
+{
+  int_least32_t elapsed = ICall_wheelElapsed(now);
+
+  if (elapsed < 0)
+  {
+    return ICall_wheelBase -
+           (uint_least32_t) (-elapsed + ICall_wheelRes - 1) / ICall_wheelRes;
+  }
+  return ICall_wheelBase + (uint_least32_t) elapsed / ICall_wheelRes;
+}
+
+/**
+ * @internal Gets the first wheel tick which starts no earlier than now.
+ * A timer expiring a number of ticks after it never fires early, even
+ * when the current wheel tick has partly elapsed.
+ * @param now  current RTOS clock tick
+ * @return wheel tick
+ */
+static uint_least32_t ICall_wheelNext(uint_least32_t now)
+{
+  int_least32_t elapsed = ICall_wheelElapsed(now);
+
+  if (elapsed < 0)
+  {
+    return ICall_wheelBase - (uint_least32_t) -elapsed / ICall_wheelRes;
+  }
+  return ICall_wheelBase + (uint_least32_t) elapsed / ICall_wheelRes +
+         (((uint_least32_t) elapsed % ICall_wheelRes) ? 1 : 0);
+}
+
+/**
+ * @internal Links a timer into the slot matching its expiry.
+ *
+ * Level 0 holds the timers expiring within the next
+ * @ref ICALL_WHEEL_SLOTS ticks, one slot per tick. Each upper level
+ * holds timers further away, one slot per block of lower level ticks.
+ * A slot of an upper level is cascaded into the lower levels when its
+ * block starts. Timers beyond the range of the wheel are linked into the
+ * furthest slot and re-inserted when it is cascaded.
+ *
+ * @param timer  timer with its expiry field set
+ * @return wheel tick at which the timer's slot is serviced
+ */
+static uint_least32_t ICall_wheelLink(ICall_WheelTimer *timer)
+{
+  uint_least32_t expiry = timer->expiry;
+  uint_least32_t idx = expiry - ICall_wheelBase;
+  uint_fast8_t level = 0;
+  uint_fast8_t slot;
+
+  if ((int_least32_t) idx < 0)
+  {
+    /* Already expired: service it with the next tick */
+    expiry = ICall_wheelBase;
+    idx = 0;
+  }
+  else if (idx >= ICALL_WHEEL_RANGE)
+  {
+    expiry = ICall_wheelBase + ICALL_WHEEL_RANGE - 1;
+    idx = ICALL_WHEEL_RANGE - 1;
+  }
+  while (idx >= ((uint_least32_t) 1 << (ICALL_WHEEL_BITS * (level + 1))))
+  {
+    level++;
+  }
+  expiry >>= ICALL_WHEEL_BITS * level;
+  slot = level * ICALL_WHEEL_SLOTS + (expiry & ICALL_WHEEL_MASK);
+
+  timer->next = ICall_wheelSlots[slot];
+  if (timer->next != NULL)
+  {
+    timer->next->pprev = &timer->next;
+  }
+  ICall_wheelSlots[slot] = timer;
+  timer->pprev = &ICall_wheelSlots[slot];
+  ICall_wheelBusy[level] |= (uint_least32_t) 1 << (slot & ICALL_WHEEL_MASK);
+  ICall_wheelActive++;
+
+  return expiry << (ICALL_WHEEL_BITS * level);
+}
+
+/**
+ * @internal Unlinks a running timer from its slot.
+ * The busy bit of the slot is cleared lazily by ICall_wheelNextEvent().
+ * @param timer  timer to unlink
+ */
+static void ICall_wheelUnlink(ICall_WheelTimer *timer)
+{
+  *timer->pprev = timer->next;
+  if (timer->next != NULL)
+  {
+    timer->next->pprev = timer->pprev;
+  }
+  timer->pprev = NULL;
+  ICall_wheelActive--;
+}
+
+/**
+ * @internal Finds the next wheel tick at which a timer expires or
+ * a non-empty slot is cascaded.
+ * @param tick  pointer to a variable to store the wheel tick
+ * @return true if there is such a tick, false if the wheel is empty.
+ */
+static bool ICall_wheelNextEvent(uint_least32_t *tick)
+{
+  uint_least32_t best = 0;
+  bool found = false;
+  uint_fast8_t level;
+
+  for (level = 0; level < ICALL_WHEEL_LEVELS; level++)
+  {
+    uint_fast8_t shift = ICALL_WHEEL_BITS * level;
+    uint_least32_t block = ICall_wheelBase >> shift;
+    uint_fast8_t d;
+
+    if (ICall_wheelBase & (((uint_least32_t) 1 << shift) - 1))
+    {
+      /* Slots of this level are serviced at block starts only */
+      block++;
+    }
+    for (d = 0; d < ICALL_WHEEL_SLOTS && ICall_wheelBusy[level]; d++)
+    {
+      uint_fast8_t idx = (block + d) & ICALL_WHEEL_MASK;
+      uint_least32_t t;
+
+      if (!(ICall_wheelBusy[level] & ((uint_least32_t) 1 << idx)))
+      {
+        continue;
+      }
+      if (ICall_wheelSlots[level * ICALL_WHEEL_SLOTS + idx] == NULL)
+      {
+        ICall_wheelBusy[level] &= ~((uint_least32_t) 1 << idx);
+        continue;
+      }
+      t = (block + d) << shift;
+      if (!found || (t - ICall_wheelBase) < (best - ICall_wheelBase))
+      {
+        best = t;
+        found = true;
+      }
+      break;
+    }
+  }
+  *tick = best;
+  return found;
+}
+
+/**
+ * @internal Arms the RTOS clock driving the wheel.
+ * @param tick  wheel tick at which the clock shall expire
+ * @param now  current RTOS clock tick
+ */
+static void ICall_wheelArm(uint_least32_t tick, uint_least32_t now)
+{
+  Clock_Handle handle = Clock_handle(&ICall_wheelClock);
+  uint_least32_t due = ICall_wheelBaseClock +
+                       (tick - ICall_wheelBase) * ICall_wheelRes;
+  int_least32_t timeout = (int_least32_t) (due - now);
+
+  Clock_stop(handle);
+  Clock_setTimeout(handle, (timeout > 0) ? (UInt) timeout : 1);
+  Clock_start(handle);
+  ICall_wheelArmedAt = tick;
+  ICall_wheelArmed = true;
+}
+
+/**
+ * @internal
+ * Clock function of the timer wheel. Services every tick with a pending
+ * event up to the current time and arms the clock for the next one.
+ * Cascaded timers are moved and expiry functions are called one at
+ * a time, each in a critical section of its own, so that interrupts are
+ * not masked for longer than a single timer and expiry functions may
+ * start or stop any timer.
+ *
+ * @param arg  not used
+ */
+static Void ICall_wheelClockFunc(UArg arg)
+{
+  ICall_CSState key = ICall_enterCSImpl();
+  uint_least32_t tick;
+
+  ICall_wheelArmed = false;
+  ICall_wheelServicing = true;
+  while (ICall_wheelNextEvent(&tick))
+  {
+    ICall_WheelTimer *timer;
+    uint_least32_t now = Clock_getTicks();
+    uint_fast8_t level;
+
+    if ((int_least32_t) (tick - ICall_wheelNow(now)) > 0)
+    {
+      /* Not due yet */
+      ICall_wheelArm(tick, now);
+      break;
+    }
+
+    /* Nothing happens on the ticks skipped */
+    ICall_wheelBaseClock += (tick - ICall_wheelBase) * ICall_wheelRes;
+    ICall_wheelBase = tick;
+
+    /* Cascade the upper level slots whose block starts now */
+    for (level = ICALL_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+      uint_fast8_t shift = ICALL_WHEEL_BITS * level;
+      ICall_WheelTimer **slot;
+
+      if (tick & (((uint_least32_t) 1 << shift) - 1))
+      {
+        continue;
+      }
+      slot = &ICall_wheelSlots[level * ICALL_WHEEL_SLOTS +
+                               ((tick >> shift) & ICALL_WHEEL_MASK)];
+      /* A cascaded timer always lands in a lower level or another slot */
+      while ((timer = *slot) != NULL)
+      {
+        ICall_wheelUnlink(timer);
+        ICall_wheelLink(timer);
+        ICall_leaveCSImpl(key);
+        key = ICall_enterCSImpl();
+      }
+    }
+
+    /* Expire the timers of this tick */
+    while ((timer = ICall_wheelSlots[tick & ICALL_WHEEL_MASK]) != NULL)
+    {
+      ICall_wheelUnlink(timer);
+      if (timer->period != 0)
+      {
+        timer->expiry += timer->period;
+        ICall_wheelLink(timer);
+      }
+      ICall_leaveCSImpl(key);
+      timer->fn(timer);
+      key = ICall_enterCSImpl();
+    }
+
+    ICall_wheelBase = tick + 1;
+    ICall_wheelBaseClock += ICall_wheelRes;
+  }
+  ICall_wheelServicing = false;
+  ICall_leaveCSImpl(key);
+}
+
+/**
+ * @internal Sets up the timer wheel.
+ */
+static void ICall_wheelInit(void)
+{
+  Clock_Params params;
+
+  ICall_wheelRes = ICALL_TIMER_WHEEL_TICK_US / Clock_tickPeriod;
+  if (ICall_wheelRes == 0)
+  {
+    ICall_wheelRes = 1;
+  }
+  ICall_wheelBaseClock = Clock_getTicks();
+
+  Clock_Params_init(&params);
+  params.startFlag = FALSE;
+  params.period = 0;
+  Clock_construct(&ICall_wheelClock, ICall_wheelClockFunc, 1, &params);
+}
+
+/* See header file for comments. */
+void ICall_wheelConstruct(ICall_WheelTimer *timer, ICall_WheelFunc fn,
+                          uint_fast32_t timeout, uint_fast32_t period)
+{
+  timer->next = NULL;
+  timer->pprev = NULL;
+  timer->fn = fn;
+  timer->expiry = 0;
+  timer->timeout = ICall_wheelTicks(timeout);
+  timer->period = ICall_wheelTicks(period);
+}
+
+/* See header file for comments. */
+void ICall_wheelSetTimeout(ICall_WheelTimer *timer, uint_fast32_t timeout)
+{
+  timer->timeout = ICall_wheelTicks(timeout);
+}
+
+/* See header file for comments. */
+void ICall_wheelSetPeriod(ICall_WheelTimer *timer, uint_fast32_t period)
+{
+  timer->period = ICall_wheelTicks(period);
+}
+
+/* See header file for comments. */
+void ICall_wheelStart(ICall_WheelTimer *timer)
+{
+  ICall_CSState key = ICall_enterCSImpl();
+  uint_least32_t now = Clock_getTicks();
+  uint_least32_t tick;
+
+  if (timer->pprev != NULL)
+  {
+    ICall_wheelUnlink(timer);
+  }
+  if (ICall_wheelServicing)
+  {
+    /* The clock function arms the clock for the next event when done */
+    timer->expiry = ICall_wheelNext(now) + timer->timeout;
+    ICall_wheelLink(timer);
+    ICall_leaveCSImpl(key);
+    return;
+  }
+  if (ICall_wheelActive == 0)
+  {
+    /* Nothing is pending: restart the wheel time from now */
+    ICall_wheelBase = ICall_wheelNow(now);
+    ICall_wheelBaseClock = now;
+  }
+  timer->expiry = ICall_wheelNext(now) + timer->timeout;
+  tick = ICall_wheelLink(timer);
+  if (!ICall_wheelArmed ||
+      (tick - ICall_wheelBase) < (ICall_wheelArmedAt - ICall_wheelBase))
+  {
+    ICall_wheelArm(tick, now);
+  }
+  ICall_leaveCSImpl(key);
+}
+
+/* See header file for comments. */
+void ICall_wheelStop(ICall_WheelTimer *timer)
+{
+  ICall_CSState key = ICall_enterCSImpl();
+
+  if (timer->pprev != NULL)
+  {
+    ICall_wheelUnlink(timer);
+  }
+  ICall_leaveCSImpl(key);
+}
+
+/* See header file for comments. */
+bool ICall_wheelIsActive(ICall_WheelTimer *timer)
+{
+  return (timer->pprev != NULL);
+}
+
+/**
+ * @internal
+ * Timer wheel expiry function of the timers set up by ICall_setTimer().
+ *
+ * @param timer  timer embedded in an @ref ICall_ScheduleEntry
+ */
+static void ICall_wheelTimerFunc(ICall_WheelTimer *timer)
+{
+  ICall_ScheduleEntry *entry = (ICall_ScheduleEntry *) timer;
+
+  entry->cback(entry->arg);
+}
+#else /* ICALL_TIMER_WHEEL */
+
 /**
  * @internal
  * Clock event handler function.
@@ -1290,6 +2274,7 @@ static Void ICall_clockFunc(UArg arg)
 
   entry->cback(entry->arg);
 }
+#endif /* ICALL_TIMER_WHEEL */
 
 #ifndef ICALL_JT
 /**
@@ -1309,7 +2294,9 @@ static ICall_Errno ICall_primSetTimer(ICall_SetTimerArgs *args)
 
   if (args->timerid == ICALL_INVALID_TIMER_ID)
   {
+#ifndef ICALL_TIMER_WHEEL
     Clock_Params params;
+#endif /* ICALL_TIMER_WHEEL */
 
     /* Create a new timer */
     entry = ICall_heapMalloc(sizeof(ICall_ScheduleEntry));
@@ -1318,6 +2305,9 @@ static ICall_Errno ICall_primSetTimer(ICall_SetTimerArgs *args)
       /* allocation failed */
       return ICALL_ERRNO_NO_RESOURCE;
     }
+#ifdef ICALL_TIMER_WHEEL
+    ICall_wheelConstruct(&entry->timer, ICall_wheelTimerFunc, args->timeout, 0);
+#else /* ICALL_TIMER_WHEEL */
     Clock_Params_init(&params);
     params.startFlag = FALSE;
     params.period = 0;
@@ -1332,6 +2322,7 @@ static ICall_Errno ICall_primSetTimer(ICall_SetTimerArgs *args)
       ICall_heapFree(entry);
       return ICALL_ERRNO_NO_RESOURCE;
     }
+#endif /* ICALL_TIMER_WHEEL */
     entry->cback = args->cback;
     entry->arg = args->arg;
     args->timerid = (ICall_TimerID) entry;
@@ -1345,13 +2336,22 @@ static ICall_Errno ICall_primSetTimer(ICall_SetTimerArgs *args)
     /* Critical section is entered to disable interrupts that might cause call
      * to callback due to race condition */
     key = ICall_enterCriticalSection();
+#ifdef ICALL_TIMER_WHEEL
+    ICall_wheelStop(&entry->timer);
+#else /* ICALL_TIMER_WHEEL */
     Clock_stop(entry->clock);
+#endif /* ICALL_TIMER_WHEEL */
     entry->arg = args->arg;
     ICall_leaveCriticalSection(key);
   }
 
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelSetTimeout(&entry->timer, args->timeout);
+  ICall_wheelStart(&entry->timer);
+#else /* ICALL_TIMER_WHEEL */
   Clock_setTimeout(entry->clock, args->timeout);
   Clock_start(entry->clock);
+#endif /* ICALL_TIMER_WHEEL */
 
   return ICALL_ERRNO_SUCCESS;
 }
@@ -1400,7 +2400,11 @@ static ICall_Errno ICall_primStopTimer(ICall_StopTimerArgs *args)
     return ICALL_ERRNO_INVALID_PARAMETER;
   }
 
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelStop(&entry->timer);
+#else /* ICALL_TIMER_WHEEL */
   Clock_stop(entry->clock);
+#endif /* ICALL_TIMER_WHEEL */
   return ICALL_ERRNO_SUCCESS;
 }
 
@@ -1449,7 +2453,7 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
 {
   Task_Handle taskhandle = Task_self();
   ICall_TaskEntry *taskentry = ICall_searchTask(taskhandle);
-  ICall_MsgQueue prependQueue = NULL;
+  ICall_MsgQueue prependQueue;
 #ifndef ICALL_EVENTS
   uint_fast16_t consumedCount = 0;
 #endif
@@ -1495,6 +2499,9 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
     }
   }
 
+  CYC_TRACE_BEGIN(CYC_TRACE_ICALL_WAIT_MATCH);
+
+  ICALL_MSG_QUEUE_INIT(prependQueue);
   errno = ICALL_ERRNO_TIMEOUT;
   timeoutStamp = Clock_getTicks() + timeout;
   while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
@@ -1560,7 +2567,7 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
 #endif //ICALL_EVENTS
 
   /* Prepend retrieved irrelevant messages */
-  ICall_msgPrepend(&taskentry->queue, prependQueue);
+  ICall_msgPrepend(&taskentry->queue, &prependQueue);
 #ifndef ICALL_EVENTS
   /* Re-increment the consumed semaphores */
   for (; consumedCount > 0; consumedCount--)
@@ -1568,9 +2575,36 @@ static ICall_Errno ICall_primWaitMatch(ICall_WaitMatchArgs *args)
     Semaphore_post(taskentry->syncHandle);
   }
 #endif /* ICALL_EVENTS */
+
+  CYC_TRACE_END(CYC_TRACE_ICALL_WAIT_MATCH);
+
   return errno;
 }
 
+/**
+ * @internal Arms the response slot of the calling thread.
+ *
+ * @param args   arguments corresponding to those of ICall_armMatch()
+ * @return return values corresponding to those of ICall_armMatch()
+ */
+static ICall_Errno ICall_primArmMatch(ICall_ArmMatchArgs *args)
+{
+  return ICall_armMatchImpl(args->matchFn);
+}
+
+/**
+ * @internal Waits for the message routed to the response slot of the
+ * calling thread.
+ *
+ * @param args   arguments corresponding to those of ICall_waitArmedMatch()
+ * @return return values corresponding to those of ICall_waitArmedMatch()
+ */
+static ICall_Errno ICall_primWaitArmedMatch(ICall_WaitArmedMatchArgs *args)
+{
+  return ICall_waitArmedMatchImpl(args->milliseconds, &args->servId,
+                                  &args->dest, &args->msg);
+}
+
 /**
  * @internal
  * Retrieves an entity ID of an entity associated with the calling thread.
@@ -1604,7 +2638,9 @@ static ICall_Errno ICall_primGetEntityId(ICall_GetEntityIdArgs *args)
       /* Not found */
       break;
     }
-    if (ICall_entities[i].task->task == taskhandle)
+    /* The primitive service entity has no task */
+    if (ICall_entities[i].task != NULL &&
+        ICall_entities[i].task->task == taskhandle)
     {
       /* Found */
       args->entity = i;
@@ -2237,6 +3273,27 @@ static const struct _icall_primsvcfunc_map_entry_t
     NULL
   }, /* ICALL_RTOS_EVENT_API */
 #endif /* ICALL_RTOS_EVENT_API */
+
+  {
+#ifdef COVERAGE_TEST
+    ICALL_PRIMITIVE_FUNC_FETCH_SERV_MSG_BATCH,
+#endif /* COVERAGE_TEST */
+    (ICall_PrimSvcFunc) ICall_primFetchServiceMsgBatch
+  },
+
+  {
+#ifdef COVERAGE_TEST
+    ICALL_PRIMITIVE_FUNC_ARM_MATCH,
+#endif /* COVERAGE_TEST */
+    (ICall_PrimSvcFunc) ICall_primArmMatch
+  },
+
+  {
+#ifdef COVERAGE_TEST
+    ICALL_PRIMITIVE_FUNC_WAIT_ARMED_MATCH,
+#endif /* COVERAGE_TEST */
+    (ICall_PrimSvcFunc) ICall_primWaitArmedMatch
+  },
 };
 /**
  * @internal
@@ -2260,6 +3317,7 @@ static void ICall_initPrim(void)
 {
   ICall_entities[0].service = ICALL_SERVICE_CLASS_PRIMITIVE;
   ICall_entities[0].fn = ICall_primService;
+  ICall_mapService(ICALL_SERVICE_CLASS_PRIMITIVE, ICALL_PRIMITIVE_ENTITY_ID);
 
   /* Initialize heap */
   ICall_heapInit();
@@ -2487,6 +3545,109 @@ ICall_fetchServiceMsg(ICall_ServiceEnum *src,
 
 }
 
+/**
+ * Retrieves up to a given number of messages received at the message
+ * queue associated with the calling thread, so that a burst of messages
+ * can be processed with a single wakeup.
+ *
+ * Messages that were not sent by a server are thrown away, as with
+ * ICall_fetchServiceMsg(). The signals posted for all retrieved messages
+ * but the first are consumed, hence the calling thread should only call
+ * this function once per wakeup of ICall_wait().
+ *
+ * @param msgs   array to store the retrieved messages
+ * @param max    number of elements in @p msgs
+ * @param count  pointer to a variable to store the number of messages
+ *               retrieved
+ * @return @ref ICALL_ERRNO_SUCCESS when at least one message was
+ *         retrieved.<br>
+ *         @ref ICALL_ERRNO_NOMSG when there is no queued service message
+ *         at the moment.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+ICall_Errno
+ICall_fetchServiceMsgBatch(ICall_ServiceMsg *msgs,
+                           uint_least8_t max,
+                           uint_least8_t *count)
+{
+  ICall_TaskEntry *taskentry = ICall_searchTask(Task_self());
+
+  *count = 0;
+  if (!taskentry)
+  {
+    return (ICALL_ERRNO_UNKNOWN_THREAD);
+  }
+  *count = ICall_fetchServiceMsgs(taskentry, msgs, max);
+  return ((*count != 0) ? ICALL_ERRNO_SUCCESS : ICALL_ERRNO_NOMSG);
+}
+
+/**
+ * Arms the response slot of the calling thread with a match function.
+ *
+ * Until the slot is collected with ICall_waitArmedMatch(), the first
+ * message sent to the calling thread which matches is stored in the slot
+ * instead of being queued.
+ *
+ * @param matchFn  pointer to a function that would return TRUE when
+ *                 the message matches its condition, or NULL to disarm.
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+ICall_Errno
+ICall_armMatch(ICall_MsgMatchFn matchFn)
+{
+  return (ICall_armMatchImpl(matchFn));
+}
+
+/**
+ * Waits for the message routed to the response slot armed with
+ * ICall_armMatch() and disarms the slot.
+ *
+ * @param milliseconds  timeout period in milliseconds.
+ * @param src    pointer to a variable to store the service id
+ *               of the sender, or NULL.
+ * @param dest   pointer to a variable to store the entity id
+ *               of the destination of the message, or NULL.
+ * @param msg    pointer to a pointer variable to store the
+ *               starting address of the message body.
+ * @return @ref ICALL_ERRNO_SUCCESS when a message was retrieved.<br>
+ *         @ref ICALL_ERRNO_TIMEOUT when designated timeout period
+ *         has passed without a matching message.<br>
+ *         @ref ICALL_ERRNO_INVALID_PARAMETER when the slot was not armed.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered an entity.
+ */
+ICall_Errno
+ICall_waitArmedMatch(uint_least32_t milliseconds,
+                     ICall_ServiceEnum *src,
+                     ICall_EntityID *dest,
+                     void **msg)
+{
+  ICall_ServiceEnum servId;
+  ICall_EntityID fetchDst;
+  ICall_Errno errno;
+
+  errno = ICall_waitArmedMatchImpl(milliseconds, &servId, &fetchDst, msg);
+  if (errno == ICALL_ERRNO_SUCCESS)
+  {
+    if (src != NULL)
+    {
+      *src = servId;
+    }
+    if (dest != NULL)
+    {
+      *dest = fetchDst;
+    }
+  }
+  return (errno);
+}
+
 /**
  * Waits for a signal to the semaphore associated with the calling thread.
  *
@@ -2604,6 +3765,7 @@ ICall_enrollService(ICall_ServiceEnum service,
       ICall_entities[i].service = service;
       ICall_entities[i].task = taskentry;
       ICall_entities[i].fn = fn;
+      ICall_mapService(service, (ICall_EntityID) i);
       *entity = (ICall_EntityID) i;
       *msgSyncHdl = taskentry->syncHandle;
       ICall_leaveCSImpl(key);
@@ -2685,7 +3847,7 @@ ICall_Errno ICall_send(ICall_EntityID src,
   hdr->srcentity = src;
   hdr->dstentity = dest;
   hdr->format = format;
-  ICall_msgEnqueue(&ICall_entities[dest].task->queue, msg);
+  ICall_deliverMsg(ICall_entities[dest].task, msg);
   ICALL_SYNC_HANDLE_POST(ICall_entities[dest].task->syncHandle);
 
   return (ICALL_ERRNO_SUCCESS);
@@ -2988,7 +4150,9 @@ ICall_setTimer(uint_fast32_t ticks,
 
   if (*id == ICALL_INVALID_TIMER_ID)
   {
+#ifndef ICALL_TIMER_WHEEL
     Clock_Params params;
+#endif /* ICALL_TIMER_WHEEL */
 
     /* Create a new timer */
     entry = ICall_heapMalloc(sizeof(ICall_ScheduleEntry));
@@ -2997,6 +4161,9 @@ ICall_setTimer(uint_fast32_t ticks,
       /* allocation failed */
       return (ICALL_ERRNO_NO_RESOURCE);
     }
+#ifdef ICALL_TIMER_WHEEL
+    ICall_wheelConstruct(&entry->timer, ICall_wheelTimerFunc, ticks, 0);
+#else /* ICALL_TIMER_WHEEL */
     Clock_Params_init(&params);
     params.startFlag = FALSE;
     params.period = 0;
@@ -3011,6 +4178,7 @@ ICall_setTimer(uint_fast32_t ticks,
       ICall_heapFree(entry);
       return (ICALL_ERRNO_NO_RESOURCE);
     }
+#endif /* ICALL_TIMER_WHEEL */
     entry->cback = cback;
     entry->arg = arg;
     *id = (ICall_TimerID) entry;
@@ -3024,13 +4192,22 @@ ICall_setTimer(uint_fast32_t ticks,
     /* Critical section is entered to disable interrupts that might cause call
      * to callback due to race condition */
     key = ICall_enterCriticalSection();
+#ifdef ICALL_TIMER_WHEEL
+    ICall_wheelStop(&entry->timer);
+#else /* ICALL_TIMER_WHEEL */
     Clock_stop(entry->clock);
+#endif /* ICALL_TIMER_WHEEL */
     entry->arg = arg;
     ICall_leaveCriticalSection(key);
   }
 
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelSetTimeout(&entry->timer, ticks);
+  ICall_wheelStart(&entry->timer);
+#else /* ICALL_TIMER_WHEEL */
   Clock_setTimeout(entry->clock, ticks);
   Clock_start(entry->clock);
+#endif /* ICALL_TIMER_WHEEL */
 
   return (ICALL_ERRNO_SUCCESS);
 
@@ -3051,7 +4228,11 @@ ICall_stopTimer(ICall_TimerID id)
     return;
   }
 
+#ifdef ICALL_TIMER_WHEEL
+  ICall_wheelStop(&entry->timer);
+#else /* ICALL_TIMER_WHEEL */
   Clock_stop(entry->clock);
+#endif /* ICALL_TIMER_WHEEL */
 }
 
 /**
@@ -3494,7 +4675,7 @@ ICall_waitMatch(uint_least32_t milliseconds,
 {
   Task_Handle taskhandle = Task_self();
   ICall_TaskEntry *taskentry = ICall_searchTask(taskhandle);
-  ICall_MsgQueue prependQueue = NULL;
+  ICall_MsgQueue prependQueue;
 #ifndef ICALL_EVENTS
   uint_fast16_t consumedCount = 0;
 #endif
@@ -3540,6 +4721,9 @@ ICall_waitMatch(uint_least32_t milliseconds,
     }
   }
 
+  CYC_TRACE_BEGIN(CYC_TRACE_ICALL_WAIT_MATCH);
+
+  ICALL_MSG_QUEUE_INIT(prependQueue);
   errno = ICALL_ERRNO_TIMEOUT;
   timeoutStamp = Clock_getTicks() + timeout;
   while (ICALL_SYNC_HANDLE_PEND(taskentry->syncHandle, timeout))
@@ -3615,7 +4799,7 @@ ICall_waitMatch(uint_least32_t milliseconds,
 #endif //ICALL_EVENTS
 
   /* Prepend retrieved irrelevant messages */
-  ICall_msgPrepend(&taskentry->queue, prependQueue);
+  ICall_msgPrepend(&taskentry->queue, &prependQueue);
 #ifndef ICALL_EVENTS
   /* Re-increment the consumed semaphores */
   for (; consumedCount > 0; consumedCount--)
@@ -3623,6 +4807,9 @@ ICall_waitMatch(uint_least32_t milliseconds,
     Semaphore_post(taskentry->syncHandle);
   }
 #endif /* ICALL_EVENTS */
+
+  CYC_TRACE_END(CYC_TRACE_ICALL_WAIT_MATCH);
+
   return (errno);
 }
 
@@ -3662,7 +4849,9 @@ ICall_getEntityId(void)
       /* Not found */
       break;
     }
-    if (ICall_entities[i].task->task == taskhandle)
+    /* The primitive service entity has no task */
+    if (ICall_entities[i].task != NULL &&
+        ICall_entities[i].task->task == taskhandle)
     {
       /* Found */
       id = i;
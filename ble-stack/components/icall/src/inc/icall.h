@@ -396,6 +396,15 @@ extern "C" {
 #define ICALL_PRIMITIVE_FUNC_POST_EVENT                   44
 #endif  /* ICALL_EVENTS */
 
+/** @internal Primitive service "fetch service message batch" function id */
+#define ICALL_PRIMITIVE_FUNC_FETCH_SERV_MSG_BATCH         45
+
+/** @internal Primitive service "arm match" function id */
+#define ICALL_PRIMITIVE_FUNC_ARM_MATCH                    46
+
+/** @internal Primitive service "wait armed match" function id */
+#define ICALL_PRIMITIVE_FUNC_WAIT_ARMED_MATCH             47
+
 /**
  * Messaging service function id for translating ICall_entityID
  * to locally understandable id.
@@ -455,6 +464,32 @@ typedef bool (*ICall_MsgMatchFn)(ICall_ServiceEnum src, ICall_EntityID dest,
  */
 typedef void (*ICall_TimerCback)(void *arg);
 
+#ifdef ICALL_TIMER_WHEEL
+struct _icall_wheel_timer_t;
+
+/**
+ * Prototype of a timer wheel expiry function
+ * @param timer  the timer that expired. The timer record may be embedded
+ *               in a larger structure to carry the callback argument.
+ */
+typedef void (*ICall_WheelFunc)(struct _icall_wheel_timer_t *timer);
+
+/**
+ * Timer record of the timer wheel.
+ * The record is owned by the caller and must be set up with
+ * ICall_wheelConstruct(). Its fields are private to the timer wheel.
+ */
+typedef struct _icall_wheel_timer_t
+{
+  struct _icall_wheel_timer_t *next;   /* next timer in the same slot */
+  struct _icall_wheel_timer_t **pprev; /* link to this timer, NULL if idle */
+  ICall_WheelFunc fn;                  /* expiry function */
+  uint_least32_t expiry;               /* expiry time in wheel ticks */
+  uint_least32_t timeout;              /* initial timeout in wheel ticks */
+  uint_least32_t period;               /* period in wheel ticks, 0 if one-shot */
+} ICall_WheelTimer;
+#endif /* ICALL_TIMER_WHEEL */
+
 /** Common service function arguments */
 typedef struct _icall_func_args_hdr_t
 {
@@ -536,6 +571,30 @@ typedef struct _icall_fetch_msg_args_t
   void *msg;
 } ICall_FetchMsgArgs;
 
+/** Message retrieved by ICall_fetchServiceMsgBatch() */
+typedef struct _icall_service_msg_t
+{
+  /** service id of the sender */
+  ICall_ServiceEnum src;
+  /** entity id of the destination */
+  ICall_EntityID dest;
+  /** starting address of the message body */
+  void *msg;
+} ICall_ServiceMsg;
+
+/** ICall_fetchServiceMsgBatch() arguments */
+typedef struct _icall_fetch_msg_batch_args_t
+{
+  /** common arguments */
+  ICall_FuncArgsHdr hdr;
+  /** array to store the retrieved messages */
+  ICall_ServiceMsg *msgs;
+  /** number of elements in msgs */
+  uint_least8_t max;
+  /** field to store the number of messages retrieved */
+  uint_least8_t count;
+} ICall_FetchMsgBatchArgs;
+
 /** ICall_wait() arguments */
 typedef struct _icall_wait_args_t
 {
@@ -859,6 +918,30 @@ typedef struct _icall_wait_match_args_t
   void *msg;
 } ICall_WaitMatchArgs;
 
+/** ICall_armMatch() arguments */
+typedef struct _icall_arm_match_args_t
+{
+  /** common arguments */
+  ICall_FuncArgsHdr hdr;
+  /** match function, or NULL to disarm */
+  ICall_MsgMatchFn matchFn;
+} ICall_ArmMatchArgs;
+
+/** ICall_waitArmedMatch() arguments */
+typedef struct _icall_wait_armed_match_args_t
+{
+  /** common arguments */
+  ICall_FuncArgsHdr hdr;
+  /** timeout period in milliseconds */
+  uint_least32_t milliseconds;
+  /** field to store the service id of the sender */
+  ICall_ServiceEnum servId;
+  /** field to store the entity id of the destination of the message */
+  ICall_EntityID dest;
+  /** field to store the starting address of the message body */
+  void *msg;
+} ICall_WaitArmedMatchArgs;
+
 /** ICall_getEntityId() arguments */
 typedef struct _icall_get_entity_id_args_t
 {
@@ -902,6 +985,32 @@ extern ICall_EnterCS ICall_enterCriticalSection;
 /** Leave critical section function pointer of the current image */
 extern ICall_LeaveCS ICall_leaveCriticalSection;
 
+#ifdef CS_PROF
+/**
+ * Enters a critical section timed by the critical section profiler
+ * (cs_prof.h) and charged to the given call site.
+ *
+ * @param file  file of the call site
+ * @param line  line of the call site
+ * @return critical section state before entry.
+ */
+extern ICall_CSState ICall_enterCSProf(const char *file,
+                                       uint_least16_t line);
+
+/**
+ * Leaves a critical section entered with ICall_enterCSProf().
+ *
+ * @param key  critical section state returned from ICall_enterCSProf()
+ */
+extern void ICall_leaveCSProf(ICall_CSState key);
+
+/* Critical sections of the current image are charged to their caller */
+#define ICall_enterCriticalSection()                        \
+  ICall_enterCSProf(__FILE__, __LINE__)
+#define ICall_leaveCriticalSection(key)                     \
+  ICall_leaveCSProf(key)
+#endif /* CS_PROF */
+
 /** Data type of the first argument passed to the entry point
  *  of an image which contains a remote task. */
 typedef struct _icall_remote_task_arg_t
@@ -1068,6 +1177,106 @@ extern void ICall_createRemoteTasks(void);
  */
 extern ICall_EntityID ICall_searchServiceEntity(ICall_ServiceEnum service);
 
+#ifdef HEAPMGR_TRACE
+/** Heap trace owner of allocations made outside of a registered task */
+#define ICALL_HEAP_OWNER_OTHER      0
+
+/** Heap trace owner of GATT messages allocated with GATT_bm_alloc() */
+#define ICALL_HEAP_OWNER_BM_GATT    1
+
+/** Heap trace owner of L2CAP messages allocated with L2CAP_bm_alloc() */
+#define ICALL_HEAP_OWNER_BM_L2CAP   2
+
+/** Heap trace owner of the n-th task registered with ICall */
+#define ICALL_HEAP_OWNER_TASK(_n)   (3 + (_n))
+
+/**
+ * Retrieves the owner that heap allocations of the calling thread are
+ * charged to.
+ *
+ * @return owner index; @ref ICALL_HEAP_OWNER_OTHER outside of a task
+ *         registered with ICall.
+ */
+extern uint_least8_t ICall_heapOwner(void);
+
+/**
+ * Changes the owner that subsequent heap allocations of the calling task
+ * are charged to, e.g. to attribute buffers allocated on behalf of
+ * a protocol layer.
+ *
+ * @param owner  new owner index
+ * @return previous owner index, to be restored by the caller.
+ */
+extern uint_least8_t ICall_heapSetOwner(uint_least8_t owner);
+
+/**
+ * Writes the binary heap trace report described in heapmgr.h.
+ *
+ * @param buf  buffer to write the report to
+ * @param len  size of the buffer in bytes
+ * @return number of bytes written; 0 if the buffer is too small.
+ */
+extern uint16_t ICall_heapTraceReport(uint8_t *buf, uint16_t len);
+#endif /* HEAPMGR_TRACE */
+
+#ifdef ICALL_TIMER_WHEEL
+/**
+ * Sets up a timer wheel record. The timer is not started.
+ *
+ * All timers of the wheel are driven by a single RTOS clock, armed for
+ * the earliest expiry only. Starting, stopping and restarting a timer
+ * take constant time regardless of the number of active timers.
+ * Expiry functions are called in the same context as RTOS clock functions.
+ *
+ * @param timer    timer record
+ * @param fn       expiry function
+ * @param timeout  initial timeout in RTOS clock ticks
+ * @param period   period in RTOS clock ticks, or 0 for a one-shot timer
+ */
+extern void ICall_wheelConstruct(ICall_WheelTimer *timer, ICall_WheelFunc fn,
+                                 uint_fast32_t timeout, uint_fast32_t period);
+
+/**
+ * Sets the timeout used by the next ICall_wheelStart() of a timer.
+ *
+ * @param timer    timer record
+ * @param timeout  timeout in RTOS clock ticks
+ */
+extern void ICall_wheelSetTimeout(ICall_WheelTimer *timer,
+                                  uint_fast32_t timeout);
+
+/**
+ * Sets the period of a timer.
+ *
+ * @param timer   timer record
+ * @param period  period in RTOS clock ticks, or 0 for a one-shot timer
+ */
+extern void ICall_wheelSetPeriod(ICall_WheelTimer *timer,
+                                 uint_fast32_t period);
+
+/**
+ * Starts or restarts a timer with its current timeout.
+ *
+ * @param timer  timer record
+ */
+extern void ICall_wheelStart(ICall_WheelTimer *timer);
+
+/**
+ * Stops a timer. Stopping an idle timer has no effect.
+ *
+ * @param timer  timer record
+ */
+extern void ICall_wheelStop(ICall_WheelTimer *timer);
+
+/**
+ * Checks whether a timer is running.
+ *
+ * @param timer  timer record
+ * @return true if the timer is running.
+ */
+extern bool ICall_wheelIsActive(ICall_WheelTimer *timer);
+#endif /* ICALL_TIMER_WHEEL */
+
 #ifdef ICALL_SLIM
  /*******************************************************************************
  * @fn          icall_directAPI
@@ -1199,6 +1408,34 @@ ICall_fetchServiceMsg(ICall_ServiceEnum *src,
                       ICall_EntityID *dest,
                       void **msg);
 
+/**
+ * Retrieves up to a given number of messages received at the message
+ * queue associated with the calling thread, so that a burst of messages
+ * can be processed with a single wakeup.
+ *
+ * Messages that were not sent by a server are thrown away, as with
+ * ICall_fetchServiceMsg(). The signals posted for all retrieved messages
+ * but the first are consumed, hence the calling thread should only call
+ * this function once per wakeup of ICall_wait().
+ *
+ * @param msgs   array to store the retrieved messages
+ * @param max    number of elements in @p msgs
+ * @param count  pointer to a variable to store the number of messages
+ *               retrieved
+ * @return @ref ICALL_ERRNO_SUCCESS when at least one message was
+ *         retrieved.<br>
+ *         @ref ICALL_ERRNO_NOMSG when there is no queued service message
+ *         at the moment.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+ICall_Errno
+ICall_fetchServiceMsgBatch(ICall_ServiceMsg *msgs,
+                           uint_least8_t max,
+                           uint_least8_t *count);
+
 /**
  * Waits for a signal to the semaphore associated with the calling thread.
  *
@@ -1704,6 +1941,61 @@ ICall_waitMatch(uint_least32_t milliseconds,
                 ICall_EntityID *dest,
                 void **msg);
 
+/**
+ * Arms the response slot of the calling thread with a match function.
+ *
+ * Until the slot is collected with ICall_waitArmedMatch(), the first
+ * message sent to the calling thread which matches is stored in the slot
+ * instead of being queued, so that waiting for it does not involve the
+ * messages already queued. The match function is called from the context
+ * of the sender, once per message, and hence must be reentrant.
+ *
+ * Arm the slot before sending the request whose response is expected,
+ * since the response may be sent before the request call returns.
+ * Passing NULL disarms the slot, e.g. when the request could not be sent.
+ *
+ * @param matchFn  pointer to a function that would return TRUE when
+ *                 the message matches its condition, or NULL.
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+ICall_Errno
+ICall_armMatch(ICall_MsgMatchFn matchFn);
+
+/**
+ * Waits for the message routed to the response slot armed with
+ * ICall_armMatch() and disarms the slot.
+ *
+ * @param milliseconds  timeout period in milliseconds.
+ * @param src    pointer to a variable to store the service id
+ *               of the registered server which sent the retrieved
+ *               message, or NULL if not interested in storing service id.
+ * @param dest   pointer to a variable to store the entity id
+ *               of the destination of the message,
+ *               of NULL if not interested in storing the destination entity id.
+ * @param msg    pointer to a pointer variable to store the
+ *               starting address of the message body being
+ *               retrieved. The pointer must not be NULL.
+ * @return @ref ICALL_ERRNO_SUCCESS when the operation was successful
+ *         and a message was retrieved.<br>
+ *         @ref ICALL_ERRNO_TIMEOUT when designated timeout period
+ *         has passed since the call of the function without
+ *         a matching message being received.<br>
+ *         @ref ICALL_ERRNO_INVALID_PARAMETER when the slot was not armed.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+ICall_Errno
+ICall_waitArmedMatch(uint_least32_t milliseconds,
+                     ICall_ServiceEnum *src,
+                     ICall_EntityID *dest,
+                     void **msg);
+
 /**
  * Retrieves an entity ID of (arbitrary) one of the entities registered
  * from the calling thread.
@@ -1906,6 +2198,45 @@ ICall_fetchServiceMsg(ICall_ServiceEnum *src,
   return errno;
 }
 
+/**
+ * Retrieves up to a given number of messages received at the message
+ * queue associated with the calling thread, so that a burst of messages
+ * can be processed with a single wakeup.
+ *
+ * Messages that were not sent by a server are thrown away, as with
+ * ICall_fetchServiceMsg(). The signals posted for all retrieved messages
+ * but the first are consumed, hence the calling thread should only call
+ * this function once per wakeup of ICall_wait().
+ *
+ * @param msgs   array to store the retrieved messages
+ * @param max    number of elements in @p msgs
+ * @param count  pointer to a variable to store the number of messages
+ *               retrieved
+ * @return @ref ICALL_ERRNO_SUCCESS when at least one message was
+ *         retrieved.<br>
+ *         @ref ICALL_ERRNO_NOMSG when there is no queued service message
+ *         at the moment.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+static ICall_Errno
+ICall_fetchServiceMsgBatch(ICall_ServiceMsg *msgs,
+                           uint_least8_t max,
+                           uint_least8_t *count)
+{
+  ICall_FetchMsgBatchArgs args;
+  ICall_Errno errno;
+  args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+  args.hdr.func = ICALL_PRIMITIVE_FUNC_FETCH_SERV_MSG_BATCH;
+  args.msgs = msgs;
+  args.max = max;
+  errno = ICall_dispatcher(&args.hdr);
+  *count = args.count;
+  return errno;
+}
+
 /**
  * Waits for a signal to the semaphore associated with the calling thread.
  *
@@ -2770,6 +3101,86 @@ ICall_waitMatch(uint_least32_t milliseconds,
   return errno;
 }
 
+/**
+ * Arms the response slot of the calling thread with a match function.
+ *
+ * Until the slot is collected with ICall_waitArmedMatch(), the first
+ * message sent to the calling thread which matches is stored in the slot
+ * instead of being queued, so that waiting for it does not involve the
+ * messages already queued. The match function is called from the context
+ * of the sender, once per message, and hence must be reentrant.
+ *
+ * Arm the slot before sending the request whose response is expected,
+ * since the response may be sent before the request call returns.
+ * Passing NULL disarms the slot, e.g. when the request could not be sent.
+ *
+ * @param matchFn  pointer to a function that would return TRUE when
+ *                 the message matches its condition, or NULL.
+ * @return @ref ICALL_ERRNO_SUCCESS when successful.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+static ICall_Errno
+ICall_armMatch(ICall_MsgMatchFn matchFn)
+{
+  ICall_ArmMatchArgs args;
+  args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+  args.hdr.func = ICALL_PRIMITIVE_FUNC_ARM_MATCH;
+  args.matchFn = matchFn;
+  return ICall_dispatcher(&args.hdr);
+}
+
+/**
+ * Waits for the message routed to the response slot armed with
+ * ICall_armMatch() and disarms the slot.
+ *
+ * @param milliseconds  timeout period in milliseconds.
+ * @param src    pointer to a variable to store the service id
+ *               of the registered server which sent the retrieved
+ *               message, or NULL if not interested in storing service id.
+ * @param dest   pointer to a variable to store the entity id
+ *               of the destination of the message,
+ *               of NULL if not interested in storing the destination entity id.
+ * @param msg    pointer to a pointer variable to store the
+ *               starting address of the message body being
+ *               retrieved. The pointer must not be NULL.
+ * @return @ref ICALL_ERRNO_SUCCESS when the operation was successful
+ *         and a message was retrieved.<br>
+ *         @ref ICALL_ERRNO_TIMEOUT when designated timeout period
+ *         has passed since the call of the function without
+ *         a matching message being received.<br>
+ *         @ref ICALL_ERRNO_INVALID_PARAMETER when the slot was not armed.<br>
+ *         @ref ICALL_ERRNO_UNKNOWN_THREAD when this function is
+ *         called from a thread which has not registered
+ *         an entity, either through ICall_enrollService()
+ *         or through ICall_registerApp().
+ */
+static ICall_Errno
+ICall_waitArmedMatch(uint_least32_t milliseconds,
+                     ICall_ServiceEnum *src,
+                     ICall_EntityID *dest,
+                     void **msg)
+{
+  ICall_WaitArmedMatchArgs args;
+  ICall_Errno errno;
+  args.hdr.service = ICALL_SERVICE_CLASS_PRIMITIVE;
+  args.hdr.func = ICALL_PRIMITIVE_FUNC_WAIT_ARMED_MATCH;
+  args.milliseconds = milliseconds;
+  errno = ICall_dispatcher(&args.hdr);
+  if (src != NULL)
+  {
+    *src = args.servId;
+  }
+  if (dest != NULL)
+  {
+    *dest = args.dest;
+  }
+  *msg = args.msg;
+  return errno;
+}
+
 /**
  * Retrieves an entity ID of (arbitrary) one of the entities registered
  * from the calling thread.
@@ -150,6 +150,55 @@ extern uint8 osal_snv_ext_write( osalSnvId_t id, osalSnvLen_t len, void *pBuf);
  */
 extern uint8 osal_snv_compact( uint8 threshold );
 
+#ifdef OSAL_SNV_LOG
+/*********************************************************************
+ * @fn      osal_snv_batch_begin
+ *
+ * @brief   Start staging NV writes.  Items written with osal_snv_write()
+ *          until osal_snv_batch_commit() are programmed as one entry.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS, or FAILURE if a batch is already open.
+ */
+extern uint8 osal_snv_batch_begin( void );
+
+/*********************************************************************
+ * @fn      osal_snv_batch_commit
+ *
+ * @brief   Write the staged items.  Either all of them are updated or,
+ *          after a reset or failure, none.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed.
+ */
+extern uint8 osal_snv_batch_commit( void );
+
+/*********************************************************************
+ * @fn      osal_snv_batch_abort
+ *
+ * @brief   Drop the staged items.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+extern void osal_snv_batch_abort( void );
+
+/*********************************************************************
+ * @fn      osal_snv_idle
+ *
+ * @brief   Erase released pages and compact ahead of time.  Call when
+ *          the task owning NV is idle.
+ *
+ * @param   none
+ *
+ * @return  TRUE if work was done, FALSE otherwise.
+ */
+extern uint8 osal_snv_idle( void );
+#endif // OSAL_SNV_LOG
+
 /*********************************************************************
 *********************************************************************/
 
@@ -0,0 +1,1011 @@
+/******************************************************************************
+
+ @file  osal_snv_log.c
+
+ @brief Log-structured, wear-leveled implementation of the OSAL Simple NV
+        API (osal_snv.h) for CC26xx internal flash.
+
+ Group: WCS, LPC, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+ 
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*********************************************************************
+ * Each flash page of the log starts with a page header holding a
+ * sequence number; the page with the highest number is the head where
+ * entries are appended.  An entry holds one or more items (one for
+ * osal_snv_write(), all staged items for osal_snv_batch_commit()) and is
+ * only valid once its commit word has been programmed, so a batch is
+ * applied completely or not at all.
+ *
+ * A RAM index maps each item Id to its latest copy, so reads do not scan
+ * flash.  One page of the ring is always kept spare: when the head fills
+ * up, the spare becomes the new head and the live items of the oldest page
+ * are moved into it.  The oldest page is then erased by osal_snv_idle(),
+ * which also compacts ahead of time when the head is mostly dead data.
+ *
+ * This module is not reentrant; all calls must come from the same task.
+ */
+
+#ifdef OSAL_SNV_LOG
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stddef.h>
+#include <string.h>
+
+#include <driverlib/flash.h>
+#include <driverlib/vims.h>
+
+#include "hal_types.h"
+#include "comdef.h"
+#include "osal_snv.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Flash area used by the log. It has no default: it must be a free area
+// outside of both images, reserved in the linker command files.
+#ifndef OSAL_SNV_LOG_BASE
+#error "OSAL_SNV_LOG_BASE must be set to the flash area of the SNV log"
+#endif
+
+#ifndef OSAL_SNV_LOG_PAGE_SIZE
+#define OSAL_SNV_LOG_PAGE_SIZE        0x1000
+#endif
+
+// Number of pages in the log ring, one of them is always spare
+#ifndef OSAL_SNV_LOG_NUM_PAGES
+#define OSAL_SNV_LOG_NUM_PAGES        2
+#endif
+
+// Highest item Id (BLE_NVID_CUST_END), sizes the RAM index
+#ifndef OSAL_SNV_LOG_MAX_ID
+#define OSAL_SNV_LOG_MAX_ID           0x8F
+#endif
+
+// Staging buffer for batch writes, in bytes. The records of one bond
+// (bond record, two LTKs, IRK, CSRK, sign counter and a table of
+// GAP_CHAR_CFG_MAX = 4 characteristic configurations) stage 144 bytes.
+#ifndef OSAL_SNV_LOG_BATCH_SIZE
+#define OSAL_SNV_LOG_BATCH_SIZE       160
+#endif
+
+// Head page usage, in percent, from which osal_snv_idle() compacts
+#ifndef OSAL_SNV_LOG_IDLE_THRESHOLD
+#define OSAL_SNV_LOG_IDLE_THRESHOLD   75
+#endif
+
+#if (OSAL_SNV_LOG_NUM_PAGES < 2) || (OSAL_SNV_LOG_NUM_PAGES > 16)
+#error "OSAL_SNV_LOG_NUM_PAGES must be between 2 and 16"
+#endif
+
+#if ((OSAL_SNV_LOG_NUM_PAGES * OSAL_SNV_LOG_PAGE_SIZE) > 0x10000)
+#error "The SNV log area is limited to 64 KB"
+#endif
+
+#define SNV_PAGE_MAGIC                0x4C564E53  // "SNVL"
+#define SNV_ENTRY_COMMIT              0x54494D43  // "CMIT"
+#define SNV_ERASED_16                 0xFFFF
+#define SNV_ERASED_32                 0xFFFFFFFF
+
+#define SNV_PAGE_HDR_LEN              sizeof(snvPageHdr_t)
+#define SNV_ENTRY_HDR_LEN             sizeof(snvEntryHdr_t)
+#define SNV_ITEM_HDR_LEN              sizeof(snvItemHdr_t)
+
+// The length fields of an entry header are programmed before its items,
+// the status after them
+#define SNV_ENTRY_STATUS_OFS          offsetof(snvEntryHdr_t, status)
+
+// Size of the RAM buffer used to move items between pages
+#define SNV_COPY_CHUNK                32
+
+/*********************************************************************
+ * MACROS
+ */
+
+#define SNV_ALIGN(len)                (((len) + 3) & ~3)
+
+// Offsets are relative to OSAL_SNV_LOG_BASE
+#define SNV_PAGE_OFFSET(page)         ((uint32)(page) * OSAL_SNV_LOG_PAGE_SIZE)
+#define SNV_ADDR(offset)              (OSAL_SNV_LOG_BASE + (uint32)(offset))
+#define SNV_PTR(offset)               ((const uint8 *)(uintptr_t)SNV_ADDR(offset))
+#define SNV_PAGE_OF(offset)           ((offset) / OSAL_SNV_LOG_PAGE_SIZE)
+
+#define SNV_NEXT_PAGE(page)           (((page) + 1) % OSAL_SNV_LOG_NUM_PAGES)
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint32 magic;     // SNV_PAGE_MAGIC
+  uint32 seq;       // Sequence number, increases with each new head page
+} snvPageHdr_t;
+
+typedef struct
+{
+  uint16 len;       // Length of the items following the header
+  uint16 lenInv;    // ~len, detects a torn header
+  uint32 status;    // SNV_ENTRY_COMMIT once all items are programmed
+} snvEntryHdr_t;
+
+typedef struct
+{
+  uint16 id;        // Item Id
+  uint16 len;       // Item length, the data is padded to a word
+} snvItemHdr_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Offset of the latest copy of each item, 0 if the item was never written
+static uint16 snvIndex[OSAL_SNV_LOG_MAX_ID + 1];
+
+// Sequence number of each page, 0 for spare pages
+static uint32 snvPageSeq[OSAL_SNV_LOG_NUM_PAGES];
+
+// Spare pages that still have to be erased
+static uint16 snvEraseMask = 0;
+
+// Head page and its write offset
+static uint8  snvHead = 0;
+static uint16 snvOffset = OSAL_SNV_LOG_PAGE_SIZE;
+
+// Batch write staging
+static uint8  snvBatchActive = FALSE;
+static uint8  snvBatchFailed = FALSE;
+static uint16 snvBatchLen = 0;
+static uint32 snvBatchBuf[OSAL_SNV_LOG_BATCH_SIZE / sizeof(uint32)];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8  snvProgram(uint16 offset, const void *pBuf, uint16 len);
+static uint8  snvErase(uint8 page);
+static uint8  snvActivate(uint8 page, uint32 seq);
+static uint16 snvScanPage(uint8 page);
+static void   snvApplyEntry(uint16 offset);
+static uint16 snvLiveSize(uint8 page);
+static uint8  snvRelocate(uint8 page);
+static uint8  snvRotate(void);
+static uint8  snvAppend(const void *pPart1, uint16 len1,
+                        const void *pPart2, uint16 len2);
+static const snvItemHdr_t *snvBatchFind(osalSnvId_t id);
+
+/*********************************************************************
+ * @fn      snvProgram
+ *
+ * @brief   Program data into the log area.
+ *
+ * @param   offset - offset in the log area
+ * @param   pBuf   - data to program, must not be in flash
+ * @param   len    - length of the data
+ *
+ * @return  SUCCESS or NV_OPER_FAILED
+ */
+static uint8 snvProgram(uint16 offset, const void *pBuf, uint16 len)
+{
+  uint32 mode;
+  uint32 status;
+
+  if (len == 0)
+  {
+    return SUCCESS;
+  }
+
+  // The flash cache has to be off while flash is programmed
+  mode = VIMSModeGet(VIMS_BASE);
+  VIMSModeSet(VIMS_BASE, VIMS_MODE_DISABLED);
+  while (VIMSModeGet(VIMS_BASE) != VIMS_MODE_DISABLED);
+
+  status = FlashProgram((uint8 *)pBuf, SNV_ADDR(offset), len);
+
+  if (mode != VIMS_MODE_DISABLED)
+  {
+    VIMSModeSet(VIMS_BASE, VIMS_MODE_ENABLED);
+  }
+
+  return (status == FAPI_STATUS_SUCCESS) ? SUCCESS : NV_OPER_FAILED;
+}
+
+/*********************************************************************
+ * @fn      snvErase
+ *
+ * @brief   Erase a page of the log area.
+ *
+ * @param   page - page index
+ *
+ * @return  SUCCESS or NV_OPER_FAILED
+ */
+static uint8 snvErase(uint8 page)
+{
+  uint32 mode;
+  uint32 status;
+
+  mode = VIMSModeGet(VIMS_BASE);
+  VIMSModeSet(VIMS_BASE, VIMS_MODE_DISABLED);
+  while (VIMSModeGet(VIMS_BASE) != VIMS_MODE_DISABLED);
+
+  status = FlashSectorErase(SNV_ADDR(SNV_PAGE_OFFSET(page)));
+
+  if (mode != VIMS_MODE_DISABLED)
+  {
+    VIMSModeSet(VIMS_BASE, VIMS_MODE_ENABLED);
+  }
+
+  if (status != FAPI_STATUS_SUCCESS)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  snvEraseMask &= ~(1 << page);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      snvActivate
+ *
+ * @brief   Make a spare page the head page.
+ *
+ * @param   page - page index
+ * @param   seq  - sequence number of the new head
+ *
+ * @return  SUCCESS or NV_OPER_FAILED
+ */
+static uint8 snvActivate(uint8 page, uint32 seq)
+{
+  snvPageHdr_t hdr;
+
+  if (snvEraseMask & (1 << page))
+  {
+    if (snvErase(page) != SUCCESS)
+    {
+      return NV_OPER_FAILED;
+    }
+  }
+
+  hdr.magic = SNV_PAGE_MAGIC;
+  hdr.seq = seq;
+
+  if (snvProgram(SNV_PAGE_OFFSET(page), &hdr, SNV_PAGE_HDR_LEN) != SUCCESS)
+  {
+    // Try another time after an erase
+    snvEraseMask |= (1 << page);
+
+    return NV_OPER_FAILED;
+  }
+
+  snvPageSeq[page] = seq;
+  snvHead = page;
+  snvOffset = SNV_PAGE_HDR_LEN;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      snvApplyEntry
+ *
+ * @brief   Point the index to the items of a committed entry.
+ *
+ * @param   offset - offset of the entry header in the log area
+ *
+ * @return  none
+ */
+static void snvApplyEntry(uint16 offset)
+{
+  const snvEntryHdr_t *pEntry = (const snvEntryHdr_t *)SNV_PTR(offset);
+  uint16 pos = offset + SNV_ENTRY_HDR_LEN;
+  uint16 end = pos + pEntry->len;
+
+  while ((pos + SNV_ITEM_HDR_LEN) <= end)
+  {
+    const snvItemHdr_t *pItem = (const snvItemHdr_t *)SNV_PTR(pos);
+
+    if (pItem->id <= OSAL_SNV_LOG_MAX_ID)
+    {
+      snvIndex[pItem->id] = pos;
+    }
+
+    pos += SNV_ITEM_HDR_LEN + SNV_ALIGN(pItem->len);
+  }
+}
+
+/*********************************************************************
+ * @fn      snvScanPage
+ *
+ * @brief   Replay the committed entries of a page into the index.
+ *
+ * @param   page - page index
+ *
+ * @return  Offset of the free space in the page, OSAL_SNV_LOG_PAGE_SIZE
+ *          if the page cannot take more entries.
+ */
+static uint16 snvScanPage(uint8 page)
+{
+  uint16 off = SNV_PAGE_HDR_LEN;
+
+  while ((off + SNV_ENTRY_HDR_LEN) <= OSAL_SNV_LOG_PAGE_SIZE)
+  {
+    const snvEntryHdr_t *pEntry =
+      (const snvEntryHdr_t *)SNV_PTR(SNV_PAGE_OFFSET(page) + off);
+    uint16 size = SNV_ENTRY_HDR_LEN + SNV_ALIGN(pEntry->len);
+
+    if ((pEntry->len == SNV_ERASED_16) && (pEntry->lenInv == SNV_ERASED_16))
+    {
+      // Free space
+      break;
+    }
+
+    if (((uint16)(pEntry->len ^ pEntry->lenInv) != 0xFFFF) ||
+        ((off + size) > OSAL_SNV_LOG_PAGE_SIZE))
+    {
+      // Torn header, the rest of the page cannot be trusted
+      return OSAL_SNV_LOG_PAGE_SIZE;
+    }
+
+    // Entries interrupted before their commit are skipped
+    if (pEntry->status == SNV_ENTRY_COMMIT)
+    {
+      snvApplyEntry(SNV_PAGE_OFFSET(page) + off);
+    }
+
+    off += size;
+  }
+
+  return off;
+}
+
+/*********************************************************************
+ * @fn      snvLiveSize
+ *
+ * @brief   Size of the items in a page that are still current.
+ *
+ * @param   page - page index
+ *
+ * @return  Size in bytes, including item headers and padding
+ */
+static uint16 snvLiveSize(uint8 page)
+{
+  uint16 size = 0;
+  uint16 id;
+
+  for (id = 0; id <= OSAL_SNV_LOG_MAX_ID; id++)
+  {
+    if ((snvIndex[id] != 0) && (SNV_PAGE_OF(snvIndex[id]) == page))
+    {
+      const snvItemHdr_t *pItem = (const snvItemHdr_t *)SNV_PTR(snvIndex[id]);
+
+      size += SNV_ITEM_HDR_LEN + SNV_ALIGN(pItem->len);
+    }
+  }
+
+  return size;
+}
+
+/*********************************************************************
+ * @fn      snvRelocate
+ *
+ * @brief   Copy the current items of a page into one entry in the head
+ *          page.  Afterwards the page holds no current data.
+ *
+ * @param   page - page index
+ *
+ * @return  SUCCESS or NV_OPER_FAILED
+ */
+static uint8 snvRelocate(uint8 page)
+{
+  snvEntryHdr_t hdr;
+  uint16 entry = SNV_PAGE_OFFSET(snvHead) + snvOffset;
+  uint16 pos;
+  uint16 id;
+  uint16 len = snvLiveSize(page);
+
+  if (len == 0)
+  {
+    return SUCCESS;
+  }
+
+  if ((snvOffset + SNV_ENTRY_HDR_LEN + len) > OSAL_SNV_LOG_PAGE_SIZE)
+  {
+    // The current data does not fit in one page
+    return NV_OPER_FAILED;
+  }
+
+  hdr.len = len;
+  hdr.lenInv = ~len;
+
+  // Claim the space first, a torn entry is skipped on the next init
+  snvOffset += SNV_ENTRY_HDR_LEN + len;
+
+  if (snvProgram(entry, &hdr, SNV_ENTRY_STATUS_OFS) != SUCCESS)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  pos = entry + SNV_ENTRY_HDR_LEN;
+
+  for (id = 0; id <= OSAL_SNV_LOG_MAX_ID; id++)
+  {
+    if ((snvIndex[id] != 0) && (SNV_PAGE_OF(snvIndex[id]) == page))
+    {
+      uint32 chunk[SNV_COPY_CHUNK / sizeof(uint32)];
+      uint16 itemLen = ((const snvItemHdr_t *)SNV_PTR(snvIndex[id]))->len;
+      uint16 remain = SNV_ITEM_HDR_LEN + itemLen;
+      uint16 src = snvIndex[id];
+      uint16 dst = pos;
+
+      // Flash cannot be read while it is programmed, bounce through RAM
+      while (remain > 0)
+      {
+        uint16 n = (remain > SNV_COPY_CHUNK) ? SNV_COPY_CHUNK : remain;
+
+        memcpy(chunk, SNV_PTR(src), n);
+        if (snvProgram(dst, chunk, n) != SUCCESS)
+        {
+          return NV_OPER_FAILED;
+        }
+
+        src += n;
+        dst += n;
+        remain -= n;
+      }
+
+      pos += SNV_ITEM_HDR_LEN + SNV_ALIGN(itemLen);
+    }
+  }
+
+  hdr.status = SNV_ENTRY_COMMIT;
+  if (snvProgram(entry + SNV_ENTRY_STATUS_OFS, &hdr.status,
+                 sizeof(hdr.status)) != SUCCESS)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  snvApplyEntry(entry);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      snvRotate
+ *
+ * @brief   Move the head to the spare page.  If that leaves no spare page,
+ *          the current items of the oldest page are moved to the new head
+ *          and the oldest page is queued for erase.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS or NV_OPER_FAILED
+ */
+static uint8 snvRotate(void)
+{
+  uint8 next = SNV_NEXT_PAGE(snvHead);
+  uint8 oldest;
+
+  // Pages are taken in ring order, the page after the head is spare
+  if (snvPageSeq[next] != 0)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  if (snvActivate(next, snvPageSeq[snvHead] + 1) != SUCCESS)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  oldest = SNV_NEXT_PAGE(next);
+
+  if (snvPageSeq[oldest] != 0)
+  {
+    if (snvRelocate(oldest) != SUCCESS)
+    {
+      return NV_OPER_FAILED;
+    }
+
+    snvPageSeq[oldest] = 0;
+    snvEraseMask |= (1 << oldest);
+  }
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      snvAppend
+ *
+ * @brief   Append an entry to the head page and commit it.  The items of
+ *          the entry are the concatenation of two buffers.
+ *
+ * @param   pPart1 - first part of the items
+ * @param   len1   - length of the first part
+ * @param   pPart2 - second part of the items
+ * @param   len2   - length of the second part
+ *
+ * @return  SUCCESS or NV_OPER_FAILED
+ */
+static uint8 snvAppend(const void *pPart1, uint16 len1,
+                       const void *pPart2, uint16 len2)
+{
+  snvEntryHdr_t hdr;
+  uint16 entry;
+  uint16 size = SNV_ENTRY_HDR_LEN + SNV_ALIGN(len1 + len2);
+
+  if ((snvOffset + size) > OSAL_SNV_LOG_PAGE_SIZE)
+  {
+    if ((snvRotate() != SUCCESS) ||
+        ((snvOffset + size) > OSAL_SNV_LOG_PAGE_SIZE))
+    {
+      return NV_OPER_FAILED;
+    }
+  }
+
+  entry = SNV_PAGE_OFFSET(snvHead) + snvOffset;
+
+  hdr.len = len1 + len2;
+  hdr.lenInv = ~hdr.len;
+
+  // Claim the space first, a torn entry is skipped on the next init
+  snvOffset += size;
+
+  if ((snvProgram(entry, &hdr, SNV_ENTRY_STATUS_OFS) != SUCCESS) ||
+      (snvProgram(entry + SNV_ENTRY_HDR_LEN, pPart1, len1) != SUCCESS) ||
+      (snvProgram(entry + SNV_ENTRY_HDR_LEN + len1, pPart2, len2) != SUCCESS))
+  {
+    return NV_OPER_FAILED;
+  }
+
+  // The entry becomes valid with its commit word
+  hdr.status = SNV_ENTRY_COMMIT;
+  if (snvProgram(entry + SNV_ENTRY_STATUS_OFS, &hdr.status,
+                 sizeof(hdr.status)) != SUCCESS)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  snvApplyEntry(entry);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      snvBatchFind
+ *
+ * @brief   Find the latest copy of an item in the batch staging buffer.
+ *
+ * @param   id - item Id
+ *
+ * @return  Pointer to the staged item header, NULL if not staged
+ */
+static const snvItemHdr_t *snvBatchFind(osalSnvId_t id)
+{
+  const uint8 *pBuf = (const uint8 *)snvBatchBuf;
+  const snvItemHdr_t *pFound = NULL;
+  uint16 pos = 0;
+
+  while (pos < snvBatchLen)
+  {
+    const snvItemHdr_t *pItem = (const snvItemHdr_t *)&pBuf[pos];
+
+    if (pItem->id == id)
+    {
+      pFound = pItem;
+    }
+
+    pos += SNV_ITEM_HDR_LEN + SNV_ALIGN(pItem->len);
+  }
+
+  return pFound;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      osal_snv_init
+ *
+ * @brief   Initialize NV service.  Replays the log into the RAM index and
+ *          completes a compaction interrupted by a reset.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if initialization succeeds. FAILURE, otherwise.
+ */
+uint8 osal_snv_init(void)
+{
+  uint32 last = 0;
+  uint8 page;
+  uint8 used = 0;
+
+  memset(snvIndex, 0, sizeof(snvIndex));
+  snvEraseMask = 0;
+  snvBatchActive = FALSE;
+
+  for (page = 0; page < OSAL_SNV_LOG_NUM_PAGES; page++)
+  {
+    const snvPageHdr_t *pHdr =
+      (const snvPageHdr_t *)SNV_PTR(SNV_PAGE_OFFSET(page));
+
+    if ((pHdr->magic == SNV_PAGE_MAGIC) && (pHdr->seq != SNV_ERASED_32) &&
+        (pHdr->seq != 0))
+    {
+      snvPageSeq[page] = pHdr->seq;
+      used++;
+    }
+    else
+    {
+      const uint32 *pWord = (const uint32 *)pHdr;
+      uint16 i;
+
+      snvPageSeq[page] = 0;
+
+      for (i = 0; i < (OSAL_SNV_LOG_PAGE_SIZE / sizeof(uint32)); i++)
+      {
+        if (pWord[i] != SNV_ERASED_32)
+        {
+          snvEraseMask |= (1 << page);
+          break;
+        }
+      }
+    }
+  }
+
+  if (used == 0)
+  {
+    // Blank log
+    return (snvActivate(0, 1) == SUCCESS) ? SUCCESS : FAILURE;
+  }
+
+  // Replay the pages from the oldest, newer copies win
+  while (used--)
+  {
+    uint8 next = 0;
+    uint32 seq = SNV_ERASED_32;
+
+    for (page = 0; page < OSAL_SNV_LOG_NUM_PAGES; page++)
+    {
+      if ((snvPageSeq[page] > last) && (snvPageSeq[page] < seq))
+      {
+        seq = snvPageSeq[page];
+        next = page;
+      }
+    }
+
+    snvHead = next;
+    snvOffset = snvScanPage(next);
+    last = seq;
+  }
+
+  // Release the oldest pages that only hold superseded data
+  page = SNV_NEXT_PAGE(snvHead);
+  while ((page != snvHead) && (snvPageSeq[page] == 0))
+  {
+    page = SNV_NEXT_PAGE(page);
+  }
+
+  while ((page != snvHead) && (snvLiveSize(page) == 0))
+  {
+    snvPageSeq[page] = 0;
+    snvEraseMask |= (1 << page);
+    page = SNV_NEXT_PAGE(page);
+  }
+
+  // A reset during compaction may have left no spare page
+  page = SNV_NEXT_PAGE(snvHead);
+  if (snvPageSeq[page] != 0)
+  {
+    if (snvRelocate(page) != SUCCESS)
+    {
+      return FAILURE;
+    }
+
+    snvPageSeq[page] = 0;
+    snvEraseMask |= (1 << page);
+  }
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_snv_read
+ *
+ * @brief   Read data from NV.
+ *
+ * @param   id   - Valid NV item Id.
+ * @param   len  - Length of data to read.
+ * @param   *pBuf - Data is read into this buffer.
+ *
+ * @return  SUCCESS if successful.
+ *          Otherwise, NV_OPER_FAILED for failure.
+ */
+uint8 osal_snv_read(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+  const snvItemHdr_t *pItem = NULL;
+
+  if (id > OSAL_SNV_LOG_MAX_ID)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  // Items written in an open batch are visible to its owner
+  if (snvBatchActive)
+  {
+    pItem = snvBatchFind(id);
+  }
+
+  if ((pItem == NULL) && (snvIndex[id] != 0))
+  {
+    pItem = (const snvItemHdr_t *)SNV_PTR(snvIndex[id]);
+  }
+
+  if ((pItem == NULL) || (len > pItem->len))
+  {
+    return NV_OPER_FAILED;
+  }
+
+  memcpy(pBuf, pItem + 1, len);
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_snv_write
+ *
+ * @brief   Write a data item to NV.  Within a batch the item is staged
+ *          until osal_snv_batch_commit().
+ *
+ * @param   id   - Valid NV item Id.
+ * @param   len  - Length of data to write.
+ * @param   *pBuf - Data to write.
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed.
+ */
+uint8 osal_snv_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+  snvItemHdr_t item;
+
+  if ((id > OSAL_SNV_LOG_MAX_ID) || (len == 0))
+  {
+    return NV_OPER_FAILED;
+  }
+
+  item.id = id;
+  item.len = len;
+
+  if (snvBatchActive)
+  {
+    uint8 *pStage = (uint8 *)snvBatchBuf + snvBatchLen;
+
+    if ((snvBatchLen + SNV_ITEM_HDR_LEN + SNV_ALIGN(len)) >
+        sizeof(snvBatchBuf))
+    {
+      // The whole batch is dropped on commit
+      snvBatchFailed = TRUE;
+
+      return NV_OPER_FAILED;
+    }
+
+    memcpy(pStage, &item, SNV_ITEM_HDR_LEN);
+    memcpy(pStage + SNV_ITEM_HDR_LEN, pBuf, len);
+    snvBatchLen += SNV_ITEM_HDR_LEN + SNV_ALIGN(len);
+
+    return SUCCESS;
+  }
+
+  return snvAppend(&item, SNV_ITEM_HDR_LEN, pBuf, len);
+}
+
+/*********************************************************************
+ * @fn      osal_snv_ext_write
+ *
+ * @brief   Write a data item to NV.
+ *
+ * @param   id   - Valid NV item Id.
+ * @param   len  - Length of data to write.
+ * @param   *pBuf - Data to write.
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed.
+ */
+uint8 osal_snv_ext_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+  return osal_snv_write(id, len, pBuf);
+}
+
+/*********************************************************************
+ * @fn      osal_snv_compact
+ *
+ * @brief   Compacts NV if its usage has reached a specific threshold.
+ *
+ * @param   threshold - compaction threshold, in percent of the head page
+ *
+ * @return  SUCCESS if successful,
+ *          NV_OPER_FAILED if failed, or
+ *          INVALIDPARAMETER if threshold invalid.
+ */
+uint8 osal_snv_compact(uint8 threshold)
+{
+  if (threshold > 100)
+  {
+    return INVALIDPARAMETER;
+  }
+
+  if (((uint32)snvOffset * 100) >=
+      ((uint32)threshold * OSAL_SNV_LOG_PAGE_SIZE))
+  {
+    return snvRotate();
+  }
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_snv_batch_begin
+ *
+ * @brief   Start staging writes for one atomic flash update.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS, or FAILURE if a batch is already open.
+ */
+uint8 osal_snv_batch_begin(void)
+{
+  if (snvBatchActive)
+  {
+    return FAILURE;
+  }
+
+  snvBatchActive = TRUE;
+  snvBatchFailed = FALSE;
+  snvBatchLen = 0;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      osal_snv_batch_commit
+ *
+ * @brief   Write all items staged since osal_snv_batch_begin() as a single
+ *          log entry.  Either all items are updated or none.
+ *
+ * @param   none
+ *
+ * @return  SUCCESS if successful, NV_OPER_FAILED if failed or if a write
+ *          of the batch did not fit in the staging buffer.
+ */
+uint8 osal_snv_batch_commit(void)
+{
+  if (!snvBatchActive)
+  {
+    return FAILURE;
+  }
+
+  snvBatchActive = FALSE;
+
+  if (snvBatchFailed)
+  {
+    return NV_OPER_FAILED;
+  }
+
+  if (snvBatchLen == 0)
+  {
+    return SUCCESS;
+  }
+
+  return snvAppend(snvBatchBuf, snvBatchLen, NULL, 0);
+}
+
+/*********************************************************************
+ * @fn      osal_snv_batch_abort
+ *
+ * @brief   Drop the items staged since osal_snv_batch_begin().
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_snv_batch_abort(void)
+{
+  snvBatchActive = FALSE;
+}
+
+/*********************************************************************
+ * @fn      osal_snv_idle
+ *
+ * @brief   Do one step of background maintenance: erase a released page,
+ *          or compact early when at least half of the used head page is
+ *          superseded data.  Meant to be called when the owning task has
+ *          nothing else to do, so that writes rarely have to compact.
+ *
+ * @param   none
+ *
+ * @return  TRUE if flash was erased or compacted, FALSE if there was
+ *          nothing to do.
+ */
+uint8 osal_snv_idle(void)
+{
+  uint8 page;
+
+  if (snvBatchActive)
+  {
+    return FALSE;
+  }
+
+  for (page = 0; page < OSAL_SNV_LOG_NUM_PAGES; page++)
+  {
+    if (snvEraseMask & (1 << page))
+    {
+      VOID snvErase(page);
+
+      return TRUE;
+    }
+  }
+
+  if (((uint32)snvOffset * 100) >=
+      ((uint32)OSAL_SNV_LOG_IDLE_THRESHOLD * OSAL_SNV_LOG_PAGE_SIZE))
+  {
+    uint16 live = 0;
+
+    for (page = 0; page < OSAL_SNV_LOG_NUM_PAGES; page++)
+    {
+      if (snvPageSeq[page] != 0)
+      {
+        live += snvLiveSize(page);
+      }
+    }
+
+    if ((SNV_PAGE_HDR_LEN + SNV_ENTRY_HDR_LEN + live) <= (snvOffset / 2))
+    {
+      VOID snvRotate();
+
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*********************************************************************
+*********************************************************************/
+
+#endif // OSAL_SNV_LOG
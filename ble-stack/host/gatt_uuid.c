@@ -60,10 +60,28 @@
  * MACROS
  */
 
+// Slot of a 16-bit UUID in gattUUIDHashTbl
+#define GATT_UUID_HASH_BUCKET( uuid ) \
+  ( (uint8)( ( (uint32)(uuid) * GATT_UUID_HASH_MULT1 ) >> 16 ) & \
+    ( GATT_UUID_HASH_BUCKETS - 1 ) )
+
+#define GATT_UUID_HASH( uuid ) \
+  ( (uint8)( ( ( ( (uint32)(uuid) * GATT_UUID_HASH_MULT2 ) >> 16 ) + \
+               gattUUIDHashDisp[GATT_UUID_HASH_BUCKET( uuid )] ) % \
+             GATT_UUID_HASH_SIZE ) )
+
+// 16-bit part of a 128-bit UUID, bytes 12 and 13 in little-endian order
+#define GATT_UUID128_SHORT( pUUID ) BUILD_UINT16( (pUUID)[12], (pUUID)[13] )
+
 /*********************************************************************
  * CONSTANTS
  */
 
+// Maximum number of registered 128-bit UUIDs
+#ifndef GATT_MAX_NUM_UUID128
+  #define GATT_MAX_NUM_UUID128                 4
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -224,9 +242,50 @@ CONST uint8 reportRefUUID[ATT_BT_UUID_SIZE] =
  * LOCAL VARIABLES
  */
 
-/*********************************************************************
- * LOCAL FUNCTIONS
- */
+// BEGIN GENERATED UUID HASH (tools/uuidhash/uuidhash.py)
+// Do not edit: run tools/uuidhash/uuidhash.py after changing the
+// 16-bit UUIDs known to GATT_FindUUIDRec().
+#define GATT_UUID_HASH_SIZE           21
+#define GATT_UUID_HASH_BUCKETS        8
+#define GATT_UUID_HASH_MULT1          0x9E37
+#define GATT_UUID_HASH_MULT2          0x8BD3
+
+// Displacement of each bucket
+static CONST uint8 gattUUIDHashDisp[GATT_UUID_HASH_BUCKETS] =
+{
+  0, 1, 2, 8, 0, 1, 5, 13
+};
+
+// UUID record of each slot
+static const uint8 * CONST gattUUIDHashTbl[GATT_UUID_HASH_SIZE] =
+{
+  clientCharCfgUUID,     // GATT_CLIENT_CHAR_CFG_UUID
+  servCharCfgUUID,       // GATT_SERV_CHAR_CFG_UUID
+  charFormatUUID,        // GATT_CHAR_FORMAT_UUID
+  charAggFormatUUID,     // GATT_CHAR_AGG_FORMAT_UUID
+  charExtPropsUUID,      // GATT_CHAR_EXT_PROPS_UUID
+  validRangeUUID,        // GATT_VALID_RANGE_UUID
+  primaryServiceUUID,    // GATT_PRIMARY_SERVICE_UUID
+  periConnParamUUID,     // PERI_CONN_PARAM_UUID
+  secondaryServiceUUID,  // GATT_SECONDARY_SERVICE_UUID
+  includeUUID,           // GATT_INCLUDE_UUID
+  characterUUID,         // GATT_CHARACTER_UUID
+  extReportRefUUID,      // GATT_EXT_REPORT_REF_UUID
+  reportRefUUID,         // GATT_REPORT_REF_UUID
+  charUserDescUUID,      // GATT_CHAR_USER_DESC_UUID
+  deviceNameUUID,        // DEVICE_NAME_UUID
+  appearanceUUID,        // APPEARANCE_UUID
+  serviceChangedUUID,    // SERVICE_CHANGED_UUID
+  gapServiceUUID,        // GAP_SERVICE_UUID
+  gattServiceUUID,       // GATT_SERVICE_UUID
+  periPrivacyFlagUUID,   // PERI_PRIVACY_FLAG_UUID
+  reconnectAddrUUID      // RECONNECT_ADDR_UUID
+};
+// END GENERATED UUID HASH
+
+// Registered 128-bit UUID records and their 16-bit parts
+static const uint8 *gattUUID128Tbl[GATT_MAX_NUM_UUID128] = { NULL };
+static uint16 gattUUID128ShortTbl[GATT_MAX_NUM_UUID128];
 
 /*********************************************************************
  * API FUNCTIONS
@@ -250,112 +309,116 @@ const uint8 *GATT_FindUUIDRec( const uint8 *pUUID, uint8 len )
   {
     // 16-bit UUID
     uint16 uuid = BUILD_UINT16( pUUID[0], pUUID[1] );
-    switch ( uuid )
-    {
-      /*** GATT Services ***/
-
-      case GAP_SERVICE_UUID:
-        pRec = gapServiceUUID;
-        break;
-
-      case GATT_SERVICE_UUID:
-        pRec = gattServiceUUID;
-        break;
-
-      /*** GATT Declarations ***/
-
-      case GATT_PRIMARY_SERVICE_UUID:
-        pRec = primaryServiceUUID;
-        break;
-
-      case GATT_SECONDARY_SERVICE_UUID:
-        pRec = secondaryServiceUUID;
-        break;
 
-      case GATT_INCLUDE_UUID:
-        pRec = includeUUID;
-        break;
-
-      case GATT_CHARACTER_UUID:
-        pRec = characterUUID;
-        break;
-
-      /*** GATT Descriptors ***/
-
-      case GATT_CHAR_EXT_PROPS_UUID:
-        pRec = charExtPropsUUID;
-        break;
-
-      case GATT_CHAR_USER_DESC_UUID:
-        pRec = charUserDescUUID;
-        break;
-
-      case GATT_CLIENT_CHAR_CFG_UUID:
-        pRec = clientCharCfgUUID;
-        break;
-
-      case GATT_SERV_CHAR_CFG_UUID:
-        pRec = servCharCfgUUID;
-        break;
-
-      case GATT_CHAR_FORMAT_UUID:
-        pRec = charFormatUUID;
-        break;
+    // Each known UUID has a slot of its own; any other UUID lands on the
+    // record of a different UUID.
+    pRec = gattUUIDHashTbl[GATT_UUID_HASH( uuid )];
+    if ( BUILD_UINT16( pRec[0], pRec[1] ) != uuid )
+    {
+      pRec = NULL;
+    }
+  }
+  else if ( len == ATT_UUID_SIZE )
+  {
+    // 128-bit UUID; vendor UUIDs share a base and differ in their 16-bit
+    // part, which is compared before the full UUID.
+    uint16 uuid = GATT_UUID128_SHORT( pUUID );
+    uint8 i;
 
-      case GATT_CHAR_AGG_FORMAT_UUID:
-        pRec = charAggFormatUUID;
+    for ( i = 0; i < GATT_MAX_NUM_UUID128; i++ )
+    {
+      if ( ( gattUUID128Tbl[i] != NULL )      &&
+           ( gattUUID128ShortTbl[i] == uuid ) &&
+           osal_memcmp( gattUUID128Tbl[i], pUUID, ATT_UUID_SIZE ) )
+      {
+        pRec = gattUUID128Tbl[i];
         break;
+      }
+    }
+  }
 
-      case GATT_VALID_RANGE_UUID:
-        pRec = validRangeUUID;
-        break;
+  return ( pRec );
+}
 
-      case GATT_EXT_REPORT_REF_UUID:
-        pRec = extReportRefUUID;
-        break;
+/*********************************************************************
+ * @fn      GATT_RegisterUUID128
+ *
+ * @brief   Register a 128-bit UUID record, so that GATT_FindUUIDRec()
+ *          finds it.  The record is referenced, not copied.
+ *
+ * @param   pUUID - 128-bit UUID record.  Must stay valid while registered.
+ *
+ * @return  SUCCESS
+ *          INVALIDPARAMETER: pUUID is NULL
+ *          bleAlreadyInRequestedMode: UUID already registered
+ *          bleNoResources: GATT_MAX_NUM_UUID128 UUIDs already registered
+ */
+bStatus_t GATT_RegisterUUID128( const uint8 *pUUID )
+{
+  uint8 i;
+  uint8 freeIdx = GATT_MAX_NUM_UUID128;
 
-      case GATT_REPORT_REF_UUID:
-        pRec = reportRefUUID;
-        break;
+  if ( pUUID == NULL )
+  {
+    return ( INVALIDPARAMETER );
+  }
 
-      /*** GATT Characteristics ***/
+  if ( GATT_FindUUIDRec( pUUID, ATT_UUID_SIZE ) != NULL )
+  {
+    return ( bleAlreadyInRequestedMode );
+  }
 
-      case DEVICE_NAME_UUID:
-        pRec = deviceNameUUID;
-        break;
+  for ( i = 0; i < GATT_MAX_NUM_UUID128; i++ )
+  {
+    if ( gattUUID128Tbl[i] == NULL )
+    {
+      freeIdx = i;
+      break;
+    }
+  }
 
-      case APPEARANCE_UUID:
-        pRec = appearanceUUID;
-        break;
+  if ( freeIdx == GATT_MAX_NUM_UUID128 )
+  {
+    return ( bleNoResources );
+  }
 
-      case RECONNECT_ADDR_UUID:
-        pRec = reconnectAddrUUID;
-        break;
+  gattUUID128ShortTbl[freeIdx] = GATT_UUID128_SHORT( pUUID );
+  gattUUID128Tbl[freeIdx] = pUUID;
 
-      case PERI_PRIVACY_FLAG_UUID:
-        pRec = periPrivacyFlagUUID;
-        break;
+  return ( SUCCESS );
+}
 
-      case PERI_CONN_PARAM_UUID:
-        pRec = periConnParamUUID;
-        break;
+/*********************************************************************
+ * @fn      GATT_DeregisterUUID128
+ *
+ * @brief   Deregister a 128-bit UUID record.
+ *
+ * @param   pUUID - 128-bit UUID.
+ *
+ * @return  SUCCESS
+ *          INVALIDPARAMETER: UUID not registered
+ */
+bStatus_t GATT_DeregisterUUID128( const uint8 *pUUID )
+{
+  const uint8 *pRec = NULL;
+  uint8 i;
 
-      case SERVICE_CHANGED_UUID:
-        pRec = serviceChangedUUID;
-        break;
+  if ( pUUID != NULL )
+  {
+    pRec = GATT_FindUUIDRec( pUUID, ATT_UUID_SIZE );
+  }
 
-      /*** GATT Units ***/
+  for ( i = 0; i < GATT_MAX_NUM_UUID128; i++ )
+  {
+    if ( ( pRec != NULL ) && ( gattUUID128Tbl[i] == pRec ) )
+    {
+      gattUUID128Tbl[i] = NULL;
 
-      default:
-        break;
+      return ( SUCCESS );
     }
   }
-  else if ( len == ATT_UUID_SIZE )
-  {
-    // 128-bit UUID
-  }
 
-  return ( pRec );
+  return ( INVALIDPARAMETER );
 }
 
 /****************************************************************************
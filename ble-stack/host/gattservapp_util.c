@@ -48,12 +48,16 @@
 /*******************************************************************************
  * INCLUDES
  */
+#include <string.h>
+
 #include "bcomdef.h"
 #include "linkdb.h"
 
 #include "gatt.h"
 #include "gattservapp.h"
 
+#include "cyc_trace.h"
+
 /*********************************************************************
  * MACROS
  */
@@ -62,10 +66,34 @@
  * CONSTANTS
  */
 
+// Link Layer data PDU payload used to estimate the number of PDUs a
+// notification takes up, on links whose parameters were not set with
+// GATTServApp_SetLinkParams()
+#ifndef GATTSERVAPP_BATCH_PDU_PAYLOAD
+  #define GATTSERVAPP_BATCH_PDU_PAYLOAD  27
+#endif
+
+// Number of links whose parameters are kept
+#ifndef GATTSERVAPP_MAX_LINKS
+  #define GATTSERVAPP_MAX_LINKS          1
+#endif
+
+// L2CAP header, ATT opcode and attribute handle of a notification
+#define GATTSERVAPP_NOTI_HDR_SIZE        7
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+// Parameters of a link used to size its notifications
+typedef struct
+{
+  uint16 connHandle;
+  uint16 mtu;        // ATT MTU, 0 if not set
+  uint16 payloadLen; // Longest notification value to send, 0 if not set
+  uint16 txOctets;   // Maximum LL payload sent
+} gattServAppLink_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -82,6 +110,8 @@
  * LOCAL VARIABLES
  */
 
+static gattServAppLink_t gattServAppLinks[GATTSERVAPP_MAX_LINKS];
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -91,6 +121,12 @@ static gattCharCfg_t *gattServApp_FindCharCfgItem( uint16 connHandle,
 static bStatus_t gattServApp_SendNotiInd( uint16 connHandle, uint8 cccValue,
                                           uint8 authenticated, gattAttribute_t *pAttr,
                                           uint8 taskId, pfnGATTReadAttrCB_t pfnReadAttrCB );
+static gattNotiBatchLink_t *gattServApp_FindBatchLink( gattNotiBatch_t *pBatch,
+                                                      uint16 connHandle );
+static uint8 gattServApp_SendBatchLink( gattNotiBatch_t *pBatch,
+                                        gattNotiBatchLink_t *pLink, uint8 maxPdus );
+static gattServAppLink_t *gattServApp_FindLink( uint16 connHandle );
+static gattServAppLink_t *gattServApp_AllocLink( uint16 connHandle );
 
 /*********************************************************************
  * API FUNCTIONS
@@ -156,6 +192,7 @@ bStatus_t GATTServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl, uint8 *pValue,
 {
   uint8 i;
   bStatus_t status = SUCCESS;
+  gattAttribute_t *pAttr = NULL;
 
   // Verify input parameters
   if ( ( charCfgTbl == NULL ) || ( pValue == NULL ) ||
@@ -171,23 +208,28 @@ bStatus_t GATTServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl, uint8 *pValue,
     if ( ( pItem->connHandle != INVALID_CONNHANDLE ) &&
          ( pItem->value != GATT_CFG_NO_OPERATION ) )
     {
-      gattAttribute_t *pAttr;
-
-      // Find the characteristic value attribute
-      pAttr = GATTServApp_FindAttr( attrTbl, numAttrs, pValue );
-      if ( pAttr != NULL )
+      // Find the characteristic value attribute on the first subscribed
+      // client only; it is the same for all the other clients
+      if ( pAttr == NULL )
       {
-        if ( pItem->value & GATT_CLIENT_CFG_NOTIFY )
+        pAttr = GATTServApp_FindAttr( attrTbl, numAttrs, pValue );
+        if ( pAttr == NULL )
         {
-           status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_NOTIFY,
-                                              authenticated, pAttr, taskId, pfnReadAttrCB );
+          // Not in this table; no client can be served
+          break;
         }
+      }
 
-        if ( pItem->value & GATT_CLIENT_CFG_INDICATE )
-        {
-           status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_INDICATE,
-                                              authenticated, pAttr, taskId, pfnReadAttrCB );
-        }
+      if ( pItem->value & GATT_CLIENT_CFG_NOTIFY )
+      {
+         status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_NOTIFY,
+                                            authenticated, pAttr, taskId, pfnReadAttrCB );
+      }
+
+      if ( pItem->value & GATT_CLIENT_CFG_INDICATE )
+      {
+         status |= gattServApp_SendNotiInd( pItem->connHandle, GATT_CLIENT_CFG_INDICATE,
+                                            authenticated, pAttr, taskId, pfnReadAttrCB );
       }
     }
   } // for
@@ -195,6 +237,470 @@ bStatus_t GATTServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl, uint8 *pValue,
   return ( status );
 }
 
+/*********************************************************************
+ * @fn      GATTServApp_ReadAttrDesc
+ *
+ * @brief   Read an attribute through a descriptor table.
+ *
+ * @param   attrTbl - attribute table.
+ * @param   descTbl - descriptor table matching attrTbl.
+ * @param   numAttrs - number of entries in attrTbl and descTbl.
+ * @param   pAttr - pointer to attribute.
+ * @param   pValue - pointer to data to be read.
+ * @param   pLen - length of data to be read.
+ * @param   offset - offset of the first octet to be read.
+ * @param   maxLen - maximum length of data to be read.
+ *
+ * @return  Success or Failure
+ */
+bStatus_t GATTServApp_ReadAttrDesc( gattAttribute_t *attrTbl,
+                                    const gattAttrDesc_t *descTbl,
+                                    uint16 numAttrs,
+                                    gattAttribute_t *pAttr, uint8 *pValue,
+                                    uint16 *pLen, uint16 offset, uint16 maxLen )
+{
+  const gattAttrDesc_t *pDesc;
+
+  if ( ( pAttr < attrTbl ) || ( pAttr >= attrTbl + numAttrs ) )
+  {
+    // Not an attribute of this table
+    *pLen = 0;
+    return ( ATT_ERR_INVALID_HANDLE );
+  }
+
+  pDesc = &(descTbl[pAttr - attrTbl]);
+
+  // Make sure it's not a blob operation
+  if ( offset > 0 )
+  {
+    return ( ATT_ERR_ATTR_NOT_LONG );
+  }
+
+  if ( ( pDesc->rule != GATT_ATTR_RULE_FIXED ) ||
+       !( pDesc->access & GATT_ATTR_ACCESS_READ ) )
+  {
+    // Not read through the table, local reads included
+    *pLen = 0;
+    return ( ATT_ERR_ATTR_NOT_FOUND );
+  }
+
+  *pLen = MIN( pDesc->len, maxLen );
+  VOID memcpy( pValue, pDesc->pValue, *pLen );
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_WriteAttrDesc
+ *
+ * @brief   Validate and write an attribute through a descriptor table.
+ *
+ * @param   connHandle - connection message was received on.
+ * @param   attrTbl - attribute table.
+ * @param   descTbl - descriptor table matching attrTbl.
+ * @param   numAttrs - number of entries in attrTbl and descTbl.
+ * @param   pAttr - pointer to attribute.
+ * @param   pValue - pointer to data to be written.
+ * @param   len - length of data.
+ * @param   offset - offset of the first octet to be written.
+ * @param   pParam - set to the profile parameter ID of a written value.
+ *
+ * @return  Success or Failure
+ */
+bStatus_t GATTServApp_WriteAttrDesc( uint16 connHandle, gattAttribute_t *attrTbl,
+                                     const gattAttrDesc_t *descTbl,
+                                     uint16 numAttrs,
+                                     gattAttribute_t *pAttr, uint8 *pValue,
+                                     uint16 len, uint16 offset, uint8 *pParam )
+{
+  const gattAttrDesc_t *pDesc;
+
+  *pParam = GATT_ATTR_NO_PARAM;
+
+  if ( ( pAttr < attrTbl ) || ( pAttr >= attrTbl + numAttrs ) )
+  {
+    // Not an attribute of this table
+    return ( ATT_ERR_INVALID_HANDLE );
+  }
+
+  pDesc = &(descTbl[pAttr - attrTbl]);
+
+  switch ( pDesc->rule )
+  {
+    case GATT_ATTR_RULE_CCC:
+      return ( GATTServApp_ProcessCCCWriteReq( connHandle, pAttr, pValue, len,
+                                               offset, pDesc->len ) );
+
+    case GATT_ATTR_RULE_FIXED:
+      if ( !( pDesc->access & GATT_ATTR_ACCESS_WRITE ) )
+      {
+        // Not written through the table, local writes included
+        return ( ATT_ERR_ATTR_NOT_FOUND );
+      }
+
+      // Make sure it's not a blob operation
+      if ( offset > 0 )
+      {
+        return ( ATT_ERR_ATTR_NOT_LONG );
+      }
+
+      if ( len != pDesc->len )
+      {
+        return ( ATT_ERR_INVALID_VALUE_SIZE );
+      }
+
+      VOID memcpy( pDesc->pValue, pValue, len );
+      *pParam = pDesc->param;
+
+      return ( SUCCESS );
+
+    default:
+      // Not served through the table
+      return ( ATT_ERR_ATTR_NOT_FOUND );
+  }
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_InitNotiBatch
+ *
+ * @brief   Initialize a notification batch.
+ *
+ * @param   pBatch - notification batch.
+ * @param   pLinks - rings of the links, one per link served at once.
+ * @param   numLinks - number of elements in pLinks.
+ * @param   pItems - storage for the queued updates, numLinks * maxItems
+ *                   elements.
+ * @param   maxItems - number of updates queued per link.
+ *
+ * @return  none
+ */
+void GATTServApp_InitNotiBatch( gattNotiBatch_t *pBatch,
+                                gattNotiBatchLink_t *pLinks, uint8 numLinks,
+                                gattNotiBatchItem_t *pItems, uint8 maxItems )
+{
+  uint8 i;
+
+  for ( i = 0; i < numLinks; i++ )
+  {
+    pLinks[i].connHandle = INVALID_CONNHANDLE;
+    pLinks[i].head = 0;
+    pLinks[i].count = 0;
+  }
+
+  pBatch->pLinks = pLinks;
+  pBatch->pItems = pItems;
+  pBatch->numLinks = numLinks;
+  pBatch->maxItems = maxItems;
+  pBatch->numItems = 0;
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_QueueNoti
+ *
+ * @brief   Queue a Characteristic Value update in a notification batch.
+ *
+ * @param   pBatch - notification batch.
+ * @param   charCfgTbl - characteristic configuration table.
+ * @param   pValue - pointer to attribute value.
+ * @param   authenticated - whether an authenticated link is required.
+ * @param   attrTbl - attribute table.
+ * @param   numAttrs - number of attributes in attribute table.
+ * @param   pfnReadAttrCB - read callback function pointer.
+ *
+ * @return  Success or Failure
+ */
+bStatus_t GATTServApp_QueueNoti( gattNotiBatch_t *pBatch,
+                                 gattCharCfg_t *charCfgTbl, uint8 *pValue,
+                                 uint8 authenticated, gattAttribute_t *attrTbl,
+                                 uint16 numAttrs, pfnGATTReadAttrCB_t pfnReadAttrCB )
+{
+  gattAttribute_t *pAttr = NULL;
+  bStatus_t status = SUCCESS;
+  uint8 i;
+
+  // Verify input parameters
+  if ( ( pBatch == NULL )  || ( charCfgTbl == NULL ) || ( pValue == NULL ) ||
+       ( attrTbl == NULL ) || ( pfnReadAttrCB == NULL ) )
+  {
+    return ( INVALIDPARAMETER );
+  }
+
+  for ( i = 0; i < linkDBNumConns; i++ )
+  {
+    uint16 connHandle = charCfgTbl[i].connHandle;
+    gattNotiBatchLink_t *pLink;
+    gattNotiBatchItem_t *pItem;
+    uint16 len;
+
+    if ( ( connHandle == INVALID_CONNHANDLE ) ||
+         !( charCfgTbl[i].value & GATT_CLIENT_CFG_NOTIFY ) )
+    {
+      continue;
+    }
+
+    if ( pAttr == NULL )
+    {
+      pAttr = GATTServApp_FindAttr( attrTbl, numAttrs, pValue );
+      if ( pAttr == NULL )
+      {
+        return ( INVALIDPARAMETER );
+      }
+    }
+
+    pLink = gattServApp_FindBatchLink( pBatch, connHandle );
+    if ( pLink == NULL )
+    {
+      // Take a free ring
+      pLink = gattServApp_FindBatchLink( pBatch, INVALID_CONNHANDLE );
+      if ( pLink == NULL )
+      {
+        status = bleNoResources;
+        continue;
+      }
+      pLink->connHandle = connHandle;
+      pLink->head = 0;
+    }
+
+    if ( pLink->count == pBatch->maxItems )
+    {
+      // The link has not taken the earlier updates yet
+      status = bleNoResources;
+      continue;
+    }
+
+    pItem = &(pBatch->pItems[(pLink - pBatch->pLinks) * pBatch->maxItems +
+                             (pLink->head + pLink->count) % pBatch->maxItems]);
+
+    if ( (*pfnReadAttrCB)( connHandle, pAttr, pItem->value, &len, 0,
+                           GATT_NOTI_BATCH_VALUE_LEN, GATT_LOCAL_READ ) != SUCCESS )
+    {
+      // Value cannot be read for this client
+      if ( pLink->count == 0 )
+      {
+        pLink->connHandle = INVALID_CONNHANDLE;
+      }
+      continue;
+    }
+
+    pItem->charCfgTbl = charCfgTbl;
+    pItem->handle = pAttr->handle;
+    pItem->authenticated = authenticated;
+    pItem->len = (uint8)len;
+
+    pLink->count++;
+    pBatch->numItems++;
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_SendNotiBatch
+ *
+ * @brief   Send the notifications queued in a batch, link by link,
+ *          oldest first.
+ *
+ * @param   pBatch - notification batch.
+ * @param   maxPdus - max number of PDUs to submit per connection.
+ *
+ * @return  Success or Failure
+ */
+bStatus_t GATTServApp_SendNotiBatch( gattNotiBatch_t *pBatch, uint8 maxPdus )
+{
+  uint8 i;
+
+  if ( pBatch == NULL )
+  {
+    return ( INVALIDPARAMETER );
+  }
+
+  for ( i = 0; i < pBatch->numLinks; i++ )
+  {
+    gattNotiBatchLink_t *pLink = &(pBatch->pLinks[i]);
+
+    if ( pLink->count != 0 )
+    {
+      VOID gattServApp_SendBatchLink( pBatch, pLink, maxPdus );
+
+      if ( pLink->count == 0 )
+      {
+        // Free the ring for another link
+        pLink->connHandle = INVALID_CONNHANDLE;
+      }
+    }
+  }
+
+  return ( ( pBatch->numItems == 0 ) ? SUCCESS : blePending );
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_SetLinkParams
+ *
+ * @brief   Set the parameters used to size the notifications of a link.
+ *
+ * @param   connHandle - connection handle.
+ * @param   payloadLen - longest notification value to send, 0 to forget
+ *                       the link.
+ * @param   txOctets - maximum LL payload sent.
+ *
+ * @return  SUCCESS or bleNoResources
+ */
+bStatus_t GATTServApp_SetLinkParams( uint16 connHandle, uint16 payloadLen,
+                                     uint16 txOctets )
+{
+  gattServAppLink_t *pLink;
+
+  if ( payloadLen == 0 )
+  {
+    pLink = gattServApp_FindLink( connHandle );
+    if ( pLink != NULL )
+    {
+      pLink->payloadLen = 0;
+      pLink->txOctets = GATTSERVAPP_BATCH_PDU_PAYLOAD;
+    }
+
+    return ( SUCCESS );
+  }
+
+  pLink = gattServApp_AllocLink( connHandle );
+  if ( pLink == NULL )
+  {
+    return ( bleNoResources );
+  }
+
+  pLink->payloadLen = payloadLen;
+  pLink->txOctets = txOctets;
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_SetLinkMTU
+ *
+ * @brief   Set the ATT MTU negotiated on a link.
+ *
+ * @param   connHandle - connection handle.
+ * @param   mtu - ATT MTU, 0 to forget it.
+ *
+ * @return  SUCCESS or bleNoResources
+ */
+bStatus_t GATTServApp_SetLinkMTU( uint16 connHandle, uint16 mtu )
+{
+  gattServAppLink_t *pLink;
+
+  if ( mtu == 0 )
+  {
+    pLink = gattServApp_FindLink( connHandle );
+    if ( pLink != NULL )
+    {
+      pLink->mtu = 0;
+    }
+
+    return ( SUCCESS );
+  }
+
+  pLink = gattServApp_AllocLink( connHandle );
+  if ( pLink == NULL )
+  {
+    return ( bleNoResources );
+  }
+
+  pLink->mtu = mtu;
+
+  return ( SUCCESS );
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_GetPayloadLen
+ *
+ * @brief   Get the longest notification value to send on a link.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  value length set with GATTServApp_SetLinkParams(), at most
+ *          the value length of the ATT MTU of the link.
+ */
+uint16 GATTServApp_GetPayloadLen( uint16 connHandle )
+{
+  gattServAppLink_t *pLink = gattServApp_FindLink( connHandle );
+  uint16 maxLen = ATT_MTU_SIZE - 3;
+
+  if ( pLink != NULL )
+  {
+    if ( pLink->mtu != 0 )
+    {
+      maxLen = pLink->mtu - 3;
+    }
+
+    if ( ( pLink->payloadLen != 0 ) && ( pLink->payloadLen < maxLen ) )
+    {
+      maxLen = pLink->payloadLen;
+    }
+  }
+
+  return ( maxLen );
+}
+
+/*********************************************************************
+ * @fn      GATTServApp_SendNotiBuf
+ *
+ * @brief   Send a notification from a buffer already filled by the caller.
+ *
+ * @param   charCfgTbl - characteristic configuration table.
+ * @param   connHandle - connection to notify.
+ * @param   pAttr - Characteristic Value attribute record.
+ * @param   pBuf - value to notify, allocated with GATT_bm_alloc().
+ * @param   len - length of the value, at most
+ *                GATTServApp_GetPayloadLen( connHandle ).
+ * @param   authenticated - whether an authenticated link is required.
+ *
+ * @return  Success or Failure
+ */
+bStatus_t GATTServApp_SendNotiBuf( gattCharCfg_t *charCfgTbl, uint16 connHandle,
+                                   gattAttribute_t *pAttr, uint8 *pBuf,
+                                   uint16 len, uint8 authenticated )
+{
+  attHandleValueNoti_t noti;
+  bStatus_t status;
+
+  if ( pBuf == NULL )
+  {
+    return ( INVALIDPARAMETER );
+  }
+
+  noti.pValue = pBuf;
+
+  // Verify input parameters
+  if ( ( charCfgTbl == NULL ) || ( pAttr == NULL ) )
+  {
+    status = INVALIDPARAMETER;
+  }
+  else if ( len > GATTServApp_GetPayloadLen( connHandle ) )
+  {
+    // Would not fit in the ATT MTU of the link; never truncated
+    status = bleInvalidRange;
+  }
+  else if ( !( GATTServApp_ReadCharCfg( connHandle, charCfgTbl ) &
+               GATT_CLIENT_CFG_NOTIFY ) )
+  {
+    status = bleIncorrectMode;
+  }
+  else
+  {
+    noti.handle = pAttr->handle;
+    noti.len = len;
+
+    status = GATT_Notification( connHandle, &noti, authenticated );
+  }
+
+  if ( status != SUCCESS )
+  {
+    GATT_bm_free( (gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI );
+  }
+
+  return ( status );
+}
+
 /*********************************************************************
  * @fn          GATTServApp_FindAttr
  *
@@ -400,6 +906,8 @@ static bStatus_t gattServApp_SendNotiInd( uint16 connHandle, uint8 cccValue,
   uint16 len;
   bStatus_t status;
 
+  CYC_TRACE_BEGIN(CYC_TRACE_GSA_SEND_NOTI_IND);
+
   // If the attribute value is longer than (ATT_MTU - 3) octets, then
   // only the first (ATT_MTU - 3) octets of this attributes value can
   // be sent in a notification.
@@ -434,9 +942,180 @@ static bStatus_t gattServApp_SendNotiInd( uint16 connHandle, uint8 cccValue,
     status = bleNoResources;
   }
 
+  CYC_TRACE_END(CYC_TRACE_GSA_SEND_NOTI_IND);
+
   return ( status );
 }
 
 
+/*********************************************************************
+ * @fn      gattServApp_FindBatchLink
+ *
+ * @brief   Find the ring of a link in a notification batch.
+ *
+ * @param   pBatch - notification batch.
+ * @param   connHandle - connection handle, INVALID_CONNHANDLE for a
+ *                       free ring.
+ *
+ * @return  ring of the link. NULL, if not found.
+ */
+static gattNotiBatchLink_t *gattServApp_FindBatchLink( gattNotiBatch_t *pBatch,
+                                                      uint16 connHandle )
+{
+  uint8 i;
+
+  for ( i = 0; i < pBatch->numLinks; i++ )
+  {
+    if ( pBatch->pLinks[i].connHandle == connHandle )
+    {
+      return ( &(pBatch->pLinks[i]) );
+    }
+  }
+
+  return ( (gattNotiBatchLink_t *)NULL );
+}
+
+/*********************************************************************
+ * @fn      gattServApp_SendBatchLink
+ *
+ * @brief   Send the notifications queued for a link in a batch, oldest
+ *          first, until maxPdus PDUs are submitted or the controller
+ *          refuses one, which stays queued for the next call.
+ *
+ * @param   pBatch - notification batch.
+ * @param   pLink - ring of the link.
+ * @param   maxPdus - max number of PDUs to submit.
+ *
+ * @return  number of notifications sent
+ */
+static uint8 gattServApp_SendBatchLink( gattNotiBatch_t *pBatch,
+                                        gattNotiBatchLink_t *pLink, uint8 maxPdus )
+{
+  gattServAppLink_t *pParams = gattServApp_FindLink( pLink->connHandle );
+  gattNotiBatchItem_t *pRing = &(pBatch->pItems[(pLink - pBatch->pLinks) *
+                                                pBatch->maxItems]);
+  uint16 txOctets = GATTSERVAPP_BATCH_PDU_PAYLOAD;
+  uint8 numPdus = 0;
+  uint8 numSent = 0;
+
+  if ( pParams != NULL )
+  {
+    txOctets = pParams->txOctets;
+  }
+
+  while ( pLink->count != 0 )
+  {
+    gattNotiBatchItem_t *pItem = &(pRing[pLink->head]);
+    attHandleValueNoti_t noti;
+    bStatus_t status = SUCCESS;
+    uint8 cost;
+    uint16 len;
+
+    cost = ( pItem->len + GATTSERVAPP_NOTI_HDR_SIZE + txOctets - 1 ) / txOctets;
+    if ( ( numPdus > 0 ) && ( numPdus + cost > maxPdus ) )
+    {
+      // No more room in this connection event
+      break;
+    }
+
+    // The client may have disabled notifications since
+    if ( GATTServApp_ReadCharCfg( pLink->connHandle, pItem->charCfgTbl ) &
+         GATT_CLIENT_CFG_NOTIFY )
+    {
+      noti.pValue = (uint8 *)GATT_bm_alloc( pLink->connHandle, ATT_HANDLE_VALUE_NOTI,
+                                            pItem->len, &len );
+      if ( noti.pValue == NULL )
+      {
+        // Try again on the next call
+        break;
+      }
+
+      VOID memcpy( noti.pValue, pItem->value, pItem->len );
+      noti.handle = pItem->handle;
+      noti.len = pItem->len;
+
+      status = GATT_Notification( pLink->connHandle, &noti, pItem->authenticated );
+      if ( status != SUCCESS )
+      {
+        GATT_bm_free( (gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI );
+
+        if ( ( status == blePending )           ||
+             ( status == MSG_BUFFER_NOT_AVAIL ) ||
+             ( status == bleMemAllocError ) )
+        {
+          // Controller is busy; try again on the next call
+          break;
+        }
+      }
+      else
+      {
+        numPdus += cost;
+        numSent++;
+      }
+    }
+
+    // Sent, or the link is gone or the client cannot be notified
+    pLink->head = ( pLink->head + 1 ) % pBatch->maxItems;
+    pLink->count--;
+    pBatch->numItems--;
+  }
+
+  return ( numSent );
+}
+
+/*********************************************************************
+ * @fn      gattServApp_FindLink
+ *
+ * @brief   Find the parameters of a link.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  link parameters. NULL, if not found.
+ */
+static gattServAppLink_t *gattServApp_FindLink( uint16 connHandle )
+{
+  uint8 i;
+
+  for ( i = 0; i < GATTSERVAPP_MAX_LINKS; i++ )
+  {
+    if ( ( ( gattServAppLinks[i].mtu != 0 ) ||
+           ( gattServAppLinks[i].payloadLen != 0 ) ) &&
+         ( gattServAppLinks[i].connHandle == connHandle ) )
+    {
+      return ( &gattServAppLinks[i] );
+    }
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      gattServApp_AllocLink
+ *
+ * @brief   Find the parameters of a link, or take unused ones for it.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  link parameters. NULL, if there is no room for the link.
+ */
+static gattServAppLink_t *gattServApp_AllocLink( uint16 connHandle )
+{
+  gattServAppLink_t *pLink = gattServApp_FindLink( connHandle );
+  uint8 i;
+
+  for ( i = 0; ( pLink == NULL ) && ( i < GATTSERVAPP_MAX_LINKS ); i++ )
+  {
+    if ( ( gattServAppLinks[i].mtu == 0 ) &&
+         ( gattServAppLinks[i].payloadLen == 0 ) )
+    {
+      pLink = &gattServAppLinks[i];
+      pLink->connHandle = connHandle;
+      pLink->txOctets = GATTSERVAPP_BATCH_PDU_PAYLOAD;
+    }
+  }
+
+  return ( pLink );
+}
+
 /****************************************************************************
 ****************************************************************************/
@@ -84,6 +84,43 @@ pfnBMFree_t  pfnBMFree  = NULL;
  * LOCAL VARIABLES
  */
 
+#ifdef ICALL_API_ASYNC
+// Match functions and tokens of the outstanding asynchronous commands,
+// oldest first. Only the task that enabled asynchronous mode uses these.
+static ICall_MsgMatchFn asyncCmdMatch[ICALL_API_ASYNC_MAX];
+static uint8 asyncCmdToken[ICALL_API_ASYNC_MAX];
+static uint8 asyncCmdHead = 0;
+static uint8 asyncCmdCount = 0;
+
+static uint8 asyncNextToken = ICALL_API_NO_TOKEN;
+static uint8 asyncLastToken = ICALL_API_NO_TOKEN;
+
+// Task using asynchronous mode
+static ICall_EntityID asyncEntity = ICALL_INVALID_ENTITY_ID;
+static uint8 asyncEnabled = FALSE;
+#endif // ICALL_API_ASYNC
+
+#ifdef GAPBOND_RPA_CACHE
+// Peer RPA to bond mapping, most recently used first
+typedef struct
+{
+  uint8 rpa[B_ADDR_LEN];        // Resolvable private address seen
+  uint8 idAddr[B_ADDR_LEN];     // Identity address of the bond
+  uint8 bondIdx;                // Bond index returned by the Bond Manager
+  uint32 tick;                  // ICall tick when the RPA was resolved
+} rpaCacheEntry_t;
+
+static rpaCacheEntry_t rpaCache[GAPBOND_RPA_CACHE_SIZE];
+static uint8 rpaCacheCount = 0;
+
+// Entries expire with the RPA interval, TGAP_PRIVATE_ADDR_INT in minutes
+static uint16 rpaCacheLifetime = 15;
+
+// Bond Manager callbacks of the application, see GAPBondMgr_Register
+static gapBondCBs_t *pRpaCacheAppCBs = NULL;
+static gapBondCBs_t rpaCacheBondCBs;
+#endif // GAPBOND_RPA_CACHE
+
 /*********************************************************************
  * EXTERNAL FUNCTIONS
  */
@@ -97,13 +134,26 @@ static void setICallCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
                               uint8_t cmdId);
 static void setDispatchCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
                                  uint8_t cmdId);
-static ICall_Errno waitMatchCS(ICall_MsgMatchFn matchCSFn, void **msg);
+static ICall_Errno sendArmedCS(ICall_EntityID src, void *msg,
+                               ICall_MsgMatchFn matchCSFn);
+static ICall_Errno waitMatchCS(void **msg);
 static bStatus_t sendWaitMatchCS(ICall_EntityID src, void *msg,
                                  ICall_MsgMatchFn matchCSFn);
 static bStatus_t sendWaitMatchValueCS(ICall_EntityID src, void *msg,
                                       ICall_MsgMatchFn matchCSFn, uint8_t len,
                                       uint8_t *pValue);
+#ifdef ICALL_API_ASYNC
+static uint8 asyncCmdPending(ICall_EntityID src, ICall_MsgMatchFn matchCSFn);
+static bStatus_t sendAsyncCS(ICall_EntityID src, void *msg,
+                             ICall_MsgMatchFn matchCSFn);
+#endif // ICALL_API_ASYNC
 static void registerTask(uint8 taskID, uint8_t subgrp, uint8_t cmdId);
+#ifdef GAPBOND_RPA_CACHE
+static uint8 rpaCacheFind(uint8 *pDevAddr, uint8 *pResolvedAddr);
+static void rpaCacheAdd(uint8 *pDevAddr, uint8 *pResolvedAddr, uint8 bondIdx);
+static void rpaCacheFlush(uint8 *pIdAddr);
+static void rpaCachePairStateCB(uint16 connHandle, uint8 state, uint8 status);
+#endif // GAPBOND_RPA_CACHE
 
 static bStatus_t gattRequest(uint16 connHandle, attMsg_t *pReq,
                              uint8 taskId, uint8 opcode);
@@ -529,12 +579,44 @@ static void setDispatchCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
 }
 
 /*********************************************************************
- * @fn      waitMatchCS
+ * @fn      sendArmedCS
  *
- * @brief   Wait for a matching Command Status response.
+ * @brief   Send a message to the BLE stack, routing its Command Status
+ *          response to the response slot of the calling thread.
  *
+ * @param   src  entity id of the sender of the message
+ * @param   msg  pointer to the message body to send.
  * @param   matchCSFn  pointer to a function that would return TRUE when
  *                     the message matches its condition.
+ *
+ * @return  ICALL_ERRNO_SUCCESS when the message was sent, in which case
+ *          waitMatchCS() must be called to collect the response.
+ */
+static ICall_Errno sendArmedCS(ICall_EntityID src, void *msg,
+                               ICall_MsgMatchFn matchCSFn)
+{
+  ICall_Errno errno;
+
+  // The stack may send the Command Status before the send returns, so the
+  // slot is armed first
+  ICall_armMatch(matchCSFn);
+
+  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
+                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+  if (errno != ICALL_ERRNO_SUCCESS)
+  {
+    ICall_armMatch(NULL);
+  }
+
+  return errno;
+}
+
+/*********************************************************************
+ * @fn      waitMatchCS
+ *
+ * @brief   Wait for the Command Status response of a message sent with
+ *          sendArmedCS(). Messages queued meanwhile are left untouched.
+ *
  * @param   msg  pointer to a pointer variable to store the starting
  *               address of the message body being retrieved. The pointer
  *               must not be NULL.
@@ -545,17 +627,19 @@ static void setDispatchCmdEvtHdr(ICall_HciExtCmd *pHdr, uint8_t subgrp,
  *          a thread which either has not registered an entity, or it has
  *          but it serves the BLE Service Class.
  */
-static ICall_Errno waitMatchCS(ICall_MsgMatchFn matchCSFn, void **msg)
+static ICall_Errno waitMatchCS(void **msg)
 {
   if (ICall_threadServes(ICALL_SERVICE_CLASS_BLE))
   {
     /* Blocking ICall is not allowed for BLE Stack thread, and hence
      * it's disabled.
      */
+    ICall_armMatch(NULL);
+
     return ICALL_ERRNO_UNKNOWN_THREAD;
   }
 
-  return ICall_waitMatch(ICALL_TIMEOUT_FOREVER, matchCSFn, NULL, NULL, msg);
+  return ICall_waitArmedMatch(ICALL_TIMEOUT_FOREVER, NULL, NULL, msg);
 }
 
 /*********************************************************************
@@ -581,15 +665,44 @@ static bStatus_t sendWaitMatchCS(ICall_EntityID src, void *msg,
     lastAppOpcodeSent = ((ICall_HciExtCmd *)msg)->opCode;
   }
 
+#ifdef ICALL_API_ASYNC
+  if (src == asyncEntity)
+  {
+    if (asyncEnabled)
+    {
+      if (asyncCmdCount < ICALL_API_ASYNC_MAX)
+      {
+        return sendAsyncCS(src, msg, matchCSFn);
+      }
+
+      // Every slot is taken: the command blocks instead, which cannot
+      // work if an outstanding command would take its status
+      if (asyncCmdPending(src, matchCSFn))
+      {
+        ICall_abort();
+      }
+    }
+
+    asyncLastToken = ICALL_API_NO_TOKEN;
+  }
+
+  if (asyncCmdPending(src, matchCSFn))
+  {
+    // The status of an outstanding asynchronous command would match first
+    ICall_freeMsg(msg);
+
+    return blePending;
+  }
+#endif // ICALL_API_ASYNC
+
   /* Send the message */
-  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
-                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+  errno = sendArmedCS(src, msg, matchCSFn);
 
   if (errno == ICALL_ERRNO_SUCCESS)
   {
     ICall_GapCmdStatus *pCmdStatus = NULL;
 
-    errno = waitMatchCS(matchCSFn, (void **)&pCmdStatus);
+    errno = waitMatchCS((void **)&pCmdStatus);
     if (errno == ICALL_ERRNO_SUCCESS)
     {
       uint8 status = pCmdStatus->hdr.hdr.status;
@@ -625,15 +738,29 @@ static bStatus_t sendWaitMatchValueCS(ICall_EntityID src, void *msg,
 {
   ICall_Errno errno;
 
+#ifdef ICALL_API_ASYNC
+  if (src == asyncEntity)
+  {
+    asyncLastToken = ICALL_API_NO_TOKEN;
+  }
+
+  if (asyncCmdPending(src, matchCSFn))
+  {
+    // The status of an outstanding asynchronous command would match first
+    ICall_freeMsg(msg);
+
+    return blePending;
+  }
+#endif // ICALL_API_ASYNC
+
   /* Send the message */
-  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
-                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+  errno = sendArmedCS(src, msg, matchCSFn);
 
   if (errno == ICALL_ERRNO_SUCCESS)
   {
     ICall_GapCmdStatus *pCmdStatus = NULL;
 
-    errno = waitMatchCS(matchCSFn, (void **)&pCmdStatus);
+    errno = waitMatchCS((void **)&pCmdStatus);
     if (errno == ICALL_ERRNO_SUCCESS)
     {
       uint8 status = pCmdStatus->hdr.hdr.status;
@@ -654,6 +781,162 @@ static bStatus_t sendWaitMatchValueCS(ICall_EntityID src, void *msg,
   return getStatusValueFromErrNo(errno);
 }
 
+#ifdef ICALL_API_ASYNC
+/*********************************************************************
+ * @fn      asyncCmdPending
+ *
+ * @brief   Check whether an outstanding asynchronous command sent by a task
+ *          completes with the same Command Status match function.
+ *
+ * @param   src  entity id of the task
+ * @param   matchCSFn  match function of the command about to be sent
+ *
+ * @return  TRUE if such a command is outstanding, FALSE otherwise.
+ */
+static uint8 asyncCmdPending(ICall_EntityID src, ICall_MsgMatchFn matchCSFn)
+{
+  uint8 i;
+
+  if (src != asyncEntity)
+  {
+    return FALSE;
+  }
+
+  for (i = 0; i < asyncCmdCount; i++)
+  {
+    if (asyncCmdMatch[(asyncCmdHead + i) % ICALL_API_ASYNC_MAX] == matchCSFn)
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*********************************************************************
+ * @fn      sendAsyncCS
+ *
+ * @brief   Send a message without waiting for its Command Status. The
+ *          status is delivered to the sender's message queue and matched
+ *          by ICall_apiCmdStatus(). The caller checks that fewer than
+ *          ICALL_API_ASYNC_MAX commands are outstanding.
+ *
+ * @param   src  entity id of the sender of the message
+ * @param   msg  pointer to the message body to send.
+ * @param   matchCSFn  pointer to a function that would return TRUE when
+ *                      the message matches its condition.
+ *
+ * @return  SUCCESS or FAILURE
+ */
+static bStatus_t sendAsyncCS(ICall_EntityID src, void *msg,
+                             ICall_MsgMatchFn matchCSFn)
+{
+  ICall_Errno errno;
+  uint8 idx;
+
+  asyncLastToken = ICALL_API_NO_TOKEN;
+
+  /* Send the message */
+  errno = ICall_sendServiceMsg(src, ICALL_SERVICE_CLASS_BLE,
+                               ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+
+  if (errno == ICALL_ERRNO_SUCCESS)
+  {
+    if (++asyncNextToken == ICALL_API_NO_TOKEN)
+    {
+      asyncNextToken++;
+    }
+
+    idx = (asyncCmdHead + asyncCmdCount) % ICALL_API_ASYNC_MAX;
+    asyncCmdMatch[idx] = matchCSFn;
+    asyncCmdToken[idx] = asyncNextToken;
+    asyncCmdCount++;
+
+    asyncLastToken = asyncNextToken;
+
+    return SUCCESS;
+  }
+
+  return getStatusValueFromErrNo(errno);
+}
+
+/*********************************************************************
+ * Enable or disable asynchronous mode for the calling task.
+ *
+ * Public function defined in icall_apimsg.h.
+ */
+bStatus_t ICall_apiSetAsync(uint8 enable)
+{
+  ICall_EntityID entity = ICall_getEntityId();
+
+  if ((entity != asyncEntity) && (asyncCmdCount != 0))
+  {
+    return bleIncorrectMode;
+  }
+
+  if (enable)
+  {
+    asyncEntity = entity;
+  }
+
+  asyncEnabled = (entity == asyncEntity) && enable;
+
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * Get the token of the last command sent by the calling task.
+ *
+ * Public function defined in icall_apimsg.h.
+ */
+uint8 ICall_apiLastToken(void)
+{
+  if (ICall_getEntityId() != asyncEntity)
+  {
+    return ICALL_API_NO_TOKEN;
+  }
+
+  return asyncLastToken;
+}
+
+/*********************************************************************
+ * Get the number of outstanding asynchronous commands.
+ *
+ * Public function defined in icall_apimsg.h.
+ */
+uint8 ICall_apiPendingCmds(void)
+{
+  return asyncCmdCount;
+}
+
+/*********************************************************************
+ * Match a received stack message against the oldest outstanding
+ * asynchronous command.
+ *
+ * Public function defined in icall_apimsg.h.
+ */
+uint8 ICall_apiCmdStatus(void *pMsg, ICall_ApiCmdDone *pDone)
+{
+  ICall_GapCmdStatus *pCmdStatus = (ICall_GapCmdStatus *)pMsg;
+
+  // Command Status events are returned in the order the commands were sent
+  if ((asyncCmdCount == 0) ||
+      !asyncCmdMatch[asyncCmdHead](ICALL_SERVICE_CLASS_BLE, asyncEntity, pMsg))
+  {
+    return FALSE;
+  }
+
+  pDone->token = asyncCmdToken[asyncCmdHead];
+  pDone->status = pCmdStatus->hdr.hdr.status;
+  pDone->opCode = pCmdStatus->opCode;
+
+  asyncCmdHead = (asyncCmdHead + 1) % ICALL_API_ASYNC_MAX;
+  asyncCmdCount--;
+
+  return TRUE;
+}
+#endif // ICALL_API_ASYNC
+
 /******************************************************************************
  * @fn      registerTask
  *
@@ -751,6 +1034,14 @@ void GAPBondMgr_Register(gapBondCBs_t *pCB)
   {
     setDispatchCmdEvtHdr(&msg->hdr, DISPATCH_GAP_PROFILE,
                          DISPATCH_PROFILE_REG_CB);
+#ifdef GAPBOND_RPA_CACHE
+    // Bonding may replace a stored bond, so watch the pairing state before
+    // handing it to the application
+    pRpaCacheAppCBs = pCB;
+    rpaCacheBondCBs.passcodeCB = (pCB != NULL) ? pCB->passcodeCB : NULL;
+    rpaCacheBondCBs.pairStateCB = rpaCachePairStateCB;
+    pCB = &rpaCacheBondCBs;
+#endif // GAPBOND_RPA_CACHE
     // set callback
     msg->pCB = pCB;
 
@@ -881,6 +1172,28 @@ uint8 GAPBondMgr_ResolveAddr(uint8 addrType, uint8 *pDevAddr,
                              uint8 *pResolvedAddr)
 {
   uint8_t bondIdx = GAP_BONDINGS_MAX;
+#ifdef GAPBOND_RPA_CACHE
+  uint8 isRpa = ((addrType == ADDRTYPE_RANDOM) &&
+                 ((pDevAddr[B_ADDR_LEN-1] & RANDOM_ADDR_HDR_MASK) ==
+                  PRIVATE_RESOLVE_ADDR_HDR));
+  uint8 idAddr[B_ADDR_LEN];
+
+  if (isRpa)
+  {
+    // A recently resolved RPA skips the ah() check against every IRK
+    bondIdx = rpaCacheFind(pDevAddr, pResolvedAddr);
+    if (bondIdx < GAP_BONDINGS_MAX)
+    {
+      return bondIdx;
+    }
+
+    // Resolve into a local buffer so that the identity can be cached
+    if (pResolvedAddr == NULL)
+    {
+      pResolvedAddr = idAddr;
+    }
+  }
+#endif // GAPBOND_RPA_CACHE
 
   // Allocate message buffer space
   ICall_BondMgrResolveAddr *msg =
@@ -901,9 +1214,194 @@ uint8 GAPBondMgr_ResolveAddr(uint8 addrType, uint8 *pDevAddr,
                          sizeof(bondIdx), (uint8_t *)&bondIdx);
   }
 
+#ifdef GAPBOND_RPA_CACHE
+  // Misses are not cached, a new bond may resolve the address later
+  if (isRpa && (bondIdx < GAP_BONDINGS_MAX))
+  {
+    rpaCacheAdd(pDevAddr, pResolvedAddr, bondIdx);
+  }
+#endif // GAPBOND_RPA_CACHE
+
   return bondIdx;
 }
 
+#ifdef GAPBOND_RPA_CACHE
+/*********************************************************************
+ * @fn      rpaCacheFind
+ *
+ * @brief   Look up a peer RPA in the cache and move a hit to the front.
+ *          Expired entries are dropped on the way.
+ *
+ * @param   pDevAddr - peer's resolvable private address
+ * @param   pResolvedAddr - buffer for the identity address, may be NULL
+ *
+ * @return  bond index if found, GAP_BONDINGS_MAX otherwise
+ */
+static uint8 rpaCacheFind(uint8 *pDevAddr, uint8 *pResolvedAddr)
+{
+  uint8 bondIdx = GAP_BONDINGS_MAX;
+  uint32 now = ICall_getTicks();
+  uint32 lifetime;
+  ICall_CSState key;
+  uint8 hit = GAPBOND_RPA_CACHE_SIZE;
+  uint8 count = 0;
+  uint8 i;
+
+  // Minutes to milliseconds, limited by the tick counter wrap around
+  lifetime = (uint32)rpaCacheLifetime * 60000;
+  if (lifetime > ICall_getMaxMSecs())
+  {
+    lifetime = ICall_getMaxMSecs();
+  }
+
+  // Several application tasks may resolve addresses
+  key = ICall_enterCriticalSection();
+
+  // Hits move entries to the front, so the order is by last use rather
+  // than by resolve time: drop expired entries wherever they are
+  for (i = 0; i < rpaCacheCount; i++)
+  {
+    if (((now - rpaCache[i].tick) / (1000 / ICall_getTickPeriod())) >= lifetime)
+    {
+      continue;
+    }
+
+    if (count != i)
+    {
+      rpaCache[count] = rpaCache[i];
+    }
+
+    if ((hit == GAPBOND_RPA_CACHE_SIZE) &&
+        (memcmp(rpaCache[count].rpa, pDevAddr, B_ADDR_LEN) == 0))
+    {
+      hit = count;
+    }
+
+    count++;
+  }
+
+  rpaCacheCount = count;
+
+  if (hit < count)
+  {
+    rpaCacheEntry_t entry = rpaCache[hit];
+
+    // Move to the front
+    memmove(&rpaCache[1], &rpaCache[0], hit * sizeof(rpaCacheEntry_t));
+    rpaCache[0] = entry;
+
+    if (pResolvedAddr != NULL)
+    {
+      memcpy(pResolvedAddr, entry.idAddr, B_ADDR_LEN);
+    }
+
+    bondIdx = entry.bondIdx;
+  }
+
+  ICall_leaveCriticalSection(key);
+
+  return bondIdx;
+}
+
+/*********************************************************************
+ * @fn      rpaCacheAdd
+ *
+ * @brief   Add a resolved RPA at the front of the cache, evicting the least
+ *          recently used entry if the cache is full.
+ *
+ * @param   pDevAddr - peer's resolvable private address
+ * @param   pResolvedAddr - identity address of the bond
+ * @param   bondIdx - bond index
+ *
+ * @return  none
+ */
+static void rpaCacheAdd(uint8 *pDevAddr, uint8 *pResolvedAddr, uint8 bondIdx)
+{
+  ICall_CSState key;
+  uint8 count;
+
+  key = ICall_enterCriticalSection();
+
+  count = rpaCacheCount;
+  if (count == GAPBOND_RPA_CACHE_SIZE)
+  {
+    count--;
+  }
+
+  memmove(&rpaCache[1], &rpaCache[0], count * sizeof(rpaCacheEntry_t));
+
+  memcpy(rpaCache[0].rpa, pDevAddr, B_ADDR_LEN);
+  memcpy(rpaCache[0].idAddr, pResolvedAddr, B_ADDR_LEN);
+  rpaCache[0].bondIdx = bondIdx;
+  rpaCache[0].tick = ICall_getTicks();
+
+  rpaCacheCount = count + 1;
+
+  ICall_leaveCriticalSection(key);
+}
+
+/*********************************************************************
+ * @fn      rpaCacheFlush
+ *
+ * @brief   Drop the entries of one bond or the whole cache.
+ *
+ * @param   pIdAddr - identity address of the bond, NULL for all bonds
+ *
+ * @return  none
+ */
+static void rpaCacheFlush(uint8 *pIdAddr)
+{
+  ICall_CSState key;
+  uint8 i;
+  uint8 keep = 0;
+
+  key = ICall_enterCriticalSection();
+
+  if (pIdAddr != NULL)
+  {
+    // Compact the cache, preserving the LRU order
+    for (i = 0; i < rpaCacheCount; i++)
+    {
+      if (memcmp(rpaCache[i].idAddr, pIdAddr, B_ADDR_LEN) != 0)
+      {
+        rpaCache[keep++] = rpaCache[i];
+      }
+    }
+  }
+
+  rpaCacheCount = keep;
+
+  ICall_leaveCriticalSection(key);
+}
+
+/*********************************************************************
+ * @fn      rpaCachePairStateCB
+ *
+ * @brief   Pairing state callback installed in front of the application's.
+ *          A new bond may take the slot of a replaced one, so the cache is
+ *          flushed when pairing completes and when a bond is saved.
+ *
+ * @param   connHandle - connection handle
+ * @param   state - pairing state
+ * @param   status - pairing status
+ *
+ * @return  none
+ */
+static void rpaCachePairStateCB(uint16 connHandle, uint8 state, uint8 status)
+{
+  if ((state == GAPBOND_PAIRING_STATE_BOND_SAVED) ||
+      ((state == GAPBOND_PAIRING_STATE_COMPLETE) && (status == SUCCESS)))
+  {
+    rpaCacheFlush(NULL);
+  }
+
+  if ((pRpaCacheAppCBs != NULL) && (pRpaCacheAppCBs->pairStateCB != NULL))
+  {
+    pRpaCacheAppCBs->pairStateCB(connHandle, state, status);
+  }
+}
+#endif // GAPBOND_RPA_CACHE
+
 /******************************************************************************
  * Add function for the GATT Service.
  *
@@ -2504,6 +3002,13 @@ bStatus_t GAP_SetParamValue(gapParamIDs_t paramID, uint16 paramValue)
   ICall_GapSetParam *msg =
     (ICall_GapSetParam *)ICall_allocMsg(sizeof(ICall_GapSetParam));
 
+#ifdef GAPBOND_RPA_CACHE
+  if (paramID == TGAP_PRIVATE_ADDR_INT)
+  {
+    rpaCacheLifetime = paramValue;
+  }
+#endif // GAPBOND_RPA_CACHE
+
   if (msg)
   {
     setICallCmdEvtHdr(&msg->hdr, HCI_EXT_GAP_SUBGRP, HCI_EXT_GAP_SET_PARAM);
@@ -2690,6 +3195,8 @@ bStatus_t GAPBondMgr_SetParameter(uint16 param, uint8 len, void *pValue)
 
   if (msg)
   {
+    bStatus_t status;
+
     setICallCmdEvtHdr(&msg->hdr, HCI_EXT_GAP_SUBGRP, HCI_EXT_GAP_BOND_SET_PARAM);
 
     /* create message header */
@@ -2698,7 +3205,27 @@ bStatus_t GAPBondMgr_SetParameter(uint16 param, uint8 len, void *pValue)
     msg->paramIdLenVal.pValue = pValue;
 
     /* Send the message. */
-    return sendWaitMatchCS(ICall_getEntityId(), msg, matchBondMgrSetParamCS);
+    status = sendWaitMatchCS(ICall_getEntityId(), msg, matchBondMgrSetParamCS);
+
+#ifdef GAPBOND_RPA_CACHE
+    // Flush once the erase is accepted: a resolve sent after this point is
+    // queued behind the erase and can no longer cache the erased bond
+    if (status == SUCCESS)
+    {
+      if (param == GAPBOND_ERASE_ALLBONDS)
+      {
+        rpaCacheFlush(NULL);
+      }
+      else if ((param == GAPBOND_ERASE_SINGLEBOND) &&
+               (len == (1 + B_ADDR_LEN)))
+      {
+        // Address type followed by the identity address
+        rpaCacheFlush((uint8 *)pValue + 1);
+      }
+    }
+#endif // GAPBOND_RPA_CACHE
+
+    return status;
   }
 
   return MSG_BUFFER_NOT_AVAIL;
@@ -2725,14 +3252,13 @@ bStatus_t GAPBondMgr_GetParameter(uint16 param, void *pValue)
     msg->paramID = param;
 
     // Send the message
-    errno = ICall_sendServiceMsg(ICall_getEntityId(), ICALL_SERVICE_CLASS_BLE,
-                                 ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+    errno = sendArmedCS(ICall_getEntityId(), msg, matchBondMgrGetParamCS);
 
     if (errno == ICALL_ERRNO_SUCCESS)
     {
       ICall_GapCmdStatus *pCmdStatus = NULL;
 
-      errno = waitMatchCS(matchBondMgrGetParamCS, (void **)&pCmdStatus);
+      errno = waitMatchCS((void **)&pCmdStatus);
       if (errno == ICALL_ERRNO_SUCCESS)
       {
         uint8 status = pCmdStatus->hdr.hdr.status;
@@ -3250,7 +3776,17 @@ void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size, uint16 *pSizeA
 {
   if (pfnBMAlloc != NULL)
   {
+#ifdef HEAPMGR_TRACE
+    uint_least8_t owner = ICall_heapSetOwner(ICALL_HEAP_OWNER_BM_GATT);
+    void *pBuf = (*pfnBMAlloc)(BM_MSG_GATT, size, connHandle, opcode,
+                               pSizeAlloc);
+
+    ICall_heapSetOwner(owner);
+
+    return pBuf;
+#else
     return (*pfnBMAlloc)(BM_MSG_GATT, size, connHandle, opcode, pSizeAlloc);
+#endif /* HEAPMGR_TRACE */
   }
 
   return ((void *)NULL);
@@ -3272,7 +3808,16 @@ void *L2CAP_bm_alloc( uint16 size )
 {
   if (pfnBMAlloc != NULL)
   {
+#ifdef HEAPMGR_TRACE
+    uint_least8_t owner = ICall_heapSetOwner(ICALL_HEAP_OWNER_BM_L2CAP);
+    void *pBuf = (*pfnBMAlloc)(BM_MSG_L2CAP, size, 0, 0, NULL);
+
+    ICall_heapSetOwner(owner);
+
+    return pBuf;
+#else
     return (*pfnBMAlloc)(BM_MSG_L2CAP, size, 0, 0, NULL);
+#endif /* HEAPMGR_TRACE */
   }
 
   return ((void *)NULL);
@@ -4626,8 +5171,7 @@ bStatus_t SM_GetScConfirmOob(uint8 *publicKey, uint8 *oob, uint8 *pOut)
     msg->oob = oob;
 
     // Send the message
-    errno = ICall_sendServiceMsg(ICall_getEntityId(), ICALL_SERVICE_CLASS_BLE,
-                                 ICALL_MSG_FORMAT_3RD_CHAR_TASK_ID, msg);
+    errno = sendArmedCS(ICall_getEntityId(), msg, matchSMGetScConfirmCS);
     
     // Send the message
     //return sendWaitMatchCS(ICall_getEntityId(), msg, matchSMGetScConfirmCS);
@@ -4636,7 +5180,7 @@ bStatus_t SM_GetScConfirmOob(uint8 *publicKey, uint8 *oob, uint8 *pOut)
     {
       ICall_GapCmdStatus *pCmdStatus = NULL;
 
-      errno = waitMatchCS(matchSMGetScConfirmCS, (void **)&pCmdStatus);
+      errno = waitMatchCS((void **)&pCmdStatus);
       
       if (errno == ICALL_ERRNO_SUCCESS)
       {
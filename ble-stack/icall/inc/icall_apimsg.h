@@ -56,6 +56,23 @@ extern "C" {
 // saved opcode of last command sent by App; won't be set by NPI
 extern uint16 lastAppOpcodeSent;
 
+#ifdef ICALL_API_ASYNC
+// Maximum number of commands outstanding in asynchronous mode
+#ifndef ICALL_API_ASYNC_MAX
+#define ICALL_API_ASYNC_MAX               16
+#endif // ICALL_API_ASYNC_MAX
+
+// Token of a command that completed synchronously
+#define ICALL_API_NO_TOKEN                0
+#endif // ICALL_API_ASYNC
+
+#ifdef GAPBOND_RPA_CACHE
+// Number of recently resolved peer RPAs remembered by GAPBondMgr_ResolveAddr
+#ifndef GAPBOND_RPA_CACHE_SIZE
+#define GAPBOND_RPA_CACHE_SIZE            8
+#endif // GAPBOND_RPA_CACHE_SIZE
+#endif // GAPBOND_RPA_CACHE
+
 /**
  * Event message header.
  * This is how it is defined in legacy BLE HCI_EXT_CMD_EVENT interface. It's
@@ -1178,10 +1195,87 @@ PACKED_TYPEDEF_STRUCT ICall_HciSetBdaddrEvtMsg
   uint16 opcode;
 } ICall_HciSetBdaddrEvtMsg;
 
+#ifdef ICALL_API_ASYNC
+/** Completion of a command sent in asynchronous mode */
+typedef struct _ICall_ApiCmdDone_
+{
+  uint8_t  token;  //!< token returned by ICall_apiLastToken() for the command
+  uint8_t  status; //!< command status, as the blocking call would return
+  uint16_t opCode; //!< opcode of the command status event
+} ICall_ApiCmdDone;
+#endif // ICALL_API_ASYNC
+
 /*********************************************************************
  * FUNCTION APIs
  */
 
+#ifdef ICALL_API_ASYNC
+/*********************************************************************
+ * @fn      ICall_apiSetAsync
+ *
+ * @brief   Enable or disable asynchronous mode for the calling task.
+ *
+ *          In asynchronous mode, stack APIs that only return a command
+ *          status send their command and return SUCCESS right away. The
+ *          command status is later received by the task as a stack
+ *          message and must be passed to ICall_apiCmdStatus(). Commands
+ *          complete in the order they were sent. Any data passed by
+ *          reference must remain valid until the command completes.
+ *          APIs that return a value through a pointer always block.
+ *
+ *          Once ICALL_API_ASYNC_MAX commands are outstanding, further
+ *          commands block as in synchronous mode and have no token. If
+ *          the status of such a command would match an outstanding
+ *          command instead, ICall_abort() is called.
+ *
+ *          Only one task may use asynchronous mode at a time.
+ *
+ * @param   enable - TRUE to enable, FALSE to disable.
+ *
+ * @return  SUCCESS, or bleIncorrectMode if another task has commands
+ *          outstanding.
+ */
+extern bStatus_t ICall_apiSetAsync(uint8 enable);
+
+/*********************************************************************
+ * @fn      ICall_apiLastToken
+ *
+ * @brief   Get the token of the last command sent by the calling task.
+ *
+ * @param   none
+ *
+ * @return  Token of the command, or ICALL_API_NO_TOKEN if it completed
+ *          synchronously.
+ */
+extern uint8 ICall_apiLastToken(void);
+
+/*********************************************************************
+ * @fn      ICall_apiPendingCmds
+ *
+ * @brief   Get the number of commands sent in asynchronous mode whose
+ *          command status has not been received yet.
+ *
+ * @param   none
+ *
+ * @return  Number of outstanding commands.
+ */
+extern uint8 ICall_apiPendingCmds(void);
+
+/*********************************************************************
+ * @fn      ICall_apiCmdStatus
+ *
+ * @brief   Check whether a received stack message is the command status
+ *          of the oldest outstanding asynchronous command.
+ *
+ * @param   pMsg - stack message received by the task.
+ * @param   pDone - filled in with the completion on a match.
+ *
+ * @return  TRUE if the message completed a command, FALSE otherwise.
+ *          The message is not freed either way.
+ */
+extern uint8 ICall_apiCmdStatus(void *pMsg, ICall_ApiCmdDone *pDone);
+#endif // ICALL_API_ASYNC
+
 /*********************************************************************
  * @fn      Util_buildRevision
  *
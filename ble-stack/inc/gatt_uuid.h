@@ -164,6 +164,26 @@ extern CONST uint8 manuAddrUUID[];
  */
 extern const uint8 *GATT_FindUUIDRec( const uint8 *pUUID, uint8 len );
 
+/**
+ * @brief   Register a 128-bit UUID record, so that GATT_FindUUIDRec()
+ *          finds it. The record is referenced, not copied.
+ *
+ * @param   pUUID - 128-bit UUID record. Must stay valid while registered.
+ *
+ * @return  SUCCESS, INVALIDPARAMETER, bleAlreadyInRequestedMode or
+ *          bleNoResources (GATT_MAX_NUM_UUID128 already registered).
+ */
+extern bStatus_t GATT_RegisterUUID128( const uint8 *pUUID );
+
+/**
+ * @brief   Deregister a 128-bit UUID record.
+ *
+ * @param   pUUID - 128-bit UUID.
+ *
+ * @return  SUCCESS or INVALIDPARAMETER if the UUID is not registered.
+ */
+extern bStatus_t GATT_DeregisterUUID128( const uint8 *pUUID );
+
 /*********************************************************************
 *********************************************************************/
 
@@ -154,6 +154,29 @@ extern "C"
 
 #define GATT_CFG_NO_OPERATION            0x0000 // No operation
 
+#if !defined ( GATT_NOTI_BATCH_VALUE_LEN )
+  #define GATT_NOTI_BATCH_VALUE_LEN      20     // Longest value copied into a notification batch (default ATT MTU less the notification header)
+#endif
+
+/** @defgroup GATT_ATTR_RULE_DEFINES GATT Attribute Descriptor Rules
+ * @{
+ */
+#define GATT_ATTR_RULE_NONE              0x00 //!< Value is not served through the descriptor table
+#define GATT_ATTR_RULE_FIXED             0x01 //!< Value is read and written as a whole; writes must be exactly len octets
+#define GATT_ATTR_RULE_CCC               0x02 //!< Client Characteristic Configuration; len holds the valid configuration bits
+/** @} End GATT_ATTR_RULE_DEFINES */
+
+/** @defgroup GATT_ATTR_ACCESS_DEFINES GATT Attribute Descriptor Access
+ * @{
+ */
+#define GATT_ATTR_ACCESS_NONE            0x00 //!< Value is neither read nor written by the profile callbacks
+#define GATT_ATTR_ACCESS_READ            0x01 //!< Value is read by the profile read callback, also for notifications
+#define GATT_ATTR_ACCESS_WRITE           0x02 //!< Value is written by the profile write callback
+#define GATT_ATTR_ACCESS_RW              ( GATT_ATTR_ACCESS_READ | GATT_ATTR_ACCESS_WRITE )
+/** @} End GATT_ATTR_ACCESS_DEFINES */
+
+#define GATT_ATTR_NO_PARAM               0xFF   // Write is not reported to the profile
+
 /** @defgroup GATT_FORMAT_TYPES_DEFINES GATT Characteristic Format Types
  * @{
  */
@@ -224,7 +247,7 @@ extern "C"
 #define GATT_PARAM_NUM_PREPARE_WRITES    0 // RW  uint8
 
 // To make the size of the pointer type be platform/compiler independent
-#define PTR_TYPE                         unsigned int *
+#define PTR_TYPE                         uintptr_t *
 
 // GATT local read or write operation
 #define GATT_LOCAL_READ                  0xFF
@@ -241,6 +264,11 @@ extern "C"
 // The number of attribute records in a given attribute table
 #define GATT_NUM_ATTRS( attrs )          ( sizeof( attrs ) / sizeof( gattAttribute_t ) )
 
+// Attribute descriptor table entries
+#define GATT_ATTR_DESC_NONE                                  { NULL, 0, GATT_ATTR_NO_PARAM, GATT_ATTR_RULE_NONE, GATT_ATTR_ACCESS_NONE }
+#define GATT_ATTR_DESC_FIXED( pValue, len, param, access )   { (uint8 *)(pValue), (len), (param), GATT_ATTR_RULE_FIXED, (access) }
+#define GATT_ATTR_DESC_CCC( validCfg )                       { NULL, (validCfg), GATT_ATTR_NO_PARAM, GATT_ATTR_RULE_CCC, GATT_ATTR_ACCESS_RW }
+
 // The handle of a service is the handle of the first attribute
 #define GATT_SERVICE_HANDLE( attrs )     ( (attrs)[0].handle )
 
@@ -363,6 +391,54 @@ typedef struct
   uint8  value;      //!< Characteristic configuration value for this client
 } gattCharCfg_t;
 
+/**
+ * GATT Structure for table-driven attribute dispatch. A descriptor table
+ * has one entry per attribute record, at the same index, so that reads
+ * and writes are served by an indexed lookup instead of matching UUIDs.
+ */
+typedef struct
+{
+  uint8 *pValue; //!< Value storage
+  uint16 len;    //!< Value length, or valid configuration bits for GATT_ATTR_RULE_CCC
+  uint8 param;   //!< Profile parameter ID reported on write, or GATT_ATTR_NO_PARAM
+  uint8 rule;    //!< Validation rule (GATT_ATTR_RULE_DEFINES)
+  uint8 access;  //!< Reads and writes served by the callbacks (GATT_ATTR_ACCESS_DEFINES)
+} gattAttrDesc_t;
+
+/**
+ * GATT Structure for a copy of a Characteristic Value update queued in a notification batch.
+ */
+typedef struct
+{
+  gattCharCfg_t *charCfgTbl;               //!< Characteristic configuration table
+  uint16 handle;                           //!< Characteristic Value handle
+  uint8 authenticated;                     //!< Whether an authenticated link is required
+  uint8 len;                               //!< Length of value
+  uint8 value[GATT_NOTI_BATCH_VALUE_LEN];  //!< Value when queued
+} gattNotiBatchItem_t;
+
+/**
+ * GATT Structure for the ring of updates queued for a link in a notification batch.
+ */
+typedef struct
+{
+  uint16 connHandle; //!< Connection handle, INVALID_CONNHANDLE if the ring is free
+  uint8 head;        //!< Oldest queued update
+  uint8 count;       //!< Number of queued updates
+} gattNotiBatchLink_t;
+
+/**
+ * GATT Structure for a notification batch.
+ */
+typedef struct
+{
+  gattNotiBatchLink_t *pLinks; //!< Rings of the links with queued updates
+  gattNotiBatchItem_t *pItems; //!< Storage of the rings, maxItems per ring
+  uint8 numLinks;              //!< Number of elements in pLinks
+  uint8 maxItems;              //!< Number of updates a ring holds
+  uint8 numItems;              //!< Number of queued updates, all rings
+} gattNotiBatch_t;
+
 /**
  * GATT Structure for service callback functions - must be setup by the application
  * and used when GATTServApp_RegisterService() is called.
@@ -648,6 +724,192 @@ extern bStatus_t GATTServApp_ProcessCharCfg( gattCharCfg_t *charCfgTbl, uint8 *p
                                         uint16 numAttrs, uint8 taskId,
                                         pfnGATTReadAttrCB_t pfnReadAttrCB );
 
+/**
+ * @brief   Read an attribute through a descriptor table.
+ *
+ * @param   attrTbl - attribute table.
+ * @param   descTbl - descriptor table matching attrTbl.
+ * @param   numAttrs - number of entries in attrTbl and descTbl.
+ * @param   pAttr - pointer to attribute.
+ * @param   pValue - pointer to data to be read.
+ * @param   pLen - length of data to be read.
+ * @param   offset - offset of the first octet to be read.
+ * @param   maxLen - maximum length of data to be read.
+ *
+ * @return  SUCCESS: Value was read.<BR>
+ *          ATT_ERR_ATTR_NOT_LONG: Offset is not 0.<BR>
+ *          ATT_ERR_ATTR_NOT_FOUND: Attribute is not readable through the table.<BR>
+ *          ATT_ERR_INVALID_HANDLE: Attribute is not in attrTbl.<BR>
+ */
+extern bStatus_t GATTServApp_ReadAttrDesc( gattAttribute_t *attrTbl,
+                                           const gattAttrDesc_t *descTbl,
+                                           uint16 numAttrs,
+                                           gattAttribute_t *pAttr, uint8 *pValue,
+                                           uint16 *pLen, uint16 offset, uint16 maxLen );
+
+/**
+ * @brief   Validate and write an attribute through a descriptor table.
+ *
+ * @param   connHandle - connection message was received on.
+ * @param   attrTbl - attribute table.
+ * @param   descTbl - descriptor table matching attrTbl.
+ * @param   numAttrs - number of entries in attrTbl and descTbl.
+ * @param   pAttr - pointer to attribute.
+ * @param   pValue - pointer to data to be written.
+ * @param   len - length of data.
+ * @param   offset - offset of the first octet to be written.
+ * @param   pParam - set to the profile parameter ID of a written value,
+ *                   GATT_ATTR_NO_PARAM otherwise.
+ *
+ * @return  SUCCESS: Value was written.<BR>
+ *          ATT_ERR_ATTR_NOT_LONG: Offset is not 0.<BR>
+ *          ATT_ERR_INVALID_VALUE_SIZE: Invalid length.<BR>
+ *          ATT_ERR_ATTR_NOT_FOUND: Attribute is not writable through the table.<BR>
+ *          ATT_ERR_INVALID_HANDLE: Attribute is not in attrTbl.<BR>
+ */
+extern bStatus_t GATTServApp_WriteAttrDesc( uint16 connHandle, gattAttribute_t *attrTbl,
+                                            const gattAttrDesc_t *descTbl,
+                                            uint16 numAttrs,
+                                            gattAttribute_t *pAttr, uint8 *pValue,
+                                            uint16 len, uint16 offset, uint8 *pParam );
+
+/**
+ * @brief   Initialize a notification batch.
+ *
+ * @param   pBatch - notification batch.
+ * @param   pLinks - rings of the links, one per link served at once.
+ * @param   numLinks - number of elements in pLinks.
+ * @param   pItems - storage for the queued updates, numLinks * maxItems
+ *                   elements.
+ * @param   maxItems - number of updates queued per link.
+ *
+ * @return  none
+ */
+extern void GATTServApp_InitNotiBatch( gattNotiBatch_t *pBatch,
+                                       gattNotiBatchLink_t *pLinks,
+                                       uint8 numLinks,
+                                       gattNotiBatchItem_t *pItems,
+                                       uint8 maxItems );
+
+/**
+ * @brief   Queue a Characteristic Value update in a notification batch,
+ *          to be notified by GATTServApp_SendNotiBatch() to all clients
+ *          that enabled notifications. The value is read and copied into
+ *          the ring of each client's link, up to GATT_NOTI_BATCH_VALUE_LEN
+ *          bytes, so every update is sent in order, even when the same
+ *          Characteristic Value is updated again before it was sent.
+ *          Indications are not batched; use GATTServApp_ProcessCharCfg()
+ *          for them.
+ *
+ * @param   pBatch - notification batch.
+ * @param   charCfgTbl - characteristic configuration table.
+ * @param   pValue - pointer to attribute value.
+ * @param   authenticated - whether an authenticated link is required.
+ * @param   attrTbl - attribute table.
+ * @param   numAttrs - number of attributes in attribute table.
+ * @param   pfnReadAttrCB - read callback function pointer.
+ *
+ * @return  SUCCESS: Update queued, or no client to notify.<BR>
+ *          INVALIDPARAMETER: Invalid parameter or attribute not found.<BR>
+ *          bleNoResources: The ring of a client's link is full, or
+ *                          no ring is free for it; the update is
+ *                          not queued for that client.<BR>
+ */
+extern bStatus_t GATTServApp_QueueNoti( gattNotiBatch_t *pBatch,
+                                        gattCharCfg_t *charCfgTbl, uint8 *pValue,
+                                        uint8 authenticated, gattAttribute_t *attrTbl,
+                                        uint16 numAttrs, pfnGATTReadAttrCB_t pfnReadAttrCB );
+
+/**
+ * @brief   Send the notifications queued in a batch, connection by
+ *          connection. Up to maxPdus Link Layer data PDUs worth of
+ *          notifications are submitted per connection, which should not
+ *          exceed the number of PDUs the controller can buffer
+ *          (MAX_NUM_PDU). Notifications that could not be sent stay
+ *          queued for the next call, e.g. at the end of the next
+ *          connection event.
+ *
+ * @param   pBatch - notification batch.
+ * @param   maxPdus - max number of PDUs to submit per connection.
+ *
+ * @return  SUCCESS: All queued notifications were sent.<BR>
+ *          blePending: Some notifications are still queued.<BR>
+ *          INVALIDPARAMETER: Invalid parameter.<BR>
+ */
+extern bStatus_t GATTServApp_SendNotiBatch( gattNotiBatch_t *pBatch, uint8 maxPdus );
+
+/**
+ * @brief   Set the parameters used to size the notifications of a link,
+ *          e.g. from the link tuning manager once the ATT MTU and data
+ *          length are known. GATTServApp_SendNotiBatch() allocates
+ *          notifications of up to payloadLen bytes and counts the PDUs
+ *          they take up with txOctets. Links without parameters use the
+ *          ATT MTU set with GATTServApp_SetLinkMTU() and the minimum LL
+ *          payload.
+ *
+ * @param   connHandle - connection handle.
+ * @param   payloadLen - longest notification value to send, 0 to forget
+ *                       the link.
+ * @param   txOctets - maximum LL payload sent.
+ *
+ * @return  SUCCESS: Parameters set.<BR>
+ *          bleNoResources: No room for another link
+ *                          (GATTSERVAPP_MAX_LINKS).<BR>
+ */
+extern bStatus_t GATTServApp_SetLinkParams( uint16 connHandle, uint16 payloadLen,
+                                            uint16 txOctets );
+
+/**
+ * @brief   Set the ATT MTU negotiated on a link, from the
+ *          ATT_MTU_UPDATED_EVENT of the connection. Notification values
+ *          are limited to the ATT MTU less 3 octets.
+ *
+ * @param   connHandle - connection handle.
+ * @param   mtu - ATT MTU, 0 to forget it on disconnection.
+ *
+ * @return  SUCCESS: ATT MTU set.<BR>
+ *          bleNoResources: No room for another link
+ *                          (GATTSERVAPP_MAX_LINKS).<BR>
+ */
+extern bStatus_t GATTServApp_SetLinkMTU( uint16 connHandle, uint16 mtu );
+
+/**
+ * @brief   Get the longest notification value to send on a link.
+ *
+ * @param   connHandle - connection handle.
+ *
+ * @return  value length set with GATTServApp_SetLinkParams(), at most
+ *          the ATT MTU of the link less 3 octets; ATT_MTU_SIZE - 3 if
+ *          neither was set.
+ */
+extern uint16 GATTServApp_GetPayloadLen( uint16 connHandle );
+
+/**
+ * @brief   Send a notification from a buffer already filled by the caller,
+ *          skipping the read callback and its copy of the value.
+ *
+ *          The buffer must have been allocated with GATT_bm_alloc() for
+ *          the same connection and ATT_HANDLE_VALUE_NOTI. Its ownership
+ *          is always handed over: it is either sent or freed.
+ *
+ * @param   charCfgTbl - characteristic configuration table.
+ * @param   connHandle - connection to notify.
+ * @param   pAttr - Characteristic Value attribute record.
+ * @param   pBuf - value to notify, allocated with GATT_bm_alloc().
+ * @param   len - length of the value, at most
+ *                GATTServApp_GetPayloadLen( connHandle ).
+ * @param   authenticated - whether an authenticated link is required.
+ *
+ * @return  SUCCESS: Notification was sent.<BR>
+ *          INVALIDPARAMETER: Invalid parameter.<BR>
+ *          bleInvalidRange: Value is longer than the link takes.<BR>
+ *          bleIncorrectMode: Client has not enabled notifications.<BR>
+ *          Otherwise, the status returned by GATT_Notification().<BR>
+ */
+extern bStatus_t GATTServApp_SendNotiBuf( gattCharCfg_t *charCfgTbl, uint16 connHandle,
+                                          gattAttribute_t *pAttr, uint8 *pBuf,
+                                          uint16 len, uint8 authenticated );
+
 /**
  * @brief   Build and send the GATT_CLIENT_CHAR_CFG_UPDATED_EVENT to
  *          the application.
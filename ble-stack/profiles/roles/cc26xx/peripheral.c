@@ -78,6 +78,8 @@
 #include "osal_snv.h"
 #include "icall_apimsg.h"
 
+#include "cyc_trace.h"
+
 /*********************************************************************
  * MACROS
  */
@@ -92,12 +94,21 @@
 #define START_CONN_UPDATE_EVT         Event_Id_01
 #define CONN_PARAM_TIMEOUT_EVT        Event_Id_02
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+#define ADAPTIVE_EVAL_EVT             Event_Id_03
+
+#define GAPROLE_ALL_EVENTS (GAPROLE_ICALL_EVT | START_ADVERTISING_EVT | \
+                            START_CONN_UPDATE_EVT | CONN_PARAM_TIMEOUT_EVT | \
+                            ADAPTIVE_EVAL_EVT)
+#else //!GAPROLE_ADAPTIVE_CONN_PARAMS
 #define GAPROLE_ALL_EVENTS (GAPROLE_ICALL_EVT | START_ADVERTISING_EVT | \
                             START_CONN_UPDATE_EVT | CONN_PARAM_TIMEOUT_EVT)
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 #else //!ICALL_EVENTS
 #define START_ADVERTISING_EVT         0x0001  // Start Advertising
 #define START_CONN_UPDATE_EVT         0x0002  // Start Connection Update Procedure
 #define CONN_PARAM_TIMEOUT_EVT        0x0004  // Connection Parameters Update Timeout
+#define ADAPTIVE_EVAL_EVT             0x0008  // Evaluate Link Traffic
 #endif //ICALL_EVENTS
 
 #define DEFAULT_ADVERT_OFF_TIME       30000   // 30 seconds
@@ -120,6 +131,34 @@
 
 #define MAX_TIMEOUT_VALUE             0xFFFF
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+// Fast profile: 15 to 30 ms interval, no slave latency, 2 s timeout
+#define DEFAULT_FAST_MIN_CONN_INTERVAL    12
+#define DEFAULT_FAST_MAX_CONN_INTERVAL    24
+#define DEFAULT_FAST_SLAVE_LATENCY        0
+#define DEFAULT_FAST_TIMEOUT_MULTIPLIER   200
+
+// Slow profile: 500 ms to 1 s interval, slave latency 3, 10 s timeout
+#define DEFAULT_SLOW_MIN_CONN_INTERVAL    400
+#define DEFAULT_SLOW_MAX_CONN_INTERVAL    800
+#define DEFAULT_SLOW_SLAVE_LATENCY        3
+#define DEFAULT_SLOW_TIMEOUT_MULTIPLIER   1000
+
+// Traffic evaluation window (in milliseconds)
+#define DEFAULT_ADAPTIVE_EVAL_PERIOD      1000
+
+// A window is busy when either threshold is reached
+#define DEFAULT_ADAPTIVE_BUSY_BYTES       64
+#define DEFAULT_ADAPTIVE_BUSY_REQS        4
+
+// Consecutive busy/idle windows before switching profiles
+#define DEFAULT_ADAPTIVE_FAST_WINDOWS     1
+#define DEFAULT_ADAPTIVE_SLOW_WINDOWS     5
+
+// Request count of a window saturates here
+#define ADAPTIVE_MAX_REQS                 UINT16_MAX
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
 // Task configuration
 #define GAPROLE_TASK_PRIORITY         3
 
@@ -172,9 +211,9 @@ static uint16_t events = 0;
 #endif //ICALL_EVENTS
 
 // Clock object used to signal timeout
-static Clock_Struct startAdvClock;
-static Clock_Struct startUpdateClock;
-static Clock_Struct updateTimeoutClock;
+static Util_ClockStruct startAdvClock;
+static Util_ClockStruct startUpdateClock;
+static Util_ClockStruct updateTimeoutClock;
 
 // Task setup
 Task_Struct gapRoleTask;
@@ -238,6 +277,47 @@ static uint8_t  gapRole_ConnTermReason = 0;
 
 static uint8_t paramUpdateNoSuccessOption = GAPROLE_NO_ACTION;
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+// Adaptive connection parameter configuration
+static gapRoleAdaptiveCfg_t gapRole_adaptiveCfg =
+{
+  .fast =
+  {
+    .minConnInterval = DEFAULT_FAST_MIN_CONN_INTERVAL,
+    .maxConnInterval = DEFAULT_FAST_MAX_CONN_INTERVAL,
+    .slaveLatency = DEFAULT_FAST_SLAVE_LATENCY,
+    .timeoutMultiplier = DEFAULT_FAST_TIMEOUT_MULTIPLIER
+  },
+  .slow =
+  {
+    .minConnInterval = DEFAULT_SLOW_MIN_CONN_INTERVAL,
+    .maxConnInterval = DEFAULT_SLOW_MAX_CONN_INTERVAL,
+    .slaveLatency = DEFAULT_SLOW_SLAVE_LATENCY,
+    .timeoutMultiplier = DEFAULT_SLOW_TIMEOUT_MULTIPLIER
+  },
+  .evalPeriod = DEFAULT_ADAPTIVE_EVAL_PERIOD,
+  .busyBytes = DEFAULT_ADAPTIVE_BUSY_BYTES,
+  .busyReqs = DEFAULT_ADAPTIVE_BUSY_REQS,
+  .fastWindows = DEFAULT_ADAPTIVE_FAST_WINDOWS,
+  .slowWindows = DEFAULT_ADAPTIVE_SLOW_WINDOWS
+};
+
+static uint8_t  gapRole_adaptiveEnable = FALSE;
+static uint8_t  gapRole_adaptiveTarget = GAPROLE_ADAPTIVE_PROFILE_NONE;
+static uint8_t  gapRole_adaptiveBusyCnt = 0;
+static uint8_t  gapRole_adaptiveIdleCnt = 0;
+
+// Traffic reported in the current window, see GAPRole_ReportTraffic
+static uint16_t gapRole_adaptiveBytes = 0;
+static uint16_t gapRole_adaptiveReqs = 0;
+
+// Profile and tick of the last adaptive update request
+static uint8_t  gapRole_adaptiveReqProfile = GAPROLE_ADAPTIVE_PROFILE_NONE;
+static uint32_t gapRole_adaptiveReqTick;
+
+static Util_ClockStruct adaptiveEvalClock;
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
 // Application callbacks
 static gapRolesCBs_t *pGapRoles_AppCGs = NULL;
 static gapRolesParamUpdateCB_t *pGapRoles_ParamUpdateCB = NULL;
@@ -262,6 +342,11 @@ static void      gapRole_SetupGAP(void);
 static void      gapRole_HandleParamUpdateNoSuccess(void);
 static bStatus_t gapRole_startConnUpdate(uint8_t handleFailure, 
                                        gapRole_updateConnParams_t *pConnParams);
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+static void      gapRole_adaptiveEval(void);
+static void      gapRole_adaptiveApply(void);
+static uint8_t   gapRole_validConnProfile(gapRoleConnProfile_t *pProfile);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 
 static void gapRole_setEvent(uint32_t event);
 
@@ -601,6 +686,24 @@ bStatus_t GAPRole_SetParameter(uint16_t param, uint8_t len, void *pValue)
         }
         break;
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+    case GAPROLE_ADAPTIVE_ENABLE:
+      if ((len == sizeof (uint8_t)) && (*((uint8_t*)pValue) <= TRUE))
+      {
+        gapRole_adaptiveEnable = *((uint8_t*)pValue);
+
+        // Start over with the next window
+        gapRole_adaptiveBusyCnt = 0;
+        gapRole_adaptiveIdleCnt = 0;
+        gapRole_adaptiveTarget = GAPROLE_ADAPTIVE_PROFILE_NONE;
+      }
+      else
+      {
+        ret = bleInvalidRange;
+      }
+      break;
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
     default:
       // The param value isn't part of this profile, try the GAP.
       if ((param < TGAP_PARAMID_MAX) && (len == sizeof (uint16_t)))
@@ -711,6 +814,16 @@ bStatus_t GAPRole_GetParameter(uint16_t param, void *pValue)
       *((uint16_t*)pValue) = gapRole_updateConnParams.timeoutMultiplier;
       break;
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+    case GAPROLE_ADAPTIVE_ENABLE:
+      *((uint8_t*)pValue) = gapRole_adaptiveEnable;
+      break;
+
+    case GAPROLE_ADAPTIVE_PROFILE:
+      *((uint8_t*)pValue) = gapRole_adaptiveTarget;
+      break;
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
     case GAPROLE_CONN_BD_ADDR:
       VOID memcpy(pValue, gapRole_ConnectedDevAddr, B_ADDR_LEN) ;
       break;
@@ -871,6 +984,12 @@ static void gapRole_init(void)
                       0, 0, false, START_CONN_UPDATE_EVT);
   Util_constructClock(&updateTimeoutClock, gapRole_clockHandler,
                       0, 0, false, CONN_PARAM_TIMEOUT_EVT);
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+  // Periodic, started when a connection is formed
+  Util_constructClock(&adaptiveEvalClock, gapRole_clockHandler,
+                      gapRole_adaptiveCfg.evalPeriod,
+                      gapRole_adaptiveCfg.evalPeriod, false, ADAPTIVE_EVAL_EVT);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 
   // Initialize the Profile Advertising and Connection Parameters
   gapRole_profileRole = GAP_PROFILE_PERIPHERAL;
@@ -949,7 +1068,9 @@ static void gapRole_taskFxn(UArg a0, UArg a1)
           else
           {
             // Process inter-task message
+            CYC_TRACE_BEGIN(CYC_TRACE_GAPROLE_STACK_MSG);
             gapRole_processStackMsg((ICall_Hdr *)pMsg);
+            CYC_TRACE_END(CYC_TRACE_GAPROLE_STACK_MSG);
           }
         }
 
@@ -1018,6 +1139,18 @@ static void gapRole_taskFxn(UArg a0, UArg a1)
       // Unsuccessful in updating connection parameters
       gapRole_HandleParamUpdateNoSuccess();
     }
+
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+    if (events & ADAPTIVE_EVAL_EVT)
+    {
+#ifndef ICALL_EVENTS
+      events &= ~ADAPTIVE_EVAL_EVT;
+#endif //ICALL_EVENTS
+
+      // Close the traffic window and pick a parameter profile
+      gapRole_adaptiveEval();
+    }
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
   } // for
 }
 
@@ -1250,6 +1383,20 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
             Util_restartClock(&startUpdateClock, timeout*1000);
           }
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+          // Start watching link traffic with an empty window
+          gapRole_adaptiveBytes = 0;
+          gapRole_adaptiveReqs = 0;
+          gapRole_adaptiveBusyCnt = 0;
+          gapRole_adaptiveIdleCnt = 0;
+          gapRole_adaptiveTarget = GAPROLE_ADAPTIVE_PROFILE_NONE;
+          gapRole_adaptiveReqProfile = GAPROLE_ADAPTIVE_PROFILE_NONE;
+
+          Util_rescheduleClock(&adaptiveEvalClock,
+                               gapRole_adaptiveCfg.evalPeriod);
+          Util_startClock(&adaptiveEvalClock);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
           // Notify the Bond Manager to the connection
           VOID GAPBondMgr_LinkEst(pPkt->devAddrType, pPkt->devAddr,
                                   pPkt->connectionHandle, GAP_PROFILE_PERIPHERAL);
@@ -1288,6 +1435,9 @@ static void gapRole_processGAPMsg(gapEventHdr_t *pMsg)
         // Cancel all connection parameter update timers (if any active)
         Util_stopClock(&startUpdateClock);
         Util_stopClock(&updateTimeoutClock);
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+        Util_stopClock(&adaptiveEvalClock);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 
         notify = TRUE;
 
@@ -1629,6 +1779,222 @@ bStatus_t GAPRole_SendUpdateParam(uint16_t minConnInterval,
   }
 }
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+/*********************************************************************
+ * @brief   Configure the adaptive connection parameter profiles.
+ *
+ * Public function defined in peripheral.h.
+ */
+bStatus_t GAPRole_SetAdaptiveConfig(gapRoleAdaptiveCfg_t *pCfg)
+{
+  if ((pCfg == NULL)                                 ||
+      (gapRole_validConnProfile(&pCfg->fast) == FALSE) ||
+      (gapRole_validConnProfile(&pCfg->slow) == FALSE) ||
+      (pCfg->evalPeriod == 0)                        ||
+      (pCfg->fastWindows == 0)                       ||
+      (pCfg->slowWindows == 0))
+  {
+    return (bleInvalidRange);
+  }
+
+  VOID memcpy(&gapRole_adaptiveCfg, pCfg, sizeof(gapRoleAdaptiveCfg_t));
+
+  // Apply the new window length if a connection is being watched
+  if (Util_isActive(&adaptiveEvalClock))
+  {
+    Util_rescheduleClock(&adaptiveEvalClock, gapRole_adaptiveCfg.evalPeriod);
+  }
+
+  return (SUCCESS);
+}
+
+/*********************************************************************
+ * @brief   Report link traffic to the adaptive connection parameter
+ *          controller.
+ *
+ * Public function defined in peripheral.h.
+ */
+void GAPRole_ReportTraffic(uint16_t queuedBytes, uint8_t attReqs)
+{
+  ICall_CSState key;
+
+  // May be called from any task, the window is closed by the GAP Role task
+  key = ICall_enterCriticalSection();
+
+  // Keep the backlog peak and the request count of the window
+  if (queuedBytes > gapRole_adaptiveBytes)
+  {
+    gapRole_adaptiveBytes = queuedBytes;
+  }
+
+  if (gapRole_adaptiveReqs < (ADAPTIVE_MAX_REQS - attReqs))
+  {
+    gapRole_adaptiveReqs += attReqs;
+  }
+  else
+  {
+    gapRole_adaptiveReqs = ADAPTIVE_MAX_REQS;
+  }
+
+  ICall_leaveCriticalSection(key);
+}
+
+/*********************************************************************
+ * @fn      gapRole_validConnProfile
+ *
+ * @brief   Check a set of connection parameters against the allowed ranges,
+ *          and that the supervision timeout exceeds
+ *          (1 + slave latency) * max interval * 2 as the spec requires.
+ *
+ * @param   pProfile - connection parameters to check
+ *
+ * @return  TRUE if valid, FALSE otherwise
+ */
+static uint8_t gapRole_validConnProfile(gapRoleConnProfile_t *pProfile)
+{
+  return ((pProfile->minConnInterval >= MIN_CONN_INTERVAL)             &&
+          (pProfile->maxConnInterval <= MAX_CONN_INTERVAL)             &&
+          (pProfile->minConnInterval <= pProfile->maxConnInterval)     &&
+          (pProfile->slaveLatency < MAX_SLAVE_LATENCY)                 &&
+          (pProfile->timeoutMultiplier >= MIN_TIMEOUT_MULTIPLIER)      &&
+          (pProfile->timeoutMultiplier <= MAX_TIMEOUT_MULTIPLIER)      &&
+          // Timeout in 10 ms units, interval in 1.25 ms units
+          (((uint32_t)pProfile->timeoutMultiplier * 4) >
+           ((uint32_t)(1 + pProfile->slaveLatency) * pProfile->maxConnInterval)));
+}
+
+/*********************************************************************
+ * @fn      gapRole_adaptiveEval
+ *
+ * @brief   Close the current traffic window and select the parameter
+ *          profile.  Switching to the fast profile takes fastWindows
+ *          consecutive busy windows, falling back to the slow profile
+ *          takes slowWindows consecutive idle windows.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void gapRole_adaptiveEval(void)
+{
+  ICall_CSState key;
+  uint16_t bytes;
+  uint16_t reqs;
+  uint32_t events;
+
+  key = ICall_enterCriticalSection();
+
+  bytes = gapRole_adaptiveBytes;
+  reqs = gapRole_adaptiveReqs;
+  gapRole_adaptiveBytes = 0;
+  gapRole_adaptiveReqs = 0;
+
+  ICall_leaveCriticalSection(key);
+
+  if ((gapRole_adaptiveEnable == FALSE) ||
+      (gapRole_ConnectionHandle == INVALID_CONNHANDLE))
+  {
+    return;
+  }
+
+  // Connection events in the window (intervals in units of 1.25 ms). A
+  // slow link caps the peer at about one request per event, so a peer
+  // that uses half of them is busy as well.
+  events = ((uint32_t)gapRole_adaptiveCfg.evalPeriod * 4) /
+           ((uint32_t)gapRole_ConnInterval * 5);
+
+  if ((bytes >= gapRole_adaptiveCfg.busyBytes) ||
+      (reqs >= gapRole_adaptiveCfg.busyReqs)   ||
+      ((reqs != 0) && ((uint32_t)reqs * 2 >= events)))
+  {
+    gapRole_adaptiveIdleCnt = 0;
+
+    if (gapRole_adaptiveBusyCnt < 0xFF)
+    {
+      gapRole_adaptiveBusyCnt++;
+    }
+  }
+  else
+  {
+    gapRole_adaptiveBusyCnt = 0;
+
+    if (gapRole_adaptiveIdleCnt < 0xFF)
+    {
+      gapRole_adaptiveIdleCnt++;
+    }
+  }
+
+  if (gapRole_adaptiveBusyCnt >= gapRole_adaptiveCfg.fastWindows)
+  {
+    gapRole_adaptiveTarget = GAPROLE_ADAPTIVE_PROFILE_FAST;
+  }
+  else if (gapRole_adaptiveIdleCnt >= gapRole_adaptiveCfg.slowWindows)
+  {
+    gapRole_adaptiveTarget = GAPROLE_ADAPTIVE_PROFILE_SLOW;
+  }
+
+  gapRole_adaptiveApply();
+}
+
+/*********************************************************************
+ * @fn      gapRole_adaptiveApply
+ *
+ * @brief   Request the target parameter profile if the link does not
+ *          already use it.  A request is deferred to a later window while
+ *          another update procedure is pending and for TGAP_CONN_PARAM_TIMEOUT
+ *          after the previous adaptive request, except that a request for
+ *          the fast profile following one for the slow profile is sent at
+ *          once: a busy peer is served on the next window and the slow
+ *          profile is still requested at most once per timeout.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void gapRole_adaptiveApply(void)
+{
+  gapRoleConnProfile_t *pProfile;
+  gapRole_updateConnParams_t params;
+  uint16_t timeout = GAP_GetParamValue(TGAP_CONN_PARAM_TIMEOUT);
+
+  if (gapRole_adaptiveTarget == GAPROLE_ADAPTIVE_PROFILE_NONE)
+  {
+    return;
+  }
+
+  // Leave the initial update and in-flight procedures alone
+  if ((Util_isActive(&startUpdateClock) == TRUE) ||
+      (Util_isActive(&updateTimeoutClock) == TRUE))
+  {
+    return;
+  }
+
+  if ((gapRole_adaptiveReqProfile != GAPROLE_ADAPTIVE_PROFILE_NONE) &&
+      !((gapRole_adaptiveTarget == GAPROLE_ADAPTIVE_PROFILE_FAST) &&
+        (gapRole_adaptiveReqProfile == GAPROLE_ADAPTIVE_PROFILE_SLOW)) &&
+      ((Clock_getTicks() - gapRole_adaptiveReqTick) <
+       (timeout * (1000 / Clock_tickPeriod))))
+  {
+    return;
+  }
+
+  pProfile = (gapRole_adaptiveTarget == GAPROLE_ADAPTIVE_PROFILE_FAST) ?
+             &gapRole_adaptiveCfg.fast : &gapRole_adaptiveCfg.slow;
+
+  params.minConnInterval = pProfile->minConnInterval;
+  params.maxConnInterval = pProfile->maxConnInterval;
+  params.slaveLatency = pProfile->slaveLatency;
+  params.timeoutMultiplier = pProfile->timeoutMultiplier;
+
+  // bleInvalidRange means the link already runs with these parameters
+  if (gapRole_startConnUpdate(GAPROLE_NO_ACTION, &params) == SUCCESS)
+  {
+    gapRole_adaptiveReqProfile = gapRole_adaptiveTarget;
+    gapRole_adaptiveReqTick = Clock_getTicks();
+  }
+}
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
 /*********************************************************************
  * @fn      gapRole_setEvent
  *
@@ -95,6 +95,10 @@ extern "C"
 #define GAPROLE_ADV_NONCONN_ENABLED 0x31B  //!< Enable/Disable Non-Connectable Advertising.  Read/Write.  Size is uint8_t.  Default is FALSE=Disabled.
 #define GAPROLE_BD_ADDR_TYPE        0x31C  //!< Address type of connected device. Read only. Size is uint8_t.
 #define GAPROLE_CONN_TERM_REASON    0x31D  //!< Reason of the last connection terminated event. Size is uint8_t.
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+#define GAPROLE_ADAPTIVE_ENABLE     0x31E  //!< Enable adaptive connection parameters. Read/Write. Size is uint8_t. Default is FALSE.
+#define GAPROLE_ADAPTIVE_PROFILE    0x31F  //!< Parameter profile selected by the adaptive controller. Read only. Size is uint8_t. See @ref GAPROLE_ADAPTIVE_PROFILES.
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
    
 /** @} End GAPROLE_PROFILE_PARAMETERS */
 
@@ -142,6 +146,42 @@ typedef enum
 #define GAPROLE_LINK_PARAM_UPDATE_WAIT_BOTH_PARAMS     4 // Wait for parameter update request, respond with best combination of local and remote parameters.
 #define GAPROLE_LINK_PARAM_UPDATE_REJECT_REQUEST       5 // Reject all parameter update requests. 
 #define GAPROLE_LINK_PARAM_UPDATE_NUM_OPTIONS          6 // Used for parameter checking.
+
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+/** @defgroup GAPROLE_ADAPTIVE_PROFILES Adaptive Connection Parameter Profiles
+ * @{
+ */
+#define GAPROLE_ADAPTIVE_PROFILE_NONE    0 //!< No profile selected yet
+#define GAPROLE_ADAPTIVE_PROFILE_SLOW    1 //!< Idle link, long interval and slave latency
+#define GAPROLE_ADAPTIVE_PROFILE_FAST    2 //!< Busy link, short interval
+/** @} End GAPROLE_ADAPTIVE_PROFILES */
+
+/**
+ * Connection parameters of an adaptive profile.
+ */
+typedef struct
+{
+  uint16_t minConnInterval;     //!< Minimum connection interval (n * 1.25ms)
+  uint16_t maxConnInterval;     //!< Maximum connection interval (n * 1.25ms)
+  uint16_t slaveLatency;        //!< Slave latency
+  uint16_t timeoutMultiplier;   //!< Supervision timeout (n * 10ms)
+} gapRoleConnProfile_t;
+
+/**
+ * Adaptive connection parameter configuration.
+ */
+typedef struct
+{
+  gapRoleConnProfile_t fast;    //!< Parameters used while data is flowing
+  gapRoleConnProfile_t slow;    //!< Parameters used while the link is idle
+  uint16_t evalPeriod;          //!< Traffic window length in milliseconds
+  uint16_t busyBytes;           //!< Queued notification bytes that make a window busy
+  uint16_t busyReqs;            //!< ATT requests per window that make a window busy,
+                                //!< as do requests in half of its connection events
+  uint8_t  fastWindows;         //!< Consecutive busy windows before switching to fast
+  uint8_t  slowWindows;         //!< Consecutive idle windows before switching to slow
+} gapRoleAdaptiveCfg_t;
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 /*-------------------------------------------------------------------
  * MACROS
  */
@@ -267,6 +307,32 @@ extern bStatus_t GAPRole_SendUpdateParam(uint16_t minConnInterval,
  */
 extern void GAPRole_RegisterAppCBs(gapRolesParamUpdateCB_t *pParamUpdateCB);
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+/**
+ * @brief       Configure the fast and slow profiles and the switching
+ *              thresholds of the adaptive connection parameter controller.
+ *              The controller is enabled with GAPROLE_ADAPTIVE_ENABLE.
+ *
+ * @param       pCfg - pointer to the configuration, copied by the GAP Role.
+ *
+ * @return      SUCCESS or bleInvalidRange
+ */
+extern bStatus_t GAPRole_SetAdaptiveConfig(gapRoleAdaptiveCfg_t *pCfg);
+
+/**
+ * @brief       Report link traffic to the adaptive connection parameter
+ *              controller.  May be called from any task.
+ *
+ * @param       queuedBytes - notification/response bytes currently waiting
+ *                            to be sent.
+ * @param       attReqs - number of ATT requests received since the last
+ *                        report.
+ *
+ * @return      none
+ */
+extern void GAPRole_ReportTraffic(uint16_t queuedBytes, uint8_t attReqs);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
 /**
  * @} End GAPROLES_PERIPHERAL_API
  */
@@ -334,6 +334,46 @@ static gattAttribute_t simpleProfileAttrTbl[SERVAPP_NUM_ATTR_SUPPORTED] =
       },
 };
 
+/*********************************************************************
+ * Profile Attributes - Descriptor Table
+ */
+
+// Serves reads and writes by attribute index; one entry per attribute
+// record in simpleProfileAttrTbl. The access flags keep the callbacks
+// from serving what the old UUID switch refused, local requests included:
+// characteristic 3 is never read, characteristics 2, 4 and 5 never written.
+static CONST gattAttrDesc_t simpleProfileDescTbl[SERVAPP_NUM_ATTR_SUPPORTED] =
+{
+  GATT_ATTR_DESC_NONE,                                            // Simple Profile Service
+
+    GATT_ATTR_DESC_NONE,                                          // Characteristic 1 Declaration
+      GATT_ATTR_DESC_FIXED( &simpleProfileChar1, 1, SIMPLEPROFILE_CHAR1,
+                            GATT_ATTR_ACCESS_RW ),                // Characteristic Value 1
+      GATT_ATTR_DESC_NONE,                                        // Characteristic 1 User Description
+
+    GATT_ATTR_DESC_NONE,                                          // Characteristic 2 Declaration
+      GATT_ATTR_DESC_FIXED( &simpleProfileChar2, 1, SIMPLEPROFILE_CHAR2,
+                            GATT_ATTR_ACCESS_READ ),              // Characteristic Value 2
+      GATT_ATTR_DESC_NONE,                                        // Characteristic 2 User Description
+
+    GATT_ATTR_DESC_NONE,                                          // Characteristic 3 Declaration
+      GATT_ATTR_DESC_FIXED( &simpleProfileChar3, 1, SIMPLEPROFILE_CHAR3,
+                            GATT_ATTR_ACCESS_WRITE ),             // Characteristic Value 3
+      GATT_ATTR_DESC_NONE,                                        // Characteristic 3 User Description
+
+    GATT_ATTR_DESC_NONE,                                          // Characteristic 4 Declaration
+      GATT_ATTR_DESC_FIXED( &simpleProfileChar4, 1, SIMPLEPROFILE_CHAR4,
+                            GATT_ATTR_ACCESS_READ ),              // Characteristic Value 4
+      GATT_ATTR_DESC_CCC( GATT_CLIENT_CFG_NOTIFY ),               // Characteristic 4 configuration
+      GATT_ATTR_DESC_NONE,                                        // Characteristic 4 User Description
+
+    GATT_ATTR_DESC_NONE,                                          // Characteristic 5 Declaration
+      GATT_ATTR_DESC_FIXED( simpleProfileChar5, SIMPLEPROFILE_CHAR5_LEN,
+                            SIMPLEPROFILE_CHAR5,
+                            GATT_ATTR_ACCESS_READ ),              // Characteristic Value 5
+      GATT_ATTR_DESC_NONE,                                        // Characteristic 5 User Description
+};
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -523,6 +563,100 @@ bStatus_t SimpleProfile_SetParameter( uint8 param, uint8 len, void *value )
   return ( ret );
 }
 
+/*********************************************************************
+ * @fn      SimpleProfile_QueueParameter
+ *
+ * @brief   Set a Simple Profile parameter and queue its notification
+ *          in a batch.
+ *
+ * @param   pBatch - notification batch
+ * @param   param - Profile parameter ID
+ * @param   len - length of data to write
+ * @param   value - pointer to data to write.
+ *
+ * @return  bStatus_t
+ */
+bStatus_t SimpleProfile_QueueParameter( gattNotiBatch_t *pBatch, uint8 param,
+                                        uint8 len, void *value )
+{
+  bStatus_t ret = SUCCESS;
+  switch ( param )
+  {
+    case SIMPLEPROFILE_CHAR4:
+      if ( len == sizeof ( uint8 ) ) 
+      {
+        simpleProfileChar4 = *((uint8*)value);
+        
+        // Notified with the rest of the batch
+        ret = GATTServApp_QueueNoti( pBatch, simpleProfileChar4Config, &simpleProfileChar4,
+                                     FALSE, simpleProfileAttrTbl,
+                                     GATT_NUM_ATTRS( simpleProfileAttrTbl ),
+                                     simpleProfile_ReadAttrCB );
+      }
+      else
+      {
+        ret = bleInvalidRange;
+      }
+      break;
+
+    default:
+      // Only characteristic 4 can be notified
+      ret = INVALIDPARAMETER;
+      break;
+  }
+  
+  return ( ret );
+}
+
+/*********************************************************************
+ * @fn      SimpleProfile_AllocSamples
+ *
+ * @brief   Allocate a Characteristic 4 notification to be filled with
+ *          one byte samples, as long as the link allows.
+ *
+ * @param   connHandle - connection to notify
+ * @param   pNumSamples - set to the number of samples the buffer holds
+ *
+ * @return  buffer, NULL if none is available
+ */
+uint8 *SimpleProfile_AllocSamples( uint16 connHandle, uint16 *pNumSamples )
+{
+  // Sized to fill whole LL packets, see GATTServApp_SetLinkParams()
+  return ( (uint8 *)GATT_bm_alloc( connHandle, ATT_HANDLE_VALUE_NOTI,
+                                   GATTServApp_GetPayloadLen( connHandle ),
+                                   pNumSamples ) );
+}
+
+/*********************************************************************
+ * @fn      SimpleProfile_NotifySamples
+ *
+ * @brief   Notify the samples filled in a buffer from
+ *          SimpleProfile_AllocSamples(). The last sample becomes the
+ *          value of Characteristic 4.
+ *
+ * @param   connHandle - connection to notify
+ * @param   pBuf - buffer from SimpleProfile_AllocSamples(), always
+ *                 sent or freed
+ * @param   numSamples - number of samples in the buffer
+ *
+ * @return  bStatus_t
+ */
+bStatus_t SimpleProfile_NotifySamples( uint16 connHandle, uint8 *pBuf,
+                                       uint16 numSamples )
+{
+  if ( ( pBuf != NULL ) && ( numSamples != 0 ) )
+  {
+    simpleProfileChar4 = pBuf[numSamples - 1];
+  }
+
+  // The samples are sent from the buffer, not read back from the profile
+  return ( GATTServApp_SendNotiBuf( simpleProfileChar4Config, connHandle,
+                                    GATTServApp_FindAttr( simpleProfileAttrTbl,
+                                                          GATT_NUM_ATTRS( simpleProfileAttrTbl ),
+                                                          &simpleProfileChar4 ),
+                                    pBuf, numSamples, FALSE ) );
+}
+
 /*********************************************************************
  * @fn      SimpleProfile_GetParameter
  *
@@ -590,52 +724,22 @@ static bStatus_t simpleProfile_ReadAttrCB(uint16_t connHandle,
                                           uint16_t offset, uint16_t maxLen,
                                           uint8_t method)
 {
-  bStatus_t status = SUCCESS;
-  
-  // Make sure it's not a blob operation (no attributes in the profile are long)
-  if ( offset > 0 )
-  {
-    return ( ATT_ERR_ATTR_NOT_LONG );
-  }
- 
-  if ( pAttr->type.len == ATT_BT_UUID_SIZE )
-  {
-    // 16-bit UUID
-    uint16 uuid = BUILD_UINT16( pAttr->type.uuid[0], pAttr->type.uuid[1]);
-    switch ( uuid )
-    {
-      // No need for "GATT_SERVICE_UUID" or "GATT_CLIENT_CHAR_CFG_UUID" cases;
-      // gattserverapp handles those reads
-
-      // characteristics 1 and 2 have read permissions
-      // characteritisc 3 does not have read permissions; therefore it is not
-      //   included here
-      // characteristic 4 does not have read permissions, but because it
-      //   can be sent as a notification, it is included here
-      case SIMPLEPROFILE_CHAR1_UUID:
-      case SIMPLEPROFILE_CHAR2_UUID:
-      case SIMPLEPROFILE_CHAR4_UUID:
-        *pLen = 1;
-        pValue[0] = *pAttr->pValue;
-        break;
-
-      case SIMPLEPROFILE_CHAR5_UUID:
-        *pLen = SIMPLEPROFILE_CHAR5_LEN;
-        VOID memcpy( pValue, pAttr->pValue, SIMPLEPROFILE_CHAR5_LEN );
-        break;
-        
-      default:
-        // Should never get here! (characteristics 3 and 4 do not have read permissions)
-        *pLen = 0;
-        status = ATT_ERR_ATTR_NOT_FOUND;
-        break;
-    }
-  }
-  else
+  bStatus_t status;
+
+  // No need to handle the service declaration or the client characteristic
+  // configuration; gattserverapp handles those reads. Characteristic 4 has
+  // no read permission but is readable through the table because it can be
+  // sent as a notification.
+  status = GATTServApp_ReadAttrDesc( simpleProfileAttrTbl, simpleProfileDescTbl,
+                                     GATT_NUM_ATTRS( simpleProfileAttrTbl ),
+                                     pAttr, pValue, pLen, offset, maxLen );
+
+  // Tell the application about reads by a peer, not those for notifications
+  if ( ( status == SUCCESS ) && ( method != GATT_LOCAL_READ ) &&
+       simpleProfile_AppCBs && simpleProfile_AppCBs->pfnSimpleProfileRead )
   {
-    // 128-bit UUID
-    *pLen = 0;
-    status = ATT_ERR_INVALID_HANDLE;
+    simpleProfile_AppCBs->pfnSimpleProfileRead(
+      simpleProfileDescTbl[pAttr - simpleProfileAttrTbl].param );
   }
 
   return ( status );
@@ -660,69 +764,18 @@ static bStatus_t simpleProfile_WriteAttrCB(uint16_t connHandle,
                                            uint8_t *pValue, uint16_t len,
                                            uint16_t offset, uint8_t method)
 {
-  bStatus_t status = SUCCESS;
-  uint8 notifyApp = 0xFF;
+  bStatus_t status;
+  uint8 notifyApp;
   
-  if ( pAttr->type.len == ATT_BT_UUID_SIZE )
-  {
-    // 16-bit UUID
-    uint16 uuid = BUILD_UINT16( pAttr->type.uuid[0], pAttr->type.uuid[1]);
-    switch ( uuid )
-    {
-      case SIMPLEPROFILE_CHAR1_UUID:
-      case SIMPLEPROFILE_CHAR3_UUID:
-
-        //Validate the value
-        // Make sure it's not a blob oper
-        if ( offset == 0 )
-        {
-          if ( len != 1 )
-          {
-            status = ATT_ERR_INVALID_VALUE_SIZE;
-          }
-        }
-        else
-        {
-          status = ATT_ERR_ATTR_NOT_LONG;
-        }
-        
-        //Write the value
-        if ( status == SUCCESS )
-        {
-          uint8 *pCurValue = (uint8 *)pAttr->pValue;        
-          *pCurValue = pValue[0];
-
-          if( pAttr->pValue == &simpleProfileChar1 )
-          {
-            notifyApp = SIMPLEPROFILE_CHAR1;        
-          }
-          else
-          {
-            notifyApp = SIMPLEPROFILE_CHAR3;           
-          }
-        }
-             
-        break;
-
-      case GATT_CLIENT_CHAR_CFG_UUID:
-        status = GATTServApp_ProcessCCCWriteReq( connHandle, pAttr, pValue, len,
-                                                 offset, GATT_CLIENT_CFG_NOTIFY );
-        break;
-        
-      default:
-        // Should never get here! (characteristics 2 and 4 do not have write permissions)
-        status = ATT_ERR_ATTR_NOT_FOUND;
-        break;
-    }
-  }
-  else
-  {
-    // 128-bit UUID
-    status = ATT_ERR_INVALID_HANDLE;
-  }
+  // Validate and write the value; only characteristics 1 and 3, and the
+  // configuration of characteristic 4, are writable through the table
+  status = GATTServApp_WriteAttrDesc( connHandle, simpleProfileAttrTbl,
+                                      simpleProfileDescTbl,
+                                      GATT_NUM_ATTRS( simpleProfileAttrTbl ),
+                                      pAttr, pValue, len, offset, &notifyApp );
 
   // If a characteristic value changed then callback function to notify application of change
-  if ( (notifyApp != 0xFF ) && simpleProfile_AppCBs && simpleProfile_AppCBs->pfnSimpleProfileChange )
+  if ( (notifyApp != GATT_ATTR_NO_PARAM ) && simpleProfile_AppCBs && simpleProfile_AppCBs->pfnSimpleProfileChange )
   {
     simpleProfile_AppCBs->pfnSimpleProfileChange( notifyApp );  
   }
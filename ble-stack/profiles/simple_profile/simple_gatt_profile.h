@@ -100,9 +100,14 @@ extern "C"
 // Callback when a characteristic value has changed
 typedef void (*simpleProfileChange_t)( uint8 paramID );
 
+// Callback when a peer has read a characteristic value; called from the
+// stack task
+typedef void (*simpleProfileRead_t)( uint8 paramID );
+
 typedef struct
 {
   simpleProfileChange_t        pfnSimpleProfileChange;  // Called when characteristic value changes
+  simpleProfileRead_t          pfnSimpleProfileRead;    // Called when a peer reads a characteristic value (optional)
 } simpleProfileCBs_t;
 
     
@@ -141,6 +146,43 @@ extern bStatus_t SimpleProfile_RegisterAppCBs( simpleProfileCBs_t *appCallbacks
  *          uint16 pointer).
  */
 extern bStatus_t SimpleProfile_SetParameter( uint8 param, uint8 len, void *value );
+
+/*
+ * SimpleProfile_QueueParameter - Set a Simple GATT Profile parameter and
+ *          queue its notification in a batch instead of sending it right
+ *          away. The batch is sent with GATTServApp_SendNotiBatch().
+ *
+ *    pBatch - notification batch
+ *    param - Profile parameter ID (SIMPLEPROFILE_CHAR4)
+ *    len - length of data to write
+ *    value - pointer to data to write.
+ */
+extern bStatus_t SimpleProfile_QueueParameter( gattNotiBatch_t *pBatch, uint8 param,
+                                               uint8 len, void *value );
+
+/*
+ * SimpleProfile_AllocSamples - Allocate a Characteristic 4 notification
+ *          to be filled in place with one byte samples. The buffer holds
+ *          as many samples as GATTServApp_GetPayloadLen() allows for the
+ *          link, e.g. the payload length reported by the link tuning
+ *          manager.
+ *
+ *    connHandle - connection to notify
+ *    pNumSamples - set to the number of samples the buffer holds
+ */
+extern uint8 *SimpleProfile_AllocSamples( uint16 connHandle, uint16 *pNumSamples );
+
+/*
+ * SimpleProfile_NotifySamples - Notify the samples filled in a buffer
+ *          from SimpleProfile_AllocSamples(), without a copy through the
+ *          read callback. The buffer is always sent or freed.
+ *
+ *    connHandle - connection to notify
+ *    pBuf - buffer from SimpleProfile_AllocSamples()
+ *    numSamples - number of samples in the buffer
+ */
+extern bStatus_t SimpleProfile_NotifySamples( uint16 connHandle, uint8 *pBuf,
+                                              uint16 numSamples );
   
 /*
  * SimpleProfile_GetParameter - Get a Simple GATT Profile parameter.
@@ -81,6 +81,14 @@ bleUserCfg_t user0Cfg = BLE_USER_CFG;
 #include <inc/hw_prcm.h>
 #endif // USE_FPGA
 
+#ifdef CYC_TRACE
+#include "cyc_trace.h"
+#endif // CYC_TRACE
+
+#ifdef CS_PROF
+#include "cs_prof.h"
+#endif // CS_PROF
+
 /*******************************************************************************
  * MACROS
  */
@@ -98,6 +106,13 @@ bleUserCfg_t user0Cfg = BLE_USER_CFG;
   #define SET_RFC_BLE_MODE(mode) HWREG( PRCM_BASE + PRCM_O_RFCMODESEL ) = (mode)
 #endif // USE_FPGA
 
+#ifdef HEAPMGR_TRACE
+// Size of the heap trace snapshot taken on an out of memory assert
+#ifndef HEAP_TRACE_DUMP_SIZE
+  #define HEAP_TRACE_DUMP_SIZE         256
+#endif
+#endif // HEAPMGR_TRACE
+
 /*******************************************************************************
  * TYPEDEFS
  */
@@ -110,6 +125,13 @@ bleUserCfg_t user0Cfg = BLE_USER_CFG;
  * GLOBAL VARIABLES
  */
 
+#ifdef HEAPMGR_TRACE
+// Heap trace snapshot taken on an out of memory assert. Read it out with a
+// debugger and decode it with tools/heapmgr/heaptrace_decode.py.
+uint8_t heapTraceDump[HEAP_TRACE_DUMP_SIZE];
+uint16_t heapTraceDumpLen;
+#endif // HEAPMGR_TRACE
+
 #ifdef CC1350_LAUNCHXL
 #ifdef POWER_SAVING
 // Power Notify Object for wake-up callbacks
@@ -193,6 +215,18 @@ int main()
   Power_setConstraint(PowerCC26XX_IDLE_PD_DISALLOW);
 #endif // POWER_SAVING | USE_FPGA
 
+#ifdef CYC_TRACE
+  /* Start the hot path trace. Read cycTraceBuf out with a debugger, or
+   * send it with CycTrace_drain(), and decode it with
+   * tools/cyctrace/cyctrace_decode.py */
+  CycTrace_init();
+#endif // CYC_TRACE
+
+#ifdef CS_PROF
+  /* Time critical sections. Read the statistics with CsProf_getSite() */
+  CsProf_init();
+#endif // CS_PROF
+
   /* Initialize ICall module */
   ICall_init();
 
@@ -263,6 +297,10 @@ void AssertHandler(uint8 assertCause, uint8 assertSubcause)
     case HAL_ASSERT_CAUSE_OUT_OF_MEMORY:
       Display_print0(dispHandle, 0, 0, "***ERROR***");
       Display_print0(dispHandle, 2, 0, ">> OUT OF MEMORY!");
+#ifdef HEAPMGR_TRACE
+      heapTraceDumpLen = ICall_heapTraceReport(heapTraceDump,
+                                               sizeof(heapTraceDump));
+#endif // HEAPMGR_TRACE
       break;
 
     case HAL_ASSERT_CAUSE_INTERNAL_ERROR:
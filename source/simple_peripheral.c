@@ -75,11 +75,20 @@
 #include "icall_apimsg.h"
 
 #include "util.h"
+#include "cyc_trace.h"
 
 #ifdef USE_RCOSC
 #include "rcosc_calibration.h"
 #endif //USE_RCOSC
 
+#ifdef L2CAP_STREAM
+#include "l2cap_stream.h"
+#endif //L2CAP_STREAM
+
+#ifdef LINK_TUNE
+#include "link_tune.h"
+#endif //LINK_TUNE
+
 #include <ti/mw/display/Display.h>
 #include "board_key.h"
 
@@ -143,6 +152,18 @@
 #define OAD_PACKET_SIZE                       ((OAD_BLOCK_SIZE) + 2)
 #endif // FEATURE_OAD
 
+#ifdef L2CAP_STREAM
+// PSM of the streaming Connection Oriented Channel
+#ifndef SBP_L2CAP_PSM
+#define SBP_L2CAP_PSM                         0x0080
+#endif
+
+// Bytes sent to the peer when it connects a channel, 0 to only receive
+#ifndef SBP_L2CAP_TX_LEN
+#define SBP_L2CAP_TX_LEN                      0
+#endif
+#endif //L2CAP_STREAM
+
 // Task configuration
 #define SBP_TASK_PRIORITY                     1
 
@@ -151,19 +172,107 @@
 #define SBP_TASK_STACK_SIZE                   644
 #endif
 
+// Number of app event messages that can be queued at once
+#ifndef SBP_EVT_POOL_SIZE
+#define SBP_EVT_POOL_SIZE                     8
+#endif
+
+// Max number of stack messages processed per task wakeup
+#ifndef SBP_MSG_BATCH_SIZE
+#define SBP_MSG_BATCH_SIZE                    8
+#endif
+
+// Max number of ATT responses waiting for retransmission, per connection
+#ifndef SBP_ATT_RSP_QUEUE_SIZE
+#define SBP_ATT_RSP_QUEUE_SIZE                4
+#endif
+
+// Controller data buffers available to retransmissions after each connection
+// event
+#ifndef SBP_ATT_RSP_CREDITS
+#ifdef MAX_NUM_PDU
+#define SBP_ATT_RSP_CREDITS                   MAX_NUM_PDU
+#else
+#define SBP_ATT_RSP_CREDITS                   5
+#endif
+#endif
+
+// Max number of connections with ATT responses waiting for retransmission
+#ifndef SBP_ATT_RSP_LINKS
+#ifdef MAX_NUM_BLE_CONNS
+#define SBP_ATT_RSP_LINKS                     MAX_NUM_BLE_CONNS
+#else
+#define SBP_ATT_RSP_LINKS                     1
+#endif
+#endif
+
+// Max number of characteristic updates waiting in the notification batch,
+// per link
+#ifndef SBP_NOTI_BATCH_SIZE
+#define SBP_NOTI_BATCH_SIZE                   4
+#endif
+
+// Max number of links with updates waiting in the notification batch
+#ifndef SBP_NOTI_BATCH_LINKS
+#ifdef MAX_NUM_BLE_CONNS
+#define SBP_NOTI_BATCH_LINKS                  MAX_NUM_BLE_CONNS
+#else
+#define SBP_NOTI_BATCH_LINKS                  1
+#endif
+#endif
+
+// Max number of LL PDUs of notifications submitted per connection at once
+#ifndef SBP_NOTI_BATCH_PDUS
+#ifdef MAX_NUM_PDU
+#define SBP_NOTI_BATCH_PDUS                   MAX_NUM_PDU
+#else
+#define SBP_NOTI_BATCH_PDUS                   5
+#endif
+#endif
+
 // Internal Events for RTOS application
 #define SBP_STATE_CHANGE_EVT                  0x0001
 #define SBP_CHAR_CHANGE_EVT                   0x0002
 #define SBP_PERIODIC_EVT                      0x0004
 #define SBP_CONN_EVT_END_EVT                  0x0008
+#define SBP_LINK_TUNE_EVT                     0x0010
+
+// Connection event notices, one bit per ATT response link from
+// SBP_CONN_EVT_END_EVT up
+#define SBP_CONN_EVT_END_EVTS                 (((1 << SBP_ATT_RSP_LINKS) - 1) \
+                                               * SBP_CONN_EVT_END_EVT)
+
+#if (SBP_ATT_RSP_LINKS < 1) || (SBP_ATT_RSP_LINKS > 12)
+#error "SBP_ATT_RSP_LINKS must be 1 to 12, one notice event bit each"
+#endif
 
 /*********************************************************************
  * TYPEDEFS
  */
 
+// ATT response waiting for retransmission
+typedef struct
+{
+  gattMsgEvent_t *pMsg;    // Response message, as returned by the GATT server
+  uint16_t tries;          // Number of transmission attempts so far
+} sbpAttRsp_t;
+
+// Connection with ATT responses waiting for retransmission. The slot is
+// free while count is 0; its connection event notice is registered
+// otherwise.
+typedef struct
+{
+  uint16_t connHandle;                       // Connection of the responses
+  uint8_t count;                             // Responses waiting
+  uint8_t credits;                           // Sends left until the next
+                                             // connection event
+  sbpAttRsp_t queue[SBP_ATT_RSP_QUEUE_SIZE]; // Responses, in arrival order
+} sbpAttRspLink_t;
+
 // App event passed from profiles.
 typedef struct
 {
+  Queue_Elem _elem; // queue element, must be first.
   appEvtHdr_t hdr;  // event header.
 } sbpEvt_t;
 
@@ -185,12 +294,24 @@ static ICall_EntityID selfEntity;
 static ICall_Semaphore sem;
 
 // Clock instances for internal periodic events.
-static Clock_Struct periodicClock;
+static Util_ClockStruct periodicClock;
 
 // Queue object used for app messages
 static Queue_Struct appMsg;
 static Queue_Handle appMsgQueue;
 
+// Pool of app event messages
+static sbpEvt_t appEvtBuf[SBP_EVT_POOL_SIZE];
+static Queue_Struct appEvt;
+static Queue_Handle appEvtPool;
+
+// Events allocated from the heap because the pool was empty, a hint to
+// raise SBP_EVT_POOL_SIZE, see SimpleBLEPeripheral_getEvtPoolMisses()
+static uint16_t appEvtPoolMisses = 0;
+
+// Stack messages fetched in one wakeup
+static ICall_ServiceMsg stackMsgs[SBP_MSG_BATCH_SIZE];
+
 #if defined(FEATURE_OAD)
 // Event data from OAD profile.
 static Queue_Struct oadQ;
@@ -279,9 +400,29 @@ static uint8_t advertData[] =
 // GAP GATT Attributes
 static uint8_t attDeviceName[GAP_DEVICE_NAME_LEN] = "Simple BLE Peripheral";
 
-// Globals used for ATT Response retransmission
-static gattMsgEvent_t *pAttRsp = NULL;
-static uint8_t rspTxRetry = 0;
+// Globals used for ATT Response retransmission, one queue per connection
+static sbpAttRspLink_t attRspLinks[SBP_ATT_RSP_LINKS];
+
+// Retry count histogram of the responses sent, and number of responses
+// dropped, see SimpleBLEPeripheral_getAttRspStats()
+static uint16_t attRspHist[SBP_ATT_RSP_HIST_SIZE];
+static uint16_t attRspDropped = 0;
+
+// Connection of the peripheral role, valid while connected
+static uint16_t activeConnHandle = INVALID_CONNHANDLE;
+
+#ifndef FEATURE_OAD_ONCHIP
+// Characteristic updates waiting to be notified
+static gattNotiBatchLink_t notiBatchLinks[SBP_NOTI_BATCH_LINKS];
+static gattNotiBatchItem_t notiBatchItems[SBP_NOTI_BATCH_LINKS *
+                                          SBP_NOTI_BATCH_SIZE];
+static gattNotiBatch_t notiBatch;
+#endif //!FEATURE_OAD_ONCHIP
+
+#ifdef L2CAP_STREAM
+// Last streaming channel established
+static uint16_t streamCID = L2CAP_CID_NULL;
+#endif //L2CAP_STREAM
 
 /*********************************************************************
  * LOCAL FUNCTIONS
@@ -298,15 +439,35 @@ static void SimpleBLEPeripheral_processCharValueChangeEvt(uint8_t paramID);
 static void SimpleBLEPeripheral_performPeriodicTask(void);
 static void SimpleBLEPeripheral_clockHandler(UArg arg);
 
-static void SimpleBLEPeripheral_sendAttRsp(void);
-static void SimpleBLEPeripheral_freeAttRsp(uint8_t status);
+static sbpAttRspLink_t *SimpleBLEPeripheral_findAttRspLink(uint16_t connHandle);
+static void SimpleBLEPeripheral_sendAttRsp(uint8_t link);
+static uint8_t SimpleBLEPeripheral_queueAttRsp(gattMsgEvent_t *pMsg);
+static void SimpleBLEPeripheral_freeAttRsp(sbpAttRspLink_t *pLink,
+                                           uint8_t status);
+static void SimpleBLEPeripheral_flushAttRsp(uint16_t connHandle, uint8_t status);
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+static void SimpleBLEPeripheral_reportBacklog(void);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 
 static void SimpleBLEPeripheral_stateChangeCB(gaprole_States_t newState);
 #ifndef FEATURE_OAD_ONCHIP
 static void SimpleBLEPeripheral_charValueChangeCB(uint8_t paramID);
+static void SimpleBLEPeripheral_charValueReadCB(uint8_t paramID);
 #endif //!FEATURE_OAD_ONCHIP
 static void SimpleBLEPeripheral_enqueueMsg(uint8_t event, uint8_t state);
 
+#ifdef LINK_TUNE
+static void SimpleBLEPeripheral_linkTuneCB(uint16 connHandle,
+                                           uint16 payloadLen);
+#endif //LINK_TUNE
+
+#ifdef L2CAP_STREAM
+static uint16 SimpleBLEPeripheral_streamRead(uint16 CID, uint32 offset,
+                                             uint8 *pBuf, uint16 len);
+static void SimpleBLEPeripheral_streamDone(uint16 CID, uint8 status,
+                                           uint32 len);
+#endif //L2CAP_STREAM
+
 #ifdef FEATURE_OAD
 void SimpleBLEPeripheral_processOadWriteCB(uint8_t event, uint16_t connHandle,
                                            uint8_t *pData);
@@ -334,7 +495,8 @@ static gapBondCBs_t simpleBLEPeripheral_BondMgrCBs =
 #ifndef FEATURE_OAD_ONCHIP
 static simpleProfileCBs_t SimpleBLEPeripheral_simpleProfileCBs =
 {
-  SimpleBLEPeripheral_charValueChangeCB // Characteristic value change callback
+  SimpleBLEPeripheral_charValueChangeCB, // Characteristic value change callback
+  SimpleBLEPeripheral_charValueReadCB    // Characteristic value read callback
 };
 #endif //!FEATURE_OAD_ONCHIP
 
@@ -345,6 +507,16 @@ static oadTargetCBs_t simpleBLEPeripheral_oadCBs =
 };
 #endif //FEATURE_OAD
 
+#ifdef L2CAP_STREAM
+// L2CAP streaming callbacks, received data is only counted
+static const l2capStreamCBs_t simpleBLEPeripheral_streamCBs =
+{
+  SimpleBLEPeripheral_streamRead, // Data source
+  NULL,                           // Data sink
+  SimpleBLEPeripheral_streamDone  // Transfer done
+};
+#endif //L2CAP_STREAM
+
 /*********************************************************************
  * PUBLIC FUNCTIONS
  */
@@ -371,6 +543,39 @@ void SimpleBLEPeripheral_createTask(void)
   Task_construct(&sbpTask, SimpleBLEPeripheral_taskFxn, &taskParams, NULL);
 }
 
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_getEvtPoolMisses
+ *
+ * @brief   Get the number of app events allocated from the heap because
+ *          the event pool was empty.
+ *
+ * @param   none
+ *
+ * @return  Number of events, a hint to raise SBP_EVT_POOL_SIZE.
+ */
+uint16_t SimpleBLEPeripheral_getEvtPoolMisses(void)
+{
+  return (appEvtPoolMisses);
+}
+
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_getAttRspStats
+ *
+ * @brief   Get the retransmission statistics of ATT responses.
+ *
+ * @param   pHist - filled with the number of responses sent, by try count:
+ *                  1, 2, 3-4, 5-8, ... tries (SBP_ATT_RSP_HIST_SIZE
+ *                  buckets)
+ *
+ * @return  Number of responses dropped.
+ */
+uint16_t SimpleBLEPeripheral_getAttRspStats(uint16_t *pHist)
+{
+  memcpy(pHist, attRspHist, sizeof(attRspHist));
+
+  return (attRspDropped);
+}
+
 /*********************************************************************
  * @fn      SimpleBLEPeripheral_init
  *
@@ -385,6 +590,9 @@ void SimpleBLEPeripheral_createTask(void)
  */
 static void SimpleBLEPeripheral_init(void)
 {
+  // Stack setup calls that failed, or could not be sent
+  uint8_t setupFailures = 0;
+
   // ******************************************************************
   // N0 STACK API CALLS CAN OCCUR BEFORE THIS CALL TO ICall_registerApp
   // ******************************************************************
@@ -417,6 +625,10 @@ static void SimpleBLEPeripheral_init(void)
   // Create an RTOS queue for message from profile to be sent to app.
   appMsgQueue = Util_constructQueue(&appMsg);
 
+  // Create the pool the app event messages are taken from.
+  appEvtPool = Util_constructPool(&appEvt, appEvtBuf, sizeof(sbpEvt_t),
+                                  SBP_EVT_POOL_SIZE);
+
   // Create one-shot clocks for internal periodic events.
   Util_constructClock(&periodicClock, SimpleBLEPeripheral_clockHandler,
                       SBP_PERIODIC_EVT_PERIOD, 0, false, SBP_PERIODIC_EVT);
@@ -462,19 +674,16 @@ static void SimpleBLEPeripheral_init(void)
                          &desiredSlaveLatency);
     GAPRole_SetParameter(GAPROLE_TIMEOUT_MULTIPLIER, sizeof(uint16_t),
                          &desiredConnTimeout);
-  }
-
-  // Set the GAP Characteristics
-  GGS_SetParameter(GGS_DEVICE_NAME_ATT, GAP_DEVICE_NAME_LEN, attDeviceName);
 
-  // Set advertising interval
-  {
-    uint16_t advInt = DEFAULT_ADVERTISING_INTERVAL;
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+    {
+      uint8_t enableAdaptive = TRUE;
 
-    GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MIN, advInt);
-    GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MAX, advInt);
-    GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MIN, advInt);
-    GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MAX, advInt);
+      // Switch between the GAP Role's fast and slow profiles with traffic
+      GAPRole_SetParameter(GAPROLE_ADAPTIVE_ENABLE, sizeof(uint8_t),
+                           &enableAdaptive);
+    }
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
   }
 
   // Setup the GAP Bond Manager
@@ -493,13 +702,38 @@ static void SimpleBLEPeripheral_init(void)
     GAPBondMgr_SetParameter(GAPBOND_BONDING_ENABLED, sizeof(uint8_t), &bonding);
   }
 
-   // Initialize GATT attributes
-  GGS_AddService(GATT_ALL_SERVICES);           // GAP
-  GATTServApp_AddService(GATT_ALL_SERVICES);   // GATT attributes
-  DevInfo_AddService();                        // Device Information Service
+#ifdef ICALL_API_ASYNC
+  // Pipeline the stack commands below rather than waiting for each one. Their
+  // arguments are static or passed by value, so they outlive the call.
+  ICall_apiSetAsync(TRUE);
+#endif // ICALL_API_ASYNC
+
+  // Set the GAP Characteristics
+  setupFailures += (GGS_SetParameter(GGS_DEVICE_NAME_ATT, GAP_DEVICE_NAME_LEN,
+                                     attDeviceName) != SUCCESS);
+
+  // Set advertising interval
+  {
+    uint16_t advInt = DEFAULT_ADVERTISING_INTERVAL;
+
+    setupFailures += (GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MIN,
+                                        advInt) != SUCCESS);
+    setupFailures += (GAP_SetParamValue(TGAP_LIM_DISC_ADV_INT_MAX,
+                                        advInt) != SUCCESS);
+    setupFailures += (GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MIN,
+                                        advInt) != SUCCESS);
+    setupFailures += (GAP_SetParamValue(TGAP_GEN_DISC_ADV_INT_MAX,
+                                        advInt) != SUCCESS);
+  }
+
+   // Initialize GATT attributes: GAP, GATT and Device Information Service
+  setupFailures += (GGS_AddService(GATT_ALL_SERVICES) != SUCCESS);
+  setupFailures += (GATTServApp_AddService(GATT_ALL_SERVICES) != SUCCESS);
+  setupFailures += (DevInfo_AddService() != SUCCESS);
 
 #ifndef FEATURE_OAD_ONCHIP
-  SimpleProfile_AddService(GATT_ALL_SERVICES); // Simple GATT Profile
+  // Simple GATT Profile
+  setupFailures += (SimpleProfile_AddService(GATT_ALL_SERVICES) != SUCCESS);
 #endif //!FEATURE_OAD_ONCHIP
 
 #ifdef FEATURE_OAD
@@ -512,6 +746,15 @@ static void SimpleBLEPeripheral_init(void)
   Reset_addService();
 #endif //IMAGE_INVALIDATE
 
+#ifdef ICALL_API_ASYNC
+  // Command statuses are received in the task loop
+  ICall_apiSetAsync(FALSE);
+#endif // ICALL_API_ASYNC
+
+  if (setupFailures != 0)
+  {
+    Display_print1(dispHandle, 5, 0, "Setup calls failed: %d", setupFailures);
+  }
 
 #ifndef FEATURE_OAD_ONCHIP
   // Setup the SimpleProfile Characteristic Values
@@ -536,6 +779,9 @@ static void SimpleBLEPeripheral_init(void)
 
   // Register callback with SimpleGATTprofile
   SimpleProfile_RegisterAppCBs(&SimpleBLEPeripheral_simpleProfileCBs);
+
+  GATTServApp_InitNotiBatch(&notiBatch, notiBatchLinks, SBP_NOTI_BATCH_LINKS,
+                            notiBatchItems, SBP_NOTI_BATCH_SIZE);
 #endif //!FEATURE_OAD_ONCHIP
 
   // Start the Device
@@ -550,8 +796,21 @@ static void SimpleBLEPeripheral_init(void)
   // Register for GATT local events and ATT Responses pending for transmission
   GATT_RegisterForMsgs(selfEntity);
 
+#ifdef L2CAP_STREAM
+  // Accept streaming Connection Oriented Channels
+  L2CAPStream_register(selfEntity, SBP_L2CAP_PSM,
+                       &simpleBLEPeripheral_streamCBs);
+#endif //L2CAP_STREAM
+
   HCI_LE_ReadMaxDataLenCmd();
 
+#ifdef LINK_TUNE
+  // Negotiate data length and MTU of new connections
+  LinkTune_init(selfEntity, SimpleBLEPeripheral_clockHandler,
+                SBP_LINK_TUNE_EVT);
+  LinkTune_register(SimpleBLEPeripheral_linkTuneCB);
+#endif //LINK_TUNE
+
 #if defined FEATURE_OAD
 #if defined (HAL_IMAGE_A)
   Display_print0(dispHandle, 0, 0, "BLE Peripheral A");
@@ -588,32 +847,56 @@ static void SimpleBLEPeripheral_taskFxn(UArg a0, UArg a1)
 
     if (errno == ICALL_ERRNO_SUCCESS)
     {
-      ICall_EntityID dest;
-      ICall_ServiceEnum src;
-      ICall_HciExtEvt *pMsg = NULL;
+      uint_least8_t numMsgs;
+      uint_least8_t i;
 
-      if (ICall_fetchServiceMsg(&src, &dest,
-                                (void **)&pMsg) == ICALL_ERRNO_SUCCESS)
+      // Fetch all queued stack messages (up to the batch size) at once so
+      // that a burst of messages is handled with a single wakeup.
+      if (ICall_fetchServiceMsgBatch(stackMsgs, SBP_MSG_BATCH_SIZE,
+                                     &numMsgs) != ICALL_ERRNO_SUCCESS)
       {
+        numMsgs = 0;
+      }
+
+      for (i = 0; i < numMsgs; i++)
+      {
+        ICall_HciExtEvt *pMsg = (ICall_HciExtEvt *)stackMsgs[i].msg;
         uint8 safeToDealloc = TRUE;
 
-        if ((src == ICALL_SERVICE_CLASS_BLE) && (dest == selfEntity))
+        if ((stackMsgs[i].src == ICALL_SERVICE_CLASS_BLE) &&
+            (stackMsgs[i].dest == selfEntity))
         {
           ICall_Stack_Event *pEvt = (ICall_Stack_Event *)pMsg;
 
           // Check for BLE stack events first
           if (pEvt->signature == 0xffff)
           {
-            if (pEvt->event_flag & SBP_CONN_EVT_END_EVT)
+            if (pEvt->event_flag & SBP_CONN_EVT_END_EVTS)
             {
-              // Try to retransmit pending ATT Response (if any)
-              SimpleBLEPeripheral_sendAttRsp();
+              uint8_t link;
+
+              // Try to retransmit the pending ATT Responses of the
+              // connections whose event ended
+              for (link = 0; link < SBP_ATT_RSP_LINKS; link++)
+              {
+                if (pEvt->event_flag & (SBP_CONN_EVT_END_EVT << link))
+                {
+                  SimpleBLEPeripheral_sendAttRsp(link);
+                }
+              }
+
+#ifdef L2CAP_STREAM
+              // And SDUs that found no buffer
+              L2CAPStream_resume();
+#endif //L2CAP_STREAM
             }
           }
           else
           {
             // Process inter-task message
+            CYC_TRACE_BEGIN(CYC_TRACE_APP_STACK_MSG);
             safeToDealloc = SimpleBLEPeripheral_processStackMsg((ICall_Hdr *)pMsg);
+            CYC_TRACE_END(CYC_TRACE_APP_STACK_MSG);
           }
         }
 
@@ -626,14 +909,21 @@ static void SimpleBLEPeripheral_taskFxn(UArg a0, UArg a1)
       // If RTOS queue is not empty, process app message.
       while (!Queue_empty(appMsgQueue))
       {
-        sbpEvt_t *pMsg = (sbpEvt_t *)Util_dequeueMsg(appMsgQueue);
+        sbpEvt_t *pMsg = (sbpEvt_t *)Util_dequeuePoolMsg(appMsgQueue);
         if (pMsg)
         {
           // Process message.
           SimpleBLEPeripheral_processAppMsg(pMsg);
 
-          // Free the space from the message.
-          ICall_free(pMsg);
+          // Return the message to its pool, or to the heap.
+          if (pMsg >= appEvtBuf && pMsg < &appEvtBuf[SBP_EVT_POOL_SIZE])
+          {
+            Util_poolFree(appEvtPool, pMsg);
+          }
+          else
+          {
+            ICall_free(pMsg);
+          }
         }
       }
     }
@@ -648,6 +938,16 @@ static void SimpleBLEPeripheral_taskFxn(UArg a0, UArg a1)
       SimpleBLEPeripheral_performPeriodicTask();
     }
 
+#ifdef LINK_TUNE
+    if (events & SBP_LINK_TUNE_EVT)
+    {
+      events &= ~SBP_LINK_TUNE_EVT;
+
+      // Report links the peer did not tune in time
+      LinkTune_processTimeout();
+    }
+#endif //LINK_TUNE
+
 #ifdef FEATURE_OAD
     while (!Queue_empty(hOadQ))
     {
@@ -691,8 +991,39 @@ static uint8_t SimpleBLEPeripheral_processStackMsg(ICall_Hdr *pMsg)
       safeToDealloc = SimpleBLEPeripheral_processGATTMsg((gattMsgEvent_t *)pMsg);
       break;
 
+#ifdef L2CAP_STREAM
+    case L2CAP_SIGNAL_EVENT:
+    case L2CAP_DATA_EVENT:
+      if (L2CAPStream_processStackMsg((osal_event_hdr_t *)pMsg) &&
+          (pMsg->event == L2CAP_SIGNAL_EVENT))
+      {
+        l2capSignalEvent_t *pSignal = (l2capSignalEvent_t *)pMsg;
+
+        if (pSignal->opcode == L2CAP_CHANNEL_ESTABLISHED_EVT)
+        {
+          streamCID = pSignal->cmd.channelEstEvt.CID;
+
+          if (SBP_L2CAP_TX_LEN > 0)
+          {
+            L2CAPStream_send(streamCID, SBP_L2CAP_TX_LEN);
+          }
+        }
+        else if ((pSignal->opcode == L2CAP_CHANNEL_TERMINATED_EVT) &&
+                 (pSignal->cmd.channelTermEvt.CID == streamCID))
+        {
+          streamCID = L2CAP_CID_NULL;
+        }
+      }
+      break;
+#endif //L2CAP_STREAM
+
     case HCI_GAP_EVENT_EVENT:
       {
+#ifdef LINK_TUNE
+        // LE Data Length Change
+        LinkTune_processStackMsg((osal_event_hdr_t *)pMsg);
+#endif //LINK_TUNE
+
         // Process HCI message
         switch(pMsg->status)
         {
@@ -706,6 +1037,33 @@ static uint8_t SimpleBLEPeripheral_processStackMsg(ICall_Hdr *pMsg)
       }
       break;
 
+#ifdef ICALL_API_ASYNC
+    case ICALL_EVENT_EVENT:
+      {
+        ICall_ApiCmdDone done;
+
+        // Completion of a command sent in asynchronous mode
+        if (!ICall_apiCmdStatus(pMsg, &done))
+        {
+          break;
+        }
+
+#ifdef L2CAP_STREAM
+        if (L2CAPStream_processCmdStatus(done.token, done.status))
+        {
+          break;
+        }
+#endif //L2CAP_STREAM
+
+        if (done.status != SUCCESS)
+        {
+          Display_print2(dispHandle, 5, 0, "Cmd %04x failed: %d", done.opCode,
+                         done.status);
+        }
+      }
+      break;
+#endif // ICALL_API_ASYNC
+
     default:
       // do nothing
       break;
@@ -723,23 +1081,24 @@ static uint8_t SimpleBLEPeripheral_processStackMsg(ICall_Hdr *pMsg)
  */
 static uint8_t SimpleBLEPeripheral_processGATTMsg(gattMsgEvent_t *pMsg)
 {
+#ifdef LINK_TUNE
+  // ATT MTU updates
+  LinkTune_processStackMsg(&pMsg->hdr);
+#endif //LINK_TUNE
+
   // See if GATT server was unable to transmit an ATT response
   if (pMsg->hdr.status == blePending)
   {
     // No HCI buffer was available. Let's try to retransmit the response
-    // on the next connection event.
-    if (HCI_EXT_ConnEventNoticeCmd(pMsg->connHandle, selfEntity,
-                                   SBP_CONN_EVT_END_EVT) == SUCCESS)
+    // once buffers are freed at the end of a connection event, holding
+    // on to the response message in the queue of its connection.
+    if (SimpleBLEPeripheral_queueAttRsp(pMsg))
     {
-      // First free any pending response
-      SimpleBLEPeripheral_freeAttRsp(FAILURE);
-
-      // Hold on to the response message for retransmission
-      pAttRsp = pMsg;
-
       // Don't free the response message yet
       return (FALSE);
     }
+
+    attRspDropped++;
   }
   else if (pMsg->method == ATT_FLOW_CTRL_VIOLATED_EVENT)
   {
@@ -752,8 +1111,10 @@ static uint8_t SimpleBLEPeripheral_processGATTMsg(gattMsgEvent_t *pMsg)
   }
   else if (pMsg->method == ATT_MTU_UPDATED_EVENT)
   {
-    // MTU size updated
-    Display_print1(dispHandle, 5, 0, "MTU Size: $d", pMsg->msg.mtuEvt.MTU);
+    // MTU size updated; notification values are sized with it
+    GATTServApp_SetLinkMTU(pMsg->connHandle, pMsg->msg.mtuEvt.MTU);
+
+    Display_print1(dispHandle, 5, 0, "MTU Size: %d", pMsg->msg.mtuEvt.MTU);
   }
 
   // Free message payload. Needed only for ATT Protocol messages
@@ -763,79 +1124,245 @@ static uint8_t SimpleBLEPeripheral_processGATTMsg(gattMsgEvent_t *pMsg)
   return (TRUE);
 }
 
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_findAttRspLink
+ *
+ * @brief   Find the retransmission queue of a connection.
+ *
+ * @param   connHandle - connection of the responses
+ *
+ * @return  Queue of the connection, NULL if no response of it is pending.
+ */
+static sbpAttRspLink_t *SimpleBLEPeripheral_findAttRspLink(uint16_t connHandle)
+{
+  uint8_t link;
+
+  for (link = 0; link < SBP_ATT_RSP_LINKS; link++)
+  {
+    if ((attRspLinks[link].count > 0) &&
+        (attRspLinks[link].connHandle == connHandle))
+    {
+      return (&attRspLinks[link]);
+    }
+  }
+
+  return (NULL);
+}
+
 /*********************************************************************
  * @fn      SimpleBLEPeripheral_sendAttRsp
  *
- * @brief   Send a pending ATT response message.
+ * @brief   Send the pending ATT response messages of a connection in
+ *          arrival order, while its controller buffers are available.
+ *          The responses of other connections wait for their own
+ *          connection events.
  *
- * @param   none
+ * @param   link - index of the connection in attRspLinks
  *
  * @return  none
  */
-static void SimpleBLEPeripheral_sendAttRsp(void)
+static void SimpleBLEPeripheral_sendAttRsp(uint8_t link)
 {
-  // See if there's a pending ATT Response to be transmitted
-  if (pAttRsp != NULL)
+  sbpAttRspLink_t *pLink = &attRspLinks[link];
+
+  // Buffers freed by the connection event that just ended. Stop at the
+  // first send that fails: the next one would fail as well.
+  pLink->credits = SBP_ATT_RSP_CREDITS;
+
+  while ((pLink->count > 0) && (pLink->credits > 0))
   {
+    gattMsgEvent_t *pMsg = pLink->queue[0].pMsg;
     uint8_t status;
 
     // Increment retransmission count
-    rspTxRetry++;
+    pLink->queue[0].tries++;
+    pLink->credits--;
 
     // Try to retransmit ATT response till either we're successful or
     // the ATT Client times out (after 30s) and drops the connection.
-    status = GATT_SendRsp(pAttRsp->connHandle, pAttRsp->method, &(pAttRsp->msg));
+    status = GATT_SendRsp(pMsg->connHandle, pMsg->method, &(pMsg->msg));
     if ((status != blePending) && (status != MSG_BUFFER_NOT_AVAIL))
     {
-      // Disable connection event end notice
-      HCI_EXT_ConnEventNoticeCmd(pAttRsp->connHandle, selfEntity, 0);
-
       // We're done with the response message
-      SimpleBLEPeripheral_freeAttRsp(status);
+      SimpleBLEPeripheral_freeAttRsp(pLink, status);
     }
     else
     {
-      // Continue retrying
-      Display_print1(dispHandle, 5, 0, "Rsp send retry: %d", rspTxRetry);
+      // Continue retrying after the next connection event
+      Display_print1(dispHandle, 5, 0, "Rsp send retry: %d",
+                     pLink->queue[0].tries);
+      pLink->credits = 0;
     }
   }
 }
 
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_queueAttRsp
+ *
+ * @brief   Queue an ATT response message for retransmission behind the
+ *          other responses of its connection. The first response of a
+ *          connection registers its connection event notice.
+ *
+ * @param   pMsg - response message the GATT server failed to send
+ *
+ * @return  TRUE if queued, FALSE if the queue of the connection is full
+ *          or no connection event notice is available for it.
+ */
+static uint8_t SimpleBLEPeripheral_queueAttRsp(gattMsgEvent_t *pMsg)
+{
+  sbpAttRspLink_t *pLink = SimpleBLEPeripheral_findAttRspLink(pMsg->connHandle);
+
+  if (pLink == NULL)
+  {
+    uint8_t link;
+
+    // Take a free slot, with the notice event bit of the slot
+    for (link = 0; link < SBP_ATT_RSP_LINKS; link++)
+    {
+      if (attRspLinks[link].count == 0)
+      {
+        break;
+      }
+    }
+
+    if ((link == SBP_ATT_RSP_LINKS) ||
+        (HCI_EXT_ConnEventNoticeCmd(pMsg->connHandle, selfEntity,
+                                    SBP_CONN_EVT_END_EVT << link) != SUCCESS))
+    {
+      // No way to learn when buffers are freed for this connection
+      return (FALSE);
+    }
+
+    pLink = &attRspLinks[link];
+    pLink->connHandle = pMsg->connHandle;
+  }
+  else if (pLink->count == SBP_ATT_RSP_QUEUE_SIZE)
+  {
+    return (FALSE);
+  }
+
+  pLink->queue[pLink->count].pMsg = pMsg;
+  pLink->queue[pLink->count].tries = 1;
+  pLink->count++;
+
+  // The GATT server just found no buffer for this connection
+  pLink->credits = 0;
+
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+  // A response backlog means the link is too slow for the traffic
+  SimpleBLEPeripheral_reportBacklog();
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
+  return (TRUE);
+}
+
 /*********************************************************************
  * @fn      SimpleBLEPeripheral_freeAttRsp
  *
- * @brief   Free ATT response message.
+ * @brief   Free the oldest ATT response message of a connection. The
+ *          connection event notice is disabled with the last one.
  *
+ * @param   pLink - retransmission queue of the connection
  * @param   status - response transmit status
  *
  * @return  none
  */
-static void SimpleBLEPeripheral_freeAttRsp(uint8_t status)
+static void SimpleBLEPeripheral_freeAttRsp(sbpAttRspLink_t *pLink,
+                                           uint8_t status)
 {
-  // See if there's a pending ATT response message
-  if (pAttRsp != NULL)
+  gattMsgEvent_t *pMsg = pLink->queue[0].pMsg;
+  uint16_t tries = pLink->queue[0].tries;
+
+  // See if the response was sent out successfully
+  if (status == SUCCESS)
   {
-    // See if the response was sent out successfully
-    if (status == SUCCESS)
+    uint8_t bucket = 0;
+
+    // Retry count histogram: 1, 2, 3-4, 5-8, ... tries
+    while ((((tries - 1) >> bucket) != 0) &&
+           (bucket < SBP_ATT_RSP_HIST_SIZE - 1))
     {
-      Display_print1(dispHandle, 5, 0, "Rsp sent retry: %d", rspTxRetry);
+      bucket++;
     }
-    else
-    {
-      // Free response payload
-      GATT_bm_free(&pAttRsp->msg, pAttRsp->method);
+    attRspHist[bucket]++;
 
-      Display_print1(dispHandle, 5, 0, "Rsp retry failed: %d", rspTxRetry);
-    }
+    Display_print1(dispHandle, 5, 0, "Rsp sent retry: %d", tries);
+  }
+  else
+  {
+    // Free response payload
+    GATT_bm_free(&pMsg->msg, pMsg->method);
 
-    // Free response message
-    ICall_freeMsg(pAttRsp);
+    attRspDropped++;
 
-    // Reset our globals
-    pAttRsp = NULL;
-    rspTxRetry = 0;
+    Display_print1(dispHandle, 5, 0, "Rsp retry failed: %d", tries);
   }
+
+  // Free response message
+  ICall_freeMsg(pMsg);
+
+  // Keep the queue in arrival order
+  pLink->count--;
+  memmove(&pLink->queue[0], &pLink->queue[1],
+          pLink->count * sizeof(sbpAttRsp_t));
+
+  if (pLink->count == 0)
+  {
+    // Disable connection event end notice
+    HCI_EXT_ConnEventNoticeCmd(pLink->connHandle, selfEntity, 0);
+  }
+}
+
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_flushAttRsp
+ *
+ * @brief   Free the pending ATT response messages of a connection. The
+ *          responses of other connections stay queued.
+ *
+ * @param   connHandle - connection whose responses are freed
+ * @param   status - response transmit status
+ *
+ * @return  none
+ */
+static void SimpleBLEPeripheral_flushAttRsp(uint16_t connHandle, uint8_t status)
+{
+  sbpAttRspLink_t *pLink = SimpleBLEPeripheral_findAttRspLink(connHandle);
+
+  while ((pLink != NULL) && (pLink->count > 0))
+  {
+    SimpleBLEPeripheral_freeAttRsp(pLink, status);
+  }
+}
+
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_reportBacklog
+ *
+ * @brief   Report the ATT responses and notifications waiting for the
+ *          link to the adaptive connection parameter controller. Each
+ *          one is counted as a full ATT_MTU_SIZE PDU.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void SimpleBLEPeripheral_reportBacklog(void)
+{
+  uint16_t pending = 0;
+  uint8_t link;
+
+  for (link = 0; link < SBP_ATT_RSP_LINKS; link++)
+  {
+    pending += attRspLinks[link].count;
+  }
+
+#ifndef FEATURE_OAD_ONCHIP
+  pending += notiBatch.numItems;
+#endif //!FEATURE_OAD_ONCHIP
+
+  GAPRole_ReportTraffic(pending * ATT_MTU_SIZE, 0);
 }
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
 
 /*********************************************************************
  * @fn      SimpleBLEPeripheral_processAppMsg
@@ -952,7 +1479,11 @@ static void SimpleBLEPeripheral_processStateChangeEvt(gaprole_States_t newState)
         // Reset flag for next connection.
         firstConnFlag = false;
 
-        SimpleBLEPeripheral_freeAttRsp(bleNotConnected);
+        if (activeConnHandle != INVALID_CONNHANDLE)
+        {
+          SimpleBLEPeripheral_flushAttRsp(activeConnHandle, bleNotConnected);
+          activeConnHandle = INVALID_CONNHANDLE;
+        }
       }
       break;
 #endif //PLUS_BROADCASTER
@@ -964,6 +1495,12 @@ static void SimpleBLEPeripheral_processStateChangeEvt(gaprole_States_t newState)
 
         Util_startClock(&periodicClock);
 
+        GAPRole_GetParameter(GAPROLE_CONNHANDLE, &activeConnHandle);
+
+#ifdef LINK_TUNE
+        LinkTune_connected(activeConnHandle);
+#endif //LINK_TUNE
+
         numActive = linkDB_NumActive();
 
         // Use numActive to determine the connection handle of the last
@@ -1013,7 +1550,14 @@ static void SimpleBLEPeripheral_processStateChangeEvt(gaprole_States_t newState)
 
     case GAPROLE_WAITING:
       Util_stopClock(&periodicClock);
-      SimpleBLEPeripheral_freeAttRsp(bleNotConnected);
+      SimpleBLEPeripheral_flushAttRsp(activeConnHandle, bleNotConnected);
+      GATTServApp_SetLinkMTU(activeConnHandle, 0);
+
+#ifdef LINK_TUNE
+      LinkTune_disconnected(activeConnHandle);
+      GATTServApp_SetLinkParams(activeConnHandle, 0, 0);
+#endif //LINK_TUNE
+      activeConnHandle = INVALID_CONNHANDLE;
 
       Display_print0(dispHandle, 2, 0, "Disconnected");
 
@@ -1022,7 +1566,14 @@ static void SimpleBLEPeripheral_processStateChangeEvt(gaprole_States_t newState)
       break;
 
     case GAPROLE_WAITING_AFTER_TIMEOUT:
-      SimpleBLEPeripheral_freeAttRsp(bleNotConnected);
+      SimpleBLEPeripheral_flushAttRsp(activeConnHandle, bleNotConnected);
+      GATTServApp_SetLinkMTU(activeConnHandle, 0);
+
+#ifdef LINK_TUNE
+      LinkTune_disconnected(activeConnHandle);
+      GATTServApp_SetLinkParams(activeConnHandle, 0, 0);
+#endif //LINK_TUNE
+      activeConnHandle = INVALID_CONNHANDLE;
 
       Display_print0(dispHandle, 2, 0, "Timed Out");
 
@@ -1063,6 +1614,24 @@ static void SimpleBLEPeripheral_charValueChangeCB(uint8_t paramID)
 {
   SimpleBLEPeripheral_enqueueMsg(SBP_CHAR_CHANGE_EVT, paramID);
 }
+
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_charValueReadCB
+ *
+ * @brief   Callback from Simple Profile indicating a characteristic
+ *          value read by the peer. Called from the stack task.
+ *
+ * @param   paramID - parameter ID of the value that was read.
+ *
+ * @return  None.
+ */
+static void SimpleBLEPeripheral_charValueReadCB(uint8_t paramID)
+{
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+  // Reads are requests from the peer as much as writes are
+  GAPRole_ReportTraffic(0, 1);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+}
 #endif //!FEATURE_OAD_ONCHIP
 
 /*********************************************************************
@@ -1080,6 +1649,11 @@ static void SimpleBLEPeripheral_processCharValueChangeEvt(uint8_t paramID)
 #ifndef FEATURE_OAD_ONCHIP
   uint8_t newValue;
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+  // Each characteristic change is a write request from the peer
+  GAPRole_ReportTraffic(0, 1);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
   switch(paramID)
   {
     case SIMPLEPROFILE_CHAR1:
@@ -1124,14 +1698,128 @@ static void SimpleBLEPeripheral_performPeriodicTask(void)
   {
     // Call to set that value of the fourth characteristic in the profile.
     // Note that if notifications of the fourth characteristic have been
-    // enabled by a GATT client device, then a notification will be sent
+    // enabled by a GATT client device, then a notification is queued
     // every time this function is called.
-    SimpleProfile_SetParameter(SIMPLEPROFILE_CHAR4, sizeof(uint8_t),
-                               &valueToCopy);
+    SimpleProfile_QueueParameter(&notiBatch, SIMPLEPROFILE_CHAR4,
+                                 sizeof(uint8_t), &valueToCopy);
   }
+
+  // Send what the link takes now; updates left over stay queued in order
+  GATTServApp_SendNotiBatch(&notiBatch, SBP_NOTI_BATCH_PDUS);
 #endif //!FEATURE_OAD_ONCHIP
+
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+  // Notifications the link did not take count as backlog
+  SimpleBLEPeripheral_reportBacklog();
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
+  {
+    uint16_t sent = 0;
+    uint8_t i;
+
+    for (i = 0; i < SBP_ATT_RSP_HIST_SIZE; i++)
+    {
+      sent += attRspHist[i];
+    }
+
+    if ((sent != 0) || (attRspDropped != 0))
+    {
+      Display_print2(dispHandle, 5, 0, "Rsp resent %d dropped %d", sent,
+                     attRspDropped);
+    }
+  }
+
+  if (appEvtPoolMisses != 0)
+  {
+    Display_print1(dispHandle, 8, 0, "Evt pool misses: %d", appEvtPoolMisses);
+  }
+
+#ifdef L2CAP_STREAM
+  {
+    l2capStreamStats_t stats;
+
+    if (L2CAPStream_getStats(streamCID, &stats) == SUCCESS)
+    {
+      Display_print2(dispHandle, 6, 0, "CoC tx %d B/s rx %d B/s",
+                     stats.txRate, stats.rxRate);
+    }
+  }
+#endif //L2CAP_STREAM
 }
 
+#ifdef L2CAP_STREAM
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_streamRead
+ *
+ * @brief   Fill an SDU of a transfer with a counting pattern.
+ *
+ * @param   CID    - local channel id
+ * @param   offset - offset of the data in the transfer
+ * @param   pBuf   - SDU payload to fill
+ * @param   len    - number of bytes wanted
+ *
+ * @return  number of bytes copied
+ */
+static uint16 SimpleBLEPeripheral_streamRead(uint16 CID, uint32 offset,
+                                             uint8 *pBuf, uint16 len)
+{
+  uint16_t i;
+
+  for (i = 0; i < len; i++)
+  {
+    pBuf[i] = (uint8_t)(offset + i);
+  }
+
+  return len;
+}
+
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_streamDone
+ *
+ * @brief   Report the end of a transfer.
+ *
+ * @param   CID    - local channel id
+ * @param   status - SUCCESS or why the transfer was aborted
+ * @param   len    - number of bytes sent
+ *
+ * @return  none
+ */
+static void SimpleBLEPeripheral_streamDone(uint16 CID, uint8 status,
+                                           uint32 len)
+{
+  Display_print2(dispHandle, 7, 0, "CoC sent %d B: %d", len, status);
+}
+#endif //L2CAP_STREAM
+
+#ifdef LINK_TUNE
+/*********************************************************************
+ * @fn      SimpleBLEPeripheral_linkTuneCB
+ *
+ * @brief   Callback from the link tuning manager with the notification
+ *          length with the best goodput on a connection. Notification
+ *          batches and the Characteristic 4 sample notifications of the
+ *          Simple GATT Profile are sized with it.
+ *
+ * @param   connHandle - connection handle
+ * @param   payloadLen - notification value length
+ *
+ * @return  none
+ */
+static void SimpleBLEPeripheral_linkTuneCB(uint16 connHandle,
+                                           uint16 payloadLen)
+{
+  linkTuneInfo_t info;
+
+  if (LinkTune_getInfo(connHandle, &info) == SUCCESS)
+  {
+    GATTServApp_SetLinkParams(connHandle, payloadLen, info.txOctets);
+
+    Display_print3(dispHandle, 5, 0, "MTU %d LL %d Payload %d", info.mtu,
+                   info.txOctets, payloadLen);
+  }
+}
+#endif //LINK_TUNE
+
 
 #ifdef FEATURE_OAD
 /*********************************************************************
@@ -1153,6 +1841,11 @@ void SimpleBLEPeripheral_processOadWriteCB(uint8_t event, uint16_t connHandle,
   oadTargetWrite_t *oadWriteEvt = ICall_malloc( sizeof(oadTargetWrite_t) + \
                                              sizeof(uint8_t) * OAD_PACKET_SIZE);
 
+#ifdef GAPROLE_ADAPTIVE_CONN_PARAMS
+  // Image block writes keep the link in the fast profile
+  GAPRole_ReportTraffic(0, 1);
+#endif //GAPROLE_ADAPTIVE_CONN_PARAMS
+
   if ( oadWriteEvt != NULL )
   {
     oadWriteEvt->event = event;
@@ -1205,14 +1898,26 @@ static void SimpleBLEPeripheral_enqueueMsg(uint8_t event, uint8_t state)
 {
   sbpEvt_t *pMsg;
 
-  // Create dynamic pointer to message.
-  if ((pMsg = ICall_malloc(sizeof(sbpEvt_t))))
+  // Take a message from the pool. State changes must not be lost, so
+  // fall back to the heap when the pool is empty.
+  if ((pMsg = Util_poolAlloc(appEvtPool)) == NULL)
+  {
+    appEvtPoolMisses++;
+
+    pMsg = ICall_malloc(sizeof(sbpEvt_t));
+  }
+
+  if (pMsg)
   {
     pMsg->hdr.event = event;
     pMsg->hdr.state = state;
 
     // Enqueue the message.
-    Util_enqueueMsg(appMsgQueue, sem, (uint8*)pMsg);
+    Util_enqueuePoolMsg(appMsgQueue, sem, pMsg);
+  }
+  else
+  {
+    HAL_ASSERT(HAL_ASSERT_CAUSE_OUT_OF_MEMORY);
   }
 }
 
@@ -65,6 +65,10 @@ extern "C"
  * CONSTANTS
  */
 
+// Number of ATT response retry count histogram buckets: 1, 2, 3-4, 5-8,
+// ... tries
+#define SBP_ATT_RSP_HIST_SIZE                 8
+
 /*********************************************************************
  * MACROS
  */
@@ -78,6 +82,18 @@ extern "C"
  */
 extern void SimpleBLEPeripheral_createTask(void);
 
+/*
+ * Get the retry count histogram of the ATT responses sent after a
+ * retransmission, and the number dropped.
+ */
+extern uint16_t SimpleBLEPeripheral_getAttRspStats(uint16_t *pHist);
+
+/*
+ * Get the number of app events allocated from the heap because the event
+ * pool was empty.
+ */
+extern uint16_t SimpleBLEPeripheral_getEvtPoolMisses(void);
+
 
 /*********************************************************************
 *********************************************************************/
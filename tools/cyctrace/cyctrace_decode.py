@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Decodes a hot path trace written by cyc_trace.c (CYC_TRACE).
+
+The trace is either the raw content of cycTraceBuf saved from a debugger
+memory view, or the stream written by CycTrace_drain(), e.g. captured
+from a UART or written by the host simulation (hostsim -t).
+
+Prints the latency of each traced section: count, min, mean, p50, p99 and
+max, and a log2 histogram of the durations. Sections are matched per
+context (task, Swi or Hwi) so nested and preempted sections are timed
+correctly; records whose begin was overwritten are skipped.
+
+Usage: cyctrace_decode.py trace.bin [--chrome trace.json]
+       cyctrace_decode.py --hex "43 54 01 08 ..."
+
+The --chrome output loads in chrome://tracing or https://ui.perfetto.dev.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+VERSION = 1
+HDR_SIZE = 16
+REC_SIZE = 8
+
+# Record kinds, see CYC_TRACE_KIND_* in cyc_trace.h
+KIND_BEGIN, KIND_END, KIND_MARK = 0, 1, 2
+
+# Contexts, see CYC_TRACE_CTX_* in cyc_trace.h
+CTX_HWI = 0xFFFF
+CTX_SWI = 0xFFFE
+
+# Trace point names, see the trace point ids in cyc_trace.h
+NAMES = {
+    1: "ICall_dispatch",
+    2: "ICall wait match",
+    3: "ICall_heapMalloc",
+    4: "gattServApp_SendNotiInd",
+    5: "app processStackMsg",
+    6: "gapRole processStackMsg",
+}
+USER_BASE = 32
+
+
+def point_name(ident):
+    if ident in NAMES:
+        return NAMES[ident]
+    if ident >= USER_BASE:
+        return "user %d" % (ident - USER_BASE)
+    return "id %d" % ident
+
+
+def ctx_name(ctx):
+    if ctx == CTX_HWI:
+        return "hwi"
+    if ctx == CTX_SWI:
+        return "swi"
+    return "task 0x%04x" % ctx
+
+
+def decode(data):
+    """Returns the tick rate and the records (ticks, ctx, id, kind), oldest
+    first, with timestamps unwrapped to 64 bits."""
+    if len(data) < HDR_SIZE or data[0:2] != b"CT":
+        raise ValueError("not a hot path trace")
+    version, rec_size = data[2], data[3]
+    if version != VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+    if rec_size != REC_SIZE:
+        raise ValueError("unsupported record size %d" % rec_size)
+    num_recs, tick_hz, head = struct.unpack_from("<H2xII", data, 4)
+    if num_recs == 0 or tick_hz == 0:
+        raise ValueError("trace was not initialized")
+    need = HDR_SIZE + num_recs * REC_SIZE
+    if len(data) < need:
+        raise ValueError("truncated trace: %d of %d bytes" % (len(data), need))
+
+    # A RAM dump is a ring, the oldest record is the next one written
+    count = min(head, num_recs)
+    first = head - count
+    recs = []
+    high = 0
+    last = None
+    for i in range(count):
+        off = HDR_SIZE + ((first + i) % num_recs) * REC_SIZE
+        time, ctx, ident, kind = struct.unpack_from("<IHBB", data, off)
+        if last is not None and time < last:
+            high += 1 << 32
+        last = time
+        recs.append((high + time, ctx, ident, kind))
+    return tick_hz, recs
+
+
+def sections(recs):
+    """Matches begin and end records of each context. Returns the
+    sections (start, ticks, ctx, id) and the number of unmatched records."""
+    stacks = {}
+    out = []
+    unmatched = 0
+    for time, ctx, ident, kind in recs:
+        stack = stacks.setdefault(ctx, [])
+        if kind == KIND_BEGIN:
+            stack.append((ident, time))
+        elif kind == KIND_END:
+            # Drop begins left open by a lost end record
+            while stack and stack[-1][0] != ident:
+                stack.pop()
+                unmatched += 1
+            if not stack:
+                unmatched += 1
+                continue
+            start = stack.pop()[1]
+            out.append((start, time - start, ctx, ident))
+    unmatched += sum(len(s) for s in stacks.values())
+    return out, unmatched
+
+
+def percentile(values, pct):
+    return values[min(len(values) - 1, len(values) * pct // 100)]
+
+
+def report(data, out=sys.stdout):
+    tick_hz, recs = decode(data)
+    secs, unmatched = sections(recs)
+    us = 1e6 / tick_hz
+
+    if recs:
+        span = (recs[-1][0] - recs[0][0]) * us
+    else:
+        span = 0
+    out.write("%u records over %.0f us at %u Hz, %u unmatched\n\n" %
+              (len(recs), span, tick_hz, unmatched))
+
+    by_id = {}
+    for _, ticks, _, ident in secs:
+        by_id.setdefault(ident, []).append(ticks * us)
+
+    out.write("%-24s %8s %9s %9s %9s %9s %9s\n" %
+              ("section (us)", "count", "min", "mean", "p50", "p99", "max"))
+    for ident in sorted(by_id):
+        values = sorted(by_id[ident])
+        out.write("%-24s %8u %9.1f %9.1f %9.1f %9.1f %9.1f\n" %
+                  (point_name(ident), len(values), values[0],
+                   sum(values) / len(values), percentile(values, 50),
+                   percentile(values, 99), values[-1]))
+
+    for ident in sorted(by_id):
+        hist = {}
+        for value in by_id[ident]:
+            bucket = 0
+            while (1 << bucket) <= value:
+                bucket += 1
+            hist[bucket] = hist.get(bucket, 0) + 1
+        top = max(hist.values())
+        out.write("\n%s\n" % point_name(ident))
+        for bucket in range(min(hist), max(hist) + 1):
+            low = (1 << (bucket - 1)) if bucket else 0
+            n = hist.get(bucket, 0)
+            out.write("  %7u-%-7u us %8u %s\n" %
+                      (low, 1 << bucket, n, "#" * ((n * 40 + top - 1) // top)))
+
+    marks = [r for r in recs if r[3] == KIND_MARK]
+    if marks:
+        out.write("\n%u marks\n" % len(marks))
+
+
+def chrome(data):
+    """Returns the trace as Chrome trace event JSON."""
+    tick_hz, recs = decode(data)
+    us = 1e6 / tick_hz
+    base = recs[0][0] if recs else 0
+    phases = {KIND_BEGIN: "B", KIND_END: "E", KIND_MARK: "i"}
+    events = []
+    for ctx in sorted(set(r[1] for r in recs)):
+        events.append({"name": "thread_name", "ph": "M", "pid": 0,
+                       "tid": ctx, "args": {"name": ctx_name(ctx)}})
+    for time, ctx, ident, kind in recs:
+        if kind not in phases:
+            continue
+        event = {"name": point_name(ident), "ph": phases[kind], "pid": 0,
+                 "tid": ctx, "ts": round((time - base) * us, 3)}
+        if kind == KIND_MARK:
+            event["s"] = "t"
+        events.append(event)
+    return json.dumps({"traceEvents": events, "displayTimeUnit": "ns"})
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", nargs="?", help="binary trace file")
+    parser.add_argument("--hex", help="trace as a string of hex bytes")
+    parser.add_argument("--chrome", metavar="JSON",
+                        help="also write a Chrome trace event file")
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex.replace("0x", "").replace(",", " "))
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("a trace file or --hex is required")
+
+    try:
+        report(data)
+        if args.chrome:
+            with open(args.chrome, "w") as f:
+                f.write(chrome(data))
+    except (ValueError, OSError) as e:
+        sys.exit("error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,615 @@
+#!/usr/bin/env python3
+"""Generates a GATT profile from a declarative service description.
+
+The description is a JSON file (see simple_profile.json). The generator
+writes <file>.h and <file>.c holding the attribute table, the matching
+gattAttrDesc_t descriptor table used by GATTServApp_ReadAttrDesc() and
+GATTServApp_WriteAttrDesc(), and the AddService, RegisterAppCBs,
+SetParameter and GetParameter functions.
+
+The output follows the hand-written profiles: a one octet value is a
+uint8 variable set and got by value, a longer one an array with a
+<MACRO>_<NAME>_LEN length macro. The callbacks read a value when the
+characteristic is readable or notified, and write it when it is writable,
+whatever the attribute permissions; local requests are served the same.
+tools/hostsim/bench/gattgen_equiv.c checks a generated profile against
+the hand-written one.
+
+Usage: gattgen.py service.json [-o output_dir]
+"""
+
+import argparse
+import json
+import os
+import sys
+
+PROPERTIES = {
+    "read": "GATT_PROP_READ",
+    "write": "GATT_PROP_WRITE",
+    "write_no_rsp": "GATT_PROP_WRITE_NO_RSP",
+    "notify": "GATT_PROP_NOTIFY",
+    "indicate": "GATT_PROP_INDICATE",
+}
+
+PERMISSIONS = {
+    "read": "GATT_PERMIT_READ",
+    "write": "GATT_PERMIT_WRITE",
+    "authen_read": "GATT_PERMIT_AUTHEN_READ",
+    "authen_write": "GATT_PERMIT_AUTHEN_WRITE",
+    "encrypt_read": "GATT_PERMIT_ENCRYPT_READ",
+    "encrypt_write": "GATT_PERMIT_ENCRYPT_WRITE",
+}
+
+# Characteristic properties that make the value read or written by the
+# profile callbacks
+READ_PROPERTIES = ("read", "notify", "indicate")
+WRITE_PROPERTIES = ("write", "write_no_rsp")
+
+SEP = "/" + "*" * 69
+
+
+class Error(Exception):
+    pass
+
+
+def flags(names, table, what):
+    try:
+        out = [table[n] for n in names]
+    except KeyError as e:
+        raise Error("unknown %s %s" % (what, e))
+    return " | ".join(out) if out else "0"
+
+
+def uuid_bytes(uuid):
+    """Returns (size macro, initializer) of a 16-bit or 128-bit UUID."""
+    uuid = uuid.replace("-", "")
+    if len(uuid) == 4:
+        return "ATT_BT_UUID_SIZE", None
+    if len(uuid) == 32:
+        raw = bytes.fromhex(uuid)[::-1]
+        return "ATT_UUID_SIZE", ", ".join("0x%02X" % b for b in raw)
+    raise Error("UUID %s is neither 16-bit nor 128-bit" % uuid)
+
+
+class Profile:
+    def __init__(self, desc):
+        self.name = desc["name"]                # e.g. simpleProfile
+        self.api = self.name[0].upper() + self.name[1:]
+        self.macro = desc.get("macro", self.name.upper())
+        self.file = desc.get("file", self.name)
+        self.uuid = desc["uuid"]
+        self.service_bit = desc.get("service_bit", "0x00000001")
+        self.chars = []
+        for idx, c in enumerate(desc["characteristics"]):
+            c = dict(c)
+            c.setdefault("name", "Char%d" % (idx + 1))
+            c["param"] = c.get("param", "%s_%s" % (self.macro, c["name"].upper()))
+            c["uuid_macro"] = "%s_%s_UUID" % (self.macro, c["name"].upper())
+            c["len_macro"] = "%s_%s_LEN" % (self.macro, c["name"].upper())
+            c["var"] = self.name + c["name"]
+            c.setdefault("len", 1)
+            c.setdefault("properties", [])
+            c.setdefault("permissions", [])
+            c["ccc"] = [p for p in ("notify", "indicate") if p in c["properties"]]
+            c["scalar"] = c["len"] == 1
+            # Value as an initializer, pointer and length expression
+            c["ref"] = ("&" if c["scalar"] else "") + c["var"]
+            c["size"] = "1" if c["scalar"] else c["len_macro"]
+            access = []
+            if any(p in c["properties"] for p in READ_PROPERTIES):
+                access.append("READ")
+            if any(p in c["properties"] for p in WRITE_PROPERTIES):
+                access.append("WRITE")
+            c["access"] = {0: "GATT_ATTR_ACCESS_NONE", 2: "GATT_ATTR_ACCESS_RW"}.get(
+                len(access), "GATT_ATTR_ACCESS_%s" % "".join(access))
+            self.chars.append(c)
+
+    # Number of attribute records: service, then declaration, value,
+    # optional configuration and optional user description per characteristic
+    def num_attrs(self):
+        n = 1
+        for c in self.chars:
+            n += 2 + (1 if c["ccc"] else 0) + (1 if "description" in c else 0)
+        return n
+
+    def header(self):
+        g = "%s_H" % self.file.upper().replace(".", "_")
+        o = []
+        o.append("/" + "*" * 78)
+        o.append("")
+        o.append(" @file  %s.h" % self.file)
+        o.append("")
+        o.append(" @brief This file contains the %s definitions and prototypes." % self.api)
+        o.append("        Generated by tools/gattgen/gattgen.py; do not edit.")
+        o.append("")
+        o.append(" " + "*" * 77 + "/")
+        o.append("")
+        o.append("#ifndef %s" % g)
+        o.append("#define %s" % g)
+        o.append("")
+        o.append("#ifdef __cplusplus")
+        o.append('extern "C"')
+        o.append("{")
+        o.append("#endif")
+        o.append("")
+        o.append(SEP)
+        o.append(" * CONSTANTS")
+        o.append(" */")
+        o.append("")
+        o.append("// Profile Parameters")
+        for idx, c in enumerate(self.chars):
+            o.append("#define %-37s %d" % (c["param"], idx))
+        o.append("")
+        o.append("// Service UUID")
+        if len(self.uuid) == 4:
+            o.append("#define %-37s 0x%s" % (self.macro + "_SERV_UUID", self.uuid.upper()))
+        o.append("")
+        o.append("// Characteristic UUIDs")
+        for c in self.chars:
+            if len(c["uuid"]) == 4:
+                o.append("#define %-37s 0x%s" % (c["uuid_macro"], c["uuid"].upper()))
+        o.append("")
+        o.append("// Service bit fields")
+        o.append("#define %-37s %s" % (self.macro + "_SERVICE", self.service_bit))
+        o.append("")
+        longs = [c for c in self.chars if not c["scalar"]]
+        if longs:
+            o.append("// Length of characteristics in bytes")
+            for c in longs:
+                o.append("#define %-37s %d" % (c["len_macro"], c["len"]))
+            o.append("")
+        o.append(SEP)
+        o.append(" * Profile Callbacks")
+        o.append(" */")
+        o.append("")
+        o.append("// Callback when a characteristic value has changed")
+        o.append("typedef void (*%sChange_t)( uint8 paramID );" % self.name)
+        o.append("")
+        o.append("// Callback when a peer has read a characteristic value; called from the")
+        o.append("// stack task")
+        o.append("typedef void (*%sRead_t)( uint8 paramID );" % self.name)
+        o.append("")
+        o.append("typedef struct")
+        o.append("{")
+        o.append("  %-28s pfn%sChange;  // Called when characteristic value changes"
+                 % (self.name + "Change_t", self.api))
+        o.append("  %-28s pfn%sRead;    // Called when a peer reads a characteristic value (optional)"
+                 % (self.name + "Read_t", self.api))
+        o.append("} %sCBs_t;" % self.name)
+        o.append("")
+        o.append(SEP)
+        o.append(" * API FUNCTIONS")
+        o.append(" */")
+        o.append("")
+        o.append("/*")
+        o.append(" * %s_AddService - Initializes the service by registering" % self.api)
+        o.append(" *          GATT attributes with the GATT server.")
+        o.append(" *")
+        o.append(" * @param   services - services to add. This is a bit map and can")
+        o.append(" *                     contain more than one service.")
+        o.append(" */")
+        o.append("extern bStatus_t %s_AddService( uint32 services );" % self.api)
+        o.append("")
+        o.append("/*")
+        o.append(" * %s_RegisterAppCBs - Registers the application callback function." % self.api)
+        o.append(" *                    Only call this function once.")
+        o.append(" *")
+        o.append(" *    appCallbacks - pointer to application callbacks.")
+        o.append(" */")
+        o.append("extern bStatus_t %s_RegisterAppCBs( %sCBs_t *appCallbacks );" % (self.api, self.name))
+        o.append("")
+        o.append("/*")
+        o.append(" * %s_SetParameter - Set a profile parameter." % self.api)
+        o.append(" *")
+        o.append(" *    param - Profile parameter ID")
+        o.append(" *    len - length of data to write")
+        o.append(" *    value - pointer to data to write.")
+        o.append(" */")
+        o.append("extern bStatus_t %s_SetParameter( uint8 param, uint8 len, void *value );" % self.api)
+        o.append("")
+        o.append("/*")
+        o.append(" * %s_GetParameter - Get a profile parameter." % self.api)
+        o.append(" *")
+        o.append(" *    param - Profile parameter ID")
+        o.append(" *    value - pointer to data to read.")
+        o.append(" */")
+        o.append("extern bStatus_t %s_GetParameter( uint8 param, void *value );" % self.api)
+        o.append("")
+        o.append(SEP)
+        o.append("*" * 69 + "/")
+        o.append("")
+        o.append("#ifdef __cplusplus")
+        o.append("}")
+        o.append("#endif")
+        o.append("")
+        o.append("#endif /* %s */" % g)
+        return "\n".join(o) + "\n"
+
+    def source(self):
+        n = self.name
+        o = []
+        o.append("/" + "*" * 78)
+        o.append("")
+        o.append(" @file  %s.c" % self.file)
+        o.append("")
+        o.append(" @brief This file contains the %s service." % self.api)
+        o.append("        Generated by tools/gattgen/gattgen.py; do not edit.")
+        o.append("")
+        o.append(" " + "*" * 77 + "/")
+        o.append("")
+        o.append(SEP)
+        o.append(" * INCLUDES")
+        o.append(" */")
+        o.append("#include <string.h>")
+        o.append("")
+        for h in ("bcomdef.h", "osal.h", "linkdb.h", "att.h", "gatt.h",
+                  "gatt_uuid.h", "gattservapp.h", "gapbondmgr.h"):
+            o.append('#include "%s"' % h)
+        o.append("")
+        o.append('#include "%s.h"' % self.file)
+        o.append("")
+        o.append(SEP)
+        o.append(" * CONSTANTS")
+        o.append(" */")
+        o.append("")
+        o.append("#define SERVAPP_NUM_ATTR_SUPPORTED        %d" % self.num_attrs())
+        o.append("")
+        o.append(SEP)
+        o.append(" * GLOBAL VARIABLES")
+        o.append(" */")
+        o.append("")
+
+        def uuid_var(var, uuid, macro):
+            size, raw = uuid_bytes(uuid)
+            o.append("CONST uint8 %s[%s] =" % (var, size))
+            o.append("{")
+            if raw is None:
+                o.append("  LO_UINT16(%s), HI_UINT16(%s)" % (macro, macro))
+            else:
+                o.append("  " + raw)
+            o.append("};")
+            o.append("")
+            return size
+
+        o.append("// Service UUID")
+        srv_size = uuid_var(n + "ServUUID", self.uuid, self.macro + "_SERV_UUID")
+        for c in self.chars:
+            o.append("// %s UUID" % c["name"])
+            c["uuid_size"] = uuid_var(c["var"] + "UUID", c["uuid"], c["uuid_macro"])
+
+        o.append(SEP)
+        o.append(" * LOCAL VARIABLES")
+        o.append(" */")
+        o.append("")
+        o.append("static %sCBs_t *%s_AppCBs = NULL;" % (n, n))
+        o.append("")
+        o.append(SEP)
+        o.append(" * Profile Attributes - variables")
+        o.append(" */")
+        o.append("")
+        o.append("// Service attribute")
+        o.append("static CONST gattAttrType_t %sService = { %s, %sServUUID };" % (n, srv_size, n))
+        o.append("")
+        for c in self.chars:
+            o.append("")
+            o.append("// %s Properties" % c["name"])
+            o.append("static uint8 %sProps = %s;" % (c["var"], flags(c["properties"], PROPERTIES, "property")))
+            o.append("")
+            o.append("// %s Value" % c["name"])
+            init = c.get("initial", [0] * c["len"])
+            if len(init) != c["len"]:
+                raise Error("%s: initial value length differs from len" % c["name"])
+            if c["scalar"]:
+                o.append("static uint8 %s = %s;" % (c["var"], init[0]))
+            else:
+                o.append("static uint8 %s[%s] = { %s };" % (c["var"], c["len_macro"],
+                                                          ", ".join(str(v) for v in init)))
+            if c["ccc"]:
+                o.append("")
+                o.append("// %s Configuration; each client has its own instantiation" % c["name"])
+                o.append("static gattCharCfg_t *%sConfig;" % c["var"])
+            if "description" in c:
+                d = c["description"]
+                o.append("")
+                o.append("// %s User Description" % c["name"])
+                o.append('static uint8 %sUserDesp[%d] = "%s";' % (c["var"], len(d) + 1, d))
+        o.append("")
+
+        attrs = []   # (comment, type, permissions, pValue, descriptor)
+        attrs.append(("Service", "{ ATT_BT_UUID_SIZE, primaryServiceUUID }",
+                      "GATT_PERMIT_READ", "(uint8 *)&%sService" % n, "GATT_ATTR_DESC_NONE"))
+        for c in self.chars:
+            attrs.append(("%s Declaration" % c["name"], "{ ATT_BT_UUID_SIZE, characterUUID }",
+                          "GATT_PERMIT_READ", "&%sProps" % c["var"], "GATT_ATTR_DESC_NONE"))
+            attrs.append(("%s Value" % c["name"], "{ %s, %sUUID }" % (c["uuid_size"], c["var"]),
+                          flags(c["permissions"], PERMISSIONS, "permission"), c["ref"],
+                          "GATT_ATTR_DESC_FIXED( %s, %s, %s, %s )" % (c["ref"], c["size"], c["param"],
+                                                                      c["access"])))
+            if c["ccc"]:
+                valid = " | ".join("GATT_CLIENT_CFG_" + p.upper() for p in c["ccc"])
+                attrs.append(("%s Configuration" % c["name"], "{ ATT_BT_UUID_SIZE, clientCharCfgUUID }",
+                              "GATT_PERMIT_READ | GATT_PERMIT_WRITE",
+                              "(uint8 *)&%sConfig" % c["var"], "GATT_ATTR_DESC_CCC( %s )" % valid))
+            if "description" in c:
+                attrs.append(("%s User Description" % c["name"], "{ ATT_BT_UUID_SIZE, charUserDescUUID }",
+                              "GATT_PERMIT_READ", "%sUserDesp" % c["var"], "GATT_ATTR_DESC_NONE"))
+
+        o.append(SEP)
+        o.append(" * Profile Attributes - Table")
+        o.append(" */")
+        o.append("")
+        o.append("static gattAttribute_t %sAttrTbl[SERVAPP_NUM_ATTR_SUPPORTED] =" % n)
+        o.append("{")
+        for comment, typ, perm, val, _ in attrs:
+            o.append("  // %s" % comment)
+            o.append("  {")
+            o.append("    %s," % typ)
+            o.append("    %s," % perm)
+            o.append("    0,")
+            o.append("    %s" % val)
+            o.append("  },")
+        o.append("};")
+        o.append("")
+        o.append(SEP)
+        o.append(" * Profile Attributes - Descriptor Table")
+        o.append(" */")
+        o.append("")
+        o.append("static CONST gattAttrDesc_t %sDescTbl[SERVAPP_NUM_ATTR_SUPPORTED] =" % n)
+        o.append("{")
+        for comment, _, _, _, desc in attrs:
+            o.append("  %s, // %s" % (desc, comment))
+        o.append("};")
+        o.append("")
+        o.append(SEP)
+        o.append(" * LOCAL FUNCTIONS")
+        o.append(" */")
+        rd = ("static bStatus_t %s_ReadAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,\n"
+              "                                uint8_t *pValue, uint16_t *pLen,\n"
+              "                                uint16_t offset, uint16_t maxLen,\n"
+              "                                uint8_t method)" % n)
+        wr = ("static bStatus_t %s_WriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,\n"
+              "                                 uint8_t *pValue, uint16_t len,\n"
+              "                                 uint16_t offset, uint8_t method)" % n)
+        o.append(rd + ";")
+        o.append(wr + ";")
+        o.append("")
+        o.append(SEP)
+        o.append(" * PROFILE CALLBACKS")
+        o.append(" */")
+        o.append("")
+        o.append("CONST gattServiceCBs_t %sCBs =" % n)
+        o.append("{")
+        o.append("  %s_ReadAttrCB,  // Read callback function pointer" % n)
+        o.append("  %s_WriteAttrCB, // Write callback function pointer" % n)
+        o.append("  NULL            // Authorization callback function pointer")
+        o.append("};")
+        o.append("")
+        o.append(SEP)
+        o.append(" * PUBLIC FUNCTIONS")
+        o.append(" */")
+        o.append("")
+
+        # AddService
+        o.append(SEP)
+        o.append(" * @fn      %s_AddService" % self.api)
+        o.append(" *")
+        o.append(" * @brief   Initializes the service by registering GATT attributes")
+        o.append(" *          with the GATT server.")
+        o.append(" *")
+        o.append(" * @param   services - services to add.")
+        o.append(" *")
+        o.append(" * @return  Success or Failure")
+        o.append(" */")
+        o.append("bStatus_t %s_AddService( uint32 services )" % self.api)
+        o.append("{")
+        for c in self.chars:
+            if c["ccc"]:
+                o.append("  // Allocate Client Characteristic Configuration table")
+                o.append("  %sConfig = (gattCharCfg_t *)ICall_malloc( sizeof(gattCharCfg_t) *" % c["var"])
+                o.append("                                           linkDBNumConns );")
+                o.append("  if ( %sConfig == NULL )" % c["var"])
+                o.append("  {")
+                o.append("    return ( bleMemAllocError );")
+                o.append("  }")
+                o.append("  GATTServApp_InitCharCfg( INVALID_CONNHANDLE, %sConfig );" % c["var"])
+                o.append("")
+        o.append("  if ( services & %s_SERVICE )" % self.macro)
+        o.append("  {")
+        o.append("    // Register GATT attribute list and CBs with GATT Server App")
+        o.append("    return ( GATTServApp_RegisterService( %sAttrTbl," % n)
+        o.append("                                          GATT_NUM_ATTRS( %sAttrTbl )," % n)
+        o.append("                                          GATT_MAX_ENCRYPT_KEY_SIZE,")
+        o.append("                                          &%sCBs ) );" % n)
+        o.append("  }")
+        o.append("")
+        o.append("  return ( SUCCESS );")
+        o.append("}")
+        o.append("")
+
+        # RegisterAppCBs
+        o.append(SEP)
+        o.append(" * @fn      %s_RegisterAppCBs" % self.api)
+        o.append(" *")
+        o.append(" * @brief   Registers the application callback function.")
+        o.append(" *")
+        o.append(" * @param   appCallbacks - pointer to application callbacks.")
+        o.append(" *")
+        o.append(" * @return  SUCCESS or bleAlreadyInRequestedMode")
+        o.append(" */")
+        o.append("bStatus_t %s_RegisterAppCBs( %sCBs_t *appCallbacks )" % (self.api, n))
+        o.append("{")
+        o.append("  if ( appCallbacks )")
+        o.append("  {")
+        o.append("    %s_AppCBs = appCallbacks;" % n)
+        o.append("")
+        o.append("    return ( SUCCESS );")
+        o.append("  }")
+        o.append("")
+        o.append("  return ( bleAlreadyInRequestedMode );")
+        o.append("}")
+        o.append("")
+
+        # SetParameter
+        o.append(SEP)
+        o.append(" * @fn      %s_SetParameter" % self.api)
+        o.append(" *")
+        o.append(" * @brief   Set a profile parameter.")
+        o.append(" *")
+        o.append(" * @param   param - Profile parameter ID")
+        o.append(" * @param   len - length of data to write")
+        o.append(" * @param   value - pointer to data to write.")
+        o.append(" *")
+        o.append(" * @return  bStatus_t")
+        o.append(" */")
+        o.append("bStatus_t %s_SetParameter( uint8 param, uint8 len, void *value )" % self.api)
+        o.append("{")
+        o.append("  bStatus_t ret = SUCCESS;")
+        o.append("  switch ( param )")
+        o.append("  {")
+        for c in self.chars:
+            o.append("    case %s:" % c["param"])
+            if c["scalar"]:
+                o.append("      if ( len == sizeof ( uint8 ) )")
+                o.append("      {")
+                o.append("        %s = *((uint8*)value);" % c["var"])
+            else:
+                o.append("      if ( len == %s )" % c["len_macro"])
+                o.append("      {")
+                o.append("        VOID memcpy( %s, value, %s );" % (c["var"], c["len_macro"]))
+            if c["ccc"]:
+                o.append("")
+                o.append("        // See if Notification/Indication has been enabled")
+                o.append("        GATTServApp_ProcessCharCfg( %sConfig, %s, FALSE," % (c["var"], c["ref"]))
+                o.append("                                    %sAttrTbl, GATT_NUM_ATTRS( %sAttrTbl )," % (n, n))
+                o.append("                                    INVALID_TASK_ID, %s_ReadAttrCB );" % n)
+            o.append("      }")
+            o.append("      else")
+            o.append("      {")
+            o.append("        ret = bleInvalidRange;")
+            o.append("      }")
+            o.append("      break;")
+            o.append("")
+        o.append("    default:")
+        o.append("      ret = INVALIDPARAMETER;")
+        o.append("      break;")
+        o.append("  }")
+        o.append("")
+        o.append("  return ( ret );")
+        o.append("}")
+        o.append("")
+
+        # GetParameter
+        o.append(SEP)
+        o.append(" * @fn      %s_GetParameter" % self.api)
+        o.append(" *")
+        o.append(" * @brief   Get a profile parameter.")
+        o.append(" *")
+        o.append(" * @param   param - Profile parameter ID")
+        o.append(" * @param   value - pointer to data to read.")
+        o.append(" *")
+        o.append(" * @return  bStatus_t")
+        o.append(" */")
+        o.append("bStatus_t %s_GetParameter( uint8 param, void *value )" % self.api)
+        o.append("{")
+        o.append("  bStatus_t ret = SUCCESS;")
+        o.append("  switch ( param )")
+        o.append("  {")
+        for c in self.chars:
+            o.append("    case %s:" % c["param"])
+            if c["scalar"]:
+                o.append("      *((uint8*)value) = %s;" % c["var"])
+            else:
+                o.append("      VOID memcpy( value, %s, %s );" % (c["var"], c["len_macro"]))
+            o.append("      break;")
+            o.append("")
+        o.append("    default:")
+        o.append("      ret = INVALIDPARAMETER;")
+        o.append("      break;")
+        o.append("  }")
+        o.append("")
+        o.append("  return ( ret );")
+        o.append("}")
+        o.append("")
+
+        # Callbacks
+        o.append(SEP)
+        o.append(" * @fn          %s_ReadAttrCB" % n)
+        o.append(" *")
+        o.append(" * @brief       Read an attribute through the descriptor table.")
+        o.append(" *")
+        o.append(" * @return      SUCCESS or Failure")
+        o.append(" */")
+        o.append(rd)
+        o.append("{")
+        o.append("  bStatus_t status;")
+        o.append("")
+        o.append("  status = GATTServApp_ReadAttrDesc( %sAttrTbl, %sDescTbl," % (n, n))
+        o.append("                                     GATT_NUM_ATTRS( %sAttrTbl )," % n)
+        o.append("                                     pAttr, pValue, pLen, offset, maxLen );")
+        o.append("")
+        o.append("  // Tell the application about reads by a peer, not those for notifications")
+        o.append("  if ( ( status == SUCCESS ) && ( method != GATT_LOCAL_READ ) &&")
+        o.append("       %s_AppCBs && %s_AppCBs->pfn%sRead )" % (n, n, self.api))
+        o.append("  {")
+        o.append("    %s_AppCBs->pfn%sRead( %sDescTbl[pAttr - %sAttrTbl].param );"
+                 % (n, self.api, n, n))
+        o.append("  }")
+        o.append("")
+        o.append("  return ( status );")
+        o.append("}")
+        o.append("")
+        o.append(SEP)
+        o.append(" * @fn      %s_WriteAttrCB" % n)
+        o.append(" *")
+        o.append(" * @brief   Validate and write an attribute through the descriptor table.")
+        o.append(" *")
+        o.append(" * @return  SUCCESS or Failure")
+        o.append(" */")
+        o.append(wr)
+        o.append("{")
+        o.append("  bStatus_t status;")
+        o.append("  uint8 notifyApp;")
+        o.append("")
+        o.append("  status = GATTServApp_WriteAttrDesc( connHandle, %sAttrTbl, %sDescTbl," % (n, n))
+        o.append("                                      GATT_NUM_ATTRS( %sAttrTbl )," % n)
+        o.append("                                      pAttr, pValue, len, offset, &notifyApp );")
+        o.append("")
+        o.append("  // If a characteristic value changed then notify the application")
+        o.append("  if ( ( notifyApp != GATT_ATTR_NO_PARAM ) && %s_AppCBs &&" % n)
+        o.append("       %s_AppCBs->pfn%sChange )" % (n, self.api))
+        o.append("  {")
+        o.append("    %s_AppCBs->pfn%sChange( notifyApp );" % (n, self.api))
+        o.append("  }")
+        o.append("")
+        o.append("  return ( status );")
+        o.append("}")
+        o.append("")
+        o.append(SEP)
+        o.append("*" * 69 + "/")
+        return "\n".join(o) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("description", help="JSON service description")
+    parser.add_argument("-o", "--output", default=".", help="output directory")
+    args = parser.parse_args()
+
+    with open(args.description) as f:
+        profile = Profile(json.load(f))
+
+    try:
+        header = profile.header()
+        source = profile.source()
+    except Error as e:
+        sys.exit("error: %s" % e)
+
+    os.makedirs(args.output, exist_ok=True)
+    for ext, text in (("h", header), ("c", source)):
+        path = os.path.join(args.output, "%s.%s" % (profile.file, ext))
+        with open(path, "w") as f:
+            f.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Decodes a heap trace report written by heapmgr.h (HEAPMGR_TRACE).
+
+The report is the raw content of the buffer filled by
+ICall_heapTraceReport(), e.g. heapTraceDump[] saved from a debugger
+memory view after an out of memory assert, or the report written by the
+host simulation (hostsim -m).
+
+Usage: heaptrace_decode.py report.bin
+       heaptrace_decode.py --hex "48 54 01 ..."
+"""
+
+import argparse
+import struct
+import sys
+
+VERSION = 1
+
+# Owner names, see ICALL_HEAP_OWNER_* in icall.h
+FIXED_OWNERS = ["other/ISR", "BM GATT", "BM L2CAP"]
+
+
+def owner_name(idx):
+    if idx < len(FIXED_OWNERS):
+        return FIXED_OWNERS[idx]
+    return "task %d" % (idx - len(FIXED_OWNERS))
+
+
+def decode(data):
+    if len(data) < 10 or data[0:2] != b"HT":
+        raise ValueError("not a heap trace report")
+    version, owners, buckets = data[2], data[3], data[4]
+    if version != VERSION:
+        raise ValueError("unsupported report version %d" % version)
+    need = 10 + buckets * 10 + owners * 10
+    if len(data) < need:
+        raise ValueError("truncated report: %d of %d bytes" % (len(data), need))
+
+    cur, peak = struct.unpack_from("<HH", data, 6)
+    off = 10
+    hist = []
+    for _ in range(buckets):
+        hist.append(struct.unpack_from("<HHHI", data, off))
+        off += 10
+    table = []
+    for _ in range(owners):
+        table.append(struct.unpack_from("<HHHHH", data, off))
+        off += 10
+    return cur, peak, hist, table
+
+
+def report(data, out=sys.stdout):
+    cur, peak, hist, table = decode(data)
+
+    out.write("Heap in use: %u bytes, peak %u bytes\n\n" % (cur, peak))
+
+    out.write("%-12s %8s %8s %8s %8s %8s\n" %
+              ("owner", "cur", "peak", "at peak", "blocks", "fails"))
+    for idx, (o_cur, o_peak, o_at, o_blk, o_fail) in enumerate(table):
+        if not (o_cur or o_peak or o_fail):
+            continue
+        out.write("%-12s %8u %8u %8u %8u %8u\n" %
+                  (owner_name(idx), o_cur, o_peak, o_at, o_blk, o_fail))
+
+    out.write("\n%-12s %8s %8s %10s\n" % ("size", "cur", "peak", "total"))
+    low = 1
+    for limit, b_cur, b_peak, b_total in hist:
+        out.write("%-12s %8u %8u %10u\n" %
+                  ("%u-%u" % (low, limit), b_cur, b_peak, b_total))
+        low = limit + 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", nargs="?", help="binary report file")
+    parser.add_argument("--hex", help="report as a string of hex bytes")
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex.replace("0x", "").replace(",", " "))
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("a report file or --hex is required")
+
+    try:
+        report(data)
+    except ValueError as e:
+        sys.exit("error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,371 @@
+/******************************************************************************
+
+ @file  app_evt_bench.c
+
+ @brief This file contains the host benchmark of the application event
+        messages, from the fixed-block pool and from the heap.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Measures the path of an application event message, as posted by
+ * SimpleBLEPeripheral_enqueueMsg() and consumed by the application task,
+ * in the two ways it has been done:
+ *
+ *  - heap: the event is taken with ICall_malloc() and queued with
+ *    Util_enqueueMsg(), which takes a second block for the queue node;
+ *    the consumer frees both;
+ *  - pool: the event is taken from a pool of SBP_EVT_POOL_SIZE blocks
+ *    with Util_poolAlloc() and queued with Util_enqueuePoolMsg(), with
+ *    no heap call unless the pool is empty.
+ *
+ * Events are posted in bursts of 1 to 2 * SBP_EVT_POOL_SIZE, each burst
+ * being drained before the next one, as the application task would when
+ * it runs after the posting callbacks. Prints the events per second,
+ * the heap calls per event and the heap high-water mark reached by the
+ * events. A last run posts events with the heap exhausted and counts the
+ * events lost.
+ *
+ * The task is not switched: the semaphore is posted and pended in the
+ * same thread, which costs both paths the same.
+ *
+ * icall.c is included rather than linked to reach the heap metrics.
+ * Build from the repository root with the defines and include paths of
+ * hostsim.c:
+ *
+ *   gcc -O2 -o app_evt_bench <hostsim.c flags> -DHEAPMGR_METRICS \
+ *       -Itools/hostsim/bench tools/hostsim/bench/app_evt_bench.c \
+ *       ble-stack/common/cc26xx/util.c tools/hostsim/host_rtos.c \
+ *       tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "icall.c"
+
+#include "util.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Pool size of simple_peripheral.c
+#define SBP_EVT_POOL_SIZE                     8
+
+// Events posted per measurement
+#define EB_EVENTS                             1000000
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// App event as the heap path allocated it
+typedef struct
+{
+  appEvtHdr_t hdr;  // event header.
+} ebHeapEvt_t;
+
+// App event as the pool path allocates it
+typedef struct
+{
+  Queue_Elem _elem; // queue element, must be first.
+  appEvtHdr_t hdr;  // event header.
+} ebPoolEvt_t;
+
+// Result of one run
+typedef struct
+{
+  double evtPerSec;
+  double heapCallsPerEvt;
+  uint16_t memMax;    // Heap high-water mark above the starting usage
+  uint32_t lost;      // Events not posted for want of memory
+} ebStat_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, unused: no remote task is created
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { NULL };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Burst lengths measured
+static const uint16_t ebBursts[] = { 1, 4, SBP_EVT_POOL_SIZE,
+                                     2 * SBP_EVT_POOL_SIZE };
+
+static Semaphore_Struct ebSem;
+
+static Queue_Struct ebMsg;
+static Queue_Handle ebMsgQueue;
+
+static ebPoolEvt_t ebEvtBuf[SBP_EVT_POOL_SIZE];
+static Queue_Struct ebEvt;
+static Queue_Handle ebEvtPool;
+
+// Heap calls of the current run
+static uint32_t ebHeapCalls;
+
+// Events consumed, checked to keep the consumer from being optimized out
+static uint32_t ebConsumed;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Consume an event as SimpleBLEPeripheral_processAppMsg() would.
+ */
+static void eb_process(appEvtHdr_t *pHdr)
+{
+  ebConsumed += pHdr->event + pHdr->state;
+}
+
+/*
+ * Post an event on the heap path. Returns FALSE if it was lost.
+ */
+static bool eb_heapPost(uint8_t event, uint8_t state)
+{
+  ebHeapEvt_t *pMsg;
+
+  ebHeapCalls++;
+  if ((pMsg = ICall_malloc(sizeof(ebHeapEvt_t))))
+  {
+    pMsg->hdr.event = event;
+    pMsg->hdr.state = state;
+
+    ebHeapCalls++;
+    if (Util_enqueueMsg(ebMsgQueue, Semaphore_handle(&ebSem),
+                        (uint8_t *)pMsg))
+    {
+      return TRUE;
+    }
+
+    ebHeapCalls++;
+    ICall_free(pMsg);
+  }
+
+  return FALSE;
+}
+
+/*
+ * Drain the queue of the heap path.
+ */
+static void eb_heapDrain(void)
+{
+  ebHeapEvt_t *pMsg;
+
+  Semaphore_pend(Semaphore_handle(&ebSem), BIOS_NO_WAIT);
+
+  while ((pMsg = (ebHeapEvt_t *)Util_dequeueMsg(ebMsgQueue)))
+  {
+    eb_process(&pMsg->hdr);
+
+    ebHeapCalls += 2;
+    ICall_free(pMsg);
+  }
+}
+
+/*
+ * Post an event on the pool path, falling back to the heap when the pool
+ * is empty as SimpleBLEPeripheral_enqueueMsg() does. Returns FALSE if it
+ * was lost.
+ */
+static bool eb_poolPost(uint8_t event, uint8_t state)
+{
+  ebPoolEvt_t *pMsg;
+
+  if ((pMsg = Util_poolAlloc(ebEvtPool)) == NULL)
+  {
+    ebHeapCalls++;
+    pMsg = ICall_malloc(sizeof(ebPoolEvt_t));
+  }
+
+  if (pMsg)
+  {
+    pMsg->hdr.event = event;
+    pMsg->hdr.state = state;
+
+    Util_enqueuePoolMsg(ebMsgQueue, Semaphore_handle(&ebSem), pMsg);
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/*
+ * Drain the queue of the pool path.
+ */
+static void eb_poolDrain(void)
+{
+  ebPoolEvt_t *pMsg;
+
+  Semaphore_pend(Semaphore_handle(&ebSem), BIOS_NO_WAIT);
+
+  while ((pMsg = Util_dequeuePoolMsg(ebMsgQueue)))
+  {
+    eb_process(&pMsg->hdr);
+
+    if (pMsg >= ebEvtBuf && pMsg < &ebEvtBuf[SBP_EVT_POOL_SIZE])
+    {
+      Util_poolFree(ebEvtPool, pMsg);
+    }
+    else
+    {
+      ebHeapCalls++;
+      ICall_free(pMsg);
+    }
+  }
+}
+
+/*
+ * Post and drain EB_EVENTS events in bursts of burst events.
+ */
+static ebStat_t eb_run(uint16_t burst, bool pool)
+{
+  ebStat_t stat;
+  bench_t bench;
+  uint32_t posted;
+  uint16_t memStart = heapmgrMemAlo;
+
+  ebHeapCalls = 0;
+  heapmgrMemMax = heapmgrMemAlo;
+  stat.lost = 0;
+
+  bench_start(&bench);
+  for (posted = 0; posted < EB_EVENTS; posted += burst)
+  {
+    uint16_t i;
+
+    for (i = 0; i < burst; i++)
+    {
+      if (!(pool ? eb_poolPost : eb_heapPost)(i, posted))
+      {
+        stat.lost++;
+      }
+    }
+
+    if (pool)
+    {
+      eb_poolDrain();
+    }
+    else
+    {
+      eb_heapDrain();
+    }
+  }
+  bench_stop(&bench);
+
+  stat.evtPerSec = posted * 1e9 / bench.ns;
+  stat.heapCallsPerEvt = (double)ebHeapCalls / posted;
+  stat.memMax = heapmgrMemMax - memStart;
+
+  return stat;
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  ebStat_t heap, pool;
+  void *pFill = NULL;
+  uint16_t size;
+  uint8_t i;
+
+  ICall_init();
+
+  Semaphore_construct(&ebSem, 0, NULL);
+  ebMsgQueue = Util_constructQueue(&ebMsg);
+  ebEvtPool = Util_constructPool(&ebEvt, ebEvtBuf, sizeof(ebPoolEvt_t),
+                                 SBP_EVT_POOL_SIZE);
+
+  printf("burst    events/s        heap calls/evt   heap high-water (B)\n");
+  printf("          heap      pool    heap  pool      heap  pool\n");
+
+  for (i = 0; i < sizeof(ebBursts) / sizeof(ebBursts[0]); i++)
+  {
+    heap = eb_run(ebBursts[i], FALSE);
+    pool = eb_run(ebBursts[i], TRUE);
+
+    printf("%5u %9.0f %9.0f %7.2f %5.2f %9u %5u\n", ebBursts[i],
+           heap.evtPerSec, pool.evtPerSec, heap.heapCallsPerEvt,
+           pool.heapCallsPerEvt, heap.memMax, pool.memMax);
+  }
+
+  // Exhaust the heap, chaining the fill blocks to free them afterwards
+  for (size = HEAPMGR_SIZE; size >= sizeof(void *); size /= 2)
+  {
+    void *pBlk;
+
+    while ((pBlk = ICall_malloc(size)))
+    {
+      *(void **)pBlk = pFill;
+      pFill = pBlk;
+    }
+  }
+
+  heap = eb_run(SBP_EVT_POOL_SIZE, FALSE);
+  pool = eb_run(SBP_EVT_POOL_SIZE, TRUE);
+
+  printf("\nheap exhausted, bursts of %u: events lost heap %u, pool %u\n",
+         SBP_EVT_POOL_SIZE, heap.lost, pool.lost);
+
+  while (pFill)
+  {
+    void *pNext = *(void **)pFill;
+
+    ICall_free(pFill);
+    pFill = pNext;
+  }
+
+  return ebConsumed == 0;
+}
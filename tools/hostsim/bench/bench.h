@@ -0,0 +1,135 @@
+/******************************************************************************
+
+ @file  bench.h
+
+ @brief This file contains the timing helpers of the host benchmarks.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * The benchmarks in this directory build the target sources that they
+ * measure on the host, with the defines and include paths listed in
+ * hostsim.c, and stub only what the stack image would provide. Their
+ * times and cycle counts are host figures, good for comparing two
+ * versions of the same code, not for predicting times on the device.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Time stamps of a measurement, see bench_start() and bench_stop()
+typedef struct
+{
+  uint64_t ns;      // Elapsed wall time in nanoseconds
+  uint64_t cycles;  // Elapsed CPU cycles, or nanoseconds without a counter
+} bench_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Monotonic time in nanoseconds.
+ */
+static inline uint64_t bench_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*
+ * CPU cycle counter, or nanoseconds on hosts without one.
+ */
+static inline uint64_t bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return bench_ns();
+#endif
+}
+
+/*
+ * Start a measurement.
+ */
+static inline void bench_start(bench_t *pBench)
+{
+  pBench->ns = bench_ns();
+  pBench->cycles = bench_cycles();
+}
+
+/*
+ * Stop a measurement; pBench then holds the elapsed time and cycles.
+ */
+static inline void bench_stop(bench_t *pBench)
+{
+  pBench->cycles = bench_cycles() - pBench->cycles;
+  pBench->ns = bench_ns() - pBench->ns;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
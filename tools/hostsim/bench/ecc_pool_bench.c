@@ -0,0 +1,839 @@
+/******************************************************************************
+
+ @file  ecc_pool_bench.c
+
+ @brief This file contains the host benchmark of the pairing critical
+        path with and without the ECCROMCC26XX key pool, on a portable
+        P-256 stand-in for the ECC ROM.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Runs the key generation and key exchange of LE Secure Connections
+ * pairings, back to back with a gap of idle time between them, through
+ * ECCROMCC26XX.c built with ECCROMCC26XX_KEY_POOL:
+ *
+ *  - no pool: the key pair is generated when pairing starts, as
+ *    ECCROMCC26XX_genKeys() did before the key pool;
+ *  - pool: ECCROMCC26XX_genKeys() hands out the key pair precomputed
+ *    by the precompute task in idle time, if ready.
+ *
+ * The critical path of a pairing runs from the key pair request to the
+ * DHKey, both computed by the application task. Prints its mean and
+ * worst simulated time and the pairings whose key pair was ready.
+ *
+ * The ECC ROM is replaced by a portable P-256 implementation, checked
+ * against the debug key pair of the Bluetooth specification and by
+ * comparing both ends of each key exchange. A scalar multiplication
+ * takes EP_MULT_MS of simulated time, which the ECC engine spends in
+ * 1 ms steps so that higher priority tasks preempt it. The time is an
+ * assumed figure, not measured on a device.
+ *
+ * ECCROMCC26XX.c is included rather than linked to reach the key pair
+ * generation without the pool. Build from the repository root with the
+ * defines and include paths of hostsim.c:
+ *
+ *   gcc -O2 -o ecc_pool_bench <hostsim.c flags> -DECCROMCC26XX_KEY_POOL \
+ *       -Ible-stack/common/cc26xx -Itools/hostsim/bench \
+ *       tools/hostsim/bench/ecc_pool_bench.c tools/hostsim/host_rtos.c \
+ *       tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+
+#include <ti/sysbios/knl/Clock.h>
+
+#include "ecc/ECCROMCC26XX.c"
+
+#include "bench.h"
+
+#ifndef ECCROMCC26XX_KEY_POOL
+#error "ecc_pool_bench needs ECCROMCC26XX_KEY_POOL"
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Simulated time of a P-256 scalar multiplication by the ECC ROM
+#ifndef EP_MULT_MS
+#define EP_MULT_MS                        160
+#endif
+
+#define EP_TICKS_PER_MS                   (1000 / Clock_tickPeriod)
+
+// Pairings per measurement
+#define EP_PAIRINGS                       20
+
+#define EP_KEY_LEN                        ECCROMCC26XX_NIST_P256_KEY_LEN_IN_BYTES
+#define EP_WORDS                          (EP_KEY_LEN / sizeof(uint32_t))
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Field element or scalar, least significant word first
+typedef uint32_t epNum_t[EP_WORDS];
+
+// Point in Jacobian coordinates, in the Montgomery domain; Z = 0 at
+// infinity
+typedef struct
+{
+  epNum_t x;
+  epNum_t y;
+  epNum_t z;
+} epPoint_t;
+
+// Key pair, in the byte order of ECCROMCC26XX
+typedef struct
+{
+  uint8_t privateKey[EP_KEY_LEN];
+  uint8_t publicKeyX[EP_KEY_LEN];
+  uint8_t publicKeyY[EP_KEY_LEN];
+} epKeys_t;
+
+// Result of one measurement
+typedef struct
+{
+  double meanMs;
+  double maxMs;
+  uint8_t ready;              // Pairings whose key pair was ready
+} epStat_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// ECC ROM globals, as used by ECCROMCC26XX.c
+uint8_t eccRom_windowSize;
+uint32_t *eccRom_workzone;
+uint32_t *eccRom_param_p;
+uint32_t *eccRom_param_r;
+uint32_t *eccRom_param_a;
+uint32_t *eccRom_param_b;
+uint32_t *eccRom_param_Gx;
+uint32_t *eccRom_param_Gy;
+
+// Curve parameters in ROM; the stand-in only supports P-256
+uint32_t NIST_Curve_P256_p;
+uint32_t NIST_Curve_P256_r;
+uint32_t NIST_Curve_P256_a;
+uint32_t NIST_Curve_P256_b;
+uint32_t NIST_Curve_P256_Gx;
+uint32_t NIST_Curve_P256_Gy;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Idle time between two pairings, in milliseconds
+static const uint16_t epGapsMs[] = { 50, 500, 5000 };
+
+// P-256 prime, base point and curve coefficient b
+static const epNum_t epP = {
+  0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000,
+  0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF
+};
+static const epNum_t epGx = {
+  0xD898C296, 0xF4A13945, 0x2DEB33A0, 0x77037D81,
+  0x63A440F2, 0xF8BCE6E5, 0xE12C4247, 0x6B17D1F2
+};
+static const epNum_t epGy = {
+  0x37BF51F5, 0xCBB64068, 0x6B315ECE, 0x2BCE3357,
+  0x7C0F9E16, 0x8EE7EB4A, 0xFE1A7F9B, 0x4FE342E2
+};
+static const epNum_t epB = {
+  0x27D2604B, 0x3BCE3C3E, 0xCC53B0F6, 0x651D06B0,
+  0x769886BC, 0xB3EBBD55, 0xAA3A93E7, 0x5AC635D8
+};
+
+// Debug key pair of the Bluetooth specification, Vol 3, Part H, 2.3.5.6.1
+static const epNum_t epDebugPriv = {
+  0xCD3C1ABD, 0x5899B8A6, 0xEB40B799, 0x4AFF607B,
+  0xD2103F50, 0x74C9B3E3, 0xA3C55F38, 0x3F49F6D4
+};
+static const epNum_t epDebugX = {
+  0x0E359DE6, 0xCC030148, 0xACF4FDDB, 0xEFF49111,
+  0xE9F9A5B9, 0x5E2C83A7, 0xF297BE2C, 0x20B003D2
+};
+static const epNum_t epDebugY = {
+  0x1589D28B, 0x741C8ED0, 0x8FED3024, 0x766345C2,
+  0x5A52155C, 0x63329ABF, 0x652AEB6D, 0xDC809C49
+};
+
+// Montgomery constants: R mod p and R^2 mod p, with R = 2^256
+static epNum_t epOne;
+static epNum_t epR2;
+
+// Scalar multiplications take simulated time once set
+static bool epTimed;
+
+static Task_Struct epTask;
+
+static uint32_t epRandState = 0x2545F491;
+
+/*********************************************************************
+ * P-256 STAND-IN
+ */
+
+/*
+ * r = a - p, modulo 2^256. Returns the borrow.
+ */
+static uint32_t ep_subP(epNum_t r, const epNum_t a)
+{
+  uint64_t borrow = 0;
+  uint8_t i;
+
+  for (i = 0; i < EP_WORDS; i++)
+  {
+    uint64_t d = (uint64_t)a[i] - epP[i] - borrow;
+
+    r[i] = (uint32_t)d;
+    borrow = (d >> 32) & 1;
+  }
+
+  return (uint32_t)borrow;
+}
+
+/*
+ * r = a + b mod p.
+ */
+static void ep_add(epNum_t r, const epNum_t a, const epNum_t b)
+{
+  epNum_t t;
+  uint64_t carry = 0;
+  uint8_t i;
+
+  for (i = 0; i < EP_WORDS; i++)
+  {
+    carry += (uint64_t)a[i] + b[i];
+    r[i] = (uint32_t)carry;
+    carry >>= 32;
+  }
+
+  if (ep_subP(t, r) == 0 || carry)
+  {
+    memcpy(r, t, sizeof(epNum_t));
+  }
+}
+
+/*
+ * r = a - b mod p.
+ */
+static void ep_sub(epNum_t r, const epNum_t a, const epNum_t b)
+{
+  uint64_t borrow = 0;
+  uint64_t carry = 0;
+  uint8_t i;
+
+  for (i = 0; i < EP_WORDS; i++)
+  {
+    uint64_t d = (uint64_t)a[i] - b[i] - borrow;
+
+    r[i] = (uint32_t)d;
+    borrow = (d >> 32) & 1;
+  }
+
+  if (borrow)
+  {
+    for (i = 0; i < EP_WORDS; i++)
+    {
+      carry += (uint64_t)r[i] + epP[i];
+      r[i] = (uint32_t)carry;
+      carry >>= 32;
+    }
+  }
+}
+
+/*
+ * r = a * b / R mod p, Montgomery multiplication. -1/p mod 2^32 is 1
+ * for P-256.
+ */
+static void ep_mul(epNum_t r, const epNum_t a, const epNum_t b)
+{
+  uint32_t t[EP_WORDS + 2] = { 0 };
+  epNum_t s;
+  uint8_t i, j;
+
+  for (i = 0; i < EP_WORDS; i++)
+  {
+    uint64_t c = 0;
+    uint32_t m;
+
+    for (j = 0; j < EP_WORDS; j++)
+    {
+      c += (uint64_t)t[j] + (uint64_t)a[i] * b[j];
+      t[j] = (uint32_t)c;
+      c >>= 32;
+    }
+    c += t[EP_WORDS];
+    t[EP_WORDS] = (uint32_t)c;
+    t[EP_WORDS + 1] = (uint32_t)(c >> 32);
+
+    m = t[0];
+    c = ((uint64_t)t[0] + (uint64_t)m * epP[0]) >> 32;
+    for (j = 1; j < EP_WORDS; j++)
+    {
+      c += (uint64_t)t[j] + (uint64_t)m * epP[j];
+      t[j - 1] = (uint32_t)c;
+      c >>= 32;
+    }
+    c += t[EP_WORDS];
+    t[EP_WORDS - 1] = (uint32_t)c;
+    t[EP_WORDS] = t[EP_WORDS + 1] + (uint32_t)(c >> 32);
+    t[EP_WORDS + 1] = 0;
+  }
+
+  // t < 2p: subtract p once if needed
+  if (ep_subP(s, t) == 0 || t[EP_WORDS])
+  {
+    memcpy(r, s, sizeof(epNum_t));
+  }
+  else
+  {
+    memcpy(r, t, sizeof(epNum_t));
+  }
+}
+
+/*
+ * Whether a is zero.
+ */
+static bool ep_isZero(const epNum_t a)
+{
+  uint32_t acc = 0;
+  uint8_t i;
+
+  for (i = 0; i < EP_WORDS; i++)
+  {
+    acc |= a[i];
+  }
+
+  return (acc == 0);
+}
+
+/*
+ * r = 1 / a in the Montgomery domain, as a^(p - 2).
+ */
+static void ep_inv(epNum_t r, const epNum_t a)
+{
+  epNum_t e, x;
+  int16_t bit;
+
+  memcpy(e, epP, sizeof(epNum_t));
+  e[0] -= 2;
+
+  memcpy(x, epOne, sizeof(epNum_t));
+  for (bit = 255; bit >= 0; bit--)
+  {
+    ep_mul(x, x, x);
+    if ((e[bit / 32] >> (bit % 32)) & 1)
+    {
+      ep_mul(x, x, a);
+    }
+  }
+  memcpy(r, x, sizeof(epNum_t));
+}
+
+/*
+ * r = 2 * q.
+ */
+static void ep_double(epPoint_t *r, const epPoint_t *q)
+{
+  epNum_t delta, gamma, beta, alpha, t1, t2;
+
+  if (ep_isZero(q->z))
+  {
+    *r = *q;
+    return;
+  }
+
+  ep_mul(delta, q->z, q->z);
+  ep_mul(gamma, q->y, q->y);
+  ep_mul(beta, q->x, gamma);
+
+  // alpha = 3 * (x - delta) * (x + delta), as a = -3
+  ep_sub(t1, q->x, delta);
+  ep_add(t2, q->x, delta);
+  ep_mul(alpha, t1, t2);
+  ep_add(t1, alpha, alpha);
+  ep_add(alpha, t1, alpha);
+
+  // z3 = (y + z)^2 - gamma - delta
+  ep_add(t1, q->y, q->z);
+  ep_mul(t1, t1, t1);
+  ep_sub(t1, t1, gamma);
+  ep_sub(r->z, t1, delta);
+
+  // x3 = alpha^2 - 8 * beta
+  ep_add(beta, beta, beta);
+  ep_add(beta, beta, beta);
+  ep_mul(t1, alpha, alpha);
+  ep_sub(t1, t1, beta);
+  ep_sub(r->x, t1, beta);
+
+  // y3 = alpha * (4 * beta - x3) - 8 * gamma^2
+  ep_sub(t1, beta, r->x);
+  ep_mul(t1, alpha, t1);
+  ep_mul(t2, gamma, gamma);
+  ep_add(t2, t2, t2);
+  ep_add(t2, t2, t2);
+  ep_add(t2, t2, t2);
+  ep_sub(r->y, t1, t2);
+}
+
+/*
+ * r = p + q.
+ */
+static void ep_addPoints(epPoint_t *r, const epPoint_t *p,
+                         const epPoint_t *q)
+{
+  epNum_t z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t;
+
+  if (ep_isZero(p->z))
+  {
+    *r = *q;
+    return;
+  }
+  if (ep_isZero(q->z))
+  {
+    *r = *p;
+    return;
+  }
+
+  ep_mul(z1z1, p->z, p->z);
+  ep_mul(z2z2, q->z, q->z);
+  ep_mul(u1, p->x, z2z2);
+  ep_mul(u2, q->x, z1z1);
+  ep_mul(s1, p->y, q->z);
+  ep_mul(s1, s1, z2z2);
+  ep_mul(s2, q->y, p->z);
+  ep_mul(s2, s2, z1z1);
+  ep_sub(h, u2, u1);
+  ep_sub(rr, s2, s1);
+
+  if (ep_isZero(h))
+  {
+    if (ep_isZero(rr))
+    {
+      ep_double(r, p);
+    }
+    else
+    {
+      memset(r, 0, sizeof(epPoint_t));
+    }
+    return;
+  }
+
+  ep_mul(hh, h, h);
+  ep_mul(hhh, h, hh);
+  ep_mul(v, u1, hh);
+
+  // z3 = z1 * z2 * h, computed first as r may be p or q
+  ep_mul(t, p->z, q->z);
+  ep_mul(r->z, t, h);
+
+  // x3 = rr^2 - hhh - 2 * v
+  ep_mul(t, rr, rr);
+  ep_sub(t, t, hhh);
+  ep_sub(t, t, v);
+  ep_sub(r->x, t, v);
+
+  // y3 = rr * (v - x3) - s1 * hhh
+  ep_sub(t, v, r->x);
+  ep_mul(t, rr, t);
+  ep_mul(s1, s1, hhh);
+  ep_sub(r->y, t, s1);
+}
+
+/*
+ * (x, y) = k * (px, py), affine coordinates out of the Montgomery
+ * domain. Returns FALSE if the result is the point at infinity.
+ */
+static bool ep_scalarMul(epNum_t x, epNum_t y, const epNum_t k,
+                         const epNum_t px, const epNum_t py)
+{
+  epPoint_t base, acc;
+  epNum_t zInv, zInv2, one = { 1 };
+  int16_t bit;
+
+  ep_mul(base.x, px, epR2);
+  ep_mul(base.y, py, epR2);
+  memcpy(base.z, epOne, sizeof(epNum_t));
+  memset(&acc, 0, sizeof(acc));
+
+  for (bit = 255; bit >= 0; bit--)
+  {
+    ep_double(&acc, &acc);
+    if ((k[bit / 32] >> (bit % 32)) & 1)
+    {
+      ep_addPoints(&acc, &acc, &base);
+    }
+  }
+
+  if (ep_isZero(acc.z))
+  {
+    return FALSE;
+  }
+
+  ep_inv(zInv, acc.z);
+  ep_mul(zInv2, zInv, zInv);
+  ep_mul(x, acc.x, zInv2);
+  ep_mul(zInv2, zInv2, zInv);
+  ep_mul(y, acc.y, zInv2);
+  ep_mul(x, x, one);
+  ep_mul(y, y, one);
+
+  return TRUE;
+}
+
+/*
+ * Whether (x, y) is on the curve: y^2 = x^3 - 3x + b.
+ */
+static bool ep_onCurve(const epNum_t x, const epNum_t y)
+{
+  epNum_t mx, my, mb, l, r, t;
+
+  ep_mul(mx, x, epR2);
+  ep_mul(my, y, epR2);
+  ep_mul(mb, epB, epR2);
+
+  ep_mul(l, my, my);
+  ep_mul(r, mx, mx);
+  ep_mul(r, r, mx);
+  ep_add(t, mx, mx);
+  ep_add(t, t, mx);
+  ep_sub(r, r, t);
+  ep_add(r, r, mb);
+
+  return (memcmp(l, r, sizeof(epNum_t)) == 0);
+}
+
+/*
+ * Set up the Montgomery constants.
+ */
+static void ep_init(void)
+{
+  epNum_t zero = { 0 };
+  uint16_t i;
+
+  // R mod p = 2^256 - p
+  ep_subP(epOne, zero);
+
+  // R^2 mod p, by doubling R 256 times
+  memcpy(epR2, epOne, sizeof(epNum_t));
+  for (i = 0; i < 256; i++)
+  {
+    ep_add(epR2, epR2, epR2);
+  }
+}
+
+/*
+ * The ECC engine is busy for the time of a scalar multiplication.
+ */
+static void ep_spend(void)
+{
+  uint16_t i;
+
+  if (!epTimed)
+  {
+    return;
+  }
+
+  for (i = 0; i < EP_MULT_MS; i++)
+  {
+    Task_sleep(EP_TICKS_PER_MS);
+  }
+}
+
+/*
+ * ECC ROM key pair generation: the random string is the private key.
+ * Buffers hold their length in words, then the number.
+ */
+uint8_t eccRom_genKeys(uint32_t *pRandString, uint32_t *pPrivateKey,
+                       uint32_t *pPublicKeyX, uint32_t *pPublicKeyY)
+{
+  if (pRandString != pPrivateKey)
+  {
+    memcpy(pPrivateKey, pRandString, (EP_WORDS + 1) * sizeof(uint32_t));
+  }
+
+  if (!ep_scalarMul(&pPublicKeyX[1], &pPublicKeyY[1], &pPrivateKey[1],
+                    epGx, epGy))
+  {
+    return ECCROMCC26XX_STATUS_SCALAR_LENGTH_ZERO;
+  }
+
+  ep_spend();
+
+  return ECCROMCC26XX_STATUS_ECDH_KEYGEN_OK;
+}
+
+/*
+ * ECC ROM shared secret generation.
+ */
+uint8_t eccRom_genSharedSecret(uint32_t *pPrivateKey, uint32_t *pPublicKeyX,
+                               uint32_t *pPublicKeyY, uint32_t *pSharedSecretX,
+                               uint32_t *pSharedSecretY)
+{
+  if (!ep_onCurve(&pPublicKeyX[1], &pPublicKeyY[1]))
+  {
+    return ECCROMCC26XX_STATUS_X_COORD_TOO_LONG;
+  }
+
+  if (!ep_scalarMul(&pSharedSecretX[1], &pSharedSecretY[1], &pPrivateKey[1],
+                    &pPublicKeyX[1], &pPublicKeyY[1]))
+  {
+    return ECCROMCC26XX_STATUS_SCALAR_LENGTH_ZERO;
+  }
+
+  ep_spend();
+
+  return ECCROMCC26XX_STATUS_ECDH_COMMON_KEY_OK;
+}
+
+/*********************************************************************
+ * TRNG STUBS
+ */
+
+void TRNGCC26XX_init(void)
+{
+}
+
+TRNGCC26XX_Handle TRNGCC26XX_open(uint8_t index)
+{
+  return NULL;
+}
+
+uint32_t TRNGCC26XX_getNumber(TRNGCC26XX_Handle handle,
+                              TRNGCC26XX_Params *params, int8_t *status)
+{
+  // xorshift32 stands in for the entropy source
+  epRandState ^= epRandState << 13;
+  epRandState ^= epRandState >> 17;
+  epRandState ^= epRandState << 5;
+
+  if (status)
+  {
+    *status = TRNGCC26XX_STATUS_SUCCESS;
+  }
+
+  return epRandState;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8_t *ep_malloc(uint16_t len)
+{
+  return malloc(len);
+}
+
+static void ep_free(uint8_t *pBuf)
+{
+  free(pBuf);
+}
+
+/*
+ * Fill a private key with random words.
+ */
+static void ep_random(uint8_t *pKey)
+{
+  uint8_t i;
+
+  for (i = 0; i < EP_KEY_LEN; i += sizeof(uint32_t))
+  {
+    uint32_t word = TRNGCC26XX_getNumber(NULL, NULL, NULL);
+
+    memcpy(&pKey[i], &word, sizeof(word));
+  }
+}
+
+/*
+ * Check the stand-in against the debug key pair.
+ */
+static void ep_selfTest(void)
+{
+  epNum_t x, y;
+
+  if (!ep_scalarMul(x, y, epDebugPriv, epGx, epGy) ||
+      memcmp(x, epDebugX, sizeof(x)) != 0 ||
+      memcmp(y, epDebugY, sizeof(y)) != 0 || !ep_onCurve(x, y))
+  {
+    printf("P-256 stand-in fails the debug key pair\n");
+    abort();
+  }
+}
+
+/*
+ * Run EP_PAIRINGS pairings with gapMs of idle time before each one.
+ */
+static void ep_run(uint16_t gapMs, bool pool, epStat_t *pStat)
+{
+  ECCROMCC26XX_Params params;
+  uint32_t totalTicks = 0;
+  uint32_t maxTicks = 0;
+  uint8_t i;
+
+  ECCROMCC26XX_Params_init(&params);
+  params.malloc = ep_malloc;
+  params.free = ep_free;
+
+  pStat->ready = 0;
+
+  for (i = 0; i < EP_PAIRINGS; i++)
+  {
+    epKeys_t local, peer;
+    uint8_t dhKeyX[EP_KEY_LEN], dhKeyY[EP_KEY_LEN];
+    uint8_t peerDhKeyX[EP_KEY_LEN], peerDhKeyY[EP_KEY_LEN];
+    UInt32 start;
+    int8_t status;
+
+    // The peer's key pair comes over the air: no simulated time
+    epTimed = FALSE;
+    ep_random(peer.privateKey);
+    ECC_genKeys(peer.privateKey, peer.publicKeyX, peer.publicKeyY, &params);
+    epTimed = TRUE;
+
+    Task_sleep(gapMs * EP_TICKS_PER_MS);
+
+    start = Clock_getTicks();
+
+    ep_random(local.privateKey);
+    if (pool)
+    {
+      pStat->ready += (ECCROMCC26XX_keyPoolCount() != 0);
+      status = ECCROMCC26XX_genKeys(local.privateKey, local.publicKeyX,
+                                    local.publicKeyY, &params);
+    }
+    else
+    {
+      status = ECC_genKeys(local.privateKey, local.publicKeyX,
+                           local.publicKeyY, &params);
+    }
+
+    if (status == ECCROMCC26XX_STATUS_SUCCESS)
+    {
+      status = ECCROMCC26XX_genDHKey(local.privateKey, peer.publicKeyX,
+                                     peer.publicKeyY, dhKeyX, dhKeyY,
+                                     &params);
+    }
+
+    if (status != ECCROMCC26XX_STATUS_SUCCESS)
+    {
+      abort();
+    }
+
+    totalTicks += Clock_getTicks() - start;
+    if (Clock_getTicks() - start > maxTicks)
+    {
+      maxTicks = Clock_getTicks() - start;
+    }
+
+    // Both ends must agree on the DHKey
+    epTimed = FALSE;
+    ECCROMCC26XX_genDHKey(peer.privateKey, local.publicKeyX, local.publicKeyY,
+                          peerDhKeyX, peerDhKeyY, &params);
+    epTimed = TRUE;
+    if (memcmp(dhKeyX, peerDhKeyX, EP_KEY_LEN) != 0)
+    {
+      abort();
+    }
+  }
+
+  pStat->meanMs = (double)totalTicks / EP_PAIRINGS / EP_TICKS_PER_MS;
+  pStat->maxMs = (double)maxTicks / EP_TICKS_PER_MS;
+}
+
+/*
+ * Task function: let the pool fill, then measure.
+ */
+static Void ep_taskFxn(UArg a0, UArg a1)
+{
+  uint8_t i;
+
+  ep_selfTest();
+
+  epTimed = TRUE;
+  ECCROMCC26XX_init();
+
+  printf("gap (ms)   no pool mean/max (ms)    pool mean/max (ms)"
+         "   key pair ready\n");
+
+  for (i = 0; i < sizeof(epGapsMs) / sizeof(epGapsMs[0]); i++)
+  {
+    epStat_t noPool, pool;
+
+    // The pool is full and its task idle before the first measurement
+    Task_sleep(2 * EP_MULT_MS * EP_TICKS_PER_MS *
+               ECCROMCC26XX_KEY_POOL_SIZE);
+
+    ep_run(epGapsMs[i], FALSE, &noPool);
+    ep_run(epGapsMs[i], TRUE, &pool);
+
+    printf("%8u %12.0f %8.0f %13.0f %8.0f %10u/%u\n", epGapsMs[i],
+           noPool.meanMs, noPool.maxMs, pool.meanMs, pool.maxMs, pool.ready,
+           EP_PAIRINGS);
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  Task_Params taskParams;
+
+  ep_init();
+
+  Task_Params_init(&taskParams);
+  taskParams.priority = 1;
+  Task_construct(&epTask, ep_taskFxn, &taskParams, NULL);
+
+  // Returns when the application task is done and the precompute task
+  // waits for a refill request
+  BIOS_start();
+
+  return 0;
+}
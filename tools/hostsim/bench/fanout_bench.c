@@ -0,0 +1,299 @@
+/******************************************************************************
+
+ @file  fanout_bench.c
+
+ @brief This file contains the host benchmark of the notification fan-
+        out of GATTServApp_ProcessCharCfg() to 1 to 16 connections.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Measures one characteristic update sent by
+ * GATTServApp_ProcessCharCfg() to 1, 4, 8 and 16 subscribed connections,
+ * against the loop it replaced, which is reproduced below and looked the
+ * attribute up again for every connection. The notified value is the
+ * last one of a table the size of the Simple Profile's, so each lookup
+ * scans the whole table.
+ *
+ * GATT_bm_alloc() and GATT_Notification() are stubs that hand out and
+ * take back a static buffer, so the figures are the fan-out of
+ * GATTServApp alone. Prints the host CPU cycles per update and per
+ * connection.
+ *
+ * gattservapp_util.c is included rather than linked to reach
+ * gattServApp_SendNotiInd(). Build from the repository root with the
+ * defines and include paths of hostsim.c:
+ *
+ *   gcc -O2 -o fanout_bench <hostsim.c flags> -Ible-stack/host \
+ *       -Itools/hostsim/bench tools/hostsim/bench/fanout_bench.c
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "gattservapp_util.c"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Most connections measured
+#define FB_MAX_CONNS                      16
+
+// Attributes in the table, as many as the Simple Profile has
+#define FB_NUM_ATTRS                      17
+
+// Updates timed per measurement
+#define FB_ROUNDS                         1000000
+
+// Notified value length
+#define FB_VALUE_LEN                      20
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 linkDBNumConns;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Connection counts measured
+static const uint8 fbConnCounts[] = { 1, 4, 8, FB_MAX_CONNS };
+
+static uint8 fbValues[FB_NUM_ATTRS][FB_VALUE_LEN];
+
+static uint8 fbUUID[ATT_BT_UUID_SIZE] = { 0xF4, 0xFF };
+
+#define FB_ATTR(_i) \
+  { { ATT_BT_UUID_SIZE, fbUUID }, GATT_PERMIT_READ, 0x20 + (_i), fbValues[_i] }
+
+static gattAttribute_t fbAttrTbl[FB_NUM_ATTRS] =
+{
+  FB_ATTR(0),  FB_ATTR(1),  FB_ATTR(2),  FB_ATTR(3),  FB_ATTR(4),
+  FB_ATTR(5),  FB_ATTR(6),  FB_ATTR(7),  FB_ATTR(8),  FB_ATTR(9),
+  FB_ATTR(10), FB_ATTR(11), FB_ATTR(12), FB_ATTR(13), FB_ATTR(14),
+  FB_ATTR(15), FB_ATTR(16)
+};
+
+static gattCharCfg_t fbConfig[FB_MAX_CONNS];
+
+// Buffer handed out by GATT_bm_alloc()
+static uint8 fbBuf[ATT_MTU_SIZE];
+
+// Notifications the "stack" was handed, checked to keep the sends from
+// being optimized out
+static uint32_t fbSent;
+
+/*********************************************************************
+ * STACK STUBS
+ */
+
+uint8 linkDB_State(uint16 connectionHandle, uint8 state)
+{
+  return connectionHandle < linkDBNumConns;
+}
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+  *pSizeAlloc = sizeof(fbBuf);
+
+  return fbBuf;
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+}
+
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+  fbSent += pNoti->pValue[0];
+
+  return SUCCESS;
+}
+
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                          uint8 authenticated, uint8 taskId)
+{
+  return FAILURE;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Read callback of the notified value.
+ */
+static bStatus_t fb_readAttrCB(uint16 connHandle, gattAttribute_t *pAttr,
+                               uint8 *pValue, uint16 *pLen, uint16 offset,
+                               uint16 maxLen, uint8 method)
+{
+  *pLen = MIN(FB_VALUE_LEN, maxLen);
+  memcpy(pValue, pAttr->pValue, *pLen);
+
+  return SUCCESS;
+}
+
+/*
+ * GATTServApp_ProcessCharCfg() as it was before the attribute was
+ * resolved once per call. Not inlined, like the function it is compared
+ * with.
+ */
+static __attribute__((noinline))
+bStatus_t fb_oldProcessCharCfg(gattCharCfg_t *charCfgTbl,
+                               uint8 *pValue, uint8 authenticated,
+                               gattAttribute_t *attrTbl,
+                               uint16 numAttrs, uint8 taskId,
+                               pfnGATTReadAttrCB_t pfnReadAttrCB)
+{
+  uint8 i;
+  bStatus_t status = SUCCESS;
+
+  for (i = 0; i < linkDBNumConns; i++)
+  {
+    gattCharCfg_t *pItem = &(charCfgTbl[i]);
+
+    if ((pItem->connHandle != INVALID_CONNHANDLE) &&
+        (pItem->value != GATT_CFG_NO_OPERATION))
+    {
+      gattAttribute_t *pAttr;
+
+      // Find the characteristic value attribute
+      pAttr = GATTServApp_FindAttr(attrTbl, numAttrs, pValue);
+      if (pAttr != NULL)
+      {
+        if (pItem->value & GATT_CLIENT_CFG_NOTIFY)
+        {
+          status |= gattServApp_SendNotiInd(pItem->connHandle,
+                                            GATT_CLIENT_CFG_NOTIFY,
+                                            authenticated, pAttr, taskId,
+                                            pfnReadAttrCB);
+        }
+
+        if (pItem->value & GATT_CLIENT_CFG_INDICATE)
+        {
+          status |= gattServApp_SendNotiInd(pItem->connHandle,
+                                            GATT_CLIENT_CFG_INDICATE,
+                                            authenticated, pAttr, taskId,
+                                            pfnReadAttrCB);
+        }
+      }
+    }
+  }
+
+  return status;
+}
+
+/*
+ * Cycles per update of FB_ROUNDS updates.
+ */
+static double fb_run(bool old)
+{
+  uint8 *pValue = fbValues[FB_NUM_ATTRS - 1];
+  bench_t bench;
+  uint32_t round;
+
+  bench_start(&bench);
+  for (round = 0; round < FB_ROUNDS; round++)
+  {
+    pValue[0] = (uint8)round;
+
+    if (old)
+    {
+      fb_oldProcessCharCfg(fbConfig, pValue, FALSE, fbAttrTbl, FB_NUM_ATTRS,
+                           INVALID_TASK_ID, fb_readAttrCB);
+    }
+    else
+    {
+      GATTServApp_ProcessCharCfg(fbConfig, pValue, FALSE, fbAttrTbl,
+                                 FB_NUM_ATTRS, INVALID_TASK_ID,
+                                 fb_readAttrCB);
+    }
+  }
+  bench_stop(&bench);
+
+  return (double)bench.cycles / FB_ROUNDS;
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint8 i;
+
+  printf("cycles per update      per connection\n");
+  printf("conns    old    new      old    new\n");
+
+  for (i = 0; i < sizeof(fbConnCounts); i++)
+  {
+    uint8 c;
+    double old, cur;
+
+    // Profiles size their tables with linkDBNumConns
+    linkDBNumConns = fbConnCounts[i];
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, fbConfig);
+    for (c = 0; c < linkDBNumConns; c++)
+    {
+      GATTServApp_WriteCharCfg(c, fbConfig, GATT_CLIENT_CFG_NOTIFY);
+    }
+
+    // Warm up the caches
+    fb_run(TRUE);
+    fb_run(FALSE);
+
+    old = fb_run(TRUE);
+    cur = fb_run(FALSE);
+
+    printf("%5u %6.0f %6.0f %8.0f %6.0f\n", linkDBNumConns, old, cur,
+           old / linkDBNumConns, cur / linkDBNumConns);
+  }
+
+  return (fbSent == 0);
+}
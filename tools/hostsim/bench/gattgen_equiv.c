@@ -0,0 +1,350 @@
+/******************************************************************************
+
+ @file  gattgen_equiv.c
+
+ @brief This file contains the equivalence check of a generated GATT
+        profile against the hand-written simple profile.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Checks that a profile generated by tools/gattgen/gattgen.py behaves
+ * like the hand-written one. The driver includes the profile source
+ * given by PROFILE_SRC, so it sees its attribute table and callbacks,
+ * and prints a transcript of what every attribute does on reads and
+ * writes of each length and offset, local requests included, and of
+ * SetParameter and GetParameter on every parameter. The transcripts of
+ * the two profiles must be identical.
+ *
+ * Build from the repository root with the defines and include paths of
+ * hostsim.c, once per profile, and compare:
+ *
+ *   python3 tools/gattgen/gattgen.py tools/gattgen/simple_profile.json \
+ *       -o /tmp/gattgen
+ *   gcc -o equiv_hand <hostsim.c flags> \
+ *       -DPROFILE_SRC='"<repo>/ble-stack/profiles/simple_profile/cc26xx/simple_gatt_profile.c"' \
+ *       tools/hostsim/bench/gattgen_equiv.c \
+ *       ble-stack/host/gattservapp_util.c ble-stack/host/gatt_uuid.c
+ *   gcc -o equiv_gen <hostsim.c flags> \
+ *       -DPROFILE_SRC='"/tmp/gattgen/simple_gatt_profile.c"' \
+ *       tools/hostsim/bench/gattgen_equiv.c \
+ *       ble-stack/host/gattservapp_util.c ble-stack/host/gatt_uuid.c
+ *   ./equiv_hand > hand.txt; ./equiv_gen > gen.txt; diff hand.txt gen.txt
+ *
+ * PROFILE_SRC is an absolute path so that the profile includes its own
+ * header first: the generated one next to it, the hand-written one from
+ * the include path.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include PROFILE_SRC
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Connection the requests are received on
+#define EQUIV_CONN_HANDLE                 0
+
+// Largest value written or read
+#define EQUIV_MAX_LEN                     8
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 linkDBNumConns = 1;
+
+static ICall_Errno equiv_dispatch(ICall_FuncArgsHdr *args);
+
+// Serves ICall_malloc() only
+ICall_Dispatcher ICall_dispatcher = equiv_dispatch;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Parameter reported by the last change and read callbacks
+static int equivChanged;
+static int equivRead;
+
+/*********************************************************************
+ * STACK STUBS
+ */
+
+static ICall_Errno equiv_dispatch(ICall_FuncArgsHdr *args)
+{
+  if (args->service == ICALL_SERVICE_CLASS_PRIMITIVE &&
+      args->func == ICALL_PRIMITIVE_FUNC_MALLOC)
+  {
+    ((ICall_AllocArgs *)args)->ptr = malloc(((ICall_AllocArgs *)args)->size);
+    return ICALL_ERRNO_SUCCESS;
+  }
+
+  return ICALL_ERRNO_INVALID_FUNCTION;
+}
+
+uint8 osal_memcmp(const void GENERIC *src1, const void GENERIC *src2,
+                  unsigned int len)
+{
+  return memcmp(src1, src2, len) == 0;
+}
+
+bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs,
+                                      uint16 numAttrs, uint8 encKeySize,
+                                      CONST gattServiceCBs_t *pServiceCBs)
+{
+  uint16 i;
+
+  // Handles as the GATT Server would assign them
+  for (i = 0; i < numAttrs; i++)
+  {
+    pAttrs[i].handle = i + 1;
+  }
+
+  return SUCCESS;
+}
+
+uint8 linkDB_State(uint16 connectionHandle, uint8 state)
+{
+  return connectionHandle == EQUIV_CONN_HANDLE;
+}
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+  return NULL;
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+}
+
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+  return SUCCESS;
+}
+
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                          uint8 authenticated, uint8 taskId)
+{
+  return SUCCESS;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void equiv_changeCB(uint8 paramID)
+{
+  equivChanged = paramID;
+}
+
+static void equiv_readCB(uint8 paramID)
+{
+  equivRead = paramID;
+}
+
+static simpleProfileCBs_t equivCBs =
+{
+  equiv_changeCB,
+  equiv_readCB
+};
+
+/*********************************************************************
+ * @fn      equiv_printParams
+ *
+ * @brief   Print the value of every profile parameter.
+ */
+static void equiv_printParams(void)
+{
+  uint8 param;
+
+  printf("   params");
+  for (param = SIMPLEPROFILE_CHAR1; param <= SIMPLEPROFILE_CHAR5; param++)
+  {
+    uint8 value[EQUIV_MAX_LEN] = { 0 };
+    uint8 i;
+
+    SimpleProfile_GetParameter(param, value);
+    printf(" ");
+    for (i = 0; i < (param == SIMPLEPROFILE_CHAR5 ?
+                     SIMPLEPROFILE_CHAR5_LEN : 1); i++)
+    {
+      printf("%02x", value[i]);
+    }
+  }
+  printf("\n");
+}
+
+/*********************************************************************
+ * @fn      equiv_access
+ *
+ * @brief   Read and write an attribute through the profile callbacks
+ *          with every length and offset, as a peer and locally.
+ *
+ * @param   pAttr - attribute, need not be in the profile table
+ * @param   name - attribute name printed
+ */
+static void equiv_access(gattAttribute_t *pAttr, const char *name)
+{
+  static uint8 pattern = 0x10;
+  uint8 method;
+
+  for (method = 0; method < 2; method++)
+  {
+    uint8 readMethod = method ? GATT_LOCAL_READ : ATT_READ_REQ;
+    uint8 writeMethod = method ? GATT_LOCAL_WRITE : ATT_WRITE_REQ;
+    uint16 offset;
+    uint16 len;
+
+    for (offset = 0; offset < 2; offset++)
+    {
+      uint8 value[EQUIV_MAX_LEN];
+      uint16 maxLen;
+
+      for (maxLen = 1; maxLen <= EQUIV_MAX_LEN; maxLen += EQUIV_MAX_LEN - 1)
+      {
+        uint16 readLen = 0;
+        uint16 i;
+        bStatus_t status;
+
+        memset(value, 0xEE, sizeof(value));
+        equivRead = -1;
+        status = simpleProfileCBs.pfnReadAttrCB(EQUIV_CONN_HANDLE, pAttr,
+                                                value, &readLen, offset,
+                                                maxLen, readMethod);
+        printf("%s %s read offset %u max %u: status 0x%02x read %d len %u",
+               name, method ? "local" : "peer", offset, maxLen, status,
+               equivRead, readLen);
+        for (i = 0; status == SUCCESS && i < readLen; i++)
+        {
+          printf(" %02x", value[i]);
+        }
+        printf("\n");
+      }
+
+      for (len = 0; len <= SIMPLEPROFILE_CHAR5_LEN + 1; len++)
+      {
+        bStatus_t status;
+        uint16 i;
+
+        for (i = 0; i < len; i++)
+        {
+          value[i] = pattern++;
+        }
+
+        // A valid configuration when written to a CCC
+        if (len == 2)
+        {
+          value[0] = LO_UINT16(GATT_CLIENT_CFG_NOTIFY);
+          value[1] = HI_UINT16(GATT_CLIENT_CFG_NOTIFY);
+        }
+
+        equivChanged = -1;
+        status = simpleProfileCBs.pfnWriteAttrCB(EQUIV_CONN_HANDLE, pAttr,
+                                                 value, len, offset,
+                                                 writeMethod);
+        printf("%s %s write offset %u len %u: status 0x%02x changed %d\n",
+               name, method ? "local" : "peer", offset, len, status,
+               equivChanged);
+        equiv_printParams();
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  gattAttribute_t other = simpleProfileAttrTbl[0];
+  uint8 param;
+  uint16 i;
+
+  if (SimpleProfile_AddService(SIMPLEPROFILE_SERVICE) != SUCCESS)
+  {
+    printf("AddService failed\n");
+    return 1;
+  }
+  SimpleProfile_RegisterAppCBs(&equivCBs);
+
+  printf("%u attributes\n", (unsigned)GATT_NUM_ATTRS(simpleProfileAttrTbl));
+
+  for (i = 0; i < GATT_NUM_ATTRS(simpleProfileAttrTbl); i++)
+  {
+    gattAttribute_t *pAttr = &simpleProfileAttrTbl[i];
+    char name[16];
+
+    printf("attr %u: permissions 0x%02x\n", pAttr->handle,
+           pAttr->permissions);
+    snprintf(name, sizeof(name), "attr %u", pAttr->handle);
+    equiv_access(pAttr, name);
+  }
+
+  // An attribute of another table is refused, not looked up
+  equiv_access(&other, "other");
+
+  for (param = SIMPLEPROFILE_CHAR1; param <= SIMPLEPROFILE_CHAR5 + 1; param++)
+  {
+    uint8 len;
+
+    for (len = 0; len <= SIMPLEPROFILE_CHAR5_LEN + 1; len++)
+    {
+      uint8 value[EQUIV_MAX_LEN];
+
+      memset(value, 0x40 + param * 8 + len, sizeof(value));
+      printf("set %u len %u: status 0x%02x\n", param, len,
+             SimpleProfile_SetParameter(param, len, value));
+      equiv_printParams();
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,616 @@
+/******************************************************************************
+
+ @file  heap_replay.c
+
+ @brief This file contains the host replay harness of heap allocation
+        traces for the heapmgr backends.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Replays an allocation trace into heapmgr.h and reports the malloc and
+ * free times (p50, p99 and longest, in host CPU cycles; the longest
+ * calls are usually the ones the host OS preempted), with the mallocs
+ * that fit the default segregated size classes apart from the larger
+ * ones, the allocations that failed and the fragmentation of the heap at
+ * the end of each connection.
+ *
+ * The backend is chosen at build time, as on the target: build once
+ * without and once with HEAPMGR_SEGREGATED and replay the same trace into
+ * both. From the repository root, with the defines and include paths of
+ * hostsim.c:
+ *
+ *   gcc -O2 -o heap_replay_ff <hostsim.c flags> -DHEAPMGR_METRICS \
+ *       -Itools/hostsim/bench tools/hostsim/bench/heap_replay.c
+ *   gcc -O2 -o heap_replay_seg <hostsim.c flags> -DHEAPMGR_METRICS \
+ *       -DHEAPMGR_SEGREGATED -Itools/hostsim/bench \
+ *       tools/hostsim/bench/heap_replay.c
+ *
+ * Usage: heap_replay [-w out] [trace]
+ *
+ *   -w  write the trace replayed, e.g. the built-in one, to a file
+ *
+ * A trace holds one operation per line; '#' starts a comment:
+ *
+ *   a <id> <size>   allocate size octets as block id
+ *   f <id>          free block id
+ *   c               end of a connection: sample the fragmentation
+ *
+ * Without a trace, a model of CONN_CYCLES connections of the simple
+ * peripheral is replayed, generated from a fixed seed so both builds see
+ * the same operations: per connection, link state held until the
+ * disconnect, app events with their queue records, ICall stack messages,
+ * ATT PDUs and notification buffers held for a few steps, prepare write
+ * queues held for longer and a bond record that outlives the connection.
+ *
+ * Fragmentation is 1 - largest free extent / free memory, counting
+ * adjacent free blocks not yet coalesced as one extent. Blocks cached on
+ * the segregated class lists are reported apart.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <heapmgr.h>
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Connections of the built-in trace and steps of each
+#define HR_CONN_CYCLES                    2000
+#define HR_CONN_STEPS                     300
+
+// Blocks held at once by the built-in trace, at most
+#define HR_MAX_LIVE                       64
+
+// Largest request that fits the default segregated size classes: the
+// 128 octet class less the 4 octet header, as in the "malloc>124" label
+#define HR_CLASS_MAX                      124
+
+// Longest trace line
+#define HR_LINE_LEN                       64
+
+// Trace operations
+#define HR_OP_ALLOC                       'a'
+#define HR_OP_FREE                        'f'
+#define HR_OP_CONN_END                    'c'
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Trace operation
+typedef struct
+{
+  char op;
+  uint32_t id;
+  uint16_t size;
+} hrOp_t;
+
+// Block held by the built-in trace until step freeAt
+typedef struct
+{
+  uint32_t id;
+  uint32_t freeAt;
+} hrLive_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Trace replayed
+static hrOp_t *hrOps;
+static uint32_t hrNumOps;
+static uint32_t hrOpsSize;
+
+// Built-in trace generator state
+static uint32_t hrSeed = 1;
+static uint32_t hrNextId;
+static hrLive_t hrLive[HR_MAX_LIVE];
+static uint8_t hrNumLive;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Append an operation to the trace.
+ */
+static void hr_add(char op, uint32_t id, uint16_t size)
+{
+  if (hrNumOps == hrOpsSize)
+  {
+    hrOpsSize = hrOpsSize ? hrOpsSize * 2 : 4096;
+    hrOps = realloc(hrOps, hrOpsSize * sizeof(hrOp_t));
+    if (hrOps == NULL)
+    {
+      abort();
+    }
+  }
+
+  hrOps[hrNumOps].op = op;
+  hrOps[hrNumOps].id = id;
+  hrOps[hrNumOps].size = size;
+  hrNumOps++;
+}
+
+/*
+ * Pseudo random number in [lo, hi].
+ */
+static uint16_t hr_rand(uint16_t lo, uint16_t hi)
+{
+  hrSeed = hrSeed * 1103515245u + 12345u;
+
+  return lo + (uint16_t)((hrSeed >> 16) % (hi - lo + 1));
+}
+
+/*
+ * Allocate a block of the built-in trace, freed at step freeAt, or never
+ * by this helper if freeAt is 0.
+ */
+static uint32_t hr_modelAlloc(uint16_t size, uint32_t freeAt)
+{
+  uint32_t id = hrNextId++;
+
+  hr_add(HR_OP_ALLOC, id, size);
+
+  if (freeAt != 0 && hrNumLive < HR_MAX_LIVE)
+  {
+    hrLive[hrNumLive].id = id;
+    hrLive[hrNumLive].freeAt = freeAt;
+    hrNumLive++;
+  }
+  else if (freeAt != 0)
+  {
+    hr_add(HR_OP_FREE, id, 0);
+  }
+
+  return id;
+}
+
+/*
+ * Free the blocks of the built-in trace that are due at step.
+ */
+static void hr_modelFreeDue(uint32_t step)
+{
+  uint8_t i = 0;
+
+  while (i < hrNumLive)
+  {
+    if (hrLive[i].freeAt <= step)
+    {
+      hr_add(HR_OP_FREE, hrLive[i].id, 0);
+      hrLive[i] = hrLive[--hrNumLive];
+    }
+    else
+    {
+      i++;
+    }
+  }
+}
+
+/*
+ * Generate the built-in trace.
+ */
+static void hr_model(void)
+{
+  uint32_t step = 0;
+  uint32_t bond[2] = { 0, 0 };
+  uint16_t conn;
+
+  for (conn = 0; conn < HR_CONN_CYCLES; conn++)
+  {
+    uint32_t link[3];
+    uint16_t i;
+
+    // Link state of the connection: GAPRole, GATT client configuration,
+    // L2CAP
+    link[0] = hr_modelAlloc(hr_rand(40, 48), 0);
+    link[1] = hr_modelAlloc(hr_rand(12, 24), 0);
+    link[2] = hr_modelAlloc(hr_rand(60, 100), 0);
+
+    for (i = 0; i < HR_CONN_STEPS; i++, step++)
+    {
+      switch (hr_rand(0, 9))
+      {
+        case 0:
+        case 1:
+        case 2:
+          // App event and its queue record
+          hr_modelAlloc(8, step + hr_rand(0, 3));
+          hr_modelAlloc(8, step + hr_rand(0, 3));
+          break;
+
+        case 3:
+        case 4:
+          // ICall stack message: header and GAP/GATT event body
+          hr_modelAlloc(12 + hr_rand(8, 40), step + hr_rand(0, 2));
+          break;
+
+        case 5:
+        case 6:
+          // ATT request PDU
+          hr_modelAlloc(hr_rand(27, 251), step + hr_rand(1, 4));
+          break;
+
+        case 7:
+        case 8:
+          // Notification buffer, held until the controller takes it
+          hr_modelAlloc(hr_rand(20, 244), step + hr_rand(1, 8));
+          break;
+
+        default:
+          // Prepare write queue, held until the execute write
+          if (hr_rand(0, 3) == 0)
+          {
+            hr_modelAlloc(hr_rand(64, 200), step + hr_rand(20, 60));
+          }
+          break;
+      }
+
+      hr_modelFreeDue(step);
+
+      // The bond record of a new pairing replaces the one of two
+      // connections ago
+      if (i == HR_CONN_STEPS / 2 && hr_rand(0, 3) == 0)
+      {
+        if (bond[conn & 1] != 0)
+        {
+          hr_add(HR_OP_FREE, bond[conn & 1], 0);
+        }
+        bond[conn & 1] = hr_modelAlloc(hr_rand(16, 64), 0);
+      }
+    }
+
+    // Disconnect
+    hr_modelFreeDue(UINT32_MAX);
+    for (i = 0; i < 3; i++)
+    {
+      hr_add(HR_OP_FREE, link[i], 0);
+    }
+    hr_add(HR_OP_CONN_END, 0, 0);
+  }
+}
+
+/*
+ * Load a trace file.
+ */
+static bool hr_load(const char *pPath)
+{
+  FILE *pFile = fopen(pPath, "r");
+  char line[HR_LINE_LEN];
+  uint32_t lineNum = 0;
+
+  if (pFile == NULL)
+  {
+    perror(pPath);
+
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), pFile) != NULL)
+  {
+    char op;
+    unsigned long id = 0, size = 0;
+    int n;
+
+    lineNum++;
+
+    n = sscanf(line, " %c %lu %lu", &op, &id, &size);
+    if (n <= 0 || op == '#')
+    {
+      continue;
+    }
+
+    if ((op == HR_OP_ALLOC && n == 3 && size <= 0xFFFF) ||
+        (op == HR_OP_FREE && n == 2) || op == HR_OP_CONN_END)
+    {
+      hr_add(op, (uint32_t)id, (uint16_t)size);
+      if (id >= hrNextId)
+      {
+        hrNextId = id + 1;
+      }
+    }
+    else
+    {
+      fprintf(stderr, "%s:%u: bad operation\n", pPath, lineNum);
+      fclose(pFile);
+
+      return false;
+    }
+  }
+
+  fclose(pFile);
+
+  return true;
+}
+
+/*
+ * Write the trace to a file.
+ */
+static bool hr_save(const char *pPath)
+{
+  FILE *pFile = fopen(pPath, "w");
+  uint32_t i;
+
+  if (pFile == NULL)
+  {
+    perror(pPath);
+
+    return false;
+  }
+
+  for (i = 0; i < hrNumOps; i++)
+  {
+    if (hrOps[i].op == HR_OP_ALLOC)
+    {
+      fprintf(pFile, "a %u %u\n", hrOps[i].id, hrOps[i].size);
+    }
+    else if (hrOps[i].op == HR_OP_FREE)
+    {
+      fprintf(pFile, "f %u\n", hrOps[i].id);
+    }
+    else
+    {
+      fprintf(pFile, "c\n");
+    }
+  }
+
+  fclose(pFile);
+
+  return true;
+}
+
+/*
+ * Fragmentation of the heap, from a walk of its blocks.
+ */
+static double hr_frag(uint32_t *pFree, uint32_t *pLargest)
+{
+  hmU8_t *pBlk = HEAPMGR_HEAP;
+  uint32_t free = 0, largest = 0, extent = 0;
+
+  for (;;)
+  {
+    heapmgrHdr_t hdr = *(heapmgrHdr_t *)pBlk;
+    heapmgrHdr_t size = hdr & ~HEAPMGR_IN_USE;
+
+    if (size == 0)
+    {
+      break;
+    }
+
+    if (hdr & HEAPMGR_IN_USE)
+    {
+      extent = 0;
+    }
+    else
+    {
+      free += size;
+      extent += size;
+      if (extent > largest)
+      {
+        largest = extent;
+      }
+    }
+
+    pBlk += size;
+  }
+
+  *pFree = free;
+  *pLargest = largest;
+
+  return free ? 1.0 - (double)largest / free : 0.0;
+}
+
+/*
+ * Order call times for qsort().
+ */
+static int hr_cmp(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*
+ * Print the p50, p99 (nearest rank) and longest of count call times.
+ */
+static void hr_report(const char *name, uint32_t *pCycles, uint32_t count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  qsort(pCycles, count, sizeof(uint32_t), hr_cmp);
+
+  printf("%-10s %9u calls  p50 %5u  p99 %5u  max %7u cycles\n", name, count,
+         pCycles[(count * 50 + 99) / 100 - 1],
+         pCycles[(count * 99 + 99) / 100 - 1], pCycles[count - 1]);
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(int argc, char *argv[])
+{
+  const char *pOut = NULL;
+  void **pBlks;
+  uint32_t *pAllocCycles, *pLargeCycles, *pFreeCycles;
+  uint32_t numAllocs = 0, numLarge = 0, numFrees = 0, fails = 0, conns = 0;
+  uint32_t free, largest;
+  double frag, fragSum = 0, fragMax = 0;
+  uint32_t i;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "w:")) != -1)
+  {
+    if (opt == 'w')
+    {
+      pOut = optarg;
+    }
+    else
+    {
+      optind = argc + 1;
+    }
+  }
+
+  if (optind > argc || argc - optind > 1)
+  {
+    fprintf(stderr, "usage: %s [-w out] [trace]\n", argv[0]);
+
+    return 2;
+  }
+
+  if (optind < argc)
+  {
+    if (!hr_load(argv[optind]))
+    {
+      return 1;
+    }
+  }
+  else
+  {
+    hr_model();
+  }
+
+  if (pOut != NULL && !hr_save(pOut))
+  {
+    return 1;
+  }
+
+  pBlks = calloc(hrNextId, sizeof(void *));
+  pAllocCycles = malloc(hrNumOps * sizeof(uint32_t));
+  pLargeCycles = malloc(hrNumOps * sizeof(uint32_t));
+  pFreeCycles = malloc(hrNumOps * sizeof(uint32_t));
+  if (pBlks == NULL || pAllocCycles == NULL || pLargeCycles == NULL ||
+      pFreeCycles == NULL)
+  {
+    return 1;
+  }
+
+  HEAPMGR_INIT();
+
+  for (i = 0; i < hrNumOps; i++)
+  {
+    const hrOp_t *pOp = &hrOps[i];
+    uint64_t start;
+    uint32_t cycles;
+
+    if (pOp->op == HR_OP_ALLOC)
+    {
+      start = bench_cycles();
+      pBlks[pOp->id] = HEAPMGR_MALLOC(pOp->size);
+      cycles = (uint32_t)(bench_cycles() - start);
+
+      if (pOp->size <= HR_CLASS_MAX)
+      {
+        pAllocCycles[numAllocs++] = cycles;
+      }
+      else
+      {
+        pLargeCycles[numLarge++] = cycles;
+      }
+
+      if (pBlks[pOp->id] == NULL)
+      {
+        fails++;
+      }
+    }
+    else if (pOp->op == HR_OP_FREE)
+    {
+      if (pBlks[pOp->id] != NULL)
+      {
+        start = bench_cycles();
+        HEAPMGR_FREE(pBlks[pOp->id]);
+        pFreeCycles[numFrees++] = (uint32_t)(bench_cycles() - start);
+
+        pBlks[pOp->id] = NULL;
+      }
+    }
+    else
+    {
+      frag = hr_frag(&free, &largest);
+      fragSum += frag;
+      if (frag > fragMax)
+      {
+        fragMax = frag;
+      }
+      conns++;
+    }
+  }
+
+#ifdef HEAPMGR_SEGREGATED
+  printf("segregated backend, %u octet heap\n", HEAPMGR_SIZE);
+#else
+  printf("first-fit backend, %u octet heap\n", HEAPMGR_SIZE);
+#endif
+
+  hr_report("malloc", pAllocCycles, numAllocs);
+  hr_report("malloc>124", pLargeCycles, numLarge);
+  hr_report("free", pFreeCycles, numFrees);
+  printf("failed allocations %u\n", fails);
+
+  frag = hr_frag(&free, &largest);
+  if (conns != 0)
+  {
+    printf("fragmentation after %u connections: mean %.1f%%, worst %.1f%%\n",
+           conns, 100 * fragSum / conns, 100 * fragMax);
+  }
+  printf("at the end: %u octets free, largest extent %u (%.1f%%)",
+         free, largest, 100 * frag);
+#ifdef HEAPMGR_SEGREGATED
+  printf(", %u cached on the class lists", HEAPMGR_GETSEGCACHED());
+#endif
+  printf("\n");
+
+  return 0;
+}
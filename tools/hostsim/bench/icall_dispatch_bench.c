@@ -0,0 +1,266 @@
+/******************************************************************************
+
+ @file  icall_dispatch_bench.c
+
+ @brief This file contains the host benchmark of the ICall dispatcher
+        with 2, 8 and 16 registered tasks.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Counts ICall dispatcher calls per second with 2, 8 and
+ * ICALL_MAX_NUM_TASKS tasks registered with ICall. Each task enrolls two
+ * services of its own class: instance 0, which the direct-mapped service
+ * table covers, and instance 1, which is still found by scanning
+ * ICall_entities. The last task created, the furthest from the start of
+ * both tables, then times:
+ *
+ *  - dispatch: an ICall_dispatcher() call to the service of the last
+ *    task, by the mapped and by the scanned service id;
+ *  - fetch: ICall_fetchMsg() on its empty queue, which looks up the
+ *    calling task, with the task entry cached in the task environment
+ *    and with the cache defeated, falling back to the ICall_tasks scan.
+ *
+ * icall.c is included rather than linked to size its tables for the
+ * benchmark. Build from the repository root with the defines and include
+ * paths of hostsim.c:
+ *
+ *   gcc -O2 -o icall_dispatch_bench <hostsim.c flags> \
+ *       -Itools/hostsim/bench tools/hostsim/bench/icall_dispatch_bench.c \
+ *       tools/hostsim/host_rtos.c tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+// Room for ICALL_MAX_NUM_TASKS tasks of two services each
+#undef ICALL_MAX_NUM_TASKS
+#define ICALL_MAX_NUM_TASKS               16
+#undef ICALL_MAX_NUM_ENTITIES
+#define ICALL_MAX_NUM_ENTITIES            (2 * ICALL_MAX_NUM_TASKS + 1)
+
+#include "icall.c"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Calls timed per measurement
+#define DB_ROUNDS                         2000000
+
+// Service class of the first task, one class per task after it
+#define DB_FIRST_CLASS                    ICALL_SERVICE_CLASS_BLE
+
+// Instance of the services the direct-mapped table does not cover
+#define DB_SCANNED_INSTANCE               1
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, unused: no remote task is created
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { NULL };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Task counts measured
+static const uint8_t dbTaskCounts[] = { 2, 8, ICALL_MAX_NUM_TASKS };
+
+// Tasks of each measurement, which stay with the kernel once created,
+// and the task count of the current one
+static Task_Struct dbTasks[sizeof(dbTaskCounts)][ICALL_MAX_NUM_TASKS];
+static uint8_t dbNumTasks;
+
+// Measured rates (calls per second): dispatch mapped/scanned, fetch
+// cached/scanned
+static double dbRates[4];
+
+// Calls handled by dbServiceFn, checked so the calls are not dropped
+static uint32_t dbCalls;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Service function of the enrolled services.
+ */
+static ICall_Errno dbServiceFn(ICall_FuncArgsHdr *args)
+{
+  dbCalls++;
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/*
+ * Calls per second of DB_ROUNDS dispatcher calls to service.
+ */
+static double db_dispatch(ICall_ServiceEnum service)
+{
+  ICall_FuncArgsHdr args;
+  bench_t bench;
+  uint32_t round;
+  UInt key;
+
+  args.service = service;
+  args.func = 0;
+
+  // Interrupts off, see db_fetch()
+  key = Hwi_disable();
+  bench_start(&bench);
+  for (round = 0; round < DB_ROUNDS; round++)
+  {
+    ICall_dispatcher(&args);
+  }
+  bench_stop(&bench);
+  Hwi_restore(key);
+
+  return DB_ROUNDS * 1e9 / bench.ns;
+}
+
+/*
+ * Calls per second of DB_ROUNDS ICall_fetchMsg() calls.
+ */
+static double db_fetch(void)
+{
+  ICall_EntityID src, dest;
+  void *pMsg;
+  bench_t bench;
+  uint32_t round;
+  UInt key;
+
+  // With interrupts already off, leaving the critical sections of the
+  // lookup does not run the host scheduler, whose cost grows with the
+  // number of tasks and would be charged to ICall
+  key = Hwi_disable();
+  bench_start(&bench);
+  for (round = 0; round < DB_ROUNDS; round++)
+  {
+    ICall_fetchMsg(&src, &dest, &pMsg);
+  }
+  bench_stop(&bench);
+  Hwi_restore(key);
+
+  return DB_ROUNDS * 1e9 / bench.ns;
+}
+
+/*
+ * Task function: enroll the two services of the task, then wait, or
+ * measure in the last task.
+ */
+static Void db_taskFxn(UArg a0, UArg a1)
+{
+  ICall_ServiceEnum service = DB_FIRST_CLASS +
+                              (ICall_ServiceEnum)a0 * 8;
+  ICall_EntityID entity;
+  ICall_SyncHandle syncHandle;
+  static uint8_t foreignEnv;
+
+  ICall_enrollService(service, dbServiceFn, &entity, &syncHandle);
+  ICall_enrollService(service + DB_SCANNED_INSTANCE, dbServiceFn, &entity,
+                      &syncHandle);
+
+  if (a0 != dbNumTasks - 1)
+  {
+    // Stay registered while the last task measures
+    ICall_wait(ICALL_TIMEOUT_FOREVER);
+
+    return;
+  }
+
+  dbRates[0] = db_dispatch(service);
+  dbRates[1] = db_dispatch(service + DB_SCANNED_INSTANCE);
+  dbRates[2] = db_fetch();
+
+  // An environment pointer the task does not own is never replaced, so
+  // every lookup scans ICall_tasks
+  Task_setEnv(Task_self(), &foreignEnv);
+  dbRates[3] = db_fetch();
+  Task_setEnv(Task_self(), NULL);
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint8_t i;
+
+  printf("million calls/s     dispatch            fetch\n");
+  printf("tasks          mapped  scanned    cached  scanned\n");
+
+  for (i = 0; i < sizeof(dbTaskCounts); i++)
+  {
+    Task_Params params;
+    uint8_t t;
+
+    dbNumTasks = dbTaskCounts[i];
+
+    ICall_init();
+
+    // Equal priorities run in creation order, so the last task enrolls
+    // last
+    Task_Params_init(&params);
+    for (t = 0; t < dbNumTasks; t++)
+    {
+      params.arg0 = t;
+      Task_construct(&dbTasks[i][t], db_taskFxn, &params, NULL);
+    }
+
+    // Returns when every task is blocked or done
+    BIOS_start();
+
+    printf("%5u %12.1f %8.1f %9.1f %8.1f\n", dbNumTasks,
+           dbRates[0] / 1e6, dbRates[1] / 1e6, dbRates[2] / 1e6,
+           dbRates[3] / 1e6);
+  }
+
+  return (dbCalls == 0);
+}
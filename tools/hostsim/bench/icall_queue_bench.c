@@ -0,0 +1,322 @@
+/******************************************************************************
+
+ @file  icall_queue_bench.c
+
+ @brief This file contains the host benchmark of the ICall message
+        queue operations at queue depths from 1 to 256.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Measures ICall_msgEnqueue() and ICall_msgPrepend() on queues holding 1
+ * to 256 messages, against the list walks they replaced, which are
+ * reproduced below:
+ *
+ *  - enqueue: one message is added behind depth - 1 queued messages and
+ *    the head is dequeued again, so the depth stays constant;
+ *  - prepend: a side list of depth messages, as left by
+ *    ICall_primWaitMatch(), is spliced in front of a one message queue.
+ *
+ * Each operation holds interrupts off for all of its work, so its call
+ * time bounds the critical section it causes. Prints the mean and the
+ * 99.9th percentile of the call time in host CPU cycles; the longest
+ * calls on the host are the ones the host OS preempted, so the
+ * percentile stands in for the longest critical section.
+ *
+ * icall.c is included rather than linked to reach its static queue
+ * functions. Build from the repository root with the defines and
+ * include paths of hostsim.c:
+ *
+ *   gcc -O2 -o icall_queue_bench <hostsim.c flags> -Itools/hostsim/bench \
+ *       tools/hostsim/bench/icall_queue_bench.c tools/hostsim/host_rtos.c \
+ *       tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "icall.c"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Deepest queue measured
+#define QB_MAX_DEPTH                      256
+
+// Operations timed per depth
+#define QB_ROUNDS                         100000
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Message as ICall_allocMsg() lays it out: header, then body
+typedef struct
+{
+  ICall_MsgHdr hdr;
+  uint32_t body;
+} qbMsg_t;
+
+// Measurement of one operation
+typedef struct
+{
+  double mean;
+  uint32_t p999;
+} qbStat_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, unused: no remote task is created
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { NULL };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static qbMsg_t qbMsgs[QB_MAX_DEPTH + 1];
+
+// Call times of the current measurement
+static uint32_t qbCycles[QB_ROUNDS];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Enqueue as it was done before the tail was tracked: walk to the end.
+ */
+static void qb_walkEnqueue(ICall_MsgQueue *q_ptr, void *msg_ptr)
+{
+  void *list;
+  ICall_CSState key;
+
+  key = ICall_enterCSImpl();
+
+  ICALL_MSG_NEXT(msg_ptr) = NULL;
+  if (q_ptr->head == NULL)
+  {
+    q_ptr->head = msg_ptr;
+  }
+  else
+  {
+    for (list = q_ptr->head; ICALL_MSG_NEXT(list) != NULL;
+         list = ICALL_MSG_NEXT(list));
+
+    ICALL_MSG_NEXT(list) = msg_ptr;
+  }
+  q_ptr->tail = msg_ptr;
+
+  ICall_leaveCSImpl(key);
+}
+
+/*
+ * Prepend as it was done before the tail was tracked: walk the side list
+ * to its end.
+ */
+static void qb_walkPrepend(ICall_MsgQueue *q_ptr, ICall_MsgQueue *list)
+{
+  void *msg_ptr;
+  ICall_CSState key;
+
+  key = ICall_enterCSImpl();
+
+  if (list->head != NULL)
+  {
+    for (msg_ptr = list->head; ICALL_MSG_NEXT(msg_ptr) != NULL;
+         msg_ptr = ICALL_MSG_NEXT(msg_ptr));
+
+    ICALL_MSG_NEXT(msg_ptr) = q_ptr->head;
+    if (q_ptr->head == NULL)
+    {
+      q_ptr->tail = msg_ptr;
+    }
+    q_ptr->head = list->head;
+  }
+
+  ICall_leaveCSImpl(key);
+}
+
+/*
+ * Fill a queue with count messages, starting with qbMsgs[first].
+ */
+static void qb_fill(ICall_MsgQueue *q_ptr, uint16_t first, uint16_t count)
+{
+  uint16_t i;
+
+  ICALL_MSG_QUEUE_INIT(*q_ptr);
+
+  for (i = 0; i < count; i++)
+  {
+    ICall_msgEnqueue(q_ptr, &qbMsgs[first + i].body);
+  }
+}
+
+/*
+ * Order call times for qsort().
+ */
+static int qb_cmp(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*
+ * Summarize the call times in qbCycles.
+ */
+static qbStat_t qb_stat(void)
+{
+  qbStat_t stat;
+  uint64_t total = 0;
+  uint32_t i;
+
+  for (i = 0; i < QB_ROUNDS; i++)
+  {
+    total += qbCycles[i];
+  }
+
+  qsort(qbCycles, QB_ROUNDS, sizeof(qbCycles[0]), qb_cmp);
+
+  stat.mean = (double)total / QB_ROUNDS;
+
+  // Nearest rank
+  stat.p999 = qbCycles[(QB_ROUNDS * 999 + 999) / 1000 - 1];
+
+  return stat;
+}
+
+/*
+ * Enqueue at a constant depth, with the tracked tail or the walk.
+ */
+static qbStat_t qb_enqueue(uint16_t depth, bool walk)
+{
+  ICall_MsgQueue q;
+  uint32_t round;
+
+  qb_fill(&q, 0, depth - 1);
+
+  for (round = 0; round < QB_ROUNDS; round++)
+  {
+    // The message dequeued last round is free again
+    void *msg_ptr = &qbMsgs[(depth - 1 + round) % depth].body;
+    uint64_t start = bench_cycles();
+
+    if (walk)
+    {
+      qb_walkEnqueue(&q, msg_ptr);
+    }
+    else
+    {
+      ICall_msgEnqueue(&q, msg_ptr);
+    }
+    qbCycles[round] = (uint32_t)(bench_cycles() - start);
+
+    ICall_msgDequeue(&q);
+  }
+
+  return qb_stat();
+}
+
+/*
+ * Prepend a side list of depth messages, with the tracked tail or the
+ * walk.
+ */
+static qbStat_t qb_prepend(uint16_t depth, bool walk)
+{
+  uint32_t round;
+
+  for (round = 0; round < QB_ROUNDS; round++)
+  {
+    ICall_MsgQueue q, list;
+    uint64_t start;
+
+    qb_fill(&q, QB_MAX_DEPTH, 1);
+    qb_fill(&list, 0, depth);
+
+    start = bench_cycles();
+    if (walk)
+    {
+      qb_walkPrepend(&q, &list);
+    }
+    else
+    {
+      ICall_msgPrepend(&q, &list);
+    }
+    qbCycles[round] = (uint32_t)(bench_cycles() - start);
+  }
+
+  return qb_stat();
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint16_t depth;
+
+  printf("cycles per call    enqueue mean/p99.9      prepend mean/p99.9\n");
+  printf("depth          tail        walk         tail        walk\n");
+
+  for (depth = 1; depth <= QB_MAX_DEPTH; depth *= 2)
+  {
+    qbStat_t enq = qb_enqueue(depth, false);
+    qbStat_t enqWalk = qb_enqueue(depth, true);
+    qbStat_t pre = qb_prepend(depth, false);
+    qbStat_t preWalk = qb_prepend(depth, true);
+
+    printf("%5u %6.0f/%-5u %6.0f/%-5u %6.0f/%-5u %6.0f/%u\n", depth,
+           enq.mean, enq.p999, enqWalk.mean, enqWalk.p999,
+           pre.mean, pre.p999, preWalk.mean, preWalk.p999);
+  }
+
+  return 0;
+}
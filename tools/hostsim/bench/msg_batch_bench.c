@@ -0,0 +1,286 @@
+/******************************************************************************
+
+ @file  msg_batch_bench.c
+
+ @brief This file contains the host simulation of the application task
+        wakeups, with single and batched fetches of stack messages.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Simulates a GATT write storm: a stack task sends 1000 messages to the
+ * application task in bursts of 1 to 32 messages, one burst per
+ * connection event, and the application task drains them in either of
+ * the two loops it has had:
+ *
+ *  - single: one ICall_fetchServiceMsg() per ICall_wait() wakeup;
+ *  - batch: ICall_fetchServiceMsgBatch() of up to SBP_MSG_BATCH_SIZE
+ *    messages per wakeup.
+ *
+ * Prints, per 1000 messages, the ICall_wait() calls that returned a
+ * signal (wakeups), and the task switches, which count the waits that
+ * blocked. As on the device, the stack runs at a higher priority, so a
+ * whole burst is queued before the application runs.
+ *
+ * icall.c is included rather than linked to size its tables for the
+ * simulation. Build from the repository root with the defines and
+ * include paths of hostsim.c:
+ *
+ *   gcc -O2 -o msg_batch_bench <hostsim.c flags> \
+ *       -Itools/hostsim/bench tools/hostsim/bench/msg_batch_bench.c \
+ *       tools/hostsim/host_rtos.c tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "icall.c"
+
+#include "host_rtos.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Batch size of simple_peripheral.c
+#define SBP_MSG_BATCH_SIZE                8
+
+// Messages sent per run
+#define MB_MSGS                           1000
+
+// Task priorities of the stack and the application
+#define MB_STACK_PRI                      5
+#define MB_APP_PRI                        1
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Message sent by the stack
+typedef struct
+{
+  uint8_t event;
+  uint8_t status;
+} mbMsg_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, unused: no remote task is created
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { NULL };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Burst lengths measured
+static const uint8_t mbBursts[] = { 1, 4, SBP_MSG_BATCH_SIZE, 32 };
+
+// Tasks of each run, which stay with the kernel once created
+static Task_Struct mbTasks[2 * sizeof(mbBursts)][2];
+
+// Parameters of the current run
+static uint8_t mbBurst;
+static bool mbBatch;
+
+static ICall_EntityID mbAppEntity;
+
+// Counts of the current run
+static uint32_t mbWakeups;
+static uint32_t mbReceived;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Service function of the stack, never called.
+ */
+static ICall_Errno mbServiceFn(ICall_FuncArgsHdr *args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/*
+ * Stack task: send MB_MSGS messages in bursts of mbBurst, one burst per
+ * tick.
+ */
+static Void mb_stackFxn(UArg a0, UArg a1)
+{
+  ICall_EntityID entity;
+  ICall_SyncHandle syncHandle;
+  uint32_t sent = 0;
+
+  ICall_enrollService(ICALL_SERVICE_CLASS_BLE, mbServiceFn, &entity,
+                      &syncHandle);
+
+  while (sent < MB_MSGS)
+  {
+    uint8_t i;
+
+    // Lets the application register before the first burst
+    Task_sleep(1);
+
+    for (i = 0; i < mbBurst && sent < MB_MSGS; i++, sent++)
+    {
+      mbMsg_t *pMsg = ICall_allocMsg(sizeof(mbMsg_t));
+
+      pMsg->event = i;
+      pMsg->status = 0;
+      ICall_send(entity, mbAppEntity, ICALL_MSG_FORMAT_KEEP, pMsg);
+    }
+  }
+}
+
+/*
+ * Application task: the loop of SimpleBLEPeripheral_taskFxn() reduced to
+ * its stack message handling.
+ */
+static Void mb_appFxn(UArg a0, UArg a1)
+{
+  ICall_SyncHandle syncHandle;
+
+  ICall_registerApp(&mbAppEntity, &syncHandle);
+
+  while (mbReceived < MB_MSGS)
+  {
+    if (ICall_wait(ICALL_TIMEOUT_FOREVER) != ICALL_ERRNO_SUCCESS)
+    {
+      continue;
+    }
+
+    mbWakeups++;
+
+    if (mbBatch)
+    {
+      ICall_ServiceMsg msgs[SBP_MSG_BATCH_SIZE];
+      uint_least8_t numMsgs;
+      uint_least8_t i;
+
+      if (ICall_fetchServiceMsgBatch(msgs, SBP_MSG_BATCH_SIZE,
+                                     &numMsgs) != ICALL_ERRNO_SUCCESS)
+      {
+        numMsgs = 0;
+      }
+
+      for (i = 0; i < numMsgs; i++)
+      {
+        ICall_freeMsg(msgs[i].msg);
+      }
+      mbReceived += numMsgs;
+    }
+    else
+    {
+      ICall_ServiceEnum src;
+      ICall_EntityID dest;
+      void *pMsg;
+
+      if (ICall_fetchServiceMsg(&src, &dest, &pMsg) == ICALL_ERRNO_SUCCESS)
+      {
+        ICall_freeMsg(pMsg);
+        mbReceived++;
+      }
+    }
+  }
+}
+
+/*
+ * Run the simulation once; returns the task switches.
+ */
+static uint32_t mb_run(uint8_t run)
+{
+  Task_Params params;
+  uint32_t switches = HostRtos_switches();
+
+  mbWakeups = 0;
+  mbReceived = 0;
+
+  ICall_init();
+
+  Task_Params_init(&params);
+  params.priority = MB_STACK_PRI;
+  Task_construct(&mbTasks[run][0], mb_stackFxn, &params, NULL);
+  params.priority = MB_APP_PRI;
+  Task_construct(&mbTasks[run][1], mb_appFxn, &params, NULL);
+
+  // Returns when both tasks are done
+  BIOS_start();
+
+  return HostRtos_switches() - switches;
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint8_t i;
+
+  printf("per %u messages      wakeups         task switches\n", MB_MSGS);
+  printf("burst           single   batch    single   batch\n");
+
+  for (i = 0; i < sizeof(mbBursts); i++)
+  {
+    uint32_t single[2], batch[2];
+
+    mbBurst = mbBursts[i];
+
+    mbBatch = FALSE;
+    single[1] = mb_run(2 * i);
+    single[0] = mbWakeups;
+
+    mbBatch = TRUE;
+    batch[1] = mb_run(2 * i + 1);
+    batch[0] = mbWakeups;
+
+    printf("%5u %14u %7u %9u %7u\n", mbBurst, single[0], batch[0],
+           single[1], batch[1]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,252 @@
+/******************************************************************************
+
+ @file  msg_match_bench.c
+
+ @brief This file contains the host benchmark of waiting for a stack
+        response with the response slot and with the queue scan,
+        behind 0 to 64 unrelated messages.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Measures how the application task collects the response to a stack
+ * command while 0, 16 or 64 unrelated messages wait in its queue:
+ *
+ *  - scan: the response is queued behind them and ICall_waitMatch()
+ *    dequeues and matches every message, then puts the others back;
+ *  - slot: ICall_armMatch() is called before the command is sent, so
+ *    ICall_send() routes the response to the response slot of the task
+ *    and ICall_waitArmedMatch() collects it without touching the queue.
+ *
+ * Each round sends the response and collects it; the response has
+ * already arrived when the wait starts, as when the stack preempts the
+ * application. Prints the host CPU cycles per round and the calls to
+ * the match function per round.
+ *
+ * icall.c is included rather than linked, as in the other ICall
+ * benchmarks. Build from the repository root with the defines and
+ * include paths of hostsim.c:
+ *
+ *   gcc -O2 -o msg_match_bench <hostsim.c flags> \
+ *       -Itools/hostsim/bench tools/hostsim/bench/msg_match_bench.c \
+ *       tools/hostsim/host_rtos.c tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "icall.c"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Rounds timed per measurement
+#define MM_ROUNDS                         200000
+
+// Most unrelated messages queued
+#define MM_MAX_QUEUED                     64
+
+// First octet of the response, of unrelated messages
+#define MM_RESPONSE                       0xAA
+#define MM_UNRELATED                      0x00
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, unused: no remote task is created
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { NULL };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Unrelated message counts measured
+static const uint8_t mmQueued[] = { 0, 16, MM_MAX_QUEUED };
+
+static Task_Struct mmTask;
+
+// Entities of the "stack" and of the application, both of mmTask
+static ICall_EntityID mmStackEntity;
+static ICall_EntityID mmAppEntity;
+
+// Calls to mm_match() in the current measurement
+static uint32_t mmMatchCalls;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Service function of the "stack", never called.
+ */
+static ICall_Errno mm_serviceFn(ICall_FuncArgsHdr *args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/*
+ * Match function of the response, as icall_api.c would pass.
+ */
+static bool mm_match(ICall_ServiceEnum src, ICall_EntityID dest,
+                     const void *msg)
+{
+  mmMatchCalls++;
+
+  return (src == ICALL_SERVICE_CLASS_BLE &&
+          *(const uint8_t *)msg == MM_RESPONSE);
+}
+
+/*
+ * Send a message from the "stack" to the application.
+ */
+static void mm_send(uint8_t *pMsg)
+{
+  ICall_send(mmStackEntity, mmAppEntity, ICALL_MSG_FORMAT_KEEP, pMsg);
+}
+
+/*
+ * Time MM_ROUNDS rounds; returns the cycles per round.
+ */
+static double mm_run(uint8_t *pRsp, bool slot)
+{
+  bench_t bench;
+  uint32_t round;
+  UInt key;
+
+  mmMatchCalls = 0;
+
+  // Interrupts off, so that leaving the critical sections does not run
+  // the host scheduler; no wait blocks since the response is queued
+  key = Hwi_disable();
+  bench_start(&bench);
+  for (round = 0; round < MM_ROUNDS; round++)
+  {
+    void *pMsg = NULL;
+
+    if (slot)
+    {
+      ICall_armMatch(mm_match);
+      mm_send(pRsp);
+      ICall_waitArmedMatch(ICALL_TIMEOUT_FOREVER, NULL, NULL, &pMsg);
+    }
+    else
+    {
+      mm_send(pRsp);
+      ICall_waitMatch(ICALL_TIMEOUT_FOREVER, mm_match, NULL, NULL, &pMsg);
+    }
+
+    if (pMsg != pRsp)
+    {
+      abort();
+    }
+  }
+  bench_stop(&bench);
+  Hwi_restore(key);
+
+  return (double)bench.cycles / MM_ROUNDS;
+}
+
+/*
+ * Task function: register both entities, then measure.
+ */
+static Void mm_taskFxn(UArg a0, UArg a1)
+{
+  ICall_SyncHandle syncHandle;
+  uint8_t *pRsp;
+  uint8_t queued = 0;
+  uint8_t i;
+
+  ICall_enrollService(ICALL_SERVICE_CLASS_BLE, mm_serviceFn,
+                      &mmStackEntity, &syncHandle);
+  ICall_registerApp(&mmAppEntity, &syncHandle);
+
+  pRsp = ICall_allocMsg(sizeof(uint8_t));
+  *pRsp = MM_RESPONSE;
+
+  printf("queued    cycles per round     match calls per round\n");
+  printf("            scan      slot        scan      slot\n");
+
+  for (i = 0; i < sizeof(mmQueued); i++)
+  {
+    double scan, slot;
+    uint32_t scanCalls;
+
+    // Unrelated messages stay queued for the whole measurement
+    while (queued < mmQueued[i])
+    {
+      uint8_t *pMsg = ICall_allocMsg(sizeof(uint8_t));
+
+      *pMsg = MM_UNRELATED;
+      mm_send(pMsg);
+      queued++;
+    }
+
+    scan = mm_run(pRsp, FALSE);
+    scanCalls = mmMatchCalls;
+    slot = mm_run(pRsp, TRUE);
+
+    printf("%6u %9.0f %9.0f %11.1f %9.1f\n", queued, scan, slot,
+           (double)scanCalls / MM_ROUNDS, (double)mmMatchCalls / MM_ROUNDS);
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  ICall_init();
+
+  Task_construct(&mmTask, mm_taskFxn, NULL, NULL);
+
+  // Returns when the task is done
+  BIOS_start();
+
+  return 0;
+}
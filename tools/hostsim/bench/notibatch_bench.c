@@ -0,0 +1,343 @@
+/******************************************************************************
+
+ @file  notibatch_bench.c
+
+ @brief This file contains the host benchmark of streaming sensor
+        samples through the notification batch and through one
+        notification per update.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Streams 200 Hz samples of a 3 characteristic IMU (accelerometer,
+ * gyroscope, magnetometer, 6 octets each) over one connection with
+ * intervals of 5, 7.5 and 15 ms, so that 1 to 3 samples arrive per
+ * connection event, in the two ways the application can send them:
+ *
+ *  - single: every characteristic update is notified right away with
+ *    GATTServApp_ProcessCharCfg(), one GATT_bm_alloc() buffer each;
+ *  - batch: a copy of each update is queued with GATTServApp_QueueNoti()
+ *    in the ring of the link, NB_RING_SIZE updates long, and the ring is
+ *    sent oldest first once per connection event with
+ *    GATTServApp_SendNotiBatch().
+ *
+ * The controller takes up to SBP_NOTI_BATCH_PDUS PDUs per connection
+ * event; GATT_Notification() refuses any more with blePending. Prints,
+ * for each path, the samples per second delivered over the link (sent
+ * notifications of all characteristics over the simulated time), the
+ * host CPU time per delivered sample, and per sample the buffers
+ * allocated, the notifications sent, and the updates lost: refused by
+ * the controller on the single path, refused by a full ring on the batch
+ * path. Updates still queued at the end count as neither sent nor lost.
+ *
+ * Build from the repository root with the defines and include paths of
+ * hostsim.c:
+ *
+ *   gcc -O2 -o notibatch_bench <hostsim.c flags> -Itools/hostsim/bench \
+ *       tools/hostsim/bench/notibatch_bench.c \
+ *       ble-stack/host/gattservapp_util.c
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bcomdef.h"
+#include "linkdb.h"
+#include "gatt.h"
+#include "gattservapp.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Connection streamed to
+#define NB_CONN_HANDLE                    0
+
+// PDUs the controller takes per connection event, as in
+// simple_peripheral.c
+#define SBP_NOTI_BATCH_PDUS               5
+
+// Characteristics updated by each sample
+#define NB_NUM_CHARS                      3
+
+// Updates the ring of the link holds: three events of samples at 15 ms
+#define NB_RING_SIZE                      27
+
+// Octets of each characteristic value
+#define NB_VALUE_LEN                      6
+
+// Sample rate
+#define NB_SAMPLE_HZ                      200
+
+// Connection events simulated per measurement
+#define NB_EVENTS                         400000
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Counts of a measurement
+typedef struct
+{
+  uint32_t samples;
+  uint32_t allocs;
+  uint32_t sent;
+  uint32_t lost;
+} nbCounts_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 linkDBNumConns = 1;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Connection intervals measured (us)
+static const uint16 nbIntervals[] = { 5000, 7500, 15000 };
+
+static uint8 nbValues[NB_NUM_CHARS][NB_VALUE_LEN];
+
+// Client configuration: notifications enabled on NB_CONN_HANDLE
+static gattCharCfg_t nbConfig[NB_NUM_CHARS][1];
+
+static uint8 nbUUID[ATT_BT_UUID_SIZE] = { 0xF4, 0xFF };
+
+static gattAttribute_t nbAttrTbl[NB_NUM_CHARS] =
+{
+  { { ATT_BT_UUID_SIZE, nbUUID }, GATT_PERMIT_READ, 0x21, nbValues[0] },
+  { { ATT_BT_UUID_SIZE, nbUUID }, GATT_PERMIT_READ, 0x24, nbValues[1] },
+  { { ATT_BT_UUID_SIZE, nbUUID }, GATT_PERMIT_READ, 0x27, nbValues[2] }
+};
+
+static gattNotiBatchLink_t nbBatchLink;
+static gattNotiBatchItem_t nbBatchItems[NB_RING_SIZE];
+static gattNotiBatch_t nbBatch;
+
+// PDUs taken by the controller in the current connection event
+static uint8 nbPdus;
+
+static nbCounts_t nbCounts;
+
+/*********************************************************************
+ * STACK STUBS
+ */
+
+uint8 linkDB_State(uint16 connectionHandle, uint8 state)
+{
+  return connectionHandle == NB_CONN_HANDLE;
+}
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+  nbCounts.allocs++;
+
+  *pSizeAlloc = size;
+
+  return malloc(size);
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+  free(pMsg->handleValueNoti.pValue);
+}
+
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+  // The value fits a 27 octet PDU
+  if (nbPdus == SBP_NOTI_BATCH_PDUS)
+  {
+    return blePending;
+  }
+
+  nbPdus++;
+  nbCounts.sent++;
+  free(pNoti->pValue);
+
+  return SUCCESS;
+}
+
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                          uint8 authenticated, uint8 taskId)
+{
+  return FAILURE;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Read callback of the characteristic values.
+ */
+static bStatus_t nb_readAttrCB(uint16 connHandle, gattAttribute_t *pAttr,
+                               uint8 *pValue, uint16 *pLen, uint16 offset,
+                               uint16 maxLen, uint8 method)
+{
+  *pLen = MIN(NB_VALUE_LEN, maxLen);
+  memcpy(pValue, pAttr->pValue, *pLen);
+
+  return SUCCESS;
+}
+
+/*
+ * Stream NB_EVENTS connection events of samples.
+ */
+static void nb_run(uint16 interval, bool batch)
+{
+  uint32_t event;
+  uint32_t due = 0;
+
+  memset(&nbCounts, 0, sizeof(nbCounts));
+  GATTServApp_InitNotiBatch(&nbBatch, &nbBatchLink, 1, nbBatchItems,
+                            NB_RING_SIZE);
+
+  for (event = 0; event < NB_EVENTS; event++)
+  {
+    // Samples that arrived since the last connection event
+    uint32_t samples = (uint64_t)(event + 1) * interval * NB_SAMPLE_HZ /
+                       1000000 - due;
+
+    due += samples;
+    nbPdus = 0;
+
+    while (samples--)
+    {
+      uint8 c;
+
+      for (c = 0; c < NB_NUM_CHARS; c++)
+      {
+        memset(nbValues[c], (uint8)nbCounts.samples, NB_VALUE_LEN);
+
+        if (batch)
+        {
+          if (GATTServApp_QueueNoti(&nbBatch, nbConfig[c], nbValues[c], FALSE,
+                                    nbAttrTbl, NB_NUM_CHARS,
+                                    nb_readAttrCB) != SUCCESS)
+          {
+            nbCounts.lost++;
+          }
+        }
+        else if (GATTServApp_ProcessCharCfg(nbConfig[c], nbValues[c], FALSE,
+                                            nbAttrTbl, NB_NUM_CHARS,
+                                            INVALID_TASK_ID,
+                                            nb_readAttrCB) != SUCCESS)
+        {
+          nbCounts.lost++;
+        }
+      }
+
+      nbCounts.samples++;
+    }
+
+    if (batch)
+    {
+      // At the end of the connection event
+      GATTServApp_SendNotiBatch(&nbBatch, SBP_NOTI_BATCH_PDUS);
+    }
+  }
+}
+
+/*
+ * Print a measurement of NB_EVENTS connection events of interval us.
+ */
+static void nb_report(const char *name, uint16 interval, const bench_t *pBench)
+{
+  double samples = nbCounts.samples;
+  double delivered = (double)nbCounts.sent / NB_NUM_CHARS;
+
+  printf("  %-7s %10.1f %9.1f %9.2f %9.2f %9.2f\n", name,
+         delivered * 1e6 / ((double)NB_EVENTS * interval),
+         delivered ? pBench->ns / delivered : 0, nbCounts.allocs / samples,
+         nbCounts.sent / samples, nbCounts.lost / samples);
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint8 c, i;
+
+  for (c = 0; c < NB_NUM_CHARS; c++)
+  {
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, nbConfig[c]);
+    GATTServApp_WriteCharCfg(NB_CONN_HANDLE, nbConfig[c],
+                             GATT_CLIENT_CFG_NOTIFY);
+  }
+
+  printf("%u Hz samples of %u characteristics, %u PDUs per event\n",
+         NB_SAMPLE_HZ, NB_NUM_CHARS, SBP_NOTI_BATCH_PDUS);
+  printf("  path    delivered/s  ns/sample   allocs      sent      lost"
+         "  per sample\n");
+
+  for (i = 0; i < sizeof(nbIntervals) / sizeof(nbIntervals[0]); i++)
+  {
+    bench_t single, batch;
+
+    // Warm up the allocator and the caches
+    nb_run(nbIntervals[i], FALSE);
+    nb_run(nbIntervals[i], TRUE);
+
+    printf("%u us interval\n", nbIntervals[i]);
+
+    bench_start(&single);
+    nb_run(nbIntervals[i], FALSE);
+    bench_stop(&single);
+    nb_report("single", nbIntervals[i], &single);
+
+    bench_start(&batch);
+    nb_run(nbIntervals[i], TRUE);
+    bench_stop(&batch);
+    nb_report("batch", nbIntervals[i], &batch);
+  }
+
+  return 0;
+}
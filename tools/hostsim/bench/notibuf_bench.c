@@ -0,0 +1,299 @@
+/******************************************************************************
+
+ @file  notibuf_bench.c
+
+ @brief This file contains the host benchmark of the zero-copy
+        notification send against the read callback copy.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Compares the two ways of notifying a sampled value on the host, for
+ * 20, 100 and 244 octet values:
+ *
+ *  - copy: the samples are written to the profile's value, then
+ *    GATTServApp_ProcessCharCfg() allocates a buffer and copies the value
+ *    into it through the read callback;
+ *  - zero-copy: the samples are written straight into a GATT_bm_alloc()
+ *    buffer sized with GATTServApp_GetPayloadLen(), then sent with
+ *    GATTServApp_SendNotiBuf().
+ *
+ * GATT_Notification() takes the buffer as the stack would and frees it.
+ * Prints the host CPU cycles per value octet and the octets per second
+ * each path sustains; the air time is not modeled.
+ *
+ * Build from the repository root with the defines and include paths of
+ * hostsim.c:
+ *
+ *   gcc -O2 -o notibuf_bench <hostsim.c flags> -Itools/hostsim/bench \
+ *       tools/hostsim/bench/notibuf_bench.c \
+ *       ble-stack/host/gattservapp_util.c
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bcomdef.h"
+#include "linkdb.h"
+#include "gatt.h"
+#include "gattservapp.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Connection notified
+#define NB_CONN_HANDLE                    0
+
+// Notifications sent per measurement
+#define NB_ROUNDS                         200000
+
+// Longest value measured, the payload of a 247 octet ATT MTU
+#define NB_MAX_LEN                        244
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 linkDBNumConns = 1;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Value lengths measured
+static const uint16 nbLens[] = { 20, 100, 244 };
+
+// Characteristic value of the copy path, and its length
+static uint8 nbValue[NB_MAX_LEN];
+static uint16 nbValueLen;
+
+// Client configuration: notifications enabled on NB_CONN_HANDLE
+static gattCharCfg_t nbConfig[1];
+
+static uint8 nbUUID[ATT_BT_UUID_SIZE] = { 0xF4, 0xFF };
+
+static gattAttribute_t nbAttrTbl[] =
+{
+  { { ATT_BT_UUID_SIZE, nbUUID }, 0, 3, nbValue }
+};
+
+// Octets the "stack" was handed, checked to keep the sends from being
+// optimized out
+static uint32_t nbSent;
+
+/*********************************************************************
+ * STACK STUBS
+ */
+
+uint8 linkDB_State(uint16 connectionHandle, uint8 state)
+{
+  return connectionHandle == NB_CONN_HANDLE;
+}
+
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+  if (size > NB_MAX_LEN)
+  {
+    size = NB_MAX_LEN;
+  }
+
+  *pSizeAlloc = size;
+
+  return malloc(size);
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+  free(pMsg->handleValueNoti.pValue);
+}
+
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+  // The stack copies the value into its PDUs and frees the buffer
+  nbSent += pNoti->len + pNoti->pValue[pNoti->len - 1];
+  free(pNoti->pValue);
+
+  return SUCCESS;
+}
+
+bStatus_t GATT_Indication(uint16 connHandle, attHandleValueInd_t *pInd,
+                          uint8 authenticated, uint8 taskId)
+{
+  return FAILURE;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Read callback of the copy path.
+ */
+static bStatus_t nb_readAttrCB(uint16 connHandle, gattAttribute_t *pAttr,
+                               uint8 *pValue, uint16 *pLen, uint16 offset,
+                               uint16 maxLen, uint8 method)
+{
+  *pLen = MIN(nbValueLen, maxLen);
+  memcpy(pValue, pAttr->pValue, *pLen);
+
+  return SUCCESS;
+}
+
+/*
+ * Write len samples, as a sensor driver would.
+ */
+static void nb_sample(uint8 *pBuf, uint16 len, uint32_t round)
+{
+  uint16 i;
+
+  for (i = 0; i < len; i++)
+  {
+    pBuf[i] = (uint8)(round + i);
+  }
+}
+
+/*
+ * Send NB_ROUNDS values of len octets through the copy path.
+ */
+static void nb_copy(uint16 len)
+{
+  uint32_t round;
+
+  nbValueLen = len;
+
+  for (round = 0; round < NB_ROUNDS; round++)
+  {
+    nb_sample(nbValue, len, round);
+    GATTServApp_ProcessCharCfg(nbConfig, nbValue, FALSE, nbAttrTbl,
+                               GATT_NUM_ATTRS(nbAttrTbl), INVALID_TASK_ID,
+                               nb_readAttrCB);
+  }
+}
+
+/*
+ * Send NB_ROUNDS values of len octets through the zero-copy path.
+ */
+static void nb_zeroCopy(uint16 len)
+{
+  uint32_t round;
+
+  for (round = 0; round < NB_ROUNDS; round++)
+  {
+    uint16 size;
+    uint8 *pBuf = GATT_bm_alloc(NB_CONN_HANDLE, ATT_HANDLE_VALUE_NOTI,
+                                GATTServApp_GetPayloadLen(NB_CONN_HANDLE),
+                                &size);
+
+    nb_sample(pBuf, len, round);
+    GATTServApp_SendNotiBuf(nbConfig, NB_CONN_HANDLE, &nbAttrTbl[0], pBuf,
+                            len, FALSE);
+  }
+}
+
+/*
+ * Print a measurement of NB_ROUNDS values of len octets.
+ */
+static void nb_report(const char *name, uint16 len, const bench_t *pBench)
+{
+  double octets = (double)NB_ROUNDS * len;
+
+  printf("  %-10s %10.2f cycles/B %10.1f MB/s\n", name,
+         pBench->cycles / octets, octets * 1e3 / pBench->ns);
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint8 i;
+
+  GATTServApp_InitCharCfg(INVALID_CONNHANDLE, nbConfig);
+  GATTServApp_WriteCharCfg(NB_CONN_HANDLE, nbConfig, GATT_CLIENT_CFG_NOTIFY);
+
+  // An ATT MTU of 247 negotiated, as from ATT_MTU_UPDATED_EVENT; no link
+  // tuning parameters
+  GATTServApp_SetLinkMTU(NB_CONN_HANDLE, NB_MAX_LEN + 3);
+
+  for (i = 0; i < sizeof(nbLens) / sizeof(nbLens[0]); i++)
+  {
+    uint16 len = nbLens[i];
+    bench_t copy, zeroCopy;
+
+    // Warm up the allocator and the caches
+    nb_copy(len);
+    nb_zeroCopy(len);
+
+    bench_start(&copy);
+    nb_copy(len);
+    bench_stop(&copy);
+
+    bench_start(&zeroCopy);
+    nb_zeroCopy(len);
+    bench_stop(&zeroCopy);
+
+    printf("%u octet values, %u notifications\n", len, NB_ROUNDS);
+    nb_report("copy", len, &copy);
+    nb_report("zero-copy", len, &zeroCopy);
+  }
+
+  // A value longer than the link takes is refused, not truncated
+  {
+    uint16 size;
+    uint8 *pBuf = GATT_bm_alloc(NB_CONN_HANDLE, ATT_HANDLE_VALUE_NOTI,
+                                NB_MAX_LEN, &size);
+
+    GATTServApp_SetLinkMTU(NB_CONN_HANDLE, ATT_MTU_SIZE);
+    printf("100 octets on a 23 octet ATT MTU: status 0x%02x\n",
+           GATTServApp_SendNotiBuf(nbConfig, NB_CONN_HANDLE, &nbAttrTbl[0],
+                                   pBuf, 100, FALSE));
+  }
+
+  return (nbSent == 0);
+}
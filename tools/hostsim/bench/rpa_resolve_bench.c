@@ -0,0 +1,429 @@
+/******************************************************************************
+
+ @file  rpa_resolve_bench.c
+
+ @brief This file contains the host benchmark of
+        GAPBondMgr_ResolveAddr() with 1 to 32 bonds, with and without
+        the RPA cache.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Resolves peer addresses with GAPBondMgr_ResolveAddr() of icall_api.c,
+ * from an application task, against the fake stack with 1 to 32 bonds.
+ * The fake stack checks an RPA with ah() against the IRK of each bond in
+ * turn, on the software AES of the stack library (sspAesEncrypt_Sw(),
+ * host_aes.c), as the Bond Manager does. Three cases:
+ *
+ *  - hit: the RPA of the last bond, resolved again and again, as a
+ *    reconnecting peer or its scan reports would;
+ *  - miss: an RPA no bond resolves, e.g. of an unbonded phone nearby;
+ *  - rotate: the RPAs of all bonds in turn, more peers than the cache
+ *    holds once there are more than GAPBOND_RPA_CACHE_SIZE bonds.
+ *
+ * Prints the CPU time of a resolve, application and stack together, and
+ * the ah() checks it took. The 0 bond line is the ICall round trip alone.
+ * Before that, checks ah() against the sample data of the Bluetooth
+ * specification and that a cached RPA is dropped when its bond is erased
+ * and when TGAP_PRIVATE_ADDR_INT expires.
+ *
+ * Build from the repository root with the defines and include paths of
+ * hostsim.c, once with and once without the cache:
+ *
+ *   gcc -O2 -o rpa_resolve_bench <hostsim.c flags> -DGAP_BONDINGS_MAX=32 \
+ *       [-DGAPBOND_RPA_CACHE] -Itools/hostsim/bench \
+ *       tools/hostsim/bench/rpa_resolve_bench.c \
+ *       ble-stack/components/icall/src/icall.c \
+ *       ble-stack/icall/app/icall_api.c ble-stack/common/cc26xx/util.c \
+ *       ble-stack/host/gatt_uuid.c tools/hostsim/host_rtos.c \
+ *       tools/hostsim/host_board.c tools/hostsim/fake_stack.c \
+ *       tools/hostsim/host_aes.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "bcomdef.h"
+#include "gap.h"
+#include "gatt.h"
+#include "gattservapp.h"
+#include "gapbondmgr.h"
+#include "l2cap.h"
+#include "osal_snv.h"
+#include "icall.h"
+#include "icall_apimsg.h"
+#include "aes.h"
+
+#include "host_rtos.h"
+#include "fake_stack.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Resolves per measurement
+#define RB_RESOLVES                       2000
+
+// Task priority of the application
+#define RB_APP_PRI                        1
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, as built by the stack project on the target
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { FakeStack_entry };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 1;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Bond counts measured
+static const uint8_t rbBonds[] = { 0, 1, 2, 4, 8, 16, 32 };
+
+// IRK, identity address and current RPA of each bond
+static uint8_t rbIrks[GAP_BONDINGS_MAX][KEYLEN];
+static uint8_t rbIdAddrs[GAP_BONDINGS_MAX][B_ADDR_LEN];
+static uint8_t rbRpas[GAP_BONDINGS_MAX][B_ADDR_LEN];
+
+// RPA of a peer without a bond
+static uint8_t rbUnknownRpa[B_ADDR_LEN];
+
+static Task_Struct rbAppTask;
+
+static bool rbDone = false;
+static int rbFailures = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Record a failed check.
+ */
+static void rb_check(bool ok, const char *pWhat)
+{
+  if (!ok)
+  {
+    printf("FAIL: %s\n", pWhat);
+    rbFailures++;
+  }
+}
+
+/*
+ * ah() of the Bluetooth specification, Vol 3 Part H 2.2.2, with the IRK
+ * and prand least significant octet first as the stack stores them.
+ */
+static uint32_t rb_ah(const uint8_t *pIrk, const uint8_t *pPrand)
+{
+  uint8_t key[KEY_BLENGTH];
+  uint8_t block[STATE_BLENGTH];
+  uint8_t i;
+
+  for (i = 0; i < KEY_BLENGTH; i++)
+  {
+    key[i] = pIrk[KEY_BLENGTH - 1 - i];
+  }
+
+  memset(block, 0, sizeof(block));
+  block[13] = pPrand[2];
+  block[14] = pPrand[1];
+  block[15] = pPrand[0];
+
+  sspAesEncrypt_Sw(key, block);
+
+  return ((uint32_t)block[13] << 16) | ((uint32_t)block[14] << 8) | block[15];
+}
+
+/*
+ * Make a new RPA from an IRK.
+ */
+static void rb_makeRpa(const uint8_t *pIrk, uint8_t *pRpa)
+{
+  uint32_t hash;
+
+  pRpa[3] = rand();
+  pRpa[4] = rand();
+  pRpa[5] = (rand() & ~RANDOM_ADDR_HDR_MASK) | PRIVATE_RESOLVE_ADDR_HDR;
+
+  hash = rb_ah(pIrk, &pRpa[3]);
+  pRpa[0] = hash;
+  pRpa[1] = hash >> 8;
+  pRpa[2] = hash >> 16;
+}
+
+/*
+ * Erase all bonds and add the first num ones of the tables.
+ */
+static void rb_setBonds(uint8_t num)
+{
+  uint8_t i;
+
+  GAPBondMgr_SetParameter(GAPBOND_ERASE_ALLBONDS, 0, NULL);
+
+  for (i = 0; i < num; i++)
+  {
+    FakeStack_addBond(rbIrks[i], rbIdAddrs[i]);
+  }
+}
+
+/*
+ * Check ah() and the invalidation of cached RPAs.
+ */
+static void rb_checks(void)
+{
+  // Bluetooth specification, Vol 3 Part H Appendix D.7
+  static const uint8_t sampleIrk[KEYLEN] =
+  {
+    0x9b, 0x7d, 0x39, 0x0a, 0xa6, 0x10, 0x10, 0x34,
+    0x05, 0xad, 0xc8, 0x57, 0xa3, 0x34, 0x02, 0xec
+  };
+  static const uint8_t samplePrand[3] = { 0x94, 0x81, 0x70 };
+  uint8_t eraseAddr[1 + B_ADDR_LEN];
+  uint8_t idAddr[B_ADDR_LEN];
+  fakeStackStats_t before, after;
+
+  rb_check(rb_ah(sampleIrk, samplePrand) == 0x0dfbaa, "ah() sample data");
+
+  // Resolve twice, the second time from the cache if there is one
+  rb_setBonds(4);
+  rb_check(GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[2], idAddr) == 2,
+           "resolve");
+  rb_check(GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[2], idAddr) == 2,
+           "resolve again");
+  rb_check(memcmp(idAddr, rbIdAddrs[2], B_ADDR_LEN) == 0, "identity address");
+  rb_check(GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbUnknownRpa, NULL) ==
+           GAP_BONDINGS_MAX, "unknown RPA");
+
+  eraseAddr[0] = ADDRTYPE_PUBLIC;
+  memcpy(&eraseAddr[1], rbIdAddrs[2], B_ADDR_LEN);
+  GAPBondMgr_SetParameter(GAPBOND_ERASE_SINGLEBOND, sizeof(eraseAddr),
+                          eraseAddr);
+  rb_check(GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[2], NULL) ==
+           GAP_BONDINGS_MAX, "RPA of an erased bond");
+
+  rb_setBonds(4);
+  GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[1], NULL);
+  GAPBondMgr_SetParameter(GAPBOND_ERASE_ALLBONDS, 0, NULL);
+  rb_check(GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[1], NULL) ==
+           GAP_BONDINGS_MAX, "RPA after erasing all bonds");
+
+  // The cached RPA goes back to the stack once the RPA interval is over
+  rb_setBonds(4);
+  GAP_SetParamValue(TGAP_PRIVATE_ADDR_INT, 1);
+  GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[3], NULL);
+  Task_sleep(61000 * (1000 / Clock_tickPeriod));
+  FakeStack_getStats(&before);
+  rb_check(GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[3], NULL) == 3,
+           "resolve after the RPA interval");
+  FakeStack_getStats(&after);
+  rb_check(after.resolves == before.resolves + 1,
+           "RPA expired after the RPA interval");
+  GAP_SetParamValue(TGAP_PRIVATE_ADDR_INT, 15);
+}
+
+/*
+ * Resolve RB_RESOLVES addresses, the given one, or the RPAs of the first
+ * num bonds in turn if NULL. Prints the CPU time and ah() checks of a
+ * resolve.
+ */
+static void rb_measure(uint8_t *pAddr, uint8_t num, uint8_t expected)
+{
+  fakeStackStats_t before, after;
+  UInt64 ns;
+  uint8_t bondIdx;
+  uint32_t i;
+  bool ok = true;
+
+  FakeStack_getStats(&before);
+  ns = HostRtos_cpuNs();
+
+  for (i = 0; i < RB_RESOLVES; i++)
+  {
+    if (pAddr == NULL)
+    {
+      bondIdx = GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, rbRpas[i % num],
+                                       NULL);
+      ok = ok && (bondIdx == (i % num));
+    }
+    else
+    {
+      bondIdx = GAPBondMgr_ResolveAddr(ADDRTYPE_RANDOM, pAddr, NULL);
+      ok = ok && (bondIdx == expected);
+    }
+  }
+
+  ns = HostRtos_cpuNs() - ns;
+  FakeStack_getStats(&after);
+
+  rb_check(ok, "bond index");
+
+  printf(" %8.2f %5.1f", (double)ns / RB_RESOLVES / 1000,
+         (double)(after.ahCalls - before.ahCalls) / RB_RESOLVES);
+}
+
+/*
+ * Application task: run the checks and the measurements.
+ */
+static Void rb_appFxn(UArg a0, UArg a1)
+{
+  ICall_EntityID entity;
+  ICall_SyncHandle syncHandle;
+  uint8_t unknownIrk[KEYLEN];
+  uint8_t i, j;
+
+  ICall_registerApp(&entity, &syncHandle);
+
+  srand(1);
+  for (i = 0; i < GAP_BONDINGS_MAX; i++)
+  {
+    for (j = 0; j < KEYLEN; j++)
+    {
+      rbIrks[i][j] = rand();
+    }
+    for (j = 0; j < B_ADDR_LEN; j++)
+    {
+      rbIdAddrs[i][j] = rand();
+    }
+    rb_makeRpa(rbIrks[i], rbRpas[i]);
+  }
+  for (j = 0; j < KEYLEN; j++)
+  {
+    unknownIrk[j] = rand();
+  }
+  rb_makeRpa(unknownIrk, rbUnknownRpa);
+
+  rb_checks();
+
+#ifdef GAPBOND_RPA_CACHE
+  printf("with the RPA cache of %u entries\n", GAPBOND_RPA_CACHE_SIZE);
+#else
+  printf("without the RPA cache\n");
+#endif // GAPBOND_RPA_CACHE
+  printf("per resolve         hit             miss           rotate\n");
+  printf("bonds         us   ah()        us   ah()        us   ah()\n");
+
+  for (i = 0; i < sizeof(rbBonds); i++)
+  {
+    uint8_t num = rbBonds[i];
+
+    rb_setBonds(num);
+
+    printf("%5u", num);
+    if (num == 0)
+    {
+      printf("        -     -");
+    }
+    else
+    {
+      rb_measure(rbRpas[num - 1], num, num - 1);
+    }
+    printf("  ");
+    rb_measure(rbUnknownRpa, num, GAP_BONDINGS_MAX);
+    printf("  ");
+    if (num == 0)
+    {
+      printf("        -     -");
+    }
+    else
+    {
+      rb_measure(NULL, num, 0);
+    }
+    printf("\n");
+  }
+
+  rbDone = true;
+}
+
+/*
+ * Idle hook: advance to the next timeout until the application is done.
+ */
+static Bool rb_idle(UInt32 nextDue, Bool due)
+{
+  if (rbDone || !due)
+  {
+    return FALSE;
+  }
+
+  HostRtos_advance(nextDue);
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  Task_Params params;
+
+  ICall_init();
+  ICall_createRemoteTasks();
+
+  Task_Params_init(&params);
+  params.priority = RB_APP_PRI;
+  Task_construct(&rbAppTask, rb_appFxn, &params, NULL);
+
+  HostRtos_setIdleHook(rb_idle);
+
+  BIOS_start();
+
+  if (rbFailures != 0)
+  {
+    printf("%d checks failed\n", rbFailures);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,569 @@
+/******************************************************************************
+
+ @file  snv_log_bench.c
+
+ @brief This file contains the host benchmark of the log-structured
+        SNV backend (OSAL_SNV_LOG) on the file-backed flash simulator.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Runs osal_snv_log.c on host_flash.c, a file mapped at the flash area
+ * of the log, with the NV writes of a peripheral that bonds with peers
+ * again and again:
+ *
+ *  - each bonding writes the GAP_BOND_REC_IDS records of a bond slot
+ *    (bond record, local and peer LTK, IRK, CSRK and sign counter) and
+ *    clears its characteristic configuration table, the seven items
+ *    gapbondmgr.c writes, either one osal_snv_write() each or as one
+ *    batch;
+ *  - the connection that follows enables BENCH_CCC_UPDATES
+ *    characteristic configurations, one write of the table each, as
+ *    GAPBondMgr_UpdateCharCfg() does;
+ *  - the task then goes idle and osal_snv_idle() runs until it has
+ *    nothing left to do.
+ *
+ * Prints, per bonding, the flash programs, bytes and modeled busy time
+ * of the bond write and of a table update, and the worst bond write;
+ * the sector erases, done in writes and in idle time, and their spread
+ * over the sectors; and the time of osal_snv_read(). The busy times are
+ * the typical flash timings of the data sheet, see host_flash.h.
+ *
+ * Every item is checked against a copy in RAM after each connection and
+ * after the log is replayed from the file by osal_snv_init(), as after a
+ * reset. Then the power is cut at every 4th byte of a bond write in
+ * turn: after each replay the bond must hold either all its old or all
+ * its new items. Separate writes are expected to leave torn bonds and
+ * are only counted.
+ *
+ * osal_snv_log.c is included rather than linked to print its
+ * configuration. Build from the repository root with the defines and
+ * include paths of hostsim.c:
+ *
+ *   gcc -O2 -o snv_log_bench <hostsim.c flags> -DOSAL_SNV_LOG \
+ *       -DOSAL_SNV_LOG_BASE=0x40000000 \
+ *       -Ible-stack/components/services/src/nv/cc26xx \
+ *       -Itools/hostsim/bench tools/hostsim/bench/snv_log_bench.c \
+ *       tools/hostsim/host_flash.c
+ *
+ * Usage: snv_log_bench [flash file], snv_log_bench.flash by default.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "osal_snv_log.c"
+
+#include "bcomdef.h"
+
+#include "host_flash.h"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Bond slots, GAP_BONDINGS_MAX of gapbondmgr.h
+#define BENCH_BONDS                   10
+
+// Items gapbondmgr.c keeps per bond slot, and the NV Id of the first
+#define BENCH_REC_IDS                 6
+#define BENCH_REC_ID(slot, rec)       (BLE_NVID_GAP_BOND_START + \
+                                       (slot) * BENCH_REC_IDS + (rec))
+#define BENCH_CFG_ID(slot)            (BLE_NVID_GATT_CFG_START + (slot))
+
+// Characteristic configurations of a table, GAP_CHAR_CFG_MAX
+#define BENCH_CHAR_CFG                4
+
+// Bondings replayed, and configurations enabled per connection
+#define BENCH_BONDINGS                200
+#define BENCH_CCC_UPDATES             4
+
+// Reads timed per item
+#define BENCH_READS                   1000
+
+// Largest item
+#define BENCH_MAX_ITEM                32
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Flash work of one kind of write
+typedef struct
+{
+  uint32_t count;
+  uint32_t programs;
+  uint32_t bytes;
+  uint64_t busyUs;
+  uint64_t maxUs;
+  uint32_t erases;
+} benchWork_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Sizes of the bond records on the target: bond record (address, address
+// type, state flags), local and peer LTK (LTK, EDIV, Rand, key size),
+// IRK, CSRK and sign counter. The table holds a handle and a value per
+// characteristic configuration.
+static const uint8_t recLens[BENCH_REC_IDS] = { 8, 28, 28, 16, 16, 4 };
+#define BENCH_CFG_LEN                 (BENCH_CHAR_CFG * 4)
+
+static const char *pFlashPath = "snv_log_bench.flash";
+
+// Content of every item as last written, and its length
+static uint8_t model[OSAL_SNV_LOG_MAX_ID + 1][BENCH_MAX_ITEM];
+static uint8_t modelLen[OSAL_SNV_LOG_MAX_ID + 1];
+
+static int failures = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Record a failed check.
+ */
+static void bench_check(bool ok, const char *pWhat)
+{
+  if (!ok)
+  {
+    printf("FAIL: %s\n", pWhat);
+    failures++;
+  }
+}
+
+/*
+ * Start from erased flash.
+ */
+static void bench_format(void)
+{
+  unlink(pFlashPath);
+
+  if (HostFlash_open(pFlashPath, OSAL_SNV_LOG_BASE,
+                     OSAL_SNV_LOG_NUM_PAGES * OSAL_SNV_LOG_PAGE_SIZE) != 0)
+  {
+    perror(pFlashPath);
+    exit(1);
+  }
+
+  memset(modelLen, 0, sizeof(modelLen));
+  bench_check(osal_snv_init() == SUCCESS, "init of erased flash");
+}
+
+/*
+ * Reset: map the flash file again and replay the log.
+ */
+static void bench_reset(void)
+{
+  HostFlash_close();
+
+  if (HostFlash_open(pFlashPath, OSAL_SNV_LOG_BASE,
+                     OSAL_SNV_LOG_NUM_PAGES * OSAL_SNV_LOG_PAGE_SIZE) != 0)
+  {
+    perror(pFlashPath);
+    exit(1);
+  }
+
+  bench_check(osal_snv_init() == SUCCESS, "init after reset");
+}
+
+/*
+ * Check that every item reads back as last written.
+ */
+static void bench_verify(const char *pWhat)
+{
+  uint8_t buf[BENCH_MAX_ITEM];
+  uint16_t id;
+
+  for (id = 0; id <= OSAL_SNV_LOG_MAX_ID; id++)
+  {
+    if (modelLen[id] != 0)
+    {
+      if ((osal_snv_read(id, modelLen[id], buf) != SUCCESS) ||
+          (memcmp(buf, model[id], modelLen[id]) != 0))
+      {
+        bench_check(false, pWhat);
+        return;
+      }
+    }
+  }
+}
+
+/*
+ * Fill the new content of the items of a bond slot, in pNew, the
+ * records first and the table last.
+ */
+static void bench_newBond(uint8_t pNew[][BENCH_MAX_ITEM])
+{
+  uint8_t rec;
+  uint8_t i;
+
+  for (rec = 0; rec < BENCH_REC_IDS; rec++)
+  {
+    for (i = 0; i < recLens[rec]; i++)
+    {
+      pNew[rec][i] = rand();
+    }
+  }
+
+  // A new bond starts with all configurations off
+  memset(pNew[BENCH_REC_IDS], 0, BENCH_CFG_LEN);
+}
+
+/*
+ * NV Id and length of item i of a bond slot, as filled by
+ * bench_newBond().
+ */
+static uint8_t bench_itemId(uint8_t slot, uint8_t i, uint8_t *pLen)
+{
+  if (i == BENCH_REC_IDS)
+  {
+    *pLen = BENCH_CFG_LEN;
+    return BENCH_CFG_ID(slot);
+  }
+
+  *pLen = recLens[i];
+  return BENCH_REC_ID(slot, i);
+}
+
+/*
+ * Write the items of a bond slot, in one batch or one by one.
+ */
+static uint8_t bench_writeBond(uint8_t slot, uint8_t pNew[][BENCH_MAX_ITEM],
+                               bool batch)
+{
+  uint8_t status = SUCCESS;
+  uint8_t i;
+
+  if (batch)
+  {
+    osal_snv_batch_begin();
+  }
+
+  for (i = 0; i <= BENCH_REC_IDS && status == SUCCESS; i++)
+  {
+    uint8_t len;
+    uint8_t id = bench_itemId(slot, i, &len);
+
+    status = osal_snv_write(id, len, pNew[i]);
+  }
+
+  if (batch)
+  {
+    if (status == SUCCESS)
+    {
+      status = osal_snv_batch_commit();
+    }
+    else
+    {
+      osal_snv_batch_abort();
+    }
+  }
+
+  return status;
+}
+
+/*
+ * Add the flash work done since pBefore to pWork.
+ */
+static void bench_account(benchWork_t *pWork, const hostFlashStats_t *pBefore)
+{
+  hostFlashStats_t now;
+  uint64_t us;
+
+  HostFlash_getStats(&now);
+  us = now.busyUs - pBefore->busyUs;
+
+  pWork->count++;
+  pWork->programs += now.programs - pBefore->programs;
+  pWork->bytes += now.programBytes - pBefore->programBytes;
+  pWork->busyUs += us;
+  pWork->erases += now.erases - pBefore->erases;
+  if (us > pWork->maxUs)
+  {
+    pWork->maxUs = us;
+  }
+}
+
+/*
+ * Print the mean flash work of a kind of write.
+ */
+static void bench_printWork(const char *pName, const benchWork_t *pWork)
+{
+  printf("  %-14s %7.1f %7.1f %9.2f %9.2f %7u\n", pName,
+         (double)pWork->programs / pWork->count,
+         (double)pWork->bytes / pWork->count,
+         (double)pWork->busyUs / pWork->count / 1000,
+         (double)pWork->maxUs / 1000, pWork->erases);
+}
+
+/*
+ * Replay the bondings, then time the reads.
+ */
+static void bench_run(bool batch)
+{
+  benchWork_t bondWork = { 0 };
+  benchWork_t cccWork = { 0 };
+  benchWork_t idleWork = { 0 };
+  hostFlashStats_t before;
+  uint8_t newItems[BENCH_REC_IDS + 1][BENCH_MAX_ITEM];
+  uint64_t readNs = 0;
+  uint64_t readCycles = 0;
+  uint32_t reads = 0;
+  uint32_t k;
+  uint16_t id;
+  uint8_t sector;
+
+  bench_format();
+  srand(1);
+
+  for (k = 0; k < BENCH_BONDINGS; k++)
+  {
+    uint8_t slot = k % BENCH_BONDS;
+    uint8_t i;
+
+    bench_newBond(newItems);
+
+    HostFlash_getStats(&before);
+    bench_check(bench_writeBond(slot, newItems, batch) == SUCCESS,
+                "bond write");
+    bench_account(&bondWork, &before);
+
+    for (i = 0; i <= BENCH_REC_IDS; i++)
+    {
+      uint8_t len;
+
+      id = bench_itemId(slot, i, &len);
+      memcpy(model[id], newItems[i], len);
+      modelLen[id] = len;
+    }
+
+    // The peer enables its configurations one by one
+    id = BENCH_CFG_ID(slot);
+    for (i = 0; i < BENCH_CCC_UPDATES; i++)
+    {
+      uint8_t *pEntry = &model[id][(i % BENCH_CHAR_CFG) * 4];
+
+      pEntry[0] = 0x2B + i;
+      pEntry[1] = 0x00;
+      pEntry[2] = 0x01;
+
+      HostFlash_getStats(&before);
+      bench_check(osal_snv_write(id, BENCH_CFG_LEN, model[id]) == SUCCESS,
+                  "table write");
+      bench_account(&cccWork, &before);
+    }
+
+    HostFlash_getStats(&before);
+    while (osal_snv_idle())
+    {
+    }
+    bench_account(&idleWork, &before);
+
+    bench_verify("items after a connection");
+  }
+
+  printf("%s, %u bondings of %u slots, %u table writes each\n",
+         batch ? "bond written as one batch" : "bond written item by item",
+         BENCH_BONDINGS, BENCH_BONDS, BENCH_CCC_UPDATES);
+  printf("  per write       programs  bytes  busy ms   max ms  erases\n");
+  bench_printWork("bond", &bondWork);
+  bench_printWork("table", &cccWork);
+  bench_printWork("idle", &idleWork);
+
+  printf("  erases per sector:");
+  for (sector = 0; sector < OSAL_SNV_LOG_NUM_PAGES; sector++)
+  {
+    printf(" %u", HostFlash_eraseCount(sector));
+  }
+  printf("\n");
+
+  // Each item in turn, so that the index entry is not always cached
+  for (k = 0; k < BENCH_READS; k++)
+  {
+    for (id = 0; id <= OSAL_SNV_LOG_MAX_ID; id++)
+    {
+      if (modelLen[id] != 0)
+      {
+        uint8_t buf[BENCH_MAX_ITEM];
+        bench_t b;
+
+        bench_start(&b);
+        osal_snv_read(id, modelLen[id], buf);
+        bench_stop(&b);
+
+        readNs += b.ns;
+        readCycles += b.cycles;
+        reads++;
+      }
+    }
+  }
+
+  printf("  osal_snv_read: %.1f ns, %.1f cycles per read of %u items\n",
+         (double)readNs / reads, (double)readCycles / reads,
+         reads / BENCH_READS);
+
+  bench_reset();
+  bench_verify("items after a reset");
+}
+
+/*
+ * Cut the power at every 4th byte of a bond write; count the bonds that
+ * a replay finds torn.
+ */
+static void bench_powerLoss(bool batch)
+{
+  uint8_t newItems[BENCH_REC_IDS + 1][BENCH_MAX_ITEM];
+  uint32_t cuts = 0;
+  uint32_t torn = 0;
+  uint32_t cut;
+  bool done = false;
+
+  for (cut = 0; !done && (cut < OSAL_SNV_LOG_PAGE_SIZE); cut += 4)
+  {
+    uint8_t slot = cut % BENCH_BONDS;
+    uint8_t buf[BENCH_MAX_ITEM];
+    uint8_t status;
+    uint8_t numNew = 0;
+    uint8_t numOld = 0;
+    uint8_t i;
+
+    bench_newBond(newItems);
+
+    HostFlash_failAfter(cut);
+    status = bench_writeBond(slot, newItems, batch);
+    HostFlash_failAfter(HOSTFLASH_NO_FAIL);
+
+    // Cuts past the end of the write no longer interrupt it
+    if (status == SUCCESS)
+    {
+      done = true;
+      break;
+    }
+
+    cuts++;
+    bench_reset();
+
+    for (i = 0; i <= BENCH_REC_IDS; i++)
+    {
+      uint8_t len;
+      uint8_t id = bench_itemId(slot, i, &len);
+
+      if ((osal_snv_read(id, len, buf) == SUCCESS) &&
+          (memcmp(buf, newItems[i], len) == 0))
+      {
+        numNew++;
+        memcpy(model[id], newItems[i], len);
+      }
+      else if ((osal_snv_read(id, len, buf) == SUCCESS) &&
+               (memcmp(buf, model[id], len) == 0))
+      {
+        numOld++;
+      }
+    }
+
+    bench_check(numNew + numOld == BENCH_REC_IDS + 1,
+                "bond item neither old nor new after a power loss");
+
+    if ((numNew != 0) && (numOld != 0))
+    {
+      torn++;
+    }
+
+    bench_verify("other items after a power loss");
+
+    while (osal_snv_idle())
+    {
+    }
+  }
+
+  printf("  power cut in a bond write: %u torn bonds out of %u cuts\n",
+         torn, cuts);
+
+  bench_check(done, "bond write with the power on");
+
+  if (batch)
+  {
+    bench_check(torn == 0, "batch torn by a power loss");
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(int argc, char *argv[])
+{
+  if (argc > 1)
+  {
+    pFlashPath = argv[1];
+  }
+
+  printf("SNV log of %u sectors of %u bytes, batch buffer of %u bytes\n\n",
+         OSAL_SNV_LOG_NUM_PAGES, OSAL_SNV_LOG_PAGE_SIZE,
+         OSAL_SNV_LOG_BATCH_SIZE);
+
+  bench_run(false);
+  bench_powerLoss(false);
+  HostFlash_close();
+
+  printf("\n");
+  bench_run(true);
+  bench_powerLoss(true);
+  HostFlash_close();
+
+  unlink(pFlashPath);
+
+  if (failures != 0)
+  {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,391 @@
+/******************************************************************************
+
+ @file  timer_wheel_bench.c
+
+ @brief This file contains the host benchmark of the ICall timer wheel
+        against one RTOS clock per timer, with 10 to 1000 active
+        timers.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Runs the same timer workload on the Util clock API in the two ways it
+ * has been implemented:
+ *
+ *  - clock: one RTOS Clock per timer, as Util_constructClock() did
+ *    before ICALL_TIMER_WHEEL;
+ *  - wheel: one ICall timer wheel record per timer, all driven by a
+ *    single RTOS Clock, as Util_constructClock() does with
+ *    ICALL_TIMER_WHEEL.
+ *
+ * The workload models per-connection timers: every millisecond of
+ * simulated time, the timers whose restart interval has elapsed are
+ * restarted with Util_restartClock(), as a supervision timeout is on
+ * each received packet. Timers whose timeout is shorter than their
+ * restart interval expire and count an expiry. 10, 100 and 1000 timers
+ * run for 10 s of simulated time.
+ *
+ * Prints the cycles per restart, the cycles spent servicing clocks per
+ * simulated millisecond, the expiries, the expiries that came before
+ * the timeout had elapsed and the latest expiry. The host kernel walks
+ * every constructed Clock to find the next one due, as the TI-RTOS Clock
+ * module walks its queue on each serviced tick, so the clock service
+ * cost grows with the number of timers in the first case only. Restarts
+ * fall on millisecond boundaries, so the wheel rounds no timeout up and
+ * both cases expire the same timers at the same ticks.
+ *
+ * The wheel takes an ICall critical section per restart and per serviced
+ * event. On the host it costs two clock_gettime() calls of the Hwi-off
+ * accounting of host_rtos.c, printed first, while the host Clock stubs
+ * take none; on the target, Clock_stop() and Clock_start() each disable
+ * interrupts as well.
+ *
+ * icall.c is included rather than linked, as in the other ICall
+ * benchmarks. Build from the repository root with the defines and
+ * include paths of hostsim.c:
+ *
+ *   gcc -O2 -o timer_wheel_bench <hostsim.c flags> -DICALL_TIMER_WHEEL \
+ *       -Itools/hostsim/bench tools/hostsim/bench/timer_wheel_bench.c \
+ *       ble-stack/common/cc26xx/util.c tools/hostsim/host_rtos.c \
+ *       tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "icall.c"
+
+#include "util.h"
+
+#include "host_rtos.h"
+
+#include "bench.h"
+
+#ifndef ICALL_TIMER_WHEEL
+#error "timer_wheel_bench needs ICALL_TIMER_WHEEL"
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Most timers measured
+#define TW_MAX_TIMERS                     1000
+
+// Simulated time per run, in milliseconds
+#define TW_RUN_MS                         10000
+
+// Critical sections timed
+#define TW_CS_ROUNDS                      100000
+
+// Clock ticks per millisecond
+#define TW_TICKS_PER_MS                   (1000 / Clock_tickPeriod)
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Timer of the workload
+typedef struct
+{
+  Clock_Struct clock;         // Clock of the clock case
+  Util_ClockStruct wheel;     // Timer of the wheel case
+  uint32_t timeoutMs;         // Timeout set by each restart
+  uint32_t intervalMs;        // Time between restarts
+  uint32_t nextMs;            // Time of the next restart
+  UInt32 startTick;           // Clock tick of the last restart
+} twTimer_t;
+
+// Result of one run
+typedef struct
+{
+  double restartCycles;       // Cycles per restart
+  double serviceCycles;       // Clock service cycles per simulated ms
+  uint32_t expiries;
+  uint32_t early;             // Expiries before the timeout elapsed
+  UInt32 maxLate;             // Latest expiry after the timeout, in ticks
+} twStat_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, unused: no remote task is created
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { NULL };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 0;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Timer counts measured
+static const uint16_t twCounts[] = { 10, 100, TW_MAX_TIMERS };
+
+static twTimer_t twTimers[TW_MAX_TIMERS];
+
+// State of the current run
+static uint16_t twNumTimers;
+static bool twWheel;
+static uint32_t twNowMs;
+static uint32_t twEndMs;
+static uint32_t twRestarts;
+static uint64_t twRestartCycles;
+static uint32_t twExpiries;
+static uint32_t twEarly;
+static UInt32 twMaxLate;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Expiry callback of both cases.
+ */
+static void tw_expired(UArg arg)
+{
+  twTimer_t *pTimer = &twTimers[arg];
+  Int32 late = (Int32)(Clock_getTicks() - pTimer->startTick -
+                       pTimer->timeoutMs * TW_TICKS_PER_MS);
+
+  twExpiries++;
+  if (late < 0)
+  {
+    twEarly++;
+  }
+  else if ((UInt32)late > twMaxLate)
+  {
+    twMaxLate = late;
+  }
+}
+
+/*
+ * Restart a timer with its timeout.
+ */
+static void tw_restart(twTimer_t *pTimer)
+{
+  pTimer->startTick = Clock_getTicks();
+
+  if (twWheel)
+  {
+    Util_restartClock(&pTimer->wheel, pTimer->timeoutMs);
+  }
+  else
+  {
+    // Util_restartClock() before ICALL_TIMER_WHEEL
+    Clock_Handle handle = Clock_handle(&pTimer->clock);
+
+    if (Clock_isActive(handle))
+    {
+      Clock_stop(handle);
+    }
+    Clock_setTimeout(handle, pTimer->timeoutMs * TW_TICKS_PER_MS);
+    Clock_start(handle);
+  }
+}
+
+/*
+ * Idle hook: run the restarts of each millisecond, then advance time to
+ * the next millisecond or the next clock due, whichever is first.
+ */
+static Bool tw_idle(UInt32 nextDue, Bool due)
+{
+  UInt32 now = Clock_getTicks();
+  UInt32 next;
+
+  if (now == twNowMs * TW_TICKS_PER_MS)
+  {
+    bench_t bench;
+    uint16_t i;
+
+    if (twNowMs == twEndMs)
+    {
+      return FALSE;
+    }
+
+    bench_start(&bench);
+    for (i = 0; i < twNumTimers; i++)
+    {
+      if (twTimers[i].nextMs == twNowMs)
+      {
+        tw_restart(&twTimers[i]);
+        twTimers[i].nextMs += twTimers[i].intervalMs;
+        twRestarts++;
+      }
+    }
+    bench_stop(&bench);
+    twRestartCycles += bench.cycles;
+
+    twNowMs++;
+  }
+
+  next = twNowMs * TW_TICKS_PER_MS;
+  if (due && (Int32)(nextDue - next) < 0)
+  {
+    next = nextDue;
+  }
+  HostRtos_advance(next);
+
+  return TRUE;
+}
+
+/*
+ * Run the workload with count timers.
+ */
+static void tw_run(uint16_t count, bool wheel, twStat_t *pStat)
+{
+  bench_t bench;
+  uint16_t i;
+
+  twNumTimers = count;
+  twWheel = wheel;
+  twRestarts = 0;
+  twRestartCycles = 0;
+  twExpiries = 0;
+  twEarly = 0;
+  twMaxLate = 0;
+
+  // Start at the next millisecond boundary
+  twNowMs = (Clock_getTicks() + TW_TICKS_PER_MS - 1) / TW_TICKS_PER_MS;
+  twEndMs = twNowMs + TW_RUN_MS;
+  HostRtos_advance(twNowMs * TW_TICKS_PER_MS);
+
+  for (i = 0; i < count; i++)
+  {
+    twTimer_t *pTimer = &twTimers[i];
+
+    // Timeouts of 20 to 219 ms, restarts every 10 to 309 ms
+    pTimer->timeoutMs = 20 + (i * 7) % 200;
+    pTimer->intervalMs = 10 + (i * 13) % 300;
+    pTimer->nextMs = twNowMs + i % pTimer->intervalMs;
+
+    if (wheel)
+    {
+      Util_constructClock(&pTimer->wheel, tw_expired, pTimer->timeoutMs,
+                          0, FALSE, i);
+    }
+    else
+    {
+      // Util_constructClock() before ICALL_TIMER_WHEEL
+      Clock_Params params;
+
+      Clock_Params_init(&params);
+      params.period = 0;
+      params.startFlag = FALSE;
+      params.arg = i;
+      Clock_construct(&pTimer->clock, tw_expired,
+                      pTimer->timeoutMs * TW_TICKS_PER_MS, &params);
+    }
+  }
+  bench_start(&bench);
+  BIOS_start();
+  bench_stop(&bench);
+
+  pStat->restartCycles = (double)twRestartCycles / twRestarts;
+  pStat->serviceCycles = (double)(bench.cycles - twRestartCycles) /
+                         TW_RUN_MS;
+  pStat->expiries = twExpiries;
+  pStat->early = twEarly;
+  pStat->maxLate = twMaxLate;
+
+  for (i = 0; i < count; i++)
+  {
+    if (wheel)
+    {
+      Util_stopClock(&twTimers[i].wheel);
+    }
+    else
+    {
+      Clock_stop(Clock_handle(&twTimers[i].clock));
+      Clock_destruct(&twTimers[i].clock);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  uint8_t i;
+
+  ICall_init();
+
+  HostRtos_setIdleHook(tw_idle);
+
+  {
+    bench_t bench;
+    uint32_t n;
+
+    bench_start(&bench);
+    for (n = 0; n < TW_CS_ROUNDS; n++)
+    {
+      ICall_leaveCSImpl(ICall_enterCSImpl());
+    }
+    bench_stop(&bench);
+
+    printf("critical section: %.0f cycles\n",
+           (double)bench.cycles / TW_CS_ROUNDS);
+  }
+
+  printf("timers   cycles per restart   service cycles per ms        "
+         "expiries     early   max late (us)\n");
+  printf("           clock     wheel         clock     wheel"
+         "       clock     wheel  clk whl     clock wheel\n");
+
+  for (i = 0; i < sizeof(twCounts) / sizeof(twCounts[0]); i++)
+  {
+    twStat_t clock, wheel;
+
+    tw_run(twCounts[i], FALSE, &clock);
+    tw_run(twCounts[i], TRUE, &wheel);
+
+    printf("%6u %9.0f %9.0f %13.0f %9.0f %11u %9u %4u %3u %9u %5u\n",
+           twCounts[i], clock.restartCycles, wheel.restartCycles,
+           clock.serviceCycles, wheel.serviceCycles, clock.expiries,
+           wheel.expiries, clock.early, wheel.early,
+           clock.maxLate * Clock_tickPeriod, wheel.maxLate * Clock_tickPeriod);
+  }
+
+  return 0;
+}
@@ -0,0 +1,408 @@
+/******************************************************************************
+
+ @file  trng_bench.c
+
+ @brief This file contains the host benchmark of the TRNGCC26XX
+        entropy pool against the blocking TRNG read, on a simulated
+        TRNG.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Draws random words the way pairing and private address rotation do,
+ * in bursts of 4, 16 and 64 words every 10 ms of simulated time, in the
+ * two ways TRNGCC26XX_getNumber() serves them when built with
+ * TRNGCC26XX_POOL:
+ *
+ *  - blocking: interrupts are masked, the TRNG is configured and polled
+ *    until the word is ready, as every request was served before the
+ *    pool. Requests with parameters other than the defaults still take
+ *    this path, so the benchmark selects it with a clock divider of 2;
+ *    the simulated TRNG takes the same time for any configuration;
+ *  - pool: the word is taken from the entropy pool, refilled by the TRNG
+ *    interrupt, or from the DRBG while the pool is empty.
+ *
+ * The simulated TRNG makes a word TB_WORD_US after it is enabled or its
+ * last word read, and raises its interrupt when the word is ready. A
+ * poll from a task spins until then: simulated time advances while the
+ * task keeps interrupts masked. Prints the CPU time per word, counting
+ * the spin, the longest time interrupts were masked and the words read
+ * from the TRNG per word drawn.
+ *
+ * Build from the repository root with the defines and include paths of
+ * hostsim.c:
+ *
+ *   gcc -O2 -o trng_bench <hostsim.c flags> -DTRNGCC26XX_POOL \
+ *       -Itools/hostsim/bench tools/hostsim/bench/trng_bench.c \
+ *       ble-stack/components/hal/src/target/_common/TRNGCC26XX.c \
+ *       tools/hostsim/host_rtos.c tools/hostsim/host_board.c -lpthread
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include <driverlib/trng.h>
+#include <inc/hw_ints.h>
+#include <TRNGCC26XX.h>
+
+#include "host_rtos.h"
+
+#include "bench.h"
+
+#ifndef TRNGCC26XX_POOL
+#error "trng_bench needs TRNGCC26XX_POOL"
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Time the simulated TRNG takes per word with any configuration.
+// Assumed, not measured on a device; override to try other figures.
+#ifndef TB_WORD_US
+#define TB_WORD_US                        100
+#endif
+
+#define TB_WORD_TICKS                     (TB_WORD_US / Clock_tickPeriod)
+
+// Bursts drawn per measurement, one every TB_BURST_PERIOD_MS
+#define TB_BURSTS                         50
+#define TB_BURST_PERIOD_MS                10
+
+// Measurements per result. The smallest of their longest interrupts-off
+// times is kept, which leaves out host interrupts and page faults.
+#define TB_REPEAT                         25
+
+#define TB_TICKS_PER_MS                   (1000 / Clock_tickPeriod)
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Result of one measurement
+typedef struct
+{
+  double cpuUsPerWord;        // CPU time per word, spin included
+  double hwiOffUs;            // Longest time interrupts were masked
+  double trngPerWord;         // TRNG words read per word drawn
+} tbStat_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Board configuration of the TRNG driver
+static TRNGCC26XX_Object tbTrngObject;
+static const TRNGCC26XX_HWAttrs tbTrngHWAttrs = { 0 };
+
+const TRNGCC26XX_Config TRNGCC26XX_config[] = {
+  { &tbTrngObject, &tbTrngHWAttrs },
+  { NULL, NULL }
+};
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Burst lengths measured
+static const uint8_t tbBursts[] = { 4, 16, 64 };
+
+static Task_Struct tbTask;
+
+// Simulated TRNG
+static Clock_Struct tbTrngClock;
+static bool tbTrngEnabled;
+static bool tbTrngReady;
+static bool tbTrngIntEnabled;
+static UInt32 tbTrngDue;
+static uint32_t tbTrngState = 0x2545F491;
+static uint32_t tbTrngWords;
+
+/*********************************************************************
+ * SIMULATED TRNG
+ */
+
+/*
+ * Start generating a word.
+ */
+static void tb_trngStart(void)
+{
+  Clock_Handle handle = Clock_handle(&tbTrngClock);
+
+  tbTrngReady = FALSE;
+  tbTrngDue = Clock_getTicks() + TB_WORD_TICKS;
+
+  Clock_stop(handle);
+  Clock_setTimeout(handle, TB_WORD_TICKS);
+  Clock_start(handle);
+}
+
+/*
+ * A word is ready: raise the interrupt if enabled.
+ */
+static Void tb_trngClockFxn(UArg arg)
+{
+  tbTrngReady = TRUE;
+
+  if (tbTrngIntEnabled)
+  {
+    Hwi_post(INT_TRNG_IRQ);
+  }
+}
+
+void TRNGConfigure(uint32_t ui32MinSamplesPerCycle,
+                   uint32_t ui32MaxSamplesPerCycle,
+                   uint32_t ui32ClocksPerSample)
+{
+  // Configuring disables the TRNG
+  TRNGDisable();
+}
+
+void TRNGEnable(void)
+{
+  tbTrngEnabled = TRUE;
+  tb_trngStart();
+}
+
+void TRNGDisable(void)
+{
+  tbTrngEnabled = FALSE;
+  tbTrngReady = FALSE;
+  Clock_stop(Clock_handle(&tbTrngClock));
+}
+
+uint32_t TRNGStatusGet(void)
+{
+  // A task polling for the word spins until it is ready
+  if (tbTrngEnabled && !tbTrngReady &&
+      BIOS_getThreadType() == BIOS_ThreadType_Task)
+  {
+    HostRtos_advance(tbTrngDue);
+    Clock_stop(Clock_handle(&tbTrngClock));
+    tbTrngReady = TRUE;
+  }
+
+  return tbTrngReady ? TRNG_NUMBER_READY : 0;
+}
+
+uint32_t TRNGNumberGet(uint32_t ui32Word)
+{
+  if (!tbTrngReady)
+  {
+    return 0;
+  }
+
+  tbTrngWords++;
+
+  // Reading the number starts the generation of the next one
+  tb_trngStart();
+
+  // xorshift32 stands in for the entropy source
+  tbTrngState ^= tbTrngState << 13;
+  tbTrngState ^= tbTrngState >> 17;
+  tbTrngState ^= tbTrngState << 5;
+
+  return tbTrngState;
+}
+
+void TRNGIntEnable(uint32_t ui32IntFlags)
+{
+  tbTrngIntEnabled = TRUE;
+
+  // A word already ready raises the interrupt right away
+  if (tbTrngReady)
+  {
+    Hwi_post(INT_TRNG_IRQ);
+  }
+}
+
+void TRNGIntDisable(uint32_t ui32IntFlags)
+{
+  tbTrngIntEnabled = FALSE;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Draw the bursts of burst words with the pool or with the blocking path.
+ */
+static void tb_measure(TRNGCC26XX_Handle handle, uint8_t burst, bool pool,
+                   tbStat_t *pStat)
+{
+  TRNGCC26XX_Params params;
+  TRNGCC26XX_Params *pParams = NULL;
+  uint64_t cpuNs = 0;
+  UInt32 spinTicks = 0;
+  uint32_t trngWords = tbTrngWords;
+  uint16_t i;
+
+  if (!pool)
+  {
+    // Not the defaults: served by the blocking path
+    TRNGCC26XX_Params_init(&params);
+    params.clocksPerSample = 2;
+    pParams = &params;
+  }
+
+  HostRtos_resetHwiOffMax();
+
+  for (i = 0; i < TB_BURSTS; i++)
+  {
+    UInt32 start = Clock_getTicks();
+    bench_t bench;
+    uint8_t j;
+
+    bench_start(&bench);
+    for (j = 0; j < burst; j++)
+    {
+      int8_t status;
+
+      TRNGCC26XX_getNumber(handle, pParams, &status);
+      if (status != TRNGCC26XX_STATUS_SUCCESS)
+      {
+        abort();
+      }
+    }
+    bench_stop(&bench);
+
+    cpuNs += bench.ns;
+    spinTicks += Clock_getTicks() - start;
+
+    Task_sleep(TB_BURST_PERIOD_MS * TB_TICKS_PER_MS -
+               (Clock_getTicks() - start));
+  }
+
+  pStat->cpuUsPerWord = ((double)cpuNs / 1000 +
+                         (double)spinTicks * Clock_tickPeriod) /
+                        (TB_BURSTS * burst);
+  pStat->hwiOffUs = (double)HostRtos_hwiOffMaxNs() / 1000;
+  pStat->trngPerWord = (double)(tbTrngWords - trngWords) /
+                       (TB_BURSTS * burst);
+}
+
+/*
+ * Measure TB_REPEAT times and keep the smallest longest interrupts-off
+ * time, with the averages of the other results.
+ */
+static void tb_run(TRNGCC26XX_Handle handle, uint8_t burst, bool pool,
+                   tbStat_t *pStat)
+{
+  uint8_t i;
+
+  memset(pStat, 0, sizeof(*pStat));
+
+  for (i = 0; i < TB_REPEAT; i++)
+  {
+    tbStat_t stat;
+
+    tb_measure(handle, burst, pool, &stat);
+
+    pStat->cpuUsPerWord += stat.cpuUsPerWord / TB_REPEAT;
+    pStat->trngPerWord += stat.trngPerWord / TB_REPEAT;
+    if (i == 0 || stat.hwiOffUs < pStat->hwiOffUs)
+    {
+      pStat->hwiOffUs = stat.hwiOffUs;
+    }
+  }
+}
+
+/*
+ * Task function: let the pool fill, then measure.
+ */
+static Void tb_taskFxn(UArg a0, UArg a1)
+{
+  TRNGCC26XX_Handle handle;
+  uint8_t i;
+
+  TRNGCC26XX_init();
+  handle = TRNGCC26XX_open(0);
+
+  // The DRBG is seeded and the pool filled in the background
+  Task_sleep(TB_BURST_PERIOD_MS * TB_TICKS_PER_MS);
+
+  printf("burst     CPU us per word     max interrupts off (us)"
+         "   TRNG words per word\n");
+  printf("       blocking      pool       blocking      pool"
+         "       blocking      pool\n");
+
+  for (i = 0; i < sizeof(tbBursts); i++)
+  {
+    tbStat_t blocking, pool;
+
+    tb_run(handle, tbBursts[i], FALSE, &blocking);
+    tb_run(handle, tbBursts[i], TRUE, &pool);
+
+    printf("%5u %10.1f %9.2f %14.1f %9.2f %14.2f %9.2f\n", tbBursts[i],
+           blocking.cpuUsPerWord, pool.cpuUsPerWord, blocking.hwiOffUs,
+           pool.hwiOffUs, blocking.trngPerWord, pool.trngPerWord);
+  }
+
+  TRNGCC26XX_close(handle);
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  Clock_Params clockParams;
+
+  Clock_Params_init(&clockParams);
+  Clock_construct(&tbTrngClock, tb_trngClockFxn, TB_WORD_TICKS,
+                  &clockParams);
+
+  Task_construct(&tbTask, tb_taskFxn, NULL, NULL);
+
+  // Returns when the task is done
+  BIOS_start();
+
+  return 0;
+}
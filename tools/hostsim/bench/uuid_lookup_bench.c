@@ -0,0 +1,389 @@
+/******************************************************************************
+
+ @file  uuid_lookup_bench.c
+
+ @brief This file contains the host benchmark and exhaustive check of
+        the hashed GATT_FindUUIDRec() against the switch it replaced.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * Checks GATT_FindUUIDRec() against the switch it replaced and times
+ * both:
+ *
+ *  - every 16-bit UUID, 0x0000 to 0xFFFF, must give the same record as
+ *    the switch, copied below from the release as uuid_switchFindRec();
+ *  - 128-bit UUIDs are found once registered, and only then: every UUID
+ *    one bit off a registered one is a miss unless it is registered too,
+ *    as are deregistered UUIDs; registering twice, past
+ *    GATT_MAX_NUM_UUID128 or NULL fails;
+ *  - host CPU cycles per lookup of known 16-bit UUIDs (hits) and of
+ *    other UUIDs of the same range (misses), with the hash and with the
+ *    switch, and of 128-bit UUIDs with all GATT_MAX_NUM_UUID128
+ *    registered, against a scan of the same table with memcmp().
+ *
+ * Exits with 1 on any mismatch. gatt_uuid.c is included rather than
+ * linked, for GATT_MAX_NUM_UUID128. Build from the repository root with
+ * the defines and include paths of hostsim.c:
+ *
+ *   gcc -O2 -o uuid_lookup_bench <hostsim.c flags> -Ible-stack/host \
+ *       -Itools/hostsim/bench tools/hostsim/bench/uuid_lookup_bench.c
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "gatt_uuid.c"
+
+#include "bench.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Lookups per measurement
+#define UUID_BENCH_LOOKUPS                1000000
+
+// Number of 16-bit UUIDs known to the switch
+#define UUID_NUM_KNOWN                    21
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Known 16-bit UUIDs, in the order of the switch
+static const uint16 uuidKnown[UUID_NUM_KNOWN] =
+{
+  GAP_SERVICE_UUID, GATT_SERVICE_UUID, GATT_PRIMARY_SERVICE_UUID,
+  GATT_SECONDARY_SERVICE_UUID, GATT_INCLUDE_UUID, GATT_CHARACTER_UUID,
+  GATT_CHAR_EXT_PROPS_UUID, GATT_CHAR_USER_DESC_UUID,
+  GATT_CLIENT_CHAR_CFG_UUID, GATT_SERV_CHAR_CFG_UUID,
+  GATT_CHAR_FORMAT_UUID, GATT_CHAR_AGG_FORMAT_UUID, GATT_VALID_RANGE_UUID,
+  GATT_EXT_REPORT_REF_UUID, GATT_REPORT_REF_UUID, DEVICE_NAME_UUID,
+  APPEARANCE_UUID, RECONNECT_ADDR_UUID, PERI_PRIVACY_FLAG_UUID,
+  PERI_CONN_PARAM_UUID, SERVICE_CHANGED_UUID
+};
+
+// Vendor 128-bit UUIDs, one more than can be registered
+static uint8 uuid128[GATT_MAX_NUM_UUID128 + 1][ATT_UUID_SIZE];
+
+// Keeps the lookups from being optimized away
+static volatile uintptr_t uuidSink;
+
+static int uuidErrors;
+
+/*********************************************************************
+ * STACK STUBS
+ */
+
+uint8 osal_memcmp(const void GENERIC *src1, const void GENERIC *src2,
+                  unsigned int len)
+{
+  return memcmp(src1, src2, len) == 0;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      uuid_switchFindRec
+ *
+ * @brief   GATT_FindUUIDRec() of the release, the reference.
+ */
+static const uint8 *uuid_switchFindRec(const uint8 *pUUID, uint8 len)
+{
+  const uint8 *pRec = NULL;
+
+  if (len == ATT_BT_UUID_SIZE)
+  {
+    switch (BUILD_UINT16(pUUID[0], pUUID[1]))
+    {
+      case GAP_SERVICE_UUID:            pRec = gapServiceUUID;       break;
+      case GATT_SERVICE_UUID:           pRec = gattServiceUUID;      break;
+      case GATT_PRIMARY_SERVICE_UUID:   pRec = primaryServiceUUID;   break;
+      case GATT_SECONDARY_SERVICE_UUID: pRec = secondaryServiceUUID; break;
+      case GATT_INCLUDE_UUID:           pRec = includeUUID;          break;
+      case GATT_CHARACTER_UUID:         pRec = characterUUID;        break;
+      case GATT_CHAR_EXT_PROPS_UUID:    pRec = charExtPropsUUID;     break;
+      case GATT_CHAR_USER_DESC_UUID:    pRec = charUserDescUUID;     break;
+      case GATT_CLIENT_CHAR_CFG_UUID:   pRec = clientCharCfgUUID;    break;
+      case GATT_SERV_CHAR_CFG_UUID:     pRec = servCharCfgUUID;      break;
+      case GATT_CHAR_FORMAT_UUID:       pRec = charFormatUUID;       break;
+      case GATT_CHAR_AGG_FORMAT_UUID:   pRec = charAggFormatUUID;    break;
+      case GATT_VALID_RANGE_UUID:       pRec = validRangeUUID;       break;
+      case GATT_EXT_REPORT_REF_UUID:    pRec = extReportRefUUID;     break;
+      case GATT_REPORT_REF_UUID:        pRec = reportRefUUID;        break;
+      case DEVICE_NAME_UUID:            pRec = deviceNameUUID;       break;
+      case APPEARANCE_UUID:             pRec = appearanceUUID;       break;
+      case RECONNECT_ADDR_UUID:         pRec = reconnectAddrUUID;    break;
+      case PERI_PRIVACY_FLAG_UUID:      pRec = periPrivacyFlagUUID;  break;
+      case PERI_CONN_PARAM_UUID:        pRec = periConnParamUUID;    break;
+      case SERVICE_CHANGED_UUID:        pRec = serviceChangedUUID;   break;
+      default:                                                       break;
+    }
+  }
+
+  return pRec;
+}
+
+/*********************************************************************
+ * @fn      uuid_scanFindRec
+ *
+ * @brief   Full compare of a 128-bit UUID with every registered one,
+ *          the reference for 128-bit lookups.
+ */
+static const uint8 *uuid_scanFindRec(const uint8 *pUUID, uint8 len)
+{
+  uint8 i;
+
+  for (i = 0; len == ATT_UUID_SIZE && i < GATT_MAX_NUM_UUID128; i++)
+  {
+    if (memcmp(uuid128[i], pUUID, ATT_UUID_SIZE) == 0)
+    {
+      return uuid128[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      uuid_expect
+ *
+ * @brief   Count a mismatch and print the first few.
+ */
+static void uuid_expect(int ok, const char *what, unsigned value)
+{
+  if (!ok && uuidErrors++ < 10)
+  {
+    printf("FAIL: %s 0x%04x\n", what, value);
+  }
+}
+
+/*********************************************************************
+ * @fn      uuid_check
+ *
+ * @brief   Exhaustive check of the 16-bit lookup and check of the
+ *          128-bit registration.
+ */
+static void uuid_check(void)
+{
+  uint8 probe[ATT_UUID_SIZE];
+  uint32 value;
+  uint8 hits = 0;
+  uint8 i, j;
+
+  for (value = 0; value <= 0xFFFF; value++)
+  {
+    const uint8 *pRec;
+
+    probe[0] = LO_UINT16(value);
+    probe[1] = HI_UINT16(value);
+    pRec = GATT_FindUUIDRec(probe, ATT_BT_UUID_SIZE);
+    uuid_expect(pRec == uuid_switchFindRec(probe, ATT_BT_UUID_SIZE),
+                "16-bit record", value);
+    hits += (pRec != NULL);
+  }
+  uuid_expect(hits == UUID_NUM_KNOWN, "16-bit hits", hits);
+
+  // Other lengths are never found
+  probe[0] = LO_UINT16(GATT_PRIMARY_SERVICE_UUID);
+  probe[1] = HI_UINT16(GATT_PRIMARY_SERVICE_UUID);
+  for (i = 0; i <= ATT_UUID_SIZE + 1; i++)
+  {
+    uuid_expect(i == ATT_BT_UUID_SIZE || i == ATT_UUID_SIZE ||
+                GATT_FindUUIDRec(probe, i) == NULL, "length", i);
+  }
+
+  for (i = 0; i <= GATT_MAX_NUM_UUID128; i++)
+  {
+    uuid_expect(GATT_FindUUIDRec(uuid128[i], ATT_UUID_SIZE) == NULL,
+                "128-bit before registration", i);
+  }
+
+  for (i = 0; i < GATT_MAX_NUM_UUID128; i++)
+  {
+    uuid_expect(GATT_RegisterUUID128(uuid128[i]) == SUCCESS,
+                "register", i);
+    uuid_expect(GATT_RegisterUUID128(uuid128[i]) ==
+                bleAlreadyInRequestedMode, "register twice", i);
+  }
+  uuid_expect(GATT_RegisterUUID128(uuid128[GATT_MAX_NUM_UUID128]) ==
+              bleNoResources, "register past the limit",
+              GATT_MAX_NUM_UUID128);
+  uuid_expect(GATT_RegisterUUID128(NULL) == INVALIDPARAMETER,
+              "register NULL", 0);
+
+  for (i = 0; i <= GATT_MAX_NUM_UUID128; i++)
+  {
+    // A copy, so that the record is found by value
+    memcpy(probe, uuid128[i], ATT_UUID_SIZE);
+    uuid_expect(GATT_FindUUIDRec(probe, ATT_UUID_SIZE) ==
+                uuid_scanFindRec(probe, ATT_UUID_SIZE), "128-bit record", i);
+
+    for (j = 0; j < ATT_UUID_SIZE * 8; j++)
+    {
+      probe[j / 8] ^= 1 << (j % 8);
+      uuid_expect(GATT_FindUUIDRec(probe, ATT_UUID_SIZE) ==
+                  uuid_scanFindRec(probe, ATT_UUID_SIZE),
+                  "128-bit one bit off", (i << 8) | j);
+      probe[j / 8] ^= 1 << (j % 8);
+    }
+  }
+
+  for (i = 0; i < GATT_MAX_NUM_UUID128; i += 2)
+  {
+    uuid_expect(GATT_DeregisterUUID128(uuid128[i]) == SUCCESS,
+                "deregister", i);
+    uuid_expect(GATT_DeregisterUUID128(uuid128[i]) == INVALIDPARAMETER,
+                "deregister twice", i);
+  }
+  for (i = 0; i < GATT_MAX_NUM_UUID128; i++)
+  {
+    uuid_expect((GATT_FindUUIDRec(uuid128[i], ATT_UUID_SIZE) != NULL) ==
+                (i % 2 == 1), "128-bit after deregistration", i);
+  }
+
+  // The freed entries are reused
+  for (i = 0; i < GATT_MAX_NUM_UUID128; i += 2)
+  {
+    uuid_expect(GATT_RegisterUUID128(uuid128[i]) == SUCCESS,
+                "register again", i);
+  }
+}
+
+/*********************************************************************
+ * @fn      uuid_time
+ *
+ * @brief   Host CPU cycles per lookup of the given UUIDs.
+ */
+static double uuid_time(const uint8 *(*pfnFind)(const uint8 *, uint8),
+                        uint8 (*pUUIDs)[ATT_UUID_SIZE], uint8 num,
+                        uint8 len)
+{
+  bench_t bench;
+  uint32 n;
+
+  bench_start(&bench);
+  for (n = 0; n < UUID_BENCH_LOOKUPS; n++)
+  {
+    uuidSink += (uintptr_t)pfnFind(pUUIDs[n % num], len);
+  }
+  bench_stop(&bench);
+
+  return (double)bench.cycles / UUID_BENCH_LOOKUPS;
+}
+
+/*********************************************************************
+ * @fn      main
+ */
+int main(void)
+{
+  static uint8 hits16[UUID_NUM_KNOWN][ATT_UUID_SIZE];
+  static uint8 misses16[UUID_NUM_KNOWN][ATT_UUID_SIZE];
+  static uint8 misses128[GATT_MAX_NUM_UUID128][ATT_UUID_SIZE];
+  uint8 i, j;
+
+  // Vendor UUIDs on a common base, as a custom service defines them
+  for (i = 0; i <= GATT_MAX_NUM_UUID128; i++)
+  {
+    for (j = 0; j < ATT_UUID_SIZE; j++)
+    {
+      uuid128[i][j] = 0xB0 + j * 7;
+    }
+    uuid128[i][12] = 0xF1 + i;
+    uuid128[i][13] = 0xFF;
+  }
+
+  uuid_check();
+  if (uuidErrors)
+  {
+    printf("%d mismatches\n", uuidErrors);
+    return 1;
+  }
+  printf("65536 16-bit UUIDs match the switch, 128-bit registration "
+         "checked\n\n");
+
+  for (i = 0; i < UUID_NUM_KNOWN; i++)
+  {
+    hits16[i][0] = LO_UINT16(uuidKnown[i]);
+    hits16[i][1] = HI_UINT16(uuidKnown[i]);
+
+    // Misses of the assigned ranges, next to the known UUIDs
+    misses16[i][0] = LO_UINT16(uuidKnown[i] + 0x40);
+    misses16[i][1] = HI_UINT16(uuidKnown[i] + 0x40);
+  }
+
+  // Same base as the registered UUIDs, another 16-bit part
+  for (i = 0; i < GATT_MAX_NUM_UUID128; i++)
+  {
+    memcpy(misses128[i], uuid128[i], ATT_UUID_SIZE);
+    misses128[i][13] = 0x00;
+  }
+
+  printf("lookup (cycles)          hash    reference\n");
+  printf("16-bit hit          %9.1f %9.1f   (switch)\n",
+         uuid_time(GATT_FindUUIDRec, hits16, UUID_NUM_KNOWN,
+                   ATT_BT_UUID_SIZE),
+         uuid_time(uuid_switchFindRec, hits16, UUID_NUM_KNOWN,
+                   ATT_BT_UUID_SIZE));
+  printf("16-bit miss         %9.1f %9.1f   (switch)\n",
+         uuid_time(GATT_FindUUIDRec, misses16, UUID_NUM_KNOWN,
+                   ATT_BT_UUID_SIZE),
+         uuid_time(uuid_switchFindRec, misses16, UUID_NUM_KNOWN,
+                   ATT_BT_UUID_SIZE));
+  printf("128-bit hit         %9.1f %9.1f   (memcmp scan)\n",
+         uuid_time(GATT_FindUUIDRec, uuid128, GATT_MAX_NUM_UUID128,
+                   ATT_UUID_SIZE),
+         uuid_time(uuid_scanFindRec, uuid128, GATT_MAX_NUM_UUID128,
+                   ATT_UUID_SIZE));
+  printf("128-bit miss        %9.1f %9.1f   (memcmp scan)\n",
+         uuid_time(GATT_FindUUIDRec, misses128, GATT_MAX_NUM_UUID128,
+                   ATT_UUID_SIZE),
+         uuid_time(uuid_scanFindRec, misses128, GATT_MAX_NUM_UUID128,
+                   ATT_UUID_SIZE));
+
+  return 0;
+}
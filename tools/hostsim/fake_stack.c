@@ -0,0 +1,2755 @@
+/******************************************************************************
+
+ @file  fake_stack.c
+
+ @brief This file contains a scripted BLE stack for host simulation.
+        It serves the ICall commands of the application with the
+        responses and events the stack image would produce, and turns
+        trace events into the messages and attribute callbacks a peer
+        would cause.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Queue.h>
+
+#include "bcomdef.h"
+#include "hci_tl.h"
+#include "hci_ext.h"
+#include "gap.h"
+#include "gatt.h"
+#include "gatt_uuid.h"
+#include "gattservapp.h"
+#include "gapbondmgr.h"
+#include "linkdb.h"
+#include "osal_snv.h"
+
+#include "icall.h"
+#include "icall_apimsg.h"
+#include "ble_dispatch.h"
+#include "ble_user_config.h"
+
+#include "util.h"
+#include "aes.h"
+
+#include "fake_stack.h"
+
+/*
+ * Only what the application can observe is modeled: command statuses,
+ * the completion events of GAP procedures, link and ATT events, and
+ * calls into the attribute callbacks of registered services. Everything
+ * happens at once; the air interface takes no time. Only commands can be
+ * given a round trip time, see FakeStack_setCmdDelay().
+ *
+ * The controller buffers are unlimited until a FAKESTACK_EVT_BUFFERS
+ * event throttles them. Each ATT response and notification then holds a
+ * buffer until a connection event of its connection frees it. A response
+ * to a peer request that finds no free buffer is handed to the
+ * application as pending, as the GATT server does, and GATT_SendRsp()
+ * and notifications fail until a buffer is freed.
+ *
+ * A FAKESTACK_EVT_RADIO event models the air interface instead of taking
+ * connection events from the trace: they run at the connection interval,
+ * and the slave skips up to its slave latency of them while it has
+ * nothing to send. Each event the slave listens to sends some of the
+ * PDUs it holds and adds to the radio-on time. The client of a
+ * FAKESTACK_EVT_BURST sends its next read in the event its previous
+ * response went out in, as ATT allows one request at a time.
+ *
+ * L2CAP Connection Oriented Channels lead to a modeled peer that loops
+ * every SDU back. A FAKESTACK_EVT_L2CAP event has the peer connect a
+ * channel to a registered PSM; L2CAP_ConnectReq() is accepted as well.
+ * An SDU is split into LE-frames of the peer MPS, which take a credit
+ * each, and the frames into PDUs of the LL payload of the modeled air.
+ * The PDUs take controller buffers, at most MAX_NUM_PDU of a connection
+ * while the buffers are not throttled, and the SDU is done once its
+ * last PDU has a buffer; a Flow Control Credit packet takes a buffer as
+ * well. The task of L2CAP_RegisterFlowCtrlTask() hears of the buffers
+ * each connection event frees. The peer sends each SDU it received back
+ * in the master PDUs of the connection events, as its credits allow, and
+ * returns credits once it received half as many LE-frames as it gave
+ * credits for. A connection event carries up to its number of PDUs in
+ * each direction, as long as they fit in the connection interval.
+ *
+ * Bonds are added with FakeStack_addBond() and resolve peer addresses as
+ * the Bond Manager does: a resolvable private address is checked with
+ * ah() against the IRK of each bond in turn, on the software AES of the
+ * stack library (sspAesEncrypt_Sw()).
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Services registered with GATTServApp_RegisterService()
+#define FAKESTACK_MAX_SERVICES            8
+
+// NV items kept by osal_snv_write(), lost on exit
+#define FAKESTACK_NV_ITEMS                16
+
+// Largest ATT MTU
+#define FAKESTACK_MAX_MTU                 251
+
+// Connection parameters of a connect event without any
+#define FAKESTACK_DEFAULT_INTERVAL        40  // 50 ms
+#define FAKESTACK_DEFAULT_TIMEOUT         500 // 5 s
+
+// Pending ATT responses tracked per connection, oldest first
+#define FAKESTACK_MAX_PENDING             8
+
+// ATT transaction timeout of the client (ms)
+#define FAKESTACK_ATT_TIMEOUT             30000
+
+// Modeled air interface at 1 Mbps: radio ramp-up and the empty packet
+// exchange of a connection event, the bytes a data PDU adds to its ATT
+// bytes (preamble, access address, headers, L2CAP header and CRC) and
+// the interframe space after it
+#define FAKESTACK_RADIO_EVT_US            400
+#define FAKESTACK_RADIO_PDU_BYTES         14
+#define FAKESTACK_RADIO_IFS_US            150
+#define FAKESTACK_RADIO_US_PER_BYTE       8
+
+// PDUs sent per connection event on the modeled air by default
+#define FAKESTACK_RADIO_EVT_PDUS          4
+
+// No connection event due, see fakeStack_runRadio()
+#define FAKESTACK_NO_EVT                  0xFFFFFFFF
+
+// LL payload of a PDU without Data Length Extension
+#define FAKESTACK_LL_OCTETS               27
+
+// PSMs and L2CAP Connection Oriented Channels
+#define FAKESTACK_MAX_PSMS                2
+#define FAKESTACK_MAX_CHANNELS            2
+
+// PDU buffers of the stack, MAX_NUM_PDU of the stack image by default
+#define FAKESTACK_COC_PDUS                5
+
+// LE-frames of a channel in controller buffers
+#define FAKESTACK_COC_FRAMES              32
+
+// MPS of the stack: an LE-frame fits in one PDU of the largest LL payload
+#define FAKESTACK_COC_MPS                 (251 - L2CAP_HDR_SIZE)
+
+// Channel parameters of the modeled peer by default
+#define FAKESTACK_COC_PEER_MTU            L2CAP_SDU_SIZE
+#define FAKESTACK_COC_PEER_MPS            FAKESTACK_COC_MPS
+#define FAKESTACK_COC_PEER_CREDITS        16
+
+// SDU length field of the first LE-frame of an SDU
+#define FAKESTACK_COC_SDU_HDR             2
+
+// LE Flow Control Credit packet after the L2CAP header: code, id, length,
+// CID and credits
+#define FAKESTACK_COC_CREDIT_LEN          8
+
+/*********************************************************************
+ * MACROS
+ */
+
+// Connection interval of a connection in ticks; intervals are in units
+// of 1.25 ms
+#define FAKESTACK_INTERVAL_TICKS(connHandle) \
+  ((uint32_t)conns[connHandle].interval * 1250 / Clock_tickPeriod)
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Queued trace event
+typedef struct
+{
+  Queue_Elem elem;
+  fakeStackEvt_t evt;
+} fakeStackQEvt_t;
+
+// Command in flight, see FakeStack_setCmdDelay()
+typedef struct
+{
+  Queue_Elem elem;
+  ICall_EntityID src;
+  ICall_HciExtCmd *pCmd;
+  uint32_t due;             // Tick the command is processed at
+} fakeStackQCmd_t;
+
+// Registered service
+typedef struct
+{
+  gattAttribute_t *pAttrs;
+  uint16 numAttrs;
+  const gattServiceCBs_t *pCBs;
+} fakeStackService_t;
+
+// Connection
+typedef struct
+{
+  uint8 active;
+  uint16 interval;
+  uint16 latency;
+  uint16 timeout;
+  uint16 mtu;
+  uint8 bufs;                                 // Controller buffers held
+  uint16 txBytes;                             // ATT bytes of their PDUs
+  uint8 numPending;                           // Pending ATT responses
+  uint32_t pendingTicks[FAKESTACK_MAX_PENDING]; // Tick each was handed back
+  uint8 reqWaiting;                           // Peer request not answered
+  uint8 rspPdus;                              // PDUs up to its response
+  uint32_t nextEvt;                           // Tick of the next event
+  uint16 skipped;                             // Events skipped in a row
+  uint16 burstHandle;                         // Attribute the client reads
+  uint16 burstLeft;                           // Reads left in the burst
+  uint8 burstActive;                          // Burst not completed yet
+  uint32_t burstStart;                        // Tick the burst started
+  uint32_t txSeq;                             // PDUs given buffers
+  uint32_t sentSeq;                           // PDUs sent
+} fakeStackConn_t;
+
+// PSM of L2CAP_RegisterPsm()
+typedef struct
+{
+  uint16 psm;
+  uint16 mtu;
+  uint16 initPeerCredits;
+  uint16 peerCreditThreshold;
+  ICall_EntityID taskId;
+} fakeStackPsm_t;
+
+// SDU on its way to the peer or back
+typedef struct
+{
+  Queue_Elem elem;
+  uint8 *pData;                               // Copy of the peer
+  uint16 len;
+  uint32_t seq;                               // txSeq of its last PDU
+} fakeStackSdu_t;
+
+// L2CAP Connection Oriented Channel. Its local and peer CIDs are the same.
+typedef struct
+{
+  uint8 active;
+  uint16 connHandle;
+  fakeStackPsm_t *pPsm;
+  uint16 peerMtu;
+  uint16 peerMps;
+  uint16 peerInitCredits;                     // Credits the peer gave
+  uint16 credits;                             // LE-frames the stack may send
+  uint16 peerCredits;                         // LE-frames the peer may send
+  uint8 stalled;                              // Out of credits
+  uint8 peerStalled;                          // Peer out of credits
+  uint8 belowThreshold;                       // Threshold event sent
+  uint8 *pTxSdu;                              // SDU being sent
+  uint16 txLen;
+  uint16 txSplit;                             // Bytes of it in LE-frames
+  uint16 frameLeft;                           // Bytes of the last frame
+                                              // waiting for a buffer
+  uint32_t frameSeq[FAKESTACK_COC_FRAMES];    // txSeq of the last PDU of
+                                              // each frame in buffers
+  uint8 frameHead;
+  uint8 frameCount;
+  Queue_Struct sentQ;                         // SDUs on the air
+  Queue_Handle sentQueue;
+  Queue_Struct echoQ;                         // SDUs the peer sends back
+  Queue_Handle echoQueue;
+  uint16 echoSplit;                           // Bytes of the first one
+                                              // in LE-frames
+  uint16 echoFrameLeft;                       // Bytes of the last frame
+                                              // not sent
+  uint16 peerRxFrames;                        // LE-frames the peer got
+                                              // since it returned credits
+  uint16 peerGrant;                           // Credits the peer returns
+                                              // in its next PDU
+  uint16 grant;                               // Credits returned to the
+                                              // peer, which it gets once
+  uint32_t grantSeq;                          // this PDU is sent
+} fakeStackChan_t;
+
+// Bond, see FakeStack_addBond()
+typedef struct
+{
+  uint8 used;
+  uint8 irk[KEYLEN];                          // Least significant octet first
+  uint8 idAddr[B_ADDR_LEN];                   // Public identity address
+} fakeStackBond_t;
+
+// NV item
+typedef struct
+{
+  osalSnvId_t id;
+  osalSnvLen_t len;
+  uint8 *pData;
+} fakeStackNvItem_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static ICall_EntityID stackEntity;
+static ICall_SyncHandle stackSync;
+
+static Queue_Struct evtQ;
+static Queue_Handle evtQueue;
+
+// Commands in flight, in the order they were sent, and their delay
+static Queue_Struct cmdQ;
+static Queue_Handle cmdQueue;
+static uint32_t cmdDelay = 0;
+
+// Tick advertising was first enabled at
+static uint8 advStarted = FALSE;
+static uint32_t advStart;
+
+// Task of GAP_DeviceInit(), which gets the GAP link events
+static ICall_EntityID gapRoleTask = ICALL_INVALID_ENTITY_ID;
+
+// Task of GATT_RegisterForMsgs()
+static ICall_EntityID gattTask = ICALL_INVALID_ENTITY_ID;
+
+// HCI_EXT_ConnEventNoticeCmd() registrations, per connection handle
+static ICall_EntityID noticeTask[FAKESTACK_MAX_CONNS];
+static uint16 noticeEvent[FAKESTACK_MAX_CONNS];
+
+// Task of L2CAP_RegisterFlowCtrlTask()
+static ICall_EntityID l2capFcTask = ICALL_INVALID_ENTITY_ID;
+
+static fakeStackConn_t conns[FAKESTACK_MAX_CONNS];
+
+// Controller buffers, see FAKESTACK_EVT_BUFFERS; unlimited while
+// bufTotal is 0. bufPerEvt is the number freed per connection event,
+// 0 for all of the connection.
+static uint8 bufTotal = 0;
+static uint8 bufPerEvt = 0;
+static uint8 bufUsed = 0;
+
+// PDUs per connection event on the modeled air, 0 while connection
+// events come from the trace, and the LL payload of L2CAP PDUs, see
+// FAKESTACK_EVT_RADIO
+static uint8 radioPdus = 0;
+static uint8 radioOctets = FAKESTACK_LL_OCTETS;
+
+static fakeStackPsm_t psms[FAKESTACK_MAX_PSMS];
+static uint8 numPsms = 0;
+
+static fakeStackChan_t chans[FAKESTACK_MAX_CHANNELS];
+
+static fakeStackService_t services[FAKESTACK_MAX_SERVICES];
+static uint8 numServices = 0;
+static uint16 nextHandle = FAKESTACK_FIRST_HANDLE;
+
+static uint16 gapParams[TGAP_PARAMID_MAX];
+
+static fakeStackNvItem_t nvItems[FAKESTACK_NV_ITEMS];
+
+static fakeStackBond_t bonds[GAP_BONDINGS_MAX];
+
+static fakeStackStats_t stats;
+
+static const uint8 ownAddr[B_ADDR_LEN] = { 0x01, 0x00, 0x00, 0xAD, 0x6B, 0xB0 };
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void fakeStack_connEvt(uint16 connHandle);
+
+/*********************************************************************
+ * @fn      fakeStack_bmAlloc
+ *
+ * @brief   Buffer allocator of GATT_bm_alloc() and L2CAP_bm_alloc().
+ */
+static void *fakeStack_bmAlloc(uint8_t type, uint16_t size,
+                               uint16_t connHandle, uint8_t opcode,
+                               uint16_t *pSizeAlloc)
+{
+  void *pBuf = ICall_malloc(size);
+
+  if (pBuf != NULL && pSizeAlloc != NULL)
+  {
+    *pSizeAlloc = size;
+  }
+
+  return pBuf;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_bmFree
+ *
+ * @brief   Buffer de-allocator of GATT_bm_free() and BM_free(). GATT
+ *          messages own a payload only for some opcodes.
+ */
+static void fakeStack_bmFree(uint8_t type, void *pMsg, uint8_t opcode)
+{
+  gattMsg_t *pGattMsg = (gattMsg_t *)pMsg;
+  uint8 *pPayload = NULL;
+
+  if (type != BM_MSG_GATT)
+  {
+    ICall_free(pMsg);
+
+    return;
+  }
+
+  switch (opcode)
+  {
+    case ATT_HANDLE_VALUE_NOTI:
+      pPayload = pGattMsg->handleValueNoti.pValue;
+      pGattMsg->handleValueNoti.pValue = NULL;
+      break;
+
+    case ATT_HANDLE_VALUE_IND:
+      pPayload = pGattMsg->handleValueInd.pValue;
+      pGattMsg->handleValueInd.pValue = NULL;
+      break;
+
+    case ATT_READ_RSP:
+      pPayload = pGattMsg->readRsp.pValue;
+      pGattMsg->readRsp.pValue = NULL;
+      break;
+
+    case ATT_READ_BLOB_RSP:
+      pPayload = pGattMsg->readBlobRsp.pValue;
+      pGattMsg->readBlobRsp.pValue = NULL;
+      break;
+
+    case ATT_WRITE_REQ:
+      pPayload = pGattMsg->writeReq.pValue;
+      pGattMsg->writeReq.pValue = NULL;
+      break;
+
+    default:
+      break;
+  }
+
+  if (pPayload != NULL)
+  {
+    ICall_free(pPayload);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_send
+ *
+ * @brief   Send a message to an application task.
+ */
+static void fakeStack_send(ICall_EntityID dest, void *pMsg)
+{
+  if (dest == ICALL_INVALID_ENTITY_ID ||
+      ICall_send(stackEntity, dest, ICALL_MSG_FORMAT_KEEP,
+                 pMsg) != ICALL_ERRNO_SUCCESS)
+  {
+    ICall_freeMsg(pMsg);
+
+    return;
+  }
+
+  stats.events++;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_allocEvt
+ *
+ * @brief   Allocate a stack to application message.
+ *
+ * @param   event - osal event of the message
+ * @param   status - status of the message
+ * @param   size - size of the message
+ *
+ * @return  message, zeroed but for the header, or NULL
+ */
+static void *fakeStack_allocEvt(uint8 event, uint8 status, uint16 size)
+{
+  osal_event_hdr_t *pHdr = (osal_event_hdr_t *)ICall_allocMsg(size);
+
+  if (pHdr != NULL)
+  {
+    memset(pHdr, 0, size);
+    pHdr->event = event;
+    pHdr->status = status;
+  }
+
+  return pHdr;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_sendGapEvt
+ *
+ * @brief   Send a GAP event that carries nothing but its opcode.
+ */
+static void fakeStack_sendGapEvt(ICall_EntityID dest, uint8 opcode)
+{
+  gapEventHdr_t *pEvt = fakeStack_allocEvt(GAP_MSG_EVENT, SUCCESS,
+                                           sizeof(gapEventHdr_t));
+
+  if (pEvt != NULL)
+  {
+    pEvt->opcode = opcode;
+    fakeStack_send(dest, pEvt);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_sendCmdStatus
+ *
+ * @brief   Complete a command with a Command Status event, which the
+ *          icall_api.c match functions recognize by the echoed opcode and
+ *          command id.
+ *
+ * @param   dest - sender of the command
+ * @param   pCmd - command
+ * @param   status - status of the command
+ * @param   len - length of the returned value
+ * @param   pValue - returned value, copied into the event
+ */
+static void fakeStack_sendCmdStatus(ICall_EntityID dest, ICall_HciExtCmd *pCmd,
+                                    uint8 status, uint8 len,
+                                    const void *pValue)
+{
+  ICall_GapCmdStatus *pCS =
+    fakeStack_allocEvt(ICALL_EVENT_EVENT, status,
+                       sizeof(ICall_GapCmdStatus) + len);
+
+  if (pCS != NULL)
+  {
+    pCS->hdr.eventOpcode = HCI_EXT_GAP_CMD_STATUS_EVENT;
+    pCS->opCode = pCmd->opCode;
+    pCS->cmdId = pCmd->cmdId;
+    pCS->len = len;
+    pCS->pValue = (uint8 *)(pCS + 1);
+    if (len != 0)
+    {
+      memcpy(pCS->pValue, pValue, len);
+    }
+
+    fakeStack_send(dest, pCS);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_numActive
+ *
+ * @brief   Count the active connections.
+ */
+static uint8 fakeStack_numActive(void)
+{
+  uint8 i;
+  uint8 num = 0;
+
+  for (i = 0; i < FAKESTACK_MAX_CONNS; i++)
+  {
+    num += conns[i].active;
+  }
+
+  return num;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_getConn
+ *
+ * @brief   Look up an active connection.
+ */
+static fakeStackConn_t *fakeStack_getConn(uint16 connHandle)
+{
+  if (connHandle < FAKESTACK_MAX_CONNS && conns[connHandle].active)
+  {
+    return &conns[connHandle];
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_peerAddr
+ *
+ * @brief   Address of the peer of a connection.
+ */
+static void fakeStack_peerAddr(uint16 connHandle, uint8 *pAddr)
+{
+  static const uint8 peerAddr[B_ADDR_LEN] = { 0x00, 0x00, 0x00,
+                                              0x33, 0x22, 0x11 };
+
+  memcpy(pAddr, peerAddr, B_ADDR_LEN);
+  pAddr[0] = (uint8)connHandle;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_takeBuf
+ *
+ * @brief   Take a controller buffer for a PDU of a connection.
+ *
+ * @param   pConn - connection
+ * @param   len - ATT bytes of the PDU
+ *
+ * @return  TRUE if a buffer was free, else FALSE
+ */
+static uint8 fakeStack_takeBuf(fakeStackConn_t *pConn, uint8 len)
+{
+  if (bufTotal != 0 && bufUsed >= bufTotal)
+  {
+    stats.bufFull++;
+
+    return FALSE;
+  }
+
+  // Buffers are held only while throttled or on the modeled air
+  if (bufTotal != 0 || radioPdus != 0)
+  {
+    bufUsed++;
+    pConn->bufs++;
+    pConn->txBytes += len;
+    pConn->txSeq++;
+  }
+
+  return TRUE;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_rspLen
+ *
+ * @brief   ATT bytes of a response.
+ */
+static uint8 fakeStack_rspLen(uint8 method, const gattMsg_t *pMsg)
+{
+  switch (method)
+  {
+    case ATT_READ_RSP:
+      return ATT_OPCODE_SIZE + pMsg->readRsp.len;
+
+    case ATT_ERROR_RSP:
+      return ATT_OPCODE_SIZE + ATT_ERROR_RSP_SIZE;
+
+    default:
+      return ATT_OPCODE_SIZE;
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_pendingSent
+ *
+ * @brief   Account for the oldest pending ATT response of a connection,
+ *          sent by the application.
+ */
+static void fakeStack_pendingSent(fakeStackConn_t *pConn)
+{
+  uint32_t wait;
+
+  // The answer to the peer's request now waits for the air
+  if (pConn->reqWaiting && pConn->rspPdus == 0)
+  {
+    pConn->rspPdus = pConn->bufs;
+  }
+
+  if (pConn->numPending == 0)
+  {
+    return;
+  }
+
+  wait = Clock_getTicks() - pConn->pendingTicks[0];
+  if (wait > stats.rspWaitMax)
+  {
+    stats.rspWaitMax = wait;
+  }
+  if (wait > FAKESTACK_ATT_TIMEOUT * (1000 / Clock_tickPeriod))
+  {
+    stats.lateRsps++;
+  }
+
+  pConn->numPending--;
+  memmove(&pConn->pendingTicks[0], &pConn->pendingTicks[1],
+          pConn->numPending * sizeof(uint32_t));
+}
+
+/*********************************************************************
+ * @fn      fakeStack_getChan
+ *
+ * @brief   Look up an open L2CAP channel by its local CID.
+ */
+static fakeStackChan_t *fakeStack_getChan(uint16 CID)
+{
+  uint16 i = CID - L2CAP_DYNAMIC_CID_MIN;
+
+  if (i < FAKESTACK_MAX_CHANNELS && chans[i].active)
+  {
+    return &chans[i];
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_findPsm
+ *
+ * @brief   Look up a registered PSM.
+ */
+static fakeStackPsm_t *fakeStack_findPsm(uint16 psm)
+{
+  uint8 i;
+
+  for (i = 0; i < numPsms; i++)
+  {
+    if (psms[i].psm == psm)
+    {
+      return &psms[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_allocSignal
+ *
+ * @brief   Allocate an L2CAP_SIGNAL_EVENT message of a channel.
+ */
+static l2capSignalEvent_t *fakeStack_allocSignal(fakeStackChan_t *pChan,
+                                                 uint8 opcode)
+{
+  l2capSignalEvent_t *pEvt = fakeStack_allocEvt(L2CAP_SIGNAL_EVENT, SUCCESS,
+                                                sizeof(l2capSignalEvent_t));
+
+  if (pEvt != NULL)
+  {
+    pEvt->connHandle = pChan->connHandle;
+    pEvt->opcode = opcode;
+  }
+
+  return pEvt;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_freeSdus
+ *
+ * @brief   Free the SDUs of a queue.
+ */
+static void fakeStack_freeSdus(Queue_Handle queue)
+{
+  while (!Queue_empty(queue))
+  {
+    free(Queue_get(queue));
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocOpen
+ *
+ * @brief   Establish a channel to the modeled peer and report it to the
+ *          task of the PSM.
+ *
+ * @param   connHandle - connection
+ * @param   pPsm - local PSM
+ * @param   mtu - peer MTU
+ * @param   mps - peer MPS
+ * @param   credits - LE-frames the peer lets the stack send
+ */
+static void fakeStack_cocOpen(uint16 connHandle, fakeStackPsm_t *pPsm,
+                              uint16 mtu, uint16 mps, uint16 credits)
+{
+  fakeStackChan_t *pChan;
+  l2capSignalEvent_t *pEvt;
+  uint8 i;
+
+  for (i = 0; i < FAKESTACK_MAX_CHANNELS && chans[i].active; i++);
+
+  if (i == FAKESTACK_MAX_CHANNELS)
+  {
+    return;
+  }
+
+  pChan = &chans[i];
+  memset(pChan, 0, sizeof(fakeStackChan_t));
+  pChan->active = TRUE;
+  pChan->connHandle = connHandle;
+  pChan->pPsm = pPsm;
+  pChan->peerMtu = mtu;
+  pChan->peerMps = mps;
+  pChan->peerInitCredits = credits;
+  pChan->credits = credits;
+  pChan->peerCredits = pPsm->initPeerCredits;
+  pChan->sentQueue = Util_constructQueue(&pChan->sentQ);
+  pChan->echoQueue = Util_constructQueue(&pChan->echoQ);
+
+  pEvt = fakeStack_allocSignal(pChan, L2CAP_CHANNEL_ESTABLISHED_EVT);
+  if (pEvt != NULL)
+  {
+    l2capChannelEstEvt_t *pEst = &pEvt->cmd.channelEstEvt;
+
+    pEst->result = L2CAP_CONN_SUCCESS;
+    pEst->CID = L2CAP_DYNAMIC_CID_MIN + i;
+    pEst->info.psm = pPsm->psm;
+    pEst->info.mtu = pPsm->mtu;
+    pEst->info.mps = FAKESTACK_COC_MPS;
+    pEst->info.credits = pChan->credits;
+    pEst->info.peerCID = pEst->CID;
+    pEst->info.peerMtu = mtu;
+    pEst->info.peerMps = mps;
+    pEst->info.peerCredits = pChan->peerCredits;
+    pEst->info.peerCreditThreshold = pPsm->peerCreditThreshold;
+    fakeStack_send(pPsm->taskId, pEvt);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocClose
+ *
+ * @brief   Terminate a channel. The SDUs the stack holds are freed.
+ */
+static void fakeStack_cocClose(fakeStackChan_t *pChan, uint16 reason)
+{
+  l2capSignalEvent_t *pEvt;
+
+  if (pChan->pTxSdu != NULL)
+  {
+    ICall_free(pChan->pTxSdu);
+    pChan->pTxSdu = NULL;
+  }
+  fakeStack_freeSdus(pChan->sentQueue);
+  fakeStack_freeSdus(pChan->echoQueue);
+  pChan->active = FALSE;
+
+  pEvt = fakeStack_allocSignal(pChan, L2CAP_CHANNEL_TERMINATED_EVT);
+  if (pEvt != NULL)
+  {
+    pEvt->cmd.channelTermEvt.CID = L2CAP_DYNAMIC_CID_MIN + (pChan - chans);
+    pEvt->cmd.channelTermEvt.peerCID = pEvt->cmd.channelTermEvt.CID;
+    pEvt->cmd.channelTermEvt.reason = reason;
+    fakeStack_send(pChan->pPsm->taskId, pEvt);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocSduDone
+ *
+ * @brief   Complete the SDU being sent, whose last PDU got a buffer. It
+ *          goes to the peer with that PDU.
+ */
+static void fakeStack_cocSduDone(fakeStackChan_t *pChan)
+{
+  fakeStackSdu_t *pSdu =
+    (fakeStackSdu_t *)malloc(sizeof(fakeStackSdu_t) + pChan->txLen);
+  l2capSignalEvent_t *pEvt;
+
+  // The peer keeps its own copy; the stack frees the payload
+  if (pSdu != NULL)
+  {
+    pSdu->pData = (uint8 *)(pSdu + 1);
+    pSdu->len = pChan->txLen;
+    pSdu->seq = conns[pChan->connHandle].txSeq;
+    memcpy(pSdu->pData, pChan->pTxSdu, pChan->txLen);
+    Queue_put(pChan->sentQueue, &pSdu->elem);
+  }
+  ICall_free(pChan->pTxSdu);
+
+  stats.cocSdus++;
+  stats.cocBytes += pChan->txLen;
+
+  pEvt = fakeStack_allocSignal(pChan, L2CAP_SEND_SDU_DONE_EVT);
+  if (pEvt != NULL)
+  {
+    l2capSendSduDoneEvt_t *pDone = &pEvt->cmd.sendSduDoneEvt;
+
+    pDone->CID = L2CAP_DYNAMIC_CID_MIN + (pChan - chans);
+    pDone->credits = pChan->credits;
+    pDone->peerCID = pDone->CID;
+    pDone->peerCredits = pChan->peerCredits;
+    pDone->totalLen = pChan->txLen;
+    pDone->txLen = pChan->txLen;
+    fakeStack_send(pChan->pPsm->taskId, pEvt);
+  }
+
+  pChan->pTxSdu = NULL;
+  pChan->txLen = 0;
+  pChan->txSplit = 0;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocPump
+ *
+ * @brief   Split the SDU being sent into LE-frames, as credits allow, and
+ *          the frames into PDUs, as controller buffers allow.
+ */
+static void fakeStack_cocPump(fakeStackChan_t *pChan)
+{
+  fakeStackConn_t *pConn = &conns[pChan->connHandle];
+
+  while (pChan->pTxSdu != NULL)
+  {
+    uint16 pdu;
+
+    if (pChan->frameLeft == 0)
+    {
+      uint16 left = pChan->txLen + FAKESTACK_COC_SDU_HDR - pChan->txSplit;
+
+      if (pChan->frameCount == FAKESTACK_COC_FRAMES)
+      {
+        break;
+      }
+
+      if (pChan->credits == 0)
+      {
+        if (!pChan->stalled)
+        {
+          l2capSignalEvent_t *pEvt =
+            fakeStack_allocSignal(pChan, L2CAP_OUT_OF_CREDIT_EVT);
+
+          pChan->stalled = TRUE;
+          stats.cocStalls++;
+
+          if (pEvt != NULL)
+          {
+            pEvt->cmd.creditEvt.CID = L2CAP_DYNAMIC_CID_MIN + (pChan - chans);
+            pEvt->cmd.creditEvt.peerCID = pEvt->cmd.creditEvt.CID;
+            pEvt->cmd.creditEvt.credits = (left + pChan->peerMps - 1) /
+                                          pChan->peerMps;
+            fakeStack_send(pChan->pPsm->taskId, pEvt);
+          }
+        }
+        break;
+      }
+
+      pChan->credits--;
+      pChan->frameLeft = MIN(pChan->peerMps, left) + L2CAP_HDR_SIZE;
+      pChan->txSplit += pChan->frameLeft - L2CAP_HDR_SIZE;
+      pChan->frameCount++;
+    }
+
+    // Without throttling, L2CAP still only has the PDU buffers of the
+    // stack
+    if (bufTotal == 0 && pConn->bufs >= FAKESTACK_COC_PDUS)
+    {
+      break;
+    }
+
+    // FAKESTACK_RADIO_PDU_BYTES counts an L2CAP header, which is frame
+    // data in all but the first PDU of a frame
+    pdu = MIN(pChan->frameLeft, radioOctets);
+    if (!fakeStack_takeBuf(pConn, (pdu > L2CAP_HDR_SIZE) ?
+                                  pdu - L2CAP_HDR_SIZE : 0))
+    {
+      break;
+    }
+
+    pChan->frameLeft -= pdu;
+    pChan->frameSeq[(pChan->frameHead + pChan->frameCount - 1) %
+                    FAKESTACK_COC_FRAMES] = pConn->txSeq;
+
+    if (pChan->frameLeft == 0 &&
+        pChan->txSplit == pChan->txLen + FAKESTACK_COC_SDU_HDR)
+    {
+      fakeStack_cocSduDone(pChan);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocPeerPdu
+ *
+ * @brief   Next PDU of the modeled peer on a connection: a Flow Control
+ *          Credit packet, else the next part of an SDU it sends back, as
+ *          its credits allow.
+ *
+ * @param   connHandle - connection
+ * @param   send - TRUE to send the PDU, FALSE to only get its length
+ *
+ * @return  LL payload of the PDU, 0 if the peer has nothing to send
+ */
+static uint16 fakeStack_cocPeerPdu(uint16 connHandle, uint8 send)
+{
+  uint8 i;
+
+  for (i = 0; i < FAKESTACK_MAX_CHANNELS; i++)
+  {
+    fakeStackChan_t *pChan = &chans[i];
+    fakeStackSdu_t *pSdu;
+    uint16 frame = 0;
+    uint16 pdu;
+
+    if (!pChan->active || pChan->connHandle != connHandle)
+    {
+      continue;
+    }
+
+    if (pChan->peerGrant != 0)
+    {
+      if (send)
+      {
+        pChan->credits += pChan->peerGrant;
+        pChan->peerGrant = 0;
+        pChan->stalled = FALSE;
+        stats.cocCreditsIn++;
+      }
+
+      return L2CAP_HDR_SIZE + FAKESTACK_COC_CREDIT_LEN;
+    }
+
+    if (Queue_empty(pChan->echoQueue))
+    {
+      continue;
+    }
+
+    pSdu = (fakeStackSdu_t *)Queue_head(pChan->echoQueue);
+    if (pChan->echoFrameLeft == 0)
+    {
+      if (pChan->peerCredits == 0)
+      {
+        if (!pChan->peerStalled)
+        {
+          pChan->peerStalled = TRUE;
+          stats.cocPeerStalls++;
+        }
+        continue;
+      }
+
+      frame = MIN(FAKESTACK_COC_MPS,
+                  pSdu->len + FAKESTACK_COC_SDU_HDR - pChan->echoSplit);
+      pdu = MIN(frame + L2CAP_HDR_SIZE, radioOctets);
+    }
+    else
+    {
+      pdu = MIN(pChan->echoFrameLeft, radioOctets);
+    }
+
+    if (!send)
+    {
+      return pdu;
+    }
+
+    if (frame != 0)
+    {
+      pChan->peerCredits--;
+      pChan->peerStalled = FALSE;
+      pChan->echoSplit += frame;
+      pChan->echoFrameLeft = frame + L2CAP_HDR_SIZE;
+
+      if (pChan->peerCredits <= pChan->pPsm->peerCreditThreshold &&
+          !pChan->belowThreshold)
+      {
+        l2capSignalEvent_t *pEvt =
+          fakeStack_allocSignal(pChan, L2CAP_PEER_CREDIT_THRESHOLD_EVT);
+
+        pChan->belowThreshold = TRUE;
+        if (pEvt != NULL)
+        {
+          pEvt->cmd.creditEvt.CID = L2CAP_DYNAMIC_CID_MIN + i;
+          pEvt->cmd.creditEvt.peerCID = pEvt->cmd.creditEvt.CID;
+          pEvt->cmd.creditEvt.credits = pChan->pPsm->peerCreditThreshold;
+          fakeStack_send(pChan->pPsm->taskId, pEvt);
+        }
+      }
+    }
+
+    pChan->echoFrameLeft -= pdu;
+
+    if (pChan->echoFrameLeft == 0 &&
+        pChan->echoSplit == pSdu->len + FAKESTACK_COC_SDU_HDR)
+    {
+      uint8 *pPayload = fakeStack_bmAlloc(BM_MSG_L2CAP, pSdu->len, connHandle,
+                                          0, NULL);
+      l2capDataEvent_t *pData = NULL;
+
+      // The whole SDU arrived; the application frees the payload. Without
+      // the memory for it the stack drops the SDU
+      if (pPayload != NULL)
+      {
+        pData = fakeStack_allocEvt(L2CAP_DATA_EVENT, SUCCESS,
+                                   sizeof(l2capDataEvent_t));
+      }
+      Queue_get(pChan->echoQueue);
+      pChan->echoSplit = 0;
+      stats.cocRxSdus++;
+      stats.cocRxBytes += pSdu->len;
+
+      if (pData != NULL)
+      {
+        pData->connHandle = connHandle;
+        pData->pkt.CID = L2CAP_DYNAMIC_CID_MIN + i;
+        pData->pkt.pPayload = pPayload;
+        pData->pkt.len = pSdu->len;
+        memcpy(pPayload, pSdu->pData, pSdu->len);
+        fakeStack_send(pChan->pPsm->taskId, pData);
+      }
+      else if (pPayload != NULL)
+      {
+        ICall_free(pPayload);
+      }
+      free(pSdu);
+    }
+
+    return pdu;
+  }
+
+  return 0;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocSent
+ *
+ * @brief   Account for the PDUs of a connection sent in a connection
+ *          event: the peer receives the LE-frames and SDUs they complete
+ *          and the credits returned to it.
+ */
+static void fakeStack_cocSent(uint16 connHandle)
+{
+  fakeStackConn_t *pConn = &conns[connHandle];
+  uint8 i;
+
+  for (i = 0; i < FAKESTACK_MAX_CHANNELS; i++)
+  {
+    fakeStackChan_t *pChan = &chans[i];
+    uint8 frames;
+
+    if (!pChan->active || pChan->connHandle != connHandle)
+    {
+      continue;
+    }
+
+    // The last frame is not complete while part of it has no buffer
+    frames = pChan->frameCount - ((pChan->frameLeft != 0) ? 1 : 0);
+    while (frames != 0 &&
+           (Int32)(pConn->sentSeq - pChan->frameSeq[pChan->frameHead]) >= 0)
+    {
+      pChan->frameHead = (pChan->frameHead + 1) % FAKESTACK_COC_FRAMES;
+      pChan->frameCount--;
+      pChan->peerRxFrames++;
+      frames--;
+    }
+
+    if (pChan->peerRxFrames != 0 &&
+        pChan->peerRxFrames >= MAX(1, pChan->peerInitCredits / 2))
+    {
+      pChan->peerGrant += pChan->peerRxFrames;
+      pChan->peerRxFrames = 0;
+    }
+
+    while (!Queue_empty(pChan->sentQueue) &&
+           (Int32)(pConn->sentSeq -
+                   ((fakeStackSdu_t *)Queue_head(pChan->sentQueue))->seq) >= 0)
+    {
+      Queue_put(pChan->echoQueue, Queue_get(pChan->sentQueue));
+    }
+
+    if (pChan->grant != 0 && (Int32)(pConn->sentSeq - pChan->grantSeq) >= 0)
+    {
+      pChan->peerCredits += pChan->grant;
+      pChan->grant = 0;
+      if (pChan->peerCredits > pChan->pPsm->peerCreditThreshold)
+      {
+        pChan->belowThreshold = FALSE;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_cocStreaming
+ *
+ * @brief   Check whether a channel of a connection has data to carry.
+ */
+static uint8 fakeStack_cocStreaming(uint16 connHandle)
+{
+  uint8 i;
+
+  for (i = 0; i < FAKESTACK_MAX_CHANNELS; i++)
+  {
+    fakeStackChan_t *pChan = &chans[i];
+
+    if (pChan->active && pChan->connHandle == connHandle &&
+        (pChan->pTxSdu != NULL || pChan->frameCount != 0 ||
+         !Queue_empty(pChan->sentQueue) || !Queue_empty(pChan->echoQueue)))
+    {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_sendTerminated
+ *
+ * @brief   Drop a connection and report it.
+ */
+static void fakeStack_sendTerminated(uint16 connHandle, uint8 reason)
+{
+  gapTerminateLinkEvent_t *pEvt;
+  uint8 i;
+
+  conns[connHandle].active = FALSE;
+
+  for (i = 0; i < FAKESTACK_MAX_CHANNELS; i++)
+  {
+    if (chans[i].active && chans[i].connHandle == connHandle)
+    {
+      fakeStack_cocClose(&chans[i], L2CAP_TERM_LINK_DOWN);
+    }
+  }
+
+  // The controller drops what the link had not sent
+  bufUsed -= conns[connHandle].bufs;
+  conns[connHandle].bufs = 0;
+  conns[connHandle].txBytes = 0;
+  conns[connHandle].sentSeq = conns[connHandle].txSeq;
+  stats.lostRsps += conns[connHandle].numPending;
+  conns[connHandle].numPending = 0;
+
+  pEvt = fakeStack_allocEvt(GAP_MSG_EVENT, SUCCESS,
+                            sizeof(gapTerminateLinkEvent_t));
+  if (pEvt != NULL)
+  {
+    pEvt->opcode = GAP_LINK_TERMINATED_EVENT;
+    pEvt->connectionHandle = connHandle;
+    pEvt->reason = reason;
+    fakeStack_send(gapRoleTask, pEvt);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_sendParamUpdate
+ *
+ * @brief   Apply new connection parameters and report them.
+ */
+static void fakeStack_sendParamUpdate(uint16 connHandle, uint16 interval,
+                                      uint16 latency, uint16 timeout)
+{
+  gapLinkUpdateEvent_t *pEvt;
+
+  conns[connHandle].interval = interval;
+  conns[connHandle].latency = latency;
+  conns[connHandle].timeout = timeout;
+
+  pEvt = fakeStack_allocEvt(GAP_MSG_EVENT, SUCCESS,
+                            sizeof(gapLinkUpdateEvent_t));
+  if (pEvt != NULL)
+  {
+    pEvt->opcode = GAP_LINK_PARAM_UPDATE_EVENT;
+    pEvt->status = SUCCESS;
+    pEvt->connectionHandle = connHandle;
+    pEvt->connInterval = interval;
+    pEvt->connLatency = latency;
+    pEvt->connTimeout = timeout;
+    fakeStack_send(gapRoleTask, pEvt);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_ah
+ *
+ * @brief   Random address hash function ah() of the Bluetooth
+ *          specification, Vol 3 Part H 2.2.2.
+ *
+ * @param   pIrk - IRK, least significant octet first
+ * @param   pPrand - prand of the address, least significant octet first
+ *
+ * @return  hash, 24 bits
+ */
+static uint32 fakeStack_ah(const uint8 *pIrk, const uint8 *pPrand)
+{
+  uint8 key[KEY_BLENGTH];
+  uint8 block[STATE_BLENGTH];
+  uint8 i;
+
+  // AES takes the most significant octet first
+  for (i = 0; i < KEY_BLENGTH; i++)
+  {
+    key[i] = pIrk[KEY_BLENGTH - 1 - i];
+  }
+
+  // r' is prand padded with zeros
+  memset(block, 0, sizeof(block));
+  block[13] = pPrand[2];
+  block[14] = pPrand[1];
+  block[15] = pPrand[0];
+
+  sspAesEncrypt_Sw(key, block);
+  stats.ahCalls++;
+
+  return BUILD_UINT32(block[15], block[14], block[13], 0);
+}
+
+/*********************************************************************
+ * @fn      fakeStack_resolveAddr
+ *
+ * @brief   Find the bond of a peer address, as GAPBondMgr_ResolveAddr()
+ *          does in the Bond Manager.
+ *
+ * @param   addrType - address type
+ * @param   pDevAddr - peer address
+ * @param   pResolvedAddr - buffer for the identity address, may be NULL
+ *
+ * @return  bond index, GAP_BONDINGS_MAX if no bond matches
+ */
+static uint8 fakeStack_resolveAddr(uint8 addrType, const uint8 *pDevAddr,
+                                   uint8 *pResolvedAddr)
+{
+  uint8 isRpa = ((addrType == ADDRTYPE_RANDOM) &&
+                 ((pDevAddr[B_ADDR_LEN-1] & RANDOM_ADDR_HDR_MASK) ==
+                  PRIVATE_RESOLVE_ADDR_HDR));
+  uint32 hash = BUILD_UINT32(pDevAddr[0], pDevAddr[1], pDevAddr[2], 0);
+  uint8 i;
+
+  stats.resolves++;
+
+  for (i = 0; i < GAP_BONDINGS_MAX; i++)
+  {
+    if (!bonds[i].used)
+    {
+      continue;
+    }
+
+    if (isRpa ? (fakeStack_ah(bonds[i].irk, &pDevAddr[3]) == hash) :
+                (memcmp(bonds[i].idAddr, pDevAddr, B_ADDR_LEN) == 0))
+    {
+      if (pResolvedAddr != NULL)
+      {
+        memcpy(pResolvedAddr, bonds[i].idAddr, B_ADDR_LEN);
+      }
+
+      return i;
+    }
+  }
+
+  return GAP_BONDINGS_MAX;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processGapCmd
+ *
+ * @brief   Process a command of the GAP subgroup.
+ */
+static void fakeStack_processGapCmd(ICall_EntityID src, ICall_HciExtCmd *pCmd,
+                                    uint8 cmdId)
+{
+  // GAP procedures need the profile role set by GAP_DeviceInit()
+  if (gapRoleTask == ICALL_INVALID_ENTITY_ID &&
+      (cmdId == HCI_EXT_GAP_UPDATE_ADV_DATA ||
+       cmdId == HCI_EXT_GAP_MAKE_DISCOVERABLE ||
+       cmdId == HCI_EXT_GAP_END_DISC))
+  {
+    fakeStack_sendCmdStatus(src, pCmd, bleIncorrectMode, 0, NULL);
+
+    return;
+  }
+
+  switch (cmdId)
+  {
+    case HCI_EXT_GAP_DEVICE_INIT:
+      {
+        gapDeviceInitDoneEvent_t *pEvt;
+
+        gapRoleTask = ((ICall_GapDeviceInit *)pCmd)->taskID;
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+
+        pEvt = fakeStack_allocEvt(GAP_MSG_EVENT, SUCCESS,
+                                  sizeof(gapDeviceInitDoneEvent_t));
+        if (pEvt != NULL)
+        {
+          pEvt->opcode = GAP_DEVICE_INIT_DONE_EVENT;
+          memcpy(pEvt->devAddr, ownAddr, B_ADDR_LEN);
+          pEvt->dataPktLen = 27;
+          pEvt->numDataPkts = 5;
+          fakeStack_send(gapRoleTask, pEvt);
+        }
+      }
+      break;
+
+    case HCI_EXT_GAP_UPDATE_ADV_DATA:
+      {
+        ICall_GapUpdateAdvParams *pParams = (ICall_GapUpdateAdvParams *)pCmd;
+        gapAdvDataUpdateEvent_t *pEvt;
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+
+        pEvt = fakeStack_allocEvt(GAP_MSG_EVENT, SUCCESS,
+                                  sizeof(gapAdvDataUpdateEvent_t));
+        if (pEvt != NULL)
+        {
+          pEvt->opcode = GAP_ADV_DATA_UPDATE_DONE_EVENT;
+          pEvt->adType = pParams->adType;
+          fakeStack_send(pParams->taskID, pEvt);
+        }
+      }
+      break;
+
+    case HCI_EXT_GAP_MAKE_DISCOVERABLE:
+      if (!advStarted)
+      {
+        advStarted = TRUE;
+        advStart = Clock_getTicks();
+      }
+
+      fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      fakeStack_sendGapEvt(((ICall_GapParamAndPtr *)pCmd)->taskID,
+                           GAP_MAKE_DISCOVERABLE_DONE_EVENT);
+      break;
+
+    case HCI_EXT_GAP_END_DISC:
+      fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      fakeStack_sendGapEvt(((ICall_GapParamAndPtr *)pCmd)->taskID,
+                           GAP_END_DISCOVERABLE_DONE_EVENT);
+      break;
+
+    case HCI_EXT_GAP_TERMINATE_LINK:
+      {
+        ICall_GapTerminateLink *pTerm = (ICall_GapTerminateLink *)pCmd;
+
+        if (fakeStack_getConn(pTerm->connHandle) == NULL)
+        {
+          fakeStack_sendCmdStatus(src, pCmd, bleNotConnected, 0, NULL);
+          break;
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+        fakeStack_sendTerminated(pTerm->connHandle,
+                                 HCI_ERROR_CODE_CONN_TERM_BY_LOCAL_HOST);
+      }
+      break;
+
+    case HCI_EXT_GAP_UPDATE_LINK_PARAM_REQ:
+      {
+        gapUpdateLinkParamReq_t *pReq =
+          (gapUpdateLinkParamReq_t *)((ICall_GapPtrParams *)pCmd)->pParam1;
+
+        if (fakeStack_getConn(pReq->connectionHandle) == NULL)
+        {
+          fakeStack_sendCmdStatus(src, pCmd, bleNotConnected, 0, NULL);
+          break;
+        }
+
+        // The master accepts the slowest interval asked for
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+        fakeStack_sendParamUpdate(pReq->connectionHandle, pReq->intervalMax,
+                                  pReq->connLatency, pReq->connTimeout);
+      }
+      break;
+
+    case HCI_EXT_GAP_SET_PARAM:
+      {
+        ICall_GapSetParam *pSet = (ICall_GapSetParam *)pCmd;
+
+        if (pSet->paramID >= TGAP_PARAMID_MAX)
+        {
+          fakeStack_sendCmdStatus(src, pCmd, INVALIDPARAMETER, 0, NULL);
+          break;
+        }
+
+        gapParams[pSet->paramID] = pSet->paramValue;
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      }
+      break;
+
+    case HCI_EXT_GAP_GET_PARAM:
+      {
+        uint16 paramID = ((ICall_GapGetParam *)pCmd)->paramID;
+        uint16 value = 0;
+
+        if (paramID < TGAP_PARAMID_MAX)
+        {
+          value = gapParams[paramID];
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, sizeof(value), &value);
+      }
+      break;
+
+    case HCI_EXT_GAP_BOND_SET_PARAM:
+      {
+        ICall_ProfileSetParam *pSet = (ICall_ProfileSetParam *)pCmd;
+        uint8 *pValue = pSet->paramIdLenVal.pValue;
+        uint8 i;
+
+        for (i = 0; i < GAP_BONDINGS_MAX; i++)
+        {
+          // Address type followed by the identity address
+          if ((pSet->paramIdLenVal.paramId == GAPBOND_ERASE_ALLBONDS) ||
+              ((pSet->paramIdLenVal.paramId == GAPBOND_ERASE_SINGLEBOND) &&
+               (pSet->paramIdLenVal.len == (1 + B_ADDR_LEN)) &&
+               (memcmp(bonds[i].idAddr, &pValue[1], B_ADDR_LEN) == 0)))
+          {
+            bonds[i].used = FALSE;
+          }
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      }
+      break;
+
+    default:
+      fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      break;
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processGattCmd
+ *
+ * @brief   Process a command of the GATT subgroup. Notifications and
+ *          indications are sent at once and their payload freed.
+ */
+static void fakeStack_processGattCmd(ICall_EntityID src, ICall_HciExtCmd *pCmd,
+                                     uint8 cmdId)
+{
+  ICall_GattInd *pInd = (ICall_GattInd *)pCmd;
+
+  if (cmdId != ATT_HANDLE_VALUE_NOTI && cmdId != ATT_HANDLE_VALUE_IND)
+  {
+    fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+
+    return;
+  }
+
+  if (fakeStack_getConn(pInd->connHandle) == NULL)
+  {
+    // The caller keeps the payload
+    fakeStack_sendCmdStatus(src, pCmd, bleNotConnected, 0, NULL);
+
+    return;
+  }
+
+  if (!fakeStack_takeBuf(fakeStack_getConn(pInd->connHandle),
+                         ATT_HANDLE_VALUE_IND_HDR_SIZE +
+                         pInd->pIndNoti->handleValueNoti.len))
+  {
+    // The caller keeps the payload
+    fakeStack_sendCmdStatus(src, pCmd, MSG_BUFFER_NOT_AVAIL, 0, NULL);
+
+    return;
+  }
+
+  stats.notifications++;
+  fakeStack_bmFree(BM_MSG_GATT, pInd->pIndNoti, cmdId);
+  fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+
+  if (cmdId == ATT_HANDLE_VALUE_IND)
+  {
+    gattMsgEvent_t *pEvt = fakeStack_allocEvt(GATT_MSG_EVENT, SUCCESS,
+                                              sizeof(gattMsgEvent_t));
+
+    if (pEvt != NULL)
+    {
+      pEvt->connHandle = pInd->connHandle;
+      pEvt->method = ATT_HANDLE_VALUE_CFM;
+      fakeStack_send(pInd->taskId, pEvt);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processL2capCmd
+ *
+ * @brief   Process a command of the L2CAP subgroup. Channels lead to the
+ *          modeled peer.
+ */
+static void fakeStack_processL2capCmd(ICall_EntityID src, ICall_HciExtCmd *pCmd,
+                                      uint8 cmdId)
+{
+  fakeStackChan_t *pChan;
+  uint8 status = SUCCESS;
+
+  switch (cmdId)
+  {
+    case HCI_EXT_L2CAP_REGISTER_PSM:
+      {
+        l2capPsm_t *pPsm = ((ICall_L2capRegisterPsm *)pCmd)->pPsm;
+
+        if (fakeStack_findPsm(pPsm->psm) != NULL)
+        {
+          status = bleAlreadyInRequestedMode;
+        }
+        else if (numPsms == FAKESTACK_MAX_PSMS)
+        {
+          status = bleNoResources;
+        }
+        else
+        {
+          psms[numPsms].psm = pPsm->psm;
+          psms[numPsms].mtu = pPsm->mtu;
+          psms[numPsms].initPeerCredits = pPsm->initPeerCredits;
+          psms[numPsms].peerCreditThreshold = pPsm->peerCreditThreshold;
+          psms[numPsms].taskId = pPsm->taskId;
+          numPsms++;
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, status, 0, NULL);
+      }
+      break;
+
+    case L2CAP_CONNECT_REQ:
+      {
+        ICall_L2capConnectReq *pReq = (ICall_L2capConnectReq *)pCmd;
+        fakeStackPsm_t *pPsm = fakeStack_findPsm(pReq->psm);
+
+        if (fakeStack_getConn(pReq->connHandle) == NULL)
+        {
+          status = bleNotConnected;
+        }
+        else if (pPsm == NULL)
+        {
+          status = INVALIDPARAMETER;
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, status, 0, NULL);
+
+        // The peer accepts right away
+        if (status == SUCCESS)
+        {
+          fakeStack_cocOpen(pReq->connHandle, pPsm, FAKESTACK_COC_PEER_MTU,
+                            FAKESTACK_COC_PEER_MPS,
+                            FAKESTACK_COC_PEER_CREDITS);
+        }
+      }
+      break;
+
+    case L2CAP_DISCONNECT_REQ:
+      pChan = fakeStack_getChan(((ICall_L2capDisconnectReq *)pCmd)->CID);
+
+      fakeStack_sendCmdStatus(src, pCmd, (pChan != NULL) ? SUCCESS :
+                              INVALIDPARAMETER, 0, NULL);
+
+      if (pChan != NULL)
+      {
+        fakeStack_cocClose(pChan, L2CAP_TERM_BY_PSM);
+      }
+      break;
+
+    case HCI_EXT_L2CAP_DATA:
+      {
+        l2capPacket_t *pPkt = ((ICall_L2capSendSDU *)pCmd)->pPkt;
+
+        pChan = fakeStack_getChan(pPkt->CID);
+        if (pChan == NULL)
+        {
+          status = bleNotConnected;
+        }
+        else if (pPkt->pPayload == NULL)
+        {
+          status = INVALIDPARAMETER;
+        }
+        else if (pChan->pTxSdu != NULL)
+        {
+          // One SDU at a time
+          status = blePending;
+        }
+        else if (pPkt->len > pChan->peerMtu)
+        {
+          status = bleInvalidMtuSize;
+        }
+        else
+        {
+          // The stack owns the payload from now on
+          pChan->pTxSdu = pPkt->pPayload;
+          pChan->txLen = pPkt->len;
+          pChan->txSplit = 0;
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, status, 0, NULL);
+
+        if (status == SUCCESS)
+        {
+          fakeStack_cocPump(pChan);
+        }
+      }
+      break;
+
+    case L2CAP_FLOW_CTRL_CREDIT:
+      {
+        ICall_L2capFlowCtrlCredit *pCredit = (ICall_L2capFlowCtrlCredit *)pCmd;
+
+        pChan = fakeStack_getChan(pCredit->CID);
+        if (pChan == NULL)
+        {
+          status = INVALIDPARAMETER;
+        }
+        else if (!fakeStack_takeBuf(&conns[pChan->connHandle],
+                                    FAKESTACK_COC_CREDIT_LEN))
+        {
+          status = MSG_BUFFER_NOT_AVAIL;
+        }
+        else
+        {
+          // The peer gets the credits with the packet
+          pChan->grant += pCredit->peerCredits;
+          pChan->grantSeq = conns[pChan->connHandle].txSeq;
+          stats.cocCredits++;
+        }
+
+        fakeStack_sendCmdStatus(src, pCmd, status, 0, NULL);
+      }
+      break;
+
+    default:
+      fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      break;
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processUtilCmd
+ *
+ * @brief   Process a command of the Util subgroup. NV items are kept in
+ *          memory.
+ */
+static void fakeStack_processUtilCmd(ICall_EntityID src, ICall_HciExtCmd *pCmd,
+                                     uint8 cmdId)
+{
+  ICall_UtilNvRead *pNv = (ICall_UtilNvRead *)pCmd;
+  fakeStackNvItem_t *pItem = NULL;
+  uint8 status = SUCCESS;
+  uint8 i;
+
+  if (cmdId != HCI_EXT_UTIL_NV_READ && cmdId != HCI_EXT_UTIL_NV_WRITE)
+  {
+    fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+
+    return;
+  }
+
+  for (i = 0; i < FAKESTACK_NV_ITEMS; i++)
+  {
+    if (nvItems[i].pData != NULL && nvItems[i].id == pNv->id)
+    {
+      pItem = &nvItems[i];
+      break;
+    }
+  }
+
+  if (cmdId == HCI_EXT_UTIL_NV_READ)
+  {
+    if (pItem != NULL && pItem->len >= pNv->len)
+    {
+      memcpy(pNv->pBuf, pItem->pData, pNv->len);
+    }
+    else
+    {
+      status = NV_OPER_FAILED;
+    }
+  }
+  else
+  {
+    for (i = 0; pItem == NULL && i < FAKESTACK_NV_ITEMS; i++)
+    {
+      if (nvItems[i].pData == NULL)
+      {
+        pItem = &nvItems[i];
+      }
+    }
+
+    if (pItem != NULL && pItem->len != pNv->len)
+    {
+      free(pItem->pData);
+      pItem->pData = malloc(pNv->len);
+    }
+
+    if (pItem == NULL || pItem->pData == NULL)
+    {
+      status = NV_OPER_FAILED;
+    }
+    else
+    {
+      pItem->id = pNv->id;
+      pItem->len = pNv->len;
+      memcpy(pItem->pData, pNv->pBuf, pNv->len);
+    }
+  }
+
+  fakeStack_sendCmdStatus(src, pCmd, status, 0, NULL);
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processDispatchCmd
+ *
+ * @brief   Process a DISPATCH_CMD_EVENT command. Registrations are not
+ *          answered, as the caller does not wait for them.
+ */
+static void fakeStack_processDispatchCmd(ICall_EntityID src,
+                                         ICall_HciExtCmd *pCmd)
+{
+  uint8 subgrp = (uint8)pCmd->opCode;
+
+  switch ((subgrp << 8) | pCmd->cmdId)
+  {
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_REG_FOR_MSG:
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_PROFILE_REG_CB:
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_BOND_LINK_TERM:
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_BOND_SLAVE_REQ_SEC:
+    case (DISPATCH_GATT_PROFILE << 8) | DISPATCH_GATT_REG_4_IND:
+    case (DISPATCH_GATT_PROFILE << 8) | DISPATCH_GATT_HTA_FLOW_CTRL:
+    case (DISPATCH_GATT_PROFILE << 8) | DISPATCH_GATT_APP_COMPL_MSG:
+    case (DISPATCH_GAP_GATT_SERV << 8) | DISPATCH_PROFILE_REG_CB:
+    case (DISPATCH_GENERAL << 8) | DISPATCH_GENERAL_REG_NPI:
+      break;
+
+    case (DISPATCH_GENERAL << 8) | DISPATCH_GENERAL_REG_L2CAP_FC:
+      l2capFcTask = ((ICall_RegisterTaskMsg *)pCmd)->taskID;
+      break;
+
+    case (DISPATCH_GATT_PROFILE << 8) | DISPATCH_GATT_REG_FOR_MSG:
+      gattTask = ((ICall_RegisterTaskMsg *)pCmd)->taskID;
+      break;
+
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_LINKDB_STATE:
+      {
+        ICall_LinkDBState *pState = (ICall_LinkDBState *)pCmd;
+        uint8 state = (fakeStack_getConn(pState->connHandle) != NULL) ?
+                      LINK_CONNECTED : LINK_NOT_CONNECTED;
+
+        state = ((state & pState->state) == pState->state);
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, sizeof(state), &state);
+      }
+      break;
+
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_LINKDB_NUM_CONNS:
+      {
+        uint8 num = FAKESTACK_MAX_CONNS;
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, sizeof(num), &num);
+      }
+      break;
+
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_LINKDB_NUM_ACTIVE:
+      {
+        uint8 num = fakeStack_numActive();
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, sizeof(num), &num);
+      }
+      break;
+
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_LINKDB_GET_INFO:
+      {
+        ICall_LinkDBGetInfo *pGet = (ICall_LinkDBGetInfo *)pCmd;
+        fakeStackConn_t *pConn = fakeStack_getConn(pGet->connHandle);
+
+        if (pConn == NULL)
+        {
+          fakeStack_sendCmdStatus(src, pCmd, bleNotConnected, 0, NULL);
+          break;
+        }
+
+        memset(pGet->pInfo, 0, sizeof(linkDBInfo_t));
+        pGet->pInfo->stateFlags = LINK_CONNECTED;
+        pGet->pInfo->addrType = ADDRTYPE_PUBLIC;
+        fakeStack_peerAddr(pGet->connHandle, pGet->pInfo->addr);
+        pGet->pInfo->connRole = GAP_PROFILE_PERIPHERAL;
+        pGet->pInfo->connInterval = pConn->interval;
+        pGet->pInfo->MTU = pConn->mtu;
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      }
+      break;
+
+    case (DISPATCH_GAP_PROFILE << 8) | DISPATCH_GAP_BOND_RESOLVE_ADDR:
+      {
+        ICall_BondMgrResolveAddr *pResolve = (ICall_BondMgrResolveAddr *)pCmd;
+        uint8 bondIdx = fakeStack_resolveAddr(pResolve->addrType,
+                                              pResolve->pDevAddr,
+                                              pResolve->pResolvedAddr);
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, sizeof(bondIdx),
+                                &bondIdx);
+      }
+      break;
+
+    case (DISPATCH_GATT_PROFILE << 8) | DISPATCH_GATT_SEND_RSP:
+      {
+        ICall_GattSendRsp *pRsp = (ICall_GattSendRsp *)pCmd;
+
+        if (fakeStack_getConn(pRsp->connHandle) == NULL)
+        {
+          fakeStack_sendCmdStatus(src, pCmd, bleNotConnected, 0, NULL);
+          break;
+        }
+
+        if (!fakeStack_takeBuf(fakeStack_getConn(pRsp->connHandle),
+                               fakeStack_rspLen(pRsp->method, pRsp->pRsp)))
+        {
+          // The caller keeps the response to retry
+          fakeStack_sendCmdStatus(src, pCmd, blePending, 0, NULL);
+          break;
+        }
+
+        stats.rsps++;
+        fakeStack_pendingSent(fakeStack_getConn(pRsp->connHandle));
+        fakeStack_bmFree(BM_MSG_GATT, pRsp->pRsp, pRsp->method);
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      }
+      break;
+
+    case (DISPATCH_GATT_SERV_APP << 8) | DISPATCH_PROFILE_REG_SERVICE:
+      {
+        ICall_GSA_RegService *pReg = (ICall_GSA_RegService *)pCmd;
+        uint16 i;
+
+        if (numServices == FAKESTACK_MAX_SERVICES)
+        {
+          fakeStack_sendCmdStatus(src, pCmd, bleNoResources, 0, NULL);
+          break;
+        }
+
+        for (i = 0; i < pReg->numAttrs; i++)
+        {
+          pReg->pAttrs[i].handle = nextHandle++;
+        }
+
+        services[numServices].pAttrs = pReg->pAttrs;
+        services[numServices].numAttrs = pReg->numAttrs;
+        services[numServices].pCBs = pReg->pServiceCBs;
+        numServices++;
+
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      }
+      break;
+
+    default:
+      fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+      break;
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processCmd
+ *
+ * @brief   Process a command sent through icall_api.c.
+ */
+static void fakeStack_processCmd(ICall_EntityID src, ICall_HciExtCmd *pCmd)
+{
+  stats.cmds++;
+
+  if (pCmd->hdr.event == DISPATCH_CMD_EVENT)
+  {
+    fakeStack_processDispatchCmd(src, pCmd);
+  }
+  else if (pCmd->hdr.event != ICALL_CMD_EVENT)
+  {
+    // Not a command
+  }
+  else if (pCmd->pktType == HCI_CMD_PACKET)
+  {
+    if (pCmd->opCode == HCI_EXT_CONN_EVENT_NOTICE)
+    {
+      ICall_Hci_Params *pParams = (ICall_Hci_Params *)pCmd;
+
+      if (pParams->param1 < FAKESTACK_MAX_CONNS)
+      {
+        noticeTask[pParams->param1] = (ICall_EntityID)pParams->param2;
+        noticeEvent[pParams->param1] = pParams->param3;
+      }
+    }
+
+    fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+  }
+  else
+  {
+    uint8 subgrp = (pCmd->opCode >> 7) & 0x07;
+    uint8 cmdId = pCmd->opCode & 0x7F;
+
+    switch (subgrp)
+    {
+      case HCI_EXT_GAP_SUBGRP:
+        fakeStack_processGapCmd(src, pCmd, cmdId);
+        break;
+
+      case HCI_EXT_GATT_SUBGRP:
+        fakeStack_processGattCmd(src, pCmd, cmdId);
+        break;
+
+      case HCI_EXT_L2CAP_SUBGRP:
+        fakeStack_processL2capCmd(src, pCmd, cmdId);
+        break;
+
+      case HCI_EXT_UTIL_SUBGRP:
+        fakeStack_processUtilCmd(src, pCmd, cmdId);
+        break;
+
+      default:
+        fakeStack_sendCmdStatus(src, pCmd, SUCCESS, 0, NULL);
+        break;
+    }
+  }
+
+  ICall_freeMsg(pCmd);
+}
+
+/*********************************************************************
+ * @fn      fakeStack_attrAccess
+ *
+ * @brief   Read or write an attribute as the GATT server would for a
+ *          peer request.
+ *
+ * @param   pEvt - FAKESTACK_EVT_READ or FAKESTACK_EVT_WRITE event
+ * @param   pValue - value read, of FAKESTACK_MAX_MTU bytes
+ * @param   pLen - length of the value read
+ *
+ * @return  SUCCESS or an ATT error code
+ */
+static uint8 fakeStack_attrAccess(fakeStackEvt_t *pEvt, uint8 *pValue,
+                                  uint16 *pLen)
+{
+  fakeStackConn_t *pConn = fakeStack_getConn(pEvt->connHandle);
+  gattAttribute_t *pAttr = FakeStack_getAttr(pEvt->handle);
+  const gattServiceCBs_t *pCBs = NULL;
+  uint8 i;
+
+  if (pConn == NULL)
+  {
+    return bleNotConnected;
+  }
+
+  if (pAttr == NULL)
+  {
+    return ATT_ERR_INVALID_HANDLE;
+  }
+
+  for (i = 0; i < numServices; i++)
+  {
+    if (pAttr >= services[i].pAttrs &&
+        pAttr < services[i].pAttrs + services[i].numAttrs)
+    {
+      pCBs = services[i].pCBs;
+    }
+  }
+
+  if (pEvt->type == FAKESTACK_EVT_WRITE)
+  {
+    if (!(pAttr->permissions & GATT_PERMIT_WRITE))
+    {
+      return ATT_ERR_WRITE_NOT_PERMITTED;
+    }
+
+    return pCBs->pfnWriteAttrCB(pEvt->connHandle, pAttr, pEvt->value,
+                                pEvt->len, 0, ATT_WRITE_REQ);
+  }
+  else
+  {
+    if (!(pAttr->permissions & GATT_PERMIT_READ))
+    {
+      return ATT_ERR_READ_NOT_PERMITTED;
+    }
+
+    // Declarations are read by GATTServApp itself
+    if (pAttr->type.len == ATT_BT_UUID_SIZE &&
+        (memcmp(pAttr->type.uuid, primaryServiceUUID, ATT_BT_UUID_SIZE) == 0 ||
+         memcmp(pAttr->type.uuid, characterUUID, ATT_BT_UUID_SIZE) == 0))
+    {
+      return SUCCESS;
+    }
+
+    return pCBs->pfnReadAttrCB(pEvt->connHandle, pAttr, pValue, pLen, 0,
+                               pConn->mtu - 1, ATT_READ_REQ);
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_sendAttRsp
+ *
+ * @brief   Send the response to a peer request. Without a free controller
+ *          buffer the GATT server hands the response to the application,
+ *          as pending, to send with GATT_SendRsp().
+ *
+ * @param   pEvt - FAKESTACK_EVT_READ or FAKESTACK_EVT_WRITE event
+ * @param   status - SUCCESS or the ATT error code of the request
+ * @param   pValue - value read
+ * @param   len - length of the value read
+ */
+static void fakeStack_sendAttRsp(fakeStackEvt_t *pEvt, uint8 status,
+                                 const uint8 *pValue, uint16 len)
+{
+  fakeStackConn_t *pConn = &conns[pEvt->connHandle];
+  gattMsgEvent_t *pRsp;
+  uint8 rspLen = ATT_OPCODE_SIZE;
+
+  if (status != SUCCESS)
+  {
+    rspLen += ATT_ERROR_RSP_SIZE;
+  }
+  else if (pEvt->type == FAKESTACK_EVT_READ)
+  {
+    rspLen += len;
+  }
+
+  pConn->reqWaiting = TRUE;
+  pConn->rspPdus = 0;
+
+  if (fakeStack_takeBuf(pConn, rspLen))
+  {
+    pConn->rspPdus = pConn->bufs;
+
+    return;
+  }
+
+  pRsp = fakeStack_allocEvt(GATT_MSG_EVENT, blePending,
+                            sizeof(gattMsgEvent_t));
+  if (pRsp == NULL)
+  {
+    return;
+  }
+
+  pRsp->connHandle = pEvt->connHandle;
+  if (status != SUCCESS)
+  {
+    pRsp->method = ATT_ERROR_RSP;
+    pRsp->msg.errorRsp.reqOpcode = (pEvt->type == FAKESTACK_EVT_WRITE) ?
+                                   ATT_WRITE_REQ : ATT_READ_REQ;
+    pRsp->msg.errorRsp.handle = pEvt->handle;
+    pRsp->msg.errorRsp.errCode = status;
+  }
+  else if (pEvt->type == FAKESTACK_EVT_WRITE)
+  {
+    pRsp->method = ATT_WRITE_RSP;
+  }
+  else
+  {
+    pRsp->method = ATT_READ_RSP;
+    pRsp->msg.readRsp.len = len;
+    if (len != 0 && (pRsp->msg.readRsp.pValue = ICall_malloc(len)) != NULL)
+    {
+      memcpy(pRsp->msg.readRsp.pValue, pValue, len);
+    }
+  }
+
+  if (pConn->numPending < FAKESTACK_MAX_PENDING)
+  {
+    pConn->pendingTicks[pConn->numPending++] = Clock_getTicks();
+  }
+  stats.pendingRsps++;
+
+  fakeStack_send(gattTask, pRsp);
+}
+
+/*********************************************************************
+ * @fn      fakeStack_processEvt
+ *
+ * @brief   Process a trace event.
+ */
+static void fakeStack_processEvt(fakeStackEvt_t *pEvt)
+{
+  fakeStackConn_t *pConn = fakeStack_getConn(pEvt->connHandle);
+
+  switch (pEvt->type)
+  {
+    case FAKESTACK_EVT_CONNECT:
+      if (pConn == NULL && pEvt->connHandle < FAKESTACK_MAX_CONNS)
+      {
+        gapEstLinkReqEvent_t *pLink;
+
+        pConn = &conns[pEvt->connHandle];
+        pConn->active = TRUE;
+        pConn->interval = (pEvt->param[0] != 0) ? pEvt->param[0] :
+                          FAKESTACK_DEFAULT_INTERVAL;
+        pConn->latency = pEvt->param[1];
+        pConn->timeout = (pEvt->param[2] != 0) ? pEvt->param[2] :
+                         FAKESTACK_DEFAULT_TIMEOUT;
+        pConn->mtu = ATT_MTU_SIZE;
+        pConn->bufs = 0;
+        pConn->txBytes = 0;
+        pConn->numPending = 0;
+        pConn->reqWaiting = FALSE;
+        pConn->rspPdus = 0;
+        pConn->nextEvt = Clock_getTicks() +
+                         FAKESTACK_INTERVAL_TICKS(pEvt->connHandle);
+        pConn->skipped = 0;
+        pConn->burstLeft = 0;
+        pConn->burstActive = FALSE;
+        pConn->txSeq = 0;
+        pConn->sentSeq = 0;
+
+        pLink = fakeStack_allocEvt(GAP_MSG_EVENT, SUCCESS,
+                                   sizeof(gapEstLinkReqEvent_t));
+        if (pLink != NULL)
+        {
+          pLink->opcode = GAP_LINK_ESTABLISHED_EVENT;
+          pLink->devAddrType = ADDRTYPE_PUBLIC;
+          fakeStack_peerAddr(pEvt->connHandle, pLink->devAddr);
+          pLink->connectionHandle = pEvt->connHandle;
+          pLink->connRole = GAP_PROFILE_PERIPHERAL;
+          pLink->connInterval = pConn->interval;
+          pLink->connLatency = pConn->latency;
+          pLink->connTimeout = pConn->timeout;
+          fakeStack_send(gapRoleTask, pLink);
+        }
+      }
+      break;
+
+    case FAKESTACK_EVT_DISCONNECT:
+      if (pConn != NULL)
+      {
+        fakeStack_sendTerminated(pEvt->connHandle,
+                                 (pEvt->param[0] != 0) ? pEvt->param[0] :
+                                 HCI_DISCONNECT_REMOTE_USER_TERM);
+      }
+      break;
+
+    case FAKESTACK_EVT_WRITE:
+    case FAKESTACK_EVT_READ:
+      {
+        uint8 value[FAKESTACK_MAX_MTU];
+        uint16 len = 0;
+        uint8 status = fakeStack_attrAccess(pEvt, value, &len);
+
+        if (status != SUCCESS)
+        {
+          stats.attErrors++;
+        }
+
+        if (pConn != NULL)
+        {
+          fakeStack_sendAttRsp(pEvt, status, value, len);
+        }
+      }
+      break;
+
+    case FAKESTACK_EVT_MTU:
+      if (pConn != NULL)
+      {
+        gattMsgEvent_t *pMtu;
+
+        pConn->mtu = MIN(MAX(pEvt->param[0], ATT_MTU_SIZE), FAKESTACK_MAX_MTU);
+
+        pMtu = fakeStack_allocEvt(GATT_MSG_EVENT, SUCCESS,
+                                  sizeof(gattMsgEvent_t));
+        if (pMtu != NULL)
+        {
+          pMtu->connHandle = pEvt->connHandle;
+          pMtu->method = ATT_MTU_UPDATED_EVENT;
+          pMtu->msg.mtuEvt.MTU = pConn->mtu;
+          fakeStack_send(gattTask, pMtu);
+        }
+      }
+      break;
+
+    case FAKESTACK_EVT_CONN_EVT:
+      // The modeled air runs its own connection events
+      if (pConn != NULL && radioPdus == 0)
+      {
+        fakeStack_connEvt(pEvt->connHandle);
+      }
+      break;
+
+    case FAKESTACK_EVT_PARAM_UPDATE:
+      if (pConn != NULL)
+      {
+        fakeStack_sendParamUpdate(pEvt->connHandle, pEvt->param[0],
+                                  pEvt->param[1], pEvt->param[2]);
+      }
+      break;
+
+    case FAKESTACK_EVT_BUFFERS:
+      bufTotal = (uint8)pEvt->param[0];
+      bufPerEvt = (uint8)pEvt->param[1];
+      break;
+
+    case FAKESTACK_EVT_RADIO:
+      if (radioPdus == 0)
+      {
+        uint8 i;
+
+        for (i = 0; i < FAKESTACK_MAX_CONNS; i++)
+        {
+          conns[i].nextEvt = Clock_getTicks() + FAKESTACK_INTERVAL_TICKS(i);
+          conns[i].skipped = 0;
+        }
+      }
+      radioPdus = (pEvt->param[0] != 0) ? (uint8)pEvt->param[0] :
+                  FAKESTACK_RADIO_EVT_PDUS;
+      radioOctets = (pEvt->param[1] != 0) ?
+                    (uint8)MIN(pEvt->param[1], 251) : FAKESTACK_LL_OCTETS;
+      break;
+
+    case FAKESTACK_EVT_BURST:
+      if (pConn != NULL)
+      {
+        if (!pConn->burstActive)
+        {
+          pConn->burstActive = TRUE;
+          pConn->burstStart = Clock_getTicks();
+        }
+        pConn->burstHandle = pEvt->handle;
+        pConn->burstLeft += pEvt->param[0];
+        stats.burstReads += pEvt->param[0];
+      }
+      break;
+
+    case FAKESTACK_EVT_L2CAP:
+      {
+        fakeStackPsm_t *pPsm = fakeStack_findPsm(pEvt->handle);
+
+        if (pConn != NULL && pPsm != NULL)
+        {
+          fakeStack_cocOpen(pEvt->connHandle, pPsm,
+                            (pEvt->param[0] != 0) ? pEvt->param[0] :
+                            FAKESTACK_COC_PEER_MTU,
+                            (pEvt->param[1] != 0) ? pEvt->param[1] :
+                            FAKESTACK_COC_PEER_MPS,
+                            (pEvt->param[2] != 0) ? pEvt->param[2] :
+                            FAKESTACK_COC_PEER_CREDITS);
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_connEvt
+ *
+ * @brief   End a connection event the slave listened to: the PDUs sent
+ *          in it free their buffers, the client of a read burst gets its
+ *          response and sends its next read, L2CAP channels exchange
+ *          their PDUs with the peer, and the application gets the
+ *          connection event notice.
+ */
+static void fakeStack_connEvt(uint16 connHandle)
+{
+  fakeStackConn_t *pConn = &conns[connHandle];
+  uint8 perEvt = (bufPerEvt != 0) ? bufPerEvt : radioPdus;
+  uint8 freed = pConn->bufs;
+  uint16 bytes = pConn->txBytes;
+  uint8 streaming = (radioPdus != 0) && fakeStack_cocStreaming(connHandle);
+  uint16 mPdus = 0;
+  uint32_t mBytes = 0;
+  uint8 i;
+
+  if (streaming)
+  {
+    // Slave and master PDUs alternate while either side has one and the
+    // event still fits in the connection interval
+    uint32_t budget = (uint32_t)pConn->interval * 1250 -
+                      FAKESTACK_RADIO_EVT_US;
+    uint32_t avg = (pConn->bufs != 0) ? pConn->txBytes / pConn->bufs : 0;
+    uint32_t used = 0;
+    uint8 n;
+
+    stats.cocEvts++;
+    stats.cocTicks += FAKESTACK_INTERVAL_TICKS(connHandle);
+    stats.cocSlots += perEvt;
+
+    freed = 0;
+    for (n = 0; n < perEvt; n++)
+    {
+      uint32_t cost = 0;
+      uint16 m = fakeStack_cocPeerPdu(connHandle, FALSE);
+
+      if (freed < pConn->bufs)
+      {
+        cost += (FAKESTACK_RADIO_PDU_BYTES + avg) *
+                FAKESTACK_RADIO_US_PER_BYTE + FAKESTACK_RADIO_IFS_US;
+      }
+      if (m != 0)
+      {
+        cost += (FAKESTACK_RADIO_PDU_BYTES - L2CAP_HDR_SIZE + m) *
+                FAKESTACK_RADIO_US_PER_BYTE + FAKESTACK_RADIO_IFS_US;
+      }
+
+      if (cost == 0 || (n != 0 && used + cost > budget))
+      {
+        break;
+      }
+      used += cost;
+
+      if (freed < pConn->bufs)
+      {
+        freed++;
+      }
+      if (m != 0)
+      {
+        fakeStack_cocPeerPdu(connHandle, TRUE);
+        mPdus++;
+        mBytes += m - L2CAP_HDR_SIZE;
+      }
+    }
+
+    if (freed != pConn->bufs)
+    {
+      bytes = (uint32)pConn->txBytes * freed / pConn->bufs;
+    }
+    stats.cocPdus += freed;
+  }
+  // PDUs sent in the event free their buffers; their ATT bytes are
+  // averaged over the PDUs held
+  else if (perEvt != 0 && perEvt < freed)
+  {
+    freed = perEvt;
+    bytes = (uint32)pConn->txBytes * freed / pConn->bufs;
+  }
+  pConn->bufs -= freed;
+  pConn->txBytes -= bytes;
+  pConn->sentSeq += freed;
+  bufUsed -= freed;
+
+  if (streaming)
+  {
+    fakeStack_cocSent(connHandle);
+  }
+
+  if (pConn->rspPdus != 0)
+  {
+    pConn->rspPdus = (pConn->rspPdus > freed) ? pConn->rspPdus - freed : 0;
+    if (pConn->rspPdus == 0)
+    {
+      pConn->reqWaiting = FALSE;
+    }
+  }
+
+  if (radioPdus != 0)
+  {
+    uint32_t us = FAKESTACK_RADIO_EVT_US +
+                  freed * (FAKESTACK_RADIO_PDU_BYTES *
+                           FAKESTACK_RADIO_US_PER_BYTE +
+                           FAKESTACK_RADIO_IFS_US) +
+                  bytes * FAKESTACK_RADIO_US_PER_BYTE +
+                  mPdus * ((FAKESTACK_RADIO_PDU_BYTES - L2CAP_HDR_SIZE) *
+                           FAKESTACK_RADIO_US_PER_BYTE +
+                           FAKESTACK_RADIO_IFS_US) +
+                  mBytes * FAKESTACK_RADIO_US_PER_BYTE;
+
+    // The client's next read rides in the same event
+    if (pConn->burstLeft != 0 && !pConn->reqWaiting)
+    {
+      bytes += ATT_OPCODE_SIZE + ATT_READ_REQ_SIZE;
+      us += (FAKESTACK_RADIO_PDU_BYTES + ATT_OPCODE_SIZE +
+             ATT_READ_REQ_SIZE) * FAKESTACK_RADIO_US_PER_BYTE +
+            FAKESTACK_RADIO_IFS_US;
+    }
+
+    stats.radioEvts++;
+    stats.radioOnUs += us;
+    stats.attBytes += bytes;
+    if (pConn->burstActive)
+    {
+      stats.burstBytes += bytes;
+    }
+  }
+
+  if (pConn->burstActive && pConn->burstLeft == 0 && !pConn->reqWaiting)
+  {
+    pConn->burstActive = FALSE;
+    stats.bursts++;
+    stats.burstTicks += Clock_getTicks() - pConn->burstStart;
+  }
+  else if (pConn->burstLeft != 0 && !pConn->reqWaiting)
+  {
+    fakeStackEvt_t req;
+
+    memset(&req, 0, sizeof(req));
+    req.type = FAKESTACK_EVT_READ;
+    req.connHandle = connHandle;
+    req.handle = pConn->burstHandle;
+    pConn->burstLeft--;
+    fakeStack_processEvt(&req);
+  }
+
+  if (noticeEvent[connHandle] != 0)
+  {
+    ICall_Stack_Event *pNotice =
+      (ICall_Stack_Event *)ICall_allocMsg(sizeof(ICall_Stack_Event));
+
+    if (pNotice != NULL)
+    {
+      pNotice->signature = 0xffff;
+      pNotice->event_flag = noticeEvent[connHandle];
+      fakeStack_send(noticeTask[connHandle], pNotice);
+    }
+  }
+
+  // Freed buffers take the next PDUs of the channels, then the flow
+  // control task hears of them
+  for (i = 0; i < FAKESTACK_MAX_CHANNELS; i++)
+  {
+    if (chans[i].active && chans[i].connHandle == connHandle)
+    {
+      fakeStack_cocPump(&chans[i]);
+    }
+  }
+
+  if (freed != 0 && l2capFcTask != ICALL_INVALID_ENTITY_ID)
+  {
+    l2capSignalEvent_t *pEvt =
+      fakeStack_allocEvt(L2CAP_SIGNAL_EVENT, SUCCESS,
+                         sizeof(l2capSignalEvent_t));
+
+    if (pEvt != NULL)
+    {
+      pEvt->connHandle = connHandle;
+      pEvt->opcode = L2CAP_NUM_CTRL_DATA_PKT_EVT;
+      pEvt->cmd.numCtrlDataPktEvt.numDataPkt = freed;
+      fakeStack_send(l2capFcTask, pEvt);
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn      fakeStack_runRadio
+ *
+ * @brief   Run the connection events due on the modeled air. The slave
+ *          skips up to its slave latency of events in a row while it
+ *          has nothing to send.
+ *
+ * @return  Ticks to the next connection event, or FAKESTACK_NO_EVT
+ */
+static uint32_t fakeStack_runRadio(void)
+{
+  uint32_t next = FAKESTACK_NO_EVT;
+  uint8 i;
+
+  for (i = 0; i < FAKESTACK_MAX_CONNS; i++)
+  {
+    fakeStackConn_t *pConn = &conns[i];
+    Int32 left;
+
+    if (!pConn->active)
+    {
+      continue;
+    }
+
+    while ((left = (Int32)(pConn->nextEvt - Clock_getTicks())) <= 0)
+    {
+      if (pConn->bufs != 0 || pConn->skipped >= pConn->latency)
+      {
+        pConn->skipped = 0;
+        fakeStack_connEvt(i);
+      }
+      else
+      {
+        pConn->skipped++;
+        stats.radioSkipped++;
+      }
+      pConn->nextEvt += FAKESTACK_INTERVAL_TICKS(i);
+    }
+
+    if ((uint32_t)left < next)
+    {
+      next = left;
+    }
+  }
+
+  return next;
+}
+
+/*********************************************************************
+ * @fn      fakeStack_msgService
+ *
+ * @brief   Handler of the ICALL_SERVICE_CLASS_BLE_MSG service. Task IDs
+ *          used in messages are the ICall entity IDs.
+ */
+static ICall_Errno fakeStack_msgService(ICall_FuncArgsHdr *args)
+{
+  if (args->func == ICALL_MSG_FUNC_GET_LOCAL_MSG_ENTITY_ID)
+  {
+    ICall_GetLocalMsgEntityIdArgs *pArgs =
+      (ICall_GetLocalMsgEntityIdArgs *)args;
+
+    pArgs->localId = pArgs->entity;
+
+    return ICALL_ERRNO_SUCCESS;
+  }
+
+  return ICALL_ERRNO_INVALID_FUNCTION;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+void FakeStack_entry(const ICall_RemoteTaskArg *arg0, void *arg1)
+{
+  ICall_EntityID msgEntity;
+  ICall_SyncHandle msgSync;
+
+  ICall_enrollService(ICALL_SERVICE_CLASS_BLE, NULL, &stackEntity,
+                      &stackSync);
+  ICall_enrollService(ICALL_SERVICE_CLASS_BLE_MSG, fakeStack_msgService,
+                      &msgEntity, &msgSync);
+
+  evtQueue = Util_constructQueue(&evtQ);
+  cmdQueue = Util_constructQueue(&cmdQ);
+
+  // TGAP_CONN_PAUSE_PERIPHERAL defaults to 5 seconds
+  gapParams[TGAP_CONN_PAUSE_PERIPHERAL] = 5;
+  gapParams[TGAP_CONN_PARAM_TIMEOUT] = 30000;
+
+  pfnBMAlloc = fakeStack_bmAlloc;
+  pfnBMFree = fakeStack_bmFree;
+
+  for (;;)
+  {
+    ICall_EntityID src;
+    ICall_EntityID dest;
+    void *pMsg;
+    uint_fast32_t timeout = ICALL_TIMEOUT_FOREVER;
+
+    if (!Queue_empty(cmdQueue))
+    {
+      fakeStackQCmd_t *pQCmd = (fakeStackQCmd_t *)Queue_head(cmdQueue);
+      Int32 left = (Int32)(pQCmd->due - Clock_getTicks());
+
+      // Wake up when the oldest command in flight arrives
+      timeout = (left > 0) ? (left * Clock_tickPeriod + 999) / 1000 : 0;
+    }
+
+    if (radioPdus != 0)
+    {
+      uint32_t left = fakeStack_runRadio();
+
+      // Wake up for the next connection event
+      if (left != FAKESTACK_NO_EVT &&
+          (left * Clock_tickPeriod + 999) / 1000 < timeout)
+      {
+        timeout = (left * Clock_tickPeriod + 999) / 1000;
+      }
+    }
+
+    ICall_wait(timeout);
+
+    while (ICall_fetchMsg(&src, &dest, &pMsg) == ICALL_ERRNO_SUCCESS)
+    {
+      fakeStackQCmd_t *pQCmd;
+
+      if (cmdDelay == 0 ||
+          (pQCmd = (fakeStackQCmd_t *)malloc(sizeof(fakeStackQCmd_t))) == NULL)
+      {
+        fakeStack_processCmd(src, (ICall_HciExtCmd *)pMsg);
+        continue;
+      }
+
+      pQCmd->src = src;
+      pQCmd->pCmd = (ICall_HciExtCmd *)pMsg;
+      pQCmd->due = Clock_getTicks() + cmdDelay;
+      Queue_put(cmdQueue, &pQCmd->elem);
+    }
+
+    while (!Queue_empty(cmdQueue) &&
+           (Int32)(((fakeStackQCmd_t *)Queue_head(cmdQueue))->due -
+                   Clock_getTicks()) <= 0)
+    {
+      fakeStackQCmd_t *pQCmd = (fakeStackQCmd_t *)Queue_get(cmdQueue);
+
+      fakeStack_processCmd(pQCmd->src, pQCmd->pCmd);
+      free(pQCmd);
+    }
+
+    while (!Queue_empty(evtQueue))
+    {
+      fakeStackQEvt_t *pQEvt = (fakeStackQEvt_t *)Queue_get(evtQueue);
+
+      fakeStack_processEvt(&pQEvt->evt);
+      free(pQEvt);
+    }
+  }
+}
+
+bStatus_t FakeStack_inject(const fakeStackEvt_t *pEvt)
+{
+  fakeStackQEvt_t *pQEvt = (fakeStackQEvt_t *)malloc(sizeof(fakeStackQEvt_t));
+
+  if (pQEvt == NULL)
+  {
+    return bleMemAllocError;
+  }
+
+  pQEvt->evt = *pEvt;
+  Queue_put(evtQueue, &pQEvt->elem);
+  ICall_signal(stackSync);
+
+  return SUCCESS;
+}
+
+gattAttribute_t *FakeStack_getAttr(uint16 handle)
+{
+  uint8 i;
+
+  for (i = 0; i < numServices; i++)
+  {
+    gattAttribute_t *pAttrs = services[i].pAttrs;
+
+    if (handle >= pAttrs[0].handle &&
+        handle < pAttrs[0].handle + services[i].numAttrs)
+    {
+      return &pAttrs[handle - pAttrs[0].handle];
+    }
+  }
+
+  return NULL;
+}
+
+void FakeStack_getStats(fakeStackStats_t *pStats)
+{
+  uint8 i;
+
+  *pStats = stats;
+
+  // Responses still pending are not sent yet either
+  for (i = 0; i < FAKESTACK_MAX_CONNS; i++)
+  {
+    pStats->lostRsps += conns[i].numPending;
+  }
+}
+
+void FakeStack_setCmdDelay(uint32_t ticks)
+{
+  cmdDelay = ticks;
+}
+
+uint8 FakeStack_getAdvStart(uint32_t *pTick)
+{
+  *pTick = advStart;
+
+  return advStarted;
+}
+
+uint8 FakeStack_addBond(const uint8 *pIrk, const uint8 *pIdAddr)
+{
+  uint8 i;
+
+  for (i = 0; i < GAP_BONDINGS_MAX; i++)
+  {
+    if (!bonds[i].used)
+    {
+      bonds[i].used = TRUE;
+      memcpy(bonds[i].irk, pIrk, KEYLEN);
+      memcpy(bonds[i].idAddr, pIdAddr, B_ADDR_LEN);
+      break;
+    }
+  }
+
+  return i;
+}
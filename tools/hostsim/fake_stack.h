@@ -0,0 +1,251 @@
+/******************************************************************************
+
+ @file  fake_stack.h
+
+ @brief This file contains the interface of the scripted BLE stack
+        that stands in for the stack image in host simulation.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef FAKE_STACK_H
+#define FAKE_STACK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "bcomdef.h"
+#include "gatt.h"
+#include "icall.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of simultaneous connections
+#ifndef FAKESTACK_MAX_CONNS
+#define FAKESTACK_MAX_CONNS               3
+#endif
+
+// Handle of the first attribute registered by the application. The GAP
+// and GATT services the stack adds itself come before it.
+#ifndef FAKESTACK_FIRST_HANDLE
+#define FAKESTACK_FIRST_HANDLE            0x000C
+#endif
+
+// Largest attribute value written or read by a trace event
+#define FAKESTACK_MAX_VALUE               64
+
+// Trace events, see FakeStack_inject()
+#define FAKESTACK_EVT_CONNECT             0 // Peer connected
+#define FAKESTACK_EVT_DISCONNECT          1 // Link terminated
+#define FAKESTACK_EVT_WRITE               2 // ATT Write Request
+#define FAKESTACK_EVT_READ                3 // ATT Read Request
+#define FAKESTACK_EVT_MTU                 4 // ATT MTU exchanged
+#define FAKESTACK_EVT_CONN_EVT            5 // Connection event ended
+#define FAKESTACK_EVT_PARAM_UPDATE        6 // Connection parameters updated
+#define FAKESTACK_EVT_BUFFERS             7 // Controller buffers throttled
+#define FAKESTACK_EVT_RADIO               8 // Air interface modeled
+#define FAKESTACK_EVT_BURST               9 // Client reads back to back
+#define FAKESTACK_EVT_L2CAP               10 // Peer connected an L2CAP channel
+#define FAKESTACK_EVT_COUNT               11
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * An event of the peer or the controller. Fields not used by an event
+ * type are ignored.
+ */
+typedef struct
+{
+  uint8 type;                        //!< FAKESTACK_EVT_*
+  uint16 connHandle;                 //!< Connection
+  uint16 handle;                     //!< Attribute handle, or PSM
+  uint16 param[3];                   //!< MTU, interval/latency/timeout,
+                                     //!< disconnect reason, buffers and
+                                     //!< buffers freed per event, PDUs
+                                     //!< and octets per event, reads of
+                                     //!< a burst or channel MTU/MPS/
+                                     //!< credits of the peer
+  uint8 len;                         //!< Value length
+  uint8 value[FAKESTACK_MAX_VALUE];  //!< Value written
+} fakeStackEvt_t;
+
+/**
+ * Counters of the traffic the stack saw.
+ */
+typedef struct
+{
+  uint32 cmds;          //!< Commands received from the application
+  uint32 events;        //!< Messages sent to the application
+  uint32 notifications; //!< Notifications and indications sent
+  uint32 rsps;          //!< ATT responses sent by GATT_SendRsp()
+  uint32 attErrors;     //!< Reads and writes that failed
+  uint32 bufFull;       //!< Sends refused for lack of a controller buffer
+  uint32 pendingRsps;   //!< ATT responses handed back to the application
+  uint32 lostRsps;      //!< Pending ATT responses never sent
+  uint32 lateRsps;      //!< Pending ATT responses sent after the ATT timeout
+  uint32 rspWaitMax;    //!< Longest wait of a pending ATT response (ticks)
+  uint32 radioEvts;     //!< Connection events the slave listened to
+  uint32 radioSkipped;  //!< Connection events skipped by slave latency
+  uint32 radioOnUs;     //!< Modeled radio-on time (us)
+  uint32 attBytes;      //!< ATT bytes carried on the modeled air
+  uint32 bursts;        //!< Read bursts completed
+  uint32 burstReads;    //!< Reads asked for by read bursts
+  uint32 burstBytes;    //!< ATT bytes carried while a burst was running
+  uint32 burstTicks;    //!< Time read bursts took to complete (ticks)
+  uint32 resolves;      //!< Peer addresses looked up in the bonds
+  uint32 ahCalls;       //!< ah() checks of an RPA against a bond's IRK
+  uint32 cocSdus;       //!< SDUs sent on L2CAP channels
+  uint32 cocBytes;      //!< Bytes of those SDUs
+  uint32 cocRxSdus;     //!< SDUs the peer looped back
+  uint32 cocRxBytes;    //!< Bytes of those SDUs
+  uint32 cocCredits;    //!< Flow Control Credit packets sent to the peer
+  uint32 cocCreditsIn;  //!< Flow Control Credit packets of the peer
+  uint32 cocStalls;     //!< Times a channel ran out of credits
+  uint32 cocPeerStalls; //!< Times the peer ran out of credits
+  uint32 cocEvts;       //!< Connection events while a channel streamed
+  uint32 cocTicks;      //!< Time channels streamed (ticks)
+  uint32 cocPdus;       //!< PDUs the slave sent in those events
+  uint32 cocSlots;      //!< PDUs the events allowed the slave
+} fakeStackStats_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      FakeStack_entry
+ *
+ * @brief   Entry of the stack image, started by ICall_createRemoteTasks()
+ *          through ICall_imgEntries[].
+ *
+ * @param   arg0 - dispatch functions of ICall
+ * @param   arg1 - not used
+ *
+ * @return  none
+ */
+extern void FakeStack_entry(const ICall_RemoteTaskArg *arg0, void *arg1);
+
+/*********************************************************************
+ * @fn      FakeStack_inject
+ *
+ * @brief   Queue an event for the stack task, as the controller would
+ *          raise it. Can be called from the idle hook of host_rtos.h.
+ *
+ * @param   pEvt - event, copied
+ *
+ * @return  SUCCESS or bleMemAllocError
+ */
+extern bStatus_t FakeStack_inject(const fakeStackEvt_t *pEvt);
+
+/*********************************************************************
+ * @fn      FakeStack_getAttr
+ *
+ * @brief   Find a registered attribute.
+ *
+ * @param   handle - attribute handle
+ *
+ * @return  attribute, or NULL if no attribute has the handle
+ */
+extern gattAttribute_t *FakeStack_getAttr(uint16 handle);
+
+/*********************************************************************
+ * @fn      FakeStack_getStats
+ *
+ * @brief   Get the traffic counters.
+ *
+ * @param   pStats - counters to fill
+ *
+ * @return  none
+ */
+extern void FakeStack_getStats(fakeStackStats_t *pStats);
+
+/*********************************************************************
+ * @fn      FakeStack_setCmdDelay
+ *
+ * @brief   Model the round trip of a command, e.g. to a network processor
+ *          over UART: commands are processed, and their status returned,
+ *          the given time after they were sent. Commands in flight do
+ *          not hold up the ones sent after them.
+ *
+ * @param   ticks - round trip time, 0 (the default) for none
+ *
+ * @return  none
+ */
+extern void FakeStack_setCmdDelay(uint32_t ticks);
+
+/*********************************************************************
+ * @fn      FakeStack_getAdvStart
+ *
+ * @brief   Get the time advertising was first enabled.
+ *
+ * @param   pTick - tick of the first GAP_MakeDiscoverable()
+ *
+ * @return  TRUE if advertising was enabled
+ */
+extern uint8 FakeStack_getAdvStart(uint32_t *pTick);
+
+/*********************************************************************
+ * @fn      FakeStack_addBond
+ *
+ * @brief   Add a bond with a public identity address, as pairing with
+ *          bonding would. Bonds are erased with GAPBOND_ERASE_ALLBONDS
+ *          and GAPBOND_ERASE_SINGLEBOND.
+ *
+ * @param   pIrk - peer IRK, least significant octet first
+ * @param   pIdAddr - peer identity address
+ *
+ * @return  bond index, GAP_BONDINGS_MAX if no slot is free
+ */
+extern uint8 FakeStack_addBond(const uint8 *pIrk, const uint8 *pIdAddr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAKE_STACK_H */
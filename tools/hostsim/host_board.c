@@ -0,0 +1,224 @@
+/******************************************************************************
+
+ @file  host_board.c
+
+ @brief This file contains the board support of the host simulation:
+        the display, PIN driver and power platform functions the
+        application and ICall call on the target.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ti/drivers/PIN.h>
+#include <ti/mw/display/Display.h>
+
+#include "icall.h"
+#include "icall_platform.h"
+#include "osal.h"
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static Display_Config display = { Display_Type_LCD };
+
+// Lines are printed only when enabled, so that they do not skew timing
+static bool displayEnabled = false;
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*
+ * Display. Lines are printed as "[line] text" to stdout.
+ */
+void HostDisplay_enable(bool enable)
+{
+  displayEnabled = enable;
+}
+
+void Display_Params_init(Display_Params *params)
+{
+  memset(params, 0, sizeof(Display_Params));
+}
+
+Display_Handle Display_open(unsigned int id, Display_Params *params)
+{
+  return &display;
+}
+
+void Display_close(Display_Handle handle)
+{
+}
+
+void Display_clear(Display_Handle handle)
+{
+}
+
+void Display_clearLines(Display_Handle handle, uint8_t fromLine,
+                        uint8_t toLine)
+{
+}
+
+void Display_doPrintf(Display_Handle handle, uint8_t line, uint8_t column,
+                      const char *fmt, ...)
+{
+  va_list va;
+
+  if (handle == NULL || !displayEnabled)
+  {
+    return;
+  }
+
+  va_start(va, fmt);
+  printf("[%u] ", line);
+  vprintf(fmt, va);
+  printf("\n");
+  va_end(va);
+}
+
+/*
+ * PIN driver. There are no pins.
+ */
+PIN_Status PIN_init(const PIN_Config aPinCfg[])
+{
+  return PIN_SUCCESS;
+}
+
+PIN_Handle PIN_open(PIN_State *state, const PIN_Config pinList[])
+{
+  return state;
+}
+
+void PIN_close(PIN_Handle handle)
+{
+}
+
+PIN_Status PIN_setOutputValue(PIN_Handle handle, PIN_Id pinId, uint32_t val)
+{
+  return PIN_SUCCESS;
+}
+
+uint32_t PIN_getInputValue(PIN_Id pinId)
+{
+  return 0;
+}
+
+/*
+ * ICall power platform. The device never sleeps and the high frequency
+ * crystal is always running.
+ */
+ICall_Errno
+ICallPlatform_pwrUpdActivityCounter(ICall_PwrUpdActivityCounterArgs *args)
+{
+  args->pwrRequired = args->incFlag;
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrRegisterNotify(ICall_PwrRegisterNotifyArgs *args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrConfigACAction(ICall_PwrBitmapArgs *args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrRequire(ICall_PwrBitmapArgs *args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrDispense(ICall_PwrBitmapArgs *args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrIsStableXOSCHF(ICall_GetBoolArgs* args)
+{
+  args->value = TRUE;
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrSwitchXOSCHF(ICall_FuncArgsHdr* args)
+{
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrGetXOSCStartupTime(ICall_PwrGetXOSCStartupTimeArgs * args)
+{
+  args->value = 0;
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+ICall_Errno
+ICallPlatform_pwrGetTransitionState(ICall_PwrGetTransitionStateArgs *args)
+{
+  args->state = 0;
+
+  return ICALL_ERRNO_SUCCESS;
+}
+
+/*
+ * OSAL memory functions the application links from the stack image.
+ */
+uint8 osal_memcmp(const void GENERIC *src1, const void GENERIC *src2,
+                  unsigned int len)
+{
+  return (memcmp(src1, src2, len) == 0);
+}
@@ -0,0 +1,280 @@
+/******************************************************************************
+
+ @file  host_flash.c
+
+ @brief This file contains the host flash simulator: a file-backed
+        array of flash sectors behind the driverlib flash and VIMS
+        functions.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * The flash area is a file mapped read-only at the target address of the
+ * area, so that code reading flash through pointers runs unchanged.
+ * FlashProgram() only clears bits, as NOR flash does: a program that
+ * would set a bit back to 1 leaves it at 0 and is counted as bad.
+ * FlashSectorErase() sets a whole sector to 0xFF. Both add the typical
+ * time of the data sheet to the modeled busy time; they take no
+ * simulated time.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <driverlib/flash.h>
+#include <driverlib/vims.h>
+
+#include "host_flash.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Largest flash area, in sectors
+#define HOSTFLASH_MAX_SECTORS         32
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static int flashFd = -1;
+static uint8_t *pFlash = NULL;
+static uint32_t flashBase;
+static uint32_t flashSize;
+
+// Bytes programmed before the simulated power loss
+static uint32_t flashBudget = HOSTFLASH_NO_FAIL;
+
+static hostFlashStats_t flashStats;
+static uint32_t flashErases[HOSTFLASH_MAX_SECTORS];
+
+static uint32_t vimsMode = VIMS_MODE_ENABLED;
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+int HostFlash_open(const char *pPath, uint32_t base, uint32_t size)
+{
+  struct stat st;
+
+  if ((size == 0) || (size % HOSTFLASH_SECTOR_SIZE) ||
+      (size > HOSTFLASH_MAX_SECTORS * HOSTFLASH_SECTOR_SIZE) ||
+      (base % HOSTFLASH_SECTOR_SIZE) || (pFlash != NULL))
+  {
+    errno = EINVAL;
+    return -1;
+  }
+
+  flashFd = open(pPath, O_RDWR | O_CREAT, 0644);
+  if ((flashFd < 0) || (fstat(flashFd, &st) != 0))
+  {
+    return -1;
+  }
+
+  // A new or short file is erased flash
+  if (st.st_size < size)
+  {
+    uint8_t erased[HOSTFLASH_SECTOR_SIZE];
+    off_t pos;
+
+    memset(erased, 0xFF, sizeof(erased));
+    for (pos = st.st_size; pos < size; pos += sizeof(erased))
+    {
+      size_t n = (size - pos < sizeof(erased)) ? size - pos : sizeof(erased);
+
+      if (pwrite(flashFd, erased, n, pos) != (ssize_t)n)
+      {
+        close(flashFd);
+        return -1;
+      }
+    }
+  }
+
+  pFlash = mmap((void *)(uintptr_t)base, size, PROT_READ,
+                MAP_SHARED | MAP_FIXED_NOREPLACE, flashFd, 0);
+  if (pFlash == MAP_FAILED)
+  {
+    pFlash = NULL;
+    close(flashFd);
+    return -1;
+  }
+
+  flashBase = base;
+  flashSize = size;
+  HostFlash_resetStats();
+
+  return 0;
+}
+
+void HostFlash_close(void)
+{
+  if (pFlash != NULL)
+  {
+    munmap(pFlash, flashSize);
+    close(flashFd);
+    pFlash = NULL;
+  }
+}
+
+void HostFlash_failAfter(uint32_t bytes)
+{
+  flashBudget = bytes;
+}
+
+void HostFlash_getStats(hostFlashStats_t *pStats)
+{
+  *pStats = flashStats;
+}
+
+void HostFlash_resetStats(void)
+{
+  memset(&flashStats, 0, sizeof(flashStats));
+  memset(flashErases, 0, sizeof(flashErases));
+}
+
+uint32_t HostFlash_eraseCount(uint32_t sector)
+{
+  return (sector < HOSTFLASH_MAX_SECTORS) ? flashErases[sector] : 0;
+}
+
+/*
+ * Flash API of driverlib.
+ */
+uint32_t FlashProgram(uint8_t *pui8DataBuffer, uint32_t ui32Address,
+                      uint32_t ui32Count)
+{
+  uint32_t offset = ui32Address - flashBase;
+  uint32_t count = ui32Count;
+  uint8_t buf[HOSTFLASH_SECTOR_SIZE];
+  uint32_t i;
+
+  if ((pFlash == NULL) || (ui32Address < flashBase) ||
+      (ui32Count > sizeof(buf)) || (offset + ui32Count > flashSize))
+  {
+    return FAPI_STATUS_INCORRECT_DATABUFFER_LENGTH;
+  }
+
+  if (count > flashBudget)
+  {
+    count = flashBudget;
+  }
+
+  // Bits can only go from 1 to 0
+  for (i = 0; i < count; i++)
+  {
+    buf[i] = pFlash[offset + i] & pui8DataBuffer[i];
+    if (buf[i] != pui8DataBuffer[i])
+    {
+      flashStats.badPrograms++;
+    }
+  }
+
+  if ((count > 0) && (pwrite(flashFd, buf, count, offset) != (ssize_t)count))
+  {
+    return FAPI_STATUS_FSM_ERROR;
+  }
+
+  flashStats.programs++;
+  flashStats.programBytes += count;
+  flashStats.busyUs += (uint64_t)HOSTFLASH_WORD_US *
+                       (((offset + count + 3) / 4) - (offset / 4));
+
+  if (flashBudget != HOSTFLASH_NO_FAIL)
+  {
+    flashBudget -= count;
+  }
+
+  return (count == ui32Count) ? FAPI_STATUS_SUCCESS : FAPI_STATUS_FSM_ERROR;
+}
+
+uint32_t FlashSectorErase(uint32_t ui32SectorAddress)
+{
+  uint32_t offset = ui32SectorAddress - flashBase;
+  uint8_t erased[HOSTFLASH_SECTOR_SIZE];
+
+  if ((pFlash == NULL) || (ui32SectorAddress < flashBase) ||
+      (offset % HOSTFLASH_SECTOR_SIZE) || (offset >= flashSize))
+  {
+    return FAPI_STATUS_INCORRECT_DATABUFFER_LENGTH;
+  }
+
+  // No power left to erase with
+  if (flashBudget == 0)
+  {
+    return FAPI_STATUS_FSM_ERROR;
+  }
+
+  memset(erased, 0xFF, sizeof(erased));
+  if (pwrite(flashFd, erased, sizeof(erased), offset) != sizeof(erased))
+  {
+    return FAPI_STATUS_FSM_ERROR;
+  }
+
+  flashStats.erases++;
+  flashStats.busyUs += HOSTFLASH_ERASE_US;
+  flashErases[offset / HOSTFLASH_SECTOR_SIZE]++;
+
+  return FAPI_STATUS_SUCCESS;
+}
+
+/*
+ * VIMS API of driverlib. The mode is only remembered, there is no cache.
+ */
+uint32_t VIMSModeGet(uint32_t ui32Base)
+{
+  return vimsMode;
+}
+
+void VIMSModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+  vimsMode = ui32Mode;
+}
+
+/*********************************************************************
+*********************************************************************/
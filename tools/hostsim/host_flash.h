@@ -0,0 +1,175 @@
+/******************************************************************************
+
+ @file  host_flash.h
+
+ @brief This file contains the interface of the host flash simulator,
+        a file-backed array of flash sectors behind the driverlib
+        flash functions.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef HOST_FLASH_H
+#define HOST_FLASH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Flash sector, the unit of FlashSectorErase()
+#define HOSTFLASH_SECTOR_SIZE         0x1000
+
+// Typical flash timings of the CC26xx data sheet: sector erase, and
+// programming of a 32-bit word
+#define HOSTFLASH_ERASE_US            8000
+#define HOSTFLASH_WORD_US             8
+
+// No power loss, see HostFlash_failAfter()
+#define HOSTFLASH_NO_FAIL             0xFFFFFFFF
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * Counters of the flash operations since HostFlash_open() or
+ * HostFlash_resetStats().
+ */
+typedef struct
+{
+  uint32_t programs;      //!< FlashProgram() calls
+  uint32_t programBytes;  //!< Bytes programmed
+  uint32_t erases;        //!< Sectors erased
+  uint32_t badPrograms;   //!< Programs that would have set a bit to 1
+  uint64_t busyUs;        //!< Modeled time the flash was busy (us)
+} hostFlashStats_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      HostFlash_open
+ *
+ * @brief   Map a file as the flash area at its target address, so that
+ *          the code reads it as memory-mapped flash. A new file starts
+ *          erased. The mapping is read-only: only FlashProgram() and
+ *          FlashSectorErase() change the file.
+ *
+ * @param   pPath - file holding the flash content
+ * @param   base - target address of the area, sector aligned
+ * @param   size - size of the area, a multiple of HOSTFLASH_SECTOR_SIZE
+ *
+ * @return  0 on success, -1 with errno set otherwise
+ */
+extern int HostFlash_open(const char *pPath, uint32_t base, uint32_t size);
+
+/*********************************************************************
+ * @fn      HostFlash_close
+ *
+ * @brief   Unmap and close the flash file. Its content stays, for a
+ *          later HostFlash_open() to start from, as after a reset.
+ *
+ * @return  none
+ */
+extern void HostFlash_close(void);
+
+/*********************************************************************
+ * @fn      HostFlash_failAfter
+ *
+ * @brief   Simulate a power loss: programming stops after the given
+ *          number of bytes, in the middle of a FlashProgram() if need
+ *          be, and every later program or erase fails until the next
+ *          call.
+ *
+ * @param   bytes - bytes still programmed, HOSTFLASH_NO_FAIL for no
+ *                  power loss
+ *
+ * @return  none
+ */
+extern void HostFlash_failAfter(uint32_t bytes);
+
+/*********************************************************************
+ * @fn      HostFlash_getStats
+ *
+ * @brief   Get the flash operation counters.
+ *
+ * @param   pStats - counters to fill
+ *
+ * @return  none
+ */
+extern void HostFlash_getStats(hostFlashStats_t *pStats);
+
+/*********************************************************************
+ * @fn      HostFlash_resetStats
+ *
+ * @brief   Clear the flash operation counters, the erase counts of the
+ *          sectors included.
+ *
+ * @return  none
+ */
+extern void HostFlash_resetStats(void);
+
+/*********************************************************************
+ * @fn      HostFlash_eraseCount
+ *
+ * @brief   Get the erases of a sector.
+ *
+ * @param   sector - sector index in the area
+ *
+ * @return  erases since HostFlash_open() or HostFlash_resetStats()
+ */
+extern uint32_t HostFlash_eraseCount(uint32_t sector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_FLASH_H */
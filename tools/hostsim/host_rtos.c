@@ -0,0 +1,1433 @@
+/******************************************************************************
+
+ @file  host_rtos.c
+
+ @brief This file contains the POSIX implementation of the TI-RTOS
+        kernel modules used by ICall and the application: Task,
+        Semaphore, Event, Clock, Queue, Swi and Hwi.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Event.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Queue.h>
+#include <ti/sysbios/knl/Swi.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "host_rtos.h"
+
+/*
+ * The simulated CPU is a mutex. Each task runs on its own thread, which
+ * holds the mutex for as long as the task is the one selected to run and
+ * waits on its condition variable otherwise. BIOS_start() keeps the main
+ * thread as the idle loop: it runs while every task is blocked, and it
+ * is the only place where interrupts (the idle hook) and clocks happen.
+ * Simulated time therefore stands still while tasks run, so runs are
+ * repeatable and independent of the host speed.
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Clock tick period of the CC26xx kernel configuration, in microseconds
+#define HOSTRTOS_TICK_PERIOD      10
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+const UInt32 Clock_tickPeriod = HOSTRTOS_TICK_PERIOD;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static pthread_mutex_t cpuLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t idleCond = PTHREAD_COND_INITIALIZER;
+
+// Task holding the CPU, NULL while the idle loop does
+static Task_Handle curTask = NULL;
+
+static BIOS_ThreadType threadType = BIOS_ThreadType_Main;
+static Bool started = FALSE;
+
+static Bool taskEnabled = TRUE;
+static Bool swiEnabled = TRUE;
+static Bool hwiEnabled = TRUE;
+
+static Task_Handle taskList = NULL;
+static Clock_Handle clockList = NULL;
+static Hwi_Handle hwiList = NULL;
+static Swi_Handle swiPending = NULL;
+
+static UInt32 ticks = 0;
+static UInt32 seqCount = 0;
+static UInt32 switchCount = 0;
+static UInt64 swiNs = 0;
+
+// Interrupts-off time: start of the current section, longest section
+static UInt64 hwiOffNs = 0;
+static UInt32 hwiOffTicks = 0;
+static UInt64 hwiOffMaxNs = 0;
+
+static HostRtos_IdleFxn idleHook = NULL;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static Void schedule(Void);
+
+/*********************************************************************
+ * @fn      lockCpu
+ *
+ * @brief   The main thread starts out holding the CPU, as main() runs
+ *          before any task.
+ */
+static void __attribute__((constructor)) lockCpu(void)
+{
+  pthread_mutex_lock(&cpuLock);
+}
+
+/*********************************************************************
+ * @fn      cpuNow
+ *
+ * @brief   Thread CPU time of the calling thread.
+ */
+static UInt64 cpuNow(Void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+  return (UInt64)ts.tv_sec * 1000000000u + (UInt64)ts.tv_nsec;
+}
+
+/*********************************************************************
+ * @fn      sliceStart / sliceEnd
+ *
+ * @brief   Charge the thread CPU time between the two to a task.
+ */
+static Void sliceStart(Task_Handle self)
+{
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &self->sliceStart);
+}
+
+static Void sliceEnd(Task_Handle self)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+  self->cpuNs += (UInt64)(ts.tv_sec - self->sliceStart.tv_sec) * 1000000000u +
+                 ts.tv_nsec - self->sliceStart.tv_nsec;
+}
+
+/*********************************************************************
+ * @fn      highestReady
+ *
+ * @brief   Find the task to run: the highest priority one, first come
+ *          first served within a priority.
+ *
+ * @return  task, or NULL if every task is blocked
+ */
+static Task_Handle highestReady(Void)
+{
+  Task_Handle t;
+  Task_Handle best = NULL;
+
+  for (t = taskList; t != NULL; t = t->link)
+  {
+    if ((t->mode == Task_Mode_READY || t->mode == Task_Mode_RUNNING) &&
+        (best == NULL || t->priority > best->priority ||
+         (t->priority == best->priority && (Int32)(t->seq - best->seq) < 0)))
+    {
+      best = t;
+    }
+  }
+
+  return best;
+}
+
+/*********************************************************************
+ * @fn      firstPending
+ *
+ * @brief   Find the task to wake up on an object: the highest priority
+ *          one, first come first served within a priority.
+ *
+ * @return  task, or NULL if no task is blocked on the object
+ */
+static Task_Handle firstPending(Ptr obj)
+{
+  Task_Handle t;
+  Task_Handle best = NULL;
+
+  for (t = taskList; t != NULL; t = t->link)
+  {
+    if (t->mode == Task_Mode_BLOCKED && t->pendObj == obj &&
+        (best == NULL || t->priority > best->priority ||
+         (t->priority == best->priority && (Int32)(t->seq - best->seq) < 0)))
+    {
+      best = t;
+    }
+  }
+
+  return best;
+}
+
+/*********************************************************************
+ * @fn      resume
+ *
+ * @brief   Wait until the calling task is given the CPU.
+ */
+static Void resume(Task_Handle self)
+{
+  while (curTask != self)
+  {
+    pthread_cond_wait(&self->cond, &cpuLock);
+  }
+
+  self->mode = Task_Mode_RUNNING;
+  threadType = BIOS_ThreadType_Task;
+  sliceStart(self);
+}
+
+/*********************************************************************
+ * @fn      handOff
+ *
+ * @brief   Give the CPU to the task that should run next, or to the idle
+ *          loop, on behalf of a task that stops running.
+ */
+static Void handOff(Task_Handle self)
+{
+  Task_Handle next = highestReady();
+
+  sliceEnd(self);
+  switchCount++;
+
+  curTask = next;
+  if (next != NULL)
+  {
+    pthread_cond_signal(&next->cond);
+  }
+  else
+  {
+    pthread_cond_signal(&idleCond);
+  }
+}
+
+/*********************************************************************
+ * @fn      block
+ *
+ * @brief   Block the calling task on an object.
+ *
+ * @param   obj - object, NULL to only wait for the timeout
+ * @param   timeout - ticks, or BIOS_WAIT_FOREVER
+ *
+ * @return  FALSE if the timeout expired
+ */
+static Bool block(Ptr obj, UInt32 timeout)
+{
+  Task_Handle self = curTask;
+
+  if (threadType != BIOS_ThreadType_Task || !taskEnabled || !hwiEnabled)
+  {
+    // As on target, blocking is only allowed from an unlocked task
+    abort();
+  }
+
+  self->mode = Task_Mode_BLOCKED;
+  self->pendObj = obj;
+  self->timedOut = FALSE;
+  self->timed = (timeout != BIOS_WAIT_FOREVER);
+  self->timeout = ticks + timeout;
+  self->seq = ++seqCount;
+  self->blocks++;
+  self->blockStart = ticks;
+
+  handOff(self);
+  resume(self);
+
+  self->blockedTicks += ticks - self->blockStart;
+
+  return !self->timedOut;
+}
+
+/*********************************************************************
+ * @fn      wake
+ *
+ * @brief   Make a blocked task ready.
+ */
+static Void wake(Task_Handle t, Bool timedOut)
+{
+  t->mode = Task_Mode_READY;
+  t->pendObj = NULL;
+  t->timed = FALSE;
+  t->timedOut = timedOut;
+  t->seq = ++seqCount;
+}
+
+/*********************************************************************
+ * @fn      runSwis
+ *
+ * @brief   Run the posted Swis, highest priority first, in Swi context.
+ */
+static Void runSwis(Void)
+{
+  BIOS_ThreadType saved = threadType;
+  Task_Handle self = (saved == BIOS_ThreadType_Task) ? curTask : NULL;
+  UInt64 start;
+
+  if (swiPending == NULL || !swiEnabled || !hwiEnabled ||
+      saved == BIOS_ThreadType_Swi)
+  {
+    return;
+  }
+
+  if (self != NULL)
+  {
+    sliceEnd(self);
+  }
+  start = cpuNow();
+  threadType = BIOS_ThreadType_Swi;
+
+  while (swiPending != NULL)
+  {
+    Swi_Handle *pp;
+    Swi_Handle *best = &swiPending;
+    Swi_Handle swi;
+
+    for (pp = &swiPending; *pp != NULL; pp = &(*pp)->link)
+    {
+      if ((*pp)->priority > (*best)->priority)
+      {
+        best = pp;
+      }
+    }
+
+    swi = *best;
+    *best = swi->link;
+    swi->posted = FALSE;
+    swi->fxn(swi->arg0, swi->arg1);
+  }
+
+  threadType = saved;
+  swiNs += cpuNow() - start;
+  if (self != NULL)
+  {
+    sliceStart(self);
+  }
+}
+
+/*********************************************************************
+ * @fn      schedule
+ *
+ * @brief   Run posted Swis and preempt the calling task if a higher
+ *          priority task is ready. Nothing happens while the caller has
+ *          the scheduler locked; it is done again once unlocked. Outside
+ *          of tasks the idle loop does it when the interrupt or Swi
+ *          returns.
+ */
+static Void schedule(Void)
+{
+  Task_Handle self = curTask;
+  Task_Handle next;
+
+  if (threadType != BIOS_ThreadType_Task || !hwiEnabled)
+  {
+    return;
+  }
+
+  runSwis();
+
+  if (!taskEnabled)
+  {
+    return;
+  }
+
+  next = highestReady();
+  if (next != self && next->priority > self->priority)
+  {
+    self->mode = Task_Mode_READY;
+    handOff(self);
+    resume(self);
+  }
+}
+
+/*********************************************************************
+ * @fn      taskThread
+ *
+ * @brief   Host thread of a task.
+ */
+static void *taskThread(void *arg)
+{
+  Task_Handle self = (Task_Handle)arg;
+
+  pthread_mutex_lock(&cpuLock);
+  resume(self);
+
+  self->fxn(self->arg0, self->arg1);
+
+  self->mode = Task_Mode_TERMINATED;
+  handOff(self);
+  pthread_mutex_unlock(&cpuLock);
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn      nextDue
+ *
+ * @brief   Find the earliest clock or pend timeout.
+ *
+ * @return  FALSE if none is pending
+ */
+static Bool nextDue(UInt32 *pTick)
+{
+  Clock_Handle c;
+  Task_Handle t;
+  Bool due = FALSE;
+
+  for (c = clockList; c != NULL; c = c->link)
+  {
+    if (c->active && (!due || (Int32)(c->due - *pTick) < 0))
+    {
+      *pTick = c->due;
+      due = TRUE;
+    }
+  }
+
+  for (t = taskList; t != NULL; t = t->link)
+  {
+    if (t->mode == Task_Mode_BLOCKED && t->timed &&
+        (!due || (Int32)(t->timeout - *pTick) < 0))
+    {
+      *pTick = t->timeout;
+      due = TRUE;
+    }
+  }
+
+  return due;
+}
+
+/*********************************************************************
+ * @fn      fireDue
+ *
+ * @brief   Expire pend timeouts and run the Clock functions that are due,
+ *          earliest first, in Swi context.
+ */
+static Void fireDue(Void)
+{
+  Task_Handle t;
+  UInt64 start = cpuNow();
+
+  for (t = taskList; t != NULL; t = t->link)
+  {
+    if (t->mode == Task_Mode_BLOCKED && t->timed &&
+        (Int32)(t->timeout - ticks) <= 0)
+    {
+      wake(t, TRUE);
+    }
+  }
+
+  threadType = BIOS_ThreadType_Swi;
+
+  for (;;)
+  {
+    Clock_Handle c;
+    Clock_Handle first = NULL;
+
+    for (c = clockList; c != NULL; c = c->link)
+    {
+      if (c->active && (Int32)(c->due - ticks) <= 0 &&
+          (first == NULL || (Int32)(c->due - first->due) < 0))
+      {
+        first = c;
+      }
+    }
+
+    if (first == NULL)
+    {
+      break;
+    }
+
+    if (first->period != 0)
+    {
+      first->due += first->period;
+    }
+    else
+    {
+      first->active = FALSE;
+    }
+
+    first->fxn(first->arg);
+  }
+
+  threadType = BIOS_ThreadType_Hwi;
+  swiNs += cpuNow() - start;
+}
+
+/*********************************************************************
+ * BIOS
+ */
+
+Void BIOS_start(Void)
+{
+  started = TRUE;
+  threadType = BIOS_ThreadType_Hwi;
+
+  for (;;)
+  {
+    Task_Handle next;
+    UInt32 due = ticks;
+    Bool pending;
+
+    runSwis();
+
+    next = highestReady();
+    if (next != NULL)
+    {
+      curTask = next;
+      pthread_cond_signal(&next->cond);
+      while (curTask != NULL)
+      {
+        pthread_cond_wait(&idleCond, &cpuLock);
+      }
+      threadType = BIOS_ThreadType_Hwi;
+      continue;
+    }
+
+    pending = nextDue(&due);
+
+    if (idleHook != NULL)
+    {
+      if (!idleHook(due, pending))
+      {
+        break;
+      }
+    }
+    else if (pending)
+    {
+      HostRtos_advance(due);
+    }
+    else
+    {
+      break;
+    }
+
+    fireDue();
+  }
+
+  threadType = BIOS_ThreadType_Main;
+  started = FALSE;
+}
+
+BIOS_ThreadType BIOS_getThreadType(Void)
+{
+  return threadType;
+}
+
+/*********************************************************************
+ * Host control
+ */
+
+Void HostRtos_setIdleHook(HostRtos_IdleFxn fxn)
+{
+  idleHook = fxn;
+}
+
+Void HostRtos_advance(UInt32 tick)
+{
+  if ((Int32)(tick - ticks) > 0)
+  {
+    ticks = tick;
+  }
+}
+
+Void HostRtos_setTaskName(Task_Handle handle, String name)
+{
+  handle->name = name;
+}
+
+Task_Handle HostRtos_nextTask(Task_Handle handle)
+{
+  return (handle == NULL) ? taskList : handle->link;
+}
+
+UInt64 HostRtos_taskCpuNs(Task_Handle handle)
+{
+  return handle->cpuNs;
+}
+
+UInt32 HostRtos_taskBlocks(Task_Handle handle)
+{
+  return handle->blocks;
+}
+
+UInt32 HostRtos_taskBlockedTicks(Task_Handle handle)
+{
+  if (handle->mode == Task_Mode_BLOCKED)
+  {
+    return handle->blockedTicks + (ticks - handle->blockStart);
+  }
+
+  return handle->blockedTicks;
+}
+
+UInt64 HostRtos_swiCpuNs(Void)
+{
+  return swiNs;
+}
+
+UInt64 HostRtos_cpuNs(Void)
+{
+  Task_Handle t;
+  UInt64 total = swiNs;
+
+  for (t = taskList; t != NULL; t = t->link)
+  {
+    total += t->cpuNs;
+  }
+
+  return total;
+}
+
+UInt32 HostRtos_switches(Void)
+{
+  return switchCount;
+}
+
+UInt64 HostRtos_hwiOffMaxNs(Void)
+{
+  return hwiOffMaxNs;
+}
+
+Void HostRtos_resetHwiOffMax(Void)
+{
+  hwiOffMaxNs = 0;
+}
+
+/*********************************************************************
+ * Task
+ */
+
+Void Task_Params_init(Task_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+  params->priority = 1;
+}
+
+Void Task_construct(Task_Struct *obj, Task_FuncPtr fxn,
+                    const Task_Params *params, Error_Block *eb)
+{
+  Task_Params defaults;
+  Task_Handle *pp;
+
+  if (params == NULL)
+  {
+    Task_Params_init(&defaults);
+    params = &defaults;
+  }
+
+  memset(obj, 0, sizeof(*obj));
+  obj->fxn = fxn;
+  obj->arg0 = params->arg0;
+  obj->arg1 = params->arg1;
+  obj->priority = params->priority;
+  obj->env = params->env;
+  obj->name = "task";
+  obj->mode = Task_Mode_READY;
+  obj->seq = ++seqCount;
+  pthread_cond_init(&obj->cond, NULL);
+
+  for (pp = &taskList; *pp != NULL; pp = &(*pp)->link)
+  {
+  }
+  *pp = obj;
+
+  if (pthread_create(&obj->thread, NULL, taskThread, obj) != 0)
+  {
+    abort();
+  }
+
+  // A task created by a running task may have to preempt it
+  schedule();
+}
+
+Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params,
+                        Error_Block *eb)
+{
+  Task_Handle handle = (Task_Handle)malloc(sizeof(Task_Object));
+
+  if (handle != NULL)
+  {
+    Task_construct(handle, fxn, params, eb);
+  }
+
+  return handle;
+}
+
+Task_Handle Task_self(Void)
+{
+  return (threadType == BIOS_ThreadType_Task) ? curTask : NULL;
+}
+
+UInt Task_disable(Void)
+{
+  UInt key = taskEnabled;
+
+  taskEnabled = FALSE;
+
+  return key;
+}
+
+Void Task_restore(UInt key)
+{
+  if (key)
+  {
+    taskEnabled = TRUE;
+    schedule();
+  }
+}
+
+Void Task_enable(Void)
+{
+  Task_restore(TRUE);
+}
+
+Void Task_yield(Void)
+{
+  Task_Handle self = curTask;
+
+  if (threadType == BIOS_ThreadType_Task && taskEnabled && hwiEnabled)
+  {
+    self->mode = Task_Mode_READY;
+    self->seq = ++seqCount;
+    if (highestReady() != self)
+    {
+      handOff(self);
+      resume(self);
+    }
+    else
+    {
+      self->mode = Task_Mode_RUNNING;
+    }
+  }
+}
+
+Void Task_sleep(UInt32 nticks)
+{
+  if (nticks != 0)
+  {
+    block(NULL, nticks);
+  }
+}
+
+Int Task_getPri(Task_Handle handle)
+{
+  return handle->priority;
+}
+
+UInt Task_setPri(Task_Handle handle, Int newpri)
+{
+  UInt oldpri = handle->priority;
+
+  handle->priority = newpri;
+
+  // A raised task may preempt the caller, a lowered caller may yield
+  schedule();
+
+  return oldpri;
+}
+
+Ptr Task_getEnv(Task_Handle handle)
+{
+  return handle->env;
+}
+
+Void Task_setEnv(Task_Handle handle, Ptr env)
+{
+  handle->env = env;
+}
+
+Task_Mode Task_getMode(Task_Handle handle)
+{
+  return handle->mode;
+}
+
+/*********************************************************************
+ * Semaphore
+ */
+
+Void Semaphore_Params_init(Semaphore_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+  params->mode = Semaphore_Mode_COUNTING;
+}
+
+Void Semaphore_construct(Semaphore_Struct *obj, Int count,
+                         const Semaphore_Params *params)
+{
+  obj->count = count;
+  obj->mode = (params != NULL) ? params->mode : Semaphore_Mode_COUNTING;
+}
+
+Semaphore_Handle Semaphore_create(Int count, const Semaphore_Params *params,
+                                  Error_Block *eb)
+{
+  Semaphore_Handle handle =
+    (Semaphore_Handle)malloc(sizeof(Semaphore_Object));
+
+  if (handle != NULL)
+  {
+    Semaphore_construct(handle, count, params);
+  }
+
+  return handle;
+}
+
+Bool Semaphore_pend(Semaphore_Handle handle, UInt32 timeout)
+{
+  if (handle->count > 0)
+  {
+    handle->count--;
+
+    return TRUE;
+  }
+
+  if (timeout == BIOS_NO_WAIT)
+  {
+    return FALSE;
+  }
+
+  // The post is handed over to the woken task without counting it
+  return block(handle, timeout);
+}
+
+Void Semaphore_post(Semaphore_Handle handle)
+{
+  Task_Handle t = firstPending(handle);
+
+  if (t != NULL)
+  {
+    wake(t, FALSE);
+    schedule();
+  }
+  else if (handle->mode == Semaphore_Mode_BINARY ||
+           handle->mode == Semaphore_Mode_BINARY_PRIORITY)
+  {
+    handle->count = 1;
+  }
+  else
+  {
+    handle->count++;
+  }
+}
+
+Int Semaphore_getCount(Semaphore_Handle handle)
+{
+  return handle->count;
+}
+
+/*********************************************************************
+ * Event
+ */
+
+/*********************************************************************
+ * @fn      eventMatch
+ *
+ * @brief   Consume the posted events that satisfy a pend, as the
+ *          TI-RTOS Event module does: all of andMask, or any of orMask.
+ *
+ * @return  consumed events, 0 if the pend is not satisfied
+ */
+static UInt eventMatch(Event_Handle handle, UInt andMask, UInt orMask)
+{
+  UInt match = orMask & handle->posted;
+
+  if ((andMask & handle->posted) == andMask)
+  {
+    match |= andMask;
+  }
+
+  handle->posted &= ~match;
+
+  return match;
+}
+
+Void Event_Params_init(Event_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+}
+
+Void Event_construct(Event_Struct *obj, const Event_Params *params)
+{
+  obj->posted = 0;
+}
+
+Event_Handle Event_create(const Event_Params *params, Error_Block *eb)
+{
+  Event_Handle handle = (Event_Handle)malloc(sizeof(Event_Object));
+
+  if (handle != NULL)
+  {
+    Event_construct(handle, params);
+  }
+
+  return handle;
+}
+
+UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask,
+                UInt32 timeout)
+{
+  Task_Handle self = curTask;
+  UInt match = eventMatch(handle, andMask, orMask);
+
+  if (match != 0 || timeout == BIOS_NO_WAIT)
+  {
+    return match;
+  }
+
+  self->andMask = andMask;
+  self->orMask = orMask;
+  self->events = 0;
+
+  return block(handle, timeout) ? self->events : 0;
+}
+
+Void Event_post(Event_Handle handle, UInt eventMask)
+{
+  Task_Handle t;
+
+  handle->posted |= eventMask;
+
+  t = firstPending(handle);
+  if (t != NULL)
+  {
+    t->events = eventMatch(handle, t->andMask, t->orMask);
+    if (t->events != 0)
+    {
+      wake(t, FALSE);
+      schedule();
+    }
+  }
+}
+
+UInt Event_getPostedEvents(Event_Handle handle)
+{
+  return handle->posted;
+}
+
+/*********************************************************************
+ * Clock
+ */
+
+Void Clock_Params_init(Clock_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+}
+
+Void Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn, UInt timeout,
+                     const Clock_Params *params)
+{
+  memset(obj, 0, sizeof(*obj));
+  obj->fxn = fxn;
+  obj->timeout = timeout;
+  if (params != NULL)
+  {
+    obj->arg = params->arg;
+    obj->period = params->period;
+  }
+
+  obj->link = clockList;
+  clockList = obj;
+
+  if (params != NULL && params->startFlag)
+  {
+    Clock_start(obj);
+  }
+}
+
+Clock_Handle Clock_create(Clock_FuncPtr fxn, UInt timeout,
+                          const Clock_Params *params, Error_Block *eb)
+{
+  Clock_Handle handle = (Clock_Handle)malloc(sizeof(Clock_Object));
+
+  if (handle != NULL)
+  {
+    Clock_construct(handle, fxn, timeout, params);
+  }
+
+  return handle;
+}
+
+Void Clock_destruct(Clock_Struct *obj)
+{
+  Clock_Handle *pp;
+
+  for (pp = &clockList; *pp != NULL; pp = &(*pp)->link)
+  {
+    if (*pp == obj)
+    {
+      *pp = obj->link;
+      break;
+    }
+  }
+}
+
+Void Clock_delete(Clock_Handle *handle)
+{
+  Clock_destruct(*handle);
+  free(*handle);
+  *handle = NULL;
+}
+
+Void Clock_start(Clock_Handle handle)
+{
+  handle->due = ticks + handle->timeout;
+  handle->active = TRUE;
+}
+
+Void Clock_stop(Clock_Handle handle)
+{
+  handle->active = FALSE;
+}
+
+Bool Clock_isActive(Clock_Handle handle)
+{
+  return handle->active;
+}
+
+Void Clock_setTimeout(Clock_Handle handle, UInt32 timeout)
+{
+  handle->timeout = timeout;
+}
+
+UInt32 Clock_getTimeout(Clock_Handle handle)
+{
+  return handle->active ? handle->due - ticks : handle->timeout;
+}
+
+Void Clock_setPeriod(Clock_Handle handle, UInt32 period)
+{
+  handle->period = period;
+}
+
+Void Clock_setFunc(Clock_Handle handle, Clock_FuncPtr fxn, UArg arg)
+{
+  handle->fxn = fxn;
+  handle->arg = arg;
+}
+
+UInt32 Clock_getTicks(Void)
+{
+  return ticks;
+}
+
+/*********************************************************************
+ * Queue
+ *
+ * Only one thread runs at a time, so the atomic and non-atomic
+ * variants are the same.
+ */
+
+Void Queue_Params_init(Queue_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+}
+
+Void Queue_construct(Queue_Struct *obj, const Queue_Params *params)
+{
+  obj->elem.next = &obj->elem;
+  obj->elem.prev = &obj->elem;
+}
+
+Queue_Handle Queue_create(const Queue_Params *params, Error_Block *eb)
+{
+  Queue_Handle handle = (Queue_Handle)malloc(sizeof(Queue_Object));
+
+  if (handle != NULL)
+  {
+    Queue_construct(handle, params);
+  }
+
+  return handle;
+}
+
+Bool Queue_empty(Queue_Handle handle)
+{
+  return handle->elem.next == &handle->elem;
+}
+
+Void Queue_enqueue(Queue_Handle handle, Queue_Elem *elem)
+{
+  elem->next = &handle->elem;
+  elem->prev = handle->elem.prev;
+  handle->elem.prev->next = elem;
+  handle->elem.prev = elem;
+}
+
+Ptr Queue_dequeue(Queue_Handle handle)
+{
+  Queue_Elem *elem = handle->elem.next;
+
+  // An empty queue returns itself, as on target
+  handle->elem.next = elem->next;
+  elem->next->prev = &handle->elem;
+
+  return elem;
+}
+
+Ptr Queue_get(Queue_Handle handle)
+{
+  return Queue_dequeue(handle);
+}
+
+Void Queue_put(Queue_Handle handle, Queue_Elem *elem)
+{
+  Queue_enqueue(handle, elem);
+}
+
+Ptr Queue_getTail(Queue_Handle handle)
+{
+  Queue_Elem *elem = handle->elem.prev;
+
+  handle->elem.prev = elem->prev;
+  elem->prev->next = &handle->elem;
+
+  return elem;
+}
+
+Void Queue_putHead(Queue_Handle handle, Queue_Elem *elem)
+{
+  elem->prev = &handle->elem;
+  elem->next = handle->elem.next;
+  handle->elem.next->prev = elem;
+  handle->elem.next = elem;
+}
+
+Ptr Queue_head(Queue_Handle handle)
+{
+  return handle->elem.next;
+}
+
+Ptr Queue_next(Ptr qelem)
+{
+  return ((Queue_Elem *)qelem)->next;
+}
+
+Ptr Queue_prev(Ptr qelem)
+{
+  return ((Queue_Elem *)qelem)->prev;
+}
+
+Void Queue_insert(Queue_Elem *qelem, Queue_Elem *elem)
+{
+  // Inserts elem in front of qelem
+  elem->next = qelem;
+  elem->prev = qelem->prev;
+  qelem->prev->next = elem;
+  qelem->prev = elem;
+}
+
+Void Queue_remove(Queue_Elem *qelem)
+{
+  qelem->prev->next = qelem->next;
+  qelem->next->prev = qelem->prev;
+}
+
+Void Queue_elemClear(Queue_Elem *qelem)
+{
+  qelem->next = qelem;
+  qelem->prev = qelem;
+}
+
+/*********************************************************************
+ * Swi
+ */
+
+Void Swi_Params_init(Swi_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+  params->priority = 1;
+}
+
+Void Swi_construct(Swi_Struct *obj, Swi_FuncPtr fxn,
+                   const Swi_Params *params, Error_Block *eb)
+{
+  memset(obj, 0, sizeof(*obj));
+  obj->fxn = fxn;
+  if (params != NULL)
+  {
+    obj->arg0 = params->arg0;
+    obj->arg1 = params->arg1;
+    obj->priority = params->priority;
+  }
+}
+
+Swi_Handle Swi_create(Swi_FuncPtr fxn, const Swi_Params *params,
+                      Error_Block *eb)
+{
+  Swi_Handle handle = (Swi_Handle)malloc(sizeof(Swi_Object));
+
+  if (handle != NULL)
+  {
+    Swi_construct(handle, fxn, params, eb);
+  }
+
+  return handle;
+}
+
+Void Swi_post(Swi_Handle handle)
+{
+  if (!handle->posted)
+  {
+    handle->posted = TRUE;
+    handle->link = swiPending;
+    swiPending = handle;
+    schedule();
+  }
+}
+
+UInt Swi_disable(Void)
+{
+  UInt key = swiEnabled;
+
+  swiEnabled = FALSE;
+
+  return key;
+}
+
+Void Swi_restore(UInt key)
+{
+  if (key)
+  {
+    swiEnabled = TRUE;
+    schedule();
+  }
+}
+
+Void Swi_enable(Void)
+{
+  Swi_restore(TRUE);
+}
+
+/*********************************************************************
+ * Hwi
+ */
+
+Void Hwi_Params_init(Hwi_Params *params)
+{
+  memset(params, 0, sizeof(*params));
+  params->priority = ~0;
+  params->enableInt = TRUE;
+}
+
+Void Hwi_construct(Hwi_Struct *obj, Int intNum, Hwi_FuncPtr fxn,
+                   const Hwi_Params *params, Error_Block *eb)
+{
+  memset(obj, 0, sizeof(*obj));
+  obj->intNum = intNum;
+  obj->fxn = fxn;
+  obj->arg = (params != NULL) ? params->arg : 0;
+  obj->enabled = (params != NULL) ? params->enableInt : TRUE;
+
+  obj->link = hwiList;
+  hwiList = obj;
+}
+
+Hwi_Handle Hwi_create(Int intNum, Hwi_FuncPtr fxn, const Hwi_Params *params,
+                      Error_Block *eb)
+{
+  Hwi_Handle handle = (Hwi_Handle)malloc(sizeof(Hwi_Object));
+
+  if (handle != NULL)
+  {
+    Hwi_construct(handle, intNum, fxn, params, eb);
+  }
+
+  return handle;
+}
+
+/*********************************************************************
+ * @fn      hwiOn
+ *
+ * @brief   Unmask interrupts and account the section they were masked
+ *          for: the thread CPU time plus the simulated time advanced
+ *          meanwhile, e.g. by a busy wait on a simulated peripheral.
+ */
+static Void hwiOn(Void)
+{
+  if (!hwiEnabled)
+  {
+    UInt64 offNs = cpuNow() - hwiOffNs +
+                   (UInt64)(ticks - hwiOffTicks) * Clock_tickPeriod * 1000;
+
+    if (offNs > hwiOffMaxNs)
+    {
+      hwiOffMaxNs = offNs;
+    }
+
+    hwiEnabled = TRUE;
+  }
+}
+
+UInt Hwi_disable(Void)
+{
+  UInt key = hwiEnabled;
+
+  if (hwiEnabled)
+  {
+    hwiOffNs = cpuNow();
+    hwiOffTicks = ticks;
+    hwiEnabled = FALSE;
+  }
+
+  return key;
+}
+
+UInt Hwi_enable(Void)
+{
+  UInt key = hwiEnabled;
+
+  hwiOn();
+  schedule();
+
+  return key;
+}
+
+Void Hwi_restore(UInt key)
+{
+  if (key)
+  {
+    hwiOn();
+    schedule();
+  }
+}
+
+/*********************************************************************
+ * @fn      findHwi
+ *
+ * @brief   Find the Hwi of an interrupt number.
+ */
+static Hwi_Handle findHwi(UInt intNum)
+{
+  Hwi_Handle h;
+
+  for (h = hwiList; h != NULL; h = h->link)
+  {
+    if (h->intNum == (Int)intNum)
+    {
+      break;
+    }
+  }
+
+  return h;
+}
+
+UInt Hwi_disableInterrupt(UInt intNum)
+{
+  Hwi_Handle h = findHwi(intNum);
+  UInt key = FALSE;
+
+  if (h != NULL)
+  {
+    key = h->enabled;
+    h->enabled = FALSE;
+  }
+
+  return key;
+}
+
+UInt Hwi_enableInterrupt(UInt intNum)
+{
+  Hwi_Handle h = findHwi(intNum);
+  UInt key = FALSE;
+
+  if (h != NULL)
+  {
+    key = h->enabled;
+    h->enabled = TRUE;
+  }
+
+  return key;
+}
+
+Void Hwi_restoreInterrupt(UInt intNum, UInt key)
+{
+  Hwi_Handle h = findHwi(intNum);
+
+  if (h != NULL)
+  {
+    h->enabled = key;
+  }
+}
+
+Void Hwi_clearInterrupt(UInt intNum)
+{
+}
+
+Void Hwi_post(UInt intNum)
+{
+  Hwi_Handle h = findHwi(intNum);
+  BIOS_ThreadType saved = threadType;
+
+  // Runs the ISR right away, as if the interrupt fired
+  if (h != NULL && h->enabled && hwiEnabled)
+  {
+    threadType = BIOS_ThreadType_Hwi;
+    h->fxn(h->arg);
+    threadType = saved;
+    schedule();
+  }
+}
@@ -0,0 +1,222 @@
+/******************************************************************************
+
+ @file  host_rtos.h
+
+ @brief This file contains the control interface of the TI-RTOS host
+        simulation port: simulated time, the idle hook that plays the
+        part of interrupts, and CPU accounting.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef HOST_RTOS_H
+#define HOST_RTOS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <xdc/std.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Task.h>
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/**
+ * @brief   Called by BIOS_start() in Hwi context whenever every task is
+ *          blocked and no Swi is pending. The hook may post to kernel
+ *          objects, as an interrupt would, and advance time with
+ *          HostRtos_advance() up to nextDue. Clocks and pend timeouts
+ *          that are due run once it returns.
+ *
+ * @param   nextDue - tick the next clock or pend timeout expires at
+ * @param   due - FALSE if no clock or pend timeout is pending
+ *
+ * @return  FALSE to end the simulation and return from BIOS_start()
+ */
+typedef Bool (*HostRtos_IdleFxn)(UInt32 nextDue, Bool due);
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      HostRtos_setIdleHook
+ *
+ * @brief   Install the idle hook. Without one, time advances to the next
+ *          clock expiry and the simulation ends when none is left.
+ *
+ * @param   fxn - idle hook
+ *
+ * @return  none
+ */
+extern Void HostRtos_setIdleHook(HostRtos_IdleFxn fxn);
+
+/*********************************************************************
+ * @fn      HostRtos_advance
+ *
+ * @brief   Move simulated time forward. Only valid from the idle hook,
+ *          or from a simulated peripheral that a task busy-waits on with
+ *          interrupts masked; clocks due meanwhile run late, once the
+ *          task blocks.
+ *
+ * @param   tick - new Clock_getTicks() value, not before the current one
+ *
+ * @return  none
+ */
+extern Void HostRtos_advance(UInt32 tick);
+
+/*********************************************************************
+ * @fn      HostRtos_setTaskName
+ *
+ * @brief   Name a task in CPU reports.
+ *
+ * @param   handle - task
+ * @param   name - name, must stay valid
+ *
+ * @return  none
+ */
+extern Void HostRtos_setTaskName(Task_Handle handle, String name);
+
+/*********************************************************************
+ * @fn      HostRtos_nextTask
+ *
+ * @brief   Iterate over the tasks in creation order.
+ *
+ * @param   handle - previous task, or NULL for the first one
+ *
+ * @return  next task, or NULL after the last one
+ */
+extern Task_Handle HostRtos_nextTask(Task_Handle handle);
+
+/*********************************************************************
+ * @fn      HostRtos_taskCpuNs
+ *
+ * @brief   Thread CPU time a task spent holding the simulated CPU. The
+ *          time spent switching host threads is not included.
+ *
+ * @param   handle - task
+ *
+ * @return  nanoseconds
+ */
+extern UInt64 HostRtos_taskCpuNs(Task_Handle handle);
+
+/*********************************************************************
+ * @fn      HostRtos_taskBlocks
+ *
+ * @brief   Number of times a task blocked on a pend or a sleep.
+ *
+ * @param   handle - task
+ *
+ * @return  blocking pends and sleeps
+ */
+extern UInt32 HostRtos_taskBlocks(Task_Handle handle);
+
+/*********************************************************************
+ * @fn      HostRtos_taskBlockedTicks
+ *
+ * @brief   Simulated time a task spent blocked on a pend or a sleep,
+ *          including the pend it may be blocked on now.
+ *
+ * @param   handle - task
+ *
+ * @return  ticks
+ */
+extern UInt32 HostRtos_taskBlockedTicks(Task_Handle handle);
+
+/*********************************************************************
+ * @fn      HostRtos_swiCpuNs
+ *
+ * @brief   Thread CPU time spent in Swi functions and Clock functions.
+ *
+ * @return  nanoseconds
+ */
+extern UInt64 HostRtos_swiCpuNs(Void);
+
+/*********************************************************************
+ * @fn      HostRtos_cpuNs
+ *
+ * @brief   Total of HostRtos_taskCpuNs() for every task and
+ *          HostRtos_swiCpuNs().
+ *
+ * @return  nanoseconds
+ */
+extern UInt64 HostRtos_cpuNs(Void);
+
+/*********************************************************************
+ * @fn      HostRtos_switches
+ *
+ * @brief   Number of task switches so far.
+ *
+ * @return  task switches
+ */
+extern UInt32 HostRtos_switches(Void);
+
+/*********************************************************************
+ * @fn      HostRtos_hwiOffMaxNs
+ *
+ * @brief   Longest time interrupts were masked since the start or since
+ *          HostRtos_resetHwiOffMax(): thread CPU time plus the simulated
+ *          time advanced while they were masked.
+ *
+ * @return  nanoseconds
+ */
+extern UInt64 HostRtos_hwiOffMaxNs(Void);
+
+/*********************************************************************
+ * @fn      HostRtos_resetHwiOffMax
+ *
+ * @brief   Restart the measurement of HostRtos_hwiOffMaxNs().
+ *
+ * @return  none
+ */
+extern Void HostRtos_resetHwiOffMax(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_RTOS_H */
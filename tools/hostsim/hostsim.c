@@ -0,0 +1,942 @@
+/******************************************************************************
+
+ @file  hostsim.c
+
+ @brief This file contains the host simulation driver. It starts the
+        application the way main.c does on the target, replays a trace
+        of peer events through the scripted stack in simulated time,
+        and reports the host CPU time spent handling each kind of
+        event.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+/*
+ * The application, GAPRole, the profiles and ICall are built from the
+ * sources of the target; the kernel (host_rtos.c) runs each task on its
+ * own thread, one at a time, with time advancing only when every task is
+ * blocked. The stack image is replaced by fake_stack.c. CPU times are the
+ * host thread times of the target code, useful to compare changes to it,
+ * not to predict times on the device.
+ *
+ * Build from the repository root (no project file is needed):
+ *
+ *   gcc -O2 -o hostsim -DCC26XX -DUSE_ICALL -DPOWER_SAVING \
+ *       -DHEAPMGR_SIZE=8192 -DICALL_MAX_NUM_ENTITIES=6 \
+ *       -DICALL_MAX_NUM_TASKS=3 -DICALL_FEATURE_SEPARATE_IMGINFO \
+ *       -DMAX_NUM_BLE_CONNS=3 \
+ *       -Itools/hostsim/include -Itools/hostsim \
+ *       -Ible-stack/inc -Ible-stack/rom -Ible-stack/icall/inc \
+ *       -Ible-stack/common/cc26xx -Ible-stack/common/cc26xx/cyc_trace \
+ *       -Ible-stack/common/cc26xx/cs_prof \
+ *       -Ible-stack/components/heapmgr \
+ *       -Ible-stack/controller/cc26xx/inc \
+ *       -Ible-stack/components/hal/src/target/_common \
+ *       -Ible-stack/components/hal/src/target/_common/cc26xx \
+ *       -Ible-stack/components/hal/src/inc \
+ *       -Ible-stack/components/osal/src/inc \
+ *       -Ible-stack/components/services/src/sdata \
+ *       -Ible-stack/components/services/src/saddr \
+ *       -Ible-stack/components/services/src/aes/cc26xx \
+ *       -Ible-stack/components/icall/src/inc \
+ *       -Ible-stack/components/icall/src \
+ *       -Ible-stack/profiles/roles -Ible-stack/profiles/roles/cc26xx \
+ *       -Ible-stack/profiles/dev_info -Ible-stack/profiles/simple_profile \
+ *       -Isource \
+ *       ble-stack/components/icall/src/icall.c \
+ *       ble-stack/icall/app/icall_api.c ble-stack/common/cc26xx/util.c \
+ *       ble-stack/host/gattservapp_util.c ble-stack/host/gatt_uuid.c \
+ *       ble-stack/profiles/roles/cc26xx/peripheral.c \
+ *       ble-stack/profiles/simple_profile/cc26xx/simple_gatt_profile.c \
+ *       ble-stack/profiles/dev_info/cc26xx/devinfoservice.c \
+ *       ble-stack/common/cc26xx/cyc_trace/cyc_trace.c \
+ *       ble-stack/common/cc26xx/cs_prof/cs_prof.c \
+ *       source/simple_peripheral.c tools/hostsim/host_rtos.c \
+ *       tools/hostsim/host_board.c tools/hostsim/fake_stack.c \
+ *       tools/hostsim/host_aes.c tools/hostsim/hostsim.c -lpthread
+ *
+ * The heap keeps the 4 byte alignment of the target, so build with
+ * -fno-sanitize=alignment when using -fsanitize=undefined. Add
+ * -DCYC_TRACE -DCYC_TRACE_SIZE=16384 for the -t option, -DHEAPMGR_TRACE
+ * for the -m option, and -DCS_PROF to list the critical sections that
+ * kept interrupts masked the longest. Add -DL2CAP_STREAM
+ * -DSBP_L2CAP_TX_LEN=<bytes>, -Ible-stack/common/cc26xx/l2cap_stream and
+ * ble-stack/common/cc26xx/l2cap_stream/l2cap_stream.c for the app to
+ * stream over the channel of an l2cap event, on the modeled air.
+ *
+ * Usage: hostsim [-v] [-l] [-n repeats] [-c ms] [-t out] [-m out] trace
+ *
+ *   -v  print the display lines of the application
+ *   -l  list the attribute handles, to write traces against
+ *   -n  replay the trace several times, 1 s apart
+ *   -c  round trip time of a stack command in ms, e.g. to a network
+ *       processor; compare the boot line of the report, the time to
+ *       advertising and how long the app task was blocked until then,
+ *       with and without -DICALL_API_ASYNC, e.g. on
+ *       traces/connect_after_boot.trace. The line is only printed if
+ *       advertising started before the first connect. Commands still in
+ *       flight when the trace ends are not processed.
+ *   -t  write the hot path trace (CYC_TRACE) to a file, to decode with
+ *       tools/cyctrace/cyctrace_decode.py
+ *   -m  write the heap trace report (HEAPMGR_TRACE) at the end of the
+ *       run to a file, to decode with tools/heapmgr/heaptrace_decode.py
+ *
+ * A trace holds one event per line, "time_ms event args", in time order;
+ * '#' starts a comment. Connection handles are 0 to 2.
+ *
+ *   connect <conn> [interval latency timeout]  peer connected
+ *   disconnect <conn> [reason]                 peer disconnected
+ *   write <conn> <handle> <hex value>          ATT Write Request
+ *   read <conn> <handle>                       ATT Read Request
+ *   mtu <conn> <mtu>                           ATT MTU exchanged
+ *   conn_evt <conn>                            connection event ended
+ *   param_update <conn> <interval> <latency> <timeout>
+ *                                              master changed parameters
+ *   buffers <count> [per_evt]                  throttle the controller to
+ *                                              count buffers, per_evt of a
+ *                                              connection freed by each of
+ *                                              its events (default all);
+ *                                              0 buffers for no limit
+ *   radio [pdus] [octets]                      model the air interface,
+ *                                              pdus sent per connection
+ *                                              event (default 4) of up to
+ *                                              octets of LL payload
+ *                                              (default 27); then conn_evt
+ *                                              lines are ignored
+ *   burst <conn> <handle> <count>              the client reads handle
+ *                                              count times, each read
+ *                                              after the last response
+ *   l2cap <conn> <psm> [mtu mps credits]       the peer connects an L2CAP
+ *                                              channel to psm and sends
+ *                                              back the SDUs it receives
+ *
+ * On the modeled air, connection events run at the connection interval
+ * and the slave skips up to its slave latency of them while it has
+ * nothing to send. The report then shows the radio-on time against the
+ * ATT bytes carried, how long the read bursts took, and the throughput
+ * of the L2CAP channels each way.
+ *
+ * Once responses were throttled, the report shows how the application
+ * retried the pending ATT responses: its retry count histogram, the
+ * responses it dropped or never sent and the longest wait of one.
+ *
+ * See traces/ for examples.
+ */
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/mw/display/Display.h>
+
+#include "icall.h"
+#include "bcomdef.h"
+#include "peripheral.h"
+#include "simple_peripheral.h"
+
+#include "host_rtos.h"
+#include "fake_stack.h"
+
+#ifdef CYC_TRACE
+#include "cyc_trace.h"
+#endif // CYC_TRACE
+
+#ifdef CS_PROF
+#include "cs_prof.h"
+#endif // CS_PROF
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Triggers of CPU time besides the trace events
+#define HOSTSIM_TRIG_STARTUP              FAKESTACK_EVT_COUNT
+#define HOSTSIM_TRIG_CLOCK                (FAKESTACK_EVT_COUNT + 1)
+#define HOSTSIM_TRIG_COUNT                (FAKESTACK_EVT_COUNT + 2)
+
+// Gap between two passes over the trace (ms)
+#define HOSTSIM_REPEAT_GAP                1000
+
+// Longest trace line
+#define HOSTSIM_LINE_LEN                  512
+
+// Critical sections listed by the CS_PROF report
+#define HOSTSIM_CS_WORST                  10
+
+// Largest heap trace report
+#define HOSTSIM_HEAP_REPORT_LEN           1024
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Trace event
+typedef struct
+{
+  UInt32 time;          // ms
+  fakeStackEvt_t evt;
+} hostSimEvt_t;
+
+// CPU time samples of a trigger, one for each time the CPU went busy
+typedef struct
+{
+  UInt64 *pNs;
+  UInt32 count;
+  UInt32 size;
+} hostSimSamples_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Stack image, as built by the stack project on the target
+const ICall_RemoteTaskEntry ICall_imgEntries[] = { FakeStack_entry };
+const Int ICall_imgTaskPriorities[] = { 5 };
+const SizeT ICall_imgTaskStackSizes[] = { 1024 };
+const void *ICall_imgInitParams[] = { NULL };
+const uint_least8_t ICall_numImages = 1;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static const char *trigNames[HOSTSIM_TRIG_COUNT] =
+{
+  "connect", "disconnect", "write", "read", "mtu", "conn_evt",
+  "param_update", "buffers", "radio", "burst", "l2cap", "startup", "clock"
+};
+
+static hostSimEvt_t *pTrace = NULL;
+static UInt32 traceLen = 0;
+static UInt32 repeats = 1;
+
+// Next event to inject, counting over all passes
+static UInt32 next = 0;
+
+// Application task, and how it was blocked until advertising started
+static Task_Handle appTask = NULL;
+static bool booted = false;
+static UInt32 bootAppBlocks;
+static UInt32 bootAppBlocked;
+
+static hostSimSamples_t samples[HOSTSIM_TRIG_COUNT];
+static UInt8 lastTrig = HOSTSIM_TRIG_STARTUP;
+static UInt64 lastCpuNs = 0;
+
+#ifdef CYC_TRACE
+// Output of the hot path trace
+static FILE *pCycTraceFile = NULL;
+#endif // CYC_TRACE
+
+#ifdef HEAPMGR_TRACE
+// Output of the heap trace report
+static FILE *pHeapReportFile = NULL;
+#endif // HEAPMGR_TRACE
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      hostSim_parseLine
+ *
+ * @brief   Parse a trace line, "time_ms event args".
+ *
+ * @param   pLine - line without comments
+ * @param   pEvt - event to fill
+ *
+ * @return  1 for an event, 0 for an empty line, -1 if malformed
+ */
+static int hostSim_parseLine(char *pLine, hostSimEvt_t *pEvt)
+{
+  char *tok[8];
+  int n = 0;
+  unsigned long arg[5] = { 0 };
+  int i;
+
+  for (tok[n] = strtok(pLine, " \t\r\n"); tok[n] != NULL && n < 7;
+       tok[++n] = strtok(NULL, " \t\r\n"));
+
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  if (n < 2)
+  {
+    return -1;
+  }
+
+  memset(pEvt, 0, sizeof(hostSimEvt_t));
+  pEvt->time = strtoul(tok[0], NULL, 0);
+
+  for (i = 0; i < FAKESTACK_EVT_COUNT; i++)
+  {
+    if (strcmp(tok[1], trigNames[i]) == 0)
+    {
+      break;
+    }
+  }
+
+  // Only radio takes no connection or count
+  if (i == FAKESTACK_EVT_COUNT || (n < 3 && i != FAKESTACK_EVT_RADIO))
+  {
+    return -1;
+  }
+
+  pEvt->evt.type = i;
+
+  // The hex value of a write is not a number
+  for (i = 2; i < n && i < 7; i++)
+  {
+    if (pEvt->evt.type != FAKESTACK_EVT_WRITE || i != 4)
+    {
+      arg[i - 2] = strtoul(tok[i], NULL, 0);
+    }
+  }
+
+  pEvt->evt.connHandle = arg[0];
+
+  switch (pEvt->evt.type)
+  {
+    case FAKESTACK_EVT_WRITE:
+      {
+        size_t len = (n > 4) ? strlen(tok[4]) : 0;
+
+        if (n != 5 || (len & 1) || len / 2 > FAKESTACK_MAX_VALUE)
+        {
+          return -1;
+        }
+
+        pEvt->evt.handle = arg[1];
+        pEvt->evt.len = len / 2;
+        for (i = 0; i < pEvt->evt.len; i++)
+        {
+          char byte[3] = { tok[4][2 * i], tok[4][2 * i + 1], 0 };
+
+          pEvt->evt.value[i] = strtoul(byte, NULL, 16);
+        }
+      }
+      break;
+
+    case FAKESTACK_EVT_READ:
+      if (n != 4)
+      {
+        return -1;
+      }
+      pEvt->evt.handle = arg[1];
+      break;
+
+    case FAKESTACK_EVT_MTU:
+      if (n != 4)
+      {
+        return -1;
+      }
+      pEvt->evt.param[0] = arg[1];
+      break;
+
+    case FAKESTACK_EVT_BUFFERS:
+    case FAKESTACK_EVT_RADIO:
+      if (n > 4)
+      {
+        return -1;
+      }
+      pEvt->evt.connHandle = 0;
+      pEvt->evt.param[0] = arg[0];
+      pEvt->evt.param[1] = arg[1];
+      break;
+
+    case FAKESTACK_EVT_BURST:
+      if (n != 5)
+      {
+        return -1;
+      }
+      pEvt->evt.handle = arg[1];
+      pEvt->evt.param[0] = arg[2];
+      break;
+
+    case FAKESTACK_EVT_L2CAP:
+      if (n != 4 && n != 7)
+      {
+        return -1;
+      }
+      pEvt->evt.handle = arg[1];
+      pEvt->evt.param[0] = arg[2];
+      pEvt->evt.param[1] = arg[3];
+      pEvt->evt.param[2] = arg[4];
+      break;
+
+    case FAKESTACK_EVT_PARAM_UPDATE:
+      if (n != 6)
+      {
+        return -1;
+      }
+      // Fall through
+
+    default:
+      pEvt->evt.param[0] = arg[1];
+      pEvt->evt.param[1] = arg[2];
+      pEvt->evt.param[2] = arg[3];
+      break;
+  }
+
+  return 1;
+}
+
+/*********************************************************************
+ * @fn      hostSim_loadTrace
+ *
+ * @brief   Read a trace file. Events must be in time order.
+ *
+ * @param   pFile - trace file name
+ *
+ * @return  TRUE if the trace was read, else FALSE
+ */
+static bool hostSim_loadTrace(const char *pFile)
+{
+  FILE *f = fopen(pFile, "r");
+  char line[HOSTSIM_LINE_LEN];
+  UInt32 lineNum = 0;
+  UInt32 size = 0;
+
+  if (f == NULL)
+  {
+    perror(pFile);
+
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), f) != NULL)
+  {
+    char *pComment = strchr(line, '#');
+    int ret;
+
+    lineNum++;
+    if (pComment != NULL)
+    {
+      *pComment = '\0';
+    }
+
+    if (traceLen == size)
+    {
+      size = (size != 0) ? size * 2 : 64;
+      pTrace = realloc(pTrace, size * sizeof(hostSimEvt_t));
+    }
+
+    ret = hostSim_parseLine(line, &pTrace[traceLen]);
+    if (ret < 0 ||
+        (ret > 0 && traceLen > 0 &&
+         pTrace[traceLen].time < pTrace[traceLen - 1].time))
+    {
+      fprintf(stderr, "%s:%u: bad event\n", pFile, lineNum);
+      fclose(f);
+
+      return false;
+    }
+
+    traceLen += ret;
+  }
+
+  fclose(f);
+
+  return true;
+}
+
+/*********************************************************************
+ * @fn      hostSim_charge
+ *
+ * @brief   Charge the CPU time used since the last idle to the trigger
+ *          of that busy period.
+ */
+static void hostSim_charge(void)
+{
+  UInt64 cpuNs = HostRtos_cpuNs();
+  hostSimSamples_t *pSamples = &samples[lastTrig];
+
+  if (pSamples->count == pSamples->size)
+  {
+    pSamples->size = (pSamples->size != 0) ? pSamples->size * 2 : 64;
+    pSamples->pNs = realloc(pSamples->pNs, pSamples->size * sizeof(UInt64));
+  }
+
+  pSamples->pNs[pSamples->count++] = cpuNs - lastCpuNs;
+  lastCpuNs = cpuNs;
+}
+
+/*********************************************************************
+ * @fn      hostSim_idle
+ *
+ * @brief   Idle hook. Runs whatever comes first of the next clock and the
+ *          next trace event.
+ */
+static Bool hostSim_idle(UInt32 nextDue, Bool due)
+{
+  UInt32 now = Clock_getTicks();
+  UInt32 tick;
+  hostSimEvt_t *pEvt;
+
+  hostSim_charge();
+
+  // Time only advances below, so the app has been blocked up to now
+  if (!booted && FakeStack_getAdvStart(&tick))
+  {
+    booted = true;
+    bootAppBlocks = HostRtos_taskBlocks(appTask);
+    bootAppBlocked = HostRtos_taskBlockedTicks(appTask);
+  }
+
+  if (next == traceLen * repeats)
+  {
+    return FALSE;
+  }
+
+  pEvt = &pTrace[next % traceLen];
+  tick = (pEvt->time + (next / traceLen) *
+          (pTrace[traceLen - 1].time + HOSTSIM_REPEAT_GAP)) *
+         (1000 / Clock_tickPeriod);
+
+  if ((Int32)(tick - now) < 0)
+  {
+    tick = now;
+  }
+
+  if (due && (Int32)(nextDue - tick) <= 0)
+  {
+    HostRtos_advance(nextDue);
+    lastTrig = HOSTSIM_TRIG_CLOCK;
+
+    return TRUE;
+  }
+
+  HostRtos_advance(tick);
+  FakeStack_inject(&pEvt->evt);
+  lastTrig = pEvt->evt.type;
+  next++;
+
+  return TRUE;
+}
+
+#ifdef CYC_TRACE
+/*********************************************************************
+ * @fn      hostSim_writeCycTrace
+ *
+ * @brief   CycTrace_drain() output to the -t file.
+ */
+static void hostSim_writeCycTrace(const uint8_t *pBuf, uint16_t len)
+{
+  fwrite(pBuf, 1, len, pCycTraceFile);
+}
+#endif // CYC_TRACE
+
+static int hostSim_cmpNs(const void *a, const void *b)
+{
+  UInt64 x = *(const UInt64 *)a;
+  UInt64 y = *(const UInt64 *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*********************************************************************
+ * @fn      hostSim_listAttrs
+ *
+ * @brief   Print the attribute handles assigned to registered services.
+ */
+static void hostSim_listAttrs(void)
+{
+  gattAttribute_t *pAttr;
+  uint16 handle;
+
+  printf("%-8s %-34s %s\n", "handle", "type", "permissions");
+  for (handle = FAKESTACK_FIRST_HANDLE;
+       (pAttr = FakeStack_getAttr(handle)) != NULL; handle++)
+  {
+    char type[33];
+    int i;
+
+    for (i = pAttr->type.len - 1; i >= 0; i--)
+    {
+      sprintf(&type[2 * (pAttr->type.len - 1 - i)], "%02x",
+              pAttr->type.uuid[i]);
+    }
+
+    printf("0x%04x   %-34s 0x%02x\n", handle, type, pAttr->permissions);
+  }
+}
+
+/*********************************************************************
+ * @fn      hostSim_report
+ *
+ * @brief   Print the CPU time of each trigger and task.
+ */
+static void hostSim_report(void)
+{
+  fakeStackStats_t stats;
+  Task_Handle task;
+  int i;
+
+  printf("%-14s %8s %10s %10s %10s %10s\n", "trigger", "count", "mean us",
+         "min us", "p99 us", "max us");
+  for (i = 0; i < HOSTSIM_TRIG_COUNT; i++)
+  {
+    hostSimSamples_t *pSamples = &samples[i];
+    UInt64 total = 0;
+    UInt32 j;
+
+    if (pSamples->count == 0)
+    {
+      continue;
+    }
+
+    qsort(pSamples->pNs, pSamples->count, sizeof(UInt64), hostSim_cmpNs);
+    for (j = 0; j < pSamples->count; j++)
+    {
+      total += pSamples->pNs[j];
+    }
+
+    // Nearest rank: the ceil(0.99 * count)-th smallest sample
+    printf("%-14s %8u %10.1f %10.1f %10.1f %10.1f\n", trigNames[i],
+           pSamples->count, total / 1000.0 / pSamples->count,
+           pSamples->pNs[0] / 1000.0,
+           pSamples->pNs[(pSamples->count * 99 + 99) / 100 - 1] / 1000.0,
+           pSamples->pNs[pSamples->count - 1] / 1000.0);
+  }
+
+  printf("\n%-14s %10s\n", "thread", "cpu ms");
+  for (task = HostRtos_nextTask(NULL); task != NULL;
+       task = HostRtos_nextTask(task))
+  {
+    printf("%-14s %10.3f\n", task->name, HostRtos_taskCpuNs(task) / 1e6);
+  }
+  printf("%-14s %10.3f\n", "swi", HostRtos_swiCpuNs() / 1e6);
+
+  FakeStack_getStats(&stats);
+  if (booted)
+  {
+    UInt32 advStart;
+
+    FakeStack_getAdvStart(&advStart);
+    printf("\nboot: advertising at %.3f ms, app task blocked %u times for "
+           "%.3f ms\n", advStart * (double)Clock_tickPeriod / 1e3,
+           bootAppBlocks, bootAppBlocked * (double)Clock_tickPeriod / 1e3);
+  }
+  if (SimpleBLEPeripheral_getEvtPoolMisses() != 0)
+  {
+    printf("\napp events: %u allocated from the heap, the pool was empty\n",
+           SimpleBLEPeripheral_getEvtPoolMisses());
+  }
+  if (stats.pendingRsps != 0)
+  {
+    uint16_t hist[SBP_ATT_RSP_HIST_SIZE];
+    uint16_t dropped = SimpleBLEPeripheral_getAttRspStats(hist);
+
+    printf("\natt rsp: %u pending, %u buffer refusals, sent after tries",
+           (unsigned)stats.pendingRsps, (unsigned)stats.bufFull);
+    for (i = 0; i < SBP_ATT_RSP_HIST_SIZE; i++)
+    {
+      if (i < 2)
+      {
+        printf("%s %d: %u", (i != 0) ? "," : "", i + 1, hist[i]);
+      }
+      else
+      {
+        printf(", %d-%d: %u", (1 << (i - 1)) + 1, 1 << i, hist[i]);
+      }
+    }
+    printf("\natt rsp: %u dropped by the app, %u never sent, %u past the "
+           "ATT timeout, longest wait %.3f ms\n", dropped,
+           (unsigned)stats.lostRsps, (unsigned)stats.lateRsps,
+           stats.rspWaitMax * (double)Clock_tickPeriod / 1e3);
+  }
+
+  if (stats.radioEvts != 0)
+  {
+    double simSecs = Clock_getTicks() * (double)Clock_tickPeriod / 1e6;
+
+    printf("\nradio: %u events, %u skipped by slave latency, on %.3f ms "
+           "(%.3f %%), %u ATT bytes, %.1f bytes per radio ms\n",
+           (unsigned)stats.radioEvts, (unsigned)stats.radioSkipped,
+           stats.radioOnUs / 1e3, stats.radioOnUs / 1e4 / simSecs,
+           (unsigned)stats.attBytes,
+           stats.attBytes * 1e3 / stats.radioOnUs);
+    if (stats.bursts != 0)
+    {
+      double burstSecs = stats.burstTicks * (double)Clock_tickPeriod / 1e6;
+
+      printf("bursts: %u done of %u reads, %.1f ms each, %.1f bytes/s "
+             "while bursting\n", (unsigned)stats.bursts,
+             (unsigned)stats.burstReads, burstSecs * 1e3 / stats.bursts,
+             stats.burstBytes / burstSecs);
+    }
+    if (stats.cocEvts != 0)
+    {
+      double cocSecs = stats.cocTicks * (double)Clock_tickPeriod / 1e6;
+
+      printf("l2cap: %u SDUs of %u bytes sent, %u of %u bytes back in "
+             "%.3f s, %.1f bytes/s out, %.1f bytes/s in\n",
+             (unsigned)stats.cocSdus, (unsigned)stats.cocBytes,
+             (unsigned)stats.cocRxSdus, (unsigned)stats.cocRxBytes, cocSecs,
+             stats.cocBytes / cocSecs, stats.cocRxBytes / cocSecs);
+      printf("l2cap: %.2f of %.2f PDUs per event sent, %u credit packets "
+             "sent, %u received, %u stalls on credits, %u of the peer\n",
+             (double)stats.cocPdus / stats.cocEvts,
+             (double)stats.cocSlots / stats.cocEvts,
+             (unsigned)stats.cocCredits, (unsigned)stats.cocCreditsIn,
+             (unsigned)stats.cocStalls, (unsigned)stats.cocPeerStalls);
+    }
+  }
+
+  printf("\nsimulated %.3f s, %u task switches\n",
+         Clock_getTicks() * (double)Clock_tickPeriod / 1e6,
+         HostRtos_switches());
+  printf("stack: %u commands, %u events, %u notifications, %u responses, "
+         "%u ATT errors\n", (unsigned)stats.cmds, (unsigned)stats.events,
+         (unsigned)stats.notifications, (unsigned)stats.rsps,
+         (unsigned)stats.attErrors);
+}
+
+#ifdef CS_PROF
+static int hostSim_cmpCsMax(const void *a, const void *b)
+{
+  const csProfSite_t *x = (const csProfSite_t *)a;
+  const csProfSite_t *y = (const csProfSite_t *)b;
+
+  return (x->maxTicks < y->maxTicks) - (x->maxTicks > y->maxTicks);
+}
+
+/*********************************************************************
+ * @fn      hostSim_reportCs
+ *
+ * @brief   Print the critical sections with the longest masked time.
+ */
+static void hostSim_reportCs(void)
+{
+  csProfSite_t sites[CS_PROF_MAX_SITES];
+  double usPerTick = 1e6 / CsProf_getTickHz();
+  uint8_t num = CsProf_getNumSites();
+  uint8_t i;
+
+  for (i = 0; i < num; i++)
+  {
+    CsProf_getSite(i, &sites[i]);
+  }
+  qsort(sites, num, sizeof(csProfSite_t), hostSim_cmpCsMax);
+
+  printf("\n%-44s %8s %10s %10s %6s\n", "critical section", "count",
+         "mean us", "max us", "over");
+  for (i = 0; i < num && i < HOSTSIM_CS_WORST; i++)
+  {
+    char site[64];
+
+    if (sites[i].pFile != NULL)
+    {
+      const char *pName = strrchr(sites[i].pFile, '/');
+
+      snprintf(site, sizeof(site), "%s:%u",
+               pName ? pName + 1 : sites[i].pFile, sites[i].line);
+    }
+    else
+    {
+      strcpy(site, "(other sites)");
+    }
+
+    printf("%-44s %8u %10.3f %10.3f %6u\n", site, (unsigned)sites[i].count,
+           sites[i].totalTicks * usPerTick / sites[i].count,
+           sites[i].maxTicks * usPerTick, sites[i].overBudget);
+  }
+  printf("%u sections over the %u us budget\n",
+         (unsigned)CsProf_getOverBudget(), CS_PROF_BUDGET_US);
+}
+#endif // CS_PROF
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+int main(int argc, char *argv[])
+{
+  bool listAttrs = false;
+  Task_Handle task;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "vln:c:t:m:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'v':
+        HostDisplay_enable(true);
+        break;
+
+      case 'l':
+        listAttrs = true;
+        break;
+
+      case 'n':
+        repeats = strtoul(optarg, NULL, 0);
+        break;
+
+      case 'c':
+        FakeStack_setCmdDelay(strtod(optarg, NULL) * 1000 / Clock_tickPeriod);
+        break;
+
+#ifdef CYC_TRACE
+      case 't':
+        pCycTraceFile = fopen(optarg, "wb");
+        if (pCycTraceFile == NULL)
+        {
+          perror(optarg);
+
+          return 1;
+        }
+        break;
+#endif // CYC_TRACE
+
+#ifdef HEAPMGR_TRACE
+      case 'm':
+        pHeapReportFile = fopen(optarg, "wb");
+        if (pHeapReportFile == NULL)
+        {
+          perror(optarg);
+
+          return 1;
+        }
+        break;
+#endif // HEAPMGR_TRACE
+
+      default:
+        optind = argc;
+        break;
+    }
+  }
+
+  if (optind != argc - 1 || repeats == 0)
+  {
+    fprintf(stderr,
+            "usage: %s [-v] [-l] [-n repeats] [-c ms] [-t out] [-m out] "
+            "trace\n",
+            argv[0]);
+
+    return 2;
+  }
+
+  if (!hostSim_loadTrace(argv[optind]))
+  {
+    return 1;
+  }
+
+  if (traceLen == 0)
+  {
+    repeats = 0;
+  }
+
+#ifdef CYC_TRACE
+  if (pCycTraceFile != NULL)
+  {
+    CycTrace_init();
+  }
+#endif // CYC_TRACE
+
+#ifdef CS_PROF
+  CsProf_init();
+#endif // CS_PROF
+
+  /* Initialize ICall module */
+  ICall_init();
+
+  /* Start tasks of external images - Priority 5 */
+  ICall_createRemoteTasks();
+
+  /* Kick off profile - Priority 3 */
+  GAPRole_createTask();
+
+  SimpleBLEPeripheral_createTask();
+
+  task = HostRtos_nextTask(NULL);
+  HostRtos_setTaskName(task, "stack");
+  task = HostRtos_nextTask(task);
+  HostRtos_setTaskName(task, "gaprole");
+  appTask = HostRtos_nextTask(task);
+  HostRtos_setTaskName(appTask, "app");
+
+  HostRtos_setIdleHook(hostSim_idle);
+
+  BIOS_start();
+
+#ifdef CYC_TRACE
+  if (pCycTraceFile != NULL)
+  {
+    printf("hot path trace: %u records\n",
+           CycTrace_drain(hostSim_writeCycTrace));
+    fclose(pCycTraceFile);
+  }
+#endif // CYC_TRACE
+
+#ifdef HEAPMGR_TRACE
+  if (pHeapReportFile != NULL)
+  {
+    static uint8_t report[HOSTSIM_HEAP_REPORT_LEN];
+    uint16_t len = ICall_heapTraceReport(report, sizeof(report));
+
+    printf("heap trace report: %u bytes\n", len);
+    fwrite(report, 1, len, pHeapReportFile);
+    fclose(pHeapReportFile);
+  }
+#endif // HEAPMGR_TRACE
+
+  if (listAttrs)
+  {
+    hostSim_listAttrs();
+    printf("\n");
+  }
+
+  hostSim_report();
+
+#ifdef CS_PROF
+  hostSim_reportCs();
+#endif // CS_PROF
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+
+ @file  trng.h
+
+ @brief This file contains the TRNG definitions of the host simulation
+        port. The functions are implemented by the simulated TRNG of
+        the program that builds the driver.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef DRIVERLIB_TRNG_H
+#define DRIVERLIB_TRNG_H
+
+#include <stdint.h>
+
+#define TRNG_NUMBER_READY         0x00000001
+#define TRNG_FRO_SHUTDOWN         0x00000002
+
+#define TRNG_HI_WORD              0x00000001
+#define TRNG_LOW_WORD             0x00000002
+
+extern void TRNGConfigure(uint32_t ui32MinSamplesPerCycle,
+                          uint32_t ui32MaxSamplesPerCycle,
+                          uint32_t ui32ClocksPerSample);
+extern void TRNGEnable(void);
+extern void TRNGDisable(void);
+extern uint32_t TRNGNumberGet(uint32_t ui32Word);
+extern uint32_t TRNGStatusGet(void);
+extern void TRNGIntEnable(uint32_t ui32IntFlags);
+extern void TRNGIntDisable(uint32_t ui32IntFlags);
+
+#endif /* DRIVERLIB_TRNG_H */
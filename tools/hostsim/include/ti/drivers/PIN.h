@@ -0,0 +1,109 @@
+/******************************************************************************
+
+ @file  PIN.h
+
+ @brief This file contains the PIN driver of the host simulation port.
+        Pins are not simulated; outputs are accepted and ignored.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_DRIVERS_PIN_H
+#define TI_DRIVERS_PIN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+typedef uint32_t PIN_Config;
+typedef uint8_t PIN_Id;
+typedef uint32_t PIN_Status;
+
+typedef struct
+{
+  uint32_t bmPort;
+} PIN_State;
+
+typedef PIN_State *PIN_Handle;
+
+#define PIN_TERMINATE             0xFE
+#define PIN_UNASSIGNED            0xFF
+#define PIN_SUCCESS               0
+
+#define PIN_ID(x)                 ((x) & 0xFF)
+
+#define PIN_GEN                   (((uint32_t)1) << 31)
+#define PIN_INPUT_EN              (PIN_GEN | (0 << 29))
+#define PIN_INPUT_DIS             (PIN_GEN | (1 << 29))
+#define PIN_HYSTERESIS            (PIN_GEN | (1 << 30))
+#define PIN_NOPULL                (PIN_GEN | (0 << 13))
+#define PIN_PULLUP                (PIN_GEN | (1 << 13))
+#define PIN_PULLDOWN              (PIN_GEN | (2 << 13))
+#define PIN_IRQ_DIS               (PIN_GEN | (0 << 16))
+#define PIN_IRQ_NEGEDGE           (PIN_GEN | (2 << 16))
+#define PIN_IRQ_POSEDGE           (PIN_GEN | (3 << 16))
+#define PIN_IRQ_BOTHEDGES         (PIN_GEN | (4 << 16))
+#define PIN_GPIO_OUTPUT_DIS       (PIN_GEN | (0 << 1))
+#define PIN_GPIO_OUTPUT_EN        (PIN_GEN | (1 << 1))
+#define PIN_GPIO_LOW              (PIN_GEN | (0 << 22))
+#define PIN_GPIO_HIGH             (PIN_GEN | (1 << 22))
+#define PIN_PUSHPULL              (PIN_GEN | (0 << 25))
+#define PIN_OPENDRAIN             (PIN_GEN | (2 << 25))
+#define PIN_OPENSOURCE            (PIN_GEN | (3 << 25))
+#define PIN_SLEWCTRL              (PIN_GEN | (1 << 12))
+#define PIN_DRVSTR_MIN            (PIN_GEN | (0x1 << 8))
+#define PIN_DRVSTR_MED            (PIN_GEN | (0x4 << 8))
+#define PIN_DRVSTR_MAX            (PIN_GEN | (0x8 << 8))
+
+extern PIN_Status PIN_init(const PIN_Config aPinCfg[]);
+extern PIN_Handle PIN_open(PIN_State *state, const PIN_Config pinList[]);
+extern void PIN_close(PIN_Handle handle);
+extern PIN_Status PIN_setOutputValue(PIN_Handle handle, PIN_Id pinId,
+                                     uint32_t val);
+extern uint32_t PIN_getInputValue(PIN_Id pinId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_DRIVERS_PIN_H */
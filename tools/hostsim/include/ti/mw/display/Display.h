@@ -0,0 +1,107 @@
+/******************************************************************************
+
+ @file  Display.h
+
+ @brief This file contains the Display driver of the host simulation
+        port. Lines are printed to stdout when enabled with
+        HostDisplay_enable().
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_MW_DISPLAY_DISPLAY_H
+#define TI_MW_DISPLAY_DISPLAY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define Display_Type_LCD          0x0001
+#define Display_Type_UART         0x0002
+#define Display_Type_ANY          0xFFFF
+
+typedef struct
+{
+  unsigned int type;
+} Display_Config;
+
+typedef Display_Config *Display_Handle;
+
+typedef struct
+{
+  int lineClearMode;
+} Display_Params;
+
+extern void Display_Params_init(Display_Params *params);
+extern Display_Handle Display_open(unsigned int id, Display_Params *params);
+extern void Display_close(Display_Handle handle);
+extern void Display_clear(Display_Handle handle);
+extern void Display_clearLines(Display_Handle handle, uint8_t fromLine,
+                               uint8_t toLine);
+extern void Display_doPrintf(Display_Handle handle, uint8_t line,
+                             uint8_t column, const char *fmt, ...);
+
+#define Display_clearLine(handle, n)   Display_clearLines(handle, n, 0)
+
+#define Display_print0(handle, line, col, fmt) \
+  Display_doPrintf(handle, line, col, fmt)
+#define Display_print1(handle, line, col, fmt, a0) \
+  Display_doPrintf(handle, line, col, fmt, a0)
+#define Display_print2(handle, line, col, fmt, a0, a1) \
+  Display_doPrintf(handle, line, col, fmt, a0, a1)
+#define Display_print3(handle, line, col, fmt, a0, a1, a2) \
+  Display_doPrintf(handle, line, col, fmt, a0, a1, a2)
+#define Display_print4(handle, line, col, fmt, a0, a1, a2, a3) \
+  Display_doPrintf(handle, line, col, fmt, a0, a1, a2, a3)
+#define Display_print5(handle, line, col, fmt, a0, a1, a2, a3, a4) \
+  Display_doPrintf(handle, line, col, fmt, a0, a1, a2, a3, a4)
+
+// Host only: print displayed lines to stdout
+extern void HostDisplay_enable(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_MW_DISPLAY_DISPLAY_H */
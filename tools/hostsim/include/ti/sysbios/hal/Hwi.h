@@ -0,0 +1,102 @@
+/******************************************************************************
+
+ @file  Hwi.h
+
+ @brief This file contains the Hwi module of the host simulation port.
+        Interrupts are simulated by the idle hook, which only runs
+        while every task is blocked, so disabling them only has to
+        nest correctly.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_HAL_HWI_H
+#define TI_SYSBIOS_HAL_HWI_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef Void (*Hwi_FuncPtr)(UArg arg);
+
+typedef struct
+{
+  UArg arg;
+  Int priority;
+  Bool enableInt;
+} Hwi_Params;
+
+typedef struct Hwi_Object
+{
+  struct Hwi_Object *link;    // next Hwi created
+  Int intNum;
+  Hwi_FuncPtr fxn;
+  UArg arg;
+  Bool enabled;
+} Hwi_Object;
+
+typedef Hwi_Object Hwi_Struct;
+typedef Hwi_Object *Hwi_Handle;
+
+#define Hwi_handle(s)     ((Hwi_Handle)(s))
+
+extern Void Hwi_Params_init(Hwi_Params *params);
+extern Hwi_Handle Hwi_create(Int intNum, Hwi_FuncPtr fxn,
+                             const Hwi_Params *params, Error_Block *eb);
+extern Void Hwi_construct(Hwi_Struct *obj, Int intNum, Hwi_FuncPtr fxn,
+                          const Hwi_Params *params, Error_Block *eb);
+extern UInt Hwi_disable(Void);
+extern UInt Hwi_enable(Void);
+extern Void Hwi_restore(UInt key);
+extern UInt Hwi_disableInterrupt(UInt intNum);
+extern UInt Hwi_enableInterrupt(UInt intNum);
+extern Void Hwi_restoreInterrupt(UInt intNum, UInt key);
+extern Void Hwi_clearInterrupt(UInt intNum);
+extern Void Hwi_post(UInt intNum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_HAL_HWI_H */
@@ -0,0 +1,108 @@
+/******************************************************************************
+
+ @file  Clock.h
+
+ @brief This file contains the Clock module of the host simulation
+        port. Clock ticks are simulated and only advance while every
+        task is blocked.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_CLOCK_H
+#define TI_SYSBIOS_KNL_CLOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef Void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct
+{
+  Bool startFlag;
+  UInt32 period;
+  UArg arg;
+} Clock_Params;
+
+typedef struct Clock_Object
+{
+  struct Clock_Object *link;  // next clock created
+  Clock_FuncPtr fxn;
+  UArg arg;
+  UInt32 timeout;
+  UInt32 period;
+  UInt32 due;                 // tick the clock expires at, while active
+  Bool active;
+} Clock_Object;
+
+typedef Clock_Object Clock_Struct;
+typedef Clock_Object *Clock_Handle;
+
+#define Clock_handle(s)   ((Clock_Handle)(s))
+
+// Tick period in microseconds
+extern const UInt32 Clock_tickPeriod;
+
+extern Void Clock_Params_init(Clock_Params *params);
+extern Clock_Handle Clock_create(Clock_FuncPtr fxn, UInt timeout,
+                                 const Clock_Params *params, Error_Block *eb);
+extern Void Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn,
+                            UInt timeout, const Clock_Params *params);
+extern Void Clock_destruct(Clock_Struct *obj);
+extern Void Clock_delete(Clock_Handle *handle);
+extern Void Clock_start(Clock_Handle handle);
+extern Void Clock_stop(Clock_Handle handle);
+extern Bool Clock_isActive(Clock_Handle handle);
+extern Void Clock_setTimeout(Clock_Handle handle, UInt32 timeout);
+extern UInt32 Clock_getTimeout(Clock_Handle handle);
+extern Void Clock_setPeriod(Clock_Handle handle, UInt32 period);
+extern Void Clock_setFunc(Clock_Handle handle, Clock_FuncPtr fxn, UArg arg);
+extern UInt32 Clock_getTicks(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_KNL_CLOCK_H */
@@ -0,0 +1,120 @@
+/******************************************************************************
+
+ @file  Event.h
+
+ @brief This file contains the Event module of the host simulation
+        port.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_EVENT_H
+#define TI_SYSBIOS_KNL_EVENT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+#define Event_Id_NONE     0
+#define Event_Id_00       ((UInt)1 << 0)
+#define Event_Id_01       ((UInt)1 << 1)
+#define Event_Id_02       ((UInt)1 << 2)
+#define Event_Id_03       ((UInt)1 << 3)
+#define Event_Id_04       ((UInt)1 << 4)
+#define Event_Id_05       ((UInt)1 << 5)
+#define Event_Id_06       ((UInt)1 << 6)
+#define Event_Id_07       ((UInt)1 << 7)
+#define Event_Id_08       ((UInt)1 << 8)
+#define Event_Id_09       ((UInt)1 << 9)
+#define Event_Id_10       ((UInt)1 << 10)
+#define Event_Id_11       ((UInt)1 << 11)
+#define Event_Id_12       ((UInt)1 << 12)
+#define Event_Id_13       ((UInt)1 << 13)
+#define Event_Id_14       ((UInt)1 << 14)
+#define Event_Id_15       ((UInt)1 << 15)
+#define Event_Id_16       ((UInt)1 << 16)
+#define Event_Id_17       ((UInt)1 << 17)
+#define Event_Id_18       ((UInt)1 << 18)
+#define Event_Id_19       ((UInt)1 << 19)
+#define Event_Id_20       ((UInt)1 << 20)
+#define Event_Id_21       ((UInt)1 << 21)
+#define Event_Id_22       ((UInt)1 << 22)
+#define Event_Id_23       ((UInt)1 << 23)
+#define Event_Id_24       ((UInt)1 << 24)
+#define Event_Id_25       ((UInt)1 << 25)
+#define Event_Id_26       ((UInt)1 << 26)
+#define Event_Id_27       ((UInt)1 << 27)
+#define Event_Id_28       ((UInt)1 << 28)
+#define Event_Id_29       ((UInt)1 << 29)
+#define Event_Id_30       ((UInt)1 << 30)
+#define Event_Id_31       ((UInt)1 << 31)
+
+typedef struct
+{
+  Int dummy;
+} Event_Params;
+
+typedef struct Event_Object
+{
+  UInt posted;
+} Event_Object;
+
+typedef Event_Object Event_Struct;
+typedef Event_Object *Event_Handle;
+
+#define Event_handle(s)   ((Event_Handle)(s))
+
+extern Void Event_Params_init(Event_Params *params);
+extern Event_Handle Event_create(const Event_Params *params, Error_Block *eb);
+extern Void Event_construct(Event_Struct *obj, const Event_Params *params);
+extern UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask,
+                       UInt32 timeout);
+extern Void Event_post(Event_Handle handle, UInt eventMask);
+extern UInt Event_getPostedEvents(Event_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_KNL_EVENT_H */
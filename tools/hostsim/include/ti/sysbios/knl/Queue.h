@@ -0,0 +1,102 @@
+/******************************************************************************
+
+ @file  Queue.h
+
+ @brief This file contains the Queue module of the host simulation
+        port.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_QUEUE_H
+#define TI_SYSBIOS_KNL_QUEUE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef struct Queue_Elem
+{
+  struct Queue_Elem *next;
+  struct Queue_Elem *prev;
+} Queue_Elem;
+
+typedef struct
+{
+  Int dummy;
+} Queue_Params;
+
+// An empty queue is an element linked to itself
+typedef struct Queue_Object
+{
+  Queue_Elem elem;
+} Queue_Object;
+
+typedef Queue_Object Queue_Struct;
+typedef Queue_Object *Queue_Handle;
+
+#define Queue_handle(s)   ((Queue_Handle)(s))
+
+extern Void Queue_Params_init(Queue_Params *params);
+extern Queue_Handle Queue_create(const Queue_Params *params, Error_Block *eb);
+extern Void Queue_construct(Queue_Struct *obj, const Queue_Params *params);
+extern Bool Queue_empty(Queue_Handle handle);
+extern Ptr Queue_get(Queue_Handle handle);
+extern Void Queue_put(Queue_Handle handle, Queue_Elem *elem);
+extern Ptr Queue_getTail(Queue_Handle handle);
+extern Void Queue_putHead(Queue_Handle handle, Queue_Elem *elem);
+extern Ptr Queue_dequeue(Queue_Handle handle);
+extern Void Queue_enqueue(Queue_Handle handle, Queue_Elem *elem);
+extern Ptr Queue_head(Queue_Handle handle);
+extern Ptr Queue_next(Ptr qelem);
+extern Ptr Queue_prev(Ptr qelem);
+extern Void Queue_insert(Queue_Elem *qelem, Queue_Elem *elem);
+extern Void Queue_remove(Queue_Elem *qelem);
+extern Void Queue_elemClear(Queue_Elem *qelem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_KNL_QUEUE_H */
@@ -0,0 +1,99 @@
+/******************************************************************************
+
+ @file  Semaphore.h
+
+ @brief This file contains the Semaphore module of the host simulation
+        port.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_SEMAPHORE_H
+#define TI_SYSBIOS_KNL_SEMAPHORE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef enum
+{
+  Semaphore_Mode_COUNTING,
+  Semaphore_Mode_BINARY,
+  Semaphore_Mode_COUNTING_PRIORITY,
+  Semaphore_Mode_BINARY_PRIORITY
+} Semaphore_Mode;
+
+typedef struct
+{
+  Ptr event;
+  UInt eventId;
+  Semaphore_Mode mode;
+} Semaphore_Params;
+
+typedef struct Semaphore_Object
+{
+  Int count;
+  Semaphore_Mode mode;
+} Semaphore_Object;
+
+typedef Semaphore_Object Semaphore_Struct;
+typedef Semaphore_Object *Semaphore_Handle;
+
+#define Semaphore_handle(s) ((Semaphore_Handle)(s))
+
+extern Void Semaphore_Params_init(Semaphore_Params *params);
+extern Semaphore_Handle Semaphore_create(Int count,
+                                         const Semaphore_Params *params,
+                                         Error_Block *eb);
+extern Void Semaphore_construct(Semaphore_Struct *obj, Int count,
+                                const Semaphore_Params *params);
+extern Bool Semaphore_pend(Semaphore_Handle handle, UInt32 timeout);
+extern Void Semaphore_post(Semaphore_Handle handle);
+extern Int Semaphore_getCount(Semaphore_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_KNL_SEMAPHORE_H */
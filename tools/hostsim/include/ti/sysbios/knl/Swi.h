@@ -0,0 +1,99 @@
+/******************************************************************************
+
+ @file  Swi.h
+
+ @brief This file contains the Swi module of the host simulation port.
+        Posted Swis run before any task, at the next point the
+        simulated CPU is rescheduled.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_SWI_H
+#define TI_SYSBIOS_KNL_SWI_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef Void (*Swi_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef struct
+{
+  UArg arg0;
+  UArg arg1;
+  UInt priority;
+  UInt trigger;
+} Swi_Params;
+
+typedef struct Swi_Object
+{
+  struct Swi_Object *link;    // next posted Swi
+  Swi_FuncPtr fxn;
+  UArg arg0;
+  UArg arg1;
+  UInt priority;
+  Bool posted;
+} Swi_Object;
+
+typedef Swi_Object Swi_Struct;
+typedef Swi_Object *Swi_Handle;
+
+#define Swi_handle(s)     ((Swi_Handle)(s))
+
+extern Void Swi_Params_init(Swi_Params *params);
+extern Swi_Handle Swi_create(Swi_FuncPtr fxn, const Swi_Params *params,
+                             Error_Block *eb);
+extern Void Swi_construct(Swi_Struct *obj, Swi_FuncPtr fxn,
+                          const Swi_Params *params, Error_Block *eb);
+extern Void Swi_post(Swi_Handle handle);
+extern UInt Swi_disable(Void);
+extern Void Swi_restore(UInt key);
+extern Void Swi_enable(Void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_KNL_SWI_H */
@@ -0,0 +1,137 @@
+/******************************************************************************
+
+ @file  Task.h
+
+ @brief This file contains the Task module of the host simulation
+        port. Each task runs on its own POSIX thread, but only the
+        highest priority ready task holds the simulated CPU.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef TI_SYSBIOS_KNL_TASK_H
+#define TI_SYSBIOS_KNL_TASK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <pthread.h>
+#include <time.h>
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+
+typedef Void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+typedef enum
+{
+  Task_Mode_RUNNING,
+  Task_Mode_READY,
+  Task_Mode_BLOCKED,
+  Task_Mode_TERMINATED,
+  Task_Mode_INACTIVE
+} Task_Mode;
+
+typedef struct
+{
+  UArg arg0;
+  UArg arg1;
+  Int priority;
+  Ptr stack;
+  SizeT stackSize;
+  Ptr env;
+} Task_Params;
+
+typedef struct Task_Object
+{
+  struct Task_Object *link;   // next task created
+  Task_FuncPtr fxn;
+  UArg arg0;
+  UArg arg1;
+  Int priority;
+  Ptr env;
+  String name;                // host only, see HostRtos_setTaskName()
+  Task_Mode mode;
+  UInt32 seq;                 // orders ready or pending tasks of a priority
+  Ptr pendObj;                // object the task is blocked on
+  UInt andMask;               // Event_pend() masks, and matched events
+  UInt orMask;
+  UInt events;
+  UInt32 timeout;             // tick a timed pend expires at
+  Bool timed;
+  Bool timedOut;
+  pthread_t thread;
+  pthread_cond_t cond;
+  struct timespec sliceStart; // thread CPU time when last resumed
+  UInt64 cpuNs;               // thread CPU time spent holding the CPU
+  UInt32 blocks;              // pends and sleeps that blocked
+  UInt32 blockStart;          // tick the task last blocked at
+  UInt32 blockedTicks;        // ticks spent blocked, but the current pend
+} Task_Object;
+
+typedef Task_Object Task_Struct;
+typedef Task_Object *Task_Handle;
+
+#define Task_handle(s)    ((Task_Handle)(s))
+#define Task_struct(h)    ((Task_Struct *)(h))
+
+extern Void Task_Params_init(Task_Params *params);
+extern Task_Handle Task_create(Task_FuncPtr fxn, const Task_Params *params,
+                               Error_Block *eb);
+extern Void Task_construct(Task_Struct *obj, Task_FuncPtr fxn,
+                           const Task_Params *params, Error_Block *eb);
+extern Task_Handle Task_self(Void);
+extern UInt Task_disable(Void);
+extern Void Task_restore(UInt key);
+extern Void Task_enable(Void);
+extern Void Task_yield(Void);
+extern Void Task_sleep(UInt32 nticks);
+extern Int Task_getPri(Task_Handle handle);
+extern UInt Task_setPri(Task_Handle handle, Int newpri);
+extern Ptr Task_getEnv(Task_Handle handle);
+extern Void Task_setEnv(Task_Handle handle, Ptr env);
+extern Task_Mode Task_getMode(Task_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TI_SYSBIOS_KNL_TASK_H */
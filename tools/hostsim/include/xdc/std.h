@@ -0,0 +1,88 @@
+/******************************************************************************
+
+ @file  std.h
+
+ @brief This file contains the XDC base types for the host simulation
+        port. The types follow the TI-RTOS definitions, with UArg wide
+        enough to hold a pointer on the host.
+
+ Group: WCS, BTS
+ Target Device: CC2650, CC2640, CC1350
+
+ ******************************************************************************
+
+ Copyright (c) 2016, Texas Instruments Incorporated
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions
+ are met:
+
+ *  Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+ *  Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+
+ *  Neither the name of Texas Instruments Incorporated nor the names of
+    its contributors may be used to endorse or promote products derived
+    from this software without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ******************************************************************************
+ Release Name: ble_sdk_2_02_01_18
+ Release Date: 2016-10-26 15:20:04
+ *****************************************************************************/
+
+#ifndef XDC_STD_H
+#define XDC_STD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef char              Char;
+typedef unsigned char     UChar;
+typedef short             Short;
+typedef unsigned short    UShort;
+typedef int               Int;
+typedef unsigned int      UInt;
+typedef long              Long;
+typedef unsigned long     ULong;
+typedef int8_t            Int8;
+typedef uint8_t           UInt8;
+typedef int16_t           Int16;
+typedef uint16_t          UInt16;
+typedef int32_t           Int32;
+typedef uint32_t          UInt32;
+typedef int64_t           Int64;
+typedef uint64_t          UInt64;
+typedef size_t            SizeT;
+typedef uintptr_t         UArg;
+typedef int               Bool;
+typedef void              Void;
+typedef void             *Ptr;
+typedef const char       *String;
+typedef int               Bits32;
+
+#ifndef TRUE
+#define TRUE              1
+#endif
+
+#ifndef FALSE
+#define FALSE             0
+#endif
+
+#endif /* XDC_STD_H */
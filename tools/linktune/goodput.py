@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Models notification goodput for negotiated ATT MTU and LL data lengths.
+
+For each ATT MTU and maximum LL payload (txOctets) pair, the peripheral
+sends notifications back to back on the 1M PHY. Each LL data packet is
+answered by an empty packet from the central, 150 us apart. Packets are
+sent while they fit in the connection interval, up to --pdus per event.
+
+Two notification sizes are compared:
+  tuned - LinkTune_payloadLen() (link_tune.c): MTU - 3, or the longest
+          value whose L2CAP frame fills whole LL packets if the partly
+          filled last packet costs more air time per byte
+  full  - MTU - 3
+
+LinkTune_payloadLen() only compares per packet air time. With no --pdus
+limit, the short last packet of "full" may fit in the time left at the end
+of an event, so "full" can win, e.g. --mtu 185 --octets 185 at 7.5 ms.
+With a limit, as set by the controller's MAX_NUM_PDU, "tuned" wins.
+
+Usage: goodput.py [--interval ms] [--mtu 23,65,...] [--octets 27,251,...]
+                  [--pdus n] [--encrypted]
+"""
+
+import argparse
+import sys
+
+L2CAP_HDR_SIZE = 4
+NOTI_HDR_SIZE = 3
+T_IFS = 150  # us
+PHY_US_PER_BYTE = 8  # 1M PHY
+
+# Preamble, access address, header and CRC; the MIC adds 4 when encrypted
+LL_OVERHEAD = 10
+LL_MIC_SIZE = 4
+
+
+# LINK_TUNE_PKT_OVERHEAD: packet overhead, empty packet and two T_IFS in
+# byte times
+PKT_OVERHEAD = 62
+
+
+def air_time(frame, tx_octets):
+    return frame + -(-frame // tx_octets) * PKT_OVERHEAD
+
+
+def payload_len(mtu, tx_octets):
+    """Same as LinkTune_payloadLen()."""
+    full = mtu + L2CAP_HDR_SIZE
+    hdr = L2CAP_HDR_SIZE + NOTI_HDR_SIZE
+    if tx_octets == 0 or full % tx_octets == 0 or full < tx_octets:
+        return mtu - NOTI_HDR_SIZE
+    whole = full - full % tx_octets
+    if ((whole - hdr) * air_time(full, tx_octets) >
+            (full - hdr) * air_time(whole, tx_octets)):
+        return whole - hdr
+    return mtu - NOTI_HDR_SIZE
+
+
+def packets(value_len, tx_octets):
+    """LL payload lengths of one notification."""
+    left = value_len + NOTI_HDR_SIZE + L2CAP_HDR_SIZE
+    out = []
+    while left > 0:
+        out.append(min(left, tx_octets))
+        left -= out[-1]
+    return out
+
+
+def goodput(value_len, tx_octets, interval_us, pdus, encrypted):
+    """Notification value bytes per second."""
+    overhead = LL_OVERHEAD + (LL_MIC_SIZE if encrypted else 0)
+    empty_us = overhead * PHY_US_PER_BYTE
+    pkts = packets(value_len, tx_octets)
+
+    # Steady state over enough events to send a whole number of
+    # notifications several times over
+    events = 100
+    sent = 0
+    idx = 0
+    for _ in range(events):
+        used = 0
+        count = 0
+        while pdus == 0 or count < pdus:
+            cost = ((pkts[idx] + overhead) * PHY_US_PER_BYTE +
+                    T_IFS + empty_us + T_IFS)
+            if used + cost > interval_us:
+                break
+            used += cost
+            count += 1
+            idx += 1
+            if idx == len(pkts):
+                sent += value_len
+                idx = 0
+        if count == 0:
+            raise ValueError("interval too short for a %u byte packet" %
+                             pkts[idx])
+    return sent * 1000000.0 / (events * interval_us)
+
+
+def int_list(text):
+    return [int(v, 0) for v in text.split(",") if v]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--interval", type=float, default=7.5,
+                        help="connection interval in ms (default 7.5)")
+    parser.add_argument("--mtu", type=int_list, default=[23, 65, 185, 247],
+                        help="ATT MTUs, comma separated")
+    parser.add_argument("--octets", type=int_list, default=[27, 69, 185, 251],
+                        help="maximum LL payloads, comma separated")
+    parser.add_argument("--pdus", type=int, default=0,
+                        help="packets per connection event, 0 for no limit")
+    parser.add_argument("--encrypted", action="store_true",
+                        help="add the MIC to every packet")
+    args = parser.parse_args()
+
+    interval_us = args.interval * 1000
+    out = sys.stdout
+    out.write("%5s %6s %7s %12s %7s %12s\n" %
+              ("mtu", "octets", "tuned", "kbit/s", "full", "kbit/s"))
+    try:
+        for mtu in args.mtu:
+            for octets in args.octets:
+                tuned = payload_len(mtu, octets)
+                full = mtu - NOTI_HDR_SIZE
+                out.write("%5u %6u %7u %12.1f %7u %12.1f\n" % (
+                    mtu, octets,
+                    tuned, goodput(tuned, octets, interval_us, args.pdus,
+                                   args.encrypted) * 8 / 1000,
+                    full, goodput(full, octets, interval_us, args.pdus,
+                                  args.encrypted) * 8 / 1000))
+    except ValueError as e:
+        sys.exit("error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
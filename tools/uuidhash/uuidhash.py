@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Generates the 16-bit UUID perfect hash used by GATT_FindUUIDRec().
+
+The hash maps each 16-bit UUID known to gatt_uuid.c onto its own slot of
+a table holding exactly one UUID record per slot (minimal perfect hash):
+
+    bucket = ((uuid * MULT1) >> 16) & (BUCKETS - 1)
+    slot   = (((uuid * MULT2) >> 16) + disp[bucket]) % SIZE
+
+The generated block of gatt_uuid.c is rewritten in place. The generator
+checks every 16-bit value: each listed UUID must land on its own record
+and no other UUID may match the record of the slot it lands on.
+
+Usage: uuidhash.py [--check] [-r repo_root]
+"""
+
+import argparse
+import itertools
+import os
+import re
+import sys
+
+# UUID macro (gatt_uuid.h) and UUID record (gatt_uuid.c) pairs known to
+# GATT_FindUUIDRec().
+UUIDS = [
+    # GATT Services
+    ("GAP_SERVICE_UUID", "gapServiceUUID"),
+    ("GATT_SERVICE_UUID", "gattServiceUUID"),
+    # GATT Declarations
+    ("GATT_PRIMARY_SERVICE_UUID", "primaryServiceUUID"),
+    ("GATT_SECONDARY_SERVICE_UUID", "secondaryServiceUUID"),
+    ("GATT_INCLUDE_UUID", "includeUUID"),
+    ("GATT_CHARACTER_UUID", "characterUUID"),
+    # GATT Descriptors
+    ("GATT_CHAR_EXT_PROPS_UUID", "charExtPropsUUID"),
+    ("GATT_CHAR_USER_DESC_UUID", "charUserDescUUID"),
+    ("GATT_CLIENT_CHAR_CFG_UUID", "clientCharCfgUUID"),
+    ("GATT_SERV_CHAR_CFG_UUID", "servCharCfgUUID"),
+    ("GATT_CHAR_FORMAT_UUID", "charFormatUUID"),
+    ("GATT_CHAR_AGG_FORMAT_UUID", "charAggFormatUUID"),
+    ("GATT_VALID_RANGE_UUID", "validRangeUUID"),
+    ("GATT_EXT_REPORT_REF_UUID", "extReportRefUUID"),
+    ("GATT_REPORT_REF_UUID", "reportRefUUID"),
+    # GATT Characteristics
+    ("DEVICE_NAME_UUID", "deviceNameUUID"),
+    ("APPEARANCE_UUID", "appearanceUUID"),
+    ("RECONNECT_ADDR_UUID", "reconnectAddrUUID"),
+    ("PERI_PRIVACY_FLAG_UUID", "periPrivacyFlagUUID"),
+    ("PERI_CONN_PARAM_UUID", "periConnParamUUID"),
+    ("SERVICE_CHANGED_UUID", "serviceChangedUUID"),
+]
+
+BUCKETS = 8
+
+HEADER = "ble-stack/inc/gatt_uuid.h"
+SOURCE = "ble-stack/host/gatt_uuid.c"
+
+BEGIN = "// BEGIN GENERATED UUID HASH (tools/uuidhash/uuidhash.py)"
+END = "// END GENERATED UUID HASH"
+
+
+class Error(Exception):
+    pass
+
+
+def read_values(path):
+    values = {}
+    with open(path, encoding="latin-1") as f:
+        for line in f:
+            m = re.match(r"#define\s+(\w+)\s+(0x[0-9A-Fa-f]+)", line)
+            if m:
+                values[m.group(1)] = int(m.group(2), 16)
+    keys = []
+    for macro, rec in UUIDS:
+        if macro not in values:
+            raise Error("%s not defined in %s" % (macro, path))
+        keys.append((values[macro], macro, rec))
+    return keys
+
+
+def mix(uuid, mult):
+    return ((uuid * mult) & 0xFFFFFFFF) >> 16
+
+
+def search(uuids):
+    size = len(uuids)
+    for mult1, mult2 in itertools.product(range(0x9E37, 0x10000, 2),
+                                          range(0x7F4B, 0x10000, 2)):
+        buckets = [[] for _ in range(BUCKETS)]
+        for u in uuids:
+            buckets[mix(u, mult1) & (BUCKETS - 1)].append(u)
+        disp = [0] * BUCKETS
+        used = set()
+        order = sorted(range(BUCKETS), key=lambda b: -len(buckets[b]))
+        for b in order:
+            for d in range(size):
+                slots = [(mix(u, mult2) + d) % size for u in buckets[b]]
+                if len(set(slots)) == len(slots) and not used & set(slots):
+                    disp[b] = d
+                    used |= set(slots)
+                    break
+            else:
+                break
+        else:
+            return mult1, mult2, disp
+    raise Error("no perfect hash found")
+
+
+def slot_of(uuid, mult1, mult2, disp, size):
+    return (mix(uuid, mult2) + disp[mix(uuid, mult1) & (BUCKETS - 1)]) % size
+
+
+def verify(keys, mult1, mult2, disp):
+    size = len(keys)
+    table = [None] * size
+    for uuid, _, rec in keys:
+        s = slot_of(uuid, mult1, mult2, disp, size)
+        if table[s] is not None:
+            raise Error("slot %d used twice" % s)
+        table[s] = (uuid, rec)
+    # Exhaustive: a lookup hits only for the listed UUIDs, on their record.
+    hits = 0
+    for uuid in range(0x10000):
+        ruuid, rec = table[slot_of(uuid, mult1, mult2, disp, size)]
+        if ruuid == uuid:
+            hits += 1
+    if hits != size:
+        raise Error("%d hits for %d UUIDs" % (hits, size))
+    return table
+
+
+def generate(keys):
+    mult1, mult2, disp = search([k[0] for k in keys])
+    table = verify(keys, mult1, mult2, disp)
+    size = len(keys)
+    macro = {rec: m for _, m, rec in keys}
+    out = [BEGIN,
+           "// Do not edit: run tools/uuidhash/uuidhash.py after changing the",
+           "// 16-bit UUIDs known to GATT_FindUUIDRec().",
+           "#define GATT_UUID_HASH_SIZE           %d" % size,
+           "#define GATT_UUID_HASH_BUCKETS        %d" % BUCKETS,
+           "#define GATT_UUID_HASH_MULT1          0x%04X" % mult1,
+           "#define GATT_UUID_HASH_MULT2          0x%04X" % mult2,
+           "",
+           "// Displacement of each bucket",
+           "static CONST uint8 gattUUIDHashDisp[GATT_UUID_HASH_BUCKETS] =",
+           "{",
+           "  " + ", ".join("%d" % d for d in disp),
+           "};",
+           "",
+           "// UUID record of each slot",
+           "static const uint8 * CONST gattUUIDHashTbl[GATT_UUID_HASH_SIZE] =",
+           "{"]
+    for i, (_, rec) in enumerate(table):
+        sep = "," if i < size - 1 else ""
+        out.append("  %-22s // %s" % (rec + sep, macro[rec]))
+    out += ["};", END]
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="fail if the generated block is out of date")
+    parser.add_argument("-r", "--root",
+                        default=os.path.join(os.path.dirname(__file__),
+                                             "..", ".."),
+                        help="repository root")
+    args = parser.parse_args()
+
+    try:
+        keys = read_values(os.path.join(args.root, HEADER))
+        block = generate(keys)
+
+        path = os.path.join(args.root, SOURCE)
+        with open(path, encoding="latin-1") as f:
+            text = f.read()
+        start = text.find(BEGIN)
+        stop = text.find(END)
+        if start < 0 or stop < start:
+            raise Error("generated block markers not found in %s" % path)
+        new = text[:start] + block + text[stop + len(END):]
+
+        if args.check:
+            if new != text:
+                raise Error("%s is out of date" % path)
+        elif new != text:
+            with open(path, "w", encoding="latin-1") as f:
+                f.write(new)
+    except (Error, OSError) as e:
+        sys.exit("error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()